@@ -0,0 +1,464 @@
+#include "stdafx.h"
+#include "struct_parser.h"
+#include "code_creator.h"
+
+code_creator::code_creator(const std::vector<gson_struct>& structs,
+	const std::vector<string>& headers)
+: structs_(structs)
+, headers_(headers)
+{
+}
+
+code_creator::~code_creator()
+{
+}
+
+//  C ַżбת
+
+static void quote(const string& s, string& buf)
+{
+	buf = "\"";
+
+	for (size_t i = 0; i < s.length(); i++)
+	{
+		char ch = s[i];
+		if (ch == '"' || ch == '\\')
+			buf << '\\';
+		buf << ch;
+	}
+
+	buf << "\"";
+}
+
+static void full_name(const gson_struct& st, const gson_field& field,
+	string& buf)
+{
+	string name(st.name);
+	name << "." << field.name;
+	quote(name, buf);
+}
+
+void code_creator::open_namespace(string& out, const string& ns)
+{
+	if (ns.empty())
+		return;
+
+	string buf(ns);
+	std::vector<string>& names = buf.split2(":");
+	for (std::vector<string>::const_iterator it = names.begin();
+		it != names.end(); ++it)
+	{
+		out.format_append("namespace %s {\r\n", it->c_str());
+	}
+	out << "\r\n";
+}
+
+void code_creator::close_namespace(string& out, const string& ns)
+{
+	if (ns.empty())
+		return;
+
+	string buf(ns);
+	std::vector<string>& names = buf.split2(":");
+	for (size_t i = names.size(); i > 0; i--)
+		out.format_append("} // namespace %s\r\n", names[i - 1].c_str());
+	out << "\r\n";
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void code_creator::create_header(const char* name)
+{
+	header_.format("// %s.h: generated by gson, do not edit\r\n\r\n"
+		"#pragma once\r\n"
+		"#include \"acl_cpp/lib_acl.hpp\"\r\n"
+		"#include \"acl_cpp/stdlib/gson_helper.hpp\"\r\n", name);
+
+	for (std::vector<string>::const_iterator it = headers_.begin();
+		it != headers_.end(); ++it)
+	{
+		header_.format_append("#include \"%s\"\r\n", it->c_str());
+	}
+	header_ << "\r\n";
+
+	for (size_t i = 0; i < structs_.size(); i++)
+	{
+		const gson_struct& st = structs_[i];
+		const char* s = st.name.c_str();
+
+		if (i == 0 || structs_[i - 1].ns != st.ns)
+			open_namespace(header_, st.ns);
+
+		header_.format_append("// %s\r\n", s);
+		header_.format_append(
+			"bool gson(const char* data, size_t len, %s& obj,\r\n"
+			"\tacl::string* err = NULL);\r\n"
+			"bool gson(acl::json_reader& in, %s& obj,"
+			" acl::string* err = NULL);\r\n"
+			"acl::string gson(const %s& obj);\r\n"
+			"void gson(acl::json_writer& out, const %s& obj);\r\n"
+			"bool gson_xml(const char* data, %s& obj,"
+			" acl::string* err = NULL);\r\n"
+			"bool gson_xml(acl::xml_node& node, %s& obj,"
+			" acl::string* err = NULL);\r\n"
+			"acl::string gson_xml(const %s& obj,"
+			" const char* tag = \"%s\");\r\n\r\n",
+			s, s, s, s, s, s, s, s);
+
+		if (i + 1 == structs_.size() || structs_[i + 1].ns != st.ns)
+		{
+			// ɵĴ뼰 gson_helper.hpp еģ
+			header_ << "// used by the generated code\r\n";
+			size_t first = i;
+			while (first > 0 && structs_[first - 1].ns == st.ns)
+				first--;
+			for (size_t j = first; j <= i; j++)
+			{
+				const char* n = structs_[j].name.c_str();
+				header_.format_append(
+					"bool gson_get(acl::json_reader& in,"
+					" acl::json_token_t token, %s& obj,\r\n"
+					"\tconst char* field, acl::string* err);\r\n"
+					"void gson_put(acl::json_writer& out,"
+					" const %s& obj);\r\n"
+					"bool gson_xml_get(acl::xml_node& node,"
+					" %s& obj, const char* field,\r\n"
+					"\tacl::string* err);\r\n"
+					"void gson_xml_put(acl::string& out,"
+					" const char* tag, const %s& obj);\r\n",
+					n, n, n, n);
+			}
+			header_ << "\r\n";
+			close_namespace(header_, st.ns);
+		}
+	}
+}
+
+// Աĳȷ飬ͬһȽ
+
+void code_creator::dispatch(const gson_struct& st, const char* var,
+	const char* indent, bool is_json)
+{
+	// Աȶ򣬳ֶͬͬһ case 
+	std::vector<size_t> fields;
+	for (size_t i = 0; i < st.fields.size(); i++)
+	{
+		size_t n = fields.size();
+		while (n > 0 && st.fields[fields[n - 1]].key.length()
+			> st.fields[i].key.length())
+		{
+			n--;
+		}
+		fields.insert(fields.begin() + n, i);
+	}
+
+	source_.format_append("%sswitch (%s)\r\n%s{\r\n", indent,
+		is_json ? "in.get_text().length()" : "strlen(tag)", indent);
+
+	string key, name;
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		const gson_field& field = st.fields[fields[i]];
+		int len = (int) field.key.length();
+
+		if (i == 0 || (int) st.fields[fields[i - 1]].key.length() != len)
+			source_.format_append("%scase %d:\r\n", indent, len);
+
+		quote(field.key, key);
+		full_name(st, field, name);
+
+		source_.format_append("%s\tif (memcmp(%s, %s, %d) == 0)\r\n"
+			"%s\t{\r\n", indent, var, key.c_str(), len, indent);
+
+		if (is_json)
+			source_.format_append("%s\t\tif (!gson_get(in,"
+				" in.next(), obj.%s, %s, err))\r\n",
+				indent, field.name.c_str(), name.c_str());
+		else
+			source_.format_append("%s\t\tif (!%s(*child,"
+				" obj.%s, %s, err))\r\n", indent,
+				field.container ? "gson_xml_add" : "gson_xml_get",
+				field.name.c_str(), name.c_str());
+
+		source_.format_append("%s\t\t\treturn false;\r\n", indent);
+		if (!field.optional && (is_json || !field.container))
+			source_.format_append("%s\t\thas_%s = true;\r\n",
+				indent, field.name.c_str());
+		source_.format_append("%s\t\tcontinue;\r\n%s\t}\r\n",
+			indent, indent);
+
+		if (i + 1 == fields.size()
+			|| (int) st.fields[fields[i + 1]].key.length() != len)
+		{
+			source_.format_append("%s\tbreak;\r\n", indent);
+		}
+	}
+
+	source_.format_append("%sdefault:\r\n%s\tbreak;\r\n%s}\r\n",
+		indent, indent, indent);
+}
+
+static void declare_required(string& out, const gson_struct& st,
+	bool is_json)
+{
+	for (std::vector<gson_field>::const_iterator it = st.fields.begin();
+		it != st.fields.end(); ++it)
+	{
+		if (!it->optional && (is_json || !it->container))
+			out.format_append("\tbool has_%s = false;\r\n",
+				it->name.c_str());
+	}
+}
+
+static void check_required(string& out, const gson_struct& st, bool is_json)
+{
+	string name;
+
+	for (std::vector<gson_field>::const_iterator it = st.fields.begin();
+		it != st.fields.end(); ++it)
+	{
+		if (it->optional || (!is_json && it->container))
+			continue;
+
+		full_name(st, *it, name);
+		if (is_json)
+			out.format_append("\tif (!has_%s)\r\n\t\treturn"
+				" acl::gson_error(in, %s, \"missing\", err);\r\n",
+				it->name.c_str(), name.c_str());
+		else
+			out.format_append("\tif (!has_%s)\r\n\t\treturn"
+				" acl::gson_xml_error(%s, \"missing\", err);\r\n",
+				it->name.c_str(), name.c_str());
+	}
+}
+
+void code_creator::json_get(const gson_struct& st)
+{
+	source_.format_append("bool gson_get(acl::json_reader& in,"
+		" acl::json_token_t token, %s& obj,\r\n"
+		"\tconst char* field, acl::string* err)\r\n{\r\n"
+		"\tusing acl::gson_get;\r\n\r\n"
+		"\tif (token == acl::JSON_TOKEN_NULL)\r\n"
+		"\t\treturn true;\r\n"
+		"\tif (token != acl::JSON_TOKEN_BEGIN_OBJECT)\r\n"
+		"\t\treturn acl::gson_error(in, field,"
+		" \"object expected\", err);\r\n\r\n", st.name.c_str());
+
+	declare_required(source_, st, true);
+
+	source_ << "\r\n\twhile ((token = in.next()) !="
+		" acl::JSON_TOKEN_END_OBJECT)\r\n\t{\r\n"
+		"\t\tif (token != acl::JSON_TOKEN_KEY)\r\n"
+		"\t\t\treturn acl::gson_error(in, field,"
+		" \"member name expected\", err);\r\n\r\n";
+
+	if (!st.fields.empty())
+	{
+		source_ << "\t\tconst char* key = in.get_text().c_str();\r\n";
+		dispatch(st, "key", "\t\t", true);
+		source_ << "\r\n";
+	}
+
+	source_ << "\t\t// unknown member\r\n"
+		"\t\tin.skip();\r\n"
+		"\t}\r\n\r\n";
+
+	check_required(source_, st, true);
+	source_ << "\treturn true;\r\n}\r\n\r\n";
+}
+
+void code_creator::json_put(const gson_struct& st)
+{
+	source_.format_append("void gson_put(acl::json_writer& out,"
+		" const %s& obj)\r\n{\r\n"
+		"\tusing acl::gson_put;\r\n\r\n"
+		"\tout.begin_object();\r\n", st.name.c_str());
+
+	string key;
+	for (std::vector<gson_field>::const_iterator it = st.fields.begin();
+		it != st.fields.end(); ++it)
+	{
+		quote(it->key, key);
+		source_.format_append("\tout.key(%s, %d);\r\n"
+			"\tgson_put(out, obj.%s);\r\n",
+			key.c_str(), (int) it->key.length(),
+			it->name.c_str());
+	}
+
+	source_ << "\tout.end_object();\r\n}\r\n\r\n";
+}
+
+void code_creator::json_api(const gson_struct& st)
+{
+	const char* s = st.name.c_str();
+	string name;
+	quote(st.name, name);
+	const char* n = name.c_str();
+
+	source_.format_append(
+		"bool gson(const char* data, size_t len, %s& obj,"
+		" acl::string* err)\r\n{\r\n"
+		"\tacl::json_reader in;\r\n"
+		"\tin.update(data, len);\r\n"
+		"\tin.update_end();\r\n"
+		"\tif (!gson_get(in, in.next(), obj, %s, err))\r\n"
+		"\t\treturn false;\r\n"
+		"\tif (in.next() != acl::JSON_TOKEN_EOF)\r\n"
+		"\t\treturn acl::gson_error(in, %s,"
+		" \"trailing data\", err);\r\n"
+		"\treturn true;\r\n}\r\n\r\n", s, n, n);
+
+	source_.format_append(
+		"bool gson(acl::json_reader& in, %s& obj, acl::string* err)\r\n"
+		"{\r\n\treturn gson_get(in, in.next(), obj, %s, err);\r\n}\r\n\r\n",
+		s, n);
+
+	source_.format_append(
+		"acl::string gson(const %s& obj)\r\n{\r\n"
+		"\tacl::string buf;\r\n"
+		"\tacl::json_writer out(buf);\r\n"
+		"\tgson_put(out, obj);\r\n"
+		"\tout.finish();\r\n"
+		"\treturn buf;\r\n}\r\n\r\n", s);
+
+	source_.format_append(
+		"void gson(acl::json_writer& out, const %s& obj)\r\n{\r\n"
+		"\tgson_put(out, obj);\r\n}\r\n\r\n", s);
+}
+
+void code_creator::xml_get(const gson_struct& st)
+{
+	source_.format_append("bool gson_xml_get(acl::xml_node& node, %s& obj,"
+		" const char* field,\r\n\tacl::string* err)\r\n{\r\n"
+		"\tusing acl::gson_xml_get;\r\n"
+		"\tusing acl::gson_xml_add;\r\n\r\n"
+		"\t(void) field;\r\n", st.name.c_str());
+
+	declare_required(source_, st, false);
+
+	source_ << "\r\n\tfor (acl::xml_node* child = node.first_child();"
+		" child != NULL;\r\n"
+		"\t\tchild = node.next_child())\r\n\t{\r\n"
+		"\t\tconst char* tag = child->tag_name();\r\n"
+		"\t\tif (tag == NULL)\r\n"
+		"\t\t\tcontinue;\r\n\r\n";
+
+	if (!st.fields.empty())
+		dispatch(st, "tag", "\t\t", false);
+
+	source_ << "\t}\r\n\r\n";
+
+	check_required(source_, st, false);
+	source_ << "\treturn true;\r\n}\r\n\r\n";
+}
+
+void code_creator::xml_put(const gson_struct& st)
+{
+	source_.format_append("void gson_xml_put(acl::string& out,"
+		" const char* tag, const %s& obj)\r\n{\r\n"
+		"\tusing acl::gson_xml_put;\r\n\r\n"
+		"\tout.format_append(\"<%%s>\", tag);\r\n", st.name.c_str());
+
+	string key;
+	for (std::vector<gson_field>::const_iterator it = st.fields.begin();
+		it != st.fields.end(); ++it)
+	{
+		quote(it->key, key);
+		source_.format_append("\tgson_xml_put(out, %s, obj.%s);\r\n",
+			key.c_str(), it->name.c_str());
+	}
+
+	source_ << "\tout.format_append(\"</%s>\", tag);\r\n}\r\n\r\n";
+}
+
+void code_creator::xml_api(const gson_struct& st)
+{
+	const char* s = st.name.c_str();
+	string name;
+	quote(st.name, name);
+	const char* n = name.c_str();
+
+	source_.format_append(
+		"bool gson_xml(const char* data, %s& obj, acl::string* err)\r\n"
+		"{\r\n"
+		"\tacl::xml xml;\r\n"
+		"\txml.update(data);\r\n"
+		"\tacl::xml_node* root = acl::gson_xml_root(xml);\r\n"
+		"\tif (root == NULL)\r\n"
+		"\t\treturn acl::gson_xml_error(%s, \"no element\", err);\r\n"
+		"\treturn gson_xml_get(*root, obj, %s, err);\r\n}\r\n\r\n",
+		s, n, n);
+
+	source_.format_append(
+		"bool gson_xml(acl::xml_node& node, %s& obj, acl::string* err)\r\n"
+		"{\r\n\treturn gson_xml_get(node, obj, %s, err);\r\n}\r\n\r\n",
+		s, n);
+
+	source_.format_append(
+		"acl::string gson_xml(const %s& obj, const char* tag)\r\n{\r\n"
+		"\tacl::string buf;\r\n"
+		"\tgson_xml_put(buf, tag, obj);\r\n"
+		"\treturn buf;\r\n}\r\n\r\n", s);
+}
+
+void code_creator::create_source(const char* name)
+{
+	source_.format("// %s.cpp: generated by gson, do not edit\r\n\r\n"
+		"#include <string.h>\r\n"
+		"#include \"%s.h\"\r\n\r\n", name, name);
+
+	for (size_t i = 0; i < structs_.size(); i++)
+	{
+		const gson_struct& st = structs_[i];
+
+		if (i == 0 || structs_[i - 1].ns != st.ns)
+			open_namespace(source_, st.ns);
+
+		source_.format_append("////////////////////////////////////////"
+			"//////////////////////////////////\r\n// %s\r\n\r\n",
+			st.name.c_str());
+
+		json_get(st);
+		json_put(st);
+		json_api(st);
+		xml_get(st);
+		xml_put(st);
+		xml_api(st);
+
+		if (i + 1 == structs_.size() || structs_[i + 1].ns != st.ns)
+			close_namespace(source_, st.ns);
+	}
+}
+
+bool code_creator::save(const char* filepath, const string& data)
+{
+	ofstream out;
+	if (out.open_trunc(filepath) == false)
+	{
+		printf("open %s error %s\r\n", filepath, last_serror());
+		return false;
+	}
+
+	if (out.write(data) == -1)
+	{
+		printf("write %s error %s\r\n", filepath, last_serror());
+		return false;
+	}
+
+	printf("create %s ok.\r\n", filepath);
+	return true;
+}
+
+bool code_creator::create(const char* path, const char* name)
+{
+	create_header(name);
+	create_source(name);
+
+	string filepath;
+	filepath.format("%s/%s.h", path, name);
+	if (!save(filepath.c_str(), header_))
+		return false;
+
+	filepath.format("%s/%s.cpp", path, name);
+	return save(filepath.c_str(), source_);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+struct gson_struct;
+struct gson_field;
+
+/**
+ * ݽṹ嶨 json/xml תĴ룬ɵ json ʹ
+ * acl::json_reader ȡǣԱĳȼݷɵֶβֱ
+ * дṹԱjson ɴʹ acl::json_writer ֱд
+ */
+class code_creator
+{
+public:
+	/**
+	 * 캯
+	 * @param structs {const std::vector<gson_struct>&} Ľṹ
+	 * @param headers {const std::vector<string>&} ṹͷļ
+	 *  ɵͷļаԭЩļ
+	 */
+	code_creator(const std::vector<gson_struct>& structs,
+		const std::vector<string>& headers);
+	~code_creator();
+
+	/**
+	 *  name.h  name.cpp ļ
+	 * @param path {const char*} Ŀ¼
+	 * @param name {const char*} ļչ
+	 * @return {bool}
+	 */
+	bool create(const char* path, const char* name);
+
+private:
+	const std::vector<gson_struct>& structs_;
+	const std::vector<string>& headers_;
+	string header_;
+	string source_;
+
+	void create_header(const char* name);
+	void create_source(const char* name);
+	void open_namespace(string& out, const string& ns);
+	void close_namespace(string& out, const string& ns);
+
+	void json_get(const gson_struct& st);
+	void json_put(const gson_struct& st);
+	void json_api(const gson_struct& st);
+	void xml_get(const gson_struct& st);
+	void xml_put(const gson_struct& st);
+	void xml_api(const gson_struct& st);
+	void dispatch(const gson_struct& st, const char* var,
+		const char* indent, bool is_json);
+	bool save(const char* filepath, const string& data);
+};
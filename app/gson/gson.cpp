@@ -0,0 +1,105 @@
+// gson.cpp : ͷļеĽṹ嶨 json/xml תĴ
+//
+
+#include "stdafx.h"
+#include <stdio.h>
+#include <getopt.h>
+#include "struct_parser.h"
+#include "code_creator.h"
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help]\r\n"
+		" -f header_file [can be repeated]\r\n"
+		" -d header_dir [scan all *.h and *.hpp]\r\n"
+		" -o output_dir [default: .]\r\n"
+		" -n output_name [default: gson, create gson.h and gson.cpp]\r\n",
+		procname);
+}
+
+static bool is_header(const char* filepath)
+{
+	const char* ptr = strrchr(filepath, '.');
+	if (ptr == NULL)
+		return false;
+	return strcasecmp(ptr, ".h") == 0 || strcasecmp(ptr, ".hpp") == 0;
+}
+
+static bool scan_headers(const char* path, std::vector<string>& headers)
+{
+	scan_dir scan;
+	if (scan.open(path, false) == false)
+	{
+		printf("open dir %s error %s\r\n", path, last_serror());
+		return false;
+	}
+
+	const char* filepath;
+	while ((filepath = scan.next_file(true)) != NULL)
+	{
+		if (is_header(filepath))
+			headers.push_back(filepath);
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<string> headers;
+	string path("."), name("gson");
+	int   ch;
+
+	acl::acl_cpp_init();
+
+	while ((ch = getopt(argc, argv, "hf:d:o:n:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'f':
+			headers.push_back(optarg);
+			break;
+		case 'd':
+			if (scan_headers(optarg, headers) == false)
+				return 1;
+			break;
+		case 'o':
+			path = optarg;
+			break;
+		case 'n':
+			name = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (headers.empty())
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	struct_parser parser;
+	for (std::vector<string>::const_iterator it = headers.begin();
+		it != headers.end(); ++it)
+	{
+		if (parser.parse(it->c_str()) == false)
+			return 1;
+	}
+
+	if (parser.check() == false)
+		return 1;
+
+	if (parser.get_structs().empty())
+	{
+		printf("no struct found\r\n");
+		return 1;
+	}
+
+	code_creator creator(parser.get_structs(), headers);
+	return creator.create(path.c_str(), name.c_str()) ? 0 : 1;
+}
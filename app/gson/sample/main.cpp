@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include "lib_acl.h"
+#include "gson.h"
+#include "util.h"
+
+static void fill_user(demo::user& u, int i)
+{
+	u.id = 10000000000LL + i;
+	u.name.format("user-%d <\"a\" & 'b'>", i);
+	u.vip = i % 2 == 0;
+	u.score = i + 0.25;
+	u.age = (unsigned short) (20 + i % 50);
+	u.ratio = 0.5f;
+	u.tags.push_back(i);
+	u.tags.push_back(-i);
+	u.emails.push_back("a@example.com");
+	u.emails.push_back("b@example.com");
+	u.flags.push_back(true);
+	u.flags.push_back(false);
+	u.home.city = "hangzhou";
+	u.home.street = "wen\\san \"road\"\n";
+	u.home.zip = 310000 + i;
+	demo::address other;
+	other.city = "beijing";
+	other.street = "chang'an";
+	other.zip = 100000;
+	u.others.push_back(other);
+	u.nick = "\xe4\xb8\xad\xe6\x96\x87";
+	u.cache = "not saved";
+}
+
+static bool same_user(const demo::user& a, const demo::user& b)
+{
+	return a.id == b.id && a.name == b.name && a.vip == b.vip
+		&& a.score == b.score && a.age == b.age
+		&& a.ratio == b.ratio && a.tags == b.tags
+		&& a.emails == b.emails && a.flags == b.flags
+		&& a.home.city == b.home.city
+		&& a.home.street == b.home.street
+		&& a.home.zip == b.home.zip
+		&& a.others.size() == b.others.size()
+		&& a.others[0].street == b.others[0].street
+		&& a.nick == b.nick;
+}
+
+static void test_json()
+{
+	demo::user u1, u2;
+	fill_user(u1, 1);
+
+	acl::string buf = gson(u1);
+	CHECK(strstr(buf.c_str(), "\"nick-name\":") != NULL);
+	CHECK(strstr(buf.c_str(), "cache") == NULL);
+
+	acl::string err;
+	CHECK(gson(buf.c_str(), buf.length(), u2, &err));
+	CHECK(same_user(u1, u2));
+	CHECK(u2.cache.empty());
+
+	// ȱٱֶ
+	demo::user u3;
+	const char* s = "{\"id\": 1, \"name\": \"x\", \"vip\": true}";
+	CHECK(!gson(s, strlen(s), u3, &err));
+	CHECK(err == "user.score: missing");
+
+	// ѡֶοȱ٣δֶ֪αnull ԭֵ
+	demo::user u4;
+	u4.nick = "keep";
+	s = "{\"id\": 2, \"name\": \"y\", \"vip\": false, \"score\": 1e2,"
+		" \"unknown\": {\"a\": [1, {\"b\": null}], \"c\": \"}\"},"
+		" \"age\": 30, \"tags\": [], \"nick-name\": null,"
+		" \"home\": {\"street\": \"s\", \"city\": \"c\", \"x\": 1}}";
+	CHECK(gson(s, strlen(s), u4, &err));
+	CHECK(u4.id == 2 && u4.name == "y" && u4.score == 100);
+	CHECK(u4.age == 30 && u4.tags.empty() && u4.nick == "keep");
+	CHECK(u4.home.city == "c" && u4.home.zip == 0);
+
+	// ʹ
+	demo::user u5;
+	s = "{\"id\": \"abc\"}";
+	CHECK(!gson(s, strlen(s), u5, &err));
+	CHECK(err == "user.id: number expected");
+
+	s = "{\"id\": 1.5}";
+	CHECK(!gson(s, strlen(s), u5, &err));
+
+	demo::user u6;
+	s = "{\"id\": 1, \"name\": \"x\", \"vip\": true, \"score\": 1,"
+		" \"age\": 70000}";
+	CHECK(!gson(s, strlen(s), u6, &err));
+	CHECK(strncmp(err.c_str(), "user.age:", 9) == 0);
+
+	point pt;
+	s = "{\"x\": 1, \"y\": 2} {";
+	CHECK(!gson(s, strlen(s), pt, &err));
+	s = "[1, 2]";
+	CHECK(!gson(s, strlen(s), pt, &err));
+	CHECK(err == "point: object expected");
+
+	// Ƕֿռ估ṹ
+	demo::inner::group g1, g2;
+	g1.title = "team";
+	g1.size = 3;
+	for (int i = 0; i < 3; i++)
+	{
+		g1.members.push_back(demo::user());
+		fill_user(g1.members.back(), i);
+	}
+	buf = gson(g1);
+	CHECK(gson(buf.c_str(), buf.length(), g2, &err));
+	CHECK(g2.title == "team" && g2.size == 3);
+	CHECK(g2.members.size() == 3);
+	CHECK(same_user(g1.members.back(), g2.members.back()));
+
+	// е json_reader жȡ
+	acl::json_reader in;
+	in.update(buf.c_str(), buf.length());
+	in.update_end();
+	demo::inner::group g3;
+	CHECK(gson(in, g3, &err));
+	CHECK(g3.members.size() == 3);
+}
+
+static void test_xml()
+{
+	demo::user u1, u2;
+	fill_user(u1, 7);
+
+	acl::string buf = gson_xml(u1);
+	CHECK(strncmp(buf.c_str(), "<user><id>", 10) == 0);
+	CHECK(strstr(buf.c_str(), "<nick-name>") != NULL);
+	CHECK(strstr(buf.c_str(), "<cache>") == NULL);
+
+	acl::string err;
+	CHECK(gson_xml(buf.c_str(), u2, &err));
+	CHECK(same_user(u1, u2));
+
+	demo::user u3;
+	const char* s = "<?xml version=\"1.0\"?>\r\n<!-- comment -->\r\n"
+		"<user><id>3</id><name>a &amp; b</name><vip>true</vip>"
+		"<score>2.5</score><age>9</age><home><city>c</city>"
+		"<street>s</street></home><unknown><a>1</a></unknown>"
+		"<tags>1</tags><tags>2</tags></user>";
+	CHECK(gson_xml(s, u3, &err));
+	CHECK(u3.id == 3 && u3.name == "a & b" && u3.vip);
+	CHECK(u3.tags.size() == 2 && u3.tags[1] == 2);
+
+	demo::user u4;
+	s = "<user><id>3</id></user>";
+	CHECK(!gson_xml(s, u4, &err));
+	CHECK(err == "user.name: missing");
+
+	demo::user u5;
+	s = "<user><id>x</id></user>";
+	CHECK(!gson_xml(s, u5, &err));
+	CHECK(strncmp(err.c_str(), "user.id:", 8) == 0);
+
+	demo::inner::group g1, g2;
+	g1.title = "team";
+	g1.size = 2;
+	for (int i = 0; i < 2; i++)
+	{
+		g1.members.push_back(demo::user());
+		fill_user(g1.members.back(), i);
+	}
+	buf = gson_xml(g1, "team");
+	CHECK(strncmp(buf.c_str(), "<team>", 6) == 0);
+	CHECK(gson_xml(buf.c_str(), g2, &err));
+	CHECK(g2.members.size() == 2);
+	CHECK(same_user(g1.members.front(), g2.members.front()));
+}
+
+// գȽ acl::json ٱ㰴Ƹṹ帳ֵ
+static void tree_parse(const acl::string& data, demo::inner::group& g)
+{
+	acl::json json;
+	json.update(data.c_str());
+
+	demo::user* u = NULL;
+	for (acl::json_node* node = json.first_node(); node != NULL;
+		node = json.next_node())
+	{
+		const char* tag = node->tag_name();
+		const char* txt = node->get_text();
+		if (tag == NULL)
+			continue;
+		if (strcmp(tag, "id") == 0)
+		{
+			g.members.push_back(demo::user());
+			u = &g.members.back();
+			u->id = acl_atoi64(txt);
+		}
+		else if (u == NULL || txt == NULL)
+			continue;
+		else if (strcmp(tag, "name") == 0)
+			u->name = txt;
+		else if (strcmp(tag, "vip") == 0)
+			u->vip = strcmp(txt, "true") == 0;
+		else if (strcmp(tag, "score") == 0)
+			u->score = atof(txt);
+		else if (strcmp(tag, "age") == 0)
+			u->age = (unsigned short) atoi(txt);
+		else if (strcmp(tag, "city") == 0)
+			u->home.city = txt;
+		else if (strcmp(tag, "street") == 0)
+			u->home.street = txt;
+		else if (strcmp(tag, "zip") == 0)
+			u->home.zip = atoi(txt);
+		else if (strcmp(tag, "nick-name") == 0)
+			u->nick = txt;
+	}
+}
+
+static void benchmark(int count)
+{
+	demo::inner::group g;
+	g.title = "benchmark";
+	g.size = count;
+	for (int i = 0; i < count; i++)
+	{
+		g.members.push_back(demo::user());
+		demo::user& u = g.members.back();
+		u.id = i;
+		u.name.format("user-%d", i);
+		u.vip = true;
+		u.score = i + 0.5;
+		u.age = 30;
+		u.home.city = "hangzhou";
+		u.home.street = "wensan road";
+		u.home.zip = 310000;
+		u.nick = "nick";
+	}
+
+	struct timeval begin, end;
+	double spent;
+
+	gettimeofday(&begin, NULL);
+	acl::string data = gson(g);
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("gson write: %d bytes, %.2f ms, %.2f MB/s\r\n",
+		(int) data.length(), spent,
+		data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	demo::inner::group g1;
+	bool ret = gson(data.c_str(), data.length(), g1);
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("gson read: %s, %d members, %.2f ms, %.2f MB/s\r\n",
+		ret ? "ok" : "error", (int) g1.members.size(), spent,
+		data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	demo::inner::group g2;
+	tree_parse(data, g2);
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("json tree read: %d members, %.2f ms, %.2f MB/s\r\n",
+		(int) g2.members.size(), spent,
+		data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	data = gson_xml(g);
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("gson xml write: %d bytes, %.2f ms\r\n",
+		(int) data.length(), spent);
+
+	gettimeofday(&begin, NULL);
+	demo::inner::group g3;
+	ret = gson_xml(data.c_str(), g3);
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("gson xml read: %s, %d members, %.2f ms\r\n",
+		ret ? "ok" : "error", (int) g3.members.size(), spent);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help] -b [benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 100000;
+	bool  bench = false;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			bench = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (bench)
+	{
+		benchmark(count);
+		return 0;
+	}
+
+	test_json();
+	test_xml();
+
+	return util::check_result();
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <list>
+#include <vector>
+#include <string>
+#include "acl_cpp/lib_acl.hpp"
+
+namespace demo
+{
+
+struct address
+{
+	std::string city;
+	std::string street;
+	int zip;		// @optional
+};
+
+struct user
+{
+	long long id;
+	acl::string name;
+	bool vip;
+	double score;
+	unsigned short age;
+	float ratio;				// @optional
+	std::vector<int> tags;
+	std::list<std::string> emails;		// @optional
+	std::vector<bool> flags;		// @optional
+	address home;
+	std::vector<address> others;		// @optional
+
+	// @name(nick-name)
+	// @optional
+	std::string nick;
+
+	std::string cache;			// @skip
+	static int count;
+
+	user() : id(0), vip(false), score(0), age(0), ratio(0) {}
+	bool empty() const { return name.empty(); }
+};
+
+namespace inner
+{
+
+struct group
+{
+	std::string title;
+	std::list<user> members;
+	unsigned int size;
+};
+
+} // namespace inner
+
+} // namespace demo
+
+// @skip
+struct ignored
+{
+	int* ptr;
+};
+
+struct point
+{
+	int x;
+	int y;
+};
@@ -0,0 +1,11 @@
+// stdafx.h : ׼ϵͳļİļ
+// ǳõĵĿضİļ
+//
+
+#pragma once
+
+#include <vector>
+#include "lib_acl.h"
+#include "acl_cpp/lib_acl.hpp"
+
+using namespace acl;
@@ -0,0 +1,711 @@
+#include "stdafx.h"
+#include "struct_parser.h"
+
+struct_parser::struct_parser()
+: pos_(0)
+{
+}
+
+struct_parser::~struct_parser()
+{
+}
+
+static bool is_ident_char(char ch)
+{
+	return ACL_ISALNUM(ch) || ch == '_';
+}
+
+static bool is_ident(const string& s)
+{
+	const char* ptr = s.c_str();
+	if (*ptr == 0 || ACL_ISDIGIT(*ptr))
+		return false;
+	for (; *ptr; ptr++)
+	{
+		if (!is_ident_char(*ptr))
+			return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void struct_parser::add_comment(int line, const char* s, size_t len)
+{
+	if (comments_.size() <= (size_t) line)
+		comments_.resize(line + 1);
+	comments_[line].append(s, len);
+	comments_[line].append(" ");
+}
+
+const char* struct_parser::comment(int line) const
+{
+	if (line < 0 || (size_t) line >= comments_.size())
+		return "";
+	return comments_[line].c_str();
+}
+
+bool struct_parser::has_code(int line) const
+{
+	return line >= 0 && (size_t) line < code_lines_.size()
+		&& code_lines_[line];
+}
+
+bool struct_parser::annotated(int line, const char* tag) const
+{
+	string value;
+	return annotation(line, tag, value);
+}
+
+// עдͬһУдڽϵֻע͵
+
+bool struct_parser::annotation(int line, const char* tag, string& value) const
+{
+	const char* text = strstr(comment(line), tag);
+	for (int n = line - 1; text == NULL && n > 0; n--)
+	{
+		if (has_code(n) || *comment(n) == 0)
+			break;
+		text = strstr(comment(n), tag);
+	}
+	if (text == NULL)
+		return false;
+
+	text += strlen(tag);
+	if (*text != '(')
+		return true;
+
+	const char* end = strchr(++text, ')');
+	if (end == NULL)
+		return true;
+
+	while (*text == ' ')
+		text++;
+	while (end > text && end[-1] == ' ')
+		end--;
+	value.copy(text, end - text);
+	return true;
+}
+
+bool struct_parser::tokenize(const char* data)
+{
+	const char* ptr = data;
+	int  line = 1;
+	bool line_start = true;
+
+	tokens_.clear();
+	comments_.clear();
+	code_lines_.clear();
+
+	while (*ptr)
+	{
+		char ch = *ptr;
+
+		if (ch == '\n')
+		{
+			line++;
+			line_start = true;
+			ptr++;
+			continue;
+		}
+		if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\f')
+		{
+			ptr++;
+			continue;
+		}
+
+		// Ԥָ \ еĲ
+		if (ch == '#' && line_start)
+		{
+			while (*ptr && *ptr != '\n')
+			{
+				if (*ptr == '\\' && ptr[1] == '\n')
+				{
+					line++;
+					ptr++;
+				}
+				else if (*ptr == '\\' && ptr[1] == '\r'
+					&& ptr[2] == '\n')
+				{
+					line++;
+					ptr += 2;
+				}
+				ptr++;
+			}
+			continue;
+		}
+
+		line_start = false;
+
+		if (ch == '/' && ptr[1] == '/')
+		{
+			const char* end = strchr(ptr, '\n');
+			if (end == NULL)
+				end = ptr + strlen(ptr);
+			add_comment(line, ptr + 2, end - ptr - 2);
+			ptr = end;
+			continue;
+		}
+
+		if (ch == '/' && ptr[1] == '*')
+		{
+			const char* end = strstr(ptr + 2, "*/");
+			if (end == NULL)
+			{
+				printf("%s(%d): unterminated comment\r\n",
+					file_.c_str(), line);
+				return false;
+			}
+			add_comment(line, ptr + 2, end - ptr - 2);
+			for (; ptr < end; ptr++)
+			{
+				if (*ptr == '\n')
+					line++;
+			}
+			ptr = end + 2;
+			continue;
+		}
+
+		token tok;
+		tok.line = line;
+		const char* begin = ptr;
+
+		if (ch == '"' || ch == '\'')
+		{
+			for (ptr++; *ptr && *ptr != ch && *ptr != '\n'; ptr++)
+			{
+				if (*ptr == '\\' && ptr[1])
+					ptr++;
+			}
+			if (*ptr != ch)
+			{
+				printf("%s(%d): unterminated literal\r\n",
+					file_.c_str(), line);
+				return false;
+			}
+			ptr++;
+		}
+		else if (is_ident_char(ch) || (ch == '.' && ACL_ISDIGIT(ptr[1])))
+		{
+			while (is_ident_char(*ptr) || *ptr == '.')
+				ptr++;
+		}
+		else if (ch == ':' && ptr[1] == ':')
+			ptr += 2;
+		else
+			ptr++;
+
+		tok.text.copy(begin, ptr - begin);
+		tokens_.push_back(tok);
+
+		if (code_lines_.size() <= (size_t) line)
+			code_lines_.resize(line + 1);
+		code_lines_[line] = true;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool struct_parser::is(const char* s) const
+{
+	return pos_ < tokens_.size() && tokens_[pos_].text == s;
+}
+
+void struct_parser::join(size_t from, size_t to, string& buf) const
+{
+	buf.clear();
+
+	for (size_t i = from; i < to; i++)
+	{
+		const string& text = tokens_[i].text;
+		if (!buf.empty() && is_ident_char(buf[buf.length() - 1])
+			&& is_ident_char(text[0]))
+		{
+			buf << " ";
+		}
+		buf << text;
+	}
+}
+
+void struct_parser::qualified(string& buf) const
+{
+	buf.clear();
+
+	for (std::vector<string>::const_iterator it = ns_.begin();
+		it != ns_.end(); ++it)
+	{
+		if (!buf.empty())
+			buf << "::";
+		buf << *it;
+	}
+}
+
+void struct_parser::skip_block()
+{
+	int depth = 0;
+
+	for (; pos_ < tokens_.size(); pos_++)
+	{
+		if (is("{"))
+			depth++;
+		else if (is("}") && --depth == 0)
+		{
+			pos_++;
+			return;
+		}
+	}
+}
+
+// һ ';' Ϊֹ򵽺 {} Ϊֹ
+
+void struct_parser::skip_decl()
+{
+	while (pos_ < tokens_.size())
+	{
+		if (is(";"))
+		{
+			pos_++;
+			return;
+		}
+		if (is("}"))
+			return;
+		if (is("{"))
+		{
+			skip_block();
+			if (is(";"))
+				pos_++;
+			return;
+		}
+		pos_++;
+	}
+}
+
+bool struct_parser::parse_scope()
+{
+	while (pos_ < tokens_.size())
+	{
+		if (is("}"))
+			return true;
+
+		if (is("namespace"))
+		{
+			pos_++;
+			if (pos_ + 1 < tokens_.size()
+				&& is_ident(tokens_[pos_].text)
+				&& tokens_[pos_ + 1].text == "{")
+			{
+				ns_.push_back(tokens_[pos_].text);
+				pos_ += 2;
+				if (!parse_scope())
+					return false;
+				pos_++;
+				ns_.pop_back();
+			}
+			else
+				skip_decl();
+		}
+		else if (is("extern") && pos_ + 2 < tokens_.size()
+			&& tokens_[pos_ + 1].text[0] == '"'
+			&& tokens_[pos_ + 2].text == "{")
+		{
+			pos_ += 3;
+			if (!parse_scope())
+				return false;
+			pos_++;
+		}
+		else if (is("typedef") && pos_ + 1 < tokens_.size()
+			&& tokens_[pos_ + 1].text == "struct")
+		{
+			pos_++;
+			if (!parse_struct(false))
+				return false;
+		}
+		else if (is("struct") || is("class"))
+		{
+			if (!parse_struct(is("class")))
+				return false;
+		}
+		else
+			skip_decl();
+	}
+
+	return true;
+}
+
+bool struct_parser::parse_struct(bool is_class)
+{
+	int line = tokens_[pos_].line;
+
+	pos_++;
+	if (pos_ >= tokens_.size() || !is_ident(tokens_[pos_].text))
+	{
+		skip_decl();
+		return true;
+	}
+
+	gson_struct st;
+	st.name = tokens_[pos_].text;
+	qualified(st.ns);
+	st.file = file_;
+	st.line = line;
+	pos_++;
+
+	if (is("final"))
+		pos_++;
+
+	if (is(":"))
+	{
+		printf("%s(%d): warning: base classes of %s are ignored\r\n",
+			file_.c_str(), line, st.name.c_str());
+		while (pos_ < tokens_.size() && !is("{") && !is(";"))
+			pos_++;
+	}
+
+	// ǰ
+	if (!is("{"))
+	{
+		skip_decl();
+		return true;
+	}
+
+	if (annotated(line, "@skip"))
+	{
+		skip_decl();
+		return true;
+	}
+
+	pos_++;
+	bool is_public = !is_class;
+
+	while (pos_ < tokens_.size() && !is("}"))
+	{
+		if ((is("public") || is("private") || is("protected"))
+			&& pos_ + 1 < tokens_.size()
+			&& tokens_[pos_ + 1].text == ":")
+		{
+			is_public = is("public");
+			pos_ += 2;
+			continue;
+		}
+
+		if (is("struct") || is("class") || is("union") || is("enum")
+			|| is("typedef") || is("using") || is("friend")
+			|| is("static") || is("template") || is("virtual")
+			|| is("explicit") || is("inline") || is("operator")
+			|| is("~"))
+		{
+			skip_decl();
+			continue;
+		}
+
+		// ռһеĸǺţʼֳֵ
+		std::vector<size_t> decl;
+		bool is_func = false;
+		int  angle = 0;
+
+		while (pos_ < tokens_.size())
+		{
+			if (is(";") && angle == 0)
+			{
+				pos_++;
+				break;
+			}
+			if (is("}"))
+				break;
+			if (is("("))
+			{
+				is_func = true;
+				break;
+			}
+			if (is("{"))
+			{
+				skip_block();
+				continue;
+			}
+			if (is("=") && angle == 0)
+			{
+				while (pos_ < tokens_.size() && !is(",")
+					&& !is(";") && !is("}"))
+				{
+					if (is("{"))
+						skip_block();
+					else
+						pos_++;
+				}
+				continue;
+			}
+			if (is("<"))
+				angle++;
+			else if (is(">"))
+				angle--;
+			decl.push_back(pos_++);
+		}
+
+		if (is_func)
+		{
+			skip_decl();
+			continue;
+		}
+
+		if (is_public && !decl.empty() && !parse_member(st, decl))
+			return false;
+	}
+
+	if (!is("}"))
+	{
+		printf("%s(%d): struct %s not closed\r\n",
+			file_.c_str(), line, st.name.c_str());
+		return false;
+	}
+
+	pos_++;
+	skip_decl();
+	structs_.push_back(st);
+	return true;
+}
+
+bool struct_parser::parse_member(gson_struct& st, std::vector<size_t>& decl)
+{
+	// Ķŷֳɶһ
+	std::vector<std::vector<size_t> > groups(1);
+	int angle = 0;
+
+	for (std::vector<size_t>::const_iterator it = decl.begin();
+		it != decl.end(); ++it)
+	{
+		const string& text = tokens_[*it].text;
+		if (text == "<")
+			angle++;
+		else if (text == ">")
+			angle--;
+		else if (text == "," && angle == 0)
+		{
+			groups.push_back(std::vector<size_t>());
+			continue;
+		}
+		groups.back().push_back(*it);
+	}
+
+	std::vector<size_t>& first = groups[0];
+	int line = tokens_[first.back()].line;
+
+	size_t type_begin = 0;
+	while (type_begin < first.size() && (tokens_[first[type_begin]].text
+		== "mutable" || tokens_[first[type_begin]].text == "volatile"))
+	{
+		type_begin++;
+	}
+
+	if (first.size() < type_begin + 2)
+	{
+		printf("%s(%d): warning: unknown declaration skipped\r\n",
+			file_.c_str(), line);
+		return true;
+	}
+
+	string type;
+	join(first[type_begin], first.back(), type);
+
+	for (size_t i = 0; i < groups.size(); i++)
+	{
+		const std::vector<size_t>& g = groups[i];
+		if (g.empty())
+			continue;
+
+		const string& name = tokens_[g.back()].text;
+		line = tokens_[g.back()].line;
+
+		if (!is_ident(name) || (i > 0 && g.size() != 1)
+			|| strchr(type.c_str(), '*') || strchr(type.c_str(), '&')
+			|| strchr(type.c_str(), '[') || strstr(type.c_str(), "const")
+			|| (type.c_str()[type.length() - 1] == ':'
+				&& type.c_str()[type.length() - 2] != ':'))
+		{
+			printf("%s(%d): warning: %s.%s: unsupported declaration"
+				" skipped\r\n", file_.c_str(), line,
+				st.name.c_str(), name.c_str());
+			continue;
+		}
+
+		if (annotated(line, "@skip"))
+			continue;
+
+		gson_field field;
+		field.name = name;
+		field.type = type;
+		field.container = false;
+		field.optional = annotated(line, "@optional");
+		field.line = line;
+		if (!annotation(line, "@name", field.key) || field.key.empty())
+			field.key = name;
+
+		st.fields.push_back(field);
+	}
+
+	return true;
+}
+
+bool struct_parser::parse(const char* filepath)
+{
+	string data;
+	if (ifstream::load(filepath, &data) == false)
+	{
+		printf("load %s error %s\r\n", filepath, last_serror());
+		return false;
+	}
+
+	file_ = filepath;
+	ns_.clear();
+	pos_ = 0;
+
+	if (!tokenize(data.c_str()))
+		return false;
+
+	while (pos_ < tokens_.size())
+	{
+		if (!parse_scope())
+			return false;
+
+		//  '}'
+		if (pos_ < tokens_.size())
+			pos_++;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static const char* __scalars[] = {
+	"bool",
+	"short", "short int", "signed short", "signed short int",
+	"unsigned short", "unsigned short int",
+	"int", "signed", "signed int", "unsigned", "unsigned int",
+	"long", "long int", "signed long", "signed long int",
+	"unsigned long", "unsigned long int",
+	"long long", "long long int", "signed long long",
+	"signed long long int", "unsigned long long",
+	"unsigned long long int",
+	"int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t",
+	"size_t", "ssize_t", "time_t", "acl_int64", "acl_uint64",
+	"float", "double",
+	"string", "acl::string", "std::string",
+	NULL,
+};
+
+static bool is_scalar(const string& type)
+{
+	for (size_t i = 0; __scalars[i] != NULL; i++)
+	{
+		if (type == __scalars[i])
+			return true;
+	}
+	return false;
+}
+
+static bool is_container(const string& type, string& elem)
+{
+	static const char* prefixes[] = {
+		"std::vector<", "vector<", "std::list<", "list<", NULL,
+	};
+
+	for (size_t i = 0; prefixes[i] != NULL; i++)
+	{
+		size_t n = strlen(prefixes[i]);
+		if (type.ncompare(prefixes[i], n) == 0
+			&& type[type.length() - 1] == '>')
+		{
+			elem.copy(type.c_str() + n, type.length() - n - 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+//  C++ ֲҹ򣬴ӽṹڵֿռ俪ʼ
+
+const gson_struct* struct_parser::find_struct(const gson_struct& owner,
+	const string& type) const
+{
+	string ns(owner.ns);
+	const char* name = type.c_str();
+	if (strncmp(name, "::", 2) == 0)
+	{
+		name += 2;
+		ns.clear();
+	}
+
+	while (true)
+	{
+		string full(ns);
+		if (!full.empty())
+			full << "::";
+		full << name;
+
+		for (std::vector<gson_struct>::const_iterator it
+			= structs_.begin(); it != structs_.end(); ++it)
+		{
+			string qname(it->ns);
+			if (!qname.empty())
+				qname << "::";
+			qname << it->name;
+			if (qname == full)
+				return &(*it);
+		}
+
+		if (ns.empty())
+			return NULL;
+
+		char* ptr = ns.rfind("::");
+		if (ptr == NULL)
+			ns.clear();
+		else
+			ns.truncate(ptr - ns.c_str());
+	}
+}
+
+bool struct_parser::check_type(const gson_struct& owner,
+	const gson_field& field, const string& type, bool nested) const
+{
+	if (is_scalar(type) || find_struct(owner, type) != NULL)
+		return true;
+
+	string elem;
+	if (is_container(type, elem))
+	{
+		if (!nested)
+			return check_type(owner, field, elem, true);
+
+		printf("%s(%d): %s.%s: nested container is not supported\r\n",
+			owner.file.c_str(), field.line, owner.name.c_str(),
+			field.name.c_str());
+		return false;
+	}
+
+	printf("%s(%d): %s.%s: unknown type %s\r\n", owner.file.c_str(),
+		field.line, owner.name.c_str(), field.name.c_str(),
+		type.c_str());
+	return false;
+}
+
+bool struct_parser::check()
+{
+	bool ok = true;
+
+	for (std::vector<gson_struct>::iterator it = structs_.begin();
+		it != structs_.end(); ++it)
+	{
+		for (std::vector<gson_field>::iterator cit = it->fields.begin();
+			cit != it->fields.end(); ++cit)
+		{
+			string elem;
+			cit->container = is_container(cit->type, elem);
+			if (!check_type(*it, *cit, cit->type, false))
+				ok = false;
+		}
+	}
+
+	return ok;
+}
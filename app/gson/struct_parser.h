@@ -0,0 +1,91 @@
+#pragma once
+
+// ṹеһֶ
+struct gson_field
+{
+	string name;		// Ա
+	string key;		// json еĳԱ xml еıǩ
+	string type;		// Ա
+	bool   container;	// ǷΪ std::vector  std::list
+	bool   optional;	// ʱǷȱٸֶ
+	int    line;
+};
+
+// һҪתĽṹ
+struct gson_struct
+{
+	string name;		// ֿռĽṹ
+	string ns;		// ڵֿռ䣬 a::bȫʱΪ
+	string file;
+	int    line;
+	std::vector<gson_field> fields;
+};
+
+/**
+ *  C++ ͷļȡṹ嶨壬ֻʶṹݳԱԱ
+ * ̬ԱǶ͵ȾԣڳԱͬһлϵע
+ * бע
+ *   // @optional     ʱȱٸֶ
+ *   // @skip         תֶΣдڽṹһʱתṹ
+ *   // @name(xxx)    ָ json/xml ʹõ
+ */
+class struct_parser
+{
+public:
+	struct_parser();
+	~struct_parser();
+
+	/**
+	 * һͷļеĽṹ屻
+	 * @param filepath {const char*}
+	 * @return {bool} ļȡ﷨ʱ false
+	 */
+	bool parse(const char* filepath);
+
+	/**
+	 * ļϺֶǷ񶼿ת
+	 * @return {bool}
+	 */
+	bool check();
+
+	const std::vector<gson_struct>& get_structs() const
+	{
+		return structs_;
+	}
+
+private:
+	struct token
+	{
+		string text;
+		int    line;
+	};
+
+	std::vector<gson_struct> structs_;
+	std::vector<token> tokens_;
+	std::vector<string> comments_;	// кűע
+	std::vector<bool> code_lines_;	// Ƿд
+	std::vector<string> ns_;
+	string file_;
+	size_t pos_;
+
+	bool tokenize(const char* data);
+	void add_comment(int line, const char* s, size_t len);
+	const char* comment(int line) const;
+	bool has_code(int line) const;
+	bool annotated(int line, const char* tag) const;
+	bool annotation(int line, const char* tag, string& value) const;
+
+	bool is(const char* s) const;
+	bool parse_scope();
+	bool parse_struct(bool is_class);
+	bool parse_member(gson_struct& st, std::vector<size_t>& decl);
+	void skip_decl();
+	void skip_block();
+	void join(size_t from, size_t to, string& out) const;
+	void qualified(string& out) const;
+
+	const gson_struct* find_struct(const gson_struct& owner,
+		const string& type) const;
+	bool check_type(const gson_struct& owner, const gson_field& field,
+		const string& type, bool nested) const;
+};
@@ -109,6 +109,8 @@ void access_list::set_allow_clients(const char* iplist)
 		from.clear();
 		to.clear();
 	}
+
+	acl_iplink_build_index(allow_clients_);
 }
 
 void access_list::set_allow_servers(const char* iplist)
@@ -144,6 +146,7 @@ void access_list::set_allow_servers(const char* iplist)
 	}
 
 	acl_argv_free(tokens);
+	acl_iplink_build_index(allow_servers_);
 }
 
 bool access_list::check_client(const char* ip)
@@ -37,6 +37,7 @@ void allow_list::set_allow_manager(const char* white_list)
 	}
 
 	acl_argv_free(tokens);
+	acl_iplink_build_index(manager_allow_);
 }
 
 bool allow_list::allow_manager(const char* ip)
@@ -32,7 +32,9 @@ typedef struct ACL_MDB ACL_MDB;
 /**
  * һݿ
  * @param dbname {const char*} ݿ
- * @param dbtype {const char*} ݿ: hash/avl
+ * @param dbtype {const char*} ݿ: hash/binhash/avl/btree
+ *  avl  btree Ϊ acl_mdb_range зΧѯbtree
+ *  Ϊ B+ ṹѯΧ avl 
  * @return {ACL_MDB*} ݿ
  */
 ACL_API ACL_MDB *acl_mdb_create(const char *dbname, const char *dbtype);
@@ -106,6 +108,22 @@ ACL_API ACL_MDT_RES *acl_mdb_find(ACL_MDB *mdb, const char *tbl_name,
 ACL_API ACL_MDT_RES *acl_mdb_list(ACL_MDB *mdb, const char *tbl_name,
 	int from, int limit);
 
+/**
+ * ֵֶ˳ѯĳΧڵĽ avl/btree ͵ݿ֧
+ * @param mdb {ACL_MDB*} ݿ
+ * @param tbl_name {const char*} ݱ
+ * @param key_label {const char*} ݱеֶ
+ * @param key_begin {const char*} ֵֶ½()Ϊ NULL ʱʾ
+ * @param key_end {const char*} ֵֶϽ()Ϊ NULL ʱʾ
+ * @param desc {int}  0 ʱֵֶӴС˳򷵻
+ * @param from {int} ѯĽϣǴӸλÿʼд洢
+ * @param limit {int} ѯĽϣ
+ * @return {ACL_MDT_RES*} ѯΪѯΪջ
+ */
+ACL_API ACL_MDT_RES *acl_mdb_range(ACL_MDB *mdb, const char *tbl_name,
+	const char *key_label, const char *key_begin, const char *key_end,
+	int desc, int from, int limit);
+
 /**
  * ݿɾһݼ¼
  * @param mdb {ACL_MDB*} ݿ
@@ -147,7 +165,7 @@ ACL_API int acl_mdb_cnt(ACL_MDB *mdb, const char *tbl_name);
 
 /**
  * һݱ
- * @param dbtype {const char *} : hash/avl
+ * @param dbtype {const char *} : hash/binhash/avl/btree
  * @param tbl_name {const char*} 
  * @param tlb_flag {unsigned int} Ա־λ
  * @param init_capacity {size_t} ÿڲϣĳʼ
@@ -208,6 +226,21 @@ ACL_API ACL_MDT_RES *acl_mdt_find(ACL_MDT *mdt, const char *key_label,
  */
 ACL_API ACL_MDT_RES *acl_mdt_list(ACL_MDT *mdt, int from, int limit);
 
+/**
+ * ֵֶ˳ѯĳΧڵĽ avl/btree ͵ݱ֧
+ * @param mdt {ACL_MDT*} ݱ
+ * @param key_label {const char*} ݱֶ
+ * @param key_begin {const char*} ֵֶ½()Ϊ NULL ʱʾ
+ * @param key_end {const char*} ֵֶϽ()Ϊ NULL ʱʾ
+ * @param desc {int}  0 ʱֵֶӴС˳򷵻
+ * @param from {int} ѯĽϣǴӸλÿʼд洢
+ * @param limit {int} ѯĽϣ
+ * @return {ACL_MDT_RES*} ѯΪѯΪջ
+ */
+ACL_API ACL_MDT_RES *acl_mdt_range(ACL_MDT *mdt, const char *key_label,
+	const char *key_begin, const char *key_end, int desc,
+	int from, int limit);
+
 /**
  * ݱɾӦĳֶμֵĽ
  * @param mdt {ACL_MDT*} ݱ
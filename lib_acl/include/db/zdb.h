@@ -4,6 +4,7 @@
 #include "stdlib/acl_define.h"
 #include "stdlib/acl_vstring.h"
 #include "stdlib/acl_fhandle.h"
+#include "stdlib/acl_bloom.h"
 
 typedef struct ZDB ZDB;
 typedef struct ZDB_KEY_HDR ZDB_KEY_HDR;
@@ -101,6 +102,8 @@ struct ZDB {
 	ACL_VSTRING *path_tmp;	/* ʱõĴ洢ļȫ·, ҪΪ˲ */
 	int   blk_count_tmp;	/* ʱõĿ, ҪΪ˲ */
 	int   inode_tmp;	/* ʱõ·ţҪΪ˲ */
+
+	ACL_BLOOM *filter;	/* ǿʱڹһڵļ */
 };
 
 /* xxx: Ϊ˱֤ƽ̨ԣ½ṹ嶼4ֽڶ */
@@ -300,6 +303,16 @@ ACL_API void zdb_close(ZDB *db);
  */
 ACL_API ZDB_BLK *zdb_lookup(ZDB *db, zdb_key_t key, size_t *size, ZDB_BLK_OFF *blk_off_buf);
 
+/**
+ *  ZDB üĹú zdb_lookup()/4 Ȳѯһ
+ * ļٶ̶ֱӷأzdb_update()/5 ¼ʱҲὫ
+ * @param db {ZDB*} ZDB ݿ
+ * @param filter {ACL_BLOOM*} ɵߴͷţұѰе
+ *  мڹرտʱ acl_bloom_save() ̣򿪿 acl_bloom_open()
+ *  ָΪ NULL ʱʾȡ
+ */
+ACL_API void zdb_set_filter(ZDB *db, ACL_BLOOM *filter);
+
 /**
  *  ZDB_BLK ȡû
  * @param b {ZDB_BLK*}
@@ -9,6 +9,7 @@ extern "C" {
 #include "stdlib/acl_vstring.h"
 #include "stdlib/acl_ring.h"
 #include "stdlib/acl_array.h"
+#include "stdlib/acl_htable.h"
 
 typedef struct ACL_JSON ACL_JSON;
 typedef struct ACL_JSON_NODE ACL_JSON_NODE;
@@ -80,6 +81,7 @@ struct ACL_JSON {
 	int   finish;               /**< Ƿ */
 	unsigned flag;              /**< ־λ */
 #define	ACL_JSON_FLAG_PART_WORD	(1 << 0)  /**< Ƿݰ */
+#define	ACL_JSON_FLAG_TAG_INDEX	(1 << 1)  /**< Ƿʹñǩѯ */
 
 	/* public: for acl_iterator, ͨ acl_foreach гӽ */
 
@@ -100,6 +102,8 @@ struct ACL_JSON {
 	int   max_cache;            /**< json 㻺ص */
 	ACL_JSON_NODE *curr_node;   /**< ǰڴ json  */
 	ACL_SLICE_POOL *slice;      /**< ڴض */
+	ACL_HTABLE *tag_table;      /**< ǩ: ǩ(Сд) ->  */
+	int   tag_dirty;            /**< ֹ޸ĺǩҪؽ */
 };
 
 /*----------------------------- in acl_json.c -----------------------------*/
@@ -209,6 +213,36 @@ ACL_API void acl_json_foreach_init(ACL_JSON *json, ACL_JSON_NODE *node);
  */
 ACL_API void acl_json_cache(ACL_JSON *json, int max_cache);
 
+/**
+ * 򿪻رձǩʱһеĽǩ㼯
+ * ˺ɽÿıǩʱĵ˳
+ * ͬǩֻһݱǩ(Сд)
+ * acl_json_getElementsByTagName ֱӷڵĽ飬
+ * acl_json_getElementsByTags ҲֻеĽ㣬ǩΪյĽ
+ * Уֹӻɾһβѯʱؽ
+ * @param json {ACL_JSON*} json 
+ * @param on {int}  0 ʾ򿪣0 ʾرղͷ
+ */
+ACL_API void acl_json_index(ACL_JSON *json, int on);
+
+/**
+ * ǩѽϵĽǩɽãδʱ
+ * κδ
+ * @param json {ACL_JSON*} json 
+ * @param node {ACL_JSON_NODE*} ǩѽϵĽ
+ */
+ACL_API void acl_json_index_add(ACL_JSON *json, ACL_JSON_NODE *node);
+
+/**
+ * ӱǩвѯǩͬ(ִСд)Ľ㼯ϣ
+ * δ acl_json_index 򱾺Զ
+ * @param json {ACL_JSON*} json 
+ * @param tag {const char*} ǩ
+ * @return {ACL_ARRAY*} ڲĽ飬߲޸Ļͷţ
+ *   json ޸ǰһֱЧ NULL ʾûиñǩĽ
+ */
+ACL_API ACL_ARRAY *acl_json_index_lookup(ACL_JSON *json, const char *tag);
+
 /**
  * ͷ JSON л JSON 
  * @param json {ACL_JSON*} json 
@@ -237,6 +271,19 @@ ACL_API void acl_json_reset(ACL_JSON *json);
  */
 ACL_API void acl_json_update(ACL_JSON *json, const char *data);
 
+/*-------------------------- in acl_json_fast.c ---------------------------*/
+
+/**
+ *  json , ܼɵĽ acl_json_update ͬ,  SIMD
+ * ָṹַ, ٰ, ı׼ json Ҫ
+ * acl_json_update ö; ݲзǱ׼дʱ, Զ
+ * acl_json_update Ľ, Ҳѭô˺
+ * @param json {ACL_JSON*} json ,  acl_json_alloc1 , 
+ *  ڴз
+ * @param data {const char*}  '\0' βַ
+ */
+ACL_API void acl_json_update_fast(ACL_JSON *json, const char *data);
+
 /*------------------------- in acl_json_util.c ----------------------------*/
 
 /**
@@ -254,7 +301,9 @@ ACL_API void acl_json_free_array(ACL_ARRAY *a);
  * @param json {ACL_JSON*} json 
  * @param tag {const char*} ǩ
  * @return {ACL_ARRAY*}  json 㼯,  ̬,  NULL 
- *  ʾûз json , ǿֵҪ acl_json_free_array ͷ
+ *  ʾûз json , ǿֵҪ acl_json_free_array ͷţ
+ *  ѵ acl_json_index ˱ǩ򷵻صڲĽ飬
+ *  ߲޸Ļͷţ json ޸ǰһֱЧ
  */
 ACL_API ACL_ARRAY *acl_json_getElementsByTagName(ACL_JSON *json, const char *tag);
 
@@ -413,6 +462,60 @@ ACL_API ACL_VSTRING *acl_json_build(ACL_JSON *json, ACL_VSTRING *buf);
 ACL_API void acl_json_building(ACL_JSON *json, size_t length,
 	int (*callback)(ACL_JSON *, ACL_VSTRING *, void *), void *ctx);
 
+/*------------------------ in acl_json_binary.c ---------------------------*/
+
+/**
+ *  json תΪ MessagePack ʽĶݣ acl_json_create_bool,
+ * acl_json_create_int64 ȺĲֵΪӦĶͣ
+ * ҶΪַ
+ * @param json {ACL_JSON*} json 
+ * @param buf {ACL_VSTRING*} ǿʱ׷ڸûУڲ
+ *  µĻ
+ * @return {ACL_VSTRING*} űĻ buf Ϊ NULL ʱҪ
+ *  acl_vstring_free ͷ
+ */
+ACL_API ACL_VSTRING *acl_json_build_msgpack(ACL_JSON *json, ACL_VSTRING *buf);
+
+/**
+ * ĳ json תΪ MessagePack ʽǩĽתΪֻһ
+ * ԱĶ
+ * @param node {ACL_JSON_NODE*} json 
+ * @param buf {ACL_VSTRING*} ͬ acl_json_build_msgpack
+ * @return {ACL_VSTRING*} ͬ acl_json_build_msgpack
+ */
+ACL_API ACL_VSTRING *acl_json_node_build_msgpack(ACL_JSON_NODE *node,
+	ACL_VSTRING *buf);
+
+/**
+ * һ MessagePack  json ɵĽĽṹ
+ *  acl_json_update ֵͬ null ӦĽ
+ * @param json {ACL_JSON*} ´ú json 
+ * @param data {const void*} ݣΪ map  array
+ * @param len {size_t} data ݳ
+ * @return {int} ֵ > 0 ʾɹΪõݳȣ
+ *  һ0 ʾݲӦݺͷʼ½
+ *  -1 ʾݸʽ json ǿգֵ <= 0 ʱ json 
+ */
+ACL_API int acl_json_update_msgpack(ACL_JSON *json, const void *data, size_t len);
+
+/**
+ *  json תΪ CBOR(RFC 7049) ʽĶݣͬ
+ * acl_json_build_msgpack
+ */
+ACL_API ACL_VSTRING *acl_json_build_cbor(ACL_JSON *json, ACL_VSTRING *buf);
+
+/**
+ * ĳ json תΪ CBOR ʽͬ acl_json_node_build_msgpack
+ */
+ACL_API ACL_VSTRING *acl_json_node_build_cbor(ACL_JSON_NODE *node,
+	ACL_VSTRING *buf);
+
+/**
+ * һ CBOR  json ֲ֧Ĵ鼰
+ * ıǩֵͬ acl_json_update_msgpack
+ */
+ACL_API int acl_json_update_cbor(ACL_JSON *json, const void *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
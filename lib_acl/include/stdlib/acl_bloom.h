@@ -0,0 +1,189 @@
+#ifndef ACL_BLOOM_INCLUDE_H
+#define ACL_BLOOM_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "acl_define.h"
+#include "acl_vstring.h"
+
+/**
+ * ͹ڷʴ̻ǰжĳһڡ
+ * Ӷν IOѯΪܴڡʱһʣ
+ * ѾӵļжΪ
+ *
+ * ACL_BLOOM: ֿ鲼¡λͼ ACL_BITS_MASKÿ̽λ
+ *  ͬһ 64 ֽڵĿ(һ cache line)Уÿβѯֻһڴ棬
+ *  ֧ɾ
+ * ACL_CUCKOO: ÿͰ 4  16 λָƣ֧ɾװʿ
+ *  ﵽ 95%
+ */
+typedef struct ACL_BLOOM ACL_BLOOM;
+typedef struct ACL_CUCKOO ACL_CUCKOO;
+
+/*----------------------------- ACL_BLOOM ----------------------------------*/
+
+/**
+ * ¡
+ * @param capacity {size_t} Ԥӵļĸ
+ * @param fp_rate {double} ʣ 0.01ȡֵΧΪ (0, 1)
+ * @return {ACL_BLOOM*}
+ */
+ACL_API ACL_BLOOM *acl_bloom_create(size_t capacity, double fp_rate);
+
+/**
+ * ͷŲ¡
+ * @param bloom {ACL_BLOOM*}
+ */
+ACL_API void acl_bloom_free(ACL_BLOOM *bloom);
+
+/**
+ * һ
+ * @param bloom {ACL_BLOOM*}
+ * @param key {const void*} 
+ * @param len {size_t} key ĳ
+ */
+ACL_API void acl_bloom_add(ACL_BLOOM *bloom, const void *key, size_t len);
+
+/**
+ * жĳǷܴ
+ * @param bloom {const ACL_BLOOM*}
+ * @param key {const void*} 
+ * @param len {size_t} key ĳ
+ * @return {int} 0 ʾһڣ 0 ʾܴ
+ */
+ACL_API int acl_bloom_test(const ACL_BLOOM *bloom, const void *key, size_t len);
+
+/**
+ * չем
+ * @param bloom {ACL_BLOOM*}
+ */
+ACL_API void acl_bloom_reset(ACL_BLOOM *bloom);
+
+/**
+ * ӵļĴ
+ * @param bloom {const ACL_BLOOM*}
+ * @return {acl_uint64}
+ */
+ACL_API acl_uint64 acl_bloom_count(const ACL_BLOOM *bloom);
+
+/**
+ * л׷ӵУݸʽֽƽ̨޹
+ * @param bloom {const ACL_BLOOM*}
+ * @param buf {ACL_VSTRING*} 洢
+ */
+ACL_API void acl_bloom_dump(const ACL_BLOOM *bloom, ACL_VSTRING *buf);
+
+/**
+ *  acl_bloom_dump Ľлָ
+ * @param data {const void*} л
+ * @param len {size_t} data ĳ
+ * @return {ACL_BLOOM*}  NULL ʾݸʽ
+ */
+ACL_API ACL_BLOOM *acl_bloom_load(const void *data, size_t len);
+
+/**
+ * ļдʱļٸԲ²ȱļ
+ * @param bloom {const ACL_BLOOM*}
+ * @param path {const char*} ļ·
+ * @return {int} 0 ʾɹ-1 ʾʧ
+ */
+ACL_API int acl_bloom_save(const ACL_BLOOM *bloom, const char *path);
+
+/**
+ *  acl_bloom_save ɵļлָ
+ * @param path {const char*} ļ·
+ * @return {ACL_BLOOM*}  NULL ʾļڻʽ
+ */
+ACL_API ACL_BLOOM *acl_bloom_open(const char *path);
+
+/*----------------------------- ACL_CUCKOO ---------------------------------*/
+
+/**
+ * ԼΪ 0.012%
+ * @param capacity {size_t} ӵļĸ
+ * @return {ACL_CUCKOO*}
+ */
+ACL_API ACL_CUCKOO *acl_cuckoo_create(size_t capacity);
+
+/**
+ * ͷŲ
+ * @param cuckoo {ACL_CUCKOO*}
+ */
+ACL_API void acl_cuckoo_free(ACL_CUCKOO *cuckoo);
+
+/**
+ * һͬһӶʱҪɾͬ
+ * @param cuckoo {ACL_CUCKOO*}
+ * @param key {const void*} 
+ * @param len {size_t} key ĳ
+ * @return {int} 0 ʾɹ-1 ʾʱüδ
+ */
+ACL_API int acl_cuckoo_add(ACL_CUCKOO *cuckoo, const void *key, size_t len);
+
+/**
+ * ɾһӹļɾδӹļܻɾļ
+ * @param cuckoo {ACL_CUCKOO*}
+ * @param key {const void*} 
+ * @param len {size_t} key ĳ
+ * @return {int} 0 ʾɾɹ-1 ʾ
+ */
+ACL_API int acl_cuckoo_del(ACL_CUCKOO *cuckoo, const void *key, size_t len);
+
+/**
+ * жĳǷܴ
+ * @param cuckoo {const ACL_CUCKOO*}
+ * @param key {const void*} 
+ * @param len {size_t} key ĳ
+ * @return {int} 0 ʾһڣ 0 ʾܴ
+ */
+ACL_API int acl_cuckoo_test(const ACL_CUCKOO *cuckoo, const void *key, size_t len);
+
+/**
+ * չем
+ * @param cuckoo {ACL_CUCKOO*}
+ */
+ACL_API void acl_cuckoo_reset(ACL_CUCKOO *cuckoo);
+
+/**
+ * ùмĸ
+ * @param cuckoo {const ACL_CUCKOO*}
+ * @return {acl_uint64}
+ */
+ACL_API acl_uint64 acl_cuckoo_count(const ACL_CUCKOO *cuckoo);
+
+/**
+ * л׷ӵУݸʽֽƽ̨޹
+ * @param cuckoo {const ACL_CUCKOO*}
+ * @param buf {ACL_VSTRING*} 洢
+ */
+ACL_API void acl_cuckoo_dump(const ACL_CUCKOO *cuckoo, ACL_VSTRING *buf);
+
+/**
+ *  acl_cuckoo_dump Ľлָ
+ * @param data {const void*} л
+ * @param len {size_t} data ĳ
+ * @return {ACL_CUCKOO*}  NULL ʾݸʽ
+ */
+ACL_API ACL_CUCKOO *acl_cuckoo_load(const void *data, size_t len);
+
+/**
+ * ļ
+ * @param cuckoo {const ACL_CUCKOO*}
+ * @param path {const char*} ļ·
+ * @return {int} 0 ʾɹ-1 ʾʧ
+ */
+ACL_API int acl_cuckoo_save(const ACL_CUCKOO *cuckoo, const char *path);
+
+/**
+ *  acl_cuckoo_save ɵļлָ
+ * @param path {const char*} ļ·
+ * @return {ACL_CUCKOO*}  NULL ʾļڻʽ
+ */
+ACL_API ACL_CUCKOO *acl_cuckoo_open(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
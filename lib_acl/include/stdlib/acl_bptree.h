@@ -0,0 +1,139 @@
+#ifndef ACL_BPTREE_INCLUDE_H
+#define ACL_BPTREE_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "acl_define.h"
+
+/**
+ * ڴ B+ ÿɴ ACL_BPTREE_ORDER (СΪɸ cache
+ * line)ݶҶУҶ֮˫
+ * зΧ avl/acl_btree ÿԪһĶṹȣ
+ * ѯʱʵĽڴ
+ */
+typedef struct ACL_BPTREE ACL_BPTREE;
+
+#define ACL_BPTREE_ORDER	32	/**< ÿŵļ */
+
+/**
+ *  acl_bptree_seek Ⱥʼ޸ĺʧЧ
+ */
+typedef struct ACL_BPTREE_ITER {
+	const void *key;	/**< ǰԪصļ */
+	void *value;		/**< ǰԪصֵ */
+
+	/* private */
+	void *leaf;
+	int   pos;
+} ACL_BPTREE_ITER;
+
+/**
+ *  B+ 
+ * @param cmp_fn {int (*)(const void*, const void*)} ıȽϺ
+ *  ֵ <0, 0, >0 ֱʾСڡڡڣ strcmp
+ * @return {ACL_BPTREE*}
+ */
+ACL_API ACL_BPTREE *acl_bptree_create(int (*cmp_fn)(const void*, const void*));
+
+/**
+ * ͷ B+ 
+ * @param tree {ACL_BPTREE*}
+ * @param free_fn {void (*)(void*, void*)} ǿʱÿԪصļֵ
+ *  úͷû
+ */
+ACL_API void acl_bptree_free(ACL_BPTREE *tree, void (*free_fn)(void*, void*));
+
+/**
+ * һԪأֻ key  value ĵַ
+ * @param tree {ACL_BPTREE*}
+ * @param key {const void*} 
+ * @param value {void*} ֵ
+ * @return {int} 0 ʾӳɹ-1 ʾüѾ
+ */
+ACL_API int acl_bptree_add(ACL_BPTREE *tree, const void *key, void *value);
+
+/**
+ * ѯĳӦֵ
+ * @param tree {const ACL_BPTREE*}
+ * @param key {const void*}
+ * @return {void*}  NULL ʾ
+ */
+ACL_API void *acl_bptree_find(const ACL_BPTREE *tree, const void *key);
+
+/**
+ * ɾĳ
+ * @param tree {ACL_BPTREE*}
+ * @param key {const void*}
+ * @param pkey {const void**} ǿʱ洢бɾԪصļַԱ
+ *  ͷ
+ * @return {void*} ɾԪصֵ NULL ʾ
+ */
+ACL_API void *acl_bptree_delete(ACL_BPTREE *tree, const void *key,
+	const void **pkey);
+
+/**
+ * Ѿظ㾡
+ * öࣻΪ
+ * @param tree {ACL_BPTREE*}
+ * @param keys {const void*[]} 
+ * @param values {void*[]} ֵ
+ * @param n {int} 鳤
+ * @return {int} 0 ʾɹ-1 ʾǿջϸ
+ */
+ACL_API int acl_bptree_load(ACL_BPTREE *tree, const void *keys[],
+	void *values[], int n);
+
+/**
+ * Ԫظ
+ * @param tree {const ACL_BPTREE*}
+ * @return {int}
+ */
+ACL_API int acl_bptree_count(const ACL_BPTREE *tree);
+
+/**
+ * ĸ߶
+ * @param tree {const ACL_BPTREE*}
+ * @return {int}
+ */
+ACL_API int acl_bptree_depth(const ACL_BPTREE *tree);
+
+/**
+ * λһ >= key Ԫأʱʹ
+ * @param tree {const ACL_BPTREE*}
+ * @param iter {ACL_BPTREE_ITER*}
+ * @param key {const void*} Ϊ NULL ʱλСԪ
+ * @return {int} 0 ʾλɹ-1 ʾûԪ
+ */
+ACL_API int acl_bptree_seek(const ACL_BPTREE *tree, ACL_BPTREE_ITER *iter,
+	const void *key);
+
+/**
+ * λһ <= key Ԫأʱʹ
+ * @param tree {const ACL_BPTREE*}
+ * @param iter {ACL_BPTREE_ITER*}
+ * @param key {const void*} Ϊ NULL ʱλԪ
+ * @return {int} 0 ʾλɹ-1 ʾûԪ
+ */
+ACL_API int acl_bptree_seek_last(const ACL_BPTREE *tree,
+	ACL_BPTREE_ITER *iter, const void *key);
+
+/**
+ * Ƶһ()Ԫ
+ * @param iter {ACL_BPTREE_ITER*}
+ * @return {int} 0 ʾɹ-1 ʾѾĩβ
+ */
+ACL_API int acl_bptree_next(ACL_BPTREE_ITER *iter);
+
+/**
+ * Ƶһ(С)Ԫ
+ * @param iter {ACL_BPTREE_ITER*}
+ * @return {int} 0 ʾɹ-1 ʾѾ￪ͷ
+ */
+ACL_API int acl_bptree_prev(ACL_BPTREE_ITER *iter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -35,6 +35,11 @@ typedef	struct ACL_DLINK {
 	void *(*iter_tail)(ACL_ITER*, struct ACL_DLINK*);
 	/* ȡһ */
 	void *(*iter_prev)(ACL_ITER*, struct ACL_DLINK*);
+
+	/* private */
+	unsigned int version;	/**< ÿ޸ */
+	void *index;		/**< acl_iplink_build_index Ĳѯ */
+	unsigned int index_version;	/**< ʱ version */
 } ACL_DLINK;
 
 /**
@@ -39,6 +39,15 @@ ACL_API ACL_IPITEM *acl_iplink_modify(ACL_IPLINK *plink, const char *pstrip_id,
 ACL_API int acl_iplink_count_item(ACL_IPLINK *plink);
 ACL_API int acl_iplink_list(const ACL_IPLINK *plink);
 
+/**
+ * Ϊ IP ַ LPM(ǰ׺ƥ) ѯ˺ acl_iplink_lookup_bin
+ *  acl_iplink_lookup_str Ĳѯʱַθ޹أַ޸ĺ
+ * ԶʧЧ(ѯ˻Ϊֲ)Ҫµñ
+ * @param plink {ACL_IPLINK*}
+ * @return {int} 0 ʾɹ-1 ʾʧ
+ */
+ACL_API int acl_iplink_build_index(ACL_IPLINK *plink);
+
 #ifdef  __cplusplus
 }
 #endif
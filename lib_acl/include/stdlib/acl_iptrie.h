@@ -0,0 +1,117 @@
+#ifndef ACL_IPTRIE_INCLUDE_H
+#define ACL_IPTRIE_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "acl_define.h"
+
+/**
+ * IPv4/IPv6 ǰ׺ƥ(LPM)ڲԶǰ׺洢 CIDR ַΣ
+ *  acl_iptrie_compile  poptrie ṹ(16 λֱ + ÿ 6 λ
+ * λͼѹڵ)ѯʱַֻλйأַεĸ޹أ
+ * IPv4  4 ڵ㣬IPv6  20 ڵ
+ */
+typedef struct ACL_IPTRIE ACL_IPTRIE;
+
+/**
+ *  LPM 
+ * @return {ACL_IPTRIE*}
+ */
+ACL_API ACL_IPTRIE *acl_iptrie_create(void);
+
+/**
+ * ͷ LPM 
+ * @param trie {ACL_IPTRIE*}
+ */
+ACL_API void acl_iptrie_free(ACL_IPTRIE *trie);
+
+/**
+ * һַΣͬĵַѾʱ滻Ӧֵ
+ * @param trie {ACL_IPTRIE*}
+ * @param cidr {const char*} ַΣʽ磺192.168.0.0/16, 10.0.0.1,
+ *  2001:db8::/32, ::1볤ʱʾַ
+ * @param value {void*} õַιֵ NULL
+ * @return {int} 0 ʾɹ-1 ʾַʽǷ
+ */
+ACL_API int acl_iptrie_add(ACL_IPTRIE *trie, const char *cidr, void *value);
+
+/**
+ * һ IPv4 ַΧڲὫΪٵ CIDR ַ
+ * @param trie {ACL_IPTRIE*}
+ * @param begin {unsigned int} ʼַ(ֽ)
+ * @param end {unsigned int} ַ(ֽ) >= begin
+ * @param value {void*} õַιֵ NULL
+ * @return {int} ֺ CIDR ַθ-1 ʾǷ
+ */
+ACL_API int acl_iptrie_add_range4(ACL_IPTRIE *trie, unsigned int begin,
+	unsigned int end, void *value);
+
+/**
+ * ɾһַ
+ * @param trie {ACL_IPTRIE*}
+ * @param cidr {const char*} ַΣʽͬ acl_iptrie_add
+ * @return {int} 0 ʾɾɹ-1 ʾڻʽǷ
+ */
+ACL_API int acl_iptrie_del(ACL_IPTRIE *trie, const char *cidr);
+
+/**
+ * еĵַ
+ * @param trie {ACL_IPTRIE*}
+ */
+ACL_API void acl_iptrie_reset(ACL_IPTRIE *trie);
+
+/**
+ * ӵĵַαֻ poptrie ѯṹӻɾַκ
+ * δ±룬ѯʱڶǰ׺Ͻ(ٶȽȻȷ)
+ * вܲѯ
+ * @param trie {ACL_IPTRIE*}
+ * @return {int} 0 ʾɹ
+ */
+ACL_API int acl_iptrie_compile(ACL_IPTRIE *trie);
+
+/**
+ * ѯĳַƥǰ׺ֵַúΪֻ
+ * Զ̲߳
+ * @param trie {const ACL_IPTRIE*}
+ * @param ip {const char*} IPv4  IPv6 ַIPv4 ַԴ :port ׺
+ * @return {void*}  NULL ʾδҵ
+ */
+ACL_API void *acl_iptrie_lookup(const ACL_IPTRIE *trie, const char *ip);
+
+/**
+ * ѯ IPv4 ַ
+ * @param trie {const ACL_IPTRIE*}
+ * @param ip {unsigned int} ֽ IPv4 ַ
+ * @return {void*}  NULL ʾδҵ
+ */
+ACL_API void *acl_iptrie_lookup4(const ACL_IPTRIE *trie, unsigned int ip);
+
+/**
+ * ѯ IPv6 ַ
+ * @param trie {const ACL_IPTRIE*}
+ * @param ip {const unsigned char*} 16 ֽֽ IPv6 ַ
+ * @return {void*}  NULL ʾδҵ
+ */
+ACL_API void *acl_iptrie_lookup6(const ACL_IPTRIE *trie, const unsigned char *ip);
+
+/**
+ * õַεĸ
+ * @param trie {const ACL_IPTRIE*}
+ * @return {int}
+ */
+ACL_API int acl_iptrie_count(const ACL_IPTRIE *trie);
+
+/**
+ *  IPv4/IPv6 ַַ
+ * @param ip {const char*} ַַ
+ * @param addr {unsigned char*}  16 ֽڵĻ洢ֽĵַ
+ * @return {int} 4 ʾ IPv46 ʾ IPv6-1 ʾʽǷ
+ */
+ACL_API int acl_iptrie_parse(const char *ip, unsigned char *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,6 +23,10 @@ extern "C" {
 #include "acl_cache2.h"
 #include "avl.h"
 #include "acl_token_tree.h"
+#include "acl_token_ac.h"
+#include "acl_iptrie.h"
+#include "acl_bptree.h"
+#include "acl_bloom.h"
 #include "acl_iterator.h"
 
 #include "acl_iostuff.h"
@@ -0,0 +1,141 @@
+#ifndef ACL_TOKEN_AC_INCLUDE_H
+#define ACL_TOKEN_AC_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "acl_define.h"
+#include "acl_token_tree.h"
+
+/**
+ * ˫(double-array)洢 Aho-Corasick ģʽƥԶ
+ *  ACL_TOKEN 256 ָȣйؼһɨȫƥ䣬
+ * ״̬ڵΪյĶ飬̣߱ʱֱ mmap 
+ */
+typedef struct ACL_TOKEN_AC ACL_TOKEN_AC;
+
+/**
+ * ƥʱظߵĽ
+ */
+typedef struct ACL_TOKEN_AC_HIT {
+	int   id;		/**< ؼʱ(˳ 0 ʼ) */
+	const char *word;	/**< ؼʱ */
+	size_t len;		/**< ؼʳ */
+	size_t off;		/**< λڱƥеʼƫ */
+	unsigned int flag;	/**< ؼʱ־λACL_TOKEN_F_XXX */
+	const void *ctx;	/**< ûӹؼʱĲļʱΪ NULL */
+} ACL_TOKEN_AC_HIT;
+
+#define ACL_TOKEN_AC_F_NONE	0
+#define ACL_TOKEN_AC_F_ICASE	(1 << 0)	/**<  ASCII ĸСд */
+
+/**
+ * һ AC Զ󣬴ӹؼʣȻ
+ * acl_token_ac_compile ſƥ
+ * @param flags {unsigned int} ACL_TOKEN_AC_F_XXX ־λ
+ * @return {ACL_TOKEN_AC*}
+ */
+ACL_API ACL_TOKEN_AC *acl_token_ac_create(unsigned int flags);
+
+/**
+ * ͷ acl_token_ac_create  acl_token_ac_load Ķ
+ * @param ac {ACL_TOKEN_AC*}
+ */
+ACL_API void acl_token_ac_free(ACL_TOKEN_AC *ac);
+
+/**
+ * һؼʣؼѾʱ־λ
+ * @param ac {ACL_TOKEN_AC*}
+ * @param word {const char*} ǿַ
+ * @param flag {unsigned int} ACL_TOKEN_F_XXX ־λ ACL_TOKEN_F_STOP
+ *  ᱻԶ
+ * @param ctx {const void*} ûʱͨ ACL_TOKEN_AC_HIT 
+ * @return {int} عؼʱ(>= 0) -1 ʾ(Ƿ
+ *  ļض)
+ */
+ACL_API int acl_token_ac_add(ACL_TOKEN_AC *ac, const char *word,
+	unsigned int flag, const void *ctx);
+
+/**
+ * һ ACL_TOKEN ƥейؼ(־λ)ԶУ
+ * ԱԭдǨ
+ * @param ac {ACL_TOKEN_AC*}
+ * @param token_tree {const ACL_TOKEN*}
+ * @return {int} ӵĹؼʸ-1 ʾ
+ */
+ACL_API int acl_token_ac_add_tree(ACL_TOKEN_AC *ac, const ACL_TOKEN *token_tree);
+
+/**
+ * ļмعؼʣÿһʽ acl_token_tree_load_deny ͬ
+ * word|d  word|pδָʱʹȱʡ־λ
+ * @param ac {ACL_TOKEN_AC*}
+ * @param filepath {const char*} ؼļ·
+ * @param flag_default {unsigned int} ȱʡ־λ
+ * @return {int} ӵĹؼʸ-1 ʾ
+ */
+ACL_API int acl_token_ac_load_words(ACL_TOKEN_AC *ac, const char *filepath,
+	unsigned int flag_default);
+
+/**
+ * ӵĹؼʱ˫ʽ AC ԶȻԼ
+ * ؼʣ±¹ؼʲŻЧ
+ * @param ac {ACL_TOKEN_AC*}
+ * @return {int} 0 ʾɹ-1 ʾʧ
+ */
+ACL_API int acl_token_ac_compile(ACL_TOKEN_AC *ac);
+
+/**
+ * ݽһɨ裬ÿһؼ(໥صĹؼ)
+ * صһûĺ
+ * @param ac {const ACL_TOKEN_AC*} ѾصԶ
+ * @param s {const char*} ƥ
+ * @param len {size_t} s ݳ
+ * @param hit_fn {int (*)(const ACL_TOKEN_AC_HIT*, void*)} ʱĻص
+ *  úط 0 ֵʱֹͣɨ
+ * @param arg {void*} صĲ
+ * @return {int} еĴ
+ */
+ACL_API int acl_token_ac_scan(const ACL_TOKEN_AC *ac, const char *s, size_t len,
+	int (*hit_fn)(const ACL_TOKEN_AC_HIT*, void*), void *arg);
+
+/**
+ * еһеĹؼ(λǰߣؼ
+ * ͬһλýʱȡ)
+ * @param ac {const ACL_TOKEN_AC*} ѾصԶ
+ * @param s {const char*} ƥ
+ * @param len {size_t} s ݳ
+ * @param hit {ACL_TOKEN_AC_HIT*} ǿʱн
+ * @return {int} 1 ʾУ0 ʾδ
+ */
+ACL_API int acl_token_ac_find(const ACL_TOKEN_AC *ac, const char *s,
+	size_t len, ACL_TOKEN_AC_HIT *hit);
+
+/**
+ * Զйؼʵĸ
+ * @param ac {const ACL_TOKEN_AC*}
+ * @return {int}
+ */
+ACL_API int acl_token_ac_count(const ACL_TOKEN_AC *ac);
+
+/**
+ * õԶ洢ļУԱ߱룬ļΪֽ
+ * @param ac {const ACL_TOKEN_AC*} ѾõԶ
+ * @param filepath {const char*} Ŀļ·
+ * @return {int} 0 ʾɹ-1 ʾʧ
+ */
+ACL_API int acl_token_ac_save(const ACL_TOKEN_AC *ac, const char *filepath);
+
+/**
+ *  acl_token_ac_save ɵļмԶ UNIX ƽ̨²ֻ
+ * mmap ʽӳ䣬̿Թͬһڴ棻غĶ
+ * ӹؼʣйؼʵ ctx Ϊ NULL
+ * @param filepath {const char*} ļ·
+ * @return {ACL_TOKEN_AC*}  NULL ʾļڻʽǷ
+ */
+ACL_API ACL_TOKEN_AC *acl_token_ac_load(const char *filepath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -104,6 +104,7 @@ struct ACL_XML {
 	unsigned flag;              /**< ־λ: ACL_XML_FLAG_xxx */ 
 #define	ACL_XML_FLAG_PART_WORD		(1 << 0) /**< ǷݺΪת '\'  */
 #define	ACL_XML_FLAG_IGNORE_SLASH	(1 << 1) /**< Ƿݵû '/'  */
+#define	ACL_XML_FLAG_TAG_INDEX		(1 << 2) /**< Ƿʹñǩѯ */
 
 	/* public: for acl_iterator, ͨ acl_foreach гӽ */
 
@@ -115,6 +116,12 @@ struct ACL_XML {
 	ACL_XML_NODE *(*iter_tail)(ACL_ITER*, ACL_XML*);
 	/* ȡһ */
 	ACL_XML_NODE *(*iter_prev)(ACL_ITER*, ACL_XML*);
+
+	/* private */
+	ACL_HTABLE *tag_table;      /**< ǩ: ǩ(Сд) ->  */
+	int   tag_dirty;            /**< ֹ޸ĺǩҪؽ */
+	ACL_ARRAY *attr_cache;      /**< ýͷųԶ󻺴 */
+	const char *data_end;       /**< ǰݽβ '\0' λ */
 };
 
 #define	ACL_XML_IS_COMMENT(x)	(((x)->flag & ACL_XML_F_META_CM))
@@ -177,13 +184,44 @@ ACL_API void acl_xml_foreach_init(ACL_XML *xml, ACL_XML_NODE *node);
 ACL_API void acl_xml_slash(ACL_XML *xml, int ignore);
 
 /**
- * 򿪻رXMLĻ湦ܣ ACL_XML ʱXMLĽ㻺湦Ч
+ * 򿪻رXMLĻ湦ܣ ACL_XML ʱXMLĽ㻺湦Чʣ
+ * ԶҲᱻ渴ãӶⷴʱƵͷڴ
  * @param xml {ACL_XML*} xml 
  * @param max_cache {int} ֵֵ > 0 ʱ xml  xml 
  *  湦ܣر xml  xml Ļ湦
  */
 ACL_API void acl_xml_cache(ACL_XML *xml, int max_cache);
 
+/**
+ * 򿪻رձǩʱһеĽǩ㼯
+ * ˺ɽÿıǩʱĵ˳
+ * ͬǩֻһݱǩ(Сд)
+ * acl_xml_getElementsByTagName ֱӷڵĽ飬
+ * acl_xml_getElementsByTags ҲֻеĽ㣬ǩΪյĽ
+ * Уֹӻɾһβѯʱؽ
+ * @param xml {ACL_XML*} xml 
+ * @param on {int}  0 ʾ򿪣0 ʾرղͷ
+ */
+ACL_API void acl_xml_index(ACL_XML *xml, int on);
+
+/**
+ * ǩѽϵĽǩɽãδʱ
+ * κδ
+ * @param xml {ACL_XML*} xml 
+ * @param node {ACL_XML_NODE*} ǩѽϵĽ
+ */
+ACL_API void acl_xml_index_add(ACL_XML *xml, ACL_XML_NODE *node);
+
+/**
+ * ӱǩвѯǩͬ(ִСд)Ľ㼯ϣ
+ * δ acl_xml_index 򱾺Զ
+ * @param xml {ACL_XML*} xml 
+ * @param tag {const char*} ǩ
+ * @return {ACL_ARRAY*} ڲĽ飬߲޸Ļͷţ
+ *   xml ޸ǰһֱЧ NULL ʾûиñǩĽ
+ */
+ACL_API ACL_ARRAY *acl_xml_index_lookup(ACL_XML *xml, const char *tag);
+
 /**
  * ͷ XML  XML 
  * @param xml {ACL_XML*} xml 
@@ -258,7 +296,9 @@ ACL_API void acl_xml_free_array(ACL_ARRAY *a);
  * @param xml {ACL_XML*} xml 
  * @param tag {const char*} ǩ
  * @return {ACL_ARRAY*}  xml 㼯,  ̬,  NULL 
- *  ʾûз xml , ǿֵҪ acl_xml_free_array ͷ
+ *  ʾûз xml , ǿֵҪ acl_xml_free_array ͷţ
+ *  ѵ acl_xml_index ˱ǩ򷵻صڲĽ飬
+ *  ߲޸Ļͷţ xml ޸ǰһֱЧ
  */
 ACL_API ACL_ARRAY *acl_xml_getElementsByTagName(ACL_XML *xml, const char *tag);
 
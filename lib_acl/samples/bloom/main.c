@@ -0,0 +1,268 @@
+#include "lib_acl.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include "util.h"
+
+#define	KEY(buf, prefix, i) \
+	snprintf((buf), sizeof(buf), "%s-%d", (prefix), (i))
+
+static void test_bloom(int n, double fp_rate)
+{
+	ACL_BLOOM *bloom = acl_bloom_create(n, fp_rate), *bloom2;
+	ACL_VSTRING *buf = acl_vstring_alloc(1024);
+	const char *path = "./bloom.dat";
+	char  key[64];
+	int   i, nfp = 0;
+	double rate;
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "in", i);
+		acl_bloom_add(bloom, key, strlen(key));
+	}
+	CHECK(acl_bloom_count(bloom) == (acl_uint64) n);
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "in", i);
+		CHECK(acl_bloom_test(bloom, key, strlen(key)));
+	}
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "out", i);
+		if (acl_bloom_test(bloom, key, strlen(key)))
+			nfp++;
+	}
+	rate = (double) nfp / n;
+	printf("bloom: %d keys, expected fp rate %.4f, real %.4f\n",
+		n, fp_rate, rate);
+	CHECK(rate < fp_rate * 1.5);
+
+	acl_bloom_dump(bloom, buf);
+	bloom2 = acl_bloom_load(acl_vstring_str(buf), ACL_VSTRING_LEN(buf));
+	CHECK(bloom2 != NULL);
+	if (bloom2) {
+		for (i = 0; i < n; i++) {
+			KEY(key, "in", i);
+			CHECK(acl_bloom_test(bloom2, key, strlen(key)));
+		}
+		CHECK(acl_bloom_count(bloom2) == (acl_uint64) n);
+		acl_bloom_free(bloom2);
+	}
+
+	/* a truncated one must be refused */
+	CHECK(acl_bloom_load(acl_vstring_str(buf),
+		ACL_VSTRING_LEN(buf) - 1) == NULL);
+
+	CHECK(acl_bloom_save(bloom, path) == 0);
+	bloom2 = acl_bloom_open(path);
+	CHECK(bloom2 != NULL);
+	if (bloom2) {
+		for (i = 0; i < n; i++) {
+			KEY(key, "in", i);
+			CHECK(acl_bloom_test(bloom2, key, strlen(key)));
+		}
+		acl_bloom_free(bloom2);
+	}
+	remove(path);
+
+	acl_bloom_reset(bloom);
+	KEY(key, "in", 0);
+	CHECK(!acl_bloom_test(bloom, key, strlen(key)));
+
+	acl_vstring_free(buf);
+	acl_bloom_free(bloom);
+}
+
+static void test_cuckoo(int n)
+{
+	ACL_CUCKOO *cuckoo = acl_cuckoo_create(n), *cuckoo2;
+	ACL_VSTRING *buf = acl_vstring_alloc(1024);
+	const char *path = "./cuckoo.dat";
+	char  key[64];
+	int   i, nfp = 0, nfull = 0;
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "in", i);
+		if (acl_cuckoo_add(cuckoo, key, strlen(key)) < 0)
+			nfull++;
+	}
+	CHECK(nfull == 0);
+	CHECK(acl_cuckoo_count(cuckoo) == (acl_uint64) n);
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_test(cuckoo, key, strlen(key)));
+	}
+	for (i = 0; i < n; i++) {
+		KEY(key, "out", i);
+		if (acl_cuckoo_test(cuckoo, key, strlen(key)))
+			nfp++;
+	}
+	printf("cuckoo: %d keys, fp rate %.5f\n", n, (double) nfp / n);
+	CHECK((double) nfp / n < 0.001);
+
+	acl_cuckoo_dump(cuckoo, buf);
+	cuckoo2 = acl_cuckoo_load(acl_vstring_str(buf), ACL_VSTRING_LEN(buf));
+	CHECK(cuckoo2 != NULL);
+	if (cuckoo2) {
+		for (i = 0; i < n; i++) {
+			KEY(key, "in", i);
+			CHECK(acl_cuckoo_test(cuckoo2, key, strlen(key)));
+		}
+		acl_cuckoo_free(cuckoo2);
+	}
+
+	CHECK(acl_cuckoo_save(cuckoo, path) == 0);
+	cuckoo2 = acl_cuckoo_open(path);
+	CHECK(cuckoo2 != NULL);
+	if (cuckoo2) {
+		CHECK(acl_cuckoo_count(cuckoo2) == (acl_uint64) n);
+		acl_cuckoo_free(cuckoo2);
+	}
+	remove(path);
+
+	/* delete the even ones, the odd ones must still be there */
+	for (i = 0; i < n; i += 2) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_del(cuckoo, key, strlen(key)) == 0);
+	}
+	for (i = 1; i < n; i += 2) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_test(cuckoo, key, strlen(key)));
+	}
+	CHECK(acl_cuckoo_count(cuckoo) == (acl_uint64) (n / 2));
+
+	for (i = 1; i < n; i += 2) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_del(cuckoo, key, strlen(key)) == 0);
+	}
+	CHECK(acl_cuckoo_count(cuckoo) == 0);
+	KEY(key, "in", 1);
+	CHECK(!acl_cuckoo_test(cuckoo, key, strlen(key)));
+	CHECK(acl_cuckoo_del(cuckoo, key, strlen(key)) == -1);
+
+	acl_vstring_free(buf);
+	acl_cuckoo_free(cuckoo);
+}
+
+/* add more keys than its capacity, it must never lose any key added */
+static void test_cuckoo_full(int n)
+{
+	ACL_CUCKOO *cuckoo = acl_cuckoo_create(n);
+	char  key[64];
+	int   i, added;
+
+	for (i = 0; i < n * 2; i++) {
+		KEY(key, "in", i);
+		if (acl_cuckoo_add(cuckoo, key, strlen(key)) < 0)
+			break;
+	}
+	added = i;
+	printf("cuckoo: capacity %d, %d keys added before full\n", n, added);
+	CHECK(added >= n);
+
+	for (i = 0; i < added; i++) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_test(cuckoo, key, strlen(key)));
+	}
+
+	/* there is room again after some keys were deleted */
+	for (i = 0; i < added; i += 2) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_del(cuckoo, key, strlen(key)) == 0);
+	}
+	for (i = 1; i < added; i += 2) {
+		KEY(key, "in", i);
+		CHECK(acl_cuckoo_test(cuckoo, key, strlen(key)));
+	}
+	KEY(key, "new", 0);
+	CHECK(acl_cuckoo_add(cuckoo, key, strlen(key)) == 0);
+
+	acl_cuckoo_free(cuckoo);
+}
+
+static void bench(int n)
+{
+	ACL_BLOOM *bloom = acl_bloom_create(n, 0.01);
+	ACL_CUCKOO *cuckoo = acl_cuckoo_create(n);
+	char **keys = (char**) acl_mymalloc(n * sizeof(char*));
+	struct timeval begin, end;
+	char  key[64];
+	int   i, n1 = 0, n2 = 0;
+
+	for (i = 0; i < n; i++) {
+		KEY(key, "key", i);
+		keys[i] = acl_mystrdup(key);
+		acl_bloom_add(bloom, key, strlen(key));
+		acl_cuckoo_add(cuckoo, key, strlen(key));
+	}
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++) {
+		if (acl_bloom_test(bloom, keys[(i * 7) % n],
+			strlen(keys[(i * 7) % n])))
+		{
+			n1++;
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("bloom  test %d: %.2f ms\n", n1, util_stamp_sub(&end, &begin));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++) {
+		if (acl_cuckoo_test(cuckoo, keys[(i * 7) % n],
+			strlen(keys[(i * 7) % n])))
+		{
+			n2++;
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("cuckoo test %d: %.2f ms\n", n2, util_stamp_sub(&end, &begin));
+	CHECK(n1 == n && n2 == n);
+
+	for (i = 0; i < n; i++)
+		acl_myfree(keys[i]);
+	acl_myfree(keys);
+	acl_bloom_free(bloom);
+	acl_cuckoo_free(cuckoo);
+}
+
+static void usage(const char *procname)
+{
+	printf("usage: %s -h[help] -b[benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char *argv[])
+{
+	int   ch, benchmark = 0, n = 1000000;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0) {
+		switch (ch) {
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			benchmark = 1;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	test_bloom(100000, 0.01);
+	test_bloom(100000, 0.001);
+	test_bloom(100000, 0.0001);
+	test_cuckoo(100000);
+	test_cuckoo(1000);
+	test_cuckoo_full(10000);
+
+	if (benchmark)
+		bench(n);
+
+	return util_check_result();
+}
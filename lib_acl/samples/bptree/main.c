@@ -0,0 +1,408 @@
+#include "lib_acl.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include "util.h"
+
+static int cmp_str(const void *v1, const void *v2)
+{
+	return strcmp((const char*) v1, (const char*) v2);
+}
+
+static int cmp_int(const void *v1, const void *v2)
+{
+	long n1 = (long) v1, n2 = (long) v2;
+
+	return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+}
+
+/* check the tree holds exactly the keys marked in the map, in order */
+static int check_tree(ACL_BPTREE *tree, const char *map, int max)
+{
+	ACL_BPTREE_ITER iter;
+	long  k, prev = -1;
+	int   n = 0, i;
+
+	for (i = 0; i < max; i++)
+		n += map[i] ? 1 : 0;
+	if (acl_bptree_count(tree) != n)
+		return -1;
+
+	n = 0;
+	if (acl_bptree_seek(tree, &iter, NULL) == 0) {
+		do {
+			k = (long) iter.key;
+			if (k <= prev || !map[k] || (long) iter.value != k * 10)
+				return -1;
+			prev = k;
+			n++;
+		} while (acl_bptree_next(&iter) == 0);
+	}
+	if (n != acl_bptree_count(tree))
+		return -1;
+
+	prev = max;
+	if (acl_bptree_seek_last(tree, &iter, NULL) == 0) {
+		do {
+			k = (long) iter.key;
+			if (k >= prev)
+				return -1;
+			prev = k;
+			n--;
+		} while (acl_bptree_prev(&iter) == 0);
+	}
+	return n == 0 ? 0 : -1;
+}
+
+static void test_random(int max, int nops)
+{
+	ACL_BPTREE *tree = acl_bptree_create(cmp_int);
+	char *map = (char*) acl_mycalloc(1, max);
+	long  k;
+	int   i, nbad = 0;
+
+	for (i = 0; i < nops; i++) {
+		k = rand() % max;
+		/* more adds than deletes at first, then shrink the tree */
+		if ((i < nops / 2 && rand() % 3 != 0)
+			|| (i >= nops / 2 && rand() % 3 == 0))
+		{
+			if (acl_bptree_add(tree, (void*) k, (void*) (k * 10))
+				!= (map[k] ? -1 : 0))
+			{
+				nbad++;
+			}
+			map[k] = 1;
+		} else {
+			const void *key = NULL;
+			void *v = acl_bptree_delete(tree, (void*) k, &key);
+
+			if (map[k] ? (v != (void*) (k * 10) || key != (void*) k)
+				: v != NULL)
+			{
+				nbad++;
+			}
+			map[k] = 0;
+		}
+		if (acl_bptree_find(tree, (void*) k) != (map[k] ?
+			(void*) (k * 10) : NULL))
+		{
+			nbad++;
+		}
+		if (i % 1000 == 0 && check_tree(tree, map, max) < 0)
+			nbad++;
+	}
+
+	CHECK(check_tree(tree, map, max) == 0);
+
+	/* delete all of them */
+	for (k = 0; k < max; k++) {
+		if (map[k] && acl_bptree_delete(tree, (void*) k, NULL) == NULL)
+			nbad++;
+		map[k] = 0;
+	}
+	CHECK(acl_bptree_count(tree) == 0 && acl_bptree_depth(tree) == 0);
+
+	printf("random test: %d ops, %d errors\n", nops, nbad);
+	CHECK(nbad == 0);
+	acl_myfree(map);
+	acl_bptree_free(tree, NULL);
+}
+
+static void test_seek(void)
+{
+	ACL_BPTREE *tree = acl_bptree_create(cmp_int);
+	const void *keys[1000];
+	void *values[1000];
+	ACL_BPTREE_ITER iter;
+	long  i;
+
+	/* the even numbers 0, 2, ... 1998 */
+	for (i = 0; i < 1000; i++) {
+		keys[i] = (void*) (i * 2);
+		values[i] = (void*) (i * 20);
+	}
+	CHECK(acl_bptree_load(tree, keys, values, 1000) == 0);
+	CHECK(acl_bptree_load(tree, keys, values, 1000) == -1);
+	CHECK(acl_bptree_count(tree) == 1000);
+	CHECK(acl_bptree_depth(tree) == 2);
+
+	CHECK(acl_bptree_seek(tree, &iter, (void*) 101) == 0);
+	CHECK((long) iter.key == 102);
+	CHECK(acl_bptree_seek(tree, &iter, (void*) 102) == 0);
+	CHECK((long) iter.key == 102);
+	CHECK(acl_bptree_seek(tree, &iter, (void*) 1999) == -1);
+	CHECK(acl_bptree_seek_last(tree, &iter, (void*) 101) == 0);
+	CHECK((long) iter.key == 100);
+	CHECK(acl_bptree_seek_last(tree, &iter, (void*) -1) == -1);
+	CHECK(acl_bptree_seek_last(tree, &iter, NULL) == 0);
+	CHECK((long) iter.key == 1998);
+	CHECK(acl_bptree_next(&iter) == -1);
+
+	/* the tree built by loading can be modified as usual */
+	CHECK(acl_bptree_add(tree, (void*) 101, (void*) 1010) == 0);
+	CHECK(acl_bptree_add(tree, (void*) 102, (void*) 1020) == -1);
+	CHECK(acl_bptree_find(tree, (void*) 101) == (void*) 1010);
+	for (i = 0; i < 2000; i += 2)
+		CHECK(acl_bptree_delete(tree, (void*) i, NULL) == (void*) (i * 10));
+	CHECK(acl_bptree_count(tree) == 1);
+
+	keys[1] = keys[0];
+	acl_bptree_free(tree, NULL);
+	tree = acl_bptree_create(cmp_int);
+	CHECK(acl_bptree_load(tree, keys, values, 10) == -1);
+	acl_bptree_free(tree, NULL);
+}
+
+static void free_str(void *key, void *value acl_unused)
+{
+	acl_myfree(key);
+}
+
+/* the deleted key's memory is freed at once, the separators in the inner
+ * nodes mustn't refer to it
+ */
+static void test_strings(int n)
+{
+	ACL_BPTREE *tree = acl_bptree_create(cmp_str);
+	char  buf[32];
+	union {
+		void *key;
+		const void *c_key;
+	} key;
+	char *ptr;
+	int   i;
+
+	for (i = 0; i < n; i++) {
+		snprintf(buf, sizeof(buf), "key-%08d", i);
+		ptr = acl_mystrdup(buf);
+		acl_bptree_add(tree, ptr, ptr);
+	}
+	for (i = 0; i < n; i += 2) {
+		snprintf(buf, sizeof(buf), "key-%08d", i);
+		CHECK(acl_bptree_delete(tree, buf, &key.c_key) != NULL);
+		memset(key.key, 'x', strlen(buf));
+		acl_myfree(key.key);
+	}
+	for (i = 0; i < n; i++) {
+		snprintf(buf, sizeof(buf), "key-%08d", i);
+		CHECK((acl_bptree_find(tree, buf) != NULL) == (i % 2 == 1));
+	}
+	for (i = 1; i < n; i += 2) {
+		ACL_BPTREE_ITER iter;
+
+		snprintf(buf, sizeof(buf), "key-%08d", i);
+		CHECK(acl_bptree_seek(tree, &iter, buf) == 0
+			&& strcmp((const char*) iter.key, buf) == 0);
+	}
+	CHECK(acl_bptree_count(tree) == n / 2);
+	acl_bptree_free(tree, free_str);
+}
+
+typedef struct USER {
+	char  name[32];
+	char  age[8];
+} USER;
+
+static void test_mdb(const char *dbtype)
+{
+	const char *labels[] = { "name", "age", NULL };
+	unsigned int flags[] = { ACL_MDT_FLAG_UNI, 0, 0 };
+	const char *keys[3];
+	ACL_MDB *mdb = acl_mdb_create("test", dbtype);
+	ACL_MDT_RES *res;
+	const USER *row;
+	USER  user;
+	int   i;
+
+	acl_mdb_tbl_create(mdb, "user", ACL_MDT_FLAG_NUL, 100, labels, flags);
+	for (i = 0; i < 100; i++) {
+		snprintf(user.name, sizeof(user.name), "user-%03d", i);
+		snprintf(user.age, sizeof(user.age), "%02d", 20 + i % 10);
+		keys[0] = user.name;
+		keys[1] = user.age;
+		keys[2] = NULL;
+		acl_mdb_add(mdb, "user", &user, sizeof(user), labels, keys);
+	}
+
+	res = acl_mdb_range(mdb, "user", "name", "user-010", "user-019", 0, 0, 0);
+	CHECK(acl_mdt_row_count(res) == 10);
+	row = (const USER*) acl_mdt_fetch_row(res);
+	CHECK(row && strcmp(row->name, "user-010") == 0);
+	acl_mdt_res_free(res);
+
+	res = acl_mdb_range(mdb, "user", "name", NULL, "user-0505", 1, 2, 3);
+	CHECK(acl_mdt_row_count(res) == 3);
+	row = (const USER*) acl_mdt_fetch_row(res);
+	CHECK(row && strcmp(row->name, "user-048") == 0);
+	acl_mdt_res_free(res);
+
+	/* each age has 10 users */
+	res = acl_mdb_range(mdb, "user", "age", "25", NULL, 0, 0, 0);
+	CHECK(acl_mdt_row_count(res) == 50);
+	acl_mdt_res_free(res);
+
+	CHECK(acl_mdb_del(mdb, "user", "age", "27", NULL) == 10);
+	res = acl_mdb_range(mdb, "user", "age", "25", "28", 1, 0, 0);
+	CHECK(acl_mdt_row_count(res) == 30);
+	row = (const USER*) acl_mdt_fetch_row(res);
+	CHECK(row && strcmp(row->age, "28") == 0);
+	acl_mdt_res_free(res);
+
+	CHECK(acl_mdb_range(mdb, "user", "name", "z", NULL, 0, 0, 0) == NULL);
+	CHECK(acl_mdb_find(mdb, "user", "name", "user-057", 0, 0) == NULL);
+	res = acl_mdb_find(mdb, "user", "name", "user-058", 0, 0);
+	CHECK(acl_mdt_row_count(res) == 1);
+	acl_mdt_res_free(res);
+
+	acl_mdb_free(mdb);
+}
+
+/*****************************************************************************/
+
+typedef struct AVL_NODE {
+	const char *key;
+	avl_node_t node;
+} AVL_NODE;
+
+static int avl_cmp(const void *v1, const void *v2)
+{
+	int   ret = strcmp(((const AVL_NODE*) v1)->key,
+			((const AVL_NODE*) v2)->key);
+
+	return ret < 0 ? -1 : (ret > 0 ? 1 : 0);
+}
+
+static void bench(int n)
+{
+	ACL_BPTREE *tree = acl_bptree_create(cmp_str), *tree2;
+	avl_tree_t avl;
+	AVL_NODE *nodes = (AVL_NODE*) acl_mycalloc(n, sizeof(AVL_NODE)), key;
+	char **strs = (char**) acl_mymalloc(n * sizeof(char*));
+	const void **sorted = (const void**) acl_mymalloc(n * sizeof(void*));
+	void **values = (void**) acl_mycalloc(n, sizeof(void*));
+	ACL_BPTREE_ITER iter;
+	struct timeval begin, end;
+	AVL_NODE *pnode;
+	void *cookie;
+	int   i, found = 0, found2 = 0;
+	long  sum = 0, sum2 = 0;
+
+	for (i = 0; i < n; i++) {
+		char buf[32];
+
+		snprintf(buf, sizeof(buf), "%08x%d", (unsigned) rand(), i);
+		strs[i] = acl_mystrdup(buf);
+	}
+	avl_create(&avl, avl_cmp, sizeof(AVL_NODE), offsetof(AVL_NODE, node));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++) {
+		nodes[i].key = strs[i];
+		avl_add(&avl, &nodes[i]);
+	}
+	gettimeofday(&end, NULL);
+	printf("avl    add %d: %.2f ms\n", n, util_stamp_sub(&end, &begin));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++)
+		acl_bptree_add(tree, strs[i], strs[i]);
+	gettimeofday(&end, NULL);
+	printf("bptree add %d: %.2f ms, depth: %d\n", n,
+		util_stamp_sub(&end, &begin), acl_bptree_depth(tree));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++) {
+		key.key = strs[(int) (((long long) i * 7919) % n)];
+		if (avl_find(&avl, &key, NULL) != NULL)
+			found++;
+	}
+	gettimeofday(&end, NULL);
+	printf("avl    find: %d, %.2f ms\n", found,
+		util_stamp_sub(&end, &begin));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < n; i++) {
+		if (acl_bptree_find(tree, strs[(int) (((long long) i * 7919) % n)]) != NULL)
+			found2++;
+	}
+	gettimeofday(&end, NULL);
+	printf("bptree find: %d, %.2f ms\n", found2,
+		util_stamp_sub(&end, &begin));
+	CHECK(found == found2);
+
+	gettimeofday(&begin, NULL);
+	for (pnode = avl_first(&avl); pnode; pnode = AVL_NEXT(&avl, pnode))
+		sum += (long) pnode->key[0];
+	gettimeofday(&end, NULL);
+	printf("avl    scan: %.2f ms\n", util_stamp_sub(&end, &begin));
+
+	gettimeofday(&begin, NULL);
+	if (acl_bptree_seek(tree, &iter, NULL) == 0) {
+		i = 0;
+		do {
+			sorted[i++] = iter.key;
+			sum2 += (long) ((const char*) iter.key)[0];
+		} while (acl_bptree_next(&iter) == 0);
+	}
+	gettimeofday(&end, NULL);
+	printf("bptree scan: %.2f ms\n", util_stamp_sub(&end, &begin));
+	CHECK(sum == sum2);
+
+	tree2 = acl_bptree_create(cmp_str);
+	gettimeofday(&begin, NULL);
+	CHECK(acl_bptree_load(tree2, sorted, values, n) == 0);
+	gettimeofday(&end, NULL);
+	printf("bptree load %d sorted: %.2f ms\n", n,
+		util_stamp_sub(&end, &begin));
+
+	acl_bptree_free(tree2, NULL);
+	acl_bptree_free(tree, NULL);
+	cookie = NULL;
+	while (avl_destroy_nodes(&avl, &cookie) != NULL) {}
+	avl_destroy(&avl);
+	for (i = 0; i < n; i++)
+		acl_myfree(strs[i]);
+	acl_myfree(strs);
+	acl_myfree(sorted);
+	acl_myfree(values);
+	acl_myfree(nodes);
+}
+
+static void usage(const char *procname)
+{
+	printf("usage: %s -h[help] -b[benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char *argv[])
+{
+	int   ch, benchmark = 0, n = 1000000;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0) {
+		switch (ch) {
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			benchmark = 1;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	test_random(5000, 200000);
+	test_seek();
+	test_strings(10000);
+	test_mdb("btree");
+	test_mdb("avl");
+
+	if (benchmark)
+		bench(n);
+
+	return util_check_result();
+}
@@ -0,0 +1,320 @@
+#include "lib_acl.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include "util.h"
+
+static void test_parse(void)
+{
+	unsigned char addr[16];
+	static const unsigned char loop6[16] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+	static const unsigned char mapped[16] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 10, 1, 2, 3 };
+
+	CHECK(acl_iptrie_parse("192.168.1.20", addr) == 4);
+	CHECK(addr[0] == 192 && addr[3] == 20);
+	CHECK(acl_iptrie_parse("192.168.1.20:8080", addr) == 4);
+	CHECK(acl_iptrie_parse("192.168.1.256", addr) == -1);
+	CHECK(acl_iptrie_parse("192.168.1", addr) == -1);
+	CHECK(acl_iptrie_parse("::1", addr) == 6);
+	CHECK(memcmp(addr, loop6, 16) == 0);
+	CHECK(acl_iptrie_parse("[::1]:80", addr) == 6);
+	CHECK(memcmp(addr, loop6, 16) == 0);
+	CHECK(acl_iptrie_parse("::ffff:10.1.2.3", addr) == 6);
+	CHECK(memcmp(addr, mapped, 16) == 0);
+	CHECK(acl_iptrie_parse("2001:db8::8:800:200c:417a", addr) == 6);
+	CHECK(addr[0] == 0x20 && addr[1] == 0x01 && addr[15] == 0x7a);
+	CHECK(acl_iptrie_parse("fe80::1%eth0", addr) == 6);
+	CHECK(acl_iptrie_parse("1::2::3", addr) == -1);
+	CHECK(acl_iptrie_parse("1:2:3:4:5:6:7:8:9", addr) == -1);
+	CHECK(acl_iptrie_parse("12345::", addr) == -1);
+}
+
+static void test_basic(int compile)
+{
+	ACL_IPTRIE *trie = acl_iptrie_create();
+
+	CHECK(acl_iptrie_add(trie, "10.0.0.0/8", "a") == 0);
+	CHECK(acl_iptrie_add(trie, "10.1.0.0/16", "b") == 0);
+	CHECK(acl_iptrie_add(trie, "10.1.2.3", "c") == 0);
+	CHECK(acl_iptrie_add(trie, "192.168.0.0/255", "x") == -1);
+	CHECK(acl_iptrie_add(trie, "2001:db8::/32", "d") == 0);
+	CHECK(acl_iptrie_add(trie, "2001:db8:1::/48", "e") == 0);
+	CHECK(acl_iptrie_add(trie, "::1", "f") == 0);
+	CHECK(acl_iptrie_count(trie) == 6);
+	if (compile)
+		acl_iptrie_compile(trie);
+
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.2.3.4"), "a") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.3.4"), "b") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.2.3:80"), "c") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.2.4"), "b") == 0);
+	CHECK(acl_iptrie_lookup(trie, "11.0.0.1") == NULL);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "2001:db8:2::1"), "d") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "2001:db8:1:ffff::1"), "e") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "::1"), "f") == 0);
+	CHECK(acl_iptrie_lookup(trie, "::2") == NULL);
+	CHECK(acl_iptrie_lookup(trie, "bad") == NULL);
+
+	/* the lookup is still right before compiling again */
+	CHECK(acl_iptrie_del(trie, "10.1.0.0/16") == 0);
+	CHECK(acl_iptrie_del(trie, "10.1.0.0/16") == -1);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.3.4"), "a") == 0);
+	acl_iptrie_compile(trie);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.3.4"), "a") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "10.1.2.3"), "c") == 0);
+
+	/* the default route */
+	acl_iptrie_add(trie, "0.0.0.0/0", "z");
+	acl_iptrie_compile(trie);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "11.0.0.1"), "z") == 0);
+
+	acl_iptrie_reset(trie);
+	CHECK(acl_iptrie_count(trie) == 0);
+	CHECK(acl_iptrie_lookup(trie, "10.1.2.3") == NULL);
+	acl_iptrie_free(trie);
+}
+
+static void test_range(void)
+{
+	ACL_IPTRIE *trie = acl_iptrie_create();
+
+	/* 192.168.0.1 - 192.168.0.255: /32 /31 /30 /29 /28 /27 /26 /25 */
+	CHECK(acl_iptrie_add_range4(trie, 0xc0a80001, 0xc0a800ff, "r") == 8);
+	CHECK(acl_iptrie_add_range4(trie, 0, 0xffffffff, "all") == 1);
+	CHECK(acl_iptrie_add_range4(trie, 2, 1, "x") == -1);
+	acl_iptrie_compile(trie);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "192.168.0.0"), "all") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "192.168.0.1"), "r") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "192.168.0.255"), "r") == 0);
+	CHECK(strcmp(acl_iptrie_lookup(trie, "192.168.1.0"), "all") == 0);
+	acl_iptrie_free(trie);
+}
+
+/* compare the compiled lookup with a linear longest prefix scan */
+typedef struct {
+	unsigned int net;
+	int   len;
+} PREFIX;
+
+static int linear_lookup(const PREFIX *prefixes, int n, unsigned int ip)
+{
+	int   i, best = -1, best_len = -1;
+	unsigned int mask;
+
+	for (i = 0; i < n; i++) {
+		mask = prefixes[i].len == 0 ? 0
+			: 0xffffffff << (32 - prefixes[i].len);
+		if ((ip & mask) == prefixes[i].net && prefixes[i].len > best_len) {
+			best = i;
+			best_len = prefixes[i].len;
+		}
+	}
+	return best;
+}
+
+static void test_random(int n, int nlookup)
+{
+	ACL_IPTRIE *trie = acl_iptrie_create();
+	PREFIX *prefixes = (PREFIX*) acl_mycalloc(n, sizeof(PREFIX));
+	char  cidr[64];
+	unsigned int ip;
+	void *v1, *v2;
+	int   i, j, k, nbad = 0;
+
+	for (i = 0; i < n; i++) {
+		prefixes[i].len = 8 + rand() % 25;
+		prefixes[i].net = ((unsigned int) rand() << 16 ^ (unsigned int) rand())
+			& (0xffffffff << (32 - prefixes[i].len));
+		/* make the prefixes cluster so that they are nested */
+		prefixes[i].net = (prefixes[i].net & 0x00ffffff) | 0x0a000000;
+		for (j = 0; j < i; j++) {
+			if (prefixes[j].net == prefixes[i].net
+				&& prefixes[j].len == prefixes[i].len)
+			{
+				break;
+			}
+		}
+		if (j < i) {
+			i--;
+			continue;
+		}
+		snprintf(cidr, sizeof(cidr), "%u.%u.%u.%u/%d",
+			prefixes[i].net >> 24, (prefixes[i].net >> 16) & 0xff,
+			(prefixes[i].net >> 8) & 0xff, prefixes[i].net & 0xff,
+			prefixes[i].len);
+		acl_iptrie_add(trie, cidr, &prefixes[i]);
+	}
+
+	for (k = 0; k < nlookup; k++) {
+		i = rand() % n;
+		ip = prefixes[i].net | ((unsigned int) rand()
+			& ~(0xffffffff << (32 - prefixes[i].len)));
+		if (k % 3 == 0)
+			ip ^= 1u << (rand() % 32);
+		v1 = acl_iptrie_lookup4(trie, ip);   /* uncompiled */
+		j = linear_lookup(prefixes, n, ip);
+		if (v1 != (j >= 0 ? &prefixes[j] : NULL))
+			nbad++;
+	}
+
+	acl_iptrie_compile(trie);
+	for (k = 0; k < nlookup; k++) {
+		i = rand() % n;
+		ip = prefixes[i].net | ((unsigned int) rand()
+			& ~(0xffffffff << (32 - prefixes[i].len)));
+		if (k % 3 == 0)
+			ip ^= 1u << (rand() % 32);
+		v2 = acl_iptrie_lookup4(trie, ip);
+		j = linear_lookup(prefixes, n, ip);
+		if (v2 != (j >= 0 ? &prefixes[j] : NULL))
+			nbad++;
+	}
+
+	printf("random test: %d prefixes, %d lookups, %d mismatched\n",
+		n, nlookup * 2, nbad);
+	CHECK(nbad == 0);
+	acl_myfree(prefixes);
+	acl_iptrie_free(trie);
+}
+
+static void test_iplink(void)
+{
+	ACL_IPLINK *link = acl_iplink_create(10);
+	ACL_IPITEM *item;
+
+	acl_iplink_insert(link, "192.168.0.1", "192.168.0.100");
+	acl_iplink_insert(link, "10.0.0.0", "10.255.255.255");
+	CHECK(acl_iplink_build_index(link) == 0);
+
+	item = acl_iplink_lookup_str(link, "192.168.0.50");
+	CHECK(item != NULL && item->begin == 0xc0a80001);
+	CHECK(acl_iplink_lookup_str(link, "192.168.0.101") == NULL);
+	CHECK(acl_iplink_lookup_str(link, "10.9.8.7") != NULL);
+
+	/* the index is out of date after being modified */
+	acl_iplink_insert(link, "192.168.0.101", "192.168.0.200");
+	CHECK(acl_iplink_lookup_str(link, "192.168.0.150") != NULL);
+	acl_iplink_build_index(link);
+	CHECK(acl_iplink_lookup_str(link, "192.168.0.150") != NULL);
+	CHECK(acl_iplink_lookup_str(link, "192.168.0.201") == NULL);
+	acl_iplink_free(link);
+}
+
+static void test_access(void)
+{
+	acl_access_add("127.0.0.1:127.0.0.1, 192.168.0.1:192.168.0.255,"
+		" 10.0.0.0/8, 2001:db8::/32, ::1", ",", ":");
+	CHECK(acl_access_permit("127.0.0.1:8080"));
+	CHECK(acl_access_permit("192.168.0.3"));
+	CHECK(!acl_access_permit("192.168.1.3:80"));
+	CHECK(acl_access_permit("10.20.30.40:80"));
+	CHECK(acl_access_permit("2001:db8::1234"));
+	CHECK(acl_access_permit("[::1]:80"));
+	CHECK(!acl_access_permit("2001:db9::1"));
+	acl_access_debug();
+}
+
+/* compare with the binary search of acl_iplink */
+static void bench(int n, int nlookup)
+{
+	ACL_IPTRIE *trie = acl_iptrie_create();
+	ACL_IPLINK *link = acl_iplink_create(n);
+	unsigned int *ips = (unsigned int*) acl_mymalloc(nlookup * sizeof(int));
+	unsigned int ip;
+	struct timeval begin, end;
+	int   i, n1 = 0, n2 = 0;
+
+	for (i = 0; i < n; i++) {
+		ip = ((unsigned int) rand() << 16 ^ (unsigned int) rand())
+			& 0xffffff00;
+		acl_iplink_insert_bin(link, ip, ip + 0xff);
+	}
+	for (i = 0; i < acl_iplink_count_item(link); i++) {
+		ACL_IPITEM *item = acl_dlink_index(link, i);
+		acl_iptrie_add_range4(trie, (unsigned int) item->begin,
+			(unsigned int) item->end, item);
+	}
+
+	gettimeofday(&begin, NULL);
+	acl_iptrie_compile(trie);
+	gettimeofday(&end, NULL);
+	printf("compile %d ranges: %.2f ms\n", acl_iplink_count_item(link),
+		util_stamp_sub(&end, &begin));
+
+	for (i = 0; i < nlookup; i++) {
+		ips[i] = (unsigned int) rand() << 16 ^ (unsigned int) rand();
+		if (i % 2 == 0)
+			ips[i] = (unsigned int) acl_dlink_index(link,
+				rand() % acl_iplink_count_item(link))->begin
+				| (ips[i] & 0xff);
+	}
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < nlookup; i++) {
+		if (acl_dlink_lookup(link, ips[i]) != NULL)
+			n1++;
+	}
+	gettimeofday(&end, NULL);
+	printf("binary search: %d found, %.2f ms\n", n1,
+		util_stamp_sub(&end, &begin));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < nlookup; i++) {
+		if (acl_iptrie_lookup4(trie, ips[i]) != NULL)
+			n2++;
+	}
+	gettimeofday(&end, NULL);
+	printf("poptrie:       %d found, %.2f ms\n", n2,
+		util_stamp_sub(&end, &begin));
+	CHECK(n1 == n2);
+
+	acl_myfree(ips);
+	acl_iplink_free(link);
+	acl_iptrie_free(trie);
+}
+
+static void usage(const char *procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		" -b[benchmark] -n ranges_count -N lookup_count\r\n", procname);
+}
+
+int main(int argc, char *argv[])
+{
+	int   ch, benchmark = 0, n = 100000, nlookup = 10000000;
+
+	while ((ch = getopt(argc, argv, "hbn:N:")) > 0) {
+		switch (ch) {
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			benchmark = 1;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'N':
+			nlookup = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	test_parse();
+	test_basic(0);
+	test_basic(1);
+	test_range();
+	test_random(2000, 100000);
+	test_iplink();
+	test_access();
+
+	if (benchmark)
+		bench(n, nlookup);
+
+	return util_check_result();
+}
@@ -0,0 +1,425 @@
+#include "lib_acl.h"
+#include <getopt.h>
+#include <sys/time.h>
+#include "util.h"
+
+#define	STR	acl_vstring_str
+#define	LEN	ACL_VSTRING_LEN
+
+/* ԱȽĽǷȫͬ */
+
+static void dump_node(const ACL_JSON_NODE *node, ACL_VSTRING *out)
+{
+	ACL_RING_ITER iter;
+	int   i = 0, tag = -1;
+
+	acl_ring_foreach(iter, &node->children) {
+		const ACL_JSON_NODE *child = acl_ring_to_appl(iter.ptr,
+			ACL_JSON_NODE, node);
+		if (child == node->tag_node)
+			tag = i;
+		i++;
+	}
+
+	acl_vstring_sprintf_append(out, "(%d %d %c%c <%s> <%s> %d",
+		node->type, node->depth, node->left_ch ? node->left_ch : '-',
+		node->right_ch ? node->right_ch : '-',
+		STR(node->ltag), STR(node->text), tag);
+
+	acl_ring_foreach(iter, &node->children) {
+		const ACL_JSON_NODE *child = acl_ring_to_appl(iter.ptr,
+			ACL_JSON_NODE, node);
+		dump_node(child, out);
+	}
+	ACL_VSTRING_ADDCH(out, ')');
+	ACL_VSTRING_TERMINATE(out);
+}
+
+static void dump_json(const ACL_JSON *json, ACL_VSTRING *out)
+{
+	ACL_VSTRING_RESET(out);
+	acl_vstring_sprintf(out, "%d %d %d ", json->finish, json->depth,
+		json->node_cnt);
+	dump_node(json->root, out);
+}
+
+/* ֱͬһݣȽϽstep > 0 ʱ */
+
+static bool compare(const char *data, size_t step, ACL_SLICE_POOL *slice)
+{
+	ACL_JSON *json1 = acl_json_alloc1(slice);
+	ACL_JSON *json2 = acl_json_alloc1(slice);
+	ACL_VSTRING *buf1 = acl_vstring_alloc(1024);
+	ACL_VSTRING *buf2 = acl_vstring_alloc(1024);
+	bool  ret;
+
+	acl_json_update(json1, data);
+
+	if (step == 0)
+		acl_json_update_fast(json2, data);
+	else {
+		ACL_VSTRING *part = acl_vstring_alloc(step + 1);
+		size_t len = strlen(data), n;
+
+		for (n = 0; n < len; n += step) {
+			acl_vstring_strncpy(part, data + n,
+				len - n > step ? step : len - n);
+			acl_json_update_fast(json2, STR(part));
+		}
+		acl_vstring_free(part);
+	}
+
+	dump_json(json1, buf1);
+	dump_json(json2, buf2);
+	ret = strcmp(STR(buf1), STR(buf2)) == 0;
+	if (!ret)
+		printf("data: %s\r\nold:  %s\r\nfast: %s\r\n",
+			data, STR(buf1), STR(buf2));
+
+	acl_vstring_free(buf1);
+	acl_vstring_free(buf2);
+	acl_json_free(json1);
+	acl_json_free(json2);
+	return ret;
+}
+
+static const char *__cases[] = {
+	"{}",
+	"  {  }  ",
+	"{\"a\": 1}",
+	"{\"a\":\"x\",\"b\":-1.5e3,\"c\":true,\"d\":false,\"e\":null}",
+	"{\"a\": {}, \"b\": [], \"c\": [{}], \"d\": [[]], \"\": {\"x\": 1}}",
+	"{\"a\": [1, \"x\", {\"b\": 2}, [3, [4, {}]], null], \"c\": {\"d\": {\"e\": [\"f\"]}}}",
+	"{\"s\": \"  leading spaces\", \"t\": \"\\t tab\", \"u\": \"\\u4e2d\\u6587\"}",
+	"{\"esc\": \"a\\\"b\\\\\\\"c\\\\\", \"k\\\"ey\": \"\\b\\f\\n\\r\\t\\/\"}",
+	"{\"brackets\": \"{[:,]}\", \"q\": \"'\", \"x\": \"\\\\\"}",
+	"{\r\n\t\"a\" :\r\n [ 1 ,\t2 ] ,\r\n \"b\" : { \"c\" : \"d\" } \r\n}\r\n",
+	"{\"a\": 1} trailing data",
+	/* ΪǱ׼дٽʱӦ״̬ */
+	"{'a': 'b'}",
+	"{a: b, c: [1, 2]}",
+	"{\"a\": 1,}",
+	"{\"a\": [1, 2,]}",
+	"{\"a\": 1; \"b\": 2}",
+	"{\"a\": , \"b\": 2}",
+	"{\"a\": x\\y}",
+	"{\"a\": 1 2}",
+	"{\"a\": [1}]",
+	"junk {\"a\": 1}",
+	"\xef\xbb\xbf{\"a\": 1}",
+	/*  */
+	"{\"a\": [1, 2",
+	"{\"a\": \"xxx",
+	"{\"a\\",
+	"",
+	"   ",
+	NULL,
+};
+
+static void test_cases(ACL_SLICE_POOL *slice)
+{
+	size_t step;
+	int   i;
+
+	for (i = 0; __cases[i] != NULL; i++) {
+		CHECK(compare(__cases[i], 0, slice));
+		for (step = 1; step < 8; step++)
+			CHECK(compare(__cases[i], step, slice));
+	}
+}
+
+/*  json ݣַкпԽ 64 ֽڱ߽ת */
+
+static void random_string(ACL_VSTRING *out)
+{
+	static const char chars[] = "ab {}[]:,'\\\"";
+	int   n = rand() % 80, i;
+
+	ACL_VSTRING_ADDCH(out, '"');
+	if (rand() % 4 == 0)
+		acl_vstring_strcat(out, "  ");
+	for (i = 0; i < n; i++) {
+		int ch = chars[rand() % (sizeof(chars) - 1)];
+		if (ch == '\\') {
+			int k = rand() % 5, j;
+			static const char esc[] = "\\\"/bfnrtu";
+			for (j = 0; j < k; j++)
+				acl_vstring_strcat(out, "\\\\");
+			ACL_VSTRING_ADDCH(out, '\\');
+			ACL_VSTRING_ADDCH(out, esc[rand() % (sizeof(esc) - 1)]);
+		} else if (ch == '"')
+			acl_vstring_strcat(out, "\\\"");
+		else
+			ACL_VSTRING_ADDCH(out, ch);
+	}
+	ACL_VSTRING_ADDCH(out, '"');
+}
+
+static void random_space(ACL_VSTRING *out)
+{
+	static const char spaces[] = " \t\r\n";
+
+	while (rand() % 3 == 0)
+		ACL_VSTRING_ADDCH(out, spaces[rand() % 4]);
+}
+
+static void random_value(ACL_VSTRING *out, int depth)
+{
+	int   n, i, type = rand() % (depth > 5 ? 4 : 6);
+
+	random_space(out);
+	switch (type) {
+	case 0:
+		random_string(out);
+		break;
+	case 1:
+		acl_vstring_sprintf_append(out, "%d.%de-%d", rand() - RAND_MAX / 2,
+			rand() % 1000, rand() % 10);
+		break;
+	case 2:
+		acl_vstring_strcat(out, rand() % 2 ? "true" : "null");
+		break;
+	case 3:
+		acl_vstring_sprintf_append(out, "%d", rand() % 100);
+		break;
+	case 4:
+		n = rand() % 5;
+		ACL_VSTRING_ADDCH(out, '[');
+		for (i = 0; i < n; i++) {
+			if (i > 0)
+				ACL_VSTRING_ADDCH(out, ',');
+			random_value(out, depth + 1);
+		}
+		random_space(out);
+		ACL_VSTRING_ADDCH(out, ']');
+		break;
+	default:
+		n = rand() % 5;
+		ACL_VSTRING_ADDCH(out, '{');
+		for (i = 0; i < n; i++) {
+			if (i > 0)
+				ACL_VSTRING_ADDCH(out, ',');
+			random_space(out);
+			random_string(out);
+			random_space(out);
+			ACL_VSTRING_ADDCH(out, ':');
+			random_value(out, depth + 1);
+		}
+		random_space(out);
+		ACL_VSTRING_ADDCH(out, '}');
+		break;
+	}
+	random_space(out);
+}
+
+static void random_json(ACL_VSTRING *out)
+{
+	int   n = 1 + rand() % 6, i;
+
+	ACL_VSTRING_RESET(out);
+	ACL_VSTRING_ADDCH(out, '{');
+	for (i = 0; i < n; i++) {
+		if (i > 0)
+			ACL_VSTRING_ADDCH(out, ',');
+		random_string(out);
+		ACL_VSTRING_ADDCH(out, ':');
+		random_value(out, 0);
+	}
+	ACL_VSTRING_ADDCH(out, '}');
+	ACL_VSTRING_TERMINATE(out);
+}
+
+static void test_random(int n, ACL_SLICE_POOL *slice)
+{
+	ACL_VSTRING *buf = acl_vstring_alloc(1024);
+	int   i, nfail = 0;
+
+	srand(1);
+	for (i = 0; i < n; i++) {
+		random_json(buf);
+		if (!compare(STR(buf), 0, slice))
+			nfail++;
+		if (i % 10 == 0 && !compare(STR(buf), 1 + rand() % 200, slice))
+			nfail++;
+		if (nfail > 5)
+			break;
+	}
+	CHECK(nfail == 0);
+	acl_vstring_free(buf);
+}
+
+/*---------------------------- benchmark ---------------------------------*/
+
+/* ճõ json ݼɣtwitter (ַΪ)canada 
+ * ()citm (Ƕ׶)
+ */
+
+static void corpus_twitter(ACL_VSTRING *out, size_t size)
+{
+	int   i = 0;
+
+	acl_vstring_strcpy(out, "{\"statuses\": [");
+	while (LEN(out) < size) {
+		if (i > 0)
+			ACL_VSTRING_ADDCH(out, ',');
+		acl_vstring_sprintf_append(out,
+			"{\"id\": %d, \"id_str\": \"%d\", \"text\": \"@user%d "
+			"this is a tweet with some \\\"quoted\\\" text and a "
+			"link http:\\/\\/t.co\\/%d\", \"user\": {\"name\": "
+			"\"user %d\", \"screen_name\": \"u%d\", \"followers\": %d, "
+			"\"verified\": false, \"lang\": \"en\"}, \"retweeted\": "
+			"false, \"entities\": {\"hashtags\": [], \"urls\": "
+			"[\"http:\\/\\/t.co\\/%d\"]}}\n",
+			i, i, i, i, i, i, i * 7, i);
+		i++;
+	}
+	acl_vstring_strcat(out, "]}");
+}
+
+static void corpus_canada(ACL_VSTRING *out, size_t size)
+{
+	int   i = 0;
+
+	acl_vstring_strcpy(out, "{\"type\": \"FeatureCollection\", "
+		"\"coordinates\": [");
+	while (LEN(out) < size) {
+		if (i > 0)
+			ACL_VSTRING_ADDCH(out, ',');
+		acl_vstring_sprintf_append(out, "[-%d.%06d,%d.%06d]",
+			60 + i % 80, (i * 7919) % 1000000, 40 + i % 30,
+			(i * 104729) % 1000000);
+		i++;
+	}
+	acl_vstring_strcat(out, "]}");
+}
+
+static void corpus_citm(ACL_VSTRING *out, size_t size)
+{
+	int   i = 0;
+
+	acl_vstring_strcpy(out, "{\"events\": {");
+	while (LEN(out) < size) {
+		if (i > 0)
+			ACL_VSTRING_ADDCH(out, ',');
+		acl_vstring_sprintf_append(out,
+			"\"%d\": {\"id\": %d, \"name\": null, \"subTopicIds\": "
+			"[%d, %d, %d], \"topicIds\": [%d], \"performances\": "
+			"{\"start\": %d, \"prices\": [{\"amount\": %d, "
+			"\"seatCategoryId\": %d}]}}",
+			138586341 + i, 138586341 + i, i, i + 1, i + 2, i % 10,
+			i * 1000, 90250 + i, 338937295 + i);
+		i++;
+	}
+	acl_vstring_strcat(out, "}}");
+}
+
+static double bench_parse(const char *data, int loop, bool fast, bool use_slice)
+{
+	struct timeval begin, end;
+	int   i;
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < loop; i++) {
+		ACL_SLICE_POOL *slice = use_slice ? acl_slice_pool_create(10,
+			100, ACL_SLICE_FLAG_GC2 | ACL_SLICE_FLAG_RTGC_OFF) : NULL;
+		ACL_JSON *json = acl_json_alloc1(slice);
+
+		if (fast)
+			acl_json_update_fast(json, data);
+		else
+			acl_json_update(json, data);
+		acl_json_free(json);
+		if (slice)
+			acl_slice_pool_destroy(slice);
+	}
+	gettimeofday(&end, NULL);
+	return util_stamp_sub(&end, &begin);
+}
+
+static void bench(const char *name, const char *data, int loop)
+{
+	size_t len = strlen(data);
+	double old1, fast1, old2, fast2;
+
+	CHECK(compare(data, 0, NULL));
+
+	old1  = bench_parse(data, loop, false, false);
+	fast1 = bench_parse(data, loop, true, false);
+	old2  = bench_parse(data, loop, false, true);
+	fast2 = bench_parse(data, loop, true, true);
+
+#define	MBS(ms)	((double) len * loop / 1048576.0 / ((ms) / 1000.0))
+
+	printf("%-8s %8lu bytes, loop %d: old %.1f MB/s, fast %.1f MB/s; "
+		"with slice: old %.1f MB/s, fast %.1f MB/s\r\n",
+		name, (unsigned long) len, loop, MBS(old1), MBS(fast1),
+		MBS(old2), MBS(fast2));
+}
+
+static void usage(const char *procname)
+{
+	printf("usage: %s -h[help] -b[benchmark] -n loop -s corpus_size"
+		" -f json_file\r\n", procname);
+}
+
+int main(int argc, char *argv[])
+{
+	int   ch, benchmark = 0, loop = 20;
+	size_t size = 1024 * 1024;
+	ACL_SLICE_POOL *slice;
+	char *file = NULL;
+
+	while ((ch = getopt(argc, argv, "hbn:s:f:")) > 0) {
+		switch (ch) {
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			benchmark = 1;
+			break;
+		case 'n':
+			loop = atoi(optarg);
+			break;
+		case 's':
+			size = (size_t) atoi(optarg);
+			break;
+		case 'f':
+			file = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	test_cases(NULL);
+	test_random(20000, NULL);
+
+	slice = acl_slice_pool_create(10, 100,
+		ACL_SLICE_FLAG_GC2 | ACL_SLICE_FLAG_RTGC_OFF);
+	test_cases(slice);
+	test_random(2000, slice);
+	acl_slice_pool_destroy(slice);
+
+	if (file) {
+		char *data = acl_vstream_loadfile(file);
+
+		if (data == NULL)
+			printf("load %s error %s\r\n", file, acl_last_serror());
+		else {
+			bench(file, data, loop);
+			acl_myfree(data);
+		}
+	} else if (benchmark) {
+		ACL_VSTRING *buf = acl_vstring_alloc(size + 1024);
+
+		corpus_twitter(buf, size);
+		bench("twitter", STR(buf), loop);
+		corpus_canada(buf, size);
+		bench("canada", STR(buf), loop);
+		corpus_citm(buf, size);
+		bench("citm", STR(buf), loop);
+		acl_vstring_free(buf);
+	}
+
+	return util_check_result();
+}
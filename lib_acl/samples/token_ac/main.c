@@ -0,0 +1,276 @@
+#include "lib_acl.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include "util.h"
+
+static int hit_print(const ACL_TOKEN_AC_HIT *hit, void *arg)
+{
+	ACL_VSTRING *buf = (ACL_VSTRING*) arg;
+
+	if (buf)
+		acl_vstring_sprintf_append(buf, "%s@%d;", hit->word,
+			(int) hit->off);
+	else
+		printf("hit: %s, off: %d, flag: %s\n", hit->word, (int) hit->off,
+			(hit->flag & ACL_TOKEN_F_DENY) ? "DENY"
+			: ((hit->flag & ACL_TOKEN_F_PASS) ? "PASS" : "NONE"));
+	return 0;
+}
+
+static void test_basic(void)
+{
+	const char *words[] = { "he", "she", "his", "hers", NULL };
+	const char *text = "ushers said his sheep";
+	ACL_TOKEN_AC *ac = acl_token_ac_create(ACL_TOKEN_AC_F_NONE);
+	ACL_TOKEN_AC_HIT hit;
+	ACL_VSTRING *buf = acl_vstring_alloc(256);
+	int   i, n;
+
+	for (i = 0; words[i] != NULL; i++)
+		CHECK(acl_token_ac_add(ac, words[i], 0, words[i]) == i);
+	CHECK(acl_token_ac_add(ac, "he", ACL_TOKEN_F_DENY, NULL) == 0);
+	CHECK(acl_token_ac_compile(ac) == 0);
+	CHECK(acl_token_ac_count(ac) == 4);
+
+	n = acl_token_ac_scan(ac, text, strlen(text), hit_print, buf);
+	printf("scan: %d hits, %s\n", n, acl_vstring_str(buf));
+	CHECK(n == 6);
+	CHECK(strcmp(acl_vstring_str(buf),
+		"she@1;he@2;hers@2;his@12;she@16;he@17;") == 0);
+
+	CHECK(acl_token_ac_find(ac, text, strlen(text), &hit) == 1);
+	CHECK(strcmp(hit.word, "she") == 0 && hit.off == 1);
+	CHECK(acl_token_ac_find(ac, "xyz", 3, NULL) == 0);
+
+	/* the overlapped one is the longest at the same end position */
+	CHECK(acl_token_ac_find(ac, "ahe", 3, &hit) == 1);
+	CHECK(hit.id == 0 && (hit.flag & ACL_TOKEN_F_DENY) && hit.ctx == NULL);
+
+	acl_vstring_free(buf);
+	acl_token_ac_free(ac);
+}
+
+static void test_icase(void)
+{
+	ACL_TOKEN_AC *ac = acl_token_ac_create(ACL_TOKEN_AC_F_ICASE);
+	ACL_TOKEN_AC_HIT hit;
+	const char *text = "Content-Type: Text/HTML";
+
+	acl_token_ac_add(ac, "text/html", ACL_TOKEN_F_PASS, NULL);
+	acl_token_ac_add(ac, "CONTENT", ACL_TOKEN_F_NONE, NULL);
+	acl_token_ac_compile(ac);
+
+	CHECK(acl_token_ac_scan(ac, text, strlen(text), NULL, NULL) == 2);
+	CHECK(acl_token_ac_find(ac, text + 8, strlen(text + 8), &hit) == 1);
+	CHECK(hit.off == 6 && (hit.flag & ACL_TOKEN_F_PASS));
+	acl_token_ac_free(ac);
+}
+
+static void test_tree(void)
+{
+	ACL_TOKEN *tree = acl_token_tree_create("hello|p world|d abc");
+	ACL_TOKEN_AC *ac = acl_token_ac_create(ACL_TOKEN_AC_F_NONE);
+	ACL_TOKEN_AC_HIT hit;
+
+	CHECK(acl_token_ac_add_tree(ac, tree) == 3);
+	acl_token_ac_compile(ac);
+	CHECK(acl_token_ac_find(ac, "xxworldxx", 9, &hit) == 1);
+	CHECK((hit.flag & ACL_TOKEN_F_DENY) && hit.off == 2);
+	acl_token_ac_free(ac);
+	acl_token_tree_destroy(tree);
+}
+
+static void test_save_load(const char *filepath)
+{
+	ACL_TOKEN_AC *ac = acl_token_ac_create(ACL_TOKEN_AC_F_ICASE);
+	ACL_TOKEN_AC *ac2;
+	ACL_VSTRING *buf1 = acl_vstring_alloc(256);
+	ACL_VSTRING *buf2 = acl_vstring_alloc(256);
+	const char *text = "One TWO three Four five";
+	char  word[32];
+	int   i;
+
+	for (i = 0; i < 1000; i++) {
+		snprintf(word, sizeof(word), "word%d", i);
+		acl_token_ac_add(ac, word, 0, NULL);
+	}
+	acl_token_ac_add(ac, "two", 0, NULL);
+	acl_token_ac_add(ac, "four", ACL_TOKEN_F_DENY, NULL);
+	acl_token_ac_compile(ac);
+	CHECK(acl_token_ac_save(ac, filepath) == 0);
+
+	ac2 = acl_token_ac_load(filepath);
+	CHECK(ac2 != NULL);
+	if (ac2 != NULL) {
+		CHECK(acl_token_ac_count(ac2) == 1002);
+		CHECK(acl_token_ac_add(ac2, "xxx", 0, NULL) == -1);
+		acl_token_ac_scan(ac, text, strlen(text), hit_print, buf1);
+		acl_token_ac_scan(ac2, text, strlen(text), hit_print, buf2);
+		CHECK(strcmp(acl_vstring_str(buf1), acl_vstring_str(buf2)) == 0);
+		CHECK(acl_token_ac_scan(ac2, "word999 word12",
+			14, NULL, NULL) == 5);
+		acl_token_ac_free(ac2);
+	}
+
+	remove(filepath);
+	acl_vstring_free(buf1);
+	acl_vstring_free(buf2);
+	acl_token_ac_free(ac);
+}
+
+/* compare with acl_token_tree_match which restarts at every position */
+static void bench(int nwords, int len)
+{
+	ACL_TOKEN *tree = acl_token_new();
+	ACL_TOKEN_AC *ac = acl_token_ac_create(ACL_TOKEN_AC_F_NONE);
+	char *text = (char*) acl_mymalloc(len + 1), word[32];
+	const char *ptr;
+	struct timeval begin, end;
+	int   i, n1 = 0, n2;
+	double spent;
+
+	for (i = 0; i < nwords; i++) {
+		snprintf(word, sizeof(word), "k%xz%d", i * 7919, i);
+		acl_token_tree_add(tree, word, ACL_TOKEN_F_STOP, NULL);
+		acl_token_ac_add(ac, word, ACL_TOKEN_F_STOP, NULL);
+	}
+	gettimeofday(&begin, NULL);
+	acl_token_ac_compile(ac);
+	gettimeofday(&end, NULL);
+	spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+	printf("compile %d words: %.2f ms\n", nwords, spent);
+
+	for (i = 0; i < len; i++)
+		text[i] = "abcdefkz0123456789"[rand() % 18];
+	text[len] = 0;
+
+	gettimeofday(&begin, NULL);
+	ptr = text;
+	while (*ptr) {
+		if (acl_token_tree_match(tree, &ptr, NULL, NULL) != NULL)
+			n1++;
+	}
+	gettimeofday(&end, NULL);
+	spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+	printf("token_tree: %d hits, %.2f ms\n", n1, spent);
+
+	gettimeofday(&begin, NULL);
+	n2 = acl_token_ac_scan(ac, text, len, NULL, NULL);
+	gettimeofday(&end, NULL);
+	spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+	printf("token_ac:   %d hits, %.2f ms, %.2f MB/s\n", n2, spent,
+		spent > 0 ? len / 1024.0 / 1024.0 / (spent / 1000.0) : 0);
+
+	acl_myfree(text);
+	acl_token_ac_free(ac);
+	acl_token_tree_destroy(tree);
+}
+
+/* compile a word file into an automaton file, which can be mmap'ed later */
+static int compile_file(const char *words, const char *out, int icase)
+{
+	ACL_TOKEN_AC *ac = acl_token_ac_create(icase ?
+		ACL_TOKEN_AC_F_ICASE : ACL_TOKEN_AC_F_NONE);
+	int   n = acl_token_ac_load_words(ac, words,
+			ACL_TOKEN_F_STOP | ACL_TOKEN_F_DENY);
+
+	if (n < 0 || acl_token_ac_compile(ac) < 0
+		|| acl_token_ac_save(ac, out) < 0)
+	{
+		acl_token_ac_free(ac);
+		return 1;
+	}
+	printf("compile %d words from %s to %s ok\n", n, words, out);
+	acl_token_ac_free(ac);
+	return 0;
+}
+
+static int scan_file(const char *acfile, const char *text_file)
+{
+	ACL_TOKEN_AC *ac = acl_token_ac_load(acfile);
+	ssize_t size;
+	char *text;
+
+	if (ac == NULL)
+		return 1;
+	text = acl_vstream_loadfile2(text_file, &size);
+	if (text == NULL) {
+		acl_token_ac_free(ac);
+		return 1;
+	}
+	printf("total hits: %d\n", acl_token_ac_scan(ac, text,
+		(size_t) size, hit_print, NULL));
+	acl_myfree(text);
+	acl_token_ac_free(ac);
+	return 0;
+}
+
+static void usage(const char *procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		" -c words_file -o ac_file [-i(ignore case)]\r\n"
+		" -l ac_file -s text_file\r\n"
+		" -b[benchmark] -n words_count -N text_length\r\n", procname);
+}
+
+int main(int argc, char *argv[])
+{
+	char  words[256], out[256], acfile[256], text[256];
+	int   ch, icase = 0, benchmark = 0, nwords = 10000, len = 10000000;
+
+	words[0] = out[0] = acfile[0] = text[0] = 0;
+
+	while ((ch = getopt(argc, argv, "hc:o:il:s:bn:N:")) > 0) {
+		switch (ch) {
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'c':
+			ACL_SAFE_STRNCPY(words, optarg, sizeof(words));
+			break;
+		case 'o':
+			ACL_SAFE_STRNCPY(out, optarg, sizeof(out));
+			break;
+		case 'i':
+			icase = 1;
+			break;
+		case 'l':
+			ACL_SAFE_STRNCPY(acfile, optarg, sizeof(acfile));
+			break;
+		case 's':
+			ACL_SAFE_STRNCPY(text, optarg, sizeof(text));
+			break;
+		case 'b':
+			benchmark = 1;
+			break;
+		case 'n':
+			nwords = atoi(optarg);
+			break;
+		case 'N':
+			len = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (words[0] && out[0])
+		return compile_file(words, out, icase);
+	if (acfile[0] && text[0])
+		return scan_file(acfile, text);
+
+	test_basic();
+	test_icase();
+	test_tree();
+	test_save_load("./token_ac.dat");
+
+	if (benchmark)
+		bench(nwords, len);
+
+	return util_check_result();
+}
@@ -0,0 +1,36 @@
+#include "lib_acl.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include "util.h"
+
+static int __check_failed = 0;
+
+void util_check_failed(const char *file, int line, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	printf("%s(%d): check failed: ", file, line);
+	vprintf(fmt, ap);
+	printf("\r\n");
+	va_end(ap);
+
+	__check_failed++;
+}
+
+int util_check_result(void)
+{
+	if (__check_failed > 0) {
+		printf("%d checks failed\r\n", __check_failed);
+		return 1;
+	}
+
+	printf("all checks passed\r\n");
+	return 0;
+}
+
+double util_stamp_sub(const struct timeval *end, const struct timeval *begin)
+{
+	return (end->tv_sec - begin->tv_sec) * 1000.0
+		+ (end->tv_usec - begin->tv_usec) / 1000.0;
+}
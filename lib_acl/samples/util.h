@@ -0,0 +1,43 @@
+#ifndef	__SAMPLES_UTIL_INCLUDE_H__
+#define	__SAMPLES_UTIL_INCLUDE_H__
+
+#include "lib_acl.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* ǷʱλüΪһʧ */
+#define	CHECK(x) do { \
+	if (!(x)) \
+		util_check_failed(__FILE__, __LINE__, "%s", #x); \
+} while (0)
+
+/**
+ * ¼һμʧܲʧܵλüԭһͨ CHECK 
+ * @param file {const char*} Դļ
+ * @param line {int} Դļек
+ * @param fmt {const char*} ʽ
+ */
+void util_check_failed(const char *file, int line, const char *fmt, ...)
+	ACL_PRINTF(3, 4);
+
+/**
+ * ȫĽ
+ * @return {int} ȫͨʱ 0򷵻 1 main ķֵ
+ */
+int util_check_result(void);
+
+/**
+ * ʱ֮ĺ
+ * @param end {const struct timeval*} ʱ
+ * @param begin {const struct timeval*} ʼʱ
+ * @return {double}
+ */
+double util_stamp_sub(const struct timeval *end, const struct timeval *begin);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif
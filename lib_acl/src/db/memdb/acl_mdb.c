@@ -188,6 +188,33 @@ ACL_MDT_RES *acl_mdb_list(ACL_MDB *mdb, const char *tbl_name, int from, int limi
 	return (mdt->list(mdt, from, limit));
 }
 
+ACL_MDT_RES *acl_mdb_range(ACL_MDB *mdb, const char *tbl_name,
+	const char *key_label, const char *key_begin, const char *key_end,
+	int desc, int from, int limit)
+{
+	const char *myname = "acl_mdb_range";
+	ACL_MDT *mdt;
+
+	if (tbl_name == NULL || *tbl_name == 0) {
+		acl_msg_error("%s(%d): tbl_name invalid", myname, __LINE__);
+		return (NULL);
+	}
+	if (key_label == NULL || *key_label == 0) {
+		acl_msg_error("%s(%d): key_label invalid", myname, __LINE__);
+		return (NULL);
+	}
+
+	mdt = (ACL_MDT *) acl_htable_find(mdb->tbls, tbl_name);
+	if (mdt == NULL) {
+		acl_msg_error("%s(%d): table no exist, tbl_name(%s)",
+			myname, __LINE__, tbl_name);
+		return (NULL);
+	}
+
+	return (mdt->range(mdt, key_label, key_begin, key_end,
+		desc, from, limit));
+}
+
 int acl_mdb_del(ACL_MDB *mdb, const char *tbl_name,
 	const char *key_label, const char *key,
 	void (*onfree_fn)(void*, unsigned int))
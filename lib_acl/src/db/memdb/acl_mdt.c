@@ -418,6 +418,87 @@ static int mdt_del(ACL_MDT *mdt, const char *key_label,
 	return (n);
 }
 
+typedef struct RANGE_CTX {
+	ACL_MDT_RES *res;
+	int   from;
+	int   limit;
+	int   i;
+	int   n;
+} RANGE_CTX;
+
+static int range_rec_fn(ACL_MDT_REC *rec, void *arg)
+{
+	const char *myname = "range_rec_fn";
+	RANGE_CTX *ctx = (RANGE_CTX*) arg;
+	ACL_MDT_REF *ref;
+	RING *ref_iter;
+	void *data;
+
+	FOREACH_RING_FORWARD(ref_iter, &rec->ref_head) {
+		if (ctx->from >= 0 && ctx->i++ < ctx->from)
+			continue;
+		ref = RING_TO_APPL(ref_iter, ACL_MDT_REF, rec_entry);
+		data = acl_mymalloc(ref->node->dlen);
+		memcpy(data, ref->node->data, ref->node->dlen);
+		if (acl_array_append(ctx->res->a, data) < 0)
+			acl_msg_fatal("%s(%d): add array error(%s)",
+				myname, __LINE__, acl_last_serror());
+		if (ctx->limit > 0 && ++ctx->n >= ctx->limit)
+			return (1);
+	}
+	return (0);
+}
+
+/**
+ * ˳ѯĳֵΧڵĽֻ(avl/btree)֧
+ * @param mdt {ACL_MDT*}
+ * @param key_label {const char*}
+ * @param key_begin {const char*} ʼ()NULL ʾ
+ * @param key_end {const char*} ()NULL ʾ
+ * @param desc {int}  0 ʱĽ򷵻
+ * @param from {int} ʼλ
+ * @param limit {int} 
+ * @return {ACL_MDT_RES*} ѯ, NULL: Ϊջ
+ */
+static ACL_MDT_RES *mdt_range(ACL_MDT *mdt, const char *key_label,
+	const char *key_begin, const char *key_end, int desc,
+	int from, int limit)
+{
+	const char *myname = "mdt_range";
+	ACL_MDT_IDX *idx;
+	RANGE_CTX ctx;
+
+	if (mdt->idx_range == NULL) {
+		acl_msg_error("%s(%d): table(%s) has no ordered index",
+			myname, __LINE__, mdt->name);
+		return (NULL);
+	}
+
+	idx = mdt_idx(mdt, key_label);
+	if (idx == NULL) {
+		acl_msg_warn("%s: key_lable(%s) no exist in %s",
+			myname, key_label, mdt->name);
+		return (NULL);
+	}
+
+	ctx.res = (ACL_MDT_RES*) acl_mycalloc(1, sizeof(ACL_MDT_RES));
+	ctx.res->a = acl_array_create(limit > 0 ? limit : 100);
+	ctx.res->ipos = 0;
+	ctx.from = from;
+	ctx.limit = limit;
+	ctx.i = 0;
+	ctx.n = 0;
+
+	mdt->idx_range(idx, key_begin, key_end, desc, range_rec_fn, &ctx);
+
+	if (acl_array_size(ctx.res->a) == 0) {
+		acl_array_destroy(ctx.res->a, NULL);
+		acl_myfree(ctx.res);
+		return (NULL);
+	}
+	return (ctx.res);
+}
+
 /**
  * ӱгһЩ
  * @param mdt {ACL_MDT*}
@@ -533,6 +614,8 @@ ACL_MDT *acl_mdt_create(const char *dbtype, const char *tbl_name,
 		mdt = acl_mdt_binhash_create();
 	} else if (strcasecmp(dbtype, "avl") == 0) {
 		mdt = acl_mdt_avl_create();
+	} else if (strcasecmp(dbtype, "btree") == 0) {
+		mdt = acl_mdt_btree_create();
 	} else {
 		acl_msg_error("%s(%d): dbtype(%s)", myname, __LINE__, dbtype);
 		return (NULL);
@@ -552,6 +635,7 @@ ACL_MDT *acl_mdt_create(const char *dbtype, const char *tbl_name,
 	mdt->probe = mdt_probe;
 	mdt->list = mdt_list;
 	mdt->walk = mdt_walk;
+	mdt->range = mdt_range;
 
 	if ((tbl_flag & ACL_MDT_FLAG_SLICE_RTGC_OFF))
 		rtgc_flag = ACL_MDT_FLAG_SLICE_RTGC_OFF;
@@ -617,6 +701,14 @@ ACL_MDT_RES *acl_mdt_list(ACL_MDT *mdt, int from, int limit)
 	return (mdt->list(mdt, from, limit));
 }
 
+ACL_MDT_RES *acl_mdt_range(ACL_MDT *mdt, const char *key_label,
+	const char *key_begin, const char *key_end, int desc,
+	int from, int limit)
+{
+	return (mdt->range(mdt, key_label, key_begin, key_end,
+		desc, from, limit));
+}
+
 int acl_mdt_delete(ACL_MDT *mdt, const char *key_label,
 	const char *key, void (*onfree_fn)(void*, unsigned int))
 {
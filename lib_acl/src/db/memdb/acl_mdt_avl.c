@@ -184,6 +184,57 @@ static void mdt_idx_del(ACL_MDT_IDX *idx, const char *key)
 		acl_myfree(pnode);
 }
 
+/**
+ * ˳ĳΧڵĽ
+ */
+static int mdt_idx_range(ACL_MDT_IDX *idx, const char *key_begin,
+	const char *key_end, int desc,
+	int (*walk_fn)(ACL_MDT_REC*, void*), void *arg)
+{
+	ACL_MDT_IDX_AVL *idx_avl = (ACL_MDT_IDX_AVL*) idx;
+	TREE_NODE node, *pnode;
+	avl_index_t where;
+	int   n = 0;
+
+	if (!desc) {
+		if (key_begin == NULL)
+			pnode = (TREE_NODE*) avl_first(&idx_avl->avl);
+		else {
+			node.key.c_key = key_begin;
+			pnode = (TREE_NODE*) avl_find(&idx_avl->avl, &node, &where);
+			if (pnode == NULL)
+				pnode = (TREE_NODE*) avl_nearest(&idx_avl->avl,
+					where, AVL_AFTER);
+		}
+		for (; pnode != NULL; pnode = AVL_NEXT(&idx_avl->avl, pnode)) {
+			if (key_end && strcmp(pnode->key.c_key, key_end) > 0)
+				break;
+			n++;
+			if (walk_fn(pnode->rec, arg))
+				break;
+		}
+	} else {
+		if (key_end == NULL)
+			pnode = (TREE_NODE*) avl_last(&idx_avl->avl);
+		else {
+			node.key.c_key = key_end;
+			pnode = (TREE_NODE*) avl_find(&idx_avl->avl, &node, &where);
+			if (pnode == NULL)
+				pnode = (TREE_NODE*) avl_nearest(&idx_avl->avl,
+					where, AVL_BEFORE);
+		}
+		for (; pnode != NULL; pnode = AVL_PREV(&idx_avl->avl, pnode)) {
+			if (key_begin && strcmp(pnode->key.c_key, key_begin) < 0)
+				break;
+			n++;
+			if (walk_fn(pnode->rec, arg))
+				break;
+		}
+	}
+
+	return (n);
+}
+
 /**
  * ͷƽģʽݱ
  */
@@ -205,5 +256,6 @@ ACL_MDT *acl_mdt_avl_create()
 	mdt->mdt.idx_add = mdt_idx_add;
 	mdt->mdt.idx_get = mdt_idx_get;
 	mdt->mdt.idx_del = mdt_idx_del;
+	mdt->mdt.idx_range = mdt_idx_range;
 	return ((ACL_MDT*) mdt);
 }
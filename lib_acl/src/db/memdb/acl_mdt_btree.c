@@ -0,0 +1,177 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ACL_BCB_COMPILER
+#pragma hdrstop
+#endif
+
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_mystring.h"
+#include "stdlib/acl_bptree.h"
+
+#endif
+
+#include "define.h"
+#include "struct.h"
+#include "mdb_private.h"
+
+/**
+ * B+ õıȽϻص
+ */
+static int cmp_fn(const void *v1, const void *v2)
+{
+	return strcmp((const char*) v1, (const char*) v2);
+}
+
+/**
+ * 
+ */
+static ACL_MDT_IDX *mdt_idx_create(ACL_MDT *mdt acl_unused,
+	size_t init_capacity acl_unused, const char *name, unsigned int flag)
+{
+	ACL_MDT_IDX_BTREE *idx;
+
+	idx = (ACL_MDT_IDX_BTREE*) acl_mycalloc(1, sizeof(ACL_MDT_IDX_BTREE));
+	idx->tree = acl_bptree_create(cmp_fn);
+	idx->idx.name = acl_mystrdup(name);
+	idx->idx.flag = flag;
+	return ((ACL_MDT_IDX*) idx);
+}
+
+static void free_key(void *key, void *value acl_unused)
+{
+	acl_myfree(key);
+}
+
+static void mdt_idx_free(ACL_MDT_IDX *idx)
+{
+	ACL_MDT_IDX_BTREE *idx_btree = (ACL_MDT_IDX_BTREE*) idx;
+
+	if (idx->flag & ACL_MDT_FLAG_KMR)
+		acl_bptree_free(idx_btree->tree, NULL);
+	else
+		acl_bptree_free(idx_btree->tree, free_key);
+	acl_myfree(idx->name);
+	acl_myfree(idx_btree);
+}
+
+/**
+ * һµֶ
+ * @param idx {ACL_MDT_IDX*} 
+ * @param key {const char*} ݱֵֶ
+ * @param rec {ACL_MDT_REC*}
+ */
+static void mdt_idx_add(ACL_MDT_IDX *idx, const char *key, ACL_MDT_REC *rec)
+{
+	ACL_MDT_IDX_BTREE *idx_btree = (ACL_MDT_IDX_BTREE*) idx;
+	const char *pkey;
+
+	if (idx->flag & ACL_MDT_FLAG_KMR)
+		pkey = key;
+	else
+		pkey = acl_mystrdup(key);
+
+	(void) acl_bptree_add(idx_btree->tree, pkey, rec);
+	rec->key = pkey;
+}
+
+/**
+ * ݱвѯӦĳֵĽ
+ * @param idx {ACL_MDT_IDX*} 
+ * @param key {const char*} ݱֵֶ
+ * @return {ACL_MDT_REC*} ӦĳֵֶĽ
+ */
+static ACL_MDT_REC *mdt_idx_get(ACL_MDT_IDX *idx, const char *key)
+{
+	ACL_MDT_IDX_BTREE *idx_btree = (ACL_MDT_IDX_BTREE*) idx;
+
+	return ((ACL_MDT_REC*) acl_bptree_find(idx_btree->tree, key));
+}
+
+/**
+ * һɾ
+ * @param idx {ACL_MDT_IDX*} 
+ * @param key {const char*} ݽüֵ
+ */
+static void mdt_idx_del(ACL_MDT_IDX *idx, const char *key)
+{
+	const char *myname = "mdt_idx_del";
+	ACL_MDT_IDX_BTREE *idx_btree = (ACL_MDT_IDX_BTREE*) idx;
+	union {
+		void *key;
+		const void *c_key;
+	} pkey;
+
+	if (acl_bptree_delete(idx_btree->tree, key, &pkey.c_key) == NULL)
+		acl_msg_fatal("%s: key(%s) not exist", myname, key);
+	if (!(idx->flag & ACL_MDT_FLAG_KMR))
+		acl_myfree(pkey.key);
+}
+
+/**
+ * ˳ĳΧڵĽҶ֮һģ
+ * ֻҪλһ
+ */
+static int mdt_idx_range(ACL_MDT_IDX *idx, const char *key_begin,
+	const char *key_end, int desc,
+	int (*walk_fn)(ACL_MDT_REC*, void*), void *arg)
+{
+	ACL_MDT_IDX_BTREE *idx_btree = (ACL_MDT_IDX_BTREE*) idx;
+	ACL_BPTREE_ITER iter;
+	int   n = 0;
+
+	if (!desc) {
+		if (acl_bptree_seek(idx_btree->tree, &iter, key_begin) < 0)
+			return (0);
+		do {
+			if (key_end && strcmp((const char*) iter.key, key_end) > 0)
+				break;
+			n++;
+			if (walk_fn((ACL_MDT_REC*) iter.value, arg))
+				break;
+		} while (acl_bptree_next(&iter) == 0);
+	} else {
+		if (acl_bptree_seek_last(idx_btree->tree, &iter, key_end) < 0)
+			return (0);
+		do {
+			if (key_begin && strcmp((const char*) iter.key, key_begin) < 0)
+				break;
+			n++;
+			if (walk_fn((ACL_MDT_REC*) iter.value, arg))
+				break;
+		} while (acl_bptree_prev(&iter) == 0);
+	}
+
+	return (n);
+}
+
+/**
+ * ͷ B+ ģʽݱ
+ */
+static void mdt_btree_free(ACL_MDT *mdt)
+{
+	ACL_MDT_BTREE *mdt_btree = (ACL_MDT_BTREE*) mdt;
+
+	acl_myfree(mdt_btree);
+}
+
+ACL_MDT *acl_mdt_btree_create()
+{
+	ACL_MDT_BTREE *mdt;
+
+	mdt = (ACL_MDT_BTREE *) acl_mycalloc(1, sizeof(ACL_MDT_BTREE));
+	mdt->mdt.tbl_free = mdt_btree_free;
+	mdt->mdt.idx_create = mdt_idx_create;
+	mdt->mdt.idx_free = mdt_idx_free;
+	mdt->mdt.idx_add = mdt_idx_add;
+	mdt->mdt.idx_get = mdt_idx_get;
+	mdt->mdt.idx_del = mdt_idx_del;
+	mdt->mdt.idx_range = mdt_idx_range;
+	return ((ACL_MDT*) mdt);
+}
@@ -6,5 +6,6 @@
 ACL_MDT *acl_mdt_hash_create(void);
 ACL_MDT *acl_mdt_binhash_create(void);
 ACL_MDT *acl_mdt_avl_create(void);
+ACL_MDT *acl_mdt_btree_create(void);
 
 #endif
@@ -13,6 +13,7 @@ extern "C" {
 #include "stdlib/acl_slice.h"
 #include "stdlib/acl_htable.h"
 #include "stdlib/acl_binhash.h"
+#include "stdlib/acl_bptree.h"
 #include "ring.h"
 
 /* ûѯ */
@@ -96,6 +97,14 @@ typedef struct ACL_MDT_IDX_AVL {
 	ACL_SLICE *slice;		/* ڴ */
 } ACL_MDT_IDX_AVL;
 
+/**
+ *  B+ ʽ洢
+ */
+typedef struct ACL_MDT_IDX_BTREE {
+	ACL_MDT_IDX idx;
+	ACL_BPTREE *tree;		/* ΪֵֵֶΪ ACL_MDT_REC */
+} ACL_MDT_IDX_BTREE;
+
 /* ݽṹ, ÿڽʱݽ(ACL_NODE)е
  * û(data)еĳֶΪֵ.
  */
@@ -123,6 +132,9 @@ struct ACL_MDT {
 	ACL_MDT_RES *(*list)(ACL_MDT *mdt, int from, int limit);
 	int (*walk)(ACL_MDT *mdt, int (*walk_fn)(const void *data, unsigned int dlen),
 		int from, int limit);
+	ACL_MDT_RES *(*range)(ACL_MDT *mdt, const char *key_label,
+		const char *key_begin, const char *key_end, int desc,
+		int from, int limit);
 
 	void (*tbl_free)(ACL_MDT*);
 
@@ -133,6 +145,10 @@ struct ACL_MDT {
 	void (*idx_add)(ACL_MDT_IDX *idx, const char *key, ACL_MDT_REC *rec);
 	void (*idx_del)(ACL_MDT_IDX *idx, const char *key);
 	ACL_MDT_REC *(*idx_get)(ACL_MDT_IDX *idx, const char *key);
+	/* ˳ [key_begin, key_end] ΧڵĽ */
+	int (*idx_range)(ACL_MDT_IDX *idx, const char *key_begin,
+		const char *key_end, int desc,
+		int (*walk_fn)(ACL_MDT_REC *rec, void *arg), void *arg);
 };
 
 typedef struct ACL_MDT_HASH {
@@ -147,10 +163,14 @@ typedef struct ACL_MDT_AVL {
 	ACL_MDT mdt;
 } ACL_MDT_AVL;
 
+typedef struct ACL_MDT_BTREE {
+	ACL_MDT mdt;
+} ACL_MDT_BTREE;
+
 /* ݿݽṹ */
 struct ACL_MDB {
 	char   name[128];		/* ݿ */
-	char   type[32];		/* ݿ: hash/avl */
+	char   type[32];		/* ݿ: hash/binhash/avl/btree */
 	ACL_HTABLE *tbls;		/* ļ */
 };
 
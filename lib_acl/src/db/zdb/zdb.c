@@ -12,6 +12,7 @@
 #include "stdlib/acl_argv.h"
 #include "stdlib/acl_mymalloc.h"
 #include "stdlib/acl_file.h"
+#include "stdlib/acl_bloom.h"
 #include "db/zdb.h"
 
 #endif
@@ -296,6 +297,11 @@ void zdb_close(ZDB *db)
 	acl_myfree(db);
 }
 
+void zdb_set_filter(ZDB *db, ACL_BLOOM *filter)
+{
+	db->filter = filter;
+}
+
 ZDB_BLK *zdb_lookup(ZDB *db, zdb_key_t key, size_t *size_ptr, ZDB_BLK_OFF *blk_off_buf)
 {
 	const char *myname = "zdb_lookup";
@@ -311,6 +317,10 @@ ZDB_BLK *zdb_lookup(ZDB *db, zdb_key_t key, size_t *size_ptr, ZDB_BLK_OFF *blk_o
 		return (NULL);
 	}
 
+	/* жϸüһʱٶ洢 */
+	if (db->filter && !acl_bloom_test(db->filter, &key, sizeof(key)))
+		return (NULL);
+
 	ret = db->key_get(db, key, &blk_off);
 	if (ret <= 0)
 		return (NULL);
@@ -382,6 +392,8 @@ int zdb_update(ZDB *db, zdb_key_t key, const ZDB_BLK_OFF *blk_off_saved,
 	}
 
 	if (blk_off_saved == NULL) {
+		if (db->filter)
+			acl_bloom_add(db->filter, &key, sizeof(key));
 		db->status |= ZDB_STAT_KEY_NEW;  /* ״̬λԱǰΪֵ */
 		ret = db->dat_add(db, key, dat, len);
 		db->status &= ~ZDB_STAT_KEY_NEW;  /* ־λ */
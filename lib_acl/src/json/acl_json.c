@@ -3,10 +3,13 @@
 #ifndef ACL_PREPARE_COMPILE
 #include "stdlib/acl_mymalloc.h"
 #include "stdlib/acl_msg.h"
+#include "stdlib/acl_mystring.h"
 #include "json/acl_json.h"
 #include "stdlib/acl_vstring.h"
 #endif
 
+#include "../private/tag_index.h"
+
 #define	LEN	ACL_VSTRING_LEN
 #define	STR	acl_vstring_str
 
@@ -163,6 +166,7 @@ int acl_json_node_delete(ACL_JSON_NODE *node)
 	}
 
 	node->json->node_cnt--;
+	node->json->tag_dirty = 1;
 	if (node->json->node_cache &&
 		acl_array_size(node->json->node_cache) < node->json->max_cache)
 	{
@@ -177,12 +181,18 @@ void acl_json_node_append(ACL_JSON_NODE *node1, ACL_JSON_NODE *node2)
 {
 	acl_ring_append(&node1->node, &node2->node);
 	node2->parent = node1->parent;
+	node2->json->tag_dirty = 1;
 }
 
 void acl_json_node_add_child(ACL_JSON_NODE *parent, ACL_JSON_NODE *child)
 {
 	acl_ring_prepend(&parent->children, &child->node);
 	child->parent = parent;
+	/* ½Ľޱǩڱǩʱż
+	 * бǩӽĽеλòҪؽ
+	 */
+	if (LEN(child->ltag) > 0 || acl_ring_size(&child->children) > 0)
+		child->json->tag_dirty = 1;
 }
 
 ACL_JSON_NODE *acl_json_node_parent(ACL_JSON_NODE *node)
@@ -485,6 +495,7 @@ ACL_JSON *acl_json_create(ACL_JSON_NODE *node)
 void acl_json_foreach_init(ACL_JSON *json, ACL_JSON_NODE *node)
 {
 	json->root = node;
+	json->tag_dirty = 1;
 	json->iter_head = json_iter_head;
 	json->iter_next = json_iter_next;
 	json->iter_tail = json_iter_tail;
@@ -505,6 +516,58 @@ void acl_json_cache(ACL_JSON *json, int max_cache)
 	}
 }
 
+/* ޸ĺĵ˳һνؽǩǰ
+ * ǩδϣɽڱǩʱ
+ */
+
+static void tag_index_build(ACL_JSON *json)
+{
+	ACL_ITER iter;
+
+	tag_index_reset(json->tag_table);
+	acl_foreach(iter, json) {
+		ACL_JSON_NODE *node = (ACL_JSON_NODE*) iter.data;
+
+		if (node != json->curr_node || json->status != ACL_JSON_S_TAG)
+			tag_index_add(json->tag_table, STR(node->ltag), node);
+	}
+	json->tag_dirty = 0;
+}
+
+void acl_json_index(ACL_JSON *json, int on)
+{
+	if (on) {
+		if (json->tag_table == NULL) {
+			json->flag |= ACL_JSON_FLAG_TAG_INDEX;
+			json->tag_table = tag_index_create();
+			tag_index_build(json);
+		}
+		return;
+	}
+
+	json->flag &= ~ACL_JSON_FLAG_TAG_INDEX;
+	if (json->tag_table != NULL) {
+		tag_index_free(json->tag_table);
+		json->tag_table = NULL;
+	}
+}
+
+void acl_json_index_add(ACL_JSON *json, ACL_JSON_NODE *node)
+{
+	if (json->tag_table != NULL && !json->tag_dirty)
+		tag_index_add(json->tag_table, STR(node->ltag), node);
+}
+
+ACL_ARRAY *acl_json_index_lookup(ACL_JSON *json, const char *tag)
+{
+	if (json->tag_table == NULL)
+		acl_json_index(json, 1);
+	else if (json->tag_dirty)
+		tag_index_build(json);
+
+	return (tag_index_find(json->tag_table, tag));
+}
+
 void acl_json_cache_free(ACL_JSON *json)
 {
 	if (json->node_cache != NULL) {
@@ -529,6 +592,8 @@ int acl_json_free(ACL_JSON *json)
 	acl_json_node_free(json->root);
 	json->node_cnt--;
 	acl_assert(json->node_cnt == 0);
+	if (json->tag_table != NULL)
+		tag_index_free(json->tag_table);
 	if (json->node_cache != NULL)
 		acl_array_free(json->node_cache,
 			(void (*)(void*)) acl_json_node_free);
@@ -566,4 +631,7 @@ void acl_json_reset(ACL_JSON *json)
 	json->status = ACL_JSON_S_ROOT;
 	json->finish = 0;
 	json->depth = 0;
+	if (json->tag_table != NULL)
+		tag_index_reset(json->tag_table);
+	json->tag_dirty = 0;
 }
@@ -0,0 +1,1035 @@
+#include "StdAfx.h"
+#include <stdio.h>
+#ifndef ACL_PREPARE_COMPILE
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "stdlib/acl_mystring.h"
+#include "stdlib/acl_vstring.h"
+#include "stdlib/acl_iterator.h"
+#include "json/acl_json.h"
+#endif
+
+/*
+ * json  MessagePack/CBOR Ƹʽ֮ת
+ * ʱ;ֵͣ acl_json_create_bool/int64 ȴ
+ * ֵΪеĲ/ҶΪ
+ * ַ acl_json_build ԸǷŵĴһ£
+ * ʱɵĽ acl_json_update Ľṹͬͬʱֵ
+ * ͣ acl_json_build ʱֵֵ
+ */
+
+#define	STR	acl_vstring_str
+#define	LEN	ACL_VSTRING_LEN
+#define	ADDCH	ACL_VSTRING_ADDCH
+
+#define	MAX_DEPTH	1024	/* ʱǶײ */
+
+/*-----------------------------  ----------------------------------*/
+
+typedef struct PACKER {
+	ACL_VSTRING *buf;
+	int   cbor;
+} PACKER;
+
+static void put_be(ACL_VSTRING *buf, acl_uint64 n, int size)
+{
+	while (size-- > 0)
+		ADDCH(buf, (unsigned char) (n >> (size * 8)));
+}
+
+/* CBOR ͷ 3 λΪͣ 5 λΪĳ */
+
+static void cbor_head(ACL_VSTRING *buf, int major, acl_uint64 n)
+{
+	major <<= 5;
+	if (n < 24)
+		ADDCH(buf, major | (int) n);
+	else if (n <= 0xff) {
+		ADDCH(buf, major | 24);
+		put_be(buf, n, 1);
+	} else if (n <= 0xffff) {
+		ADDCH(buf, major | 25);
+		put_be(buf, n, 2);
+	} else if (n <= 0xffffffff) {
+		ADDCH(buf, major | 26);
+		put_be(buf, n, 4);
+	} else {
+		ADDCH(buf, major | 27);
+		put_be(buf, n, 8);
+	}
+}
+
+static void put_uint(PACKER *packer, acl_uint64 n)
+{
+	ACL_VSTRING *buf = packer->buf;
+
+	if (packer->cbor)
+		cbor_head(buf, 0, n);
+	else if (n <= 0x7f)
+		ADDCH(buf, (int) n);
+	else if (n <= 0xff) {
+		ADDCH(buf, 0xcc);
+		put_be(buf, n, 1);
+	} else if (n <= 0xffff) {
+		ADDCH(buf, 0xcd);
+		put_be(buf, n, 2);
+	} else if (n <= 0xffffffff) {
+		ADDCH(buf, 0xce);
+		put_be(buf, n, 4);
+	} else {
+		ADDCH(buf, 0xcf);
+		put_be(buf, n, 8);
+	}
+}
+
+static void put_int(PACKER *packer, acl_int64 n)
+{
+	ACL_VSTRING *buf = packer->buf;
+
+	if (n >= 0)
+		put_uint(packer, (acl_uint64) n);
+	else if (packer->cbor)
+		cbor_head(buf, 1, (acl_uint64) (-1 - n));
+	else if (n >= -32)
+		ADDCH(buf, (int) (n & 0xff));
+	else if (n >= -128) {
+		ADDCH(buf, 0xd0);
+		put_be(buf, (acl_uint64) n, 1);
+	} else if (n >= -32768) {
+		ADDCH(buf, 0xd1);
+		put_be(buf, (acl_uint64) n, 2);
+	} else if (n >= -2147483647 - 1) {
+		ADDCH(buf, 0xd2);
+		put_be(buf, (acl_uint64) n, 4);
+	} else {
+		ADDCH(buf, 0xd3);
+		put_be(buf, (acl_uint64) n, 8);
+	}
+}
+
+/* رʾΪʱ 4 ֽڱ */
+
+static void put_double(PACKER *packer, double d)
+{
+	ACL_VSTRING *buf = packer->buf;
+	float f = (float) d;
+	union { float f; unsigned u; } u4;
+	union { double d; acl_uint64 u; } u8;
+
+	if ((double) f == d) {
+		u4.f = f;
+		ADDCH(buf, packer->cbor ? 0xfa : 0xca);
+		put_be(buf, u4.u, 4);
+	} else {
+		u8.d = d;
+		ADDCH(buf, packer->cbor ? 0xfb : 0xcb);
+		put_be(buf, u8.u, 8);
+	}
+}
+
+static void put_bool(PACKER *packer, int yes)
+{
+	if (packer->cbor)
+		ADDCH(packer->buf, yes ? 0xf5 : 0xf4);
+	else
+		ADDCH(packer->buf, yes ? 0xc3 : 0xc2);
+}
+
+static void put_null(PACKER *packer)
+{
+	ADDCH(packer->buf, packer->cbor ? 0xf6 : 0xc0);
+}
+
+static void put_str(PACKER *packer, const char *s, size_t len)
+{
+	ACL_VSTRING *buf = packer->buf;
+
+	if (packer->cbor)
+		cbor_head(buf, 3, len);
+	else if (len < 32)
+		ADDCH(buf, 0xa0 | (int) len);
+	else if (len <= 0xff) {
+		ADDCH(buf, 0xd9);
+		put_be(buf, len, 1);
+	} else if (len <= 0xffff) {
+		ADDCH(buf, 0xda);
+		put_be(buf, len, 2);
+	} else {
+		ADDCH(buf, 0xdb);
+		put_be(buf, len, 4);
+	}
+
+	if (len > 0)
+		acl_vstring_memcat(buf, s, len);
+}
+
+static void put_array(PACKER *packer, size_t n)
+{
+	ACL_VSTRING *buf = packer->buf;
+
+	if (packer->cbor)
+		cbor_head(buf, 4, n);
+	else if (n < 16)
+		ADDCH(buf, 0x90 | (int) n);
+	else if (n <= 0xffff) {
+		ADDCH(buf, 0xdc);
+		put_be(buf, n, 2);
+	} else {
+		ADDCH(buf, 0xdd);
+		put_be(buf, n, 4);
+	}
+}
+
+static void put_map(PACKER *packer, size_t n)
+{
+	ACL_VSTRING *buf = packer->buf;
+
+	if (packer->cbor)
+		cbor_head(buf, 5, n);
+	else if (n < 16)
+		ADDCH(buf, 0x80 | (int) n);
+	else if (n <= 0xffff) {
+		ADDCH(buf, 0xde);
+		put_be(buf, n, 2);
+	} else {
+		ADDCH(buf, 0xdf);
+		put_be(buf, n, 4);
+	}
+}
+
+/* ֵıȰʱٰ */
+
+static void put_number(PACKER *packer, ACL_JSON_NODE *node)
+{
+	const char *s = STR(node->text);
+	char *end;
+	acl_int64 n;
+	acl_uint64 u;
+	double d;
+
+	errno = 0;
+#ifdef WIN32
+	n = _strtoi64(s, &end, 10);
+#else
+	n = strtoll(s, &end, 10);
+#endif
+	if (end != s && *end == 0) {
+		if (errno == 0) {
+			put_int(packer, n);
+			return;
+		}
+
+		/*  long long Χ */
+		if (*s != '-') {
+			errno = 0;
+#ifdef WIN32
+			u = _strtoui64(s, &end, 10);
+#else
+			u = strtoull(s, &end, 10);
+#endif
+			if (errno == 0) {
+				put_uint(packer, u);
+				return;
+			}
+		}
+	}
+
+	d = strtod(s, &end);
+	if (end != s && *end == 0)
+		put_double(packer, d);
+	else
+		put_str(packer, s, LEN(node->text));
+}
+
+static void pack_value(PACKER *packer, ACL_JSON_NODE *node);
+
+/*  acl_json_update ɵĿնкһյռλ㣬
+ *  acl_json_build һ£ıΪյķַҲ
+ */
+
+static int is_placeholder(ACL_JSON_NODE *node)
+{
+	if (node->tag_node != NULL || node->left_ch != 0
+		|| acl_ring_size(&node->children) > 0)
+	{
+		return 0;
+	}
+	if (node->parent && node->parent->left_ch == '[')
+		return LEN(node->text) == 0
+			&& !(node->type & ACL_JSON_T_A_STRING);
+	return node->type == ACL_JSON_T_MEMBER && LEN(node->ltag) == 0;
+}
+
+static size_t child_count(ACL_JSON_NODE *node)
+{
+	ACL_RING *ring = &node->children, *iter;
+	size_t n = 0;
+
+	for (iter = acl_ring_succ(ring); iter != ring; iter = acl_ring_succ(iter))
+		if (!is_placeholder(acl_ring_to_appl(iter, ACL_JSON_NODE, node)))
+			n++;
+	return n;
+}
+
+static void pack_leaf(PACKER *packer, ACL_JSON_NODE *node)
+{
+	if (node->type & (ACL_JSON_T_BOOL | ACL_JSON_T_A_BOOL))
+		put_bool(packer, strcasecmp(STR(node->text), "true") == 0);
+	else if (node->type & ACL_JSON_T_NULL)
+		put_null(packer);
+	else if (node->type & (ACL_JSON_T_NUMBER | ACL_JSON_T_A_NUMBER))
+		put_number(packer, node);
+	else
+		put_str(packer, STR(node->text), LEN(node->text));
+}
+
+static void pack_container(PACKER *packer, ACL_JSON_NODE *node)
+{
+	ACL_RING *ring = &node->children, *iter;
+	ACL_JSON_NODE *child;
+	int   is_map = node->left_ch != '[';
+
+	if (is_map)
+		put_map(packer, child_count(node));
+	else
+		put_array(packer, child_count(node));
+
+	for (iter = acl_ring_succ(ring); iter != ring; iter = acl_ring_succ(iter)) {
+		child = acl_ring_to_appl(iter, ACL_JSON_NODE, node);
+		if (is_placeholder(child))
+			continue;
+
+		if (is_map) {
+			put_str(packer, STR(child->ltag), LEN(child->ltag));
+			if (child->tag_node != NULL)
+				pack_value(packer, child->tag_node);
+			else if (child->left_ch != 0)
+				pack_container(packer, child);
+			else
+				pack_leaf(packer, child);
+		} else
+			pack_value(packer, child);
+	}
+}
+
+/* дǩĽΪֻһԱĶ */
+
+static void pack_value(PACKER *packer, ACL_JSON_NODE *node)
+{
+	if (LEN(node->ltag) > 0) {
+		put_map(packer, 1);
+		put_str(packer, STR(node->ltag), LEN(node->ltag));
+	}
+
+	if (node->tag_node != NULL)
+		pack_value(packer, node->tag_node);
+	else if (node->left_ch != 0)
+		pack_container(packer, node);
+	else
+		pack_leaf(packer, node);
+}
+
+static ACL_VSTRING *json_pack(ACL_JSON *json, ACL_VSTRING *buf, int cbor)
+{
+	PACKER packer;
+	ACL_JSON_NODE *root = json->root;
+
+	if (buf == NULL)
+		buf = acl_vstring_alloc(256);
+
+	packer.buf = buf;
+	packer.cbor = cbor;
+
+	/* ûʱ( acl_json_create )ֻһӽ */
+	if (root->left_ch == 0 && acl_ring_size(&root->children) > 0)
+		pack_value(&packer, acl_ring_to_appl(
+			acl_ring_succ(&root->children), ACL_JSON_NODE, node));
+	else
+		pack_container(&packer, root);
+
+	ACL_VSTRING_TERMINATE(buf);
+	return buf;
+}
+
+static ACL_VSTRING *json_node_pack(ACL_JSON_NODE *node, ACL_VSTRING *buf,
+	int cbor)
+{
+	PACKER packer;
+
+	if (node == node->json->root)
+		return json_pack(node->json, buf, cbor);
+
+	if (buf == NULL)
+		buf = acl_vstring_alloc(256);
+
+	packer.buf = buf;
+	packer.cbor = cbor;
+	pack_value(&packer, node);
+
+	ACL_VSTRING_TERMINATE(buf);
+	return buf;
+}
+
+ACL_VSTRING *acl_json_build_msgpack(ACL_JSON *json, ACL_VSTRING *buf)
+{
+	return json_pack(json, buf, 0);
+}
+
+ACL_VSTRING *acl_json_node_build_msgpack(ACL_JSON_NODE *node, ACL_VSTRING *buf)
+{
+	return json_node_pack(node, buf, 0);
+}
+
+ACL_VSTRING *acl_json_build_cbor(ACL_JSON *json, ACL_VSTRING *buf)
+{
+	return json_pack(json, buf, 1);
+}
+
+ACL_VSTRING *acl_json_node_build_cbor(ACL_JSON_NODE *node, ACL_VSTRING *buf)
+{
+	return json_node_pack(node, buf, 1);
+}
+
+/*-----------------------------  ----------------------------------*/
+
+typedef struct UNPACKER {
+	ACL_JSON *json;
+	const unsigned char *ptr;
+	const unsigned char *end;
+	int   more;		/* ݲ */
+	int   top;		/* Ķֱʹø */
+} UNPACKER;
+
+#define	NEED(u, n) do { \
+	if ((acl_uint64) ((u)->end - (u)->ptr) < (acl_uint64) (n)) { \
+		(u)->more = 1; \
+		return -1; \
+	} \
+} while (0)
+
+static acl_uint64 get_be(UNPACKER *u, int size)
+{
+	acl_uint64 n = 0;
+
+	while (size-- > 0)
+		n = (n << 8) | *u->ptr++;
+	return n;
+}
+
+static ACL_JSON_NODE *new_node(ACL_JSON *json, ACL_JSON_NODE *parent, int type)
+{
+	ACL_JSON_NODE *node = acl_json_node_alloc(json);
+
+	node->type = type;
+	node->depth = parent->depth + 1;
+	if (node->depth > json->depth)
+		json->depth = node->depth;
+	acl_json_node_add_child(parent, node);
+	return node;
+}
+
+/* ԱֵдԱУԪ½һ */
+
+static ACL_JSON_NODE *leaf_node(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int member_type, int element_type)
+{
+	if (pair != NULL) {
+		pair->type = member_type;
+		return pair;
+	}
+	return new_node(u->json, parent, element_type);
+}
+
+static void set_int(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, acl_int64 n)
+{
+	ACL_JSON_NODE *node = leaf_node(u, parent, pair,
+		ACL_JSON_T_NUMBER, ACL_JSON_T_A_NUMBER);
+	char  buf[32];
+
+	acl_vstring_strcpy(node->text, acl_i64toa(n, buf, sizeof(buf)));
+}
+
+static void set_uint(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, acl_uint64 n)
+{
+	ACL_JSON_NODE *node = leaf_node(u, parent, pair,
+		ACL_JSON_T_NUMBER, ACL_JSON_T_A_NUMBER);
+	char  buf[32];
+
+	acl_vstring_strcpy(node->text, acl_ui64toa(n, buf, sizeof(buf)));
+}
+
+/* ܻԭֵͬʽֵȵЧλ */
+
+static void set_null(UNPACKER *u, ACL_JSON_NODE *parent, ACL_JSON_NODE *pair);
+
+static void set_double(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, double d, int is_float)
+{
+	ACL_JSON_NODE *node;
+	char  buf[64];
+
+	/* NaN  json ޷ʾ */
+	if (d != d || d - d != d - d) {
+		set_null(u, parent, pair);
+		return;
+	}
+
+	node = leaf_node(u, parent, pair, ACL_JSON_T_NUMBER,
+		ACL_JSON_T_A_NUMBER);
+
+	if (is_float) {
+		snprintf(buf, sizeof(buf), "%.7g", d);
+		if ((float) strtod(buf, NULL) != (float) d)
+			snprintf(buf, sizeof(buf), "%.9g", d);
+	} else {
+		snprintf(buf, sizeof(buf), "%.15g", d);
+		if (strtod(buf, NULL) != d)
+			snprintf(buf, sizeof(buf), "%.17g", d);
+	}
+	acl_vstring_strcpy(node->text, buf);
+}
+
+static void set_bool(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int yes)
+{
+	ACL_JSON_NODE *node = leaf_node(u, parent, pair,
+		ACL_JSON_T_BOOL, ACL_JSON_T_A_BOOL);
+
+	acl_vstring_strcpy(node->text, yes ? "true" : "false");
+}
+
+static void set_null(UNPACKER *u, ACL_JSON_NODE *parent, ACL_JSON_NODE *pair)
+{
+	ACL_JSON_NODE *node = leaf_node(u, parent, pair,
+		ACL_JSON_T_NULL, ACL_JSON_T_NULL);
+
+	acl_vstring_strcpy(node->text, "null");
+}
+
+static ACL_VSTRING *set_str(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair)
+{
+	ACL_JSON_NODE *node = leaf_node(u, parent, pair,
+		ACL_JSON_T_TEXT, ACL_JSON_T_A_STRING);
+
+	ACL_VSTRING_RESET(node->text);
+	ACL_VSTRING_TERMINATE(node->text);
+	return node->text;
+}
+
+/* 㣬ΪԱֵʱΪԱıǩֵ */
+
+static ACL_JSON_NODE *open_node(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int is_map)
+{
+	ACL_JSON_NODE *node;
+
+	if (u->top) {
+		u->top = 0;
+		node = u->json->root;
+		node->type = is_map ? ACL_JSON_T_OBJ : ACL_JSON_T_ARRAY;
+	} else if (pair != NULL) {
+		node = new_node(u->json, pair, is_map ? ACL_JSON_T_OBJ
+			: ACL_JSON_T_ARRAY);
+		pair->tag_node = node;
+	} else
+		node = new_node(u->json, parent, is_map ? ACL_JSON_T_OBJ
+			: ACL_JSON_T_ARRAY);
+
+	node->left_ch = is_map ? '{' : '[';
+	node->right_ch = is_map ? '}' : ']';
+	return node;
+}
+
+/*----------------------------- MessagePack ---------------------------*/
+
+static int msgpack_value(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth);
+
+static int msgpack_str(UNPACKER *u, ACL_VSTRING *buf, size_t len)
+{
+	NEED(u, len);
+	acl_vstring_memcpy(buf, (const char*) u->ptr, len);
+	ACL_VSTRING_TERMINATE(buf);
+	u->ptr += len;
+	return 0;
+}
+
+/* ĳԱַƴ */
+
+static int msgpack_key(UNPACKER *u, ACL_VSTRING *key)
+{
+	int   ch;
+	char  buf[32];
+
+	NEED(u, 1);
+	ch = *u->ptr++;
+
+	if ((ch & 0xe0) == 0xa0)
+		return msgpack_str(u, key, ch & 0x1f);
+	if (ch <= 0x7f || ch >= 0xe0) {
+		acl_vstring_strcpy(key, acl_i64toa(ch <= 0x7f ? ch : ch - 256,
+			buf, sizeof(buf)));
+		return 0;
+	}
+
+	switch (ch) {
+	case 0xd9:
+	case 0xc4:
+		NEED(u, 1);
+		return msgpack_str(u, key, (size_t) get_be(u, 1));
+	case 0xda:
+	case 0xc5:
+		NEED(u, 2);
+		return msgpack_str(u, key, (size_t) get_be(u, 2));
+	case 0xdb:
+	case 0xc6:
+		NEED(u, 4);
+		return msgpack_str(u, key, (size_t) get_be(u, 4));
+	case 0xcc:
+	case 0xcd:
+	case 0xce:
+	case 0xcf:
+		NEED(u, 1 << (ch - 0xcc));
+		acl_vstring_strcpy(key, acl_ui64toa(get_be(u, 1 << (ch - 0xcc)),
+			buf, sizeof(buf)));
+		return 0;
+	case 0xd0:
+		NEED(u, 1);
+		acl_vstring_strcpy(key, acl_i64toa((signed char) get_be(u, 1),
+			buf, sizeof(buf)));
+		return 0;
+	case 0xd1:
+		NEED(u, 2);
+		acl_vstring_strcpy(key, acl_i64toa((short) get_be(u, 2),
+			buf, sizeof(buf)));
+		return 0;
+	case 0xd2:
+		NEED(u, 4);
+		acl_vstring_strcpy(key, acl_i64toa((int) get_be(u, 4),
+			buf, sizeof(buf)));
+		return 0;
+	case 0xd3:
+		NEED(u, 8);
+		acl_vstring_strcpy(key, acl_i64toa((acl_int64) get_be(u, 8),
+			buf, sizeof(buf)));
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+static int msgpack_container(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth, size_t n, int is_map)
+{
+	ACL_JSON_NODE *node, *child;
+
+	if (depth >= MAX_DEPTH)
+		return -1;
+
+	/* ÿԱռһֽ */
+	NEED(u, n);
+
+	node = open_node(u, parent, pair, is_map);
+	while (n-- > 0) {
+		if (is_map) {
+			child = new_node(u->json, node, ACL_JSON_T_LEAF);
+			if (msgpack_key(u, child->ltag) == -1)
+				return -1;
+			acl_json_index_add(u->json, child);
+		} else
+			child = NULL;
+
+		if (msgpack_value(u, node, child, depth + 1) == -1)
+			return -1;
+	}
+	return 0;
+}
+
+static int msgpack_value(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth)
+{
+	int   ch;
+	union { float f; unsigned u; } u4;
+	union { double d; acl_uint64 u; } u8;
+
+	NEED(u, 1);
+	ch = *u->ptr++;
+
+	if (ch <= 0x7f) {
+		set_int(u, parent, pair, ch);
+		return 0;
+	}
+	if (ch >= 0xe0) {
+		set_int(u, parent, pair, (signed char) ch);
+		return 0;
+	}
+	if ((ch & 0xe0) == 0xa0)
+		return msgpack_str(u, set_str(u, parent, pair), ch & 0x1f);
+	if ((ch & 0xf0) == 0x90)
+		return msgpack_container(u, parent, pair, depth, ch & 0x0f, 0);
+	if ((ch & 0xf0) == 0x80)
+		return msgpack_container(u, parent, pair, depth, ch & 0x0f, 1);
+
+	switch (ch) {
+	case 0xc0:
+		set_null(u, parent, pair);
+		return 0;
+	case 0xc2:
+	case 0xc3:
+		set_bool(u, parent, pair, ch == 0xc3);
+		return 0;
+	case 0xc4:
+	case 0xd9:
+		NEED(u, 1);
+		return msgpack_str(u, set_str(u, parent, pair),
+			(size_t) get_be(u, 1));
+	case 0xc5:
+	case 0xda:
+		NEED(u, 2);
+		return msgpack_str(u, set_str(u, parent, pair),
+			(size_t) get_be(u, 2));
+	case 0xc6:
+	case 0xdb:
+		NEED(u, 4);
+		return msgpack_str(u, set_str(u, parent, pair),
+			(size_t) get_be(u, 4));
+	case 0xca:
+		NEED(u, 4);
+		u4.u = (unsigned) get_be(u, 4);
+		set_double(u, parent, pair, u4.f, 1);
+		return 0;
+	case 0xcb:
+		NEED(u, 8);
+		u8.u = get_be(u, 8);
+		set_double(u, parent, pair, u8.d, 0);
+		return 0;
+	case 0xcc:
+	case 0xcd:
+	case 0xce:
+	case 0xcf:
+		NEED(u, 1 << (ch - 0xcc));
+		set_uint(u, parent, pair, get_be(u, 1 << (ch - 0xcc)));
+		return 0;
+	case 0xd0:
+		NEED(u, 1);
+		set_int(u, parent, pair, (signed char) get_be(u, 1));
+		return 0;
+	case 0xd1:
+		NEED(u, 2);
+		set_int(u, parent, pair, (short) get_be(u, 2));
+		return 0;
+	case 0xd2:
+		NEED(u, 4);
+		set_int(u, parent, pair, (int) get_be(u, 4));
+		return 0;
+	case 0xd3:
+		NEED(u, 8);
+		set_int(u, parent, pair, (acl_int64) get_be(u, 8));
+		return 0;
+	case 0xdc:
+		NEED(u, 2);
+		return msgpack_container(u, parent, pair, depth,
+			(size_t) get_be(u, 2), 0);
+	case 0xdd:
+		NEED(u, 4);
+		return msgpack_container(u, parent, pair, depth,
+			(size_t) get_be(u, 4), 0);
+	case 0xde:
+		NEED(u, 2);
+		return msgpack_container(u, parent, pair, depth,
+			(size_t) get_be(u, 2), 1);
+	case 0xdf:
+		NEED(u, 4);
+		return msgpack_container(u, parent, pair, depth,
+			(size_t) get_be(u, 4), 1);
+	default:
+		/* 0xc1 δ壬չ json ûжӦıʾ */
+		return -1;
+	}
+}
+
+/*-------------------------------- CBOR -------------------------------*/
+
+#define	CBOR_INDEFINITE	((acl_uint64) -1)
+
+static int cbor_value(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth);
+
+/* ȡͷеĲʱ CBOR_INDEFINITE */
+
+static int cbor_arg(UNPACKER *u, int info, acl_uint64 *n)
+{
+	if (info < 24)
+		*n = info;
+	else if (info <= 27) {
+		NEED(u, 1 << (info - 24));
+		*n = get_be(u, 1 << (info - 24));
+	} else if (info == 31)
+		*n = CBOR_INDEFINITE;
+	else
+		return -1;
+	return 0;
+}
+
+static int cbor_break(UNPACKER *u)
+{
+	NEED(u, 1);
+	if (*u->ptr != 0xff)
+		return 0;
+	u->ptr++;
+	return 1;
+}
+
+/* ַƴʱͬ͵ĶƴӶ */
+
+static int cbor_str(UNPACKER *u, ACL_VSTRING *buf, int major, acl_uint64 n)
+{
+	int   ch, ret;
+
+	if (n != CBOR_INDEFINITE) {
+		NEED(u, n);
+		acl_vstring_memcat(buf, (const char*) u->ptr, (size_t) n);
+		ACL_VSTRING_TERMINATE(buf);
+		u->ptr += n;
+		return 0;
+	}
+
+	while ((ret = cbor_break(u)) == 0) {
+		ch = *u->ptr++;
+		if ((ch >> 5) != major || (ch & 0x1f) == 31)
+			return -1;
+		if (cbor_arg(u, ch & 0x1f, &n) == -1)
+			return -1;
+		if (cbor_str(u, buf, major, n) == -1)
+			return -1;
+	}
+	return ret == 1 ? 0 : -1;
+}
+
+static int cbor_key(UNPACKER *u, ACL_VSTRING *key)
+{
+	int   ch;
+	acl_uint64 n;
+	char  buf[32];
+
+	NEED(u, 1);
+	ch = *u->ptr++;
+	if (cbor_arg(u, ch & 0x1f, &n) == -1)
+		return -1;
+
+	switch (ch >> 5) {
+	case 0:
+		acl_vstring_strcpy(key, acl_ui64toa(n, buf, sizeof(buf)));
+		return 0;
+	case 1:
+		if (n > ((acl_uint64) -1 >> 1))
+			return -1;
+		acl_vstring_strcpy(key, acl_i64toa(-1 - (acl_int64) n,
+			buf, sizeof(buf)));
+		return 0;
+	case 2:
+	case 3:
+		ACL_VSTRING_RESET(key);
+		return cbor_str(u, key, ch >> 5, n);
+	default:
+		return -1;
+	}
+}
+
+static int cbor_container(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth, acl_uint64 n, int is_map)
+{
+	ACL_JSON_NODE *node, *child;
+	int   ret;
+
+	if (depth >= MAX_DEPTH)
+		return -1;
+	if (n != CBOR_INDEFINITE)
+		NEED(u, n);
+
+	node = open_node(u, parent, pair, is_map);
+	for (;;) {
+		if (n == CBOR_INDEFINITE) {
+			if ((ret = cbor_break(u)) == 1)
+				break;
+			else if (ret == -1)
+				return -1;
+		} else if (n-- == 0)
+			break;
+
+		if (is_map) {
+			child = new_node(u->json, node, ACL_JSON_T_LEAF);
+			if (cbor_key(u, child->ltag) == -1)
+				return -1;
+			acl_json_index_add(u->json, child);
+		} else
+			child = NULL;
+
+		if (cbor_value(u, node, child, depth + 1) == -1)
+			return -1;
+	}
+	return 0;
+}
+
+/* 뾫ȸλתΪȸ */
+
+static float half_to_float(unsigned half)
+{
+	unsigned sign = (half & 0x8000) << 16;
+	unsigned exp = (half >> 10) & 0x1f, mant = half & 0x3ff;
+	union { float f; unsigned u; } u4;
+
+	if (exp == 31)
+		u4.u = sign | 0x7f800000 | (mant << 13);
+	else if (exp != 0)
+		u4.u = sign | ((exp + 112) << 23) | (mant << 13);
+	else if (mant == 0)
+		u4.u = sign;
+	else {
+		/* ǹ */
+		exp = 113;
+		while (!(mant & 0x400)) {
+			mant <<= 1;
+			exp--;
+		}
+		u4.u = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+	}
+	return u4.f;
+}
+
+static int cbor_simple(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int info)
+{
+	union { float f; unsigned u; } u4;
+	union { double d; acl_uint64 u; } u8;
+
+	switch (info) {
+	case 20:
+	case 21:
+		set_bool(u, parent, pair, info == 21);
+		return 0;
+	case 22:
+	case 23:
+		/* null  undefined */
+		set_null(u, parent, pair);
+		return 0;
+	case 25:
+		NEED(u, 2);
+		set_double(u, parent, pair,
+			half_to_float((unsigned) get_be(u, 2)), 1);
+		return 0;
+	case 26:
+		NEED(u, 4);
+		u4.u = (unsigned) get_be(u, 4);
+		set_double(u, parent, pair, u4.f, 1);
+		return 0;
+	case 27:
+		NEED(u, 8);
+		u8.u = get_be(u, 8);
+		set_double(u, parent, pair, u8.d, 0);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+static int cbor_value(UNPACKER *u, ACL_JSON_NODE *parent,
+	ACL_JSON_NODE *pair, int depth)
+{
+	int   ch, major;
+	acl_uint64 n;
+
+	NEED(u, 1);
+	ch = *u->ptr++;
+	major = ch >> 5;
+
+	if (major == 7)
+		return cbor_simple(u, parent, pair, ch & 0x1f);
+	if (cbor_arg(u, ch & 0x1f, &n) == -1)
+		return -1;
+
+	switch (major) {
+	case 0:
+		if (n == CBOR_INDEFINITE)
+			return -1;
+		set_uint(u, parent, pair, n);
+		return 0;
+	case 1:
+		if (n == CBOR_INDEFINITE)
+			return -1;
+		if (n <= ((acl_uint64) -1 >> 1))
+			set_int(u, parent, pair, -1 - (acl_int64) n);
+		else
+			set_double(u, parent, pair, -1.0 - (double) n, 0);
+		return 0;
+	case 2:
+	case 3:
+		return cbor_str(u, set_str(u, parent, pair), major, n);
+	case 4:
+	case 5:
+		return cbor_container(u, parent, pair, depth, n, major == 5);
+	case 6:
+		/* Աǩֻȡǵ */
+		if (n == CBOR_INDEFINITE || depth >= MAX_DEPTH)
+			return -1;
+		return cbor_value(u, parent, pair, depth + 1);
+	default:
+		return -1;
+	}
+}
+
+/*---------------------------------------------------------------------*/
+
+static int json_unpack(ACL_JSON *json, const void *data, size_t len, int cbor)
+{
+	UNPACKER u;
+	int   ret, ch;
+
+	if (len == 0)
+		return 0;
+	if (json->finish || acl_ring_size(&json->root->children) > 0)
+		return -1;
+
+	/*  json ıһ£ֻǶ飬ֱΪ */
+	ch = *(const unsigned char*) data;
+	if (cbor ? (ch >> 5) != 4 && (ch >> 5) != 5
+		: (ch & 0xe0) != 0x80 && (ch < 0xdc || ch > 0xdf))
+	{
+		return -1;
+	}
+
+	u.json = json;
+	u.ptr = (const unsigned char*) data;
+	u.end = u.ptr + len;
+	u.more = 0;
+	u.top = 1;
+
+	ret = cbor ? cbor_value(&u, NULL, NULL, 0)
+		: msgpack_value(&u, NULL, NULL, 0);
+
+	if (ret == -1) {
+		ret = u.more ? 0 : -1;
+		acl_json_reset(json);
+		return ret;
+	}
+
+	json->curr_node = json->root;
+	json->status = ACL_JSON_S_NEXT;
+	json->finish = 1;
+	return (int) (u.ptr - (const unsigned char*) data);
+}
+
+int acl_json_update_msgpack(ACL_JSON *json, const void *data, size_t len)
+{
+	return json_unpack(json, data, len, 0);
+}
+
+int acl_json_update_cbor(ACL_JSON *json, const void *data, size_t len)
+{
+	return json_unpack(json, data, len, 1);
+}
@@ -0,0 +1,634 @@
+#include "StdAfx.h"
+#include <stdio.h>
+#ifndef ACL_PREPARE_COMPILE
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_vstring.h"
+#include "json/acl_json.h"
+#endif
+
+/*
+ * ׶ε json 
+ * һ׶ΰÿ 64 ֽһ飬 SSE2/AVX2 Ƚָõšתṹַ
+ * ({ } [ ] : ,) λͼתλͼȥתţλͼǰ׺
+ * õַ򣬴ӶȥַڵĽṹַнṹַŵλ
+ * 飻
+ * ڶ׶ΰ˳򴴽 json 㣬ַοֽڴ
+ * ɵĽ acl_json_update ȫͬڶ׶βֵ֧ķǱ׼
+ * д(šŵıǩĶŵ)ݲʱ
+ * acl_json_update ״̬
+ */
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define JSON_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define JSON_USE_SSE2
+#endif
+
+#if defined(__PCLMUL__) && (defined(JSON_USE_AVX2) || defined(JSON_USE_SSE2))
+# include <wmmintrin.h>
+# define JSON_USE_CLMUL
+#endif
+
+#ifdef MS_VC6
+# define ODD_BITS	0xaaaaaaaaaaaaaaaa
+#else
+# define ODD_BITS	0xaaaaaaaaaaaaaaaall
+#endif
+
+#define	BLOCK_SIZE	64
+#define	INDEX_INIT	256
+
+#define	STR	acl_vstring_str
+#define	LEN	ACL_VSTRING_LEN
+#define	ADDCH	ACL_VSTRING_ADDCH
+
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n')
+#define SKIP_SPACE(ptr) { while(IS_SPACE(*(ptr))) (ptr)++; }
+
+typedef struct JSON_INDEX {
+	unsigned *pos;		/* ṹַеƫλ */
+	size_t cnt;
+	unsigned buf[INDEX_INIT];	/* Сʱڴ */
+} JSON_INDEX;
+
+typedef struct JSON_FAST {
+	ACL_JSON *json;
+	const char *data;
+	const char *ptr;	/* ǰλ */
+	const unsigned *pos;
+	size_t cnt;
+	size_t i;		/* һ */
+} JSON_FAST;
+
+enum {
+	FAST_S_OBJ,		/*  '{' */
+	FAST_S_MEMBER,		/*  ',' ֮ */
+	FAST_S_ARRAY,		/*  '[' */
+	FAST_S_ELEMENT,		/*  ',' ֮ */
+	FAST_S_NEXT		/* һֵ֮ */
+};
+
+/*------------------------------ stage one --------------------------------*/
+
+static int bit_ctz(acl_uint64 x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	int   n = 0;
+
+	if ((x & 0xffffffff) == 0) {
+		n += 32;
+		x >>= 32;
+	}
+	if ((x & 0xffff) == 0) {
+		n += 16;
+		x >>= 16;
+	}
+	if ((x & 0xff) == 0) {
+		n += 8;
+		x >>= 8;
+	}
+	while ((x & 1) == 0) {
+		n++;
+		x >>= 1;
+	}
+	return n;
+#endif
+}
+
+/* ӵ 0 λ i λڵ i λÿ֮λ */
+
+static acl_uint64 prefix_xor(acl_uint64 x)
+{
+#ifdef JSON_USE_CLMUL
+	__m128i all = _mm_set1_epi8((char) 0xff);
+	__m128i res = _mm_clmulepi64_si128(
+		_mm_set_epi64x(0, (long long) x), all, 0);
+
+	return (acl_uint64) _mm_cvtsi128_si64(res);
+#else
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+#endif
+}
+
+/* 㱻תַλͼż '\' ໥ʱתַ
+ * escaped ¼һһַǷΪδ '\'
+ */
+
+static acl_uint64 block_escaped(acl_uint64 bs, acl_uint64 *escaped)
+{
+	acl_uint64 potential, maybe, code, result;
+
+	if (bs == 0) {
+		result = *escaped;
+		*escaped = 0;
+		return result;
+	}
+
+	potential = bs & ~*escaped;
+	maybe = (potential << 1) | ODD_BITS;
+	code = (maybe - potential) ^ ODD_BITS;
+	result = code ^ (bs | *escaped);
+	*escaped = (code & bs) >> 63;
+	return result;
+}
+
+/* õ 64 ֽšתṹַλͼ */
+
+static void block_classify(const unsigned char *in, acl_uint64 *quote,
+	acl_uint64 *bs, acl_uint64 *op)
+{
+#if defined(JSON_USE_AVX2)
+	const __m256i cq = _mm256_set1_epi8('"');
+	const __m256i cb = _mm256_set1_epi8('\\');
+	const __m256i c20 = _mm256_set1_epi8(0x20);
+	const __m256i cl = _mm256_set1_epi8('{');
+	const __m256i cr = _mm256_set1_epi8('}');
+	const __m256i cc = _mm256_set1_epi8(':');
+	const __m256i cm = _mm256_set1_epi8(',');
+	int   i;
+
+	*quote = *bs = *op = 0;
+	for (i = 0; i < BLOCK_SIZE; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*) (in + i));
+		/* '[' | 0x20 == '{', ']' | 0x20 == '}' */
+		__m256i u = _mm256_or_si256(v, c20);
+		__m256i s = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(u, cl),
+				_mm256_cmpeq_epi8(u, cr)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, cc),
+				_mm256_cmpeq_epi8(v, cm)));
+
+		*quote |= (acl_uint64) (unsigned) _mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(v, cq)) << i;
+		*bs |= (acl_uint64) (unsigned) _mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(v, cb)) << i;
+		*op |= (acl_uint64) (unsigned) _mm256_movemask_epi8(s) << i;
+	}
+#elif defined(JSON_USE_SSE2)
+	const __m128i cq = _mm_set1_epi8('"');
+	const __m128i cb = _mm_set1_epi8('\\');
+	const __m128i c20 = _mm_set1_epi8(0x20);
+	const __m128i cl = _mm_set1_epi8('{');
+	const __m128i cr = _mm_set1_epi8('}');
+	const __m128i cc = _mm_set1_epi8(':');
+	const __m128i cm = _mm_set1_epi8(',');
+	int   i;
+
+	*quote = *bs = *op = 0;
+	for (i = 0; i < BLOCK_SIZE; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+		/* '[' | 0x20 == '{', ']' | 0x20 == '}' */
+		__m128i u = _mm_or_si128(v, c20);
+		__m128i s = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(u, cl),
+				_mm_cmpeq_epi8(u, cr)),
+			_mm_or_si128(_mm_cmpeq_epi8(v, cc),
+				_mm_cmpeq_epi8(v, cm)));
+
+		*quote |= (acl_uint64) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(v, cq)) << i;
+		*bs |= (acl_uint64) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(v, cb)) << i;
+		*op |= (acl_uint64) _mm_movemask_epi8(s) << i;
+	}
+#else
+	acl_uint64 bit = 1;
+	int   i;
+
+	*quote = *bs = *op = 0;
+	for (i = 0; i < BLOCK_SIZE; i++, bit <<= 1) {
+		switch (in[i]) {
+		case '"':
+			*quote |= bit;
+			break;
+		case '\\':
+			*bs |= bit;
+			break;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ':':
+		case ',':
+			*op |= bit;
+			break;
+		default:
+			break;
+		}
+	}
+#endif
+}
+
+/* һ׶ΣַĽṹַδתŵλ */
+
+static void json_index(JSON_INDEX *index, const char *data, size_t len)
+{
+	const unsigned char *ptr = (const unsigned char*) data;
+	unsigned char tail[BLOCK_SIZE];
+	acl_uint64 quote, bs, op, in_str, bits;
+	acl_uint64 prev_escaped = 0, prev_in_str = 0;
+	size_t off;
+
+	for (off = 0; off < len; off += BLOCK_SIZE) {
+		const unsigned char *in;
+
+		if (len - off >= BLOCK_SIZE)
+			in = ptr + off;
+		else {
+			memset(tail, 0, sizeof(tail));
+			memcpy(tail, ptr + off, len - off);
+			in = tail;
+		}
+
+		block_classify(in, &quote, &bs, &op);
+		quote &= ~block_escaped(bs, &prev_escaped);
+
+		in_str = prefix_xor(quote) ^ prev_in_str;
+		prev_in_str = (in_str >> 63) ? ~(acl_uint64) 0 : 0;
+
+		bits = (op & ~in_str) | quote;
+		while (bits) {
+			index->pos[index->cnt++] = (unsigned) (off + bit_ctz(bits));
+			bits &= bits - 1;
+		}
+	}
+}
+
+/* Ƿȥ֮Ķʱ -1 */
+
+static int json_complete(JSON_INDEX *index, const char *data)
+{
+	size_t i;
+	int   depth = 0;
+
+	if (index->cnt == 0 || data[index->pos[0]] != '{')
+		return -1;
+
+	for (i = 0; i < index->cnt; i++) {
+		switch (data[index->pos[i]]) {
+		case '{':
+		case '[':
+			depth++;
+			break;
+		case '}':
+		case ']':
+			if (--depth == 0) {
+				index->cnt = i + 1;
+				return 0;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return -1;
+}
+
+/*------------------------------ stage two --------------------------------*/
+
+/*  json_tag/json_string ķʽڵַ */
+
+static void json_unescape(ACL_VSTRING *buf, const char *ptr,
+	const char *end, int skip_space)
+{
+	const char *bs;
+
+	/*  json_string һ£ֵַͷĿհױ */
+	if (skip_space) {
+		while (ptr < end && IS_SPACE(*ptr))
+			ptr++;
+	}
+
+	while (ptr < end) {
+		bs = (const char*) memchr(ptr, '\\', end - ptr);
+		if (bs == NULL) {
+			acl_vstring_memcat(buf, ptr, end - ptr);
+			break;
+		}
+		if (bs > ptr)
+			acl_vstring_memcat(buf, ptr, bs - ptr);
+
+		/* βδת壬 '\' ֮һַ */
+		bs++;
+		switch (*bs) {
+		case 'b':
+			ADDCH(buf, '\b');
+			break;
+		case 'f':
+			ADDCH(buf, '\f');
+			break;
+		case 'n':
+			ADDCH(buf, '\n');
+			break;
+		case 'r':
+			ADDCH(buf, '\r');
+			break;
+		case 't':
+			ADDCH(buf, '\t');
+			break;
+		default:
+			ADDCH(buf, *bs);
+			break;
+		}
+		ptr = bs + 1;
+	}
+
+	ACL_VSTRING_TERMINATE(buf);
+}
+
+/* ȡһڵַǰλֻ֮пհ */
+
+static int fast_peek(JSON_FAST *fast)
+{
+	const char *end;
+
+	if (fast->i >= fast->cnt)
+		return -1;
+
+	end = fast->data + fast->pos[fast->i];
+	while (fast->ptr < end) {
+		if (!IS_SPACE(*fast->ptr))
+			return -1;
+		fast->ptr++;
+	}
+
+	return (unsigned char) *end;
+}
+
+#define	FAST_SKIP(fast) do { \
+	(fast)->ptr++; \
+	(fast)->i++; \
+} while (0)
+
+/* ǰλΪʼţȡڵַ */
+
+static int fast_string(JSON_FAST *fast, ACL_VSTRING *buf, int skip_space)
+{
+	const char *end;
+
+	if (fast->i + 1 >= fast->cnt
+		|| fast->data + fast->pos[fast->i] != fast->ptr)
+	{
+		return -1;
+	}
+
+	end = fast->data + fast->pos[fast->i + 1];
+	if (*end != '"')
+		return -1;
+
+	json_unescape(buf, fast->ptr + 1, end, skip_space);
+	fast->i += 2;
+	fast->ptr = end + 1;
+	return 0;
+}
+
+/* ȡҶֵַ֡truefalsenull Ȳŵֵ */
+
+static int fast_leaf(JSON_FAST *fast, ACL_JSON_NODE *node)
+{
+	const char *end;
+
+	SKIP_SPACE(fast->ptr);
+	if (*fast->ptr == '"')
+		return fast_string(fast, node->text, 1);
+
+	for (end = fast->ptr; *end; end++) {
+		if (IS_SPACE(*end) || *end == ',' || *end == ';'
+			|| *end == '}' || *end == ']')
+		{
+			break;
+		}
+		if (*end == '{' || *end == '[' || *end == ':'
+			|| *end == '"' || *end == '\'' || *end == '\\')
+		{
+			return -1;
+		}
+	}
+
+	if (end == fast->ptr)
+		return -1;
+
+	acl_vstring_memcpy(node->text, fast->ptr, end - fast->ptr);
+	ACL_VSTRING_TERMINATE(node->text);
+	fast->ptr = end;
+	return 0;
+}
+
+static ACL_JSON_NODE *fast_node(ACL_JSON *json, ACL_JSON_NODE *parent, int type)
+{
+	ACL_JSON_NODE *node = acl_json_node_alloc(json);
+
+	node->type = type;
+	node->depth = parent->depth + 1;
+	if (node->depth > json->depth)
+		json->depth = node->depth;
+	acl_json_node_add_child(parent, node);
+	return node;
+}
+
+/* 㣬ǩǿʱΪıǩֵ */
+
+static ACL_JSON_NODE *fast_open(ACL_JSON *json, ACL_JSON_NODE *parent, int ch)
+{
+	ACL_JSON_NODE *node;
+
+	if (ch == '{') {
+		node = fast_node(json, parent, ACL_JSON_T_OBJ);
+		node->left_ch = '{';
+		node->right_ch = '}';
+	} else {
+		node = fast_node(json, parent, ACL_JSON_T_ARRAY);
+		node->left_ch = '[';
+		node->right_ch = ']';
+	}
+
+	if (LEN(parent->ltag) > 0)
+		parent->tag_node = node;
+	return node;
+}
+
+/* 󷵻صڵĶ飬Ϊǩֵʱǩ */
+
+static ACL_JSON_NODE *fast_close(ACL_JSON_NODE *node)
+{
+	ACL_JSON_NODE *parent = node->parent;
+
+	if (!(parent->type & (ACL_JSON_T_OBJ | ACL_JSON_T_ARRAY)))
+		parent = parent->parent;
+	return parent;
+}
+
+/* ڶ׶Σ json 㣬ֵ֧ĸʽʱ -1 */
+
+static int json_build(JSON_FAST *fast)
+{
+	ACL_JSON *json = fast->json;
+	ACL_JSON_NODE *curr = json->root, *node;
+	int   status = FAST_S_OBJ, ch;
+
+	if (fast_peek(fast) != '{')
+		return -1;
+	FAST_SKIP(fast);
+	json->root->type = ACL_JSON_T_OBJ;
+
+	for (;;) {
+		switch (status) {
+		case FAST_S_OBJ:
+		case FAST_S_MEMBER:
+			ch = fast_peek(fast);
+			if (ch == '}' && status == FAST_S_OBJ) {
+				/*  json_pair һ£նһյĳԱ */
+				(void) fast_node(json, curr, ACL_JSON_T_MEMBER);
+				status = FAST_S_NEXT;
+				break;
+			}
+			if (ch != '"')
+				return -1;
+
+			node = fast_node(json, curr, ACL_JSON_T_LEAF);
+			if (fast_string(fast, node->ltag, 0) == -1)
+				return -1;
+			acl_json_index_add(json, node);
+			if (fast_peek(fast) != ':')
+				return -1;
+			FAST_SKIP(fast);
+
+			SKIP_SPACE(fast->ptr);
+			ch = *fast->ptr;
+			if (ch == '{' || ch == '[') {
+				if (fast_peek(fast) != ch)
+					return -1;
+				FAST_SKIP(fast);
+				curr = fast_open(json, node, ch);
+				status = ch == '{' ? FAST_S_OBJ : FAST_S_ARRAY;
+			} else if (fast_leaf(fast, node) == -1)
+				return -1;
+			else
+				status = FAST_S_NEXT;
+			break;
+		case FAST_S_ARRAY:
+		case FAST_S_ELEMENT:
+			SKIP_SPACE(fast->ptr);
+			ch = *fast->ptr;
+			if (ch == ']' && status == FAST_S_ARRAY) {
+				/*  json_element һ£һյԪ */
+				(void) fast_node(json, curr, ACL_JSON_T_LEAF);
+				status = FAST_S_NEXT;
+			} else if (ch == '{' || ch == '[') {
+				if (fast_peek(fast) != ch)
+					return -1;
+				FAST_SKIP(fast);
+				curr = fast_open(json, curr, ch);
+				status = ch == '{' ? FAST_S_OBJ : FAST_S_ARRAY;
+			} else {
+				node = fast_node(json, curr, ACL_JSON_T_LEAF);
+				if (fast_leaf(fast, node) == -1)
+					return -1;
+				status = FAST_S_NEXT;
+			}
+			break;
+		case FAST_S_NEXT:
+			ch = fast_peek(fast);
+			if (ch == ',') {
+				FAST_SKIP(fast);
+				status = curr->left_ch == '[' ?
+					FAST_S_ELEMENT : FAST_S_MEMBER;
+			} else if (ch == curr->right_ch) {
+				FAST_SKIP(fast);
+				if (curr == json->root) {
+					json->curr_node = json->root;
+					json->status = ACL_JSON_S_NEXT;
+					json->finish = 1;
+					return 0;
+				}
+				curr = fast_close(curr);
+			} else
+				return -1;
+			break;
+		default:
+			return -1;
+		}
+	}
+}
+
+void acl_json_update_fast(ACL_JSON *json, const char *data)
+{
+	JSON_INDEX index;
+	JSON_FAST  fast;
+	size_t len;
+	int   type, ret;
+
+	if (json->finish)
+		return;
+
+	/* ֻδʼ json ߿ٽ̣ݰʱ
+	 * תĺǰһֽڣҲֻ״ֽ̬ڴ
+	 */
+	if (json->status != ACL_JSON_S_ROOT
+		|| (json->flag & ACL_JSON_FLAG_PART_WORD)
+		|| acl_ring_size(&json->root->children) > 0)
+	{
+		acl_json_update(json, data);
+		return;
+	}
+
+	len = strlen(data);
+	if (len == 0)
+		return;
+	if (len >= (size_t) 0xffffffff) {
+		acl_json_update(json, data);
+		return;
+	}
+
+	/* ݳȣһη㹻Ŀռ䣬δõڴҳ
+	 * ռڴ
+	 */
+	if (len + BLOCK_SIZE <= INDEX_INIT)
+		index.pos = index.buf;
+	else
+		index.pos = (unsigned*) acl_mymalloc(
+			(len + BLOCK_SIZE) * sizeof(unsigned));
+	index.cnt = 0;
+	json_index(&index, data, len);
+
+	/* ݲʱ״̬Ҳ״̬ */
+	if (json_complete(&index, data) == -1) {
+		if (index.pos != index.buf)
+			acl_myfree(index.pos);
+		acl_json_update(json, data);
+		return;
+	}
+
+	fast.json = json;
+	fast.data = data;
+	fast.ptr = data;
+	fast.pos = index.pos;
+	fast.cnt = index.cnt;
+	fast.i = 0;
+
+	type = json->root->type;
+	ret = json_build(&fast);
+
+	if (index.pos != index.buf)
+		acl_myfree(index.pos);
+
+	/* Ǳ׼ json ݣѴĽ״̬½ */
+	if (ret == -1) {
+		acl_json_reset(json);
+		json->root->type = type;
+		acl_json_update(json, data);
+	}
+}
@@ -247,6 +247,10 @@ static const char *json_tag(ACL_JSON *json, const char *data)
 	if (LEN(node->ltag) > 0)
 		ACL_VSTRING_TERMINATE(node->ltag);
 
+	/* ǩϣĵ˳򽫽ǩ */
+	if (json->status != ACL_JSON_S_TAG)
+		acl_json_index_add(json, node);
+
 	return data;
 }
 
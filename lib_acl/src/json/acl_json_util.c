@@ -21,8 +21,13 @@ void acl_json_free_array(ACL_ARRAY *a)
 ACL_ARRAY *acl_json_getElementsByTagName(ACL_JSON *json, const char *tag)
 {
 	ACL_ITER iter;
-	ACL_ARRAY *a = acl_array_create(10);
+	ACL_ARRAY *a;
 
+	/* 򿪱ǩʱֱӷڵĽ飬ر */
+	if ((json->flag & ACL_JSON_FLAG_TAG_INDEX))
+		return (acl_json_index_lookup(json, tag));
+
+	a = acl_array_create(10);
 	acl_foreach(iter, json) {
 		ACL_JSON_NODE *node = (ACL_JSON_NODE*) iter.data;
 		if (strcasecmp(tag, STR(node->ltag)) == 0) {
@@ -44,7 +49,7 @@ ACL_ARRAY *acl_json_getElementsByTags(ACL_JSON *json, const char *tags)
 	ACL_ARRAY *a, *result;
 	ACL_ITER iter;
 	ACL_JSON_NODE *node_saved, *node;
-	int   i;
+	int   i, indexed = json->flag & ACL_JSON_FLAG_TAG_INDEX;
 
 	a = acl_json_getElementsByTagName(json, tokens->argv[tokens->argc - 1]);
 	if (a == NULL) {
@@ -76,7 +81,8 @@ ACL_ARRAY *acl_json_getElementsByTags(ACL_JSON *json, const char *tags)
 			result->push_back(result, node_saved);
 	}
 
-	acl_json_free_array(a);
+	if (!indexed)
+		acl_json_free_array(a);
 	acl_argv_free(tokens);
 
 	if (acl_array_size(result) == 0) {
@@ -280,6 +286,7 @@ void acl_json_building(ACL_JSON *json, size_t length,
 			switch (node->type) {
 			case ACL_JSON_T_BOOL:
 			case ACL_JSON_T_NUMBER:
+			case ACL_JSON_T_NULL:
 				acl_vstring_strcat(buf, STR(node->text));
 				break;
 			default:
@@ -295,6 +302,7 @@ void acl_json_building(ACL_JSON *json, size_t length,
 			switch (node->type) {
 			case ACL_JSON_T_A_BOOL:
 			case ACL_JSON_T_A_NUMBER:
+			case ACL_JSON_T_NULL:
 				acl_vstring_strcat(buf, STR(node->text));
 				break;
 			default:
@@ -399,6 +407,7 @@ ACL_VSTRING *acl_json_build(ACL_JSON *json, ACL_VSTRING *buf)
 			switch (node->type) {
 			case ACL_JSON_T_BOOL:
 			case ACL_JSON_T_NUMBER:
+			case ACL_JSON_T_NULL:
 				acl_vstring_strcat(buf, STR(node->text));
 				break;
 			default:
@@ -414,6 +423,7 @@ ACL_VSTRING *acl_json_build(ACL_JSON *json, ACL_VSTRING *buf)
 			switch (node->type) {
 			case ACL_JSON_T_A_BOOL:
 			case ACL_JSON_T_A_NUMBER:
+			case ACL_JSON_T_NULL:
 				acl_vstring_strcat(buf, STR(node->text));
 				break;
 			default:
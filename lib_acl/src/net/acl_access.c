@@ -16,25 +16,21 @@
 #endif
 
 /* local variables */
-static ACL_IPLINK *__host_allow_link = NULL;
+static ACL_IPTRIE *__host_allow_trie = NULL;
+static ACL_ARGV *__host_allow_items = NULL;
 static void (*__log_fn) (const char *fmt, ...) = acl_msg_info;
 static int __host_allow_all = 0;
 
+/* the value stored in the trie, which must not be NULL */
+static char __host_allow_value[] = "allow";
+
 static void __access_init(void)
 {
-	const char *myname = "__access_init";
-
-	if (__host_allow_link)
+	if (__host_allow_trie)
 		return;
 
-	__host_allow_link = acl_iplink_create(10);
-	if (__host_allow_link == NULL) {
-		char tbuf[256];
-		__log_fn("FATAL, %s(%d)->%s: call acl_iplink_create error=%s",
-				__FILE__, __LINE__, myname,
-				acl_last_strerror(tbuf, sizeof(tbuf)));
-		exit (1);
-	}
+	__host_allow_trie = acl_iptrie_create();
+	__host_allow_items = acl_argv_alloc(10);
 }
 
 int acl_access_add(const char *data, const char *sep1, const char *sep2)
@@ -43,10 +39,14 @@ int acl_access_add(const char *data, const char *sep1, const char *sep2)
 	 * example:
 	 * 127.0.0.1:127.0.0.1, 10.0.250.1:10.0.250:10, 192.168.0.1:192.168.0.255
 	 * 127.0.0.1,127.0.0.1; 10.0.250.1,10.0.250:10; 192.168.0.1,192.168.0.255
+	 * the item can also be a cidr or a single ipv6 address:
+	 * 10.0.0.0/8, 2001:db8::/32, ::1
 	 */
 	const char *myname = "acl_access_add";
 	ACL_ARGV *items;
-	char *psrc, *ptr, *from, *to, buf[256];
+	char *psrc, *ptr, *from, *to, buf[256], range[256];
+	unsigned char addr_from[16], addr_to[16];
+	unsigned int ip_from, ip_to;
 	int   i;
 
 	if (data == NULL || *data == 0) {
@@ -68,7 +68,7 @@ int acl_access_add(const char *data, const char *sep1, const char *sep2)
 		return (0);
 	}
 
-	if (__host_allow_link == NULL)
+	if (__host_allow_trie == NULL)
 		__access_init();
 
 	items = acl_argv_split(data, sep1);
@@ -97,6 +97,25 @@ int acl_access_add(const char *data, const char *sep1, const char *sep2)
 		psrc = acl_argv_index(items, i);
 		ACL_SAFE_STRNCPY(buf, psrc, sizeof(buf) - 1);
 		ptr = buf;
+		STRIP_SPACE(ptr);
+		if (*ptr == 0)
+			continue;
+
+		/* cidr or ipv6 address, which may contain sep2 as ':' */
+		if (strchr(ptr, '/') != NULL
+			|| acl_iptrie_parse(ptr, addr_from) == 6)
+		{
+			if (acl_msg_verbose)
+				__log_fn("add access: %s", ptr);
+			if (acl_iptrie_add(__host_allow_trie, ptr,
+				__host_allow_value) < 0)
+			{
+				__log_fn("%s, %s(%d): invalid cidr(%s)",
+					__FILE__, myname, __LINE__, psrc);
+			} else
+				acl_argv_add(__host_allow_items, ptr, NULL);
+			continue;
+		}
 
 		from = acl_mystrtok(&ptr, sep2);
 		if (from == NULL || *from == 0) {
@@ -122,13 +141,37 @@ int acl_access_add(const char *data, const char *sep1, const char *sep2)
 
 		if (acl_msg_verbose)
 			__log_fn("add access: from(%s), to(%s)", from, to);
-		if (acl_iplink_insert(__host_allow_link, from, to) == NULL)
-			__log_fn("%s, %s(%d): acl_iplink_insert error(%s)",
+		if (acl_iptrie_parse(from, addr_from) != 4
+			|| acl_iptrie_parse(to, addr_to) != 4)
+		{
+			__log_fn("%s, %s(%d): invalid ip(%s)",
 				__FILE__, myname, __LINE__, psrc);
+			continue;
+		}
+
+		ip_from = ((unsigned int) addr_from[0] << 24)
+			| ((unsigned int) addr_from[1] << 16)
+			| ((unsigned int) addr_from[2] << 8) | addr_from[3];
+		ip_to = ((unsigned int) addr_to[0] << 24)
+			| ((unsigned int) addr_to[1] << 16)
+			| ((unsigned int) addr_to[2] << 8) | addr_to[3];
+		if (ip_from > ip_to) {
+			unsigned int tmp = ip_from;
+			ip_from = ip_to;
+			ip_to = tmp;
+		}
+
+		acl_iptrie_add_range4(__host_allow_trie, ip_from, ip_to,
+			__host_allow_value);
+		snprintf(range, sizeof(range), "%s-%s", from, to);
+		acl_argv_add(__host_allow_items, range, NULL);
 	}
 
 	acl_argv_free(items);
 
+	/* build the lookup table once for all the items added */
+	acl_iptrie_compile(__host_allow_trie);
+
 	return (0);
 }
 
@@ -165,18 +208,13 @@ void acl_access_setup_logfn(void (*log_fn)(const char *fmt, ...))
 
 int acl_access_permit(const char *addr)
 {
-	char  ip[32], *ptr;
-
 	if (__host_allow_all)
 		return (1);
-	if (__host_allow_link == NULL)
+	if (__host_allow_trie == NULL)
 		return (1);
 
-	ACL_SAFE_STRNCPY(ip, addr, sizeof(ip));
-	ptr = strchr(ip, ':');
-	if (ptr)
-		*ptr = 0;
-	if (acl_iplink_lookup_str(__host_allow_link, ip) != NULL)
+	/* the addr may be ip:port, [ipv6]:port or ipv6 */
+	if (acl_iptrie_lookup(__host_allow_trie, addr) != NULL)
 		return (1);
 
 	return (0);
@@ -184,8 +222,12 @@ int acl_access_permit(const char *addr)
 
 static void __access_cfg_out(void)
 {
+	int   i;
 
-	acl_iplink_list(__host_allow_link);
+	if (__host_allow_items == NULL)
+		return;
+	for (i = 0; i < __host_allow_items->argc; i++)
+		printf("allow: %s\n", __host_allow_items->argv[i]);
 }
 
 void acl_access_debug(void)
@@ -0,0 +1,91 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_mystring.h"
+
+#endif
+
+#include "tag_index.h"
+
+static void tag_array_free(void *arg)
+{
+	acl_array_free((ACL_ARRAY*) arg, NULL);
+}
+
+ACL_HTABLE *tag_index_create(void)
+{
+	return (acl_htable_create(64, 0));
+}
+
+void tag_index_free(ACL_HTABLE *table)
+{
+	acl_htable_free(table, tag_array_free);
+}
+
+void tag_index_reset(ACL_HTABLE *table)
+{
+	acl_htable_reset(table, tag_array_free);
+}
+
+/* ǩִСдддĸʱתСдΪ϶̵
+ * ǩջתֻйıǩҪڴ
+ */
+
+#define	KEY_SIZE	256
+
+static const char *tag_key(const char *tag, char *buf, char **dbuf)
+{
+	const char *ptr;
+	size_t len;
+
+	for (ptr = tag; *ptr; ptr++) {
+		if (*ptr >= 'A' && *ptr <= 'Z')
+			break;
+	}
+	if (*ptr == 0)
+		return (tag);
+
+	len = strlen(tag);
+	if (len < KEY_SIZE) {
+		memcpy(buf, tag, len + 1);
+		return (acl_lowercase(buf));
+	}
+
+	*dbuf = acl_mystrdup(tag);
+	return (acl_lowercase(*dbuf));
+}
+
+void tag_index_add(ACL_HTABLE *table, const char *tag, void *node)
+{
+	char  buf[KEY_SIZE], *dbuf = NULL;
+	const char *key;
+	ACL_ARRAY *a;
+
+	if (*tag == 0)
+		return;
+
+	key = tag_key(tag, buf, &dbuf);
+	a = (ACL_ARRAY*) acl_htable_find(table, key);
+	if (a == NULL) {
+		a = acl_array_create(4);
+		acl_htable_enter(table, key, a);
+	}
+	acl_array_append(a, node);
+
+	if (dbuf != NULL)
+		acl_myfree(dbuf);
+}
+
+ACL_ARRAY *tag_index_find(ACL_HTABLE *table, const char *tag)
+{
+	char  buf[KEY_SIZE], *dbuf = NULL;
+	ACL_ARRAY *a;
+
+	a = (ACL_ARRAY*) acl_htable_find(table, tag_key(tag, buf, &dbuf));
+	if (dbuf != NULL)
+		acl_myfree(dbuf);
+	return (a);
+}
@@ -0,0 +1,57 @@
+#ifndef	__TAG_INDEX_INCLUDE_H_
+#define	__TAG_INDEX_INCLUDE_H_
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include "stdlib/acl_define.h"
+#include "stdlib/acl_array.h"
+#include "stdlib/acl_htable.h"
+
+/*
+ * xml  json õıǩ: ǩ(Сд) -> 飬ͬǩĽ
+ * еͬһǩֻһݣ㰴Ⱥ
+ * ˳ţĵ˳룬˳һ
+ */
+
+/**
+ * ǩ
+ * @return {ACL_HTABLE*}
+ */
+ACL_HTABLE *tag_index_create(void);
+
+/**
+ * ͷűǩڵĽ飬ͷŽ
+ * @param table {ACL_HTABLE*}  tag_index_create 
+ */
+void tag_index_free(ACL_HTABLE *table);
+
+/**
+ * ձǩԱؽ
+ * @param table {ACL_HTABLE*}  tag_index_create 
+ */
+void tag_index_reset(ACL_HTABLE *table);
+
+/**
+ * ǩӦĽβǩΪյĽ㲻
+ * @param table {ACL_HTABLE*}  tag_index_create 
+ * @param tag {const char*} ıǩ
+ * @param node {void*} xml  json 
+ */
+void tag_index_add(ACL_HTABLE *table, const char *tag, void *node);
+
+/**
+ * ѯǩͬ(ִСд)Ľ
+ * @param table {ACL_HTABLE*}  tag_index_create 
+ * @param tag {const char*} ǩ
+ * @return {ACL_ARRAY*} ڲĽ飬߲޸Ļͷţ
+ *   NULL ʾûиñǩĽ
+ */
+ACL_ARRAY *tag_index_find(ACL_HTABLE *table, const char *tag);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif
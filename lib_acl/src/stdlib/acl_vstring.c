@@ -56,10 +56,14 @@ static void vstring_extend(ACL_VBUF *bp, int incr)
 	else
 		new_len += MAX_PREALLOC;
 
-	if (vp->slice)
-		bp->data = (unsigned char *) acl_slice_pool_realloc(
-			__FILE__, __LINE__, vp->slice, bp->data, new_len);
-	else
+	if (vp->slice) {
+		/* acl_slice_pool_realloc ³ȸƣԽԭ */
+		unsigned char *data = (unsigned char *) acl_slice_pool_alloc(
+			__FILE__, __LINE__, vp->slice, new_len);
+		memcpy(data, bp->data, bp->len);
+		acl_slice_pool_free(__FILE__, __LINE__, bp->data);
+		bp->data = data;
+	} else
 		bp->data = (unsigned char *) acl_myrealloc(bp->data, new_len);
 	bp->len = new_len;
 	bp->ptr = bp->data + used;
@@ -0,0 +1,635 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_vstring.h"
+#include "stdlib/acl_vstream.h"
+#include "stdlib/acl_bits_map.h"
+#include "stdlib/acl_bloom.h"
+
+#endif
+
+#define BLOCK_BYTES	64		/* one cache line */
+#define BLOCK_BITS	(BLOCK_BYTES * ACL_BITS_MASK_NBBY)
+#define BLOCK_SHIFT	(32 - 9)	/* the high 9 bits select one of 512 */
+#define MAX_PROBES	16
+
+#define SLOTS		4		/* fingerprints per bucket */
+#define MAX_KICKS	500
+
+#define HDR_SIZE	32
+
+#ifdef MS_VC6
+# define FNV_OFFSET	0xcbf29ce484222325
+# define FNV_PRIME	0x100000001b3
+# define MIX_MUL1	0xbf58476d1ce4e5b9
+# define MIX_MUL2	0x94d049bb133111eb
+#else
+# define FNV_OFFSET	0xcbf29ce484222325ll
+# define FNV_PRIME	0x100000001b3ll
+# define MIX_MUL1	0xbf58476d1ce4e5b9ll
+# define MIX_MUL2	0x94d049bb133111ebll
+#endif
+
+#define LN2		0.69314718055994530942
+#define LN10		2.30258509299404568402
+
+struct ACL_BLOOM {
+	ACL_BITS_MASK mask;	/* mask.data is aligned to BLOCK_BYTES */
+	char *buf;		/* the memory really allocated */
+	unsigned int nblocks;
+	unsigned int k;
+	acl_uint64 count;
+};
+
+struct ACL_CUCKOO {
+	unsigned short *table;	/* nbuckets * SLOTS fingerprints, 0 is empty */
+	unsigned int nbuckets;	/* power of 2 */
+	acl_uint64 count;
+	int   victim_used;	/* the last kicked out one which has no room */
+	unsigned int victim_index;
+	unsigned short victim_fp;
+	unsigned int seed;
+};
+
+/* FNV-1a followed by the finalizer of splitmix64 */
+static acl_uint64 hash64(const void *key, size_t len)
+{
+	const unsigned char *ptr = (const unsigned char*) key;
+	acl_uint64 h = (acl_uint64) FNV_OFFSET;
+
+	while (len-- > 0) {
+		h ^= *ptr++;
+		h *= (acl_uint64) FNV_PRIME;
+	}
+
+	h ^= h >> 30;
+	h *= (acl_uint64) MIX_MUL1;
+	h ^= h >> 27;
+	h *= (acl_uint64) MIX_MUL2;
+	h ^= h >> 31;
+	return h;
+}
+
+static void put_u32(unsigned char *ptr, unsigned int n)
+{
+	ptr[0] = (unsigned char) (n & 0xff);
+	ptr[1] = (unsigned char) ((n >> 8) & 0xff);
+	ptr[2] = (unsigned char) ((n >> 16) & 0xff);
+	ptr[3] = (unsigned char) ((n >> 24) & 0xff);
+}
+
+static unsigned int get_u32(const unsigned char *ptr)
+{
+	return (unsigned int) ptr[0] | ((unsigned int) ptr[1] << 8)
+		| ((unsigned int) ptr[2] << 16) | ((unsigned int) ptr[3] << 24);
+}
+
+static void put_u64(unsigned char *ptr, acl_uint64 n)
+{
+	put_u32(ptr, (unsigned int) (n & 0xffffffff));
+	put_u32(ptr + 4, (unsigned int) (n >> 32));
+}
+
+static acl_uint64 get_u64(const unsigned char *ptr)
+{
+	return (acl_uint64) get_u32(ptr) | ((acl_uint64) get_u32(ptr + 4) << 32);
+}
+
+static int file_save(ACL_VSTRING *buf, const char *path)
+{
+	const char *myname = "file_save";
+	ACL_VSTRING *tmp = acl_vstring_alloc(256);
+	ACL_VSTREAM *fp;
+	int   ret;
+
+	acl_vstring_sprintf(tmp, "%s.tmp", path);
+	fp = acl_vstream_fopen(acl_vstring_str(tmp),
+		O_WRONLY | O_CREAT | O_TRUNC, 0600, 4096);
+	if (fp == NULL) {
+		acl_msg_error("%s(%d): open %s error %s", myname, __LINE__,
+			acl_vstring_str(tmp), acl_last_serror());
+		acl_vstring_free(tmp);
+		return -1;
+	}
+
+	ret = acl_vstream_writen(fp, acl_vstring_str(buf), ACL_VSTRING_LEN(buf));
+	acl_vstream_close(fp);
+	if (ret == ACL_VSTREAM_EOF) {
+		acl_msg_error("%s(%d): write %s error %s", myname, __LINE__,
+			acl_vstring_str(tmp), acl_last_serror());
+		remove(acl_vstring_str(tmp));
+		acl_vstring_free(tmp);
+		return -1;
+	}
+
+	if (rename(acl_vstring_str(tmp), path) < 0) {
+		acl_msg_error("%s(%d): rename %s to %s error %s", myname,
+			__LINE__, acl_vstring_str(tmp), path, acl_last_serror());
+		remove(acl_vstring_str(tmp));
+		acl_vstring_free(tmp);
+		return -1;
+	}
+
+	acl_vstring_free(tmp);
+	return 0;
+}
+
+/*----------------------------- ACL_BLOOM ----------------------------------*/
+
+/* ln(x) for 0 < x < 1, so we needn't link with libm */
+static double ln(double x)
+{
+	double y, y2, sum = 0, term;
+	int   e = 0, i;
+
+	while (x < 0.5) {
+		x *= 2;
+		e++;
+	}
+
+	/* ln(x) = 2 * atanh((x - 1) / (x + 1)), x is in [0.5, 1) now */
+	y = (x - 1) / (x + 1);
+	y2 = y * y;
+	term = y;
+	for (i = 1; i < 40; i += 2) {
+		sum += term / i;
+		term *= y2;
+	}
+	return 2 * sum - e * LN2;
+}
+
+static ACL_BLOOM *bloom_alloc(unsigned int nblocks, unsigned int k)
+{
+	ACL_BLOOM *bloom = (ACL_BLOOM*) acl_mycalloc(1, sizeof(ACL_BLOOM));
+	size_t size = (size_t) nblocks * BLOCK_BYTES;
+
+	bloom->buf = (char*) acl_mymalloc(size + BLOCK_BYTES);
+	bloom->mask.data = (char*) (((size_t) bloom->buf + BLOCK_BYTES - 1)
+			& ~((size_t) BLOCK_BYTES - 1));
+	bloom->mask.data_len = size;
+	ACL_BITS_MASK_ZERO(&bloom->mask);
+	bloom->nblocks = nblocks;
+	bloom->k = k;
+	return bloom;
+}
+
+ACL_BLOOM *acl_bloom_create(size_t capacity, double fp_rate)
+{
+	const char *myname = "acl_bloom_create";
+	double bits, factor;
+	unsigned int k;
+
+	if (capacity == 0)
+		capacity = 1;
+	if (fp_rate <= 0 || fp_rate >= 1)
+		fp_rate = 0.01;
+
+	/* m = -n * ln(p) / (ln2)^2, k = m / n * ln2; all probes of a key
+	 * share one block, so the blocks are not loaded evenly and more bits
+	 * are needed to reach the same false positive rate, the lower the
+	 * rate the more: 10 percent more for 1%, 45 percent for 0.1%, and 80
+	 * percent for 0.01% (measured by samples/bloom)
+	 */
+	bits = -((double) capacity) * ln(fp_rate) / (LN2 * LN2);
+	k = (unsigned int) (bits / (double) capacity * LN2 + 0.5);
+	factor = 0.4 - 0.35 * ln(fp_rate) / LN10;
+	if (factor > 1)
+		bits *= factor;
+
+	if (k < 1)
+		k = 1;
+	else if (k > MAX_PROBES)
+		k = MAX_PROBES;
+	if (bits / BLOCK_BITS >= (double) 0xffffffff)
+		acl_msg_fatal("%s(%d): capacity(%lu) too large", myname,
+			__LINE__, (unsigned long) capacity);
+
+	return bloom_alloc((unsigned int) (bits / BLOCK_BITS) + 1, k);
+}
+
+void acl_bloom_free(ACL_BLOOM *bloom)
+{
+	acl_myfree(bloom->buf);
+	acl_myfree(bloom);
+}
+
+/* the block of the key, and the first and the step of the probes whose
+ * high bits are used as the bit offsets in the block
+ */
+#define BLOOM_PROBE(bloom, key, len, base, h1, h2) do { \
+	acl_uint64 _h = hash64((key), (len)); \
+	(base) = (size_t) ((((_h >> 32) * (bloom)->nblocks) >> 32)) * BLOCK_BITS; \
+	(h1) = (unsigned int) _h; \
+	(h2) = (((h1) >> 17) | ((h1) << 15)) * 0x9e3779b1 | 1; \
+} while (0)
+
+void acl_bloom_add(ACL_BLOOM *bloom, const void *key, size_t len)
+{
+	size_t base;
+	unsigned int h1, h2, i;
+
+	BLOOM_PROBE(bloom, key, len, base, h1, h2);
+	for (i = 0; i < bloom->k; i++) {
+		ACL_BITS_MASK_SET(base + (h1 >> BLOCK_SHIFT), &bloom->mask);
+		h1 += h2;
+	}
+	bloom->count++;
+}
+
+int acl_bloom_test(const ACL_BLOOM *bloom, const void *key, size_t len)
+{
+	size_t base;
+	unsigned int h1, h2, i;
+
+	BLOOM_PROBE(bloom, key, len, base, h1, h2);
+	for (i = 0; i < bloom->k; i++) {
+		if (!ACL_BITS_MASK_ISSET(base + (h1 >> BLOCK_SHIFT),
+			&bloom->mask))
+		{
+			return 0;
+		}
+		h1 += h2;
+	}
+	return 1;
+}
+
+void acl_bloom_reset(ACL_BLOOM *bloom)
+{
+	ACL_BITS_MASK_ZERO(&bloom->mask);
+	bloom->count = 0;
+}
+
+acl_uint64 acl_bloom_count(const ACL_BLOOM *bloom)
+{
+	return bloom->count;
+}
+
+#define BLOOM_MAGIC	"ACLBLOOM"
+#define CUCKOO_MAGIC	"ACLCUCKO"
+#define FILTER_VERSION	1
+
+/* magic[8], version, k, nblocks, 0, count[8], bits */
+void acl_bloom_dump(const ACL_BLOOM *bloom, ACL_VSTRING *buf)
+{
+	unsigned char hdr[HDR_SIZE];
+
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(hdr, BLOOM_MAGIC, 8);
+	put_u32(hdr + 8, FILTER_VERSION);
+	put_u32(hdr + 12, bloom->k);
+	put_u32(hdr + 16, bloom->nblocks);
+	put_u64(hdr + 24, bloom->count);
+	acl_vstring_memcat(buf, (const char*) hdr, sizeof(hdr));
+	acl_vstring_memcat(buf, bloom->mask.data, bloom->mask.data_len);
+	ACL_VSTRING_TERMINATE(buf);
+}
+
+ACL_BLOOM *acl_bloom_load(const void *data, size_t len)
+{
+	const char *myname = "acl_bloom_load";
+	const unsigned char *ptr = (const unsigned char*) data;
+	unsigned int k, nblocks;
+	ACL_BLOOM *bloom;
+
+	if (len < HDR_SIZE || memcmp(ptr, BLOOM_MAGIC, 8) != 0
+		|| get_u32(ptr + 8) != FILTER_VERSION)
+	{
+		acl_msg_error("%s(%d): invalid header", myname, __LINE__);
+		return NULL;
+	}
+
+	k = get_u32(ptr + 12);
+	nblocks = get_u32(ptr + 16);
+	if (k < 1 || k > MAX_PROBES || nblocks == 0
+		|| (len - HDR_SIZE) / BLOCK_BYTES != nblocks
+		|| (len - HDR_SIZE) % BLOCK_BYTES != 0)
+	{
+		acl_msg_error("%s(%d): invalid k(%u) or nblocks(%u), len(%lu)",
+			myname, __LINE__, k, nblocks, (unsigned long) len);
+		return NULL;
+	}
+
+	bloom = bloom_alloc(nblocks, k);
+	bloom->count = get_u64(ptr + 24);
+	memcpy(bloom->mask.data, ptr + HDR_SIZE, bloom->mask.data_len);
+	return bloom;
+}
+
+int acl_bloom_save(const ACL_BLOOM *bloom, const char *path)
+{
+	ACL_VSTRING *buf = acl_vstring_alloc(HDR_SIZE + bloom->mask.data_len);
+	int   ret;
+
+	acl_bloom_dump(bloom, buf);
+	ret = file_save(buf, path);
+	acl_vstring_free(buf);
+	return ret;
+}
+
+ACL_BLOOM *acl_bloom_open(const char *path)
+{
+	ssize_t size;
+	char *data = acl_vstream_loadfile2(path, &size);
+	ACL_BLOOM *bloom;
+
+	if (data == NULL)
+		return NULL;
+	bloom = size > 0 ? acl_bloom_load(data, (size_t) size) : NULL;
+	acl_myfree(data);
+	return bloom;
+}
+
+/*----------------------------- ACL_CUCKOO ---------------------------------*/
+
+#define BUCKET(c, i)	((c)->table + (size_t) (i) * SLOTS)
+#define ALT_INDEX(c, i, fp) \
+	(((i) ^ ((unsigned int) (fp) * 0x5bd1e995)) & ((c)->nbuckets - 1))
+
+static ACL_CUCKOO *cuckoo_alloc(unsigned int nbuckets)
+{
+	ACL_CUCKOO *cuckoo = (ACL_CUCKOO*) acl_mycalloc(1, sizeof(ACL_CUCKOO));
+
+	cuckoo->table = (unsigned short*) acl_mycalloc((size_t) nbuckets
+			* SLOTS, sizeof(unsigned short));
+	cuckoo->nbuckets = nbuckets;
+	cuckoo->seed = 2463534242U;
+	return cuckoo;
+}
+
+ACL_CUCKOO *acl_cuckoo_create(size_t capacity)
+{
+	const char *myname = "acl_cuckoo_create";
+	unsigned int nbuckets = 1;
+
+	/* keep the load factor under 95 percent */
+	while ((double) nbuckets * SLOTS * 0.95 < (double) capacity) {
+		if (nbuckets >= 0x80000000U)
+			acl_msg_fatal("%s(%d): capacity(%lu) too large",
+				myname, __LINE__, (unsigned long) capacity);
+		nbuckets <<= 1;
+	}
+	return cuckoo_alloc(nbuckets);
+}
+
+void acl_cuckoo_free(ACL_CUCKOO *cuckoo)
+{
+	acl_myfree(cuckoo->table);
+	acl_myfree(cuckoo);
+}
+
+static unsigned short cuckoo_hash(const ACL_CUCKOO *cuckoo, const void *key,
+	size_t len, unsigned int *index)
+{
+	acl_uint64 h = hash64(key, len);
+	unsigned short fp = (unsigned short) (h >> 48);
+
+	*index = (unsigned int) h & (cuckoo->nbuckets - 1);
+	return fp == 0 ? 1 : fp;
+}
+
+static int bucket_insert(ACL_CUCKOO *cuckoo, unsigned int i, unsigned short fp)
+{
+	unsigned short *bucket = BUCKET(cuckoo, i);
+	int   j;
+
+	for (j = 0; j < SLOTS; j++) {
+		if (bucket[j] == 0) {
+			bucket[j] = fp;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int bucket_find(const ACL_CUCKOO *cuckoo, unsigned int i,
+	unsigned short fp)
+{
+	const unsigned short *bucket = BUCKET(cuckoo, i);
+
+	return bucket[0] == fp || bucket[1] == fp
+		|| bucket[2] == fp || bucket[3] == fp;
+}
+
+static int bucket_remove(ACL_CUCKOO *cuckoo, unsigned int i, unsigned short fp)
+{
+	unsigned short *bucket = BUCKET(cuckoo, i);
+	int   j;
+
+	for (j = 0; j < SLOTS; j++) {
+		if (bucket[j] == fp) {
+			bucket[j] = 0;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static unsigned int cuckoo_rand(ACL_CUCKOO *cuckoo)
+{
+	cuckoo->seed ^= cuckoo->seed << 13;
+	cuckoo->seed ^= cuckoo->seed >> 17;
+	cuckoo->seed ^= cuckoo->seed << 5;
+	return cuckoo->seed;
+}
+
+int acl_cuckoo_add(ACL_CUCKOO *cuckoo, const void *key, size_t len)
+{
+	unsigned int i1, i2, i;
+	unsigned short fp, tmp;
+	unsigned short *bucket;
+	int   n, j;
+
+	/* no room any more since the last kicked out one is pending */
+	if (cuckoo->victim_used)
+		return -1;
+
+	fp = cuckoo_hash(cuckoo, key, len, &i1);
+	i2 = ALT_INDEX(cuckoo, i1, fp);
+	if (bucket_insert(cuckoo, i1, fp) || bucket_insert(cuckoo, i2, fp)) {
+		cuckoo->count++;
+		return 0;
+	}
+
+	/* kick out a random one and move it to its alternate bucket */
+	i = (cuckoo_rand(cuckoo) & 1) ? i1 : i2;
+	for (n = 0; n < MAX_KICKS; n++) {
+		bucket = BUCKET(cuckoo, i);
+		j = (int) (cuckoo_rand(cuckoo) % SLOTS);
+		tmp = bucket[j];
+		bucket[j] = fp;
+		fp = tmp;
+		i = ALT_INDEX(cuckoo, i, fp);
+		if (bucket_insert(cuckoo, i, fp)) {
+			cuckoo->count++;
+			return 0;
+		}
+	}
+
+	/* the new key has been put in, keep the homeless one aside */
+	cuckoo->victim_used = 1;
+	cuckoo->victim_index = i;
+	cuckoo->victim_fp = fp;
+	cuckoo->count++;
+	return 0;
+}
+
+int acl_cuckoo_test(const ACL_CUCKOO *cuckoo, const void *key, size_t len)
+{
+	unsigned int i1, i2;
+	unsigned short fp;
+
+	fp = cuckoo_hash(cuckoo, key, len, &i1);
+	i2 = ALT_INDEX(cuckoo, i1, fp);
+	if (bucket_find(cuckoo, i1, fp) || bucket_find(cuckoo, i2, fp))
+		return 1;
+	return cuckoo->victim_used && cuckoo->victim_fp == fp
+		&& (cuckoo->victim_index == i1 || cuckoo->victim_index == i2);
+}
+
+int acl_cuckoo_del(ACL_CUCKOO *cuckoo, const void *key, size_t len)
+{
+	unsigned int i1, i2, i;
+	unsigned short fp;
+
+	fp = cuckoo_hash(cuckoo, key, len, &i1);
+	i2 = ALT_INDEX(cuckoo, i1, fp);
+
+	if (bucket_remove(cuckoo, i1, fp) || bucket_remove(cuckoo, i2, fp)) {
+		cuckoo->count--;
+
+		/* try to give the pending one a place again */
+		if (cuckoo->victim_used) {
+			i = cuckoo->victim_index;
+			fp = cuckoo->victim_fp;
+			if (bucket_insert(cuckoo, i, fp) || bucket_insert(
+				cuckoo, ALT_INDEX(cuckoo, i, fp), fp))
+			{
+				cuckoo->victim_used = 0;
+			}
+		}
+		return 0;
+	}
+
+	if (cuckoo->victim_used && cuckoo->victim_fp == fp
+		&& (cuckoo->victim_index == i1 || cuckoo->victim_index == i2))
+	{
+		cuckoo->victim_used = 0;
+		cuckoo->count--;
+		return 0;
+	}
+	return -1;
+}
+
+void acl_cuckoo_reset(ACL_CUCKOO *cuckoo)
+{
+	memset(cuckoo->table, 0, (size_t) cuckoo->nbuckets * SLOTS
+		* sizeof(unsigned short));
+	cuckoo->victim_used = 0;
+	cuckoo->count = 0;
+}
+
+acl_uint64 acl_cuckoo_count(const ACL_CUCKOO *cuckoo)
+{
+	return cuckoo->count;
+}
+
+/* magic[8], version, nbuckets, victim_used << 16 | victim_fp,
+ * victim_index, count[8], fingerprints in little endian
+ */
+void acl_cuckoo_dump(const ACL_CUCKOO *cuckoo, ACL_VSTRING *buf)
+{
+	unsigned char hdr[HDR_SIZE], tmp[512];
+	size_t i, n = (size_t) cuckoo->nbuckets * SLOTS, pos = 0;
+
+	memcpy(hdr, CUCKOO_MAGIC, 8);
+	put_u32(hdr + 8, FILTER_VERSION);
+	put_u32(hdr + 12, cuckoo->nbuckets);
+	put_u32(hdr + 16, (cuckoo->victim_used ? 0x10000 : 0)
+		| cuckoo->victim_fp);
+	put_u32(hdr + 20, cuckoo->victim_index);
+	put_u64(hdr + 24, cuckoo->count);
+	acl_vstring_memcat(buf, (const char*) hdr, sizeof(hdr));
+
+	for (i = 0; i < n; i++) {
+		tmp[pos++] = (unsigned char) (cuckoo->table[i] & 0xff);
+		tmp[pos++] = (unsigned char) (cuckoo->table[i] >> 8);
+		if (pos == sizeof(tmp)) {
+			acl_vstring_memcat(buf, (const char*) tmp, pos);
+			pos = 0;
+		}
+	}
+	if (pos > 0)
+		acl_vstring_memcat(buf, (const char*) tmp, pos);
+	ACL_VSTRING_TERMINATE(buf);
+}
+
+ACL_CUCKOO *acl_cuckoo_load(const void *data, size_t len)
+{
+	const char *myname = "acl_cuckoo_load";
+	const unsigned char *ptr = (const unsigned char*) data;
+	unsigned int nbuckets, victim;
+	ACL_CUCKOO *cuckoo;
+	size_t i, n;
+
+	if (len < HDR_SIZE || memcmp(ptr, CUCKOO_MAGIC, 8) != 0
+		|| get_u32(ptr + 8) != FILTER_VERSION)
+	{
+		acl_msg_error("%s(%d): invalid header", myname, __LINE__);
+		return NULL;
+	}
+
+	nbuckets = get_u32(ptr + 12);
+	victim = get_u32(ptr + 16);
+	if (nbuckets == 0 || (nbuckets & (nbuckets - 1)) != 0
+		|| (len - HDR_SIZE) / (SLOTS * 2) != nbuckets
+		|| (len - HDR_SIZE) % (SLOTS * 2) != 0
+		|| get_u32(ptr + 20) >= nbuckets)
+	{
+		acl_msg_error("%s(%d): invalid nbuckets(%u), len(%lu)",
+			myname, __LINE__, nbuckets, (unsigned long) len);
+		return NULL;
+	}
+
+	cuckoo = cuckoo_alloc(nbuckets);
+	cuckoo->victim_used = (victim & 0x10000) ? 1 : 0;
+	cuckoo->victim_fp = (unsigned short) (victim & 0xffff);
+	cuckoo->victim_index = get_u32(ptr + 20);
+	cuckoo->count = get_u64(ptr + 24);
+
+	ptr += HDR_SIZE;
+	n = (size_t) nbuckets * SLOTS;
+	for (i = 0; i < n; i++, ptr += 2)
+		cuckoo->table[i] = (unsigned short) (ptr[0] | (ptr[1] << 8));
+	return cuckoo;
+}
+
+int acl_cuckoo_save(const ACL_CUCKOO *cuckoo, const char *path)
+{
+	ACL_VSTRING *buf = acl_vstring_alloc(HDR_SIZE
+			+ (size_t) cuckoo->nbuckets * SLOTS * 2);
+	int   ret;
+
+	acl_cuckoo_dump(cuckoo, buf);
+	ret = file_save(buf, path);
+	acl_vstring_free(buf);
+	return ret;
+}
+
+ACL_CUCKOO *acl_cuckoo_open(const char *path)
+{
+	ssize_t size;
+	char *data = acl_vstream_loadfile2(path, &size);
+	ACL_CUCKOO *cuckoo;
+
+	if (data == NULL)
+		return NULL;
+	cuckoo = size > 0 ? acl_cuckoo_load(data, (size_t) size) : NULL;
+	acl_myfree(data);
+	return cuckoo;
+}
@@ -0,0 +1,653 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_bptree.h"
+
+#endif
+
+#define ORDER		ACL_BPTREE_ORDER
+#define MIN_KEYS	(ORDER / 2)
+#define MAX_DEPTH	32
+
+typedef struct BPT_NODE {
+	int   leaf;
+	int   n;
+	const void *keys[ORDER];
+} BPT_NODE;
+
+/* the inner node with n keys has n + 1 children, the child i holds the
+ * keys in [keys[i - 1], keys[i])
+ */
+typedef struct BPT_INNER {
+	BPT_NODE node;
+	BPT_NODE *child[ORDER + 1];
+} BPT_INNER;
+
+typedef struct BPT_LEAF {
+	BPT_NODE node;
+	struct BPT_LEAF *prev;
+	struct BPT_LEAF *next;
+	void *values[ORDER];
+} BPT_LEAF;
+
+struct ACL_BPTREE {
+	int (*cmp_fn)(const void*, const void*);
+	BPT_NODE *root;
+	BPT_LEAF *head;
+	BPT_LEAF *tail;
+	int   count;
+	int   depth;
+};
+
+#define INNER(x)	((BPT_INNER*) (x))
+#define LEAF(x)		((BPT_LEAF*) (x))
+
+ACL_BPTREE *acl_bptree_create(int (*cmp_fn)(const void*, const void*))
+{
+	ACL_BPTREE *tree = (ACL_BPTREE*) acl_mycalloc(1, sizeof(ACL_BPTREE));
+
+	tree->cmp_fn = cmp_fn;
+	return tree;
+}
+
+static void node_free(BPT_NODE *node, void (*free_fn)(void*, void*))
+{
+	int   i;
+	union {
+		void *key;
+		const void *c_key;
+	} key;
+
+	if (node->leaf) {
+		if (free_fn) {
+			for (i = 0; i < node->n; i++) {
+				key.c_key = node->keys[i];
+				free_fn(key.key, LEAF(node)->values[i]);
+			}
+		}
+	} else {
+		for (i = 0; i <= node->n; i++)
+			node_free(INNER(node)->child[i], free_fn);
+	}
+	acl_myfree(node);
+}
+
+void acl_bptree_free(ACL_BPTREE *tree, void (*free_fn)(void*, void*))
+{
+	if (tree->root)
+		node_free(tree->root, free_fn);
+	acl_myfree(tree);
+}
+
+static BPT_LEAF *leaf_new(void)
+{
+	BPT_LEAF *leaf = (BPT_LEAF*) acl_mymalloc(sizeof(BPT_LEAF));
+
+	leaf->node.leaf = 1;
+	leaf->node.n = 0;
+	leaf->prev = leaf->next = NULL;
+	return leaf;
+}
+
+static BPT_INNER *inner_new(void)
+{
+	BPT_INNER *inner = (BPT_INNER*) acl_mymalloc(sizeof(BPT_INNER));
+
+	inner->node.leaf = 0;
+	inner->node.n = 0;
+	return inner;
+}
+
+/* return the first position whose key >= key, *eq is set when equal */
+static int node_search(const ACL_BPTREE *tree, const BPT_NODE *node,
+	const void *key, int *eq)
+{
+	int   lo = 0, hi = node->n, mid, ret;
+
+	*eq = 0;
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+		ret = tree->cmp_fn(node->keys[mid], key);
+		if (ret < 0)
+			lo = mid + 1;
+		else {
+			if (ret == 0) {
+				*eq = 1;
+				return mid;
+			}
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static BPT_LEAF *leaf_find(const ACL_BPTREE *tree, const void *key)
+{
+	BPT_NODE *node = tree->root;
+	int   i, eq;
+
+	while (!node->leaf) {
+		i = node_search(tree, node, key, &eq);
+		node = INNER(node)->child[eq ? i + 1 : i];
+	}
+	return LEAF(node);
+}
+
+void *acl_bptree_find(const ACL_BPTREE *tree, const void *key)
+{
+	BPT_LEAF *leaf;
+	int   i, eq;
+
+	if (tree->root == NULL)
+		return NULL;
+	leaf = leaf_find(tree, key);
+	i = node_search(tree, &leaf->node, key, &eq);
+	return eq ? leaf->values[i] : NULL;
+}
+
+int acl_bptree_count(const ACL_BPTREE *tree)
+{
+	return tree->count;
+}
+
+int acl_bptree_depth(const ACL_BPTREE *tree)
+{
+	return tree->depth;
+}
+
+/*****************************************************************************/
+
+/* split the full leaf while inserting key at pos, return the right half */
+static BPT_LEAF *leaf_split(BPT_LEAF *leaf, int pos, const void *key,
+	void *value)
+{
+	const void *keys[ORDER + 1];
+	void *values[ORDER + 1];
+	BPT_LEAF *right = leaf_new();
+	int   nleft = (ORDER + 1) / 2, i;
+
+	memcpy(keys, leaf->node.keys, pos * sizeof(void*));
+	memcpy(values, leaf->values, pos * sizeof(void*));
+	keys[pos] = key;
+	values[pos] = value;
+	memcpy(keys + pos + 1, leaf->node.keys + pos, (ORDER - pos) * sizeof(void*));
+	memcpy(values + pos + 1, leaf->values + pos, (ORDER - pos) * sizeof(void*));
+
+	for (i = 0; i < nleft; i++) {
+		leaf->node.keys[i] = keys[i];
+		leaf->values[i] = values[i];
+	}
+	leaf->node.n = nleft;
+	for (i = nleft; i <= ORDER; i++) {
+		right->node.keys[i - nleft] = keys[i];
+		right->values[i - nleft] = values[i];
+	}
+	right->node.n = ORDER + 1 - nleft;
+
+	right->prev = leaf;
+	right->next = leaf->next;
+	if (leaf->next)
+		leaf->next->prev = right;
+	leaf->next = right;
+	return right;
+}
+
+/* split the full inner node while inserting key and its right child at pos,
+ * return the right half and the key moved up
+ */
+static BPT_INNER *inner_split(BPT_INNER *inner, int pos, const void *key,
+	BPT_NODE *child, const void **up)
+{
+	const void *keys[ORDER + 1];
+	BPT_NODE *children[ORDER + 2];
+	BPT_INNER *right = inner_new();
+	int   i;
+
+	memcpy(keys, inner->node.keys, pos * sizeof(void*));
+	keys[pos] = key;
+	memcpy(keys + pos + 1, inner->node.keys + pos,
+		(ORDER - pos) * sizeof(void*));
+	memcpy(children, inner->child, (pos + 1) * sizeof(void*));
+	children[pos + 1] = child;
+	memcpy(children + pos + 2, inner->child + pos + 1,
+		(ORDER - pos) * sizeof(void*));
+
+	/* MIN_KEYS keys left, one up and ORDER - MIN_KEYS keys right */
+	for (i = 0; i < MIN_KEYS; i++) {
+		inner->node.keys[i] = keys[i];
+		inner->child[i] = children[i];
+	}
+	inner->child[MIN_KEYS] = children[MIN_KEYS];
+	inner->node.n = MIN_KEYS;
+
+	*up = keys[MIN_KEYS];
+
+	for (i = MIN_KEYS + 1; i <= ORDER; i++) {
+		right->node.keys[i - MIN_KEYS - 1] = keys[i];
+		right->child[i - MIN_KEYS - 1] = children[i];
+	}
+	right->child[ORDER - MIN_KEYS] = children[ORDER + 1];
+	right->node.n = ORDER - MIN_KEYS;
+	return right;
+}
+
+int acl_bptree_add(ACL_BPTREE *tree, const void *key, void *value)
+{
+	BPT_INNER *path[MAX_DEPTH], *parent, *new_root;
+	int   idx[MAX_DEPTH], lvl = 0, i, eq, pos;
+	BPT_NODE *node, *split;
+	const void *sep;
+
+	if (tree->root == NULL) {
+		BPT_LEAF *leaf = leaf_new();
+
+		leaf->node.keys[0] = key;
+		leaf->values[0] = value;
+		leaf->node.n = 1;
+		tree->root = &leaf->node;
+		tree->head = tree->tail = leaf;
+		tree->count = 1;
+		tree->depth = 1;
+		return 0;
+	}
+
+	node = tree->root;
+	while (!node->leaf) {
+		i = node_search(tree, node, key, &eq);
+		path[lvl] = INNER(node);
+		idx[lvl++] = eq ? i + 1 : i;
+		node = INNER(node)->child[eq ? i + 1 : i];
+	}
+
+	pos = node_search(tree, node, key, &eq);
+	if (eq)
+		return -1;
+	tree->count++;
+
+	if (node->n < ORDER) {
+		memmove(node->keys + pos + 1, node->keys + pos,
+			(node->n - pos) * sizeof(void*));
+		memmove(LEAF(node)->values + pos + 1, LEAF(node)->values + pos,
+			(node->n - pos) * sizeof(void*));
+		node->keys[pos] = key;
+		LEAF(node)->values[pos] = value;
+		node->n++;
+		return 0;
+	}
+
+	split = &leaf_split(LEAF(node), pos, key, value)->node;
+	if (LEAF(node) == tree->tail)
+		tree->tail = LEAF(split);
+	sep = split->keys[0];
+
+	while (lvl > 0) {
+		parent = path[--lvl];
+		pos = idx[lvl];
+		if (parent->node.n < ORDER) {
+			memmove(parent->node.keys + pos + 1, parent->node.keys + pos,
+				(parent->node.n - pos) * sizeof(void*));
+			memmove(parent->child + pos + 2, parent->child + pos + 1,
+				(parent->node.n - pos) * sizeof(void*));
+			parent->node.keys[pos] = sep;
+			parent->child[pos + 1] = split;
+			parent->node.n++;
+			return 0;
+		}
+		split = &inner_split(parent, pos, sep, split, &sep)->node;
+	}
+
+	new_root = inner_new();
+	new_root->node.keys[0] = sep;
+	new_root->child[0] = tree->root;
+	new_root->child[1] = split;
+	new_root->node.n = 1;
+	tree->root = &new_root->node;
+	tree->depth++;
+	return 0;
+}
+
+/*****************************************************************************/
+
+/* remove the key at pos and the child at pos + 1 from the inner node */
+static void inner_remove(BPT_INNER *inner, int pos)
+{
+	memmove(inner->node.keys + pos, inner->node.keys + pos + 1,
+		(inner->node.n - pos - 1) * sizeof(void*));
+	memmove(inner->child + pos + 1, inner->child + pos + 2,
+		(inner->node.n - pos - 1) * sizeof(void*));
+	inner->node.n--;
+}
+
+static void leaf_rebalance(ACL_BPTREE *tree, BPT_INNER *parent, int c)
+{
+	BPT_LEAF *leaf = LEAF(parent->child[c]);
+	BPT_LEAF *left = c > 0 ? LEAF(parent->child[c - 1]) : NULL;
+	BPT_LEAF *right = c < parent->node.n ? LEAF(parent->child[c + 1]) : NULL;
+	int   n;
+
+	if (left && left->node.n > MIN_KEYS) {
+		n = leaf->node.n;
+		memmove(leaf->node.keys + 1, leaf->node.keys, n * sizeof(void*));
+		memmove(leaf->values + 1, leaf->values, n * sizeof(void*));
+		leaf->node.keys[0] = left->node.keys[left->node.n - 1];
+		leaf->values[0] = left->values[left->node.n - 1];
+		left->node.n--;
+		leaf->node.n++;
+		parent->node.keys[c - 1] = leaf->node.keys[0];
+	} else if (right && right->node.n > MIN_KEYS) {
+		n = leaf->node.n;
+		leaf->node.keys[n] = right->node.keys[0];
+		leaf->values[n] = right->values[0];
+		leaf->node.n++;
+		right->node.n--;
+		memmove(right->node.keys, right->node.keys + 1,
+			right->node.n * sizeof(void*));
+		memmove(right->values, right->values + 1,
+			right->node.n * sizeof(void*));
+		parent->node.keys[c] = right->node.keys[0];
+	} else {
+		if (left == NULL) {
+			/* merge the right sibling into the leaf instead */
+			left = leaf;
+			leaf = right;
+			c++;
+		}
+		memcpy(left->node.keys + left->node.n, leaf->node.keys,
+			leaf->node.n * sizeof(void*));
+		memcpy(left->values + left->node.n, leaf->values,
+			leaf->node.n * sizeof(void*));
+		left->node.n += leaf->node.n;
+		left->next = leaf->next;
+		if (leaf->next)
+			leaf->next->prev = left;
+		if (tree->tail == leaf)
+			tree->tail = left;
+		inner_remove(parent, c - 1);
+		acl_myfree(leaf);
+	}
+}
+
+static void inner_rebalance(BPT_INNER *parent, int c)
+{
+	BPT_INNER *inner = INNER(parent->child[c]);
+	BPT_INNER *left = c > 0 ? INNER(parent->child[c - 1]) : NULL;
+	BPT_INNER *right = c < parent->node.n ? INNER(parent->child[c + 1]) : NULL;
+	int   n;
+
+	if (left && left->node.n > MIN_KEYS) {
+		n = inner->node.n;
+		memmove(inner->node.keys + 1, inner->node.keys, n * sizeof(void*));
+		memmove(inner->child + 1, inner->child, (n + 1) * sizeof(void*));
+		inner->node.keys[0] = parent->node.keys[c - 1];
+		inner->child[0] = left->child[left->node.n];
+		parent->node.keys[c - 1] = left->node.keys[left->node.n - 1];
+		left->node.n--;
+		inner->node.n++;
+	} else if (right && right->node.n > MIN_KEYS) {
+		n = inner->node.n;
+		inner->node.keys[n] = parent->node.keys[c];
+		inner->child[n + 1] = right->child[0];
+		inner->node.n++;
+		parent->node.keys[c] = right->node.keys[0];
+		right->node.n--;
+		memmove(right->node.keys, right->node.keys + 1,
+			right->node.n * sizeof(void*));
+		memmove(right->child, right->child + 1,
+			(right->node.n + 1) * sizeof(void*));
+	} else {
+		if (left == NULL) {
+			left = inner;
+			inner = right;
+			c++;
+		}
+		n = left->node.n;
+		left->node.keys[n] = parent->node.keys[c - 1];
+		memcpy(left->node.keys + n + 1, inner->node.keys,
+			inner->node.n * sizeof(void*));
+		memcpy(left->child + n + 1, inner->child,
+			(inner->node.n + 1) * sizeof(void*));
+		left->node.n += inner->node.n + 1;
+		inner_remove(parent, c - 1);
+		acl_myfree(inner);
+	}
+}
+
+void *acl_bptree_delete(ACL_BPTREE *tree, const void *key, const void **pkey)
+{
+	BPT_INNER *path[MAX_DEPTH];
+	int   idx[MAX_DEPTH], lvl = 0, i, eq;
+	BPT_NODE *node, *child;
+	void *value;
+
+	if (tree->root == NULL)
+		return NULL;
+
+	node = tree->root;
+	while (!node->leaf) {
+		i = node_search(tree, node, key, &eq);
+		path[lvl] = INNER(node);
+		idx[lvl++] = eq ? i + 1 : i;
+		node = INNER(node)->child[eq ? i + 1 : i];
+	}
+
+	i = node_search(tree, node, key, &eq);
+	if (!eq)
+		return NULL;
+
+	if (pkey)
+		*pkey = node->keys[i];
+	value = LEAF(node)->values[i];
+	memmove(node->keys + i, node->keys + i + 1,
+		(node->n - i - 1) * sizeof(void*));
+	memmove(LEAF(node)->values + i, LEAF(node)->values + i + 1,
+		(node->n - i - 1) * sizeof(void*));
+	node->n--;
+	tree->count--;
+
+	while (lvl > 0 && node->n < MIN_KEYS) {
+		lvl--;
+		if (node->leaf)
+			leaf_rebalance(tree, path[lvl], idx[lvl]);
+		else
+			inner_rebalance(path[lvl], idx[lvl]);
+		node = &path[lvl]->node;
+	}
+
+	if (tree->root->n == 0) {
+		if (tree->root->leaf) {
+			acl_myfree(tree->root);
+			tree->root = NULL;
+			tree->head = tree->tail = NULL;
+			tree->depth = 0;
+			return value;
+		}
+		node = tree->root;
+		tree->root = INNER(node)->child[0];
+		tree->depth--;
+		acl_myfree(node);
+	}
+
+	/* the deleted key may still be used as a separator in the inner
+	 * nodes along its search path, replace it with the smallest key of
+	 * the right subtree because the key's memory may be freed by caller
+	 */
+	node = tree->root;
+	while (!node->leaf) {
+		i = node_search(tree, node, key, &eq);
+		if (!eq) {
+			node = INNER(node)->child[i];
+			continue;
+		}
+		child = INNER(node)->child[i + 1];
+		while (!child->leaf)
+			child = INNER(child)->child[0];
+		node->keys[i] = child->keys[0];
+		node = INNER(node)->child[i + 1];
+	}
+
+	return value;
+}
+
+/*****************************************************************************/
+
+int acl_bptree_load(ACL_BPTREE *tree, const void *keys[], void *values[], int n)
+{
+	const char *myname = "acl_bptree_load";
+	BPT_NODE **nodes;
+	const void **mins;
+	BPT_LEAF *leaf, *prev = NULL;
+	BPT_INNER *inner;
+	int   m, pm, i, j, k, cnt;
+
+	if (tree->root != NULL || n < 0) {
+		acl_msg_error("%s(%d): tree not empty or n(%d) invalid",
+			myname, __LINE__, n);
+		return -1;
+	}
+	for (i = 1; i < n; i++) {
+		if (tree->cmp_fn(keys[i - 1], keys[i]) >= 0) {
+			acl_msg_error("%s(%d): keys not in strict order at %d",
+				myname, __LINE__, i);
+			return -1;
+		}
+	}
+	if (n == 0)
+		return 0;
+
+	/* the leaves are filled as even as possible so that each of them
+	 * has at least MIN_KEYS keys
+	 */
+	m = (n + ORDER - 1) / ORDER;
+	nodes = (BPT_NODE**) acl_mymalloc(m * sizeof(BPT_NODE*));
+	mins = (const void**) acl_mymalloc(m * sizeof(void*));
+
+	for (j = 0, k = 0; j < m; j++) {
+		cnt = n / m + (j < n % m ? 1 : 0);
+		leaf = leaf_new();
+		memcpy(leaf->node.keys, keys + k, cnt * sizeof(void*));
+		memcpy(leaf->values, values + k, cnt * sizeof(void*));
+		leaf->node.n = cnt;
+		leaf->prev = prev;
+		if (prev)
+			prev->next = leaf;
+		else
+			tree->head = leaf;
+		prev = leaf;
+		nodes[j] = &leaf->node;
+		mins[j] = leaf->node.keys[0];
+		k += cnt;
+	}
+	tree->tail = prev;
+	tree->depth = 1;
+
+	while (m > 1) {
+		pm = (m + ORDER) / (ORDER + 1);
+		for (j = 0, k = 0; j < pm; j++) {
+			cnt = m / pm + (j < m % pm ? 1 : 0);
+			inner = inner_new();
+			for (i = 0; i < cnt; i++) {
+				inner->child[i] = nodes[k + i];
+				if (i > 0)
+					inner->node.keys[i - 1] = mins[k + i];
+			}
+			inner->node.n = cnt - 1;
+			nodes[j] = &inner->node;
+			mins[j] = mins[k];
+			k += cnt;
+		}
+		m = pm;
+		tree->depth++;
+	}
+
+	tree->root = nodes[0];
+	tree->count = n;
+	acl_myfree(nodes);
+	acl_myfree(mins);
+	return 0;
+}
+
+/*****************************************************************************/
+
+static int iter_set(ACL_BPTREE_ITER *iter, BPT_LEAF *leaf, int pos)
+{
+	if (leaf == NULL) {
+		iter->leaf = NULL;
+		iter->key = NULL;
+		iter->value = NULL;
+		return -1;
+	}
+
+	iter->leaf = leaf;
+	iter->pos = pos;
+	iter->key = leaf->node.keys[pos];
+	iter->value = leaf->values[pos];
+	return 0;
+}
+
+int acl_bptree_seek(const ACL_BPTREE *tree, ACL_BPTREE_ITER *iter,
+	const void *key)
+{
+	BPT_LEAF *leaf;
+	int   i, eq;
+
+	if (tree->root == NULL)
+		return iter_set(iter, NULL, 0);
+	if (key == NULL)
+		return iter_set(iter, tree->head, 0);
+
+	leaf = leaf_find(tree, key);
+	i = node_search(tree, &leaf->node, key, &eq);
+	if (i < leaf->node.n)
+		return iter_set(iter, leaf, i);
+	return iter_set(iter, leaf->next, 0);
+}
+
+int acl_bptree_seek_last(const ACL_BPTREE *tree, ACL_BPTREE_ITER *iter,
+	const void *key)
+{
+	BPT_LEAF *leaf;
+	int   i, eq;
+
+	if (tree->root == NULL)
+		return iter_set(iter, NULL, 0);
+	if (key == NULL)
+		return iter_set(iter, tree->tail, tree->tail->node.n - 1);
+
+	leaf = leaf_find(tree, key);
+	i = node_search(tree, &leaf->node, key, &eq);
+	if (eq)
+		return iter_set(iter, leaf, i);
+	if (i > 0)
+		return iter_set(iter, leaf, i - 1);
+	leaf = leaf->prev;
+	return iter_set(iter, leaf, leaf ? leaf->node.n - 1 : 0);
+}
+
+int acl_bptree_next(ACL_BPTREE_ITER *iter)
+{
+	BPT_LEAF *leaf = LEAF(iter->leaf);
+
+	if (leaf == NULL)
+		return -1;
+	if (iter->pos + 1 < leaf->node.n)
+		return iter_set(iter, leaf, iter->pos + 1);
+	return iter_set(iter, leaf->next, 0);
+}
+
+int acl_bptree_prev(ACL_BPTREE_ITER *iter)
+{
+	BPT_LEAF *leaf = LEAF(iter->leaf);
+
+	if (leaf == NULL)
+		return -1;
+	if (iter->pos > 0)
+		return iter_set(iter, leaf, iter->pos - 1);
+	leaf = leaf->prev;
+	return iter_set(iter, leaf, leaf ? leaf->node.n - 1 : 0);
+}
@@ -459,6 +459,9 @@ ACL_DLINK *acl_dlink_create(int nsize)
 	plink = (ACL_DLINK *) acl_mymalloc(sizeof(ACL_DLINK));
 	plink->parray = NULL;
 	plink->call_back_data = NULL;
+	plink->version = 0;
+	plink->index = NULL;
+	plink->index_version = 0;
 	nsize = nsize > 0 ? nsize : 1;
 	plink->parray = acl_array_create(nsize);
 	if(plink->parray == NULL) {
@@ -600,6 +603,7 @@ ACL_DITEM *acl_dlink_insert(ACL_DLINK *plink, acl_uint64 begin, acl_uint64 end)
 		end   = tmp;
 	}
 
+	plink->version++;
 	if(acl_array_size(plink->parray) == 0) {
 		/* this is the first item of the array */
 		return dlink_append(plink->parray, begin, end);
@@ -617,6 +621,7 @@ int acl_dlink_delete(ACL_DLINK *plink, acl_uint64 n)
 	ditem = acl_dlink_lookup2(plink, n, &idx);
 	if (ditem == NULL)
 		return -1;
+	plink->version++;
 	acl_array_delete_idx(plink->parray, idx, dlink_free_callback);
 	return 0;
 }
@@ -625,6 +630,7 @@ int acl_dlink_delete_by_item(ACL_DLINK *plink, ACL_DITEM *pitem)
 {
 	int ret;
 
+	plink->version++;
 	ret = acl_array_delete_obj(plink->parray, pitem, dlink_free_callback);
 	if (ret < 0)	/* this is impossile, but a sanity check */
 		return -1;
@@ -640,6 +646,7 @@ int acl_dlink_delete_range(ACL_DLINK *plink, acl_uint64 begin, acl_uint64 end)
 	low = 0;
 	pitem_low = NULL;
 	size = acl_array_size(parray);
+	plink->version++;
 
 	for (i = 0; i < size; i++) {
 		pitem = (ACL_DITEM*) acl_array_index(parray, i);
@@ -756,6 +763,7 @@ ACL_DITEM *acl_dlink_modify(ACL_DLINK *plink, acl_uint64 begin, acl_uint64 end)
 		end   = tmp;
 	}
 
+	plink->version++;
 	return dlink_add(plink->parray, begin, end);
 }
 
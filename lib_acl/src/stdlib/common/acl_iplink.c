@@ -21,6 +21,7 @@
 #include "stdlib/acl_array.h"
 #include "stdlib/acl_dlink.h"
 #include "stdlib/acl_iplink.h"
+#include "stdlib/acl_iptrie.h"
 
 #endif
 
@@ -59,8 +60,42 @@ ACL_IPLINK *acl_iplink_create(int nsize)
 
 void acl_iplink_free(ACL_IPLINK *lnk)
 {
-	if (lnk)
-		acl_dlink_free(lnk);
+	if (lnk == NULL)
+		return;
+	if (lnk->index)
+		acl_iptrie_free((ACL_IPTRIE*) lnk->index);
+	acl_dlink_free(lnk);
+}
+
+int acl_iplink_build_index(ACL_IPLINK *plink)
+{
+	ACL_IPTRIE *trie = (ACL_IPTRIE*) plink->index;
+	ACL_IPITEM *item;
+	int   i, n;
+
+	if (trie == NULL)
+		trie = acl_iptrie_create();
+	else
+		acl_iptrie_reset(trie);
+
+	n = acl_array_size(plink->parray);
+	for (i = 0; i < n; i++) {
+		item = (ACL_IPITEM*) acl_array_index(plink->parray, i);
+		if (item->begin > 0xffffffff || item->end > 0xffffffff)
+			continue;
+		if (acl_iptrie_add_range4(trie, (unsigned int) item->begin,
+			(unsigned int) item->end, item) < 0)
+		{
+			acl_iptrie_free(trie);
+			plink->index = NULL;
+			return -1;
+		}
+	}
+
+	acl_iptrie_compile(trie);
+	plink->index = trie;
+	plink->index_version = plink->version;
+	return 0;
 }
 
 ACL_IPITEM *acl_iplink_lookup_item(const ACL_IPLINK *plink,
@@ -71,6 +106,9 @@ ACL_IPITEM *acl_iplink_lookup_item(const ACL_IPLINK *plink,
 
 ACL_IPITEM *acl_iplink_lookup_bin(const ACL_IPLINK *plink, unsigned int ip)
 {
+	if (plink->index && plink->index_version == plink->version)
+		return (ACL_IPITEM*) acl_iptrie_lookup4(
+			(const ACL_IPTRIE*) plink->index, ip);
 	return acl_dlink_lookup(plink, ip);
 }
 
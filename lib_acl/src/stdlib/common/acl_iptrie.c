@@ -0,0 +1,735 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_mystring.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_iptrie.h"
+
+#endif
+
+/*
+ * All prefixes are kept in a binary trie which is the only writable part.
+ * acl_iptrie_compile() turns it into a poptrie: a 2^16 direct pointing
+ * table followed by 64-ary nodes whose children and leaves are addressed
+ * by popcount over two bit vectors, so one node is 24 bytes and the leaves
+ * of the same value are run-length compressed.
+ */
+
+typedef struct BT_NODE {
+	int   child[2];
+	unsigned int value;	/* index into values, 0 means none */
+} BT_NODE;
+
+typedef struct POP_NODE {
+	acl_uint64 vector;	/* bit i set: entry i points to a child node */
+	acl_uint64 leafvec;	/* bit i set: a leaf run starts at entry i */
+	unsigned int base0;	/* the first leaf of the node */
+	unsigned int base1;	/* the first child node of the node */
+} POP_NODE;
+
+#define DIRECT_BITS	16
+#define DIRECT_SIZE	(1 << DIRECT_BITS)
+#define DIRECT_LEAF	0x80000000
+#define STRIDE		6
+
+typedef struct IPTRIE_FAMILY {
+	int   width;		/* 32 or 128 */
+	int   count;
+	int   dirty;
+
+	BT_NODE *bt;
+	int   bt_size;
+	int   bt_max;
+
+	unsigned int *direct;
+	POP_NODE *nodes;
+	unsigned int nnodes;
+	unsigned int nodes_max;
+	unsigned int *leaves;
+	unsigned int nleaves;
+	unsigned int leaves_max;
+} IPTRIE_FAMILY;
+
+struct ACL_IPTRIE {
+	IPTRIE_FAMILY v4;
+	IPTRIE_FAMILY v6;
+
+	void **values;		/* values[0] is always NULL */
+	unsigned int nvalues;
+	unsigned int values_max;
+	unsigned int *vfree;	/* recycled value slots */
+	unsigned int nvfree;
+};
+
+static unsigned int popcnt64(acl_uint64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned int) __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & (acl_uint64) 0x5555555555555555);
+	x = (x & (acl_uint64) 0x3333333333333333)
+		+ ((x >> 2) & (acl_uint64) 0x3333333333333333);
+	x = (x + (x >> 4)) & (acl_uint64) 0x0f0f0f0f0f0f0f0f;
+	return (unsigned int) ((x * (acl_uint64) 0x0101010101010101) >> 56);
+#endif
+}
+
+static void family_init(IPTRIE_FAMILY *fam, int width)
+{
+	memset(fam, 0, sizeof(IPTRIE_FAMILY));
+	fam->width = width;
+	fam->bt_max = 64;
+	fam->bt = (BT_NODE*) acl_mymalloc(fam->bt_max * sizeof(BT_NODE));
+	fam->bt[0].child[0] = fam->bt[0].child[1] = -1;
+	fam->bt[0].value = 0;
+	fam->bt_size = 1;
+	fam->dirty = 1;
+}
+
+static void family_compiled_free(IPTRIE_FAMILY *fam)
+{
+	if (fam->direct) {
+		acl_myfree(fam->direct);
+		fam->direct = NULL;
+	}
+	if (fam->nodes) {
+		acl_myfree(fam->nodes);
+		fam->nodes = NULL;
+	}
+	if (fam->leaves) {
+		acl_myfree(fam->leaves);
+		fam->leaves = NULL;
+	}
+	fam->nnodes = fam->nodes_max = 0;
+	fam->nleaves = fam->leaves_max = 0;
+}
+
+static void family_free(IPTRIE_FAMILY *fam)
+{
+	family_compiled_free(fam);
+	acl_myfree(fam->bt);
+}
+
+ACL_IPTRIE *acl_iptrie_create(void)
+{
+	ACL_IPTRIE *trie = (ACL_IPTRIE*) acl_mycalloc(1, sizeof(ACL_IPTRIE));
+
+	family_init(&trie->v4, 32);
+	family_init(&trie->v6, 128);
+	trie->values_max = 64;
+	trie->values = (void**) acl_mymalloc(trie->values_max * sizeof(void*));
+	trie->values[0] = NULL;
+	trie->nvalues = 1;
+	trie->vfree = (unsigned int*) acl_mymalloc(
+		trie->values_max * sizeof(unsigned int));
+	return trie;
+}
+
+void acl_iptrie_free(ACL_IPTRIE *trie)
+{
+	family_free(&trie->v4);
+	family_free(&trie->v6);
+	acl_myfree(trie->values);
+	acl_myfree(trie->vfree);
+	acl_myfree(trie);
+}
+
+void acl_iptrie_reset(ACL_IPTRIE *trie)
+{
+	family_free(&trie->v4);
+	family_free(&trie->v6);
+	family_init(&trie->v4, 32);
+	family_init(&trie->v6, 128);
+	trie->nvalues = 1;
+	trie->nvfree = 0;
+}
+
+/*****************************************************************************/
+
+static int parse_ip4(const char *ip, unsigned char *addr)
+{
+	int   i, n;
+
+	for (i = 0; i < 4; i++) {
+		if (*ip < '0' || *ip > '9')
+			return -1;
+		n = 0;
+		while (*ip >= '0' && *ip <= '9') {
+			n = n * 10 + (*ip++ - '0');
+			if (n > 255)
+				return -1;
+		}
+		addr[i] = (unsigned char) n;
+		if (i < 3 && *ip++ != '.')
+			return -1;
+	}
+	return *ip == 0 ? 0 : -1;
+}
+
+static int hexval(int ch)
+{
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+	if (ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+	if (ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+	return -1;
+}
+
+static int parse_ip6(const char *ip, unsigned char *addr)
+{
+	unsigned char buf[16];
+	int   ngroup = 0, gap = -1, i, n, v, d;
+	const char *ptr;
+
+	if (ip[0] == ':') {
+		if (ip[1] != ':')
+			return -1;
+		gap = 0;
+		ip += 2;
+	}
+
+	while (*ip) {
+		if (ngroup >= 8)
+			return -1;
+
+		/* the embedded ipv4 address at the tail */
+		ptr = ip;
+		while (hexval(*ptr) >= 0)
+			ptr++;
+		if (*ptr == '.') {
+			if (ngroup > 6 || parse_ip4(ip, buf + ngroup * 2) < 0)
+				return -1;
+			ngroup += 2;
+			break;
+		}
+
+		v = 0;
+		for (n = 0; (d = hexval(*ip)) >= 0; n++, ip++) {
+			if (n >= 4)
+				return -1;
+			v = (v << 4) | d;
+		}
+		if (n == 0)
+			return -1;
+		buf[ngroup * 2] = (unsigned char) (v >> 8);
+		buf[ngroup * 2 + 1] = (unsigned char) (v & 0xff);
+		ngroup++;
+
+		if (*ip == 0)
+			break;
+		if (*ip++ != ':')
+			return -1;
+		if (*ip == ':') {
+			if (gap >= 0)
+				return -1;
+			gap = ngroup;
+			ip++;
+		} else if (*ip == 0)
+			return -1;
+	}
+
+	if (gap < 0) {
+		if (ngroup != 8)
+			return -1;
+		memcpy(addr, buf, 16);
+		return 0;
+	}
+	if (ngroup >= 8)
+		return -1;
+
+	memset(addr, 0, 16);
+	memcpy(addr, buf, gap * 2);
+	n = (ngroup - gap) * 2;
+	for (i = 0; i < n; i++)
+		addr[16 - n + i] = buf[gap * 2 + i];
+	return 0;
+}
+
+int acl_iptrie_parse(const char *ip, unsigned char *addr)
+{
+	char  buf[64], *ptr;
+	size_t len;
+
+	if (ip == NULL || *ip == 0)
+		return -1;
+
+	if (*ip == '[') {
+		ip++;
+		ptr = strchr(ip, ']');
+		len = ptr ? (size_t) (ptr - ip) : strlen(ip);
+	} else
+		len = strlen(ip);
+	if (len >= sizeof(buf))
+		return -1;
+	memcpy(buf, ip, len);
+	buf[len] = 0;
+
+	/* skip the zone id, such as fe80::1%eth0 */
+	ptr = strchr(buf, '%');
+	if (ptr)
+		*ptr = 0;
+
+	ptr = strchr(buf, ':');
+	if (ptr == NULL)
+		return parse_ip4(buf, addr) == 0 ? 4 : -1;
+	if (strchr(ptr + 1, ':') == NULL) {
+		/* ipv4 with port, such as 127.0.0.1:80 */
+		*ptr = 0;
+		return parse_ip4(buf, addr) == 0 ? 4 : -1;
+	}
+	return parse_ip6(buf, addr) == 0 ? 6 : -1;
+}
+
+static int parse_cidr(const char *cidr, unsigned char *addr, int *plen)
+{
+	char  buf[64], *ptr;
+	int   family, len = -1, width;
+
+	if (cidr == NULL || strlen(cidr) >= sizeof(buf))
+		return -1;
+	ACL_SAFE_STRNCPY(buf, cidr, sizeof(buf));
+
+	ptr = strchr(buf, '/');
+	if (ptr) {
+		*ptr++ = 0;
+		if (*ptr < '0' || *ptr > '9')
+			return -1;
+		len = atoi(ptr);
+	}
+
+	family = acl_iptrie_parse(buf, addr);
+	if (family < 0)
+		return -1;
+	width = family == 4 ? 32 : 128;
+	if (len < 0)
+		len = width;
+	else if (len > width)
+		return -1;
+	*plen = len;
+	return family;
+}
+
+/*****************************************************************************/
+
+#define KEY_BIT(key, i)	(((key)[(i) >> 3] >> (7 - ((i) & 7))) & 1)
+
+static int bt_node_new(IPTRIE_FAMILY *fam)
+{
+	if (fam->bt_size >= fam->bt_max) {
+		fam->bt_max *= 2;
+		fam->bt = (BT_NODE*) acl_myrealloc(fam->bt,
+			fam->bt_max * sizeof(BT_NODE));
+	}
+	fam->bt[fam->bt_size].child[0] = -1;
+	fam->bt[fam->bt_size].child[1] = -1;
+	fam->bt[fam->bt_size].value = 0;
+	return fam->bt_size++;
+}
+
+static unsigned int value_new(ACL_IPTRIE *trie, void *value)
+{
+	unsigned int idx;
+
+	if (trie->nvfree > 0)
+		idx = trie->vfree[--trie->nvfree];
+	else {
+		if (trie->nvalues >= trie->values_max) {
+			trie->values_max *= 2;
+			trie->values = (void**) acl_myrealloc(trie->values,
+				trie->values_max * sizeof(void*));
+			trie->vfree = (unsigned int*) acl_myrealloc(trie->vfree,
+				trie->values_max * sizeof(unsigned int));
+		}
+		idx = trie->nvalues++;
+	}
+	trie->values[idx] = value;
+	return idx;
+}
+
+static int prefix_add(ACL_IPTRIE *trie, IPTRIE_FAMILY *fam,
+	const unsigned char *key, int len, void *value)
+{
+	int   node = 0, i, bit, next;
+
+	for (i = 0; i < len; i++) {
+		bit = KEY_BIT(key, i);
+		next = fam->bt[node].child[bit];
+		if (next < 0) {
+			next = bt_node_new(fam);  /* may move fam->bt */
+			fam->bt[node].child[bit] = next;
+		}
+		node = next;
+	}
+
+	if (fam->bt[node].value > 0)
+		trie->values[fam->bt[node].value] = value;
+	else {
+		fam->bt[node].value = value_new(trie, value);
+		fam->count++;
+	}
+	fam->dirty = 1;
+	return 0;
+}
+
+static void key_mask(unsigned char *key, int width, int len)
+{
+	int   i;
+
+	for (i = len; i < width; i++)
+		key[i >> 3] &= (unsigned char) ~(1 << (7 - (i & 7)));
+}
+
+int acl_iptrie_add(ACL_IPTRIE *trie, const char *cidr, void *value)
+{
+	const char *myname = "acl_iptrie_add";
+	unsigned char key[16];
+	int   family, len;
+
+	if (value == NULL) {
+		acl_msg_error("%s(%d): value NULL", myname, __LINE__);
+		return -1;
+	}
+
+	family = parse_cidr(cidr, key, &len);
+	if (family < 0) {
+		acl_msg_error("%s(%d): invalid cidr(%s)", myname, __LINE__,
+			cidr ? cidr : "null");
+		return -1;
+	}
+
+	if (family == 4) {
+		key_mask(key, 32, len);
+		return prefix_add(trie, &trie->v4, key, len, value);
+	} else {
+		key_mask(key, 128, len);
+		return prefix_add(trie, &trie->v6, key, len, value);
+	}
+}
+
+int acl_iptrie_add_range4(ACL_IPTRIE *trie, unsigned int begin,
+	unsigned int end, void *value)
+{
+	acl_uint64 b = begin, e = end, size;
+	unsigned char key[4];
+	int   len, n = 0;
+
+	if (value == NULL || begin > end)
+		return -1;
+
+	while (b <= e) {
+		/* the largest aligned block starting at b within the range */
+		len = 32;
+		while (len > 0) {
+			size = ((acl_uint64) 1) << (32 - len + 1);
+			if ((b & (size - 1)) != 0 || b + size - 1 > e)
+				break;
+			len--;
+		}
+
+		key[0] = (unsigned char) ((b >> 24) & 0xff);
+		key[1] = (unsigned char) ((b >> 16) & 0xff);
+		key[2] = (unsigned char) ((b >> 8) & 0xff);
+		key[3] = (unsigned char) (b & 0xff);
+		prefix_add(trie, &trie->v4, key, len, value);
+		n++;
+		b += ((acl_uint64) 1) << (32 - len);
+	}
+
+	return n;
+}
+
+int acl_iptrie_del(ACL_IPTRIE *trie, const char *cidr)
+{
+	IPTRIE_FAMILY *fam;
+	unsigned char key[16];
+	int   family, len, node = 0, i;
+
+	family = parse_cidr(cidr, key, &len);
+	if (family < 0)
+		return -1;
+
+	fam = family == 4 ? &trie->v4 : &trie->v6;
+	key_mask(key, fam->width, len);
+
+	for (i = 0; i < len && node >= 0; i++)
+		node = fam->bt[node].child[KEY_BIT(key, i)];
+	if (node < 0 || fam->bt[node].value == 0)
+		return -1;
+
+	/* the empty branch is kept, it's harmless for the lookup */
+	trie->values[fam->bt[node].value] = NULL;
+	trie->vfree[trie->nvfree++] = fam->bt[node].value;
+	fam->bt[node].value = 0;
+	fam->count--;
+	fam->dirty = 1;
+	return 0;
+}
+
+int acl_iptrie_count(const ACL_IPTRIE *trie)
+{
+	return trie->v4.count + trie->v6.count;
+}
+
+/*****************************************************************************/
+
+/* get n bits from the bit offset off of the key, padding 0 after width */
+static unsigned int key_bits(const unsigned char *key, int width,
+	int off, int n)
+{
+	unsigned int v = 0;
+	int   i;
+
+	for (i = off; i < off + n; i++) {
+		v <<= 1;
+		if (i < width)
+			v |= KEY_BIT(key, i);
+	}
+	return v;
+}
+
+/*
+ * walk down the binary trie from node at depth by n bits of pattern,
+ * remembering the longest prefix value met, return the last node or -1
+ */
+static int bt_walk(const IPTRIE_FAMILY *fam, int node, int depth, int n,
+	unsigned int pattern, unsigned int *value)
+{
+	int   i, bit;
+
+	for (i = 0; i < n && depth + i < fam->width; i++) {
+		bit = (pattern >> (n - 1 - i)) & 1;
+		node = fam->bt[node].child[bit];
+		if (node < 0)
+			return -1;
+		if (fam->bt[node].value > 0)
+			*value = fam->bt[node].value;
+	}
+	return node;
+}
+
+#define BT_HAS_CHILD(fam, node) \
+	((node) >= 0 && ((fam)->bt[(node)].child[0] >= 0 \
+		|| (fam)->bt[(node)].child[1] >= 0))
+
+static unsigned int pop_nodes_alloc(IPTRIE_FAMILY *fam, unsigned int n)
+{
+	unsigned int base = fam->nnodes;
+
+	if (fam->nnodes + n > fam->nodes_max) {
+		while (fam->nnodes + n > fam->nodes_max)
+			fam->nodes_max = fam->nodes_max > 0
+				? fam->nodes_max * 2 : 1024;
+		if (fam->nodes)
+			fam->nodes = (POP_NODE*) acl_myrealloc(fam->nodes,
+				fam->nodes_max * sizeof(POP_NODE));
+		else
+			fam->nodes = (POP_NODE*) acl_mymalloc(
+				fam->nodes_max * sizeof(POP_NODE));
+	}
+	fam->nnodes += n;
+	return base;
+}
+
+static void pop_leaf_add(IPTRIE_FAMILY *fam, unsigned int value)
+{
+	if (fam->nleaves >= fam->leaves_max) {
+		fam->leaves_max = fam->leaves_max > 0
+			? fam->leaves_max * 2 : 1024;
+		if (fam->leaves)
+			fam->leaves = (unsigned int*) acl_myrealloc(fam->leaves,
+				fam->leaves_max * sizeof(unsigned int));
+		else
+			fam->leaves = (unsigned int*) acl_mymalloc(
+				fam->leaves_max * sizeof(unsigned int));
+	}
+	fam->leaves[fam->nleaves++] = value;
+}
+
+static void pop_node_build(IPTRIE_FAMILY *fam, unsigned int pos, int bnode,
+	int depth, unsigned int inherit)
+{
+	unsigned int values[1 << STRIDE], prev = 0, base0, base1, k;
+	int   ends[1 << STRIDE], i, first = 1;
+	acl_uint64 vector = 0, leafvec = 0, bit;
+
+	for (i = 0; i < (1 << STRIDE); i++) {
+		values[i] = inherit;
+		ends[i] = bt_walk(fam, bnode, depth, STRIDE,
+			(unsigned int) i, &values[i]);
+		if (depth + STRIDE < fam->width && BT_HAS_CHILD(fam, ends[i]))
+			vector |= ((acl_uint64) 1) << i;
+	}
+
+	base0 = fam->nleaves;
+	for (i = 0; i < (1 << STRIDE); i++) {
+		bit = ((acl_uint64) 1) << i;
+		if (vector & bit)
+			continue;
+		if (first || values[i] != prev) {
+			leafvec |= bit;
+			pop_leaf_add(fam, values[i]);
+			prev = values[i];
+			first = 0;
+		}
+	}
+
+	base1 = pop_nodes_alloc(fam, popcnt64(vector));
+	fam->nodes[pos].vector = vector;
+	fam->nodes[pos].leafvec = leafvec;
+	fam->nodes[pos].base0 = base0;
+	fam->nodes[pos].base1 = base1;
+
+	for (i = 0, k = 0; i < (1 << STRIDE); i++) {
+		if (vector & (((acl_uint64) 1) << i))
+			pop_node_build(fam, base1 + k++, ends[i],
+				depth + STRIDE, values[i]);
+	}
+}
+
+static void family_compile(IPTRIE_FAMILY *fam)
+{
+	unsigned int i, value, pos;
+	int   end;
+
+	family_compiled_free(fam);
+	fam->direct = (unsigned int*) acl_mymalloc(
+		DIRECT_SIZE * sizeof(unsigned int));
+
+	for (i = 0; i < DIRECT_SIZE; i++) {
+		value = fam->bt[0].value;
+		end = bt_walk(fam, 0, 0, DIRECT_BITS, i, &value);
+		if (BT_HAS_CHILD(fam, end)) {
+			pos = pop_nodes_alloc(fam, 1);
+			fam->direct[i] = pos;
+			pop_node_build(fam, pos, end, DIRECT_BITS, value);
+		} else
+			fam->direct[i] = DIRECT_LEAF | value;
+	}
+
+	fam->dirty = 0;
+}
+
+int acl_iptrie_compile(ACL_IPTRIE *trie)
+{
+	if (trie->v4.dirty)
+		family_compile(&trie->v4);
+	if (trie->v6.dirty)
+		family_compile(&trie->v6);
+	return 0;
+}
+
+/*****************************************************************************/
+
+/* lookup in the binary trie when the trie hasn't been compiled */
+static unsigned int bt_lookup(const IPTRIE_FAMILY *fam, const unsigned char *key)
+{
+	unsigned int value = fam->bt[0].value;
+	int   node = 0, i;
+
+	for (i = 0; i < fam->width; i++) {
+		node = fam->bt[node].child[KEY_BIT(key, i)];
+		if (node < 0)
+			break;
+		if (fam->bt[node].value > 0)
+			value = fam->bt[node].value;
+	}
+	return value;
+}
+
+static unsigned int pop_lookup(const IPTRIE_FAMILY *fam, const unsigned char *key)
+{
+	unsigned int e = fam->direct[(key[0] << 8) | key[1]], idx;
+	const POP_NODE *node;
+	acl_uint64 bit;
+	int   off = DIRECT_BITS;
+
+	if (e & DIRECT_LEAF)
+		return e & ~DIRECT_LEAF;
+
+	node = &fam->nodes[e];
+	while (1) {
+		idx = key_bits(key, fam->width, off, STRIDE);
+		bit = ((acl_uint64) 1) << idx;
+		if (!(node->vector & bit))
+			break;
+		node = &fam->nodes[node->base1
+			+ popcnt64(node->vector & (bit - 1))];
+		off += STRIDE;
+	}
+
+	return fam->leaves[node->base0
+		+ popcnt64(node->leafvec & ((bit << 1) - 1)) - 1];
+}
+
+/* the same as pop_lookup, but extracting bits from a register */
+void *acl_iptrie_lookup4(const ACL_IPTRIE *trie, unsigned int ip)
+{
+	const IPTRIE_FAMILY *fam = &trie->v4;
+	unsigned char key[4];
+	unsigned int e, idx;
+	const POP_NODE *node;
+	acl_uint64 bit, k;
+	int   off;
+
+	if (fam->dirty) {
+		if (fam->count == 0)
+			return NULL;
+		key[0] = (unsigned char) (ip >> 24);
+		key[1] = (unsigned char) ((ip >> 16) & 0xff);
+		key[2] = (unsigned char) ((ip >> 8) & 0xff);
+		key[3] = (unsigned char) (ip & 0xff);
+		return trie->values[bt_lookup(fam, key)];
+	}
+
+	e = fam->direct[ip >> 16];
+	if (e & DIRECT_LEAF)
+		return trie->values[e & ~DIRECT_LEAF];
+
+	k = ((acl_uint64) ip) << 32;
+	node = &fam->nodes[e];
+	off = DIRECT_BITS;
+	while (1) {
+		idx = (unsigned int) ((k << off) >> (64 - STRIDE));
+		bit = ((acl_uint64) 1) << idx;
+		if (!(node->vector & bit))
+			break;
+		node = &fam->nodes[node->base1
+			+ popcnt64(node->vector & (bit - 1))];
+		off += STRIDE;
+	}
+
+	return trie->values[fam->leaves[node->base0
+		+ popcnt64(node->leafvec & ((bit << 1) - 1)) - 1]];
+}
+
+void *acl_iptrie_lookup6(const ACL_IPTRIE *trie, const unsigned char *ip)
+{
+	const IPTRIE_FAMILY *fam = &trie->v6;
+
+	if (fam->dirty)
+		return fam->count == 0 ? NULL : trie->values[bt_lookup(fam, ip)];
+	return trie->values[pop_lookup(fam, ip)];
+}
+
+void *acl_iptrie_lookup(const ACL_IPTRIE *trie, const char *ip)
+{
+	unsigned char addr[16];
+
+	switch (acl_iptrie_parse(ip, addr)) {
+	case 4:
+		return acl_iptrie_lookup4(trie, ((unsigned int) addr[0] << 24)
+			| ((unsigned int) addr[1] << 16)
+			| ((unsigned int) addr[2] << 8) | addr[3]);
+	case 6:
+		return acl_iptrie_lookup6(trie, addr);
+	default:
+		return NULL;
+	}
+}
@@ -0,0 +1,829 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_vstring.h"
+#include "stdlib/acl_vstream.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_file.h"
+#include "stdlib/acl_token_tree.h"
+#include "stdlib/acl_token_ac.h"
+
+#endif
+
+#ifdef ACL_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef STR
+#define STR	acl_vstring_str
+#endif
+
+#ifndef LEN
+#define LEN	ACL_VSTRING_LEN
+#endif
+
+/*
+ * The automaton is stored as a double array: the transition of state s by
+ * byte c goes to t = base[s] + c when check[t] == s, otherwise the failure
+ * links are followed.  base/check/fail/out of one state share 16 bytes so
+ * that one transition touches a single cache line in the common case.
+ */
+
+typedef struct AC_NODE {
+	int   base;
+	int   check;		/* owner state, AC_FREE for unused slot */
+	int   fail;
+	int   out;		/* first accepting state in the suffix chain, or 0 */
+} AC_NODE;
+
+#define AC_FREE		-1
+#define AC_ROOT_CHECK	-2
+#define AC_ALPHA	256
+
+typedef struct AC_WORD {
+	unsigned int off;	/* offset of the word in strs */
+	unsigned int len;
+	unsigned int flag;
+} AC_WORD;
+
+/* the trie used only while building */
+typedef struct AC_TNODE {
+	int   child;		/* first child */
+	int   sibling;		/* next sibling, sorted by label */
+	int   word;		/* word id or -1 */
+	int   state;		/* the state index in the double array */
+	unsigned char label;
+} AC_TNODE;
+
+#define AC_MAGIC	"ACLTKAC1"
+#define AC_VERSION	1
+#define AC_ENDIAN	0x01020304
+
+typedef struct AC_FILE_HDR {
+	char  magic[8];
+	unsigned int version;
+	unsigned int endian;
+	unsigned int flags;
+	unsigned int nnodes;
+	unsigned int nwords;
+	unsigned int strs_len;
+	unsigned char map[AC_ALPHA];
+} AC_FILE_HDR;
+
+struct ACL_TOKEN_AC {
+	unsigned int flags;
+	unsigned char map[AC_ALPHA];
+
+	/* compiled automaton, either owned or pointing into mmap'ed file */
+	const AC_NODE *nodes;
+	const int *state_word;
+	const AC_WORD *words;
+	const char *strs;
+	int   nnodes;
+	int   nwords;
+
+	/* building part, unused when loaded from file */
+	AC_TNODE *tnodes;
+	int   tnodes_size;
+	int   tnodes_max;
+	AC_WORD *words_build;
+	const void **ctxs;
+	int   words_max;
+	ACL_VSTRING *strs_build;
+	int   dirty;
+
+	AC_NODE *nodes_own;
+	int  *state_word_own;
+
+	/* loaded part */
+	void *map_addr;
+	size_t map_len;
+};
+
+ACL_TOKEN_AC *acl_token_ac_create(unsigned int flags)
+{
+	ACL_TOKEN_AC *ac = (ACL_TOKEN_AC*) acl_mycalloc(1, sizeof(ACL_TOKEN_AC));
+	int   i;
+
+	ac->flags = flags;
+	for (i = 0; i < AC_ALPHA; i++) {
+		if ((flags & ACL_TOKEN_AC_F_ICASE) && i >= 'A' && i <= 'Z')
+			ac->map[i] = (unsigned char) (i - 'A' + 'a');
+		else
+			ac->map[i] = (unsigned char) i;
+	}
+
+	ac->tnodes_max = 1024;
+	ac->tnodes = (AC_TNODE*) acl_mymalloc(ac->tnodes_max * sizeof(AC_TNODE));
+	ac->tnodes[0].child = -1;
+	ac->tnodes[0].sibling = -1;
+	ac->tnodes[0].word = -1;
+	ac->tnodes[0].state = 0;
+	ac->tnodes[0].label = 0;
+	ac->tnodes_size = 1;
+
+	ac->words_max = 64;
+	ac->words_build = (AC_WORD*) acl_mymalloc(ac->words_max * sizeof(AC_WORD));
+	ac->ctxs = (const void**) acl_mymalloc(ac->words_max * sizeof(void*));
+	ac->strs_build = acl_vstring_alloc(1024);
+	return ac;
+}
+
+void acl_token_ac_free(ACL_TOKEN_AC *ac)
+{
+	if (ac->map_addr) {
+#ifdef ACL_UNIX
+		munmap(ac->map_addr, ac->map_len);
+#else
+		acl_myfree(ac->map_addr);
+#endif
+	}
+	if (ac->tnodes)
+		acl_myfree(ac->tnodes);
+	if (ac->words_build)
+		acl_myfree(ac->words_build);
+	if (ac->ctxs)
+		acl_myfree(ac->ctxs);
+	if (ac->strs_build)
+		acl_vstring_free(ac->strs_build);
+	if (ac->nodes_own)
+		acl_myfree(ac->nodes_own);
+	if (ac->state_word_own)
+		acl_myfree(ac->state_word_own);
+	acl_myfree(ac);
+}
+
+static int ac_tnode_new(ACL_TOKEN_AC *ac, unsigned char label)
+{
+	AC_TNODE *node;
+
+	if (ac->tnodes_size >= ac->tnodes_max) {
+		ac->tnodes_max *= 2;
+		ac->tnodes = (AC_TNODE*) acl_myrealloc(ac->tnodes,
+			ac->tnodes_max * sizeof(AC_TNODE));
+	}
+	node = &ac->tnodes[ac->tnodes_size];
+	node->child = -1;
+	node->sibling = -1;
+	node->word = -1;
+	node->state = -1;
+	node->label = label;
+	return ac->tnodes_size++;
+}
+
+/* find or create the child of parent labeled ch, keeping siblings sorted */
+static int ac_tnode_child(ACL_TOKEN_AC *ac, int parent, unsigned char ch)
+{
+	int   prev = -1, iter = ac->tnodes[parent].child, node;
+
+	while (iter >= 0 && ac->tnodes[iter].label < ch) {
+		prev = iter;
+		iter = ac->tnodes[iter].sibling;
+	}
+	if (iter >= 0 && ac->tnodes[iter].label == ch)
+		return iter;
+
+	node = ac_tnode_new(ac, ch);  /* may move ac->tnodes */
+	ac->tnodes[node].sibling = iter;
+	if (prev < 0)
+		ac->tnodes[parent].child = node;
+	else
+		ac->tnodes[prev].sibling = node;
+	return node;
+}
+
+int acl_token_ac_add(ACL_TOKEN_AC *ac, const char *word,
+	unsigned int flag, const void *ctx)
+{
+	const char *myname = "acl_token_ac_add";
+	const unsigned char *ptr = (const unsigned char*) word;
+	int   node = 0, id;
+	size_t len;
+
+	if (ac->tnodes == NULL) {
+		acl_msg_error("%s(%d): can't add word to loaded automaton",
+			myname, __LINE__);
+		return -1;
+	}
+	if (word == NULL || *word == 0)
+		return -1;
+	if ((flag & ACL_TOKEN_F_PASS) && (flag & ACL_TOKEN_F_DENY)) {
+		acl_msg_error("%s(%d): word(%s)'s flag(%u) is"
+			" ACL_TOKEN_F_DENY | ACL_TOKEN_F_PASS",
+			myname, __LINE__, word, flag);
+		return -1;
+	}
+
+	while (*ptr) {
+		node = ac_tnode_child(ac, node, ac->map[*ptr]);
+		ptr++;
+	}
+
+	flag |= ACL_TOKEN_F_STOP;
+	id = ac->tnodes[node].word;
+	if (id >= 0) {
+		ac->words_build[id].flag = flag;
+		ac->ctxs[id] = ctx;
+		return id;
+	}
+
+	if (ac->nwords >= ac->words_max) {
+		ac->words_max *= 2;
+		ac->words_build = (AC_WORD*) acl_myrealloc(ac->words_build,
+			ac->words_max * sizeof(AC_WORD));
+		ac->ctxs = (const void**) acl_myrealloc(ac->ctxs,
+			ac->words_max * sizeof(void*));
+	}
+
+	len = (const char*) ptr - word;
+	id = ac->nwords++;
+	ac->words_build[id].off = (unsigned int) LEN(ac->strs_build);
+	ac->words_build[id].len = (unsigned int) len;
+	ac->words_build[id].flag = flag;
+	ac->ctxs[id] = ctx;
+	acl_vstring_memcat(ac->strs_build, word, len + 1);
+	ac->tnodes[node].word = id;
+	ac->dirty = 1;
+	return id;
+}
+
+static void ac_tree_walk(const ACL_TOKEN *token, void *arg)
+{
+	ACL_TOKEN_AC *ac = (ACL_TOKEN_AC*) arg;
+	ACL_VSTRING *buf = acl_vstring_alloc(128);
+
+	acl_token_name(token, buf);
+	(void) acl_token_ac_add(ac, STR(buf), token->flag, token->ctx);
+	acl_vstring_free(buf);
+}
+
+int acl_token_ac_add_tree(ACL_TOKEN_AC *ac, const ACL_TOKEN *token_tree)
+{
+	int   i, n = ac->nwords;
+
+	if (ac->tnodes == NULL)
+		return -1;
+
+	for (i = 0; i < ACL_TOKEN_WIDTH; i++) {
+		if (token_tree->tokens[i])
+			acl_token_tree_walk(token_tree->tokens[i],
+				ac_tree_walk, ac);
+	}
+	return ac->nwords - n;
+}
+
+int acl_token_ac_load_words(ACL_TOKEN_AC *ac, const char *filepath,
+	unsigned int flag_default)
+{
+	const char *myname = "acl_token_ac_load_words";
+	ACL_FILE *fp;
+	unsigned int flag;
+	char  buf[1024], *ptr;
+	int   n = 0;
+
+	if (ac->tnodes == NULL)
+		return -1;
+
+	fp = acl_fopen(filepath, "r");
+	if (fp == NULL) {
+		acl_msg_error("%s(%d): open %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		return -1;
+	}
+
+	while (acl_fgets_nonl(buf, sizeof(buf), fp) != NULL) {
+		ptr = strrchr(buf, '|');
+		if (ptr) {
+			*ptr++ = 0;
+			flag = ACL_TOKEN_F_STOP;
+			if (*ptr == 'd' || *ptr == 'D')
+				flag |= ACL_TOKEN_F_DENY;
+			else if (*ptr == 'p' || *ptr == 'P')
+				flag |= ACL_TOKEN_F_PASS;
+		} else
+			flag = flag_default;
+		if (buf[0] == 0 || buf[0] == '#')
+			continue;
+		if (acl_token_ac_add(ac, buf, flag, NULL) >= 0)
+			n++;
+	}
+
+	acl_fclose(fp);
+	return n;
+}
+
+/*****************************************************************************/
+
+/*
+ * Free slots are kept in an ascending doubly linked list, so searching
+ * a base only visits the free slots; a slot that failed too many times
+ * as the first child's position is dropped from the list (it is still
+ * free and can be used by the other children), as libdatrie/cedar do.
+ */
+typedef struct AC_BUILDER {
+	AC_NODE *nodes;
+	int  *fnext;
+	int  *fprev;
+	unsigned char *ftry;
+	int   size;
+	int   fhead;
+	int   ftail;
+	int   max_used;
+} AC_BUILDER;
+
+#define AC_TRY_MAX	16
+
+static void ac_builder_grow(AC_BUILDER *builder, int need)
+{
+	int   size = builder->size, i;
+
+	if (need <= size)
+		return;
+	while (size < need)
+		size *= 2;
+	builder->nodes = (AC_NODE*) acl_myrealloc(builder->nodes,
+		size * sizeof(AC_NODE));
+	builder->fnext = (int*) acl_myrealloc(builder->fnext, size * sizeof(int));
+	builder->fprev = (int*) acl_myrealloc(builder->fprev, size * sizeof(int));
+	builder->ftry = (unsigned char*) acl_myrealloc(builder->ftry, size);
+
+	for (i = builder->size; i < size; i++) {
+		builder->nodes[i].base = 0;
+		builder->nodes[i].check = AC_FREE;
+		builder->nodes[i].fail = 0;
+		builder->nodes[i].out = 0;
+		builder->ftry[i] = 0;
+		builder->fnext[i] = -1;
+		builder->fprev[i] = builder->ftail;
+		if (builder->ftail >= 0)
+			builder->fnext[builder->ftail] = i;
+		else
+			builder->fhead = i;
+		builder->ftail = i;
+	}
+	builder->size = size;
+}
+
+static void ac_builder_init(AC_BUILDER *builder)
+{
+	/* acl_myrealloc doesn't accept NULL, so allocate the root first */
+	builder->nodes = (AC_NODE*) acl_mymalloc(sizeof(AC_NODE));
+	builder->fnext = (int*) acl_mymalloc(sizeof(int));
+	builder->fprev = (int*) acl_mymalloc(sizeof(int));
+	builder->ftry = (unsigned char*) acl_mymalloc(1);
+	builder->size = 1;
+	builder->fhead = -1;
+	builder->ftail = -1;
+	builder->max_used = 0;
+
+	builder->nodes[0].base = 0;
+	builder->nodes[0].check = AC_ROOT_CHECK;
+	builder->nodes[0].fail = 0;
+	builder->nodes[0].out = 0;
+	builder->fnext[0] = builder->fprev[0] = -1;
+	builder->ftry[0] = 0;
+
+	ac_builder_grow(builder, 1024);
+}
+
+static void ac_builder_end(AC_BUILDER *builder)
+{
+	acl_myfree(builder->fnext);
+	acl_myfree(builder->fprev);
+	acl_myfree(builder->ftry);
+	builder->fnext = builder->fprev = NULL;
+	builder->ftry = NULL;
+}
+
+static void ac_builder_unlink(AC_BUILDER *builder, int pos)
+{
+	int   prev = builder->fprev[pos], next = builder->fnext[pos];
+
+	if (prev >= 0)
+		builder->fnext[prev] = next;
+	else
+		builder->fhead = next;
+	if (next >= 0)
+		builder->fprev[next] = prev;
+	else
+		builder->ftail = prev;
+	builder->fprev[pos] = builder->fnext[pos] = -1;
+}
+
+static void ac_builder_use(AC_BUILDER *builder, int pos, int owner)
+{
+	/* dropped slots were already unlinked */
+	if (builder->fprev[pos] >= 0 || builder->fhead == pos)
+		ac_builder_unlink(builder, pos);
+	builder->nodes[pos].check = owner;
+	if (pos > builder->max_used)
+		builder->max_used = pos;
+}
+
+/* find a base where every label of the children lands on a free slot */
+static int ac_builder_base(AC_BUILDER *builder, const AC_TNODE *tnodes,
+	int first)
+{
+	int   pos, next, base, iter;
+	unsigned char first_label = tnodes[first].label;
+
+	pos = builder->fhead;
+	while (1) {
+		if (pos < 0) {
+			/* no usable free slot left, append some */
+			pos = builder->size;
+			ac_builder_grow(builder, builder->size + AC_ALPHA + 1);
+		}
+
+		base = pos - first_label;
+		if (base >= 1) {
+			ac_builder_grow(builder, base + AC_ALPHA + 1);
+			for (iter = tnodes[first].sibling; iter >= 0;
+				iter = tnodes[iter].sibling)
+			{
+				if (builder->nodes[base + tnodes[iter].label]
+					.check != AC_FREE)
+				{
+					break;
+				}
+			}
+			if (iter < 0)
+				return base;
+		}
+
+		next = builder->fnext[pos];
+		if (base >= 1 && ++builder->ftry[pos] >= AC_TRY_MAX)
+			ac_builder_unlink(builder, pos);
+		pos = next;
+	}
+}
+
+static int ac_compile_da(ACL_TOKEN_AC *ac, AC_BUILDER *builder)
+{
+	AC_TNODE *tnodes = ac->tnodes;
+	int  *queue, head = 0, tail = 0, tn, child, base, t;
+
+	ac_builder_init(builder);
+
+	queue = (int*) acl_mymalloc(ac->tnodes_size * sizeof(int));
+	tnodes[0].state = 0;
+	queue[tail++] = 0;
+
+	while (head < tail) {
+		tn = queue[head++];
+		child = tnodes[tn].child;
+		if (child < 0)
+			continue;
+
+		base = ac_builder_base(builder, tnodes, child);
+		builder->nodes[tnodes[tn].state].base = base;
+
+		for (; child >= 0; child = tnodes[child].sibling) {
+			t = base + tnodes[child].label;
+			ac_builder_use(builder, t, tnodes[tn].state);
+			tnodes[child].state = t;
+			queue[tail++] = child;
+		}
+	}
+
+	acl_myfree(queue);
+	ac_builder_end(builder);
+
+	/* keep room so base + c never runs past the end while matching */
+	builder->size = builder->max_used + AC_ALPHA + 1;
+	return 0;
+}
+
+#define AC_NEXT(nodes, s, c) \
+	((nodes)[(nodes)[(s)].base + (c)].check == (s) \
+	 ? (nodes)[(s)].base + (c) : -1)
+
+static void ac_compile_fail(ACL_TOKEN_AC *ac, AC_NODE *nodes, int *state_word)
+{
+	const AC_TNODE *tnodes = ac->tnodes;
+	int  *queue, head = 0, tail = 0, tn, child, s, t, f, next;
+	unsigned char c;
+
+	queue = (int*) acl_mymalloc(ac->tnodes_size * sizeof(int));
+	queue[tail++] = 0;
+
+	while (head < tail) {
+		tn = queue[head++];
+		s = tnodes[tn].state;
+		for (child = tnodes[tn].child; child >= 0;
+			child = tnodes[child].sibling)
+		{
+			c = tnodes[child].label;
+			t = tnodes[child].state;
+			state_word[t] = tnodes[child].word;
+
+			if (s == 0)
+				nodes[t].fail = 0;
+			else {
+				f = nodes[s].fail;
+				while ((next = AC_NEXT(nodes, f, c)) < 0 && f != 0)
+					f = nodes[f].fail;
+				nodes[t].fail = next < 0 ? 0 : next;
+			}
+
+			/* fail state is shallower, so its out is already set */
+			nodes[t].out = state_word[t] >= 0
+				? t : nodes[nodes[t].fail].out;
+			queue[tail++] = child;
+		}
+	}
+
+	acl_myfree(queue);
+}
+
+int acl_token_ac_compile(ACL_TOKEN_AC *ac)
+{
+	AC_BUILDER builder;
+	int  *state_word, i;
+
+	if (ac->tnodes == NULL)
+		return ac->nodes != NULL ? 0 : -1;
+	if (!ac->dirty && ac->nodes != NULL)
+		return 0;
+
+	if (ac_compile_da(ac, &builder) < 0)
+		return -1;
+
+	state_word = (int*) acl_mymalloc(builder.size * sizeof(int));
+	for (i = 0; i < builder.size; i++)
+		state_word[i] = -1;
+
+	ac_compile_fail(ac, builder.nodes, state_word);
+
+	if (ac->nodes_own)
+		acl_myfree(ac->nodes_own);
+	if (ac->state_word_own)
+		acl_myfree(ac->state_word_own);
+
+	ac->nodes_own = builder.nodes;
+	ac->state_word_own = state_word;
+	ac->nodes = ac->nodes_own;
+	ac->state_word = ac->state_word_own;
+	ac->nnodes = builder.size;
+	ac->words = ac->words_build;
+	ac->strs = STR(ac->strs_build);
+	ac->dirty = 0;
+	return 0;
+}
+
+/*****************************************************************************/
+
+static void ac_hit_set(const ACL_TOKEN_AC *ac, int id, size_t end,
+	ACL_TOKEN_AC_HIT *hit)
+{
+	const AC_WORD *word = &ac->words[id];
+
+	hit->id = id;
+	hit->word = ac->strs + word->off;
+	hit->len = word->len;
+	hit->off = end + 1 - word->len;
+	hit->flag = word->flag;
+	hit->ctx = ac->ctxs != NULL && ac->tnodes != NULL ? ac->ctxs[id] : NULL;
+}
+
+int acl_token_ac_scan(const ACL_TOKEN_AC *ac, const char *s, size_t len,
+	int (*hit_fn)(const ACL_TOKEN_AC_HIT*, void*), void *arg)
+{
+	const AC_NODE *nodes = ac->nodes;
+	const unsigned char *ptr = (const unsigned char*) s;
+	const unsigned char *map = ac->map;
+	ACL_TOKEN_AC_HIT hit;
+	size_t i;
+	int   state = 0, next, out, n = 0;
+	unsigned char c;
+
+	if (nodes == NULL || ac->nwords == 0)
+		return 0;
+
+	for (i = 0; i < len; i++) {
+		c = map[ptr[i]];
+		while ((next = AC_NEXT(nodes, state, c)) < 0 && state != 0)
+			state = nodes[state].fail;
+		state = next < 0 ? 0 : next;
+
+		for (out = nodes[state].out; out > 0;
+			out = nodes[nodes[out].fail].out)
+		{
+			n++;
+			if (hit_fn == NULL)
+				continue;
+			ac_hit_set(ac, ac->state_word[out], i, &hit);
+			if (hit_fn(&hit, arg) != 0)
+				return n;
+		}
+	}
+
+	return n;
+}
+
+int acl_token_ac_find(const ACL_TOKEN_AC *ac, const char *s,
+	size_t len, ACL_TOKEN_AC_HIT *hit)
+{
+	const AC_NODE *nodes = ac->nodes;
+	const unsigned char *ptr = (const unsigned char*) s;
+	const unsigned char *map = ac->map;
+	size_t i;
+	int   state = 0, next;
+	unsigned char c;
+
+	if (nodes == NULL || ac->nwords == 0)
+		return 0;
+
+	for (i = 0; i < len; i++) {
+		c = map[ptr[i]];
+		while ((next = AC_NEXT(nodes, state, c)) < 0 && state != 0)
+			state = nodes[state].fail;
+		state = next < 0 ? 0 : next;
+
+		/* the first state in the out chain is the longest one */
+		if (nodes[state].out > 0) {
+			if (hit)
+				ac_hit_set(ac, ac->state_word[nodes[state].out],
+					i, hit);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int acl_token_ac_count(const ACL_TOKEN_AC *ac)
+{
+	return ac->nwords;
+}
+
+/*****************************************************************************/
+
+int acl_token_ac_save(const ACL_TOKEN_AC *ac, const char *filepath)
+{
+	const char *myname = "acl_token_ac_save";
+	ACL_VSTREAM *fp;
+	AC_FILE_HDR hdr;
+	unsigned int strs_len;
+	int   ret;
+
+	if (ac->nodes == NULL || (ac->tnodes != NULL && ac->dirty)) {
+		acl_msg_error("%s(%d): automaton not compiled", myname, __LINE__);
+		return -1;
+	}
+
+	strs_len = ac->nwords > 0 ? ac->words[ac->nwords - 1].off
+		+ ac->words[ac->nwords - 1].len + 1 : 0;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, AC_MAGIC, sizeof(hdr.magic));
+	hdr.version = AC_VERSION;
+	hdr.endian = AC_ENDIAN;
+	hdr.flags = ac->flags;
+	hdr.nnodes = (unsigned int) ac->nnodes;
+	hdr.nwords = (unsigned int) ac->nwords;
+	hdr.strs_len = strs_len;
+	memcpy(hdr.map, ac->map, sizeof(hdr.map));
+
+#ifdef	WIN32
+	fp = acl_vstream_fopen(filepath, O_WRONLY | O_CREAT | O_TRUNC
+		| O_BINARY, 0644, 8192);
+#else
+	fp = acl_vstream_fopen(filepath, O_WRONLY | O_CREAT | O_TRUNC,
+		0644, 8192);
+#endif
+	if (fp == NULL) {
+		acl_msg_error("%s(%d): open %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		return -1;
+	}
+
+	ret = acl_vstream_buffed_writen(fp, &hdr, sizeof(hdr));
+	if (ret != ACL_VSTREAM_EOF)
+		ret = acl_vstream_buffed_writen(fp, ac->nodes,
+			ac->nnodes * sizeof(AC_NODE));
+	if (ret != ACL_VSTREAM_EOF)
+		ret = acl_vstream_buffed_writen(fp, ac->state_word,
+			ac->nnodes * sizeof(int));
+	if (ret != ACL_VSTREAM_EOF && ac->nwords > 0)
+		ret = acl_vstream_buffed_writen(fp, ac->words,
+			ac->nwords * sizeof(AC_WORD));
+	if (ret != ACL_VSTREAM_EOF && strs_len > 0)
+		ret = acl_vstream_buffed_writen(fp, ac->strs, strs_len);
+	if (ret != ACL_VSTREAM_EOF)
+		ret = acl_vstream_fflush(fp);
+
+	acl_vstream_close(fp);
+
+	if (ret == ACL_VSTREAM_EOF) {
+		acl_msg_error("%s(%d): write %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		return -1;
+	}
+	return 0;
+}
+
+static int ac_attach(ACL_TOKEN_AC *ac, const char *data, size_t len)
+{
+	const char *myname = "ac_attach";
+	const AC_FILE_HDR *hdr = (const AC_FILE_HDR*) data;
+	size_t need;
+
+	if (len < sizeof(AC_FILE_HDR)
+		|| memcmp(hdr->magic, AC_MAGIC, sizeof(hdr->magic)) != 0
+		|| hdr->version != AC_VERSION || hdr->endian != AC_ENDIAN)
+	{
+		acl_msg_error("%s(%d): invalid file header", myname, __LINE__);
+		return -1;
+	}
+
+	need = sizeof(AC_FILE_HDR) + (size_t) hdr->nnodes * sizeof(AC_NODE)
+		+ (size_t) hdr->nnodes * sizeof(int)
+		+ (size_t) hdr->nwords * sizeof(AC_WORD) + hdr->strs_len;
+	if (need > len || hdr->nnodes < AC_ALPHA + 1) {
+		acl_msg_error("%s(%d): file truncated, need: %lu, len: %lu",
+			myname, __LINE__, (unsigned long) need,
+			(unsigned long) len);
+		return -1;
+	}
+
+	ac->flags = hdr->flags;
+	memcpy(ac->map, hdr->map, sizeof(ac->map));
+	ac->nnodes = (int) hdr->nnodes;
+	ac->nwords = (int) hdr->nwords;
+	data += sizeof(AC_FILE_HDR);
+	ac->nodes = (const AC_NODE*) data;
+	data += hdr->nnodes * sizeof(AC_NODE);
+	ac->state_word = (const int*) data;
+	data += hdr->nnodes * sizeof(int);
+	ac->words = (const AC_WORD*) data;
+	data += hdr->nwords * sizeof(AC_WORD);
+	ac->strs = data;
+	return 0;
+}
+
+ACL_TOKEN_AC *acl_token_ac_load(const char *filepath)
+{
+	const char *myname = "acl_token_ac_load";
+	ACL_TOKEN_AC *ac;
+	void *addr;
+	size_t len;
+#ifdef ACL_UNIX
+	struct stat sbuf;
+	int   fd = open(filepath, O_RDONLY);
+
+	if (fd == -1) {
+		acl_msg_error("%s(%d): open %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		return NULL;
+	}
+	if (fstat(fd, &sbuf) == -1 || sbuf.st_size <= 0) {
+		acl_msg_error("%s(%d): fstat %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		close(fd);
+		return NULL;
+	}
+	len = (size_t) sbuf.st_size;
+	addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		acl_msg_error("%s(%d): mmap %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		return NULL;
+	}
+#else
+	ssize_t size;
+
+	addr = acl_vstream_loadfile2(filepath, &size);
+	if (addr == NULL || size <= 0) {
+		acl_msg_error("%s(%d): load %s error(%s)",
+			myname, __LINE__, filepath, acl_last_serror());
+		if (addr)
+			acl_myfree(addr);
+		return NULL;
+	}
+	len = (size_t) size;
+#endif
+
+	ac = (ACL_TOKEN_AC*) acl_mycalloc(1, sizeof(ACL_TOKEN_AC));
+	ac->map_addr = addr;
+	ac->map_len = len;
+
+	if (ac_attach(ac, (const char*) addr, len) < 0) {
+		acl_msg_error("%s(%d): invalid file %s", myname, __LINE__,
+			filepath);
+		acl_token_ac_free(ac);
+		return NULL;
+	}
+	return ac;
+}
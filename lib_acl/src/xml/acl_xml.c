@@ -11,6 +11,8 @@
 
 #endif
 
+#include "../private/tag_index.h"
+
 #define	LEN	ACL_VSTRING_LEN
 #define	STR	acl_vstring_str
 
@@ -18,6 +20,23 @@ ACL_XML_ATTR *acl_xml_attr_alloc(ACL_XML_NODE *node)
 {
 	ACL_XML_ATTR *attr;
 
+	if (node->xml->attr_cache) {
+		attr = (ACL_XML_ATTR*)
+			node->xml->attr_cache->pop_back(node->xml->attr_cache);
+		if (attr) {
+			ACL_VSTRING_RESET(attr->name);
+			ACL_VSTRING_RESET(attr->value);
+			ACL_VSTRING_TERMINATE(attr->name);
+			ACL_VSTRING_TERMINATE(attr->value);
+			attr->node = node;
+			attr->quote = 0;
+			attr->backslash = 0;
+			attr->part_word = 0;
+			acl_array_append(node->attr_list, attr);
+			return (attr);
+		}
+	}
+
 	if (node->xml->slice)
 		attr = (ACL_XML_ATTR*) acl_slice_pool_calloc(__FILE__, __LINE__,
 				node->xml->slice, 1, sizeof(ACL_XML_ATTR));
@@ -44,6 +63,26 @@ void acl_xml_attr_free(ACL_XML_ATTR *attr)
 		acl_myfree(attr);
 }
 
+/* ͷԻأʱԶĽѾͷ */
+
+static void attr_cache_free(ACL_XML *xml)
+{
+	ACL_XML_ATTR *attr;
+
+	while ((attr = (ACL_XML_ATTR*)
+		xml->attr_cache->pop_back(xml->attr_cache)) != NULL)
+	{
+		acl_vstring_free(attr->name);
+		acl_vstring_free(attr->value);
+		if (xml->slice)
+			acl_slice_pool_free(__FILE__, __LINE__, attr);
+		else
+			acl_myfree(attr);
+	}
+	acl_array_free(xml->attr_cache, NULL);
+	xml->attr_cache = NULL;
+}
+
 static ACL_XML_NODE *node_iter_head(ACL_ITER *it, ACL_XML_NODE *node)
 {
 	ACL_RING *ring_ptr;
@@ -128,7 +167,17 @@ static void acl_xml_node_reset(ACL_XML_NODE *node)
 
 	node->id = NULL;
 
-	if (node->attr_list)
+	if (node->attr_list && node->xml->attr_cache) {
+		ACL_XML_ATTR *attr;
+
+		/* Զ뻺أԱ½㸴 */
+		while ((attr = (ACL_XML_ATTR*)
+			node->attr_list->pop_back(node->attr_list)) != NULL)
+		{
+			node->xml->attr_cache->push_back(
+				node->xml->attr_cache, attr);
+		}
+	} else if (node->attr_list)
 		acl_array_clean(node->attr_list,
 			(void (*)(void*)) acl_xml_attr_free);
 	node->parent = NULL;
@@ -208,6 +257,7 @@ int acl_xml_node_delete(ACL_XML_NODE *node)
 	}
 
 	node->xml->node_cnt--;
+	node->xml->tag_dirty = 1;
 	if (node->id != NULL)
 		acl_htable_delete(node->xml->id_table, STR(node->id), NULL);
 	if (node->xml->node_cache &&
@@ -229,12 +279,18 @@ void acl_xml_node_append(ACL_XML_NODE *node1, ACL_XML_NODE *node2)
 	*/
 		acl_ring_append(&node1->node, &node2->node);
 	node2->parent = node1->parent;
+	node2->xml->tag_dirty = 1;
 }
 
 void acl_xml_node_add_child(ACL_XML_NODE *parent, ACL_XML_NODE *child)
 {
 	acl_ring_prepend(&parent->children, &child->node);
 	child->parent = parent;
+	/* ½Ľޱǩڱǩʱż
+	 * бǩӽĽеλòҪؽ
+	 */
+	if (LEN(child->ltag) > 0 || acl_ring_size(&child->children) > 0)
+		child->xml->tag_dirty = 1;
 }
 
 ACL_XML_NODE *acl_xml_node_parent(ACL_XML_NODE *node)
@@ -448,6 +504,7 @@ ACL_XML *acl_xml_alloc1(ACL_SLICE_POOL *slice)
 void acl_xml_foreach_init(ACL_XML *xml, ACL_XML_NODE *node)
 {
 	xml->root = node;
+	xml->tag_dirty = 1;
 	xml->iter_head = xml_iter_head;
 	xml->iter_next = xml_iter_next;
 	xml->iter_tail = xml_iter_tail;
@@ -468,12 +525,87 @@ void acl_xml_cache(ACL_XML *xml, int max_cache)
 		xml->node_cache = NULL;
 		xml->max_cache = 0;
 	}
+	if (xml->attr_cache != NULL)
+		attr_cache_free(xml);
 	if (max_cache > 0) {
 		xml->node_cache = acl_array_create(max_cache);
+		xml->attr_cache = acl_array_create(max_cache);
 		xml->max_cache = max_cache;
 	}
 }
 
+/* ʼǩǰǰıǩвɽڱǩ
+ * ʱ
+ */
+
+static int tag_parsing(ACL_XML *xml, ACL_XML_NODE *node)
+{
+	if (node != xml->curr_node)
+		return (0);
+
+	switch (node->status) {
+	case ACL_XML_S_NXT:
+	case ACL_XML_S_LLT:
+	case ACL_XML_S_LCH:
+	case ACL_XML_S_LEM:
+	case ACL_XML_S_LTAG:
+	case ACL_XML_S_MTAG:
+		return (1);
+	default:
+		return (0);
+	}
+}
+
+/* ޸ĺĵ˳һνؽǩ */
+
+static void tag_index_build(ACL_XML *xml)
+{
+	ACL_ITER iter;
+
+	tag_index_reset(xml->tag_table);
+	acl_foreach(iter, xml) {
+		ACL_XML_NODE *node = (ACL_XML_NODE*) iter.data;
+
+		if (!tag_parsing(xml, node))
+			tag_index_add(xml->tag_table, STR(node->ltag), node);
+	}
+	xml->tag_dirty = 0;
+}
+
+void acl_xml_index(ACL_XML *xml, int on)
+{
+	if (on) {
+		if (xml->tag_table == NULL) {
+			xml->flag |= ACL_XML_FLAG_TAG_INDEX;
+			xml->tag_table = tag_index_create();
+			tag_index_build(xml);
+		}
+		return;
+	}
+
+	xml->flag &= ~ACL_XML_FLAG_TAG_INDEX;
+	if (xml->tag_table != NULL) {
+		tag_index_free(xml->tag_table);
+		xml->tag_table = NULL;
+	}
+}
+
+void acl_xml_index_add(ACL_XML *xml, ACL_XML_NODE *node)
+{
+	if (xml->tag_table != NULL && !xml->tag_dirty)
+		tag_index_add(xml->tag_table, STR(node->ltag), node);
+}
+
+ACL_ARRAY *acl_xml_index_lookup(ACL_XML *xml, const char *tag)
+{
+	if (xml->tag_table == NULL)
+		acl_xml_index(xml, 1);
+	else if (xml->tag_dirty)
+		tag_index_build(xml);
+
+	return (tag_index_find(xml->tag_table, tag));
+}
+
 void acl_xml_cache_free(ACL_XML *xml)
 {
 	if (xml->node_cache != NULL) {
@@ -482,6 +614,8 @@ void acl_xml_cache_free(ACL_XML *xml)
 		xml->node_cache = NULL;
 		xml->max_cache = 0;
 	}
+	if (xml->attr_cache != NULL)
+		attr_cache_free(xml);
 }
 
 int acl_xml_free(ACL_XML *xml)
@@ -499,9 +633,13 @@ int acl_xml_free(ACL_XML *xml)
 	xml->node_cnt--;
 	acl_assert(xml->node_cnt == 0);
 	acl_htable_free(xml->id_table, NULL);
+	if (xml->tag_table != NULL)
+		tag_index_free(xml->tag_table);
 	if (xml->node_cache != NULL)
 		acl_array_free(xml->node_cache,
 			(void (*)(void*)) acl_xml_node_free);
+	if (xml->attr_cache != NULL)
+		attr_cache_free(xml);
 	if (xml->slice)
 		acl_slice_pool_free(__FILE__, __LINE__, xml);
 	else
@@ -531,7 +669,11 @@ void acl_xml_reset(ACL_XML *xml)
 			myname, __LINE__, xml->node_cnt);
 
 	acl_htable_reset(xml->id_table, NULL);
+	if (xml->tag_table != NULL)
+		tag_index_reset(xml->tag_table);
+	xml->tag_dirty = 0;
 	xml->curr_node = NULL;
+	xml->depth = 0;
 }
 
 int acl_xml_is_closure(ACL_XML *xml)
@@ -26,6 +26,81 @@
 #define SKIP_WHILE(cond, ptr) { while(*(ptr) && (cond)) (ptr)++; }
 #define SKIP_SPACE(ptr) { while(IS_SPACE(*(ptr))) (ptr)++; }
 
+/*
+ * ıǩֵͨϳֽھ״ֽ̬׷ӵĿϴ
+ * ҳһҪ״ֽ̬( '<''>'šתհ׷)
+ * ֮ǰ׷ӣʱ SSE2 ָÿαȽ 16 ֽڣھ
+ * β '\0'  16 ֽʱȡʣಿֽڱȽϣԲ
+ * ȡ֮ڴ
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define XML_USE_SSE2
+#endif
+
+#define	SCAN_LT		"<"
+#define	SCAN_TAG	">\x20\t\r\n"
+#define	SCAN_NAME	"=\x20\t\r\n"
+#define	SCAN_VALUE	">\\\x20\t\r\n"
+
+#ifdef XML_USE_SSE2
+
+static int bit_ctz(unsigned x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(x);
+#else
+	int   n = 0;
+
+	while ((x & 1) == 0) {
+		n++;
+		x >>= 1;
+	}
+	return n;
+#endif
+}
+
+#endif
+
+/*
+ *  data ʼһ set ϻΪ '\0' ֽλãset  6 ֽڣ
+ * end Ϊνݽβ '\0' λ
+ */
+
+static const char *scan_chars(const char *data, const char *end,
+	const char *set)
+{
+#ifdef XML_USE_SSE2
+	__m128i pat[6], blk, hit;
+	unsigned mask;
+	int   i, n = 0;
+
+	while (set[n] != 0 && n < 6) {
+		pat[n] = _mm_set1_epi8(set[n]);
+		n++;
+	}
+
+	while (end - data >= 16) {
+		blk = _mm_loadu_si128((const __m128i*) data);
+		hit = _mm_cmpeq_epi8(blk, pat[0]);
+		for (i = 1; i < n; i++)
+			hit = _mm_or_si128(hit,
+				_mm_cmpeq_epi8(blk, pat[i]));
+		mask = (unsigned) _mm_movemask_epi8(hit);
+		if (mask != 0)
+			return data + bit_ctz(mask);
+		data += 16;
+	}
+#else
+	(void) end;
+#endif
+
+	while (*data != 0 && strchr(set, *data) == NULL)
+		data++;
+	return data;
+}
+
 /* ״̬ݽṹ */
 
 struct XML_STATUS_MACHINE {
@@ -36,7 +111,7 @@ struct XML_STATUS_MACHINE {
 static const char *xml_parse_next_left_lt(ACL_XML *xml, const char *data)
 {
 	SKIP_SPACE(data);
-	SKIP_WHILE(*data != '<', data);
+	data = scan_chars(data, xml->data_end, SCAN_LT);
 	if (*data == 0)
 		return (NULL);
 	data++;
@@ -127,6 +202,8 @@ static const char *xml_parse_meta_tag(ACL_XML *xml, const char *data)
 		data++;
 		if (IS_SPACE(ch)) {
 			xml->curr_node->status = ACL_XML_S_MTXT;
+			ACL_VSTRING_TERMINATE(xml->curr_node->ltag);
+			acl_xml_index_add(xml, xml->curr_node);
 			break;
 		}
 		ADDCH(xml->curr_node->ltag, ch);
@@ -365,9 +442,20 @@ static const char *xml_parse_left_tag(ACL_XML *xml, const char *data)
 	}
 
 	while ((ch = *data) != 0) {
+		const char *end = scan_chars(data, xml->data_end, SCAN_TAG);
+
+		if (end > data) {
+			acl_vstring_memcat(xml->curr_node->ltag, data, end - data);
+			xml->curr_node->last_ch = end[-1];
+			data = end;
+			continue;
+		}
+
 		data++;
 		if (ch == '>') {
 			xml->curr_node->status = ACL_XML_S_LGT;
+			/* ȽǩַжǷΪҶڵԹرսڵ */
+			ACL_VSTRING_TERMINATE(xml->curr_node->ltag);
 			xml_parse_check_self_closed(xml);
 			if ((xml->curr_node->flag & ACL_XML_F_SELF_CL)
 				&& xml->curr_node->last_ch == '/')
@@ -376,17 +464,18 @@ static const char *xml_parse_left_tag(ACL_XML *xml, const char *data)
 					LEN(xml->curr_node->ltag) - 1);
 			}
 			break;
-		} else if (IS_SPACE(ch)) {
+		} else {
 			xml->curr_node->status = ACL_XML_S_ATTR;
 			xml->curr_node->last_ch = ch;
 			break;
-		} else {
-			ADDCH(xml->curr_node->ltag, ch);
-			xml->curr_node->last_ch = ch;
 		}
 	}
 
 	ACL_VSTRING_TERMINATE(xml->curr_node->ltag);
+
+	/* ǩϣĵ˳򽫽ǩ */
+	if (xml->curr_node->status != ACL_XML_S_LTAG)
+		acl_xml_index_add(xml, xml->curr_node);
 	return (data);
 }
 
@@ -424,14 +513,21 @@ static const char *xml_parse_attr(ACL_XML *xml, const char *data)
 	}
 
 	while ((ch = *data) != 0) {
+		const char *end = scan_chars(data, xml->data_end, SCAN_NAME);
+
+		if (end > data) {
+			acl_vstring_memcat(attr->name, data, end - data);
+			xml->curr_node->last_ch = end[-1];
+			data = end;
+			continue;
+		}
+
 		xml->curr_node->last_ch = ch;
 		if (ch == '=') {
 			xml->curr_node->status = ACL_XML_S_AVAL;
 			data++;
 			break;
 		}
-		if (!IS_SPACE(ch))
-			ADDCH(attr->name, ch);
 		data++;
 	}
 
@@ -478,14 +574,25 @@ static const char *xml_parse_attr_val(ACL_XML *xml, const char *data)
 			else
 				attr->backslash = 1;
 		} else if (attr->quote) {
+			char  set[3];
+			const char *end;
+
 			if (ch == attr->quote) {
 				xml->curr_node->status = ACL_XML_S_ATTR;
 				xml->curr_node->last_ch = ch;
 				data++;
 				break;
 			}
-			ADDCH(attr->value, ch);
-			xml->curr_node->last_ch = ch;
+
+			/* ׷һŻת֮ǰ */
+			set[0] = (char) attr->quote;
+			set[1] = '\\';
+			set[2] = 0;
+			end = scan_chars(data, xml->data_end, set);
+			acl_vstring_memcat(attr->value, data, end - data);
+			xml->curr_node->last_ch = end[-1];
+			data = end;
+			continue;
 		} else if (ch == '>') {
 			xml->curr_node->status = ACL_XML_S_LGT;
 			xml_parse_check_self_closed(xml);
@@ -496,6 +603,14 @@ static const char *xml_parse_attr_val(ACL_XML *xml, const char *data)
 			xml->curr_node->last_ch = ch;
 			data++;
 			break;
+		} else if (!(xml->flag & ACL_XML_FLAG_PART_WORD)) {
+			/* ݰʱֽжϣ׷ */
+			const char *end = scan_chars(data, xml->data_end, SCAN_VALUE);
+
+			acl_vstring_memcat(attr->value, data, end - data);
+			xml->curr_node->last_ch = end[-1];
+			data = end;
+			continue;
 		} else {
 			ADDCH(attr->value, ch);
 			xml->curr_node->last_ch = ch;
@@ -546,13 +661,16 @@ static const char *xml_parse_text(ACL_XML *xml, const char *data)
 	}
 
 	while ((ch = *data) != 0) {
+		const char *end;
+
 		if (ch == '<') {
 			xml->curr_node->status = ACL_XML_S_RLT;
 			data++;
 			break;
 		}
-		ADDCH(xml->curr_node->text, ch);
-		data++;
+		end = scan_chars(data, xml->data_end, SCAN_LT);
+		acl_vstring_memcat(xml->curr_node->text, data, end - data);
+		data = end;
 	}
 
 	ACL_VSTRING_TERMINATE(xml->curr_node->text);
@@ -695,15 +813,20 @@ static const char *xml_parse_right_tag(ACL_XML *xml, const char *data)
 	}
 
 	while ((ch = *data) != 0) {
+		const char *end;
+
 		if (ch == '>') {
 			curr_node->status = ACL_XML_S_RGT;
 			data++;
 			break;
 		}
-
-		if (!IS_SPACE(ch))
-			ADDCH(curr_node->rtag, ch);
-		data++;
+		if (IS_SPACE(ch)) {
+			data++;
+			continue;
+		}
+		end = scan_chars(data, xml->data_end, SCAN_TAG);
+		acl_vstring_memcat(curr_node->rtag, data, end - data);
+		data = end;
 	}
 
 	ACL_VSTRING_TERMINATE(curr_node->rtag);
@@ -755,6 +878,9 @@ void acl_xml_update(ACL_XML *xml, const char *data)
 {
 	const char *ptr = data;
 
+	if (data != NULL)
+		xml->data_end = data + strlen(data);
+
 	/* XML ״̬ѭ */
 
 	while (ptr && *ptr) {
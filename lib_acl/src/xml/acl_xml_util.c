@@ -70,8 +70,13 @@ void acl_xml_free_array(ACL_ARRAY *a)
 ACL_ARRAY *acl_xml_getElementsByTagName(ACL_XML *xml, const char *tag)
 {
 	ACL_ITER iter;
-	ACL_ARRAY *a = acl_array_create(10);
+	ACL_ARRAY *a;
+
+	/* 򿪱ǩʱֱӷڵĽ飬ر */
+	if ((xml->flag & ACL_XML_FLAG_TAG_INDEX))
+		return (acl_xml_index_lookup(xml, tag));
 
+	a = acl_array_create(10);
 	acl_foreach(iter, xml) {
 		ACL_XML_NODE *node = (ACL_XML_NODE*) iter.data;
 		if (strcasecmp(tag, STR(node->ltag)) == 0) {
@@ -92,6 +97,7 @@ ACL_ARRAY *acl_xml_getElementsByTags(ACL_XML *xml, const char *tags)
 	ACL_ARGV *tokens = acl_argv_split(tags, "/");
 	ACL_ARRAY *a, *ret;
 	ACL_ITER iter;
+	int   indexed = xml->flag & ACL_XML_FLAG_TAG_INDEX;
 
 	a = acl_xml_getElementsByTagName(xml, tokens->argv[tokens->argc - 1]);
 	if (a == NULL) {
@@ -116,7 +122,8 @@ ACL_ARRAY *acl_xml_getElementsByTags(ACL_XML *xml, const char *tags)
 			ret->push_back(ret, node);
 	}
 
-	acl_xml_free_array(a);
+	if (!indexed)
+		acl_xml_free_array(a);
 	acl_argv_free(tokens);
 
 	if (acl_array_size(ret) == 0) {
@@ -9,7 +9,7 @@ class connect_pool;
 class ACL_CPP_API connect_client
 {
 public:
-	connect_client() : when_(0), pool_(NULL) {}
+	connect_client() : when_(0), pool_(NULL), next_(NULL), begin_(0) {}
 	virtual ~connect_client() {}
 
 	/**
@@ -35,6 +35,17 @@ public:
 	 */
 	virtual bool open() = 0;
 
+	/**
+	 * 麯ʵִ˺̽ǷȻ(緢 PING
+	 * ) connect_pool::check_dead ں̨ã false ʱ
+	 * رգȱʡΪǿõ
+	 * @return {bool} Ƿ
+	 */
+	virtual bool alive()
+	{
+		return true;
+	}
+
 	/**
 	 * ӳضã connect_pool ڲ
 	 * Ӷ set_pool ӳض
@@ -50,6 +61,8 @@ private:
 
 	time_t when_;
 	connect_pool* pool_;
+	connect_client* next_;		// ӳؿջеһ
+	long long begin_;		//  peek ʱʱ(΢)ͳӳ
 
 	void set_pool(connect_pool* pool)
 	{
@@ -3,6 +3,8 @@
 #include "acl_cpp/stdlib/string.hpp"
 #include "acl_cpp/stdlib/locker.hpp"
 #include <vector>
+#include <map>
+#include <utility>
 
 struct ACL_EVENT;
 
@@ -12,6 +14,26 @@ namespace acl
 class connect_pool;
 class connect_monitor;
 
+/**
+ * ֵӳؼȺѡȡӳʱõĹϣʽ
+ */
+typedef enum
+{
+	CONNECT_HASH_MOD,	// crc32(key) % ӳظȱʡʽ
+	CONNECT_HASH_KETAMA,	//  ketama һԹϣ
+	CONNECT_HASH_JUMP,	// jump һԹϣ
+	CONNECT_HASH_RENDEZVOUS,// Ȩص rendezvous(Ȩ)ϣ
+} connect_hash_t;
+
+/**
+ * ֵӳؼȺѡȡӳʱĸؾⷽʽ
+ */
+typedef enum
+{
+	CONNECT_BALANCE_ROUND_ROBIN,	// ѭȱʡʽ
+	CONNECT_BALANCE_P2C,		// ѡȡӳأȡؽϵ
+} connect_balance_t;
+
 /**
  * connect pool лȡӳصȹ
  */
@@ -51,6 +73,65 @@ public:
 	 */
 	void set_retry_inter(int n);
 
+	/**
+	 * ӳÿ߳̿ɻĿӸޣ֮ӵӳ
+	 * ͬЧμ connect_pool::set_thread_cache
+	 * @param max {size_t} Ϊ 0 ʱʾ̻߳
+	 */
+	void set_thread_cache(size_t max);
+
+	/**
+	 * ӳٱֵĿӸ֮ӵӳͬЧ
+	 *  connect_monitor ɺ̨̲߳㣬μ connect_pool::set_min_idle
+	 * @param n {int} Ϊ 0 ʱʾ
+	 */
+	void set_min_idle(int n);
+
+	/**
+	 * ΪеӳԤȽӣһڷ󡢽ǰã
+	 * ڵ߳нУӳؼȺμ connect_pool::prewarm
+	 * @param n {int} ÿӳ½ĿӸ<= 0 ʱ set_min_idle
+	 *  ĸ
+	 * @return {int} ɹ
+	 */
+	int prewarm(int n = 0);
+
+	/**
+	 *  peek() ѡȡӳʱĸؾⷽʽúڳʱã
+	 * ڲԶCONNECT_BALANCE_P2C ʽῪӳصĸͳ(μ
+	 * connect_pool::set_track_load)ÿѡȡõӳأȡ;
+	 * ӳٵָȨƶƽֵ(EWMA)֮ϵߣʹķԶֵ
+	 * ٵͬʱ set_outlier ժ쳣ķ
+	 * @param type {connect_balance_t}
+	 */
+	void set_balance(connect_balance_t type);
+
+	/**
+	 * õǰĸؾⷽʽ
+	 * @return {connect_balance_t}
+	 */
+	connect_balance_t get_balance() const
+	{
+		return balance_;
+	}
+
+	/**
+	 *  CONNECT_BALANCE_P2C ʽ쳣ժÿһΣ
+	 * ժķժʱڲᱻ peek() ѡУ֮ڻָʱֵõ
+	 * ֱָժʱժʱ䰴ɱ
+	 * @param max_failures {int} ʧܴﵽֵʱժ<= 0 ʱʧ
+	 *  ժȱʡֵΪ 5
+	 * @param latency_factor {double} ӳٳзӳλĸñʱ
+	 *  ժ( 3 ӳٲʱż)<= 0 ʱӳժȱʡ
+	 *  ֵΪ 3.0
+	 * @param eject_time {int} ״ժʱ()ȱʡֵΪ 10
+	 * @param recover_time {int} ժ𲽻ָʱ()ȱʡֵΪ 30
+	 * @param max_percent {int} ͬʱժķռİٷֱޣ
+	 *  ȱʡֵΪ 50
+	 */
+	void set_outlier(int max_failures, double latency_factor,
+		int eject_time = 10, int recover_time = 30, int max_percent = 50);
+
 	/**
 	 * ӳؼȺɾĳַӳأúڳй
 	 * ãΪڲԶ
@@ -71,9 +152,9 @@ public:
 		bool restore = false);
 
 	/**
-	 * ӳؼȺлһӳأúѭʽӳؼлȡһ
-	 * ˷ӳأӶ֤ȫľԣúڲԶӳع
-	 * м
+	 * ӳؼȺлһӳأúȱʡѭʽӳؼлȡ
+	 * һ˷ӳأӶ֤ȫľԣҲͨ set_balance
+	 * лΪѡȡúڲԶӳعм
 	 * ⣬úΪӿڣʵԼѭʽ
 	 * @return {connect_pool*} һӳأָԶǿ
 	 */
@@ -82,7 +163,8 @@ public:
 	/**
 	 * ӳؼȺлһӳأúùϣλʽӼлȡһ
 	 * ˷ӳأش麯ԼļȺȡʽ
-	 * 麯ڲȱʡ CRC32 Ĺϣ㷨
+	 * 麯ڲȱʡ CRC32 ȡģĹϣ㷨ͨ set_key_hash л
+	 * ΪһԹϣʽ
 	 * @param key {const char*} ֵֵַΪ NULLڲ
 	 *  Զлѭʽ
 	 * @param exclusive {bool} ǷҪӳ飬Ҫ̬
@@ -91,6 +173,38 @@ public:
 	 */
 	virtual connect_pool* peek(const char* key, bool exclusive = true);
 
+	/**
+	 *  peek(key) ֵѡȡӳʱĹϣʽúڳʱ
+	 * ãڲԶ CONNECT_HASH_MOD ⣬ʽɾʱ
+	 * ֻԼ 1/N ļֵᱻӳ䣬ĳӳزʱӳص
+	 * ֵתӳأֵӳϵֲ
+	 * עCONNECT_HASH_JUMP ӳڼе±㣬ֻڼβ
+	 * ɾʱܱ֤ٵӳ䣬ketama  rendezvous ʽ
+	 * ַ㣬ɾ˳޹
+	 * @param type {connect_hash_t} ϣʽ
+	 * @param vnodes {int} ketama ʽȨΪ 1 ķڹϣϵ
+	 *  ԽֲԽȣϣռõڴҲԽ
+	 */
+	void set_key_hash(connect_hash_t type, int vnodes = 160);
+
+	/**
+	 * õǰֵѡȡӳʱĹϣʽ
+	 * @return {connect_hash_t}
+	 */
+	connect_hash_t get_key_hash() const
+	{
+		return hash_type_;
+	}
+
+	/**
+	 * ĳȨأȨԽֵõļֵԽ࣬ CONNECT_HASH_KETAMA
+	 *  CONNECT_HASH_RENDEZVOUS ʽЧڵ set ӷ֮ǰ
+	 * ãڲԶ
+	 * @param addr {const char*} ַ(ip:port)
+	 * @param weight {unsigned} ȨأȱʡֵΪ 1Ϊ 0 ʱ 1 
+	 */
+	void set_weight(const char* addr, unsigned weight);
+
 	/**
 	 * û peek ʱԵô˺ӳع̼
 	 */
@@ -130,7 +244,7 @@ public:
 	}
 
 	/**
-	 * ӡǰ redis ӳصķ
+	 * ӡǰӳصķ
 	 */
 	void statistics();
 
@@ -178,10 +292,42 @@ private:
 	locker lock_;				//  pools_ ʱĻ
 	int  stat_inter_;			// ͳƷĶʱ
 	int  retry_inter_;			// ӳʧܺԵʱ
+	size_t thread_cache_;			// ÿ̻߳ĿӸ
+	int  min_idle_;				// ÿӳٱֵĿӸ
+
+	connect_balance_t balance_;		// ֵѡȡӳصķʽ
+	unsigned long long rand_;		// ѡȡӳص״̬
+	int   max_failures_;			// ժǰʧܴ
+	double latency_factor_;			// ժʱӳλı
+	int   eject_time_;			// ״ժʱ()
+	int   recover_time_;			// ժ𲽻ָʱ()
+	int   max_eject_percent_;		// ͬʱժķİٷֱ
+	time_t last_outlier_check_;		// ϴμ쳣ʱ
+	double avg_latency_;			// ӳٵƽֵ()
 	connect_monitor* monitor_;		// ̨߳̾
 
+	connect_hash_t hash_type_;		// ֵѡȡӳصĹϣʽ
+	int  vnodes_;				// ketama ʽµ
+	std::map<string, unsigned> weights_;	// Ȩ
+	// ketama ϣϣֵ
+	std::vector<std::pair<unsigned, connect_pool*> > ring_;
+	// rendezvous ʽ pools_ һһӦķַϣֵȨ
+	std::vector<std::pair<unsigned long long, unsigned> > nodes_;
+
 	// óȱʡ֮ķȺ
 	void set_service_list(const char* addr_list, int count);
+
+	// ӳؼϻϣʽıؽϣݣѼ
+	void rebuild_hash();
+	unsigned get_weight(const char* addr) const;
+
+	connect_pool* peek_ketama(const char* key) const;
+	connect_pool* peek_jump(const char* key) const;
+	connect_pool* peek_rendezvous(const char* key) const;
+
+	connect_pool* peek_round_robin();
+	connect_pool* peek_p2c();
+	void check_outliers(time_t now);
 };
 
 } // namespace acl
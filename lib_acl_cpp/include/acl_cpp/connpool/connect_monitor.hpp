@@ -13,6 +13,7 @@ class connect_manager;
 class rpc_service;
 class socket_stream;
 class aio_socket_stream;
+class thread_pool;
 
 class ACL_CPP_API connect_monitor : public thread
 {
@@ -50,6 +51,25 @@ public:
 	 */
 	connect_monitor& set_conn_timeout(int n);
 
+	/**
+	 * άӳؿӵ̳߳е߳߳ڷȷ
+	 * ɸ̳߳زнӣԲӳصٿ
+	 * (μ connect_pool::set_min_idle)ͬʱڸ̳߳жԿӽб
+	 * ̽⣻ڼ߳ǰãȱʡֵΪ 10
+	 * @param n {int} ߳
+	 * @return {connect_monitor&}
+	 */
+	connect_monitor& set_keep_threads(int n);
+
+	/**
+	 * öӳпӽб̽ʱÿν̽ʱ䲻
+	 * ֵ(μ connect_pool::check_dead)̳̽߳нУռ
+	 * 
+	 * @param n {int} ʱ()Ϊ 0 ʱ̽⣬ȱʡֵΪ 0
+	 * @return {connect_monitor&}
+	 */
+	connect_monitor& set_keepalive_inter(int n);
+
 	/**
 	 * ֹͣ߳
 	 * @param graceful {bool} Ƿعرռ̣Ϊ true
@@ -103,6 +123,17 @@ public:
 	 */
 	void on_open(check_client& checker);
 
+	/**
+	 * ȷϷô˺÷ӳеĿ
+	 * @param addr {const char*} ַ
+	 */
+	void keep_conns(const char* addr);
+
+	/**
+	 * ⶨʱÿδʱô˺ʱԿӽб̽
+	 */
+	void on_timer();
+
 protected:
 	// ി麯
 	virtual void* run();
@@ -115,6 +146,10 @@ private:
 	int   check_inter_;			// ӳ״̬ʱ()
 	int   conn_timeout_;			// ӷĳʱʱ
 	rpc_service* rpc_service_;		// 첽 RPC ͨŷ
+	thread_pool* threads_;			// άӳؿӵ̳߳
+	int   keep_threads_;			// ̳߳е߳
+	int   keepalive_inter_;			// ̽ʱ()
+	time_t last_keepalive_;			// ϴα̽ʱ
 };
 
 } // namespace acl
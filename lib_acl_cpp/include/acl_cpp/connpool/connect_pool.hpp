@@ -1,6 +1,6 @@
 #pragma once
 #include "acl_cpp/acl_cpp_define.hpp"
-#include <list>
+#include <vector>
 #include "acl_cpp/stdlib/locker.hpp"
 
 namespace acl
@@ -8,6 +8,7 @@ namespace acl
 
 class connect_manager;
 class connect_client;
+class conn_cache;
 
 /**
  * ͻӳ࣬ʵֶӳصĶ̬Ϊ࣬Ҫʵ
@@ -48,6 +49,64 @@ public:
 	 */
 	connect_pool& set_idle_ttl(time_t ttl);
 
+	/**
+	 * ÿ߳̿ɻıӳؿӵĸޣ̹߳黹ȷ
+	 * ̵߳ĻУٴλȡʱҲȴлȡӶ߳Ƶӳ
+	 * ӳصﵽʱ̻߳Ŀӣ߳˳
+	 * ʱ仺ӻ黹ӳأδñʱȱʡֵΪ 0̻߳
+	 * @param max {size_t} ÿ̻߳ĿӸޣΪ 0 ʱʾ
+	 * @return {connect_pool&}
+	 */
+	connect_pool& set_thread_cache(size_t max);
+
+	/**
+	 * ǷͳƱӳص;ӳ٣ͳΪ peek 
+	 *  put 黹ӣӳؼȺĸؾ⼰쳣ժÿ
+	 * peek/put ͳֵһδñʱȱʡͳ
+	 * @param on {bool}
+	 * @return {connect_pool&}
+	 */
+	connect_pool& set_track_load(bool on);
+
+	/**
+	 * ӳٱֵĿӸ connect_monitor ̨ʱ
+	 * ߳ȷϷ󣬻̳߳внԲӣ
+	 * Ӷϻָ peek ͬӣҲ
+	 *  prewarm ͬ㣻δñʱȱʡֵΪ 0
+	 * @param n {int} ٿӸӳ
+	 * @return {connect_pool&}
+	 */
+	connect_pool& set_min_idle(int n);
+
+	/**
+	 *  set_min_idle õٿӸ
+	 * @return {int}
+	 */
+	int get_min_idle() const
+	{
+		return min_idle_;
+	}
+
+	/**
+	 * ԤȽӲӳУӹڵ߳нУ
+	 * ӳصӰ̵߳ peek/putʧʱӳػᱻΪ
+	 * ״̬
+	 * @param n {int} ϣ½ĿӸ<= 0 ʱ set_min_idle
+	 *  ĸӳ
+	 * @return {int} ɹӸ
+	 */
+	int prewarm(int n = 0);
+
+	/**
+	 * ӳеĿӽб̽(μ connect_client::alive)
+	 * ӽرգ̽Уһ connect_monitor ں̨߳
+	 * еãռ̣̻߳еӲ̽
+	 * @param ttl {time_t} ̽ʱ䲻ڸֵ()ӣΪ 0 ʱ̽
+	 *  еĿ
+	 * @return {int} رյӸ
+	 */
+	int check_dead(time_t ttl = 0);
+
 	/**
 	 * ӳгԻȡһӣáϴη쳣ʱ
 	 * δڻӳӸﵽ򽫷 NULLһµ
@@ -67,7 +126,8 @@ public:
 	/**
 	 * ӳпеӣڵͷŵ
 	 * @param ttl {time_t} ʱֵӽͷ
-	 * @param exclusive {bool} ڲǷҪ
+	 * @param exclusive {bool} ڲǷҪΪ false ʱʾѳ
+	 *  ӳصʱ̻߳еĿ
 	 * @return {int} ͷŵĿӸ
 	 */
 	int check_idle(time_t ttl, bool exclusive = true);
@@ -145,10 +205,104 @@ public:
 		return current_used_;
 	}
 
+	/**
+	 * ӳ( peek  put)ָȨƶƽֵ()޲ʱ
+	 *  0 set_track_load ͳ
+	 * @return {double}
+	 */
+	double get_latency() const
+	{
+		return latency_;
+	}
+
+	/**
+	 * õǰ;ѱ peek δ put Ӹ
+	 * @return {int}
+	 */
+	int get_inflight() const
+	{
+		return inflight_;
+	}
+
+	/**
+	 * ӳصĸ֣Ϊӳٵƶƽֵ(; + 1)֮
+	 * һʱûв򷵻 0 ʹý㱻̽
+	 * @return {double}
+	 */
+	double get_load();
+
+	/**
+	 * ʧܵĴ put(conn, false) 黹Ϊһʧܣ
+	 * put(conn, true) 黹ʱ
+	 * @return {int}
+	 */
+	int get_failures() const
+	{
+		return failures_;
+	}
+
+	/**
+	 * жϸӳصǰǷ쳣ӳؼȺʱժ
+	 * @return {bool}
+	 */
+	bool is_ejected() const
+	{
+		return ejected_until_ > 0 && time(NULL) < ejected_until_;
+	}
+
+	/**
+	 * ӳعпӵĸ̻߳
+	 * @return {size_t}
+	 */
+	size_t get_idle_count() const
+	{
+		return idle_count_;
+	}
+
+	/**
+	 *  peek/put жӳؼĴ̻߳
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_lock_count() const
+	{
+		return lock_count_;
+	}
+
+	/**
+	 *  peek/put мʱ(ѱ̳߳)Ĵ
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_lock_contended() const
+	{
+		return lock_contended_;
+	}
+
+	/**
+	 *  peek/put ȴʱ(΢)
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_lock_wait() const
+	{
+		return lock_wait_;
+	}
+
+	/**
+	 * ôֱ̻߳ӻӵĴֵÿۻһźϲһΣ
+	 * ͺ
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_cache_hits() const
+	{
+		return cache_hits_;
+	}
+
 protected:
 	virtual connect_client* create_connect() = 0;
 
 	friend class connect_manager;
+	friend class connect_monitor;
+	friend class conn_cache;
+	friend class keep_job;
 
 	/**
 	 * øӳضΪӳ٣ڲüΪ 0 ʱ
@@ -170,11 +324,58 @@ protected:
 	time_t last_check_;			// ϴμӵʱ
 	int   check_inter_;			// ӵʱ
 
-	locker lock_;				//  pool_ ʱĻ
+	locker lock_;				// ʿջȳԱʱĻ
 	unsigned long long total_used_;		// ӳصз
 	unsigned long long current_used_;	// ĳʱڵķ
 	time_t last_;				// ϴμ¼ʱ
-	std::list<connect_client*> pool_;	// ӳؼ
+	connect_client* idle_;			// ջͨӶ
+	size_t idle_count_;			// ջеӸ
+	size_t cache_max_;			// ÿ̻߳ĿӸ
+	std::vector<conn_cache*> caches_;	// ˱ӳӵ̻߳
+	unsigned long long lock_count_;		// peek/put Ĵ
+	unsigned long long lock_contended_;	// ʱĴ
+	unsigned long long lock_wait_;		// ȴʱ(΢)
+	unsigned long long cache_hits_;		// ̻߳Ĵ
+
+	bool  track_load_;			// Ƿͳ;ӳ
+	int   inflight_;			// ;
+	double latency_;			// ӳٵƶƽֵ()
+	time_t last_sample_;			// ϴβʱ
+	int   failures_;			// ʧܵĴ
+	int   ejections_;			// ժĴ
+	time_t ejected_until_;			// ժ״̬Ľֹʱ
+	time_t recover_until_;			// ժ𲽻ָĽֹʱ
+	locker stat_lock_;			// ͳֵ lock_ 
+
+	int   min_idle_;			// ٱֵĿӸ
+	int   warming_;				// ԤδϵĿӸ
+	int   refers_;				// ̨Աӳصü
+
+	bool  confirmed_;			// ʧܺǷѳɹ
+	locker connect_lock_;			// δȷϷ˿ʱн
+
+private:
+	void lock_pool();
+	connect_client* peek_one();
+	void request_begin(connect_client* conn);
+	void request_end(connect_client* conn, bool ok);
+	void eject(time_t now, int eject_time, int recover_time);
+	double get_ramp(time_t now);
+	bool put_shared(connect_client* conn, bool keep, time_t now);
+	connect_client* peek_cached();
+	bool put_cached(connect_client* conn, time_t now);
+	bool attach_cache(conn_cache* cache);
+	void drain_caches(std::vector<connect_client*>& out, time_t ttl,
+		size_t max, bool detach);
+	void check_idle_timer(time_t now);
+
+	// Ϊ½ԤԤͬʱʹӳزᱻ
+	int reserve_idle(int n);
+	//  n Ԥӣسɹĸ
+	int open_reserved(int n);
+	// ̨ӳڼ䣬ӳزᱻ
+	void refer();
+	void unrefer();
 };
 
 } // namespace acl
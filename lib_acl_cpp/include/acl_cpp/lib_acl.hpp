@@ -10,6 +10,9 @@
 #include "acl_cpp/stdlib/dns_service.hpp"
 #include "acl_cpp/stdlib/final_tpl.hpp"
 #include "acl_cpp/stdlib/json.hpp"
+#include "acl_cpp/stdlib/json_reader.hpp"
+#include "acl_cpp/stdlib/json_writer.hpp"
+#include "acl_cpp/stdlib/gson_helper.hpp"
 #include "acl_cpp/stdlib/locker.hpp"
 #include "acl_cpp/stdlib/log.hpp"
 //#include "malloc.hpp"
@@ -27,6 +30,7 @@
 #include "acl_cpp/stdlib/thread_pool.hpp"
 #include "acl_cpp/stdlib/scan_dir.hpp"
 #include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/stdlib/bloom_filter.hpp"
 
 #include "acl_cpp/memcache/memcache.hpp"
 #include "acl_cpp/memcache/memcache_pool.hpp"
@@ -143,6 +147,12 @@
 #include "acl_cpp/redis/redis_list.hpp"
 #include "acl_cpp/redis/redis_pubsub.hpp"
 #include "acl_cpp/redis/redis_transaction.hpp"
+#include "acl_cpp/redis/redis_pipeline.hpp"
+#include "acl_cpp/redis/redis_batch.hpp"
+#include "acl_cpp/redis/redis_near_cache.hpp"
+#include "acl_cpp/redis/redis_subscriber.hpp"
+#include "acl_cpp/redis/aio_redis_client.hpp"
+#include "acl_cpp/redis/aio_redis_cluster.hpp"
 #include "acl_cpp/redis/redis_set.hpp"
 #include "acl_cpp/redis/redis_zset.hpp"
 #include "acl_cpp/redis/redis_script.hpp"
@@ -1,6 +1,8 @@
 #pragma once
 #include "acl_cpp/acl_cpp_define.hpp"
 #include <time.h>
+#include <map>
+#include <vector>
 #include "acl_cpp/connpool/connect_client.hpp"
 #include "acl_cpp/stdlib/string.hpp"
 #include "acl_cpp/mime/rfc2047.hpp"
@@ -192,6 +194,51 @@ public:
 	*/
 	bool del(const char* key);
 
+	/**
+	 *  memcached öֵĻݣмֵһ
+	 *  get k1 k2 ... (ֵ϶ʱֳɶһԷ)
+	 * һαне VALUE ݿ
+	 * @param keys {const std::vector<string>&} ֵϣظļֵֻѯ
+	 *  һ
+	 * @param out {std::map<string, string>&} 洢ѯԭʼֵΪ
+	 *  ڵļֵڽУڲոö
+	 * @param flags {std::map<string, unsigned short>*} ǿʱ洢ֵ
+	 *  ı־λ
+	 * @return {bool} Ƿֵڲ
+	 */
+	bool get_multi(const std::vector<string>& keys,
+		std::map<string, string>& out,
+		std::map<string, unsigned short>* flags = NULL);
+	bool get_multi(const std::vector<const char*>& keys,
+		std::map<string, string>& out,
+		std::map<string, unsigned short>* flags = NULL);
+
+	/**
+	 *  noreply ʽӻ޸ĶֵĻݣе set һ
+	 * ͣ˲ٶÿӦ
+	 * @param items {const std::map<string, string>&} ֵݵļ
+	 * @param timeout {time_t} 泬ʱʱ()
+	 * @param flags {unsigned short} ı־λ
+	 * @param sync {bool} ֮Ǹһ version Ϊ true ʱȴ
+	 *  ӦȷϷѴеΪ false ʱ꼴أ
+	 *  Ӧڴӵһβ֮ǰȡǰгӦ
+	 *  رոӺλӦ
+	 * @return {bool} Ƿɹ noreply ʱ˲صĽ
+	 *  Է true ʾѱ(sync Ϊ true ʱʾѱ
+	 *  ˴)
+	 */
+	bool set_multi(const std::map<string, string>& items,
+		time_t timeout = 0, unsigned short flags = 0, bool sync = true);
+
+	/**
+	 *  noreply ʽɾֵĻ
+	 * @param keys {const std::vector<string>&} ֵ
+	 * @param sync {bool} ͬ set_multi
+	 * @return {bool} ͬ set_multi
+	 */
+	bool del_multi(const std::vector<string>& keys, bool sync = true);
+	bool del_multi(const std::vector<const char*>& keys, bool sync = true);
+
 	/**
 	* ϴβ memcached Ϣ
 	* @return {const char*} ϢΪ
@@ -224,6 +271,19 @@ public:
 	void property_list();
 
 private:
+	friend class memcache_manager;
+
+	// ºΪ󼰶ȡӦ׶ΣԱ
+	// memcache_manager зζȡӦ
+	bool get_multi_send(const std::vector<string>& keys);
+	bool get_multi_recv(std::map<string, string>& out,
+		std::map<string, unsigned short>* flags);
+	bool set_multi_send(const std::map<string, string>& items,
+		time_t timeout, unsigned short flags, bool sync);
+	bool del_multi_send(const std::vector<string>& keys, bool sync);
+	bool sync_recv();
+	bool send_request(const string& req);
+
 	bool set(const string& key, const void* dat, size_t dlen,
 		time_t timeout, unsigned short flags);
 	bool get(const string& key, string& buf, unsigned short* flags);
@@ -248,6 +308,10 @@ private:
 	socket_stream* conn_;    // ˷Ӷ
 	string req_line_;        // 洢
 	string res_line_;        // 洢Ӧ
+	std::map<string, string> multi_keys_;  // ѯʱת KEY ԭʼ KEY ĶӦϵ
+	int   multi_cmds_;       // ѯʱ͵ get 
+	int   unsynced_;         // δȡ version Ӧ
+	bool drain_sync();
 	bool error_happen(const char* line);
 };
 
@@ -1,5 +1,9 @@
 #pragma once
 #include "acl_cpp/acl_cpp_define.hpp"
+#include <time.h>
+#include <map>
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
 #include "acl_cpp/connpool/connect_manager.hpp"
 
 namespace acl
@@ -14,6 +18,37 @@ public:
 	memcache_manager();
 	virtual ~memcache_manager();
 
+	/**
+	 * öֵĻݣֵ peek(key) Ĺϣʽ鵽
+	 * зζȡӦӶʹ
+	 * ܵĺʱӽһ
+	 * @param keys {const std::vector<string>&} ֵ
+	 * @param out {std::map<string, string>&} 洢ѯڵļֵ
+	 *  ڽ
+	 * @param flags {std::map<string, unsigned short>*} ǿʱ洢ֵ
+	 *  ı־λ
+	 * @return {bool} Ƿзɹַʱ
+	 *  ĲѯȻᱻ out 
+	 */
+	bool get_multi(const std::vector<string>& keys,
+		std::map<string, string>& out,
+		std::map<string, unsigned short>* flags = NULL);
+
+	/**
+	 *  noreply ʽӻ޸ĶֵĻݣ
+	 * зͣμ memcache::set_multi
+	 * @return {bool} Ƿзɹ
+	 */
+	bool set_multi(const std::map<string, string>& items,
+		time_t timeout = 0, unsigned short flags = 0, bool sync = true);
+
+	/**
+	 *  noreply ʽɾֵĻݣзͣ
+	 * μ memcache::del_multi
+	 * @return {bool} Ƿзɹ
+	 */
+	bool del_multi(const std::vector<string>& keys, bool sync = true);
+
 protected:
 	/**
 	 * ി麯ӳض
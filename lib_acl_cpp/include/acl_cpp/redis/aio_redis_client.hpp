@@ -0,0 +1,198 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <list>
+#include <map>
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stream/aio_socket_stream.hpp"
+
+namespace acl
+{
+
+class aio_handle;
+class dbuf_pool;
+class redis_command;
+class redis_parser;
+class redis_result;
+
+/**
+ * 첽 redis Ľص࣬ʵ result_callback 
+ * the callback class for the asynchronous redis command, the subclass
+ * should implement the result_callback method
+ */
+class ACL_CPP_API aio_redis_callback
+{
+public:
+	aio_redis_callback() {}
+	virtual ~aio_redis_callback() {}
+
+	/**
+	 * õ redis-server ӦӳʱرնʧʱĻص
+	 * ص̽ڲøûصԿڱ
+	 * ٸö󣻱ҲԹرջ aio_redis_client 
+	 * called when the command got the reply from redis-server, or failed
+	 * because of connecting error, IO timeout or closed; the callback object
+	 * won't be used again after this function returns, so it can be
+	 * destroyed in this function; the aio_redis_client object can also be
+	 * closed or destroyed in this function
+	 * @param result {const redis_result*} ӦΪ NULL ʾʧܣ
+	 *  ýڱЧ
+	 *  the reply of the command, NULL if failed; the result object is
+	 *  valid only in this function
+	 */
+	virtual void result_callback(const redis_result* result) = 0;
+};
+
+/**
+ * ڷ IO  redis ͻ࣬ͬһϿͶ
+ * صȴǰһӦÿӦ˳صԵĻص
+ *  aio_handle ͬһ߳ʹ
+ * the asynchronous redis client connection class based on non-blocking IO,
+ * many commands can be sent on one connection without waiting for the
+ * replies of the previous commands, and the replies will be passed to the
+ * callbacks in the order of sending; the object should be used in the
+ * same thread with the aio_handle
+ */
+class ACL_CPP_API aio_redis_client : public aio_open_callback
+{
+public:
+	/**
+	 * 캯
+	 * constructor
+	 * @param handle {aio_handle&} 첽¼
+	 *  the asynchronous event engine
+	 * @param addr {const char*} redis-server ַʽip:port
+	 *  the redis-server addr, such as ip:port
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout in seconds for connecting the redis-server
+	 * @param rw_timeout {int} ȴӦĳʱʱ()
+	 *  the timeout in seconds for waiting the replies
+	 */
+	aio_redis_client(aio_handle& handle, const char* addr,
+		int conn_timeout = 10, int rw_timeout = 10);
+
+	/**
+	 * ʱδررӣδõӦĻص
+	 *  NULL ص
+	 * the connection will be closed if it's opened, and all the callbacks
+	 * of the commands without reply will be called with NULL result
+	 */
+	virtual ~aio_redis_client();
+
+	/**
+	 * 첽 redis-serverһ㲻ʽãʱԶ
+	 * connect the redis-server asynchronously, it needn't be called
+	 * because the connection will be opened when sending command
+	 * @return {bool}  false ʾʧ
+	 *  false if connecting failed immediately
+	 */
+	bool open();
+
+	/**
+	 * 첽رӣδõӦ NULL ص
+	 * close the connection asynchronously, and the callbacks of the
+	 * commands without reply will be called with NULL result
+	 */
+	void close();
+
+	/**
+	 *  redis-server ǷѾ
+	 * if the connection with the redis-server has been opened
+	 * @return {bool}
+	 */
+	bool opened() const
+	{
+		return opened_;
+	}
+
+	/**
+	 *  redis-server ַ
+	 * get the redis-server addr
+	 * @return {const char*}
+	 */
+	const char* get_addr() const
+	{
+		return addr_.c_str();
+	}
+
+	/**
+	 * ѷ(ȴ)δõӦ
+	 * get the number of the commands sent without reply
+	 * @return {size_t}
+	 */
+	size_t get_pending() const
+	{
+		return pending_.size();
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	/**
+	 * 첽һ redis Ӧʱص callback
+	 * send one redis command asynchronously, and the callback will be
+	 * called when the reply arrives
+	 * @param cmd {const char*} redis  "GET", "HSET"
+	 *  the redis command, such as "GET", "HSET"
+	 * @param key {const char*} ļֵΪ NULL ʱʾûмֵ
+	 *  the key of the command, NULL if no key
+	 * @param args {const std::vector<string>&} ֵ
+	 *  the other arguments after the key
+	 * @param callback {aio_redis_callback*} صΪ NULL ʱӦ
+	 *  the result callback, and the reply will be discarded if NULL
+	 * @return {bool}  false ʾʧܣʱص callback
+	 *  false if connecting failed, and the callback won't be called
+	 */
+	bool exec(const char* cmd, const char* key,
+		const std::vector<string>& args, aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key,
+		const std::vector<const char*>& args,
+		aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key,
+		const std::map<string, string>& attrs,
+		aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key, const char* args[],
+		const size_t lens[], size_t argc, aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key, const char* args[],
+		size_t argc, aio_redis_callback* callback);
+
+	/**
+	 * 첽һѾ redis Эõ
+	 * send one redis command encoded in redis protocol asynchronously
+	 * @param data {const char*} 
+	 *  the encoded command
+	 * @param len {size_t} data ĳ
+	 *  the length of data
+	 * @param callback {aio_redis_callback*} صΪ NULL ʱӦ
+	 *  the result callback, and the reply will be discarded if NULL
+	 * @return {bool}  false ʾʧܣʱص callback
+	 *  false if connecting failed, and the callback won't be called
+	 */
+	bool exec_request(const char* data, size_t len,
+		aio_redis_callback* callback);
+
+protected:
+	//  aio_open_callback 麯
+	virtual bool open_callback();
+	virtual bool read_callback(char* data, int len);
+	virtual void close_callback();
+	virtual bool timeout_callback();
+
+private:
+	aio_handle& handle_;
+	string addr_;
+	int   conn_timeout_;
+	int   rw_timeout_;
+	aio_socket_stream* conn_;
+	bool  opened_;
+	string wbuf_;
+	std::list<aio_redis_callback*> pending_;
+	redis_command* builder_;
+	redis_parser* parser_;
+	dbuf_pool* pool_;
+	bool* destroyed_;	// ָ read_callback ľֲ־صʱλ
+
+	bool send_request(aio_redis_callback* callback);
+	void fail_pending();
+};
+
+} // namespace acl
@@ -0,0 +1,173 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <map>
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+
+namespace acl
+{
+
+class aio_handle;
+class aio_redis_client;
+class aio_redis_callback;
+class redis_command;
+
+/**
+ * 첽 redis Ⱥͻֵ࣬Ĺϣ۽Ӧ
+ * aio_redis_client ӣԶ MOVED/ASK ض򣻹ϣַ
+ * ӳϵ redis_client_cluster һյ MOVED ʱ̬£
+ *  aio_handle ͬһ߳ʹ
+ * the asynchronous redis cluster client class, which sends the command
+ * to the aio_redis_client connection of the node owning the hash slot of
+ * the command's key, and handles MOVED/ASK redirections automatically; the
+ * mapping of slots and node addrs is updated dynamically when MOVED
+ * happens, just like redis_client_cluster; the object should be used in
+ * the same thread with the aio_handle
+ */
+class ACL_CPP_API aio_redis_cluster
+{
+public:
+	/**
+	 * 캯
+	 * constructor
+	 * @param handle {aio_handle&} 첽¼
+	 *  the asynchronous event engine
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout in seconds for connecting the redis-server
+	 * @param rw_timeout {int} ȴӦĳʱʱ()
+	 *  the timeout in seconds for waiting the replies
+	 * @param max_slot {int} ϣֵ
+	 *  the max hash-slot value of keys
+	 */
+	aio_redis_cluster(aio_handle& handle, int conn_timeout = 10,
+		int rw_timeout = 10, int max_slot = 16384);
+
+	/**
+	 * ʱرеӣδõӦ NULL ص
+	 * all connections will be closed, and the callbacks of the commands
+	 * without reply will be called with NULL result
+	 */
+	virtual ~aio_redis_cluster();
+
+	/**
+	 * ӼȺеĽַڹϣ۶ӦĽδ֪ʱ
+	 * һ㣬 MOVED ضȷĽ
+	 * add the nodes' addrs of the cluster, when the node of one slot is
+	 * unknown, the command will be sent to one of them, and redirected
+	 * to the right node by MOVED
+	 * @param addrs {const char*} ַַ֮ ,  ; ָ
+	 *  磺127.0.0.1:7000,127.0.0.1:7001
+	 *  the nodes' addrs separated by , or ;, such as
+	 *  127.0.0.1:7000,127.0.0.1:7001
+	 * @return {aio_redis_cluster&}
+	 */
+	aio_redis_cluster& set(const char* addrs);
+
+	/**
+	 * ַָӶ󣬲ʱԶ
+	 * get the connection of the given addr, which will be created if
+	 * not exists
+	 * @param addr {const char*} ַʽip:port
+	 *  the node's addr, such as ip:port
+	 * @return {aio_redis_client*}
+	 */
+	aio_redis_client* get(const char* addr);
+
+	/**
+	 * ݹϣֵöӦӶ
+	 * get the connection of the node owning the given slot
+	 * @param slot {int} ϣֵ
+	 *  the hash-slot value
+	 * @return {aio_redis_client*} ϣ۶ӦĽδ֪ʱ NULL
+	 *  NULL if the node of the slot is unknown
+	 */
+	aio_redis_client* peek_slot(int slot);
+
+	/**
+	 * ùϣֵӦĽַ
+	 * set the node's addr with one slot
+	 * @param slot {int} ϣֵ
+	 *  the hash-slot
+	 * @param addr {const char*} ַ
+	 *  the node's addr
+	 */
+	void set_slot(int slot, const char* addr);
+
+	/**
+	 * ϣֵַӳϵ
+	 * remove the mapping of one slot and the node's addr
+	 * @param slot {int} ϣֵ
+	 *  the hash-slot
+	 */
+	void clear_slot(int slot);
+
+	/**
+	 * ùϣֵ
+	 * get the max hash-slot
+	 * @return {int}
+	 */
+	int get_max_slot() const
+	{
+		return max_slot_;
+	}
+
+	/**
+	 * һضķֵĬֵΪ 15
+	 * set redirect limit for MOVE/ASK of one command, default is 15
+	 * @param max {int} ֻеֵ > 0 ʱЧ
+	 *  valid only when max > 0
+	 */
+	void set_redirect_max(int max);
+
+	/**
+	 * ضķֵ
+	 * get redirect limit of MOVE/ASK
+	 * @return {int}
+	 */
+	int get_redirect_max() const
+	{
+		return redirect_max_;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+
+	/**
+	 * 첽һ redis ͬ aio_redis_client::execض
+	 * ֵʱһε MOVED/ASK ص
+	 * send one redis command asynchronously, the arguments are the same as
+	 * aio_redis_client::exec; when redirecting too many times, the last
+	 * MOVED/ASK error will be passed to the callback
+	 * @return {bool}  false ʾûпõĽ㣬ʱص callback
+	 *  false if no node available, and the callback won't be called
+	 */
+	bool exec(const char* cmd, const char* key,
+		const std::vector<string>& args, aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key,
+		const std::vector<const char*>& args,
+		aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key,
+		const std::map<string, string>& attrs,
+		aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key, const char* args[],
+		const size_t lens[], size_t argc, aio_redis_callback* callback);
+	bool exec(const char* cmd, const char* key, const char* args[],
+		size_t argc, aio_redis_callback* callback);
+
+private:
+	aio_handle& handle_;
+	int   conn_timeout_;
+	int   rw_timeout_;
+	int   max_slot_;
+	int   redirect_max_;
+	const char** slot_addrs_;
+	std::vector<char*> addrs_;
+	size_t next_;
+	std::map<string, aio_redis_client*> clients_;
+	redis_command* builder_;
+
+	const char* save_addr(const char* addr);
+	aio_redis_client* peek();
+	bool send_request(const char* key, aio_redis_callback* callback);
+};
+
+} // namespace acl
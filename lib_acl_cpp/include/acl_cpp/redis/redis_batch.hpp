@@ -0,0 +1,161 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <map>
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/redis/redis_pipeline.hpp"
+
+namespace acl
+{
+
+class redis_client;
+class redis_client_cluster;
+class redis_result;
+
+/**
+ * redis ֵ࣬ڼȺģʽ½һֵ( MGET/MSET/DEL/
+ * EXISTS)ļֵĹϣ۲ֳɶͨ redis_pipeline ÿ
+ * redis ϲзͣ󰴵߸ļֵ˳Ӷ
+ *  CROSSSLOT ԼֵĶǼȺģʽ
+ * ֵһзͣע⣺ֺĸپԭ
+ * redis multi-keys batch command class, in cluster mode the keys of one
+ * multi-keys command (such as MGET/MSET/DEL/EXISTS) are split into some
+ * sub-commands by their hash slots, and the sub-commands of each redis
+ * node are sent in parallel by redis_pipeline, then the results will be
+ * reassembled in the caller's keys order, which avoids the CROSSSLOT error
+ * and the round trips of operating the keys one by one; in no-cluster mode
+ * all the keys are sent in one command; notice: the sub-commands aren't
+ * atomic as a whole.
+ */
+class ACL_CPP_API redis_batch : public redis_pipeline
+{
+public:
+	/**
+	 * see redis_command::redis_command()
+	 */
+	redis_batch();
+
+	/**
+	 * see redis_command::redis_command(redis_client*)
+	 */
+	redis_batch(redis_client* conn);
+
+	/**
+	 * see redis_command::redis_command(redis_client_cluster* size_t)
+	 */
+	redis_batch(redis_client_cluster* cluster, size_t max_conns);
+
+	virtual ~redis_batch();
+
+	/////////////////////////////////////////////////////////////////////
+
+	/**
+	 * ִһͨõĶֵÿ step Ϊһ飬ÿĵһ
+	 * Ϊֵֵͬһϣ۵Ĳ鱻ϲΪһ
+	 * execute one generic multi-keys command, the arguments are grouped
+	 * by every step arguments, and the first of each group is the key,
+	 * the groups whose keys belong to the same hash slot are combined into
+	 * one sub-command
+	 * @param cmd {const char*} redis  "MGET", "DEL", "MSET"
+	 *  the redis command, such as "MGET", "DEL", "MSET"
+	 * @param args {const std::vector<string>&} 飬Ϊ
+	 *  the argument groups, which can't be empty
+	 * @param step {size_t} ÿĸ MGET Ϊ 1MSET Ϊ 2
+	 *  the number of arguments in one group, such as 1 for MGET,
+	 *  2 for MSET
+	 * @return {bool} ǷõӦӦΪ
+	 *  REDIS_RESULT_ERROR 
+	 *  if all the sub-commands got their replies, which maybe
+	 *  REDIS_RESULT_ERROR
+	 */
+	bool exec_keys(const char* cmd, const std::vector<string>& args,
+		size_t step = 1);
+	bool exec_keys(const char* cmd, const std::vector<const char*>& args,
+		size_t step = 1);
+	bool exec_keys(const char* cmd, const char* args[],
+		const size_t lens[], size_t argc, size_t step = 1);
+
+	/**
+	 *  exec_keys õ i ( i ֵ)ӦĽ
+	 * ӦΪԪظĲͬ( MGET)
+	 * ضӦԪأ򷵻Ӧ( DEL Ӧ)
+	 * get the result of the ith argument group (the ith key) after calling
+	 * exec_keys: if the reply of the sub-command is an array with the same
+	 * number of elements as the groups in the sub-command (such as MGET),
+	 * the corresponding element will be returned, or else the reply of the
+	 * sub-command will be returned (such as the integer reply of DEL)
+	 * @param i {size_t} ±꣬ 0 ʼ
+	 *  the index of the argument group, beginning with 0
+	 * @return {const redis_result*} ±ԽδõӦʱ NULL
+	 *  NULL if the index is out of bounds or the sub-command got no reply
+	 */
+	const redis_result* get_key_result(size_t i) const;
+
+	/////////////////////////////////////////////////////////////////////
+
+	/**
+	 * ȡֵֵַͬ redis_string::mget
+	 * get the values of the given string keys, the same as
+	 * redis_string::mget
+	 * @param keys {const std::vector<string>&} ֵ
+	 *  the keys
+	 * @param out {std::vector<string>*} ǿʱֵ˳Ž
+	 *  ļֵӦմ
+	 *  if not NULL, it will store the values in the keys order, and the
+	 *  value of the key not existing is empty string
+	 * @return {bool} Ƿִгɹ
+	 *  if all the sub-commands were executed successfully
+	 */
+	bool mget(const std::vector<string>& keys,
+		std::vector<string>* out = NULL);
+	bool mget(const std::vector<const char*>& keys,
+		std::vector<string>* out = NULL);
+
+	/**
+	 * öֵֵַͬ redis_string::mset
+	 * set the values of the given string keys, the same as
+	 * redis_string::mset
+	 * @param objs {const std::map<string, string>&} ֵֵ
+	 *  the keys and their values
+	 * @return {bool} Ƿִгɹ
+	 *  if all the sub-commands were executed successfully
+	 */
+	bool mset(const std::map<string, string>& objs);
+	bool mset(const std::vector<string>& keys,
+		const std::vector<string>& values);
+
+	/**
+	 * ɾֵ
+	 * delete the given keys
+	 * @param keys {const std::vector<string>&} ֵ
+	 *  the keys
+	 * @return {int} ɾļֵʱ -1
+	 *  the number of the keys deleted, -1 if some error happened
+	 */
+	int del(const std::vector<string>& keys);
+	int del(const std::vector<const char*>& keys);
+
+	/**
+	 * öֵдڵļֵ
+	 * get the number of the existing keys in the given keys
+	 * @param keys {const std::vector<string>&} ֵ
+	 *  the keys
+	 * @return {int} ڵļֵʱ -1
+	 *  the number of the existing keys, -1 if some error happened
+	 */
+	int exists(const std::vector<string>& keys);
+	int exists(const std::vector<const char*>& keys);
+
+private:
+	// ÿ±꼰ڸе±
+	std::vector<size_t> key_cmds_;
+	std::vector<size_t> key_idxs_;
+	// ÿĲ
+	std::vector<size_t> cmd_keys_;
+
+	bool get_values(std::vector<string>* out);
+	bool check_ok();
+	int  get_sum();
+};
+
+} // namespace acl
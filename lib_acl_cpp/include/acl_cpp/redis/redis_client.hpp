@@ -11,6 +11,7 @@ namespace acl
 class dbuf_pool;
 class redis_result;
 class redis_request;
+class redis_parser;
 
 /**
  * redis ͻ˶ͨ࣬ͨཫ֯õ redis  redis ˣ
@@ -50,6 +51,16 @@ public:
 	 */
 	void close();
 
+	/**
+	 * 麯 PING ̽ǷȻãӳں̨
+	 * virtual function in connect_client, which sends PING to check if
+	 * the idle connection is still usable, and is called by the connection
+	 * pool in the background
+	 * @return {bool} Ƿ
+	 *  if the connection is usable
+	 */
+	bool alive();
+
 	/**
 	 * 
 	 * get acl::socket_stream from the connection
@@ -79,6 +90,16 @@ public:
 	 */
 	void set_slice_respond(bool on);
 
+	/**
+	 * Ƿӽ READONLY ڼȺĴӽִ
+	 * ӽǰ
+	 * set if sending READONLY after the connection was opened, which
+	 * allows the read commands on the replica nodes of the cluster, and
+	 * it should be called before the connection was opened
+	 * @param on {bool}
+	 */
+	void set_readonly(bool on);
+
 	/**
 	 * ڷǷƬͷʽ redis-server ݣͬʱȡ
 	 * صӦ
@@ -111,6 +132,35 @@ public:
 	const redis_result* run(dbuf_pool* pool, const redis_request& req,
 		size_t nchildren);
 
+	/**
+	 *  redis-server ݶȡӦ read_respond ʹã
+	 *  redis-server ֱȻһȡӦӶʹ
+	 * redis-server дδʱԶ
+	 * only send request to redis-server without reading the respond, which
+	 * should be used with read_respond, so the requests can be sent to
+	 * many redis-servers first, and then read their responds one by one,
+	 * and the redis-servers can handle the requests in parallel; the
+	 * connection will be opened automatically if it isn't opened
+	 * @param req {const string&} ݰ
+	 *  the request package
+	 * @return {bool} Ƿͳɹ
+	 *  if the request was sent successfully
+	 */
+	bool send_request(const string& req);
+
+	/**
+	 * ȡ send_request ͵Ӧݣʱر
+	 * read and analyse the respond of the request sent by send_request,
+	 * and the connection will be closed if some error happens
+	 * @param pool {dbuf_pool*} ڴع
+	 *  memory pool manager
+	 * @param nchildren {size_t} Ӧмݶ
+	 *  the data object number in the server's response data
+	 * @return {const redis_result*} ͬ run
+	 *  the same as run
+	 */
+	const redis_result* read_respond(dbuf_pool* pool, size_t nchildren);
+
 protected:
 	// 麯
 	virtual bool open();
@@ -121,20 +171,24 @@ private:
 	int   conn_timeout_;
 	int   rw_timeout_;
 	bool  retry_;
-	string  buf_;
+	bool  readonly_;
 	bool slice_req_;
 	bool slice_res_;
 
-	redis_result* get_redis_objects(dbuf_pool* pool, size_t nobjs);
-	redis_result* get_redis_object(dbuf_pool* pool);
-	redis_result* get_redis_error(dbuf_pool* pool);
-	redis_result* get_redis_status(dbuf_pool* pool);
-	redis_result* get_redis_integer(dbuf_pool* pool);
-	redis_result* get_redis_string(dbuf_pool* pool);
-	redis_result* get_redis_array(dbuf_pool* pool);
+	// ӦݱڽڴϷĶУɽ
+	// ֱãԱݵĿ
+	redis_parser* parser_;
+	char*   rbuf_;
+	size_t  rsize_;
+	size_t  rlen_;
+	size_t  roff_;
+	// ںӦݣһζӦʱȴ
+	string  rleft_;
 
-	void put_data(dbuf_pool* pool, redis_result* rr,
-		const char* data, size_t len);
+	redis_result* get_objects(dbuf_pool* pool, size_t nobjs);
+	redis_result* get_object(dbuf_pool* pool);
+	bool read_more(dbuf_pool* pool);
+	bool send_readonly();
 };
 
 } // end namespace acl
@@ -8,6 +8,20 @@ namespace acl
 {
 
 class redis_pool;
+class redis_slot;
+class redis_client_pool;
+class slots_refresher;
+
+/**
+ * Ⱥģʽ¶·ɷʽ
+ * the routing mode of the read commands in cluster mode
+ */
+typedef enum
+{
+	REDIS_READ_MASTER,		// ֻ; read from master only
+	REDIS_READ_PREFER_REPLICA,	// ȴӴӽ; prefer the replicas
+	REDIS_READ_NEAREST,		// ӽӳ߶; the nearest
+} redis_read_mode_t;
 
 /**
  * redis ͻ˼Ⱥ࣬ͨע redis ͻ(redis_command)
@@ -66,6 +80,107 @@ public:
 	 */
 	void set_all_slot(const char* addr, int max_conns);
 
+	/**
+	 * δ֪ļȺͨ CLUSTER SLOTS ȡȺϢɹ
+	 * һ滻йϣַӳϵδֵĹϣ۱
+	 * ѴڵĽӳرʹã½ӳرԶ
+	 * صΪ set_all_slot  start_refresh õֵ
+	 * load the cluster's topology with CLUSTER SLOTS from the known nodes
+	 * one by one, and replace all the mapping between the slots and the
+	 * nodes' addrs at once if successful, the slots not in the topology
+	 * will be cleared; the connection pools of the existing nodes will be
+	 * reused, and the pools of the new nodes will be created with the max
+	 * connections limit set by set_all_slot or start_refresh
+	 * @return {bool} ǷĳɹȡϢ
+	 *  if the topology was got from one node successfully
+	 */
+	bool refresh_slots();
+
+	/**
+	 * һμȺϢ̨̣߳ÿ inter ˢһΣ
+	 * յ MOVED ضʱͨ request_refresh ̨߳̾
+	 * ˢ£ӶڼȺлеĹϣͨض
+	 * load the cluster's topology at once and start a background thread
+	 * refreshing it every inter seconds, and the thread will be requested
+	 * to refresh as soon as possible by request_refresh when one command
+	 * got a MOVED redirection, which avoids updating the slots one by one
+	 * with redirections after the cluster's failover
+	 * @param inter {int} ˢµʱ()<= 0 ʱյ MOVED ʱ
+	 *  ˢ
+	 *  the interval in seconds of refreshing periodically, and it will
+	 *  refresh only when got MOVED if it's <= 0
+	 * @param max_conns {int} Ϊ½ӳص
+	 *  the max connections limit of the pools created for the new nodes
+	 * @return {bool} ״μǷɹʧʱ̨߳Ȼ
+	 *  if the first loading was successful, the background thread will
+	 *  be started even if failed
+	 */
+	bool start_refresh(int inter = 60, int max_conns = 100);
+
+	/**
+	 * ֹ̨ͣˢ̣߳ʱԶ
+	 * stop the background refreshing thread, which will be called in
+	 * the destructor automatically
+	 */
+	void stop_refresh();
+
+	/**
+	 * ̨߳̾ˢ¼ȺϢˢǰĶ󱻺ϲΪһΣ
+	 * еˢµļ 1 룻δ̨߳ʱκ
+	 * 
+	 * request the background thread to refresh the cluster's topology as
+	 * soon as possible, the requests before refreshing will be merged into
+	 * one, and the interval between two refreshings caused by requests is
+	 * at least one second; nothing will be done if the background thread
+	 * wasn't started
+	 */
+	void request_refresh();
+
+	/**
+	 * ö·ɷʽĬΪ REDIS_READ_MASTER REDIS_READ_MASTER
+	 * ʱͨ CLUSTER SLOTS (set_all_slot/refresh_slots/
+	 * start_refresh)ʱΪӽ㴴ӳأӽ READONLY
+	 * ֻ( redis_string::get, redis_hash::hgetall, redis_zset::zrange
+	 * )ӳٵƶƽֵ;ѡŵĽ㣻
+	 * ˼ǰ
+	 * set the routing mode of the read commands, default is
+	 * REDIS_READ_MASTER; if it's not REDIS_READ_MASTER, the connection
+	 * pools of the replicas will also be created when loading the topology
+	 * with CLUSTER SLOTS (set_all_slot/refresh_slots/start_refresh), whose
+	 * connections will send READONLY after opened, and the read-only
+	 * commands (such as redis_string::get, redis_hash::hgetall,
+	 * redis_zset::zrange, etc.) will be sent to the best node according to
+	 * the EWMA of nodes' latency and the requests in flight; this should
+	 * be called before loading the topology and creating the commands
+	 * @param mode {redis_read_mode_t}
+	 */
+	void set_read_mode(redis_read_mode_t mode);
+
+	/**
+	 * ö·ɷʽ
+	 * get the routing mode of the read commands
+	 * @return {redis_read_mode_t}
+	 */
+	redis_read_mode_t get_read_mode() const
+	{
+		return read_mode_;
+	}
+
+	/**
+	 * ո·ɷʽΪϣѡӳأϣûпõ
+	 * ӽ·ɷʽΪ REDIS_READ_MASTER ʱӳ
+	 * choose the connection pool for the read commands of the slot with
+	 * the given routing mode, and the master's pool will be returned if
+	 * the slot has no available replica or the mode is REDIS_READ_MASTER
+	 * @param slot {int} ϣֵ
+	 *  the hash-slot value
+	 * @param mode {redis_read_mode_t} ·ɷʽ
+	 *  the routing mode
+	 * @return {redis_client_pool*} ϣ۲ʱ NULL
+	 *  NULL will be returned if the slot doesn't exist
+	 */
+	redis_client_pool* peek_read_slot(int slot, redis_read_mode_t mode);
+
 	/**
 	 * ̬ϣ۶Ӧ redis ַԱ¼λãڲ߳;
 	 * dynamicly remove one slot and redis-server addr mapping, which is
@@ -152,6 +267,20 @@ private:
 	std::vector<char*> addrs_;
 	int   redirect_max_;
 	int   redirect_sleep_;
+	int   max_conns_;
+	slots_refresher* refresher_;
+
+	// ÿϣ۶ӦĴӽַϣ϶󱻶ϣ۹
+	typedef std::vector<const char*> replicas_t;
+	redis_read_mode_t read_mode_;
+	const replicas_t** slot_replicas_;
+	std::vector<replicas_t*> replicas_;
+	unsigned int read_seq_;
+
+	const char* save_addr(const char* addr);
+	const replicas_t* save_replicas(const replicas_t& addrs);
+	bool load_slots(const char* addr);
+	void set_slots(const std::vector<redis_slot*>& slots);
 };
 
 } // namespace acl
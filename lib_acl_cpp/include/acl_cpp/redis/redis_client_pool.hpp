@@ -39,6 +39,25 @@ public:
 	 */
 	redis_client_pool& set_timeout(int conn_timeout, int rw_timeout);
 
+	/**
+	 * ½Ƿ READONLY ڼȺдӽӳ
+	 * set if the new connections send READONLY, which is used for the
+	 * connection pools of the replica nodes in cluster
+	 * @param on {bool}
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_readonly(bool on);
+
+	/**
+	 * ж½Ƿ READONLY 
+	 * if the new connections send READONLY
+	 * @return {bool}
+	 */
+	bool is_readonly() const
+	{
+		return readonly_;
+	}
+
 protected:
 	/**
 	 * ി麯: ô˺һµ
@@ -50,6 +69,7 @@ protected:
 private:
 	int   conn_timeout_;
 	int   rw_timeout_;
+	bool  readonly_;
 };
 
 } // namespace acl
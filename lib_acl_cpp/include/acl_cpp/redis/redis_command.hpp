@@ -4,6 +4,7 @@
 #include <list>
 #include <vector>
 #include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
 
 namespace acl
 {
@@ -11,6 +12,7 @@ namespace acl
 class redis_client;
 class redis_client_cluster;
 class redis_request;
+class redis_near_cache;
 
 /**
  * redis ͻĴ鸸;
@@ -123,6 +125,26 @@ public:
 		return cluster_;
 	}
 
+	/**
+	 * üȺģʽ±ֻ·ɷʽȱʡʹüȺõ
+	 * ·ɷʽ( redis_client_cluster::set_read_mode)
+	 * set the routing mode of the read-only commands of this object in
+	 * cluster mode, the mode set in the cluster object will be used by
+	 * default (see redis_client_cluster::set_read_mode)
+	 * @param mode {redis_read_mode_t}
+	 */
+	void set_read_mode(redis_read_mode_t mode);
+
+	/**
+	 * ֻ·ɷʽ
+	 * get the routing mode of the read-only commands
+	 * @return {redis_read_mode_t}
+	 */
+	redis_read_mode_t get_read_mode() const
+	{
+		return read_mode_;
+	}
+
 	/**
 	 * ڴؾڴ redis_command ڲ;
 	 * get memory pool handle be set
@@ -281,6 +303,37 @@ public:
 	 */
 	void set_slice_respond(bool on);
 
+	/**
+	 * ý˻ú󱾶Ķ(Ŀǰ֧ redis_string::get
+	 *  redis_hash::hget/hgetall)ȴӻлȡݣʱʷ
+	 * ˣʱ get_result ȻȡĺЧִͨед
+	 * ɺʹмֵ( DEL/MSET ĸEVAL/EVALSHA 
+	 * )ĻʧЧFLUSHDB/FLUSHALL ջ棬Ա֤дһ
+	 * set the near cache object, the reading operations (redis_string::get
+	 * and redis_hash::hget/hgetall now) will look up the cache first, and
+	 * the server won't be accessed if hit, when the methods getting the
+	 * result object such as get_result are invalid; the writing commands
+	 * executed by this object will invalidate the cache of all their keys
+	 * (such as each key of DEL/MSET, the keys declared by EVAL/EVALSHA)
+	 * after completed, and FLUSHDB/FLUSHALL will clear the cache, for
+	 * keeping the local read-after-write consistency
+	 * @param cache {redis_near_cache*} Ϊ NULL ʱȡ棬öԱ
+	 *  ߳е볤ڱ
+	 *  NULL to cancel the cache, the cache object can be shared by the
+	 *  commands in different threads, and must live longer than this
+	 */
+	void set_near_cache(redis_near_cache* cache);
+
+	/**
+	 * õĽ˻
+	 * get the near cache object set
+	 * @return {redis_near_cache*}
+	 */
+	redis_near_cache* get_near_cache() const
+	{
+		return near_cache_;
+	}
+
 protected:
 	const redis_result* run(size_t nchild = 0);
 	const redis_result* run(redis_client_cluster* cluster, size_t nchild);
@@ -354,6 +407,10 @@ protected:
 
 	/************************** common *********************************/
 protected:
+	friend class redis_pipeline;
+	friend class aio_redis_client;
+	friend class aio_redis_cluster;
+
 	dbuf_pool* pool_;
 
 	// ݼֵϣֵ
@@ -369,8 +426,11 @@ private:
 	int slot_;
 	int redirect_max_;
 	int redirect_sleep_;
+	redis_read_mode_t read_mode_;
+	bool read_only_;	// ǰǷΪֻ
 
 	redis_client* peek_conn(redis_client_cluster* cluster, int slot);
+	redis_client* peek_read_conn(redis_client_cluster* cluster, int slot);
 	redis_client* redirect(redis_client_cluster* cluster, const char* addr);
 	const char* get_addr(const char* info);
 	void set_client_addr(const char* addr);
@@ -394,6 +454,15 @@ private:
 	/************************** respond ********************************/
 	bool slice_res_;
 	const redis_result* result_;
+
+private:
+	/************************** near cache *****************************/
+	redis_near_cache* near_cache_;
+	std::vector<string>* near_keys_;	// дļֵ
+	bool near_dirty_;
+	bool near_flush_;
+
+	void near_invalidate();
 };
 
 } // namespace acl
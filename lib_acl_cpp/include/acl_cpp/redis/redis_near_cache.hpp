@@ -0,0 +1,164 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <map>
+#include <list>
+#include <vector>
+#include "acl_cpp/stdlib/noncopyable.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
+#include "acl_cpp/stdlib/string.hpp"
+
+namespace acl
+{
+
+class near_tracker;
+
+/**
+ * redis ͻ˽˻࣬ȵֵĶڽڣ˸ö
+ * redis_command ڶȡʱȲѯ(Ŀǰ֧ redis_string::get 
+ * redis_hash::hget/hgetall) LRU ̭ҿʱ䣬
+ * ͨ track  redis 6  CLIENT TRACKING 㲥(BCAST)ģʽɺ̨
+ * ߳ͨĶӽշ˵ļֵʧЧ֪ͨδʱݵ
+ * һԽʱ䱣֤̰߳ȫģԱ߳е redis
+ * 
+ * redis client-side near cache, the read results of the hot keys are
+ * cached in process, and the redis_command objects which have been set
+ * with the cache will look up it first when reading (redis_string::get and
+ * redis_hash::hget/hgetall are supported now); the cache is LRU and the
+ * entries can have TTL, and the CLIENT TRACKING BCAST mode of redis 6 can
+ * be enabled by track, then a background thread will receive the keys'
+ * invalidation messages from server with a dedicated subscribing
+ * connection; without tracking, the consistency depends only on the TTL;
+ * the object is thread safe and can be shared by the redis commands in
+ * different threads
+ */
+class ACL_CPP_API redis_near_cache : public noncopyable
+{
+public:
+	/**
+	 * 캯
+	 * constructor
+	 * @param max_keys {size_t} ໺ļֵʱ̭δ
+	 *  ļֵΪ 0 ʱڲԶΪ 10000
+	 *  the max number of the cached keys, the least recently used keys
+	 *  will be removed when exceeding it, 10000 will be used if it's 0
+	 * @param ttl {int} ݵʱ()<= 0 ʱʾڣʱ
+	 *  Ӧͨ track ʧЧ֪ͨ
+	 *  the TTL of the cached data in milliseconds, never expiring if
+	 *  it's <= 0, in which case track should be called
+	 */
+	redis_near_cache(size_t max_keys = 10000, int ttl = 60000);
+	~redis_near_cache();
+
+	/**
+	 *  redis ˵ļֵʧЧ֪ͨ˽һӼһ
+	 * ӣԹ㲥(BCAST)ģʽ CLIENT TRACKING̨߳̽
+	 * ʧЧ֪ͨӶϿʱ沢ԶȺģʽӦöÿ
+	 * һα
+	 * enable the keys' invalidation notifications of the redis server, one
+	 * subscribing connection and one tracking connection will be created,
+	 * CLIENT TRACKING will be turned on with BCAST mode, and a background
+	 * thread will be started to receive the notifications; all the cache
+	 * will be cleared and the connections will be reopened when they're
+	 * broken; in cluster mode, it should be called for each master node
+	 * @param addr {const char*} redis ַ
+	 *  the redis server's address
+	 * @param prefixes {const std::vector<string>*} ǿʱǰ׺
+	 *  ͷļֵӶʧЧ֪ͨ
+	 *  if not NULL, only the keys beginning with the prefixes are tracked,
+	 *  which can reduce the notifications
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout of connecting in seconds
+	 * @param rw_timeout {int} дʱʱ()
+	 *  the timeout of IO in seconds
+	 * @return {bool} ״οǷɹʧʱ(˵ 6.0 汾)
+	 *  ȻãһԽʱ䱣֤
+	 *  if the tracking was enabled successfully, if failed (such as
+	 *  the redis server's version is less than 6.0) the cache can still be
+	 *  used with the consistency depending only on the TTL
+	 */
+	bool track(const char* addr, const std::vector<string>* prefixes = NULL,
+		int conn_timeout = 10, int rw_timeout = 10);
+
+	/**
+	 * ʹĳֵĻʧЧ
+	 * invalidate the cached data of one key
+	 * @param key {const char*} ֵ
+	 *  the key
+	 * @param len {size_t} ֵ
+	 *  the key's length
+	 */
+	void invalidate(const char* key, size_t len);
+	void invalidate(const char* key);
+
+	/**
+	 * л
+	 * remove all the cached data
+	 */
+	void clear();
+
+	/**
+	 * õǰļֵ
+	 * get the number of the cached keys
+	 * @return {size_t}
+	 */
+	size_t size();
+
+	/**
+	 * ûеĴ
+	 * get the number of the cache hits
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_hits() const
+	{
+		return hits_;
+	}
+
+	/**
+	 * ûδеĴ
+	 * get the number of the cache misses
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_misses() const
+	{
+		return misses_;
+	}
+
+public:
+	// ºȻ public ģֻ redis ڲʹãѯδʱ
+	// ص seq дʱ룬ڼüֵʧЧʱд뱻ԣӶ⽫
+	// ʧЧǰľݷ뻺
+
+	bool get(const char* key, size_t len, string& out,
+		unsigned long long& seq);
+	void put(const char* key, size_t len, const string& value,
+		unsigned long long seq);
+
+	bool hget(const char* key, size_t len, const char* name,
+		size_t name_len, string& out, unsigned long long& seq);
+	void hput(const char* key, size_t len, const char* name,
+		size_t name_len, const string& value, unsigned long long seq);
+
+	bool hgetall(const char* key, size_t len,
+		std::map<string, string>& out, unsigned long long& seq);
+	void hputall(const char* key, size_t len,
+		const std::map<string, string>& attrs, unsigned long long seq);
+
+private:
+	struct near_node;
+
+	size_t max_keys_;
+	int    ttl_;
+	locker lock_;
+	std::map<string, near_node*> nodes_;
+	std::list<near_node*> lru_;
+	unsigned long long seq_;
+	unsigned long long hits_;
+	unsigned long long misses_;
+	std::vector<near_tracker*> trackers_;
+
+	near_node* peek(const char* key, size_t len, unsigned long long& seq);
+	near_node* find(const char* key, size_t len, unsigned long long seq);
+	void remove(near_node* node);
+};
+
+} // namespace acl
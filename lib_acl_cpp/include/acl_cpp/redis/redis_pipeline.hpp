@@ -0,0 +1,182 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <map>
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/redis/redis_command.hpp"
+
+namespace acl
+{
+
+class redis_client;
+class redis_client_pool;
+class redis_result;
+
+/**
+ * redis ܵ࣬ȽȻһԷ͸ redis-server
+ * ٰ˳ȡӦӶϲΪһΣڼȺģʽ£
+ * ÿļֵĹϣ۽ redis 鷢ͣԶ
+ * MOVED/ASK ض
+ * redis pipeline class, which caches many commands and sends them to
+ * redis-server in one write, then reads all the replies in order; in
+ * cluster mode, the commands are grouped by the redis node owning the
+ * hash slot of each command's key, and MOVED/ASK redirections are handled
+ * automatically.
+ */
+class ACL_CPP_API redis_pipeline : virtual public redis_command
+{
+public:
+	/**
+	 * see redis_command::redis_command()
+	 */
+	redis_pipeline();
+
+	/**
+	 * see redis_command::redis_command(redis_client*)
+	 */
+	redis_pipeline(redis_client* conn);
+
+	/**
+	 * see redis_command::redis_command(redis_client_cluster* size_t)
+	 */
+	redis_pipeline(redis_client_cluster* cluster, size_t max_conns);
+
+	virtual ~redis_pipeline();
+
+	/////////////////////////////////////////////////////////////////////
+
+	/**
+	 * ܵһֱͣ flushһ
+	 * flush ٴʱԶһӦ
+	 * add one command into the pipeline, which won't be sent until flush
+	 * was called; when adding command after the last flush, the last
+	 * commands and their results will be cleared first.
+	 * @param cmd {const char*} redis  "GET", "HSET"
+	 *  the redis command, such as "GET", "HSET"
+	 * @param key {const char*} ļֵΪ NULL ʱʾûмֵ
+	 *  ڼȺģʽ¸һ redis 
+	 *  the key of the command, NULL if no key, and in cluster mode the
+	 *  command will be sent to any redis node
+	 * @param args {const std::vector<string>&} ֵ
+	 *  the other arguments after the key
+	 * @return {redis_pipeline&}
+	 */
+	redis_pipeline& add(const char* cmd, const char* key,
+		const std::vector<string>& args);
+	redis_pipeline& add(const char* cmd, const char* key,
+		const std::vector<const char*>& args);
+	redis_pipeline& add(const char* cmd, const char* key,
+		const std::map<string, string>& attrs);
+
+	/**
+	 * ܵһΪ
+	 * add one command with binary arguments into the pipeline
+	 * @param cmd {const char*} redis 
+	 *  the redis command
+	 * @param key {const char*} ļֵΪ NULL
+	 *  the key of the command, maybe NULL
+	 * @param args {const char*[]} ֵ
+	 *  the other arguments after the key
+	 * @param lens {const size_t[]} ÿĳ
+	 *  the length of every argument
+	 * @param argc {size_t} 
+	 *  the number of the arguments
+	 * @return {redis_pipeline&}
+	 */
+	redis_pipeline& add(const char* cmd, const char* key,
+		const char* args[], const size_t lens[], size_t argc);
+	redis_pipeline& add(const char* cmd, const char* key,
+		const char* args[], size_t argc);
+
+	/**
+	 * ܵ͸ redis-server ȡеӦǼȺģʽ
+	 * ͨһдͣȺģʽÿ redis ͨһ
+	 * дͣн㷢һȡӦ㲢д
+	 * send all the commands in the pipeline to redis-server and read all
+	 * the replies; in no-cluster mode all commands are sent in one write,
+	 * and in cluster mode the commands for each redis node are sent in
+	 * one write, and the commands are sent to all the nodes before reading
+	 * the replies, so the nodes can handle the commands in parallel.
+	 * @return {bool} Ƿ񶼵õӦ true ʱÿĽ
+	 *  ȻΪ REDIS_RESULT_ERROR ͣ false ʱδõӦ
+	 *  ӦĽΪ NULL
+	 *  if all commands got their replies; when returning true, the
+	 *  result of some command maybe REDIS_RESULT_ERROR, when returning
+	 *  false, the result of the command without reply will be NULL.
+	 */
+	bool flush();
+
+	/**
+	 * ùܵĸ
+	 * get the number of commands in the pipeline
+	 * @return {size_t}
+	 */
+	size_t get_size() const;
+
+	/**
+	 *  flush ĳӦ´
+	 * clear ǰһֱЧ
+	 * get the result of one command after flush, the result object is
+	 * valid until adding command again or calling clear.
+	 * @param i {size_t} ӵ˳±꣬ 0 ʼ
+	 *  the index of the command in adding order, beginning with 0
+	 * @return {const redis_result*} ±ԽδõӦʱ NULL
+	 *  NULL will be returned if the index is out of bounds or the command
+	 *  got no reply
+	 */
+	const redis_result* get_child(size_t i) const;
+
+protected:
+	/**
+	 * ܵһѾùϣֵʹ
+	 * add one command with the given hash slot, used by the subclass
+	 * @param slot {int} ϣֵΪ -1 ʱʾûмֵ
+	 *  the hash slot, -1 if the command has no key
+	 * @param argc {size_t} argv ĳ
+	 *  the size of argv
+	 * @param argv {const char*[]} ڵв
+	 *  all the arguments including the command
+	 * @param lens {size_t[]} ÿĳ
+	 *  the length of every argument
+	 * @return {redis_pipeline&}
+	 */
+	redis_pipeline& add_slot(int slot, size_t argc, const char* argv[],
+		size_t lens[]);
+
+private:
+	struct pipeline_cmd
+	{
+		size_t off;
+		size_t len;
+		int    slot;
+		bool   asking;
+		const char* addr;
+		const redis_result* result;
+	};
+
+	string  cmds_buf_;
+	std::vector<pipeline_cmd> cmds_;
+	bool    flushed_;
+
+	struct pipeline_node
+	{
+		redis_client_pool* conns;
+		redis_client* conn;
+		std::vector<size_t> idx;
+		size_t nreply;
+	};
+
+	void prepare();
+	int  key_slot(const char* key);
+	void add_request(int slot);
+	bool flush_client();
+	bool flush_cluster();
+	redis_client_pool* get_pool(const pipeline_cmd& cmd);
+	bool send_node(pipeline_node& node, std::vector<size_t>& retry,
+		bool& doze);
+	void read_node(pipeline_node& node, std::vector<size_t>& retry,
+		bool& doze);
+	void retry_node(const pipeline_node& node, std::vector<size_t>& retry);
+};
+
+} // namespace acl
@@ -182,6 +182,7 @@ private:
 	~redis_result();
 
 	friend class redis_client;
+	friend class redis_parser;
 	void clear();
 
 	redis_result& set_type(redis_result_t type);
@@ -0,0 +1,261 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <vector>
+#include "acl_cpp/stdlib/noncopyable.hpp"
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
+
+namespace acl
+{
+
+class redis_client_cluster;
+class redis_result;
+class sub_shard;
+class sub_reader;
+class sub_worker;
+
+/**
+ * redis ̶߳ķࣺĵƵ(ģʽ)ϣֵɢ
+ * ϣһ IO ߳ͬʱȡжϵϢٰ
+ * ƵĹϣֵַɸ̣߳ɹ̻߳ص麯 on_message
+ * ͬһƵϢͬһ̰߳˳ԴƵ
+ * ƵϢգӶϿԶ¶е
+ * ƵģʽȺģʽ¶ֲڼȺĸ(Ⱥе
+ * ͨϢн֮㲥)ʵ on_messageúڶ
+ * ߳б
+ * redis multi-threaded subscriber service: the subscribed channels (or
+ * patterns) are spread on several subscribing connections by their hash
+ * values, one dedicated IO thread reads and parses the messages from all
+ * the connections, and dispatches them to the worker threads by the
+ * channels' hash values, the virtual function on_message will be called
+ * in the worker threads, and the messages of the same channel are always
+ * handled by the same worker thread in the receiving order, so a slow
+ * channel handler won't stall other channels; the connections will be
+ * reopened with all the channels and patterns resubscribed automatically
+ * when broken; in cluster mode, the connections are distributed on the
+ * master nodes in turn (the normal pub/sub messages are broadcasted
+ * between all the nodes in cluster); the subclass must implement
+ * on_message, which will be called concurrently by the worker threads
+ */
+class ACL_CPP_API redis_subscriber : public noncopyable
+{
+public:
+	/**
+	 * ģʽµĹ캯
+	 * constructor for single redis server
+	 * @param addr {const char*} redis ַ
+	 *  the redis server's address
+	 * @param shards {size_t} ӵĸΪ 0 ʱڲԶΪ 1
+	 *  the number of subscribing connections, 1 will be used if it's 0
+	 * @param threads {size_t} ̵߳ĸΪ 0 ʱڲԶΪ 1
+	 *  the number of the worker threads, 1 will be used if it's 0
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout of connecting in seconds
+	 * @param rw_timeout {int} дʱʱ()еĶÿһ
+	 *  ʱ䷢һ PINGʱδյӦʱؽ
+	 *  the timeout of IO in seconds, the idle connections will send PING
+	 *  periodically, and will be reopened if no respond in the timeout
+	 */
+	redis_subscriber(const char* addr, size_t shards = 1,
+		size_t threads = 4, int conn_timeout = 10, int rw_timeout = 10);
+
+	/**
+	 * ȺģʽµĹ캯ʹõַȡԼȺ
+	 * ϣӳϵ齫 shards ΪȺĸ
+	 * constructor for redis cluster, the master nodes' addresses used by
+	 * the subscribing connections are got from the mapping between the
+	 * slots and the nodes in the cluster object, the shards should be set
+	 * to the number of the masters
+	 * @param cluster {redis_client_cluster*} Ⱥ볤
+	 *  һӦȵ set_all_slot  start_refresh 
+	 *  the cluster object, which must live longer than this object, and
+	 *  set_all_slot or start_refresh should be called before
+	 * @param shards {size_t} ͬ
+	 *  see above
+	 * @param threads {size_t} ͬ
+	 *  see above
+	 * @param conn_timeout {int} ͬ
+	 *  see above
+	 * @param rw_timeout {int} ͬ
+	 *  see above
+	 */
+	redis_subscriber(redis_client_cluster* cluster, size_t shards = 1,
+		size_t threads = 4, int conn_timeout = 10, int rw_timeout = 10);
+
+	/**
+	 * ڲ stop̻߳ص on_message
+	 * Ӧȵ stop
+	 * destructor, stop will be called internal; because on_message of
+	 * the subclass is called by the worker threads, stop should be called
+	 * in the subclass's destructor first
+	 */
+	virtual ~redis_subscriber();
+
+	/**
+	 * ڵ start ǰÿ߳дϢʱ IO
+	 * ߳̽ͣȡ̴ֱ߳겿Ϣ
+	 * set the max number of the pending messages in each worker thread
+	 * before start, the IO thread will stop reading when exceeding it,
+	 * until some messages were handled by the worker thread
+	 * @param max {size_t} Ϊ 0 ʱʾƣĬֵΪ 100000
+	 *  no limit if it's 0, the default is 100000
+	 */
+	void set_max_queue(size_t max);
+
+	/**
+	 * еĶӲ IO ̼̣߳߳ʧʱ IO ̻߳
+	 * ں̨ÿһһ
+	 * open all the subscribing connections and start the IO thread and
+	 * the worker threads, the IO thread will retry every second in
+	 * background if some connections can't be opened
+	 * @return {bool} Ƿ̣߳ʱ false
+	 *  if all the threads were started, false if started already
+	 */
+	bool start();
+
+	/**
+	 * ֹ̲ͣ߳رжӣ̻߳ȴѽյϢ
+	 *  on_message е
+	 * stop all the threads and close all the subscribing connections, the
+	 * worker threads will handle the received messages first; it mustn't
+	 * be called in on_message
+	 */
+	void stop();
+
+	/**
+	 * һƵ start ǰãҲ on_message 
+	 * ãĵƵ¼ؽԶ¶
+	 * subscribe one or more channels, which can be called before or after
+	 * start, or in on_message; the subscribed channels are saved and will
+	 * be resubscribed automatically after the connections reopened
+	 * @param channel {const char*} Ƶ
+	 *  the channel
+	 * @return {bool} ǷͳɹʧʱӻᱻؽƵ
+	 *  󱻶
+	 *  if the command was sent successfully, if failed the connection
+	 *  will be reopened, and the channel will be subscribed after then
+	 */
+	bool subscribe(const char* channel);
+	bool subscribe(const std::vector<string>& channels);
+
+	/**
+	 * ȡһƵڹ̶߳еĸƵϢȻᱻ
+	 * 
+	 * unsubscribe one or more channels, the messages of the channels
+	 * which are in the worker threads' queues will still be handled
+	 * @param channel {const char*} Ƶ
+	 *  the channel
+	 * @return {bool} ȡǷͳɹ
+	 *  if the command was sent successfully
+	 */
+	bool unsubscribe(const char* channel);
+	bool unsubscribe(const std::vector<string>& channels);
+
+	/**
+	 * һƥģʽģʽĹϣֵ䶩ӣƥ
+	 * ϢȻƵַ߳
+	 * subscribe one or more patterns, the connection is selected by the
+	 * pattern's hash value, and the matched messages are still dispatched
+	 * to the worker threads by the channels
+	 * @param pattern {const char*} ƥģʽ
+	 *  the pattern
+	 * @return {bool} ͬ subscribe
+	 *  see subscribe
+	 */
+	bool psubscribe(const char* pattern);
+	bool psubscribe(const std::vector<string>& patterns);
+
+	/**
+	 * ȡһƥģʽ
+	 * unsubscribe one or more patterns
+	 * @param pattern {const char*} ƥģʽ
+	 *  the pattern
+	 * @return {bool} ͬ unsubscribe
+	 *  see unsubscribe
+	 */
+	bool punsubscribe(const char* pattern);
+	bool punsubscribe(const std::vector<string>& patterns);
+
+	/**
+	 *  IO ߳ѽյϢ
+	 * get the number of the messages received by the IO thread
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_received() const;
+
+	/**
+	 * ù߳ѴϢ
+	 * get the number of the messages handled by the worker threads
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_handled() const;
+
+	/**
+	 * öؽĴ
+	 * get the times of the subscribing connections reopened
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_reconnects() const;
+
+protected:
+	/**
+	 * ڹ߳бصϢʵ
+	 * the message handler called in the worker threads, the subclass
+	 * must implement it
+	 * @param channel {const string&} ϢƵ
+	 *  the channel of the message
+	 * @param msg {const string&} Ϣ
+	 *  the message
+	 * @param pattern {const char*} ͨģʽյϢΪƥģʽ
+	 *  Ϊ NULL
+	 *  the matched pattern if the message was received by pattern, or NULL
+	 */
+	virtual void on_message(const string& channel, const string& msg,
+		const char* pattern) = 0;
+
+	/**
+	 * ؽ¶ĺ IO ߳бصӶϿڼ䷢
+	 * ϢѾʧԾݴ˽в
+	 * called in the IO thread after a connection was reopened and all
+	 * resubscribed, the messages published during the disconnection were
+	 * lost, the subclass can compensate them
+	 * @param addr {const char*} ӵ redis ַ
+	 *  the redis server's address of the new connection
+	 */
+	virtual void on_reconnect(const char* addr)
+	{
+		(void) addr;
+	}
+
+private:
+	friend class sub_reader;
+	friend class sub_worker;
+
+	string addr_;
+	redis_client_cluster* cluster_;
+	int    conn_timeout_;
+	int    rw_timeout_;
+	size_t max_queue_;
+	locker lock_;
+	bool   stop_;
+	unsigned long long received_;
+	unsigned long long reconnects_;
+	unsigned long long handled_;
+	std::vector<sub_shard*> shards_;
+	std::vector<sub_worker*> workers_;
+	sub_reader* reader_;
+
+	void init(size_t shards, size_t threads);
+	bool stopped() const;
+	bool subop(const char* cmd, const std::vector<string>& names);
+	bool open(sub_shard* shard);
+	void close(sub_shard* shard);
+	void get_masters(std::vector<string>& out);
+	void check_ping(sub_shard* shard, time_t now);
+	bool read_shard(sub_shard* shard);
+	void on_result(const redis_result* rr);
+	void run_reader();
+	void run_worker(sub_worker* worker);
+};
+
+} // namespace acl
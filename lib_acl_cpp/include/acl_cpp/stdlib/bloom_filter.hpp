@@ -0,0 +1,202 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+
+struct ACL_BLOOM;
+struct ACL_CUCKOO;
+
+namespace acl
+{
+
+class string;
+
+/**
+ * ֿ鲼¡ڷʴ̻ǰжĳǷһڣ
+ * ֧ɾװ lib_acl е ACL_BLOOM ṹ
+ */
+class ACL_CPP_API bloom_filter
+{
+public:
+	/**
+	 * 캯
+	 * @param capacity {size_t} Ԥӵļĸ
+	 * @param fp_rate {double} 
+	 */
+	bloom_filter(size_t capacity, double fp_rate = 0.01);
+	~bloom_filter();
+
+	/**
+	 * һ
+	 * @param key {const void*} 
+	 * @param len {size_t} key ĳ
+	 * @return {bloom_filter&}
+	 */
+	bloom_filter& add(const void* key, size_t len);
+	bloom_filter& add(const char* key);
+
+	/**
+	 * жĳǷܴ
+	 * @param key {const void*} 
+	 * @param len {size_t} key ĳ
+	 * @return {bool}  false ʾһ
+	 */
+	bool maybe_exists(const void* key, size_t len) const;
+	bool maybe_exists(const char* key) const;
+
+	/**
+	 * еļ
+	 */
+	void reset();
+
+	/**
+	 * ӵļĴ
+	 * @return {acl_uint64}
+	 */
+#ifdef WIN32
+	unsigned __int64 count() const;
+#else
+	unsigned long long count() const;
+#endif
+
+	/**
+	 * л׷ӵ
+	 * @param out {string&} 洢
+	 */
+	void save(string& out) const;
+
+	/**
+	 * л滻ǰĹ
+	 * @param in {const string&}  save ɵ
+	 * @return {bool} ݸʽʱ false ҵǰ
+	 */
+	bool load(const string& in);
+
+	/**
+	 * ļ
+	 * @param path {const char*} ļ·
+	 * @return {bool} Ƿɹ
+	 */
+	bool save_file(const char* path) const;
+
+	/**
+	 * ļе滻ǰĹ
+	 * @param path {const char*}  save_file ɵļ
+	 * @return {bool} ļڻʽʱ false ҵǰ
+	 */
+	bool load_file(const char* path);
+
+	/**
+	 *  lib_acl е C 
+	 * @return {ACL_BLOOM*}
+	 */
+	ACL_BLOOM* get_bloom() const
+	{
+		return bloom_;
+	}
+
+private:
+	ACL_BLOOM* bloom_;
+
+	bloom_filter(const bloom_filter&);
+	const bloom_filter& operator=(const bloom_filter&);
+};
+
+/**
+ *  bloom_filter ÷֧ͬɾװ lib_acl
+ * е ACL_CUCKOO ṹ
+ */
+class ACL_CPP_API cuckoo_filter
+{
+public:
+	/**
+	 * 캯
+	 * @param capacity {size_t} ӵļĸ
+	 */
+	cuckoo_filter(size_t capacity);
+	~cuckoo_filter();
+
+	/**
+	 * һ
+	 * @param key {const void*} 
+	 * @param len {size_t} key ĳ
+	 * @return {bool}  false ʾ
+	 */
+	bool add(const void* key, size_t len);
+	bool add(const char* key);
+
+	/**
+	 * ɾһӹļ
+	 * @param key {const void*} 
+	 * @param len {size_t} key ĳ
+	 * @return {bool}  false ʾ
+	 */
+	bool del(const void* key, size_t len);
+	bool del(const char* key);
+
+	/**
+	 * жĳǷܴ
+	 * @param key {const void*} 
+	 * @param len {size_t} key ĳ
+	 * @return {bool}  false ʾһ
+	 */
+	bool maybe_exists(const void* key, size_t len) const;
+	bool maybe_exists(const char* key) const;
+
+	/**
+	 * еļ
+	 */
+	void reset();
+
+	/**
+	 * üĸ
+	 * @return {acl_uint64}
+	 */
+#ifdef WIN32
+	unsigned __int64 count() const;
+#else
+	unsigned long long count() const;
+#endif
+
+	/**
+	 * л׷ӵ
+	 * @param out {string&} 洢
+	 */
+	void save(string& out) const;
+
+	/**
+	 * л滻ǰĹ
+	 * @param in {const string&}  save ɵ
+	 * @return {bool} ݸʽʱ false ҵǰ
+	 */
+	bool load(const string& in);
+
+	/**
+	 * ļ
+	 * @param path {const char*} ļ·
+	 * @return {bool} Ƿɹ
+	 */
+	bool save_file(const char* path) const;
+
+	/**
+	 * ļе滻ǰĹ
+	 * @param path {const char*}  save_file ɵļ
+	 * @return {bool} ļڻʽʱ false ҵǰ
+	 */
+	bool load_file(const char* path);
+
+	/**
+	 *  lib_acl е C 
+	 * @return {ACL_CUCKOO*}
+	 */
+	ACL_CUCKOO* get_cuckoo() const
+	{
+		return cuckoo_;
+	}
+
+private:
+	ACL_CUCKOO* cuckoo_;
+
+	cuckoo_filter(const cuckoo_filter&);
+	const cuckoo_filter& operator=(const cuckoo_filter&);
+};
+
+} // namespace acl
@@ -0,0 +1,307 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/json_reader.hpp"
+#include "acl_cpp/stdlib/json_writer.hpp"
+
+/**
+ *  app/gson ɵĽṹ json/xml תõĸÿֻ
+ * ͶӦһغṹͶӦͬ gson ڽṹ
+ * ֿռУͨزұģã
+ *  json ʱֱʹ json_reader ȡǣ json 
+ *  field Ϊʱʾֶerr ǿʱųԭ
+ */
+
+namespace acl
+{
+
+class xml;
+class xml_node;
+
+//////////////////////////////////////////////////////////////////////////
+// json token ΪֵĵһǣֵΪ null ʱ޸ı
+
+/**
+ * óԭǷ false
+ * @param in {json_reader&}
+ * @param field {const char*} ֶ
+ * @param msg {const char*} ԭjson_reader ʱʹԭ
+ * @param err {string*} ǿʱųԭ
+ * @return {bool}  false
+ */
+ACL_CPP_API bool gson_error(json_reader& in, const char* field,
+	const char* msg, string* err);
+
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, bool& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, short& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	unsigned short& v, const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, int& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	unsigned int& v, const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, long& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	unsigned long& v, const char* field, string* err);
+#ifdef WIN32
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	__int64& v, const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	unsigned __int64& v, const char* field, string* err);
+#else
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	long long int& v, const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	unsigned long long int& v, const char* field, string* err);
+#endif
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, float& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, double& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token, string& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	std::string& v, const char* field, string* err);
+
+ACL_CPP_API bool gson_get(json_reader& in, json_token_t token,
+	std::vector<bool>& v, const char* field, string* err);
+
+template<typename T>
+bool gson_get(json_reader& in, json_token_t token, std::vector<T>& v,
+	const char* field, string* err);
+template<typename T>
+bool gson_get(json_reader& in, json_token_t token, std::list<T>& v,
+	const char* field, string* err);
+
+//////////////////////////////////////////////////////////////////////////
+// json 
+
+ACL_CPP_API void gson_put(json_writer& out, bool v);
+ACL_CPP_API void gson_put(json_writer& out, short v);
+ACL_CPP_API void gson_put(json_writer& out, unsigned short v);
+ACL_CPP_API void gson_put(json_writer& out, int v);
+ACL_CPP_API void gson_put(json_writer& out, unsigned int v);
+ACL_CPP_API void gson_put(json_writer& out, long v);
+ACL_CPP_API void gson_put(json_writer& out, unsigned long v);
+#ifdef WIN32
+ACL_CPP_API void gson_put(json_writer& out, __int64 v);
+ACL_CPP_API void gson_put(json_writer& out, unsigned __int64 v);
+#else
+ACL_CPP_API void gson_put(json_writer& out, long long int v);
+ACL_CPP_API void gson_put(json_writer& out, unsigned long long int v);
+#endif
+ACL_CPP_API void gson_put(json_writer& out, float v);
+ACL_CPP_API void gson_put(json_writer& out, double v);
+ACL_CPP_API void gson_put(json_writer& out, const string& v);
+ACL_CPP_API void gson_put(json_writer& out, const std::string& v);
+
+template<typename T>
+void gson_put(json_writer& out, const std::vector<T>& v);
+template<typename T>
+void gson_put(json_writer& out, const std::list<T>& v);
+
+//////////////////////////////////////////////////////////////////////////
+// xml node ΪֶζӦĽ㣬͵ֶζӦͬ
+
+/**
+ * óԭǷ false
+ * @param field {const char*} ֶ
+ * @param msg {const char*} ԭ
+ * @param err {string*} ǿʱųԭ
+ * @return {bool}  false
+ */
+ACL_CPP_API bool gson_xml_error(const char* field, const char* msg,
+	string* err);
+
+/**
+ *  xml ݵĸԪأ <?xml ...?> ע͵Ƚ
+ * @param x {xml&}
+ * @return {xml_node*}  NULL ʾûԪ
+ */
+ACL_CPP_API xml_node* gson_xml_root(xml& x);
+
+ACL_CPP_API bool gson_xml_get(xml_node& node, bool& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, short& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, unsigned short& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, int& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, unsigned int& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, long& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, unsigned long& v,
+	const char* field, string* err);
+#ifdef WIN32
+ACL_CPP_API bool gson_xml_get(xml_node& node, __int64& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, unsigned __int64& v,
+	const char* field, string* err);
+#else
+ACL_CPP_API bool gson_xml_get(xml_node& node, long long int& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, unsigned long long int& v,
+	const char* field, string* err);
+#endif
+ACL_CPP_API bool gson_xml_get(xml_node& node, float& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, double& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, string& v,
+	const char* field, string* err);
+ACL_CPP_API bool gson_xml_get(xml_node& node, std::string& v,
+	const char* field, string* err);
+
+ACL_CPP_API bool gson_xml_add(xml_node& node, std::vector<bool>& v,
+	const char* field, string* err);
+
+template<typename T>
+bool gson_xml_add(xml_node& node, std::vector<T>& v,
+	const char* field, string* err);
+template<typename T>
+bool gson_xml_add(xml_node& node, std::list<T>& v,
+	const char* field, string* err);
+
+//////////////////////////////////////////////////////////////////////////
+// xml ɣtag Ϊֶεıǩ
+
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, bool v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, short v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	unsigned short v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, int v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	unsigned int v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, long v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	unsigned long v);
+#ifdef WIN32
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, __int64 v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	unsigned __int64 v);
+#else
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	long long int v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	unsigned long long int v);
+#endif
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, float v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag, double v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	const string& v);
+ACL_CPP_API void gson_xml_put(string& out, const char* tag,
+	const std::string& v);
+
+template<typename T>
+void gson_xml_put(string& out, const char* tag, const std::vector<T>& v);
+template<typename T>
+void gson_xml_put(string& out, const char* tag, const std::list<T>& v);
+
+//////////////////////////////////////////////////////////////////////////
+// ģ壬ԪΪṹʱ gson ɵͬ
+
+template<typename T>
+bool gson_get(json_reader& in, json_token_t token, std::vector<T>& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_BEGIN_ARRAY)
+		return gson_error(in, field, "array expected", err);
+
+	while ((token = in.next()) != JSON_TOKEN_END_ARRAY)
+	{
+		v.push_back(T());
+		if (!gson_get(in, token, v.back(), field, err))
+			return false;
+	}
+	return true;
+}
+
+template<typename T>
+bool gson_get(json_reader& in, json_token_t token, std::list<T>& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_BEGIN_ARRAY)
+		return gson_error(in, field, "array expected", err);
+
+	while ((token = in.next()) != JSON_TOKEN_END_ARRAY)
+	{
+		v.push_back(T());
+		if (!gson_get(in, token, v.back(), field, err))
+			return false;
+	}
+	return true;
+}
+
+template<typename T>
+void gson_put(json_writer& out, const std::vector<T>& v)
+{
+	out.begin_array();
+	for (typename std::vector<T>::const_iterator it = v.begin();
+		it != v.end(); ++it)
+	{
+		gson_put(out, *it);
+	}
+	out.end_array();
+}
+
+template<typename T>
+void gson_put(json_writer& out, const std::list<T>& v)
+{
+	out.begin_array();
+	for (typename std::list<T>::const_iterator it = v.begin();
+		it != v.end(); ++it)
+	{
+		gson_put(out, *it);
+	}
+	out.end_array();
+}
+
+template<typename T>
+bool gson_xml_add(xml_node& node, std::vector<T>& v,
+	const char* field, string* err)
+{
+	v.push_back(T());
+	return gson_xml_get(node, v.back(), field, err);
+}
+
+template<typename T>
+bool gson_xml_add(xml_node& node, std::list<T>& v,
+	const char* field, string* err)
+{
+	v.push_back(T());
+	return gson_xml_get(node, v.back(), field, err);
+}
+
+template<typename T>
+void gson_xml_put(string& out, const char* tag, const std::vector<T>& v)
+{
+	for (typename std::vector<T>::const_iterator it = v.begin();
+		it != v.end(); ++it)
+	{
+		gson_xml_put(out, tag, *it);
+	}
+}
+
+template<typename T>
+void gson_xml_put(string& out, const char* tag, const std::list<T>& v)
+{
+	for (typename std::list<T>::const_iterator it = v.begin();
+		it != v.end(); ++it)
+	{
+		gson_xml_put(out, tag, *it);
+	}
+}
+
+} // namespace acl
@@ -7,6 +7,7 @@
 struct ACL_JSON_NODE;
 struct ACL_JSON;
 struct ACL_ITER;
+struct ACL_SLICE_POOL;
 
 /**
  *  ACL  json ķװ C++ ûʹã̫עأ
@@ -67,6 +68,19 @@ public:
 	 */
 	const string& to_string(void);
 
+	/**
+	 * ǰ json ת MessagePack ʽĶݣǩ
+	 * תΪֻһԱĶ
+	 * @param out {string&} ת׷ڸû
+	 */
+	void build_msgpack(string& out) const;
+
+	/**
+	 * ǰ json ת CBOR ʽĶݣͬ build_msgpack
+	 * @param out {string&} ת׷ڸû
+	 */
+	void build_cbor(string& out) const;
+
 	/**
 	 *  json  json_node ӽ
 	 * @param child {json_node*} ӽ
@@ -292,15 +306,44 @@ public:
 	 */
 	json& part_word(bool on);
 
+	/**
+	 * Ƿʹñǩڽǰʱɽ߽߽
+	 * ʱһν˺󰴱ǩѯ
+	 * ʱٱڶͬһ json βѯĳ
+	 * @param on {bool}
+	 * @return {json&}
+	 */
+	json& use_index(bool on);
+
 	/**
 	 * ʽʽѭñ json ݣҲһ
 	 *  json ݣظʹø json  json
 	 * Ӧڽһ json ǰ reset() 
-	 * һεĽ
+	 * һεĽ״νݽ϶ʱ㼰ַɱ
+	 * ڴƬط䣬reset() ظʱѷڴ
 	 * @param data {const char*} json 
 	 */
 	void update(const char* data);
 
+	/**
+	 * һ MessagePack  json ɵĽ
+	 *  update  json ıʱͬԱĴ벻Ҫ޸
+	 * @param data {const void*} ݣΪ map  array
+	 * @param len {size_t} ݳ
+	 * @return {int} > 0 ʾɹõݳȣ0 ʾ
+	 *  Ӧݺ½-1 ʾݸʽ json 
+	 *  ʹǰûе reset()
+	 */
+	int update_msgpack(const void* data, size_t len);
+
+	/**
+	 * һ CBOR  json ͬ update_msgpack
+	 * @param data {const void*} ݣΪ map  array
+	 * @param len {size_t} ݳ
+	 * @return {int} ͬ update_msgpack
+	 */
+	int update_cbor(const void* data, size_t len);
+
 	/**
 	 *  json ״̬ json Զ json 
 	 * нڷʹñ json ǰҪñ
@@ -495,6 +538,19 @@ public:
 	 */
 	void build_json(string& out);
 
+	/**
+	 *  json ת MessagePack ʽĶݣ create_node
+	 * ȴֵתΪӦĶͣҶתΪַ
+	 * @param out {string&} ת׷ڸû
+	 */
+	void build_msgpack(string& out);
+
+	/**
+	 *  json ת CBOR ʽĶݣͬ build_msgpack
+	 * @param out {string&} ת׷ڸû
+	 */
+	void build_cbor(string& out);
+
 	/**
 	 *  json ת json ַ
 	 * @return {const string&}
@@ -521,6 +577,10 @@ private:
 	// 
 	string* buf_;
 	ACL_ITER* iter_;
+	// ʱڴƬ
+	ACL_SLICE_POOL* slice_;
+
+	void use_slice(void);
 };
 
 } // namespace acl
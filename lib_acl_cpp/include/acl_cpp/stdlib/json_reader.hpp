@@ -0,0 +1,222 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+
+namespace acl
+{
+
+/**
+ * json_reader::next صı
+ */
+typedef enum
+{
+	JSON_TOKEN_ERROR = -1,		// ݸʽ򳬳
+	JSON_TOKEN_MORE,		// Ҫ
+	JSON_TOKEN_EOF,			// Ѿ
+	JSON_TOKEN_BEGIN_OBJECT,	// {
+	JSON_TOKEN_END_OBJECT,		// }
+	JSON_TOKEN_BEGIN_ARRAY,		// [
+	JSON_TOKEN_END_ARRAY,		// ]
+	JSON_TOKEN_KEY,			// Ա
+	JSON_TOKEN_STRING,		// ֵַ
+	JSON_TOKEN_NUMBER,		// ֵ
+	JSON_TOKEN_BOOL,		// true  false
+	JSON_TOKEN_NULL			// null
+} json_token_t;
+
+class istream;
+
+/**
+ * ʽ json ȡ json еıǶ json 
+ * ݿԷֿ룻ռڴֻ뵥ǵĳȼǶйأ
+ * ݵĴС޹أֻȡֶεĳϣҪ
+ * ͨ skip ݽн
+ *  json ݿ(ÿһ json ־)ÿݽʱ
+ * depth() Ϊ 0ݽ next  JSON_TOKEN_EOF
+ *
+ * ÷һжȡ HTTP 壺
+ *  acl::json_reader reader(req.getInputStream(), req.getContentLength());
+ *  acl::json_token_t token;
+ *  while ((token = reader.next()) > acl::JSON_TOKEN_EOF) { ... }
+ *
+ * ÷ɵݣ
+ *  reader.update(data, len);
+ *  while ((token = reader.next()) > acl::JSON_TOKEN_EOF) { ... }
+ *   JSON_TOKEN_MORE  update ݣȫ
+ *   update_end()
+ */
+class ACL_CPP_API json_reader
+{
+public:
+	/**
+	 * 캯ɵͨ update 
+	 */
+	json_reader();
+
+	/**
+	 * 캯жȡ
+	 * @param in {istream&} 
+	 * @param len {long long int} ȡݳȣ< 0 ʱ
+	 */
+#ifdef WIN32
+	json_reader(istream& in, __int64 len = -1);
+#else
+	json_reader(istream& in, long long int len = -1);
+#endif
+	~json_reader();
+
+	/**
+	 * Դƣʱ next  JSON_TOKEN_ERROR
+	 * @param max_token {size_t} (ֵַ)󳤶
+	 * @param max_depth {size_t} Ƕ
+	 * @return {json_reader&}
+	 */
+	json_reader& set_limits(size_t max_token, size_t max_depth);
+
+	/**
+	 * ݣݱڲӦ next 
+	 * JSON_TOKEN_MORE ݣӶ֤ڲ
+	 * @param data {const char*} 
+	 * @param len {size_t} ݳ
+	 */
+	void update(const char* data, size_t len);
+
+	/**
+	 * ֪ͨѾȫ
+	 */
+	void update_end();
+
+	/**
+	 * ȡһ
+	 * @return {json_token_t}  JSON_TOKEN_MORE ʱҪݣ
+	 *   JSON_TOKEN_EOF ʾѾ JSON_TOKEN_ERROR
+	 *  ʾͨ get_error ôԭ
+	 */
+	json_token_t next();
+
+	/**
+	 * շصıӦֵΪ JSON_TOKEN_BEGIN_OBJECT 
+	 * JSON_TOKEN_BEGIN_ARRAY ʱ()Ϊ
+	 * JSON_TOKEN_KEY ʱóԱֵֻżŶ
+	 * ʽҲ max_token 
+	 * @return {bool} շصıΪʱ false
+	 */
+	bool skip();
+
+	/**
+	 * õǰǵıַȥŲת
+	 * @return {const string&}
+	 */
+	const string& get_text() const
+	{
+		return text_;
+	}
+
+	/**
+	 * ǰΪ JSON_TOKEN_BOOL ʱֵ
+	 * @return {bool}
+	 */
+	bool get_bool() const;
+
+	/**
+	 * ǰΪ JSON_TOKEN_NUMBER ʱֵ
+	 * @return {long long int}
+	 */
+#ifdef WIN32
+	__int64 get_int64() const;
+#else
+	long long int get_int64() const;
+#endif
+
+	/**
+	 * ǰΪ JSON_TOKEN_NUMBER ʱ両ֵ
+	 * @return {double}
+	 */
+	double get_double() const;
+
+	/**
+	 * ǰڵǶȣλʱΪ 0
+	 * @return {size_t}
+	 */
+	size_t depth() const
+	{
+		return stack_.size();
+	}
+
+	/**
+	 * ʱóԭ
+	 * @return {const char*}
+	 */
+	const char* get_error() const
+	{
+		return error_.c_str();
+	}
+
+	/**
+	 * öȡ״̬ԱڽµݣԴƱֲ
+	 */
+	void reset();
+
+private:
+	istream* in_;
+#ifdef WIN32
+	__int64 in_left_;
+	__int64 offset_;
+#else
+	long long int in_left_;
+	long long int offset_;
+#endif
+	string buf_;
+	size_t pos_;
+	bool   eof_;
+
+	size_t max_token_;
+	size_t max_depth_;
+	std::vector<char> stack_;
+
+	int    expect_;
+	int    lex_;
+	int    status_;
+	json_token_t last_;
+	string text_;
+	string error_;
+
+	// ַתַ
+	bool   is_key_;
+	int    esc_;
+	unsigned int ucs_;
+	unsigned int high_;
+
+	// true, false, null
+	const char* literal_;
+	size_t literal_pos_;
+
+	// 
+	bool   skip_value_;
+	bool   discard_;
+	bool   raw_;
+	bool   raw_str_;
+	bool   raw_esc_;
+	size_t raw_level_;
+
+	void init();
+	bool fill();
+	int  parse();
+	int  parse_value(char ch);
+	int  parse_string();
+	int  parse_number();
+	int  parse_literal();
+	int  parse_raw();
+	int  finish();
+	int  value_done(json_token_t token);
+	int  error(const char* msg);
+	bool append(const char* s, size_t n);
+	bool append_ucs(unsigned int ucs);
+	bool flush_high();
+
+	json_reader(const json_reader&);
+	const json_reader& operator=(const json_reader&);
+};
+
+} // namespace acl
@@ -0,0 +1,194 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <vector>
+
+namespace acl
+{
+
+class string;
+class ostream;
+class aio_ostream;
+class HttpServletResponse;
+
+/**
+ * ʽ json ɱдҪȴ json תΪ
+ * ַռڴֻй̶Сдɺܴ json ݣ
+ * ԱԪ֮ĶԶӡ
+ *
+ * ÷
+ *  acl::json_writer writer(res);  // res Ϊ HttpServletResponse
+ *  writer.begin_object()
+ *      .key("name").value("zsx")
+ *      .key("list").begin_array();
+ *  for (...)
+ *      writer.value(i);
+ *  writer.end_array().end_object();
+ *  if (writer.finish() == false) { ... }
+ */
+class ACL_CPP_API json_writer
+{
+public:
+	/**
+	 * 캯ɵд
+	 * @param out {ostream&}  socket_stream  ofstream
+	 * @param size {size_t} дСʱд
+	 */
+	json_writer(ostream& out, size_t size = 8192);
+
+	/**
+	 * 캯ɵΪ HTTP Ӧ巢ͣͨ
+	 * setChunkedTransferEncoding  chunked ʽʱÿд
+	 * ʱһݿ飬 finish ʱͽ
+	 * @param res {HttpServletResponse&}
+	 * @param size {size_t} дС
+	 */
+	json_writer(HttpServletResponse& res, size_t size = 8192);
+
+	/**
+	 * 캯ɵд첽Уע첽ݲ
+	 * ʱڲ
+	 * @param out {aio_ostream&}
+	 * @param size {size_t} дС
+	 */
+	json_writer(aio_ostream& out, size_t size = 8192);
+
+	/**
+	 * 캯ɵ׷ַ
+	 * @param out {string&}
+	 */
+	json_writer(string& out);
+
+	~json_writer();
+
+	/**
+	 * ʼһ {
+	 * @return {json_writer&}
+	 */
+	json_writer& begin_object();
+
+	/**
+	 * ǰĶ }
+	 * @return {json_writer&}
+	 */
+	json_writer& end_object();
+
+	/**
+	 * ʼһ [
+	 * @return {json_writer&}
+	 */
+	json_writer& begin_array();
+
+	/**
+	 * ǰ ]
+	 * @return {json_writer&}
+	 */
+	json_writer& end_array();
+
+	/**
+	 * дԱƣӦдóԱֵ
+	 * @param name {const char*} Աת
+	 * @return {json_writer&}
+	 */
+	json_writer& key(const char* name);
+	json_writer& key(const char* name, size_t len);
+
+	/**
+	 * дֵַת壻s Ϊ NULL ʱд null
+	 * @param s {const char*}
+	 * @return {json_writer&}
+	 */
+	json_writer& value(const char* s);
+	json_writer& value(const char* s, size_t len);
+	json_writer& value(const string& s);
+
+	/**
+	 * дֵ
+	 * @param n {long long int}
+	 * @return {json_writer&}
+	 */
+#ifdef WIN32
+	json_writer& value(__int64 n);
+#else
+	json_writer& value(long long int n);
+#endif
+	json_writer& value(int n);
+	json_writer& value(double n);
+
+	/**
+	 * д벼ֵ
+	 * @param b {bool}
+	 * @return {json_writer&}
+	 */
+	json_writer& value(bool b);
+
+	/**
+	 * д null
+	 * @return {json_writer&}
+	 */
+	json_writer& value_null();
+
+	/**
+	 * Ѿɺõ json Ϊһֵԭд
+	 * @param data {const char*}
+	 * @param len {size_t}
+	 * @return {json_writer&}
+	 */
+	json_writer& raw(const char* data, size_t len);
+
+	/**
+	 * дед
+	 * @return {bool} дǷɹ
+	 */
+	bool flush();
+
+	/**
+	 * Ϻãд뻺ʣݣ chunked ʽ
+	 * HTTP Ӧᷢͽ
+	 * @return {bool} дǷɹδʱҲ false
+	 */
+	bool finish();
+
+	/**
+	 * дǷʧܣʧܺݾ
+	 * @return {bool}
+	 */
+	bool failed() const
+	{
+		return failed_;
+	}
+
+	/**
+	 * ǰǶ
+	 * @return {size_t}
+	 */
+	size_t depth() const
+	{
+		return stack_.size();
+	}
+
+private:
+	ostream* out_;
+	HttpServletResponse* res_;
+	aio_ostream* aio_;
+	string* str_;
+
+	char*  buf_;
+	size_t size_;
+	size_t len_;
+	bool   failed_;
+
+	// ÿǷҪһֵ֮ǰӶ
+	std::vector<bool> stack_;
+	bool   after_key_;
+
+	void init(size_t size);
+	void separate();
+	void put(const char* s, size_t n);
+	void put(char ch);
+	void put_escape(const char* s, size_t n);
+
+	json_writer(const json_writer&);
+	const json_writer& operator=(const json_writer&);
+};
+
+} // namespace acl
@@ -299,6 +299,15 @@ public:
 	xml& part_word(bool on);
 	xml& ignore_slash(bool on);
 
+	/**
+	 * Ƿʹñǩڽǰʱɽ߽߽
+	 * ʱһν˺󰴱ǩѯ
+	 * ʱٱڶͬһ XML βѯĳ
+	 * @param on {bool}
+	 * @return {xml&}
+	 */
+	xml& use_index(bool on);
+
 	/**
 	 * ʽʽѭñ XML ݣҲһ
 	 *  XML ݣظʹø XML  XML
@@ -0,0 +1,290 @@
+#include "stdafx.h"
+#include "util.h"
+
+class dummy_client : public acl::connect_client
+{
+public:
+	dummy_client() {}
+	~dummy_client() {}
+
+	bool open()
+	{
+		return true;
+	}
+};
+
+// ӳأģʱǷʧ
+class dummy_pool : public acl::connect_pool
+{
+public:
+	dummy_pool(const char* addr, int count, size_t idx)
+	: acl::connect_pool(addr, count, idx), cost_(500), fail_(false) {}
+	~dummy_pool() {}
+
+	int cost_;		// ģʱ(΢)
+	bool fail_;		// ģʧ
+
+protected:
+	acl::connect_client* create_connect()
+	{
+		return new dummy_client;
+	}
+};
+
+class dummy_manager : public acl::connect_manager
+{
+public:
+	dummy_manager(int n)
+	{
+		acl::string addr;
+		for (int i = 0; i < n; i++)
+		{
+			addr.format("192.168.1.%d:11211", i);
+			set(addr, 10);
+		}
+	}
+
+	~dummy_manager() {}
+
+	dummy_pool& pool(int i)
+	{
+		return *(dummy_pool*) get_pools()[i];
+	}
+
+protected:
+	acl::connect_pool* create_pool(const char* addr, int count, size_t idx)
+	{
+		return new dummy_pool(addr, count, idx);
+	}
+};
+
+//  count ģͳÿӳطֵõ
+static void run(dummy_manager& manager, int count, std::vector<int>& hits)
+{
+	hits.assign(manager.size(), 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		dummy_pool* pool = (dummy_pool*) manager.peek();
+		if (pool == NULL)
+			continue;
+		acl::connect_client* conn = pool->peek();
+		if (conn == NULL)
+			continue;
+
+		usleep(pool->cost_);
+		pool->put(conn, !pool->fail_);
+
+		for (size_t j = 0; j < manager.size(); j++)
+		{
+			if (&manager.pool((int) j) == pool)
+				hits[j]++;
+		}
+	}
+}
+
+static void show(const char* name, const std::vector<int>& hits)
+{
+	printf("%s:", name);
+	for (size_t i = 0; i < hits.size(); i++)
+		printf(" %d", hits[i]);
+	printf("\r\n");
+}
+
+// ѭʽֵͬ󣬰ѡȡʱԼ
+static void test_slow(void)
+{
+	std::vector<int> hits;
+
+	dummy_manager rr(4);
+	rr.pool(0).cost_ = 5000;
+	run(rr, 400, hits);
+	show("round robin, server 0 slow", hits);
+	CHECK(hits[0] == 100);
+
+	dummy_manager p2c(4);
+	p2c.set_balance(acl::CONNECT_BALANCE_P2C);
+	p2c.set_outlier(5, 0);
+	p2c.pool(0).cost_ = 5000;
+	run(p2c, 400, hits);
+	show("p2c, server 0 slow", hits);
+	CHECK(hits[0] < 40);
+	CHECK(p2c.pool(0).get_latency() > 4.0);
+	CHECK(p2c.pool(1).get_latency() < 4.0);
+	CHECK(p2c.pool(0).get_inflight() == 0);
+}
+
+// ʧܵķժָ
+static void test_failures(void)
+{
+	std::vector<int> hits;
+
+	dummy_manager manager(4);
+	manager.set_balance(acl::CONNECT_BALANCE_P2C);
+	manager.set_outlier(1, 0, 2, 2);
+
+	// ʧܵʹӳټӱܿò
+	manager.pool(2).fail_ = true;
+	run(manager, 100, hits);
+	show("p2c, server 2 failing", hits);
+	CHECK(manager.pool(2).get_failures() >= 1
+		|| manager.pool(2).is_ejected());
+	CHECK(hits[2] <= 5);
+
+	// һļбժ
+	sleep(1);
+	run(manager, 200, hits);
+	show("p2c, server 2 ejected", hits);
+	CHECK(manager.pool(2).is_ejected());
+	CHECK(hits[2] == 0);
+
+	// ժʱ𲽻ָָڼֵõ
+	manager.pool(2).fail_ = false;
+	while (manager.pool(2).is_ejected())
+		acl_doze(100);
+
+	run(manager, 400, hits);
+	show("p2c, server 2 recovering", hits);
+	CHECK(hits[2] > 0 && hits[2] < 100);
+
+	// ȫָ²ѡȡ
+	sleep(3);
+	run(manager, 400, hits);
+	show("p2c, server 2 recovered", hits);
+	CHECK(hits[2] > 0);
+	CHECK(!manager.pool(2).is_ejected());
+}
+
+// ӳԶķժ
+static void test_latency(void)
+{
+	std::vector<int> hits;
+
+	dummy_manager manager(4);
+	manager.set_balance(acl::CONNECT_BALANCE_P2C);
+	manager.set_outlier(0, 3.0, 5, 5);
+	manager.pool(3).cost_ = 10000;
+
+	// ֤ÿӳٲ
+	for (int i = 0; i < 4; i++)
+	{
+		acl::connect_client* conn = manager.pool(i).peek();
+		usleep(manager.pool(i).cost_);
+		manager.pool(i).put(conn);
+	}
+
+	sleep(1);
+	run(manager, 200, hits);
+	show("p2c, server 3 latency outlier", hits);
+	CHECK(manager.pool(3).is_ejected());
+	CHECK(hits[3] == 0);
+}
+
+// ͬʱժķޣȫʱ˻ѭ
+static void test_max_eject(void)
+{
+	std::vector<int> hits;
+
+	dummy_manager manager(4);
+	manager.set_balance(acl::CONNECT_BALANCE_P2C);
+	manager.set_outlier(5, 0, 10, 10, 50);
+	for (int i = 0; i < 4; i++)
+		manager.pool(i).fail_ = true;
+
+	run(manager, 100, hits);
+	sleep(1);
+	run(manager, 100, hits);
+
+	int ejected = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		if (manager.pool(i).is_ejected())
+			ejected++;
+	}
+	printf("p2c, all failing: %d of 4 ejected\r\n", ejected);
+	CHECK(ejected == 2);
+
+	dummy_manager all(2);
+	all.set_balance(acl::CONNECT_BALANCE_P2C);
+	all.set_outlier(1, 0, 10, 10, 100);
+	all.pool(0).fail_ = all.pool(1).fail_ = true;
+	run(all, 10, hits);
+	sleep(1);
+	run(all, 10, hits);
+	CHECK(all.pool(0).is_ejected() && all.pool(1).is_ejected());
+	CHECK(all.peek() != NULL);
+}
+
+static void benchmark(int count)
+{
+	acl::connect_balance_t types[] = {
+		acl::CONNECT_BALANCE_ROUND_ROBIN,
+		acl::CONNECT_BALANCE_P2C,
+	};
+
+	for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+	{
+		dummy_manager manager(10);
+		manager.set_balance(types[i]);
+
+		struct timeval begin, end;
+		gettimeofday(&begin, NULL);
+		for (int j = 0; j < count; j++)
+		{
+			acl::connect_pool* pool = manager.peek();
+			acl::connect_client* conn = pool->peek();
+			pool->put(conn);
+		}
+		gettimeofday(&end, NULL);
+
+		double spent = util::stamp_sub(&end, &begin);
+		printf("%s: %d peek/put, spent: %.2f ms, %.2f ops/s\r\n",
+			i == 0 ? "round robin" : "p2c", count, spent,
+			count * 1000 / (spent > 0 ? spent : 1));
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-n count[default: 1000000]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 1000000;
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hn:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+
+	if (bench)
+		benchmark(n);
+	else
+	{
+		test_slow();
+		test_failures();
+		test_latency();
+		test_max_eject();
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,461 @@
+#include "stdafx.h"
+#include "util.h"
+
+static acl::locker __lock;
+static int __opened = 0, __closed = 0, __pools_freed = 0;
+
+// Ϊ true ʱģ˲ãӵȴһʱʧ
+static bool __down = false;
+static int __refused = 0;
+
+// ӣֻ¼ͷŵĴ
+class dummy_client : public acl::connect_client
+{
+public:
+	dummy_client() {}
+	~dummy_client()
+	{
+		__lock.lock();
+		__closed++;
+		__lock.unlock();
+	}
+
+	bool open()
+	{
+		__lock.lock();
+		bool down = __down;
+		if (down)
+			__refused++;
+		else
+			__opened++;
+		__lock.unlock();
+
+		if (down)
+			acl_doze(100);
+		return !down;
+	}
+};
+
+class dummy_pool : public acl::connect_pool
+{
+public:
+	dummy_pool(const char* addr, int count, size_t idx)
+	: acl::connect_pool(addr, count, idx) {}
+
+	~dummy_pool()
+	{
+		__lock.lock();
+		__pools_freed++;
+		__lock.unlock();
+	}
+
+	int get_conns() const
+	{
+		return count_;
+	}
+
+protected:
+	acl::connect_client* create_connect()
+	{
+		return new dummy_client;
+	}
+};
+
+class dummy_manager : public acl::connect_manager
+{
+public:
+	dummy_manager() {}
+	~dummy_manager() {}
+
+protected:
+	acl::connect_pool* create_pool(const char* addr, int count, size_t idx)
+	{
+		return new dummy_pool(addr, count, idx);
+	}
+};
+
+// ӳػȡ黹
+class worker : public acl::thread
+{
+public:
+	worker(acl::connect_pool& pool, int count)
+	: pool_(pool), count_(count), failed_(0) {}
+	~worker() {}
+
+	int failed_count() const
+	{
+		return failed_;
+	}
+
+protected:
+	void* run()
+	{
+		for (int i = 0; i < count_; i++)
+		{
+			acl::connect_client* conn = pool_.peek();
+			if (conn == NULL)
+			{
+				failed_++;
+				continue;
+			}
+			pool_.put(conn);
+		}
+		return NULL;
+	}
+
+private:
+	acl::connect_pool& pool_;
+	int count_;
+	int failed_;
+};
+
+// һӷ뱾̻߳ȴֱ֪ͨ˳
+class holder : public acl::thread
+{
+public:
+	holder(acl::connect_pool& pool) : pool_(pool), ready_(false), quit_(false) {}
+	~holder() {}
+
+	void wait_ready()
+	{
+		while (true)
+		{
+			lock_.lock();
+			bool ready = ready_;
+			lock_.unlock();
+			if (ready)
+				break;
+			acl_doze(1);
+		}
+	}
+
+	void quit()
+	{
+		lock_.lock();
+		quit_ = true;
+		lock_.unlock();
+	}
+
+protected:
+	void* run()
+	{
+		acl::connect_client* conn = pool_.peek();
+		if (conn != NULL)
+			pool_.put(conn);
+
+		lock_.lock();
+		ready_ = true;
+		lock_.unlock();
+
+		while (true)
+		{
+			lock_.lock();
+			bool quit = quit_;
+			lock_.unlock();
+			if (quit)
+				break;
+			acl_doze(1);
+		}
+		return NULL;
+	}
+
+private:
+	acl::connect_pool& pool_;
+	acl::locker lock_;
+	bool ready_;
+	bool quit_;
+};
+
+static void run_workers(acl::connect_pool& pool, int nthreads, int count,
+	int& failed, double& spent)
+{
+	std::vector<worker*> workers;
+	struct timeval begin, end;
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < nthreads; i++)
+	{
+		worker* w = new worker(pool, count);
+		w->set_detachable(false);
+		w->start();
+		workers.push_back(w);
+	}
+
+	failed = 0;
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i]->wait();
+		failed += workers[i]->failed_count();
+		delete workers[i];
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+}
+
+static void benchmark(int nthreads, int count, size_t cache)
+{
+	dummy_pool pool("127.0.0.1:1", nthreads * 2, 0);
+	pool.set_thread_cache(cache);
+
+	int failed;
+	double spent;
+	run_workers(pool, nthreads, count, failed, spent);
+
+	long long total = (long long) nthreads * count;
+	printf("cache %d: %d threads, %lld peek/put, spent %.2f ms, "
+		"%.2f ops/s\r\n", (int) cache, nthreads, total, spent,
+		total * 1000 / (spent > 0 ? spent : 1));
+	printf("  conns: %d, lock: %llu, contended: %llu, wait: %llu us, "
+		"cache hits: %llu, total used: %llu\r\n", pool.get_conns(),
+		pool.get_lock_count(), pool.get_lock_contended(),
+		pool.get_lock_wait(), pool.get_cache_hits(),
+		pool.get_total_used());
+
+	CHECK(failed == 0);
+	CHECK(pool.get_conns() <= nthreads);
+}
+
+// ̻߳ĻΪСޡ߳˳黹
+static void test_cache(void)
+{
+	dummy_pool pool("127.0.0.1:1", 10, 0);
+	pool.set_thread_cache(1);
+
+	// 黹ĵһӽ̻߳棬ڶ빲
+	acl::connect_client* conn1 = pool.peek();
+	acl::connect_client* conn2 = pool.peek();
+	CHECK(conn1 != NULL && conn2 != NULL && conn1 != conn2);
+	pool.put(conn1);
+	pool.put(conn2);
+	CHECK(pool.get_idle_count() == 1);
+
+	unsigned long long locks = pool.get_lock_count();
+	CHECK(pool.peek() == conn1);
+	CHECK(pool.get_lock_count() == locks);
+	pool.put(conn1);
+
+	// ӵʹô̻߳ʱͬͳ
+	for (int i = 0; i < 200; i++)
+		pool.put(pool.peek());
+	CHECK(pool.get_cache_hits() >= 128);
+	CHECK(pool.get_lock_count() == locks);
+
+	// ֱֵӹر
+	int closed = __closed;
+	acl::connect_client* conn = pool.peek();
+	pool.put(conn, false);
+	CHECK(__closed == closed + 1);
+	CHECK(pool.get_conns() == 1);
+
+	// ߳˳ʱ仺ӹ黹
+	holder h(pool);
+	h.set_detachable(false);
+	h.start();
+	h.wait_ready();
+	CHECK(pool.get_idle_count() == 0);
+	h.quit();
+	h.wait();
+	CHECK(pool.get_idle_count() == 1);
+	CHECK(pool.get_conns() == 1);
+}
+
+// ﵽʱ̻߳Ŀ
+static void test_steal(void)
+{
+	dummy_pool pool("127.0.0.1:1", 1, 0);
+	pool.set_thread_cache(1);
+
+	holder h(pool);
+	h.set_detachable(false);
+	h.start();
+	h.wait_ready();
+
+	CHECK(pool.get_idle_count() == 0);
+	acl::connect_client* conn = pool.peek();
+	CHECK(conn != NULL);
+	CHECK(pool.get_conns() == 1);
+	CHECK(pool.peek() == NULL);
+	pool.put(conn);
+
+	h.quit();
+	h.wait();
+}
+
+// ӹʱ̻߳еͬͷ
+static void test_idle(void)
+{
+	dummy_pool pool("127.0.0.1:1", 10, 0);
+	pool.set_thread_cache(2);
+
+	holder h(pool);
+	h.set_detachable(false);
+	h.start();
+	h.wait_ready();
+
+	acl::connect_client* conn = pool.peek();
+	pool.put(conn);
+	CHECK(pool.get_conns() == 2);
+
+	CHECK(pool.check_idle(3600) == 0);
+	CHECK(pool.check_idle(0) == 2);
+	CHECK(pool.get_conns() == 0);
+
+	h.quit();
+	h.wait();
+	CHECK(pool.get_conns() == 0);
+	CHECK(pool.get_idle_count() == 0);
+}
+
+// ӳرɾʱе̻߳ӱһͷ
+static void test_destroy(void)
+{
+	int freed = __pools_freed;
+	dummy_manager* manager = new dummy_manager;
+	manager->set_thread_cache(1);
+	manager->set("127.0.0.1:1", 10);
+	manager->set("127.0.0.1:2", 10);
+
+	holder h1(*manager->get("127.0.0.1:1")), h2(*manager->get("127.0.0.1:2"));
+	h1.set_detachable(false);
+	h2.set_detachable(false);
+	h1.start();
+	h2.start();
+	h1.wait_ready();
+	h2.wait_ready();
+
+	int closed = __closed;
+	manager->remove("127.0.0.1:1");
+	CHECK(__pools_freed == freed + 1);
+	CHECK(__closed == closed + 1);
+
+	delete manager;
+	CHECK(__pools_freed == freed + 2);
+	CHECK(__closed == closed + 2);
+
+	h1.quit();
+	h2.quit();
+	h1.wait();
+	h2.wait();
+}
+
+// ӹͬʱ߳˳黹仺ӣӳȴ
+// ̹߳黹Ϻܱ
+static void test_exit(void)
+{
+	int freed = __pools_freed;
+	const char* addrs[] = { "127.0.0.1:1", "127.0.0.1:2" };
+
+	for (int round = 0; round < 100; round++)
+	{
+		dummy_manager* manager = new dummy_manager;
+		manager->set_thread_cache(1);
+		manager->set(addrs[0], 10);
+		manager->set(addrs[1], 10);
+
+		std::vector<holder*> holders;
+		for (int i = 0; i < 16; i++)
+		{
+			holder* h = new holder(*manager->get(addrs[i % 2]));
+			h->set_detachable(false);
+			h->start();
+			holders.push_back(h);
+		}
+		for (size_t i = 0; i < holders.size(); i++)
+			holders[i]->wait_ready();
+
+		for (size_t i = 0; i < holders.size(); i++)
+			holders[i]->quit();
+		delete manager;
+
+		for (size_t i = 0; i < holders.size(); i++)
+		{
+			holders[i]->wait();
+			delete holders[i];
+		}
+	}
+
+	CHECK(__pools_freed == freed + 200);
+}
+
+// ˲ʱֻһ߳̽ӣ̵߳ȴֱӷأ
+// ָ߳ȻԲؽ
+static void test_down(void)
+{
+	dummy_pool pool("127.0.0.1:1", 10, 0);
+	pool.set_retry_inter(60);
+
+	__down = true;
+	int refused = __refused, failed;
+	double spent;
+	run_workers(pool, 8, 1, failed, spent);
+	printf("down: %d threads failed, %d connects, spent %.2f ms\r\n",
+		failed, __refused - refused, spent);
+	CHECK(failed == 8);
+	CHECK(__refused == refused + 1);
+	CHECK(spent < 400);
+
+	__down = false;
+	pool.set_alive(true);
+	run_workers(pool, 8, 1000, failed, spent);
+	CHECK(failed == 0);
+	CHECK(pool.get_conns() > 0 && pool.get_conns() <= 8);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-t threads[default: 64]\r\n"
+		"-n count per thread[default: 100000]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, nthreads = 64, n = 100000;
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "ht:n:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 't':
+			nthreads = atoi(optarg);
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+
+	if (bench)
+	{
+		benchmark(nthreads, n, 0);
+		benchmark(nthreads, n, 1);
+	}
+	else
+	{
+		test_cache();
+		test_steal();
+		test_idle();
+		test_destroy();
+		test_exit();
+		test_down();
+		benchmark(8, 10000, 0);
+		benchmark(8, 10000, 1);
+		printf("opened: %d, refused: %d, closed: %d\r\n",
+			__opened, __refused, __closed);
+		CHECK(__opened + __refused == __closed);
+	}
+
+	return util::check_result();
+}
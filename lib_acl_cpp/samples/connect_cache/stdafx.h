@@ -0,0 +1,19 @@
+// stdafx.h : ׼ϵͳļİļ
+// ǳõĵĿضİļ
+//
+
+#pragma once
+
+
+//#include <iostream>
+//#include <tchar.h>
+
+// TODO: ڴ˴óҪĸͷļ
+
+#include "lib_acl.h"
+#include "acl_cpp/lib_acl.hpp"
+
+#ifdef	WIN32
+#define	snprintf _snprintf
+#endif
+
@@ -0,0 +1,290 @@
+#include "stdafx.h"
+#include <math.h>
+#include "util.h"
+
+// ӳأֵֻ֤ķֲ
+class dummy_pool : public acl::connect_pool
+{
+public:
+	dummy_pool(const char* addr, int count, size_t idx)
+	: acl::connect_pool(addr, count, idx) {}
+	~dummy_pool() {}
+
+protected:
+	acl::connect_client* create_connect()
+	{
+		return NULL;
+	}
+};
+
+class dummy_manager : public acl::connect_manager
+{
+public:
+	dummy_manager(acl::connect_hash_t type)
+	{
+		set_key_hash(type);
+		set_retry_inter(3600);
+	}
+	~dummy_manager() {}
+
+	void add(int from, int to)
+	{
+		acl::string addr;
+		for (int i = from; i < to; i++)
+		{
+			addr.format("192.168.1.%d:11211", i);
+			set(addr, 10);
+		}
+	}
+
+protected:
+	acl::connect_pool* create_pool(const char* addr, int count, size_t idx)
+	{
+		return new dummy_pool(addr, count, idx);
+	}
+};
+
+static const char* hash_name(acl::connect_hash_t type)
+{
+	switch (type)
+	{
+	case acl::CONNECT_HASH_KETAMA:
+		return "ketama";
+	case acl::CONNECT_HASH_JUMP:
+		return "jump";
+	case acl::CONNECT_HASH_RENDEZVOUS:
+		return "rendezvous";
+	case acl::CONNECT_HASH_MOD:
+	default:
+		return "mod";
+	}
+}
+
+static void make_keys(std::vector<acl::string>& keys, int count)
+{
+	acl::string key;
+	for (int i = 0; i < count; i++)
+	{
+		key.format("key_%d", i);
+		keys.push_back(key);
+	}
+}
+
+// ¼ÿֵӳķַ
+static void route(dummy_manager& manager, const std::vector<acl::string>& keys,
+	std::vector<acl::string>& addrs)
+{
+	addrs.clear();
+	for (size_t i = 0; i < keys.size(); i++)
+		addrs.push_back(manager.peek(keys[i])->get_addr());
+}
+
+static void count_addrs(const std::vector<acl::string>& addrs,
+	std::map<acl::string, int>& counts)
+{
+	counts.clear();
+	for (size_t i = 0; i < addrs.size(); i++)
+		counts[addrs[i]]++;
+}
+
+// ֵڸǷֲȣtolerance Ϊƫƽֵı
+static void check_balance(const std::vector<acl::string>& addrs,
+	size_t nservers, double tolerance)
+{
+	std::map<acl::string, int> counts;
+	count_addrs(addrs, counts);
+	CHECK(counts.size() == nservers);
+
+	double avg = (double) addrs.size() / nservers, max_dev = 0;
+	std::map<acl::string, int>::const_iterator cit;
+	for (cit = counts.begin(); cit != counts.end(); ++cit)
+	{
+		double dev = fabs(cit->second - avg) / avg;
+		if (dev > max_dev)
+			max_dev = dev;
+	}
+	printf("  balance: max deviation %.1f%%\r\n", max_dev * 100);
+	CHECK(max_dev <= tolerance);
+}
+
+static void test_hash(acl::connect_hash_t type, const std::vector<acl::string>& keys)
+{
+	printf("%s:\r\n", hash_name(type));
+
+	dummy_manager manager(type);
+	manager.add(1, 11);
+
+	std::vector<acl::string> before, after;
+	route(manager, keys, before);
+	// ketama ľȡ160 ʱƫԼΪ 10%
+	check_balance(before, 10, type == acl::CONNECT_HASH_KETAMA ? 0.3 : 0.1);
+
+	// һֻԼ 1/11 ļֵǨƣֻǨµķ
+	manager.add(11, 12);
+	route(manager, keys, after);
+	int moved = 0, wrong = 0;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (before[i] == after[i])
+			continue;
+		moved++;
+		if (after[i] != "192.168.1.11:11211")
+			wrong++;
+	}
+	printf("  add one: %.1f%% keys moved\r\n", moved * 100.0 / keys.size());
+	if (type == acl::CONNECT_HASH_MOD)
+		CHECK(moved > (int) keys.size() / 2);
+	else
+	{
+		CHECK(moved < (int) keys.size() * 0.15);
+		CHECK(wrong == 0);
+	}
+
+	if (type == acl::CONNECT_HASH_MOD)
+		return;
+
+	// һʱֻи÷ϵļֵɢ
+	const char* dead = "192.168.1.3:11211";
+	manager.set_pools_status(dead, false);
+	std::vector<acl::string> failover;
+	route(manager, keys, failover);
+	moved = wrong = 0;
+	std::map<acl::string, int> targets;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (after[i] == dead)
+		{
+			targets[failover[i]]++;
+			if (failover[i] == dead)
+				wrong++;
+		}
+		else if (after[i] != failover[i])
+			moved++;
+	}
+	printf("  one dead: %d live keys moved, dead keys spread over %d\r\n",
+		moved, (int) targets.size());
+	CHECK(moved == 0 && wrong == 0);
+	CHECK(targets.size() >= 5);
+
+	// ָӳϵԭ
+	manager.set_pools_status(dead, true);
+	route(manager, keys, failover);
+	CHECK(failover == after);
+
+	// ַķʽмɾʱֵӰ
+	if (type != acl::CONNECT_HASH_JUMP)
+	{
+		manager.remove("192.168.1.5:11211");
+		route(manager, keys, failover);
+		moved = 0;
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			if (after[i] != "192.168.1.5:11211"
+				&& after[i] != failover[i])
+			{
+				moved++;
+			}
+		}
+		printf("  remove one: %d other keys moved\r\n", moved);
+		CHECK(moved == 0);
+	}
+}
+
+static void test_weight(acl::connect_hash_t type, const std::vector<acl::string>& keys)
+{
+	dummy_manager manager(type);
+	manager.set_weight("192.168.1.1:11211", 3);
+	manager.add(1, 5);
+
+	std::vector<acl::string> addrs;
+	route(manager, keys, addrs);
+	std::map<acl::string, int> counts;
+	count_addrs(addrs, counts);
+
+	// ȨΪ 3 ķӦֵԼ 3/6 ļֵ
+	double share = counts["192.168.1.1:11211"] / (double) keys.size();
+	printf("%s weight 3 of 6: %.1f%% keys\r\n", hash_name(type), share * 100);
+	CHECK(share > 0.45 && share < 0.55);
+}
+
+static void benchmark(acl::connect_hash_t type, int nservers, int count)
+{
+	dummy_manager manager(type);
+	manager.add(1, nservers + 1);
+
+	std::vector<acl::string> keys;
+	make_keys(keys, 1000);
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < count; i++)
+		(void) manager.peek(keys[i % keys.size()]);
+	gettimeofday(&end, NULL);
+
+	double spent = util::stamp_sub(&end, &begin);
+	printf("%s: %d servers, %d peeks, spent: %.2f ms, %.2f peeks/s\r\n",
+		hash_name(type), nservers, count, spent,
+		count * 1000 / (spent > 0 ? spent : 1));
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-n count[default: 1000000]\r\n"
+		"-s servers[default: 10]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 1000000, nservers = 10;
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hn:s:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 's':
+			nservers = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+
+	acl::connect_hash_t types[] = {
+		acl::CONNECT_HASH_MOD,
+		acl::CONNECT_HASH_KETAMA,
+		acl::CONNECT_HASH_JUMP,
+		acl::CONNECT_HASH_RENDEZVOUS,
+	};
+
+	if (bench)
+	{
+		for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+			benchmark(types[i], nservers, n);
+		return 0;
+	}
+
+	std::vector<acl::string> keys;
+	make_keys(keys, 100000);
+
+	for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+		test_hash(types[i], keys);
+
+	test_weight(acl::CONNECT_HASH_KETAMA, keys);
+	test_weight(acl::CONNECT_HASH_RENDEZVOUS, keys);
+
+	return util::check_result();
+}
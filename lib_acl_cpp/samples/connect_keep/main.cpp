@@ -0,0 +1,274 @@
+#include "stdafx.h"
+#include "util.h"
+
+static acl::locker __lock;
+static int __opened = 0, __closed = 0, __kill = 0, __pools_freed = 0;
+
+static int counter(int& n)
+{
+	__lock.lock();
+	int ret = n;
+	__lock.unlock();
+	return ret;
+}
+
+// õӣopen ģӺʱʧܣalive ģʧЧ
+class dummy_client : public acl::connect_client
+{
+public:
+	dummy_client(int delay, bool fail)
+	: delay_(delay), fail_(fail), opened_(false) {}
+
+	~dummy_client()
+	{
+		if (!opened_)
+			return;
+		__lock.lock();
+		__closed++;
+		__lock.unlock();
+	}
+
+	bool open()
+	{
+		if (delay_ > 0)
+			acl_doze(delay_);
+		if (fail_)
+			return false;
+
+		__lock.lock();
+		__opened++;
+		__lock.unlock();
+		opened_ = true;
+		return true;
+	}
+
+	bool alive()
+	{
+		__lock.lock();
+		bool ok = __kill <= 0;
+		if (!ok)
+			__kill--;
+		__lock.unlock();
+		return ok;
+	}
+
+private:
+	int  delay_;
+	bool fail_;
+	bool opened_;
+};
+
+class dummy_pool : public acl::connect_pool
+{
+public:
+	dummy_pool(const char* addr, int count, size_t idx)
+	: acl::connect_pool(addr, count, idx), delay_(0), fail_(false) {}
+
+	~dummy_pool()
+	{
+		__lock.lock();
+		__pools_freed++;
+		__lock.unlock();
+	}
+
+	int get_conns() const
+	{
+		return count_;
+	}
+
+	int  delay_;		// ģӺʱ()
+	bool fail_;		// ģʧ
+
+protected:
+	acl::connect_client* create_connect()
+	{
+		return new dummy_client(delay_, fail_);
+	}
+};
+
+class dummy_manager : public acl::connect_manager
+{
+public:
+	dummy_manager() {}
+	~dummy_manager() {}
+
+protected:
+	acl::connect_pool* create_pool(const char* addr, int count, size_t idx)
+	{
+		return new dummy_pool(addr, count, idx);
+	}
+};
+
+// ȴȴ timeout 
+#define WAIT(cond, timeout) do { \
+	for (int _i = 0; _i < (timeout) * 10 && !(cond); _i++) \
+		acl_doze(100); \
+} while (0)
+
+// ͬԤȼٿӸ
+static void test_prewarm(void)
+{
+	int opened = __opened;
+	dummy_pool pool("127.0.0.1:1", 10, 0);
+	pool.set_min_idle(4);
+
+	CHECK(pool.prewarm() == 4);
+	CHECK(pool.get_idle_count() == 4);
+	CHECK(pool.prewarm() == 0);
+	CHECK(__opened == opened + 4);
+
+	// Ԥȵӱֱȡ
+	acl::connect_client* conn = pool.peek();
+	CHECK(conn != NULL);
+	CHECK(__opened == opened + 4);
+	pool.put(conn);
+
+	CHECK(pool.prewarm(100) == 6);
+	CHECK(pool.get_conns() == 10);
+	CHECK(pool.get_idle_count() == 10);
+
+	// ʧʱӳرΪ
+	dummy_pool bad("127.0.0.1:2", 10, 0);
+	bad.fail_ = true;
+	bad.set_retry_inter(60);
+	bad.set_min_idle(4);
+	CHECK(bad.prewarm() == 0);
+	CHECK(bad.get_conns() == 0);
+	CHECK(!bad.aliving());
+}
+
+// ̽رʧЧĿӣʹùӲ̽
+static void test_check_dead(void)
+{
+	dummy_pool pool("127.0.0.1:1", 10, 0);
+	CHECK(pool.prewarm(5) == 5);
+
+	int closed = __closed;
+	__lock.lock();
+	__kill = 2;
+	__lock.unlock();
+
+	CHECK(pool.check_dead(3600) == 0);
+	CHECK(pool.check_dead() == 2);
+	CHECK(__closed == closed + 2);
+	CHECK(pool.get_idle_count() == 3);
+	CHECK(pool.get_conns() == 3);
+	CHECK(pool.check_dead() == 0);
+}
+
+// ̨߳ȷϷӣõķӣ
+// ڶԿӽб̽
+static void test_monitor(const char* addr)
+{
+	dummy_manager manager;
+	manager.set_min_idle(4);
+	manager.set(addr, 20);
+	manager.set("127.0.0.1:1", 20);
+
+	dummy_pool* pool = (dummy_pool*) manager.get(addr);
+	dummy_pool* dead = (dummy_pool*) manager.get("127.0.0.1:1");
+	pool->delay_ = 50;
+
+	acl::connect_monitor* monitor = new acl::connect_monitor(manager);
+	monitor->set_check_inter(1).set_conn_timeout(1);
+	monitor->set_keep_threads(4).set_keepalive_inter(1);
+
+	int opened = counter(__opened);
+	manager.start_monitor(monitor);
+	WAIT(pool->get_idle_count() >= 4, 5);
+	printf("monitor, idle: %d, conns: %d, dead server conns: %d\r\n",
+		(int) pool->get_idle_count(), pool->get_conns(),
+		dead->get_conns());
+	CHECK(pool->get_idle_count() == 4);
+	CHECK(counter(__opened) == opened + 4);
+	CHECK(dead->get_conns() == 0);
+
+	// ȡ߿Ӻ²
+	std::vector<acl::connect_client*> conns;
+	for (int i = 0; i < 4; i++)
+		conns.push_back(pool->peek());
+	WAIT(pool->get_idle_count() >= 4, 5);
+	CHECK(pool->get_idle_count() == 4);
+	CHECK(pool->get_conns() == 8);
+
+	for (size_t i = 0; i < conns.size(); i++)
+		pool->put(conns[i]);
+
+	// ʧЧĿں̨ر
+	int closed = counter(__closed);
+	__lock.lock();
+	__kill = 3;
+	__lock.unlock();
+	WAIT(counter(__closed) >= closed + 3, 5);
+	CHECK(counter(__closed) == closed + 3);
+	WAIT(pool->get_idle_count() >= 5, 5);
+	CHECK(pool->get_idle_count() == 5);
+	printf("monitor, after keepalive: idle: %d, closed: %d\r\n",
+		(int) pool->get_idle_count(), counter(__closed) - closed);
+
+	delete manager.stop_monitor(true);
+}
+
+// ̨ڼɾӳأӳɺű
+static void test_remove(const char* addr)
+{
+	int freed = counter(__pools_freed);
+	dummy_manager manager;
+	manager.set_min_idle(8);
+	manager.set(addr, 20);
+	((dummy_pool*) manager.get(addr))->delay_ = 1000;
+
+	acl::connect_monitor* monitor = new acl::connect_monitor(manager);
+	monitor->set_check_inter(1).set_conn_timeout(1);
+	manager.start_monitor(monitor);
+
+	// ȴ߳̿ʼӺɾӳ
+	acl_doze(1500);
+	manager.remove(addr);
+	CHECK(counter(__pools_freed) == freed);
+
+	delete manager.stop_monitor(true);
+	CHECK(counter(__pools_freed) == freed + 1);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch;
+
+	while ((ch = getopt(argc, argv, "h")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+
+	// ̨߳Է̽Ƿ
+	acl::server_socket server;
+	if (server.open("127.0.0.1:0") == false)
+	{
+		printf("listen error\r\n");
+		return 1;
+	}
+
+	test_prewarm();
+	test_check_dead();
+	test_monitor(server.get_addr());
+	test_remove(server.get_addr());
+
+	printf("opened: %d, closed: %d\r\n", __opened, __closed);
+	CHECK(__opened == __closed);
+
+	return util::check_result();
+}
@@ -0,0 +1,295 @@
+#include "stdafx.h"
+#include <string>
+#include "util.h"
+
+static acl::string hex(const acl::string& buf)
+{
+	acl::string out;
+	for (size_t i = 0; i < buf.length(); i++)
+		out.format_append("%02x", (unsigned char) buf[i]);
+	return out;
+}
+
+static acl::string bytes(const char* s)
+{
+	acl::string out;
+	for (; s[0] && s[1]; s += 2)
+	{
+		char tmp[3] = { s[0], s[1], 0 };
+		char ch = (char) strtol(tmp, NULL, 16);
+		out.append(&ch, 1);
+	}
+	return out;
+}
+
+static void build_tree(acl::json& json)
+{
+	acl::json_node& root = json.get_root();
+	root.add_text("name", "acl \"lib\"\r\n")
+		.add_number("small", 7)
+		.add_number("neg", -300)
+		.add_number("big", 9000000000LL)
+		.add_bool("ok", true)
+		.add_bool("bad", false);
+
+	acl::json_node& list = json.create_array();
+	list.add_array_text("a")
+		.add_array_number(-1)
+		.add_array_bool(false)
+		.add_child(json.create_node()
+			.add_text("k", "v")
+			.add_child("inner", json.create_array()
+				.add_array_number(1)
+				.add_array_number(2)));
+	root.add_child("list", list);
+
+	acl::json_node& obj = json.create_node();
+	obj.add_text("city", "hangzhou").add_number("zip", 310000);
+	root.add_child("home", obj);
+}
+
+static void test_roundtrip()
+{
+	acl::json json;
+	build_tree(json);
+	acl::string text(json.to_string());
+
+	acl::string mp, cb;
+	json.build_msgpack(mp);
+	json.build_cbor(cb);
+
+	acl::json json1;
+	CHECK(json1.update_msgpack(mp.c_str(), mp.length()) == (int) mp.length());
+	CHECK(json1.to_string() == text);
+
+	acl::json json2;
+	CHECK(json2.update_cbor(cb.c_str(), cb.length()) == (int) cb.length());
+	CHECK(json2.to_string() == text);
+
+	// ɵĽıɵĽͬķʽ
+	const std::vector<acl::json_node*>& zips =
+		json1.getElementsByTags("home/zip");
+	CHECK(zips.size() == 1 && strcmp(zips[0]->get_text(), "310000") == 0);
+	const std::vector<acl::json_node*>& inner =
+		json2.getElementsByTagName("inner");
+	CHECK(inner.size() == 1 && inner[0]->get_obj() != NULL);
+
+	// ٴαĽͬ
+	acl::string mp2, cb2;
+	json1.build_msgpack(mp2);
+	json2.build_cbor(cb2);
+	CHECK(mp2 == mp);
+	CHECK(cb2 == cb);
+
+	// 룬ǩʱΪֻһԱĶ
+	acl::string buf;
+	zips[0]->build_msgpack(buf);
+	CHECK(hex(buf) == "81a37a6970ce0004baf0");
+	buf.clear();
+	zips[0]->build_cbor(buf);
+	CHECK(hex(buf) == "a1637a69701a0004baf0");
+
+	// ıҶ㲻ֵַַ
+	acl::json json3("{\"a\": 1, \"b\": [true, \"x\"], \"c\": {}, \"d\": []}");
+	buf.clear();
+	json3.build_msgpack(buf);
+	CHECK(hex(buf) == "84a161a131a16292a474727565a178a16380a16490");
+
+	acl::json json4;
+	CHECK(json4.update_msgpack(buf.c_str(), buf.length()) > 0);
+	CHECK(json4.to_string() == json3.to_string());
+}
+
+static void test_encoding()
+{
+	acl::json json;
+	json.get_root().add_number("a", 1);
+
+	acl::string buf;
+	json.build_msgpack(buf);
+	CHECK(hex(buf) == "81a16101");
+	buf.clear();
+	json.build_cbor(buf);
+	CHECK(hex(buf) == "a1616101");
+
+	// ̵ʽ
+	acl::json json1;
+	json1.get_root().add_number("a", -32).add_number("b", -33)
+		.add_number("c", 255).add_number("d", 65536)
+		.add_number("e", -2147483647LL - 1);
+	buf.clear();
+	json1.build_msgpack(buf);
+	CHECK(hex(buf) == "85a161e0a162d0dfa163ccffa164ce00010000a165d280000000");
+	buf.clear();
+	json1.build_cbor(buf);
+	CHECK(hex(buf) == "a5616138" "1f61623820616318ff61641a00010000"
+		"61653a7fffffff");
+}
+
+static void test_decoding()
+{
+	// {"f": 1.5, "d": 0.1, "u": 2^64-1, "n": nil, "bin": "ab", 1: [ -1 ]}
+	acl::string buf = bytes("86a166ca3fc00000a164"
+		"cb3fb999999999999a" "a175cfffffffffffffffff" "a16ec0"
+		"a362696ec4026162" "0191ff");
+	acl::json json;
+	CHECK(json.update_msgpack(buf.c_str(), buf.length())
+		== (int) buf.length());
+	CHECK(json.to_string() == "{\"f\": 1.5, \"d\": 0.1, "
+		"\"u\": 18446744073709551615, \"n\": null, \"bin\": \"ab\", "
+		"\"1\": [-1]}");
+
+	// Ϊ
+	acl::json json1;
+	buf = bytes("92a1788101c3");
+	CHECK(json1.update_msgpack(buf.c_str(), buf.length()) == 6);
+	CHECK(json1.to_string() == "[\"x\", {\"1\": true}]");
+
+	// CBOR顢󼰴ǩ뾫ȸundefined
+	acl::json json2;
+	buf = bytes("bf6161" "9f01f93c00f7ff" "6162" "7f616161" "62ff"
+		"6163c11a514b67b0" "ff");
+	CHECK(json2.update_cbor(buf.c_str(), buf.length())
+		== (int) buf.length());
+	CHECK(json2.to_string() == "{\"a\": [1, 1, null], \"b\": \"ab\", "
+		"\"c\": 1363896240}");
+}
+
+static void test_errors()
+{
+	acl::json json;
+	acl::string buf;
+
+	json.get_root().add_text("key", "value")
+		.add_child("arr", json.create_array().add_array_number(1));
+	json.build_msgpack(buf);
+
+	// ݷ 0
+	for (size_t i = 1; i < buf.length(); i++)
+	{
+		acl::json json1;
+		CHECK(json1.update_msgpack(buf.c_str(), i) == 0);
+		CHECK(json1.update_msgpack(buf.c_str(), buf.length())
+			== (int) buf.length());
+	}
+
+	// һ
+	acl::string two(buf);
+	two << buf;
+	acl::json json2;
+	CHECK(json2.update_msgpack(two.c_str(), two.length())
+		== (int) buf.length());
+	// δ reset ʱٴν
+	CHECK(json2.update_msgpack(buf.c_str(), buf.length()) == -1);
+	json2.reset();
+	CHECK(json2.update_msgpack(two.c_str() + buf.length(), buf.length())
+		== (int) buf.length());
+
+	acl::json json3;
+	// Ϊ
+	CHECK(json3.update_msgpack("\x01", 1) == -1);
+	// δ
+	CHECK(json3.update_msgpack("\x81\xa1\x61\xc1", 4) == -1);
+	// չ
+	CHECK(json3.update_msgpack("\x81\xa1\x61\xd4\x01\x00", 6) == -1);
+	CHECK(json3.to_string() == "{}");
+	// CBOR ж break
+	CHECK(json3.update_cbor("\xa1\x61\x61\xff", 4) == -1);
+
+	// Ƕ׹
+	acl::string deep;
+	for (int i = 0; i < 2000; i++)
+		deep << (char) 0x91;
+	deep << (char) 0x01;
+	CHECK(json3.update_msgpack(deep.c_str(), deep.length()) == -1);
+}
+
+static void benchmark(int count)
+{
+	acl::json tree;
+	acl::json_node& list = tree.create_array();
+	for (int i = 0; i < count; i++)
+	{
+		acl::string name;
+		name.format("user-%d", i);
+		list.add_child(tree.create_node()
+			.add_number("id", i)
+			.add_text("name", name.c_str())
+			.add_bool("vip", i % 2 == 0)
+			.add_child("tags", tree.create_array()
+				.add_array_text("a")
+				.add_array_number(i * 3)
+				.add_array_bool(true))
+			.add_text("text", "hello \"world\"")
+			.add_number("score", i * 100));
+	}
+	tree.get_root().add_child("list", list);
+
+	struct timeval begin, end;
+	double spent;
+	acl::string text, mp, cb;
+
+#define	BENCH(label, stmt, len) do { \
+	gettimeofday(&begin, NULL); \
+	stmt; \
+	gettimeofday(&end, NULL); \
+	spent = util::stamp_sub(&end, &begin); \
+	printf("%-16s %10d bytes, %8.2f ms, %8.2f MB/s\r\n", label, \
+		(int) (len), spent, (len) / 1024.0 / 1024.0 / (spent / 1000.0)); \
+} while (0)
+
+	BENCH("json build:", tree.build_json(text), text.length());
+	BENCH("msgpack build:", tree.build_msgpack(mp), mp.length());
+	BENCH("cbor build:", tree.build_cbor(cb), cb.length());
+
+	acl::json json1, json2, json3;
+	BENCH("json parse:", json1.update(text.c_str()), text.length());
+	BENCH("msgpack parse:", json2.update_msgpack(mp.c_str(), mp.length()),
+		mp.length());
+	BENCH("cbor parse:", json3.update_cbor(cb.c_str(), cb.length()),
+		cb.length());
+
+	CHECK(json2.to_string() == text);
+	CHECK(json3.to_string() == text);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help] -b [benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 100000;
+	bool  bench = false;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			bench = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (bench)
+		benchmark(count);
+	else
+	{
+		test_roundtrip();
+		test_encoding();
+		test_decoding();
+		test_errors();
+	}
+
+	return util::check_result();
+}
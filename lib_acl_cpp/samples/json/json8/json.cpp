@@ -0,0 +1,418 @@
+#include "stdafx.h"
+#include <string>
+#include "util.h"
+
+static const char* token_name(acl::json_token_t token)
+{
+	switch (token)
+	{
+	case acl::JSON_TOKEN_ERROR:
+		return "E";
+	case acl::JSON_TOKEN_MORE:
+		return "M";
+	case acl::JSON_TOKEN_EOF:
+		return "$";
+	case acl::JSON_TOKEN_BEGIN_OBJECT:
+		return "{";
+	case acl::JSON_TOKEN_END_OBJECT:
+		return "}";
+	case acl::JSON_TOKEN_BEGIN_ARRAY:
+		return "[";
+	case acl::JSON_TOKEN_END_ARRAY:
+		return "]";
+	case acl::JSON_TOKEN_KEY:
+		return "K";
+	case acl::JSON_TOKEN_STRING:
+		return "S";
+	case acl::JSON_TOKEN_NUMBER:
+		return "N";
+	case acl::JSON_TOKEN_BOOL:
+		return "B";
+	case acl::JSON_TOKEN_NULL:
+		return "Z";
+	default:
+		return "?";
+	}
+}
+
+// бӳһַchunk Ϊÿݳȣ
+// skip_key ΪʱóԱֵskip_depth > 0 ʱȵĶ
+
+static std::string tokens(const char* data, size_t chunk,
+	const char* skip_key = NULL, size_t skip_depth = 0,
+	acl::json_reader* r = NULL)
+{
+	acl::json_reader reader;
+	if (r == NULL)
+		r = &reader;
+
+	std::string out;
+	size_t len = strlen(data), off = 0;
+
+	while (true)
+	{
+		acl::json_token_t token = r->next();
+		if (token == acl::JSON_TOKEN_MORE)
+		{
+			if (off >= len)
+			{
+				r->update_end();
+				continue;
+			}
+			size_t n = len - off > chunk ? chunk : len - off;
+			r->update(data + off, n);
+			off += n;
+			continue;
+		}
+
+		out += token_name(token);
+		if (token == acl::JSON_TOKEN_ERROR || token == acl::JSON_TOKEN_EOF)
+			break;
+		if (token >= acl::JSON_TOKEN_KEY)
+		{
+			out += r->get_text().c_str();
+			out += ",";
+		}
+
+		if (token == acl::JSON_TOKEN_KEY && skip_key
+			&& r->get_text() == skip_key)
+		{
+			CHECK(r->skip());
+		}
+		else if ((token == acl::JSON_TOKEN_BEGIN_OBJECT
+			|| token == acl::JSON_TOKEN_BEGIN_ARRAY)
+			&& r->depth() == skip_depth)
+		{
+			CHECK(r->skip());
+		}
+	}
+
+	return out;
+}
+
+// ֽĽӦͬ
+
+static void check(const char* data, const char* expect,
+	const char* skip_key = NULL, size_t skip_depth = 0)
+{
+	std::string s1 = tokens(data, strlen(data) + 1, skip_key, skip_depth);
+	std::string s2 = tokens(data, 1, skip_key, skip_depth);
+	std::string s3 = tokens(data, 3, skip_key, skip_depth);
+
+	if (s1 != expect || s2 != expect || s3 != expect)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"input : %s\r\nexpect: %s\r\nwhole : %s\r\n"
+			"byte  : %s\r\nchunk3: %s", data, expect,
+			s1.c_str(), s2.c_str(), s3.c_str());
+	}
+}
+
+static void test_tokens(void)
+{
+	check("{}", "{}$");
+	check("[]", "[]$");
+	check("  {\"a\" : 1, \"b\": [true, false, null, -1.5e3, \"x\"],"
+		" \"c\": {\"d\": {}}}  ",
+		"{Ka,N1,Kb,[Btrue,Bfalse,Znull,N-1.5e3,Sx,]Kc,{Kd,{}}}$");
+	check("\"abc\"", "Sabc,$");
+	check("123", "N123,$");
+	check("0", "N0,$");
+	check("true", "Btrue,$");
+	check("[[[]],[1]]", "[[[]][N1,]]$");
+
+	// ת弰 unicode
+	check("[\"a\\\"b\\\\c\\/d\\n\"]", "[Sa\"b\\c/d\n,]$");
+	check("[\"\\u0041\\u00e9\\u4e2d\"]", "[SA\xc3\xa9\xe4\xb8\xad,]$");
+	check("[\"\\ud83d\\ude00\"]", "[S\xf0\x9f\x98\x80,]$");
+	check("[\"\\ud83dx\"]", "[S\xef\xbf\xbdx,]$");
+	check("[\"\\ude00\"]", "[S\xef\xbf\xbd,]$");
+
+	//  json 
+	check("{\"a\":1}\n{\"a\":2}\n[3]\n",
+		"{Ka,N1,}{Ka,N2,}[N3,]$");
+	check("1 2", "N1,N2,$");
+	check("", "$");
+}
+
+static void test_errors(void)
+{
+	check("{", "{E");
+	check("[1,", "[N1,E");
+	check("{\"a\"}", "{Ka,E");
+	check("{\"a\":1,}", "{Ka,N1,E");
+	check("[1,]", "[N1,E");
+	check("[1 2]", "[N1,E");
+	check("[}", "[E");
+	check("{]", "{E");
+	check("]", "E");
+	check("[01]", "[E");
+	check("[1.]", "[E");
+	check("[-]", "[E");
+	check("1e", "E");
+	check("[tru]", "[E");
+	check("[nul", "[E");
+	check("[\"abc", "[E");
+	check("[\"a\\x\"]", "[E");
+	check("[\"\\u12G4\"]", "[E");
+	check("[\"a\nb\"]", "[E");
+	check("{1:2}", "{E");
+	check("[1}", "[N1,E");
+
+	// һֱ JSON_TOKEN_ERROR
+	acl::json_reader reader;
+	reader.update("]", 1);
+	CHECK(reader.next() == acl::JSON_TOKEN_ERROR);
+	CHECK(reader.next() == acl::JSON_TOKEN_ERROR);
+	CHECK(*reader.get_error() != 0);
+
+	reader.reset();
+	reader.update("[]", 2);
+	reader.update_end();
+	CHECK(reader.next() == acl::JSON_TOKEN_BEGIN_ARRAY);
+	CHECK(reader.next() == acl::JSON_TOKEN_END_ARRAY);
+	CHECK(reader.next() == acl::JSON_TOKEN_EOF);
+}
+
+static void test_skip(void)
+{
+	const char* data = "{\"a\": {\"x\": [1, \"}]\\\"\", {\"y\": 2}]},"
+		" \"b\": [[], [{}]], \"c\": \"str\", \"d\": 3, \"e\": true}";
+
+	check(data, "{$", NULL, 1);
+	check(data, "{Ka,{Kb,[Kc,Sstr,Kd,N3,Ke,Btrue,}$", NULL, 2);
+	check(data, "{Ka,{Kx,[}Kb,[[[]Kc,Sstr,Kd,N3,Ke,Btrue,}$", NULL, 3);
+	check(data, "{Ka,Kb,[[][{}]]Kc,Sstr,Kd,N3,Ke,Btrue,}$", "a");
+	check(data, "{Ka,{Kx,[N1,S}]\",{Ky,N2,}]}Kb,Kc,Sstr,Kd,N3,Ke,Btrue,}$",
+		"b");
+	check(data, "{Ka,{Kx,[N1,S}]\",{Ky,N2,}]}Kb,[[][{}]]Kc,Kd,N3,"
+		"Ke,Btrue,}$", "c");
+	check(data, "{Ka,{Kx,[N1,S}]\",{Ky,N2,}]}Kb,[[][{}]]Kc,Sstr,Kd,"
+		"Ke,Btrue,}$", "d");
+	check(data, "{Ka,{Kx,[N1,S}]\",{Ky,N2,}]}Kb,[[][{}]]Kc,Sstr,Kd,"
+		"N3,Ke,}$", "e");
+	check("[1] [2]", "[[$", NULL, 1);
+	check("{\"a\": [1, 2}", "{Ka,E", "a");
+	check("{\"a\": [1, 2", "{Ka,E", "a");
+
+	// ֻԱֵ
+	acl::json_reader reader;
+	reader.update("[1]", 3);
+	CHECK(reader.next() == acl::JSON_TOKEN_BEGIN_ARRAY);
+	CHECK(reader.next() == acl::JSON_TOKEN_NUMBER);
+	CHECK(reader.skip() == false);
+	CHECK(reader.get_int64() == 1);
+}
+
+static void test_limits(void)
+{
+	acl::json_reader reader;
+
+	reader.set_limits(4, 2);
+	CHECK(tokens("[\"abcd\"]", 1, NULL, 0, &reader) == "[Sabcd,]$");
+
+	reader.reset();
+	CHECK(tokens("[\"abcde\"]", 1, NULL, 0, &reader) == "[E");
+
+	reader.reset();
+	CHECK(tokens("[123456]", 2, NULL, 0, &reader) == "[E");
+
+	reader.reset();
+	CHECK(tokens("[[1]]", 2, NULL, 0, &reader) == "[[N1,]]$");
+
+	reader.reset();
+	CHECK(tokens("[[[1]]]", 2, NULL, 0, &reader) == "[[E");
+
+	// ݲܳ
+	reader.reset();
+	CHECK(tokens("{\"a\":\"abcdefgh\",\"b\":[\"abcdefgh\"]}", 3,
+		"a", 2, &reader) == "{Ka,Kb,[}$");
+}
+
+static void test_values(void)
+{
+	acl::json_reader reader;
+	const char* data = "[-9007199254740993, 2.5, true, false]";
+
+	reader.update(data, strlen(data));
+	reader.update_end();
+	CHECK(reader.next() == acl::JSON_TOKEN_BEGIN_ARRAY);
+	CHECK(reader.next() == acl::JSON_TOKEN_NUMBER);
+	CHECK(reader.get_int64() == -9007199254740993LL);
+	CHECK(reader.depth() == 1);
+	CHECK(reader.next() == acl::JSON_TOKEN_NUMBER);
+	CHECK(reader.get_double() == 2.5);
+	CHECK(reader.next() == acl::JSON_TOKEN_BOOL);
+	CHECK(reader.get_bool() == true);
+	CHECK(reader.next() == acl::JSON_TOKEN_BOOL);
+	CHECK(reader.get_bool() == false);
+	CHECK(reader.next() == acl::JSON_TOKEN_END_ARRAY);
+	CHECK(reader.depth() == 0);
+	CHECK(reader.next() == acl::JSON_TOKEN_EOF);
+}
+
+// ļжȡݣֻȡҪֶ
+
+static void test_stream(int count)
+{
+	const char* filepath = "./json8.tmp";
+	acl::ofstream out;
+	if (out.open_trunc(filepath) == false)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"open %s error %s", filepath, acl::last_serror());
+		return;
+	}
+
+	out.write("[", 1);
+	for (int i = 0; i < count; i++)
+	{
+		out.format("%s{\"id\": %d, \"name\": \"user-%d\", \"tags\":"
+			" [\"a\", \"b\", {\"c\": [1, 2, 3]}], \"score\": %d.5}",
+			i > 0 ? ",\n" : "", i, i, i);
+	}
+	out.write("]", 1);
+	out.close();
+
+	acl::ifstream in;
+	if (in.open_read(filepath) == false)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"open %s error %s", filepath, acl::last_serror());
+		return;
+	}
+
+	acl::json_reader reader(in);
+	acl::json_token_t token;
+	long long int sum = 0;
+	int n = 0;
+	bool is_id = false;
+
+	while ((token = reader.next()) > acl::JSON_TOKEN_EOF)
+	{
+		if (token == acl::JSON_TOKEN_KEY)
+		{
+			is_id = reader.get_text() == "id";
+			if (!is_id)
+				reader.skip();
+		}
+		else if (token == acl::JSON_TOKEN_NUMBER && is_id)
+		{
+			sum += reader.get_int64();
+			n++;
+		}
+	}
+
+	CHECK(token == acl::JSON_TOKEN_EOF);
+	CHECK(n == count);
+	CHECK(sum == (long long int) count * (count - 1) / 2);
+	in.close();
+
+	// ޶ȡʱݲ
+	if (in.open_read(filepath))
+	{
+		acl::json_reader reader2(in, 100);
+		while ((token = reader2.next()) > acl::JSON_TOKEN_EOF) {}
+		CHECK(token == acl::JSON_TOKEN_ERROR);
+		in.close();
+	}
+
+	remove(filepath);
+}
+
+static void benchmark(int count)
+{
+	acl::string data;
+	data += "{\"list\": [";
+	for (int i = 0; i < count; i++)
+	{
+		data.format_append("%s{\"id\": %d, \"name\": \"user-%d\","
+			" \"tags\": [\"a\", \"b\", {\"c\": [1, 2, 3]}],"
+			" \"text\": \"hello \\\"world\\\" \\u4e2d\\u6587\","
+			" \"score\": %d.5}", i > 0 ? "," : "", i, i, i);
+	}
+	data += "]}";
+
+	struct timeval begin, end;
+	acl::json_token_t token;
+	int n = 0;
+
+	gettimeofday(&begin, NULL);
+	acl::json_reader reader;
+	reader.update(data.c_str(), data.length());
+	reader.update_end();
+	while ((token = reader.next()) > acl::JSON_TOKEN_EOF)
+		n++;
+	gettimeofday(&end, NULL);
+	double spent = util::stamp_sub(&end, &begin);
+	printf("json_reader: %d tokens, %.2f ms, %.2f MB/s\r\n", n, spent,
+		data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	reader.reset();
+	reader.update(data.c_str(), data.length());
+	reader.update_end();
+	n = 0;
+	while ((token = reader.next()) > acl::JSON_TOKEN_EOF)
+	{
+		if (token == acl::JSON_TOKEN_BEGIN_OBJECT && reader.depth() == 3)
+			reader.skip();
+		n++;
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("json_reader skip: %d tokens, %.2f ms, %.2f MB/s\r\n", n,
+		spent, data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	acl::json json;
+	json.update(data.c_str());
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("json tree: %.2f ms, %.2f MB/s\r\n", spent,
+		data.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help] -b [benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 10000;
+	bool  bench = false;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			bench = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (bench)
+	{
+		benchmark(count);
+		return 0;
+	}
+
+	test_tokens();
+	test_errors();
+	test_skip();
+	test_limits();
+	test_values();
+	test_stream(count);
+
+	return util::check_result();
+}
@@ -0,0 +1,239 @@
+#include "stdafx.h"
+#include "util.h"
+
+static void build(acl::json_writer& writer, int count)
+{
+	writer.begin_object()
+		.key("name").value("zsx")
+		.key("ok").value(true)
+		.key("none").value_null()
+		.key("list").begin_array();
+
+	for (int i = 0; i < count; i++)
+	{
+		writer.begin_object()
+			.key("id").value(i)
+			.key("name").value(acl::string().format("user-%d", i))
+			.key("text").value("hello \"world\"\r\n")
+			.key("tags").begin_array()
+				.value("a").value("b").begin_array().end_array()
+			.end_array()
+			.key("score").value(i + 0.5)
+			.end_object();
+	}
+
+	writer.end_array()
+		.key("raw").raw("{\"a\":[1,2]}", 11)
+		.end_object();
+}
+
+static void test_build(void)
+{
+	acl::string buf;
+	acl::json_writer writer(buf);
+
+	build(writer, 2);
+	CHECK(writer.finish());
+	CHECK(buf == "{\"name\":\"zsx\",\"ok\":true,\"none\":null,\"list\":["
+		"{\"id\":0,\"name\":\"user-0\",\"text\":\"hello \\\"world\\\"\\r\\n\","
+		"\"tags\":[\"a\",\"b\",[]],\"score\":0.5},"
+		"{\"id\":1,\"name\":\"user-1\",\"text\":\"hello \\\"world\\\"\\r\\n\","
+		"\"tags\":[\"a\",\"b\",[]],\"score\":1.5}],"
+		"\"raw\":{\"a\":[1,2]}}");
+
+	// дֵ
+	buf.clear();
+	acl::json_writer writer2(buf);
+	writer2.value(1).value("x").begin_array().value(2).end_array();
+	CHECK(writer2.finish());
+	CHECK(buf == "1\"x\"[2]");
+
+	// δ
+	buf.clear();
+	acl::json_writer writer3(buf);
+	writer3.begin_object().key("a");
+	CHECK(writer3.finish() == false);
+	CHECK(buf == "{\"a\":");
+	CHECK(writer3.depth() == 1);
+}
+
+static void test_numbers(void)
+{
+	acl::string buf;
+	acl::json_writer writer(buf);
+
+	writer.begin_array()
+		.value(0)
+		.value(-1)
+#ifdef WIN32
+		.value((__int64) -9223372036854775807LL - 1)
+#else
+		.value((long long int) -9223372036854775807LL - 1)
+#endif
+		.value(0.1)
+		.value(1e300)
+		.value(-2.5)
+		.value(1.0 / 3)
+		.value(0.0 / 0.0)
+		.end_array();
+	CHECK(writer.finish());
+	CHECK(buf == "[0,-1,-9223372036854775808,0.1,1e+300,-2.5,"
+		"0.33333333333333331,null]");
+}
+
+// ֽڵת json_reader Ӧԭͬ
+
+static void test_escape(void)
+{
+	std::string all;
+	for (int i = 1; i < 256; i++)
+		all += (char) i;
+
+	for (size_t n = 0; n < all.size(); n++)
+	{
+		std::string s = all.substr(n) + all.substr(0, n);
+		acl::string buf;
+		acl::json_writer writer(buf);
+
+		writer.begin_array().value(s.c_str(), s.size()).end_array();
+		CHECK(writer.finish());
+
+		for (size_t i = 0; i < buf.length(); i++)
+		{
+			if ((unsigned char) buf[i] < 0x20)
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"control character %d", buf[i]);
+				break;
+			}
+		}
+
+		acl::json_reader reader;
+		reader.update(buf.c_str(), buf.length());
+		reader.update_end();
+		CHECK(reader.next() == acl::JSON_TOKEN_BEGIN_ARRAY);
+		CHECK(reader.next() == acl::JSON_TOKEN_STRING);
+		CHECK(reader.get_text().length() == s.size());
+		CHECK(memcmp(reader.get_text().c_str(), s.c_str(), s.size()) == 0);
+	}
+
+	acl::string buf;
+	acl::json_writer writer(buf);
+	writer.value("a\"b\\c\b\f\n\r\t\x01\x1f/\xe4\xb8\xad");
+	CHECK(writer.finish());
+	CHECK(buf == "\"a\\\"b\\\\c\\b\\f\\n\\r\\t\\u0001\\u001f/\xe4\xb8\xad\"");
+}
+
+// úСĻдļӦдַͬ
+
+static void test_stream(int count)
+{
+	acl::string expect;
+	acl::json_writer writer(expect);
+	build(writer, count);
+	CHECK(writer.finish());
+
+	const char* filepath = "./json9.tmp";
+	acl::ofstream out;
+	if (out.open_trunc(filepath) == false)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"open %s error %s", filepath, acl::last_serror());
+		return;
+	}
+
+	acl::json_writer writer2(out, 64);
+	build(writer2, count);
+	CHECK(writer2.finish());
+	out.close();
+
+	acl::string buf;
+	CHECK(acl::ifstream::load(filepath, &buf));
+	CHECK(buf == expect);
+	remove(filepath);
+
+	acl::json json;
+	json.update(expect.c_str());
+	CHECK(json.getElementsByTagName("id").size() == (size_t) count);
+}
+
+static void benchmark(int count)
+{
+	struct timeval begin, end;
+
+	gettimeofday(&begin, NULL);
+	acl::string buf;
+	acl::json_writer writer(buf);
+	build(writer, count);
+	writer.finish();
+	gettimeofday(&end, NULL);
+	double spent = util::stamp_sub(&end, &begin);
+	printf("json_writer: %d bytes, %.2f ms, %.2f MB/s\r\n",
+		(int) buf.length(), spent,
+		buf.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+
+	gettimeofday(&begin, NULL);
+	acl::json json;
+	acl::json_node& list = json.get_root().add_child(false, true)
+		.add_text("name", "zsx").add_bool("ok", true)
+		.add_child("list", json.create_array(), true);
+	for (int i = 0; i < count; i++)
+	{
+		acl::json_node& tags = json.create_array();
+		tags.add_array_text("a").add_array_text("b");
+		list.add_child(json.create_node()
+			.add_number("id", i)
+			.add_text("name", acl::string().format("user-%d", i))
+			.add_text("text", "hello \"world\"\r\n")
+			.add_child("tags", tags)
+			.add_text("score", acl::string().format("%.1f", i + 0.5)));
+	}
+	const acl::string& s = json.to_string();
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("json tree: %d bytes, %.2f ms, %.2f MB/s\r\n",
+		(int) s.length(), spent,
+		s.length() / 1024.0 / 1024.0 / (spent / 1000.0));
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help] -b [benchmark] -n count\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 10000;
+	bool  bench = false;
+
+	while ((ch = getopt(argc, argv, "hbn:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			bench = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (bench)
+	{
+		benchmark(count);
+		return 0;
+	}
+
+	test_build();
+	test_numbers();
+	test_escape();
+	test_stream(count);
+
+	return util::check_result();
+}
@@ -0,0 +1,441 @@
+#include "stdafx.h"
+#include <signal.h>
+#include "util.h"
+
+// ͨ stats ÷ĳͳֵʱ -1
+static long long get_stat(const char* addr, const char* name)
+{
+	acl::socket_stream conn;
+	if (conn.open(addr, 10, 10) == false)
+		return -1;
+	if (conn.write("stats\r\n") == -1)
+		return -1;
+
+	acl::string line, prefix;
+	prefix.format("STAT %s ", name);
+	long long n = -1;
+
+	while (conn.gets(line))
+	{
+		if (line == "END")
+			break;
+		if (strncmp(line.c_str(), prefix.c_str(), prefix.length()) == 0)
+			n = atoll(line.c_str() + prefix.length());
+	}
+	return n;
+}
+
+static void make_items(std::map<acl::string, acl::string>& items,
+	const char* prefix, int count)
+{
+	acl::string key, val;
+	for (int i = 0; i < count; i++)
+	{
+		key.format("%s_%d", prefix, i);
+		val.format("value_%s_%d", prefix, i);
+		items[key] = val;
+	}
+}
+
+static void get_keys(const std::map<acl::string, acl::string>& items,
+	std::vector<acl::string>& keys)
+{
+	std::map<acl::string, acl::string>::const_iterator cit;
+	for (cit = items.begin(); cit != items.end(); ++cit)
+		keys.push_back(cit->first);
+}
+
+// ϵд
+static void test_conn(const char* addr)
+{
+	acl::memcache conn(addr, 10, 10);
+	std::map<acl::string, acl::string> items, out;
+	std::map<acl::string, unsigned short> flags;
+	std::vector<acl::string> keys;
+
+	make_items(items, "conn", 50);
+	CHECK(conn.set_multi(items, 0, 7));
+
+	get_keys(items, keys);
+	keys.push_back("conn_missing_1");
+	keys.push_back("conn_missing_2");
+	keys.push_back("conn_0");
+
+	long long cmds = get_stat(addr, "get_cmds");
+	CHECK(conn.get_multi(keys, out, &flags));
+	CHECK(get_stat(addr, "get_cmds") == cmds + 1);
+	CHECK(out == items);
+	CHECK(flags.size() == items.size());
+	CHECK(flags["conn_10"] == 7);
+
+	// 뵥ֵѯһ
+	acl::string buf;
+	CHECK(conn.get("conn_10", buf) && buf == items["conn_10"]);
+
+	// ֵ϶ʱֳɶ get 
+	items.clear();
+	make_items(items, "many", 250);
+	CHECK(conn.set_multi(items));
+	keys.clear();
+	get_keys(items, keys);
+	out.clear();
+	cmds = get_stat(addr, "get_cmds");
+	CHECK(conn.get_multi(keys, out));
+	CHECK(get_stat(addr, "get_cmds") == cmds + 3);
+	CHECK(out == items);
+
+	CHECK(conn.del_multi(keys));
+	out.clear();
+	CHECK(conn.get_multi(keys, out));
+	CHECK(out.empty());
+
+	// ȴȷʱͬһϵĺȻ󱻴
+	CHECK(conn.set_multi(items, 0, 0, false));
+	CHECK(conn.get_multi(keys, out));
+	CHECK(out == items);
+	CHECK(conn.del_multi(keys, false));
+	out.clear();
+	CHECK(conn.get_multi(keys, out));
+	CHECK(out.empty());
+
+	std::vector<const char*> keys2;
+	keys2.push_back("none_1");
+	out.clear();
+	CHECK(conn.get_multi(keys2, out));
+	CHECK(out.empty());
+	CHECK(conn.del_multi(keys2));
+
+	keys.clear();
+	CHECK(conn.get_multi(keys, out));
+	CHECK(conn.del_multi(keys));
+	items.clear();
+	CHECK(conn.set_multi(items));
+}
+
+// ˼ֵǰ׺ַļֵʱȻԭʼֵ
+static void test_prefix(const char* addr)
+{
+	acl::memcache conn(addr, 10, 10);
+	conn.set_prefix("app");
+
+	std::map<acl::string, acl::string> items, out;
+	items["key with space"] = "value 1";
+	items["key\twith\ttab"] = "value 2";
+	items["plain"] = "";
+	CHECK(conn.set_multi(items));
+
+	std::vector<acl::string> keys;
+	get_keys(items, keys);
+	CHECK(conn.get_multi(keys, out));
+
+	// ݱֵѯ
+	CHECK(out.size() == 3 && out["key with space"] == "value 1"
+		&& out["key\twith\ttab"] == "value 2" && out["plain"].empty());
+
+	acl::string buf;
+	CHECK(conn.get("key with space", buf) && buf == "value 1");
+
+	acl::memcache other(addr, 10, 10);
+	out.clear();
+	CHECK(other.get_multi(keys, out));
+	CHECK(out.empty());
+}
+
+// ͨӳؼȺдֵ
+static void test_manager(const std::vector<acl::string>& addrs)
+{
+	acl::memcache_manager manager;
+	for (size_t i = 0; i < addrs.size(); i++)
+		manager.set(addrs[i], 10);
+
+	std::map<acl::string, acl::string> items, out;
+	make_items(items, "manager", 150);
+	CHECK(manager.set_multi(items));
+
+	std::vector<long long> cmds;
+	for (size_t i = 0; i < addrs.size(); i++)
+		cmds.push_back(get_stat(addrs[i], "get_cmds"));
+
+	std::vector<acl::string> keys;
+	get_keys(items, keys);
+	CHECK(manager.get_multi(keys, out));
+	CHECK(out == items);
+
+	// ÿֻյһ get 
+	for (size_t i = 0; i < addrs.size(); i++)
+	{
+		long long n = get_stat(addrs[i], "get_cmds") - cmds[i];
+		printf("%s: %lld get commands\r\n", addrs[i].c_str(), n);
+		CHECK(n == 1);
+	}
+
+	// 뵥ֵ·ɷʽһ
+	for (size_t i = 0; i < keys.size(); i += 10)
+	{
+		acl::connect_pool* pool = manager.peek(keys[i]);
+		acl::memcache* conn = (acl::memcache*) pool->peek();
+		acl::string buf;
+		CHECK(conn->get(keys[i], buf) && buf == items[keys[i]]);
+		pool->put(conn);
+	}
+
+	CHECK(manager.del_multi(keys));
+	out.clear();
+	CHECK(manager.get_multi(keys, out));
+	CHECK(out.empty());
+
+	CHECK(manager.set_multi(items, 0, 0, false));
+	CHECK(manager.get_multi(keys, out));
+	CHECK(out == items);
+	CHECK(manager.del_multi(keys, false));
+}
+
+// ַʱʧܣĽȻЧ
+static void test_dead(const std::vector<acl::string>& addrs)
+{
+	acl::memcache_manager manager;
+	for (size_t i = 0; i < addrs.size(); i++)
+		manager.set(addrs[i], 10);
+	manager.set("127.0.0.1:1", 10);
+
+	std::map<acl::string, acl::string> items, out;
+	make_items(items, "dead", 100);
+
+	CHECK(!manager.set_multi(items));
+
+	std::vector<acl::string> keys;
+	get_keys(items, keys);
+	CHECK(!manager.get_multi(keys, out));
+	CHECK(!out.empty() && out.size() < items.size());
+
+	std::map<acl::string, acl::string>::const_iterator cit;
+	for (cit = out.begin(); cit != out.end(); ++cit)
+		CHECK(items[cit->first] == cit->second);
+	printf("dead: %d of %d keys got\r\n", (int) out.size(),
+		(int) items.size());
+
+	manager.del_multi(keys);
+}
+
+// ģ memcached ˣset  bad ͷʱʹ noreply Ҳ
+// 󣬲ѯֵ crlf ʱݿ֮ \r\n
+class fake_server : public acl::thread
+{
+public:
+	fake_server(acl::server_socket& server) : server_(server) {}
+	~fake_server() {}
+
+protected:
+	void* run()
+	{
+		// δÿӣͻ˹رճӺ
+		acl::socket_stream* conn;
+		while ((conn = server_.accept()) != NULL)
+		{
+			bool quit = !handle(*conn);
+			delete conn;
+			if (quit)
+				break;
+		}
+		return NULL;
+	}
+
+private:
+	acl::server_socket& server_;
+
+	// ͻҪ˳ʱ false
+	bool handle(acl::socket_stream& conn)
+	{
+		acl::string line, data;
+
+		while (conn.gets(line))
+		{
+			std::vector<acl::string>& tokens = line.split2(" ");
+			if (tokens.empty())
+				continue;
+			if (tokens[0] == "quit")
+				return false;
+
+			if (tokens[0] == "version")
+				conn.write("VERSION 1.0\r\n");
+			else if (tokens[0] == "set" && tokens.size() >= 5)
+			{
+				size_t len = (size_t) atoi(tokens[4]) + 2;
+				data.clear();
+				if (conn.read(data, len, true) == false)
+					break;
+				if (strncmp(data.c_str(), "bad", 3) == 0)
+					conn.write("CLIENT_ERROR bad data chunk\r\n");
+			}
+			else if (tokens[0] == "get")
+			{
+				for (size_t i = 1; i < tokens.size(); i++)
+					conn.format("VALUE %s 0 1\r\nv%s",
+						tokens[i].c_str(), tokens[i] == "crlf"
+						? "XY\r\n" : "\r\n");
+				conn.write("END\r\n");
+			}
+		}
+		return true;
+	}
+};
+
+//  noreply ӦӦݿ֮Ϊ \r\n
+static void test_sync(void)
+{
+	acl::server_socket server;
+	if (server.open("127.0.0.1:0") == false)
+	{
+		util::check_failed(__FILE__, __LINE__, "listen error");
+		return;
+	}
+
+	fake_server fake(server);
+	fake.set_detachable(false);
+	fake.start();
+
+	{
+		acl::memcache conn(server.get_addr(), 10, 10);
+		std::map<acl::string, acl::string> items, out;
+		items["sync_1"] = "bad";
+		items["sync_2"] = "good";
+
+		std::vector<acl::string> keys;
+		keys.push_back("sync_1");
+
+		CHECK(conn.set_multi(items, 0, 0, false));
+		CHECK(conn.get_multi(keys, out));
+		CHECK(out.size() == 1 && out["sync_1"] == "v");
+
+		CHECK(conn.del_multi(keys, false));
+		CHECK(!conn.set_multi(items));
+		out.clear();
+		CHECK(conn.get_multi(keys, out));
+		CHECK(out.size() == 1 && out["sync_1"] == "v");
+
+		keys.push_back("crlf");
+		out.clear();
+		CHECK(!conn.get_multi(keys, out));
+	}
+
+	acl::socket_stream quit;
+	if (quit.open(server.get_addr(), 10, 10))
+		quit.write("quit\r\n");
+	fake.wait();
+}
+
+// Ƚֵѯѯĺʱ
+static void benchmark(const char* addr, int count, int nkeys)
+{
+	acl::memcache conn(addr, 10, 10);
+	std::map<acl::string, acl::string> items, out;
+	make_items(items, "bench", nkeys);
+	CHECK(conn.set_multi(items));
+
+	std::vector<acl::string> keys;
+	get_keys(items, keys);
+
+	struct timeval begin, end;
+	acl::string buf;
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < count; i++)
+	{
+		for (size_t j = 0; j < keys.size(); j++)
+		{
+			if (!conn.get(keys[j], buf))
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"get %s error", keys[j].c_str());
+				return;
+			}
+		}
+	}
+	gettimeofday(&end, NULL);
+	double spent = util::stamp_sub(&end, &begin);
+	printf("get: %d x %d keys, spent: %.2f ms, %.2f requests/s\r\n",
+		count, nkeys, spent, count * 1000 / (spent > 0 ? spent : 1));
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < count; i++)
+	{
+		out.clear();
+		if (!conn.get_multi(keys, out) || out.size() != keys.size())
+		{
+			util::check_failed(__FILE__, __LINE__,
+				"get_multi error");
+			return;
+		}
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("get_multi: %d x %d keys, spent: %.2f ms, %.2f requests/s\r\n",
+		count, nkeys, spent, count * 1000 / (spent > 0 ? spent : 1));
+
+	conn.del_multi(keys);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s memcached addrs[127.0.0.1:11211, split by ',']\r\n"
+		"-n count[default: 1000]\r\n"
+		"-k keys per request[default: 50]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 1000, nkeys = 50;
+	acl::string addrs("127.0.0.1:11211");
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:n:k:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addrs = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'k':
+			nkeys = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+#ifndef WIN32
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	std::vector<acl::string> servers;
+	std::list<acl::string>& tokens = addrs.split(",");
+	std::list<acl::string>::iterator it = tokens.begin();
+	for (; it != tokens.end(); ++it)
+		servers.push_back(*it);
+
+	if (bench)
+		benchmark(servers[0], n, nkeys);
+	else
+	{
+		test_sync();
+		test_conn(servers[0]);
+		test_prefix(servers[0]);
+		test_manager(servers);
+		test_dead(servers);
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,8 @@
+// stdafx.cpp : ֻ׼ļԴļ
+// master_threads.pch ΪԤͷ
+// stdafx.obj ԤϢ
+
+#include "stdafx.h"
+
+// TODO:  STDAFX.H 
+//κĸͷļڴļ
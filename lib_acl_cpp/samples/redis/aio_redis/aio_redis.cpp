@@ -0,0 +1,391 @@
+#include "stdafx.h"
+#include "util.h"
+
+static int __pending = 0;
+static int __sent = 0;
+static int __next = 0;
+static bool __check_order = true;
+
+// һӦʱ type Ϊ REDIS_RESULT_UNKOWN
+class result_check : public acl::aio_redis_callback
+{
+public:
+	result_check(acl::redis_result_t type, const char* value = NULL,
+		size_t len = 0)
+	: seq_(__sent++)
+	, type_(type)
+	, value_(value)
+	, len_(value && len == 0 ? strlen(value) : len)
+	, size_(0)
+	, nullable_(false)
+	{
+		__pending++;
+	}
+
+	// ҲΪ NULL
+	result_check& set_nullable()
+	{
+		nullable_ = true;
+		return *this;
+	}
+
+	// ͽԪظ
+	result_check& set_size(size_t size)
+	{
+		size_ = size;
+		return *this;
+	}
+
+	void result_callback(const acl::redis_result* result)
+	{
+		// ͬһϵӦ밴ķ˳ص
+		if (__check_order)
+			CHECK(seq_ == __next);
+		__next++;
+		__pending--;
+
+		if (type_ == acl::REDIS_RESULT_UNKOWN)
+			CHECK(result == NULL);
+		else if (result == NULL && nullable_)
+			;
+		else
+		{
+			CHECK(result != NULL && result->get_type() == type_);
+			if (result != NULL && value_ != NULL)
+			{
+				acl::string buf;
+				result->argv_to_string(buf);
+				CHECK(buf.length() == len_
+					&& memcmp(buf.c_str(), value_, len_) == 0);
+			}
+			if (result != NULL && size_ > 0)
+				CHECK(result->get_size() == size_);
+		}
+
+		delete this;
+	}
+
+private:
+	~result_check() {}
+
+	int seq_;
+	acl::redis_result_t type_;
+	const char* value_;
+	size_t len_;
+	size_t size_;
+	bool nullable_;
+};
+
+static void wait_pending(acl::aio_handle& handle)
+{
+	while (__pending > 0)
+		handle.check();
+}
+
+template <typename T>
+static void test_client(acl::aio_handle& handle, T& client, int count)
+{
+	acl::string key, val;
+	std::vector<acl::string> args;
+
+	// ȴӦͶ
+	std::vector<acl::string> values;
+	for (int i = 0; i < count; i++)
+	{
+		key.format("aio_key_%d", i);
+		val.format("aio_value_%d", i);
+		values.push_back(val);
+		args.clear();
+		args.push_back(val);
+		client.exec("SET", key, args,
+			new result_check(acl::REDIS_RESULT_STATUS, "OK"));
+	}
+	for (int i = 0; i < count; i++)
+	{
+		key.format("aio_key_%d", i);
+		args.clear();
+		client.exec("GET", key, args, new result_check(
+			acl::REDIS_RESULT_STRING, values[i].c_str()));
+	}
+
+	// Ʋ
+	const char* hargs[] = { "name\0x", "va\r\nlue" };
+	const size_t hlens[] = { 6, 7 };
+	client.exec("HSET", "aio_hash", hargs, hlens, 2,
+		new result_check(acl::REDIS_RESULT_INTEGER));
+	client.exec("HGET", "aio_hash", hargs, hlens, 1,
+		new result_check(acl::REDIS_RESULT_STRING, "va\r\nlue", 7));
+	args.clear();
+	client.exec("HGETALL", "aio_hash", args,
+		&(new result_check(acl::REDIS_RESULT_ARRAY))->set_size(2));
+	client.exec("NO_SUCH_CMD", "aio_key_0", args,
+		new result_check(acl::REDIS_RESULT_ERROR));
+	client.exec("GET", "aio_no_such_key", args,
+		new result_check(acl::REDIS_RESULT_STRING));
+
+	// ҪζܵõӦ
+	acl::string big;
+	for (int i = 0; i < 100000; i++)
+		big.format_append("%08d", i);
+	args.clear();
+	args.push_back(big);
+	client.exec("SET", "aio_big", args,
+		new result_check(acl::REDIS_RESULT_STATUS, "OK"));
+	args.clear();
+	client.exec("GET", "aio_big", args, new result_check(
+		acl::REDIS_RESULT_STRING, big.c_str(), big.length()));
+
+	wait_pending(handle);
+}
+
+static void test_refused(acl::aio_handle& handle)
+{
+	// ʧʱеȴе NULL ص
+	acl::aio_redis_client client(handle, "127.0.0.1:1", 2, 2);
+	std::vector<acl::string> args;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (!client.exec("GET", "aio_key_0", args,
+			new result_check(acl::REDIS_RESULT_UNKOWN)))
+		{
+			// ʧʱص
+			__pending--;
+			__next++;
+		}
+	}
+
+	wait_pending(handle);
+	CHECK(client.get_pending() == 0);
+}
+
+static void test_quit(acl::aio_handle& handle, acl::aio_redis_client& client)
+{
+	// ˹رӺδõӦ NULL ص
+	std::vector<acl::string> args;
+
+	// ˹رʱδݻᷢ RSTʱͻδ
+	// ȡ QUIT Ӧܻᶪʧ
+	client.exec("QUIT", NULL, args, &(new result_check(
+		acl::REDIS_RESULT_STATUS, "OK"))->set_nullable());
+	for (int i = 0; i < 3; i++)
+		client.exec("GET", "aio_key_0", args,
+			new result_check(acl::REDIS_RESULT_UNKOWN));
+	wait_pending(handle);
+	CHECK(client.get_pending() == 0);
+
+	// ٴηʱԶ
+	client.exec("GET", "aio_key_0", args,
+		new result_check(acl::REDIS_RESULT_STRING, "aio_value_0"));
+	wait_pending(handle);
+}
+
+// ڽصٿͻ˶
+class destroy_check : public acl::aio_redis_callback
+{
+public:
+	destroy_check(acl::aio_redis_client* client)
+	: seq_(__sent++), client_(client)
+	{
+		__pending++;
+	}
+
+	void result_callback(const acl::redis_result* result)
+	{
+		CHECK(seq_ == __next);
+		__next++;
+		__pending--;
+
+		CHECK(result != NULL && result->get_type()
+			== acl::REDIS_RESULT_STRING);
+		delete client_;
+		delete this;
+	}
+
+private:
+	~destroy_check() {}
+
+	int seq_;
+	acl::aio_redis_client* client_;
+};
+
+static void test_destroy(acl::aio_handle& handle, const char* addr)
+{
+	// ӽǰ͵һдӦһͬһζе
+	// һӦĻصٿͻˣ NULL ص
+	acl::aio_redis_client* client = new acl::aio_redis_client(handle, addr);
+	std::vector<acl::string> args;
+
+	client->exec("GET", "aio_key_0", args, new destroy_check(client));
+	for (int i = 0; i < 3; i++)
+		client->exec("GET", "aio_key_0", args,
+			new result_check(acl::REDIS_RESULT_UNKOWN));
+	wait_pending(handle);
+}
+
+class bench_callback : public acl::aio_redis_callback
+{
+public:
+	bench_callback(acl::aio_redis_client& client, int count)
+	: client_(client), count_(count), sent_(0), done_(0), errors_(0)
+	{
+		args_.push_back("field");
+	}
+
+	~bench_callback() {}
+
+	bool send()
+	{
+		if (sent_ >= count_)
+			return false;
+		key_.format("aio_bench_%d", sent_++ % 100);
+		return client_.exec("HGET", key_, args_, this);
+	}
+
+	void result_callback(const acl::redis_result* result)
+	{
+		done_++;
+		if (result == NULL || result->get_type()
+			!= acl::REDIS_RESULT_STRING)
+		{
+			errors_++;
+		}
+		send();
+	}
+
+	bool finished() const
+	{
+		return done_ >= count_;
+	}
+
+	int errors() const
+	{
+		return errors_;
+	}
+
+private:
+	acl::aio_redis_client& client_;
+	int count_;
+	int sent_;
+	int done_;
+	int errors_;
+	acl::string key_;
+	std::vector<acl::string> args_;
+};
+
+// ֲͬ;Ƚ
+static void benchmark(acl::aio_handle& handle, const char* addr,
+	int count, int max_depth)
+{
+	acl::aio_redis_client client(handle, addr);
+	std::vector<acl::string> args;
+	args.push_back("field");
+	args.push_back("value");
+
+	acl::string key;
+	for (int i = 0; i < 100; i++)
+	{
+		key.format("aio_bench_%d", i);
+		client.exec("HSET", key, args, NULL);
+	}
+
+	for (int depth = 1; depth <= max_depth; depth *= 2)
+	{
+		struct timeval begin, end;
+		gettimeofday(&begin, NULL);
+
+		bench_callback bench(client, count);
+		for (int i = 0; i < depth; i++)
+			bench.send();
+		while (!bench.finished())
+			handle.check();
+
+		gettimeofday(&end, NULL);
+		double spent = util::stamp_sub(&end, &begin);
+
+		char label[32];
+		snprintf(label, sizeof(label), "depth %d", depth);
+		printf("%-12s %8d cmds, %10.2f ms, %10.2f cmds/s, errors: %d\r\n",
+			label, count, spent, count * 1000 / (spent > 0 ? spent : 1),
+			bench.errors());
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379, or addrs of cluster: ip1:port1,ip2:port2]\r\n"
+		"-c [use redis cluster mode]\r\n"
+		"-n count[default: 100]\r\n"
+		"-b [benchmark]\r\n"
+		"-d max_depth[default: 256]\r\n"
+		"-k [use kernel event: epoll/kqueue/devpoll]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100, max_depth = 256;
+	acl::string addr("127.0.0.1:6379");
+	bool cluster_mode = false, bench = false, use_kernel = false;
+
+	while ((ch = getopt(argc, argv, "hs:cn:bd:k")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'c':
+			cluster_mode = true;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		case 'd':
+			max_depth = atoi(optarg);
+			break;
+		case 'k':
+			use_kernel = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::aio_handle handle(use_kernel ? acl::ENGINE_KERNEL
+		: acl::ENGINE_SELECT);
+
+	if (bench)
+		benchmark(handle, addr, n, max_depth);
+	else if (cluster_mode)
+	{
+		// ͬӦ˳ǲȷ
+		__check_order = false;
+
+		acl::aio_redis_cluster cluster(handle);
+		cluster.set(addr);
+		test_client(handle, cluster, n);
+
+		// ڶʱϣӳϵѾ
+		test_client(handle, cluster, n);
+	}
+	else
+	{
+		acl::aio_redis_client client(handle, addr);
+		test_client(handle, client, n);
+		test_quit(handle, client);
+		test_refused(handle);
+		test_destroy(handle, addr);
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,206 @@
+#include "stdafx.h"
+#include "util.h"
+
+static void test_batch(acl::redis_batch& batch, int count)
+{
+	std::vector<acl::string> keys, values;
+	acl::string key, val;
+
+	for (int i = 0; i < count; i++)
+	{
+		key.format("batch_key_%d", i);
+		val.format("batch_value_%d", i);
+		keys.push_back(key);
+		values.push_back(val);
+	}
+
+	CHECK(batch.del(keys) >= 0);
+	CHECK(batch.exists(keys) == 0);
+
+	// Ⱥģʽ¸ֲֵڲͬĹϣУ밴ֵ˳򷵻
+	CHECK(batch.mset(keys, values));
+	CHECK(batch.exists(keys) == count);
+
+	std::vector<acl::string> out;
+	CHECK(batch.mget(keys, &out));
+	CHECK(out.size() == (size_t) count);
+	for (size_t i = 0; i < out.size() && i < values.size(); i++)
+		CHECK(out[i] == values[i]);
+
+	// ڵļֵӦմͬһֵԳֶ
+	std::vector<const char*> keys2;
+	keys2.push_back("batch_no_such_key");
+	keys2.push_back(keys[0].c_str());
+	keys2.push_back(keys[count - 1].c_str());
+	keys2.push_back(keys[0].c_str());
+	CHECK(batch.mget(keys2, &out));
+	CHECK(out.size() == 4 && out[0].empty() && out[1] == values[0]
+		&& out[2] == values[count - 1] && out[3] == values[0]);
+	CHECK(batch.exists(keys2) == 3);
+
+	std::map<acl::string, acl::string> objs;
+	objs["batch_key_0"] = "new_value_0";
+	objs["batch_key_1"] = "new_value_1";
+	CHECK(batch.mset(objs));
+
+	// ͨõĶִֵй
+	CHECK(batch.exec_keys("MGET", keys));
+	const acl::redis_result* rr = batch.get_key_result(1);
+	CHECK(rr && rr->get_type() == acl::REDIS_RESULT_STRING);
+	if (rr)
+	{
+		rr->argv_to_string(val);
+		CHECK(val == "new_value_1");
+	}
+	CHECK(batch.get_key_result(keys.size()) == NULL);
+
+	CHECK(batch.del(keys) == count);
+	CHECK(batch.exists(keys) == 0);
+	CHECK(batch.mget(keys, &out));
+	CHECK(out.size() == (size_t) count && out[0].empty());
+
+	// 
+	std::vector<acl::string> args;
+	CHECK(!batch.exec_keys("MGET", args));
+	args.push_back("batch_key_0");
+	args.push_back("value");
+	args.push_back("batch_key_1");
+	CHECK(!batch.exec_keys("MSET", args, 2));
+}
+
+// Ƚֵĺʱ
+static void benchmark(acl::redis_batch& batch, acl::redis_string& cmd,
+	int count, int loop)
+{
+	std::vector<acl::string> keys, values;
+	acl::string key, val;
+
+	for (int i = 0; i < count; i++)
+	{
+		key.format("batch_bench_%d", i);
+		val.format("batch_value_%d", i);
+		keys.push_back(key);
+		values.push_back(val);
+	}
+
+	if (!batch.mset(keys, values))
+	{
+		util::check_failed(__FILE__, __LINE__, "mset error");
+		return;
+	}
+
+	struct timeval begin, end;
+	double spent;
+
+	gettimeofday(&begin, NULL);
+	for (int n = 0; n < loop; n++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			cmd.clear();
+			val.clear();
+			if (cmd.get(keys[i], val) == false)
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"get %s error", keys[i].c_str());
+				return;
+			}
+		}
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("%-12s %8d keys, loop %d, %10.2f ms\r\n", "get",
+		count, loop, spent);
+
+	std::vector<acl::string> out;
+
+	gettimeofday(&begin, NULL);
+	for (int n = 0; n < loop; n++)
+	{
+		if (!batch.mget(keys, &out) || out.size() != keys.size())
+		{
+			util::check_failed(__FILE__, __LINE__, "mget error");
+			return;
+		}
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("%-12s %8d keys, loop %d, %10.2f ms\r\n", "batch mget",
+		count, loop, spent);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379, or addrs of cluster: ip1:port1,ip2:port2]\r\n"
+		"-c [use redis cluster mode]\r\n"
+		"-n count[default: 100]\r\n"
+		"-b [benchmark]\r\n"
+		"-l loop[default: 10]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100, loop = 10;
+	acl::string addr("127.0.0.1:6379");
+	bool cluster_mode = false, bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:cn:bl:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'c':
+			cluster_mode = true;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		case 'l':
+			loop = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// ԹҪֵ
+	if (n < 2)
+		n = 2;
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::redis_client client(addr.c_str());
+	acl::redis_client_cluster cluster;
+	acl::redis_batch batch;
+	acl::redis_string cmd;
+
+	if (cluster_mode)
+	{
+		cluster.set_redirect_sleep(0);
+		cluster.init(NULL, addr.c_str(), 10);
+		batch.set_cluster(&cluster, 10);
+		cmd.set_cluster(&cluster, 10);
+	}
+	else
+	{
+		batch.set_client(&client);
+		cmd.set_client(&client);
+	}
+
+	if (bench)
+		benchmark(batch, cmd, n, loop);
+	else
+		test_batch(batch, n);
+
+	return util::check_result();
+}
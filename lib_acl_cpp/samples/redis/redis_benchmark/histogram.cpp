@@ -0,0 +1,184 @@
+#include "stdafx.h"
+#include "histogram.h"
+
+// ֵĶλ
+static int bit_length(unsigned long long v)
+{
+	int n = 0;
+
+	if (v >> 32) { n += 32; v >>= 32; }
+	if (v >> 16) { n += 16; v >>= 16; }
+	if (v >> 8)  { n += 8;  v >>= 8;  }
+	if (v >> 4)  { n += 4;  v >>= 4;  }
+	if (v >> 2)  { n += 2;  v >>= 2;  }
+	if (v >> 1)  { n += 1;  v >>= 1;  }
+	return n + (int) v;
+}
+
+histogram::histogram(long long highest /* = 60000000 */, int digits /* = 3 */)
+: highest_(highest < 2 ? 2 : highest)
+, digits_(digits < 1 ? 1 : (digits > 5 ? 5 : digits))
+, total_(0)
+, min_(0)
+, max_(0)
+, sum_(0.0)
+{
+	// Ϊ֤Ч־ȣÿڵͰ벻С 2 * 10^digits
+	long long largest = 2;
+	for (int i = 0; i < digits_; i++)
+		largest *= 10;
+
+	int magnitude = bit_length((unsigned long long) largest - 1);
+	half_magnitude_ = magnitude - 1;
+	sub_count_ = 1LL << magnitude;
+	sub_half_ = sub_count_ / 2;
+	sub_mask_ = sub_count_ - 1;
+
+	// 㸲ֵĶ
+	long long smallest_untrackable = sub_count_;
+	int buckets = 1;
+	while (smallest_untrackable <= highest_)
+	{
+		if (smallest_untrackable > (0x7fffffffffffffffLL >> 1))
+		{
+			buckets++;
+			break;
+		}
+		smallest_untrackable <<= 1;
+		buckets++;
+	}
+
+	counts_len_ = (int) ((buckets + 1) * sub_half_);
+	counts_ = (long long*) acl_mycalloc(counts_len_, sizeof(long long));
+}
+
+histogram::~histogram()
+{
+	acl_myfree(counts_);
+}
+
+int histogram::bucket_index(long long value) const
+{
+	return bit_length((unsigned long long) (value | sub_mask_))
+		- (half_magnitude_ + 1);
+}
+
+int histogram::counts_index(long long value) const
+{
+	int bucket = bucket_index(value);
+	long long sub = value >> bucket;
+	return (int) (((long long) (bucket + 1) << half_magnitude_)
+		+ (sub - sub_half_));
+}
+
+long long histogram::value_at(int index) const
+{
+	int bucket = (index >> half_magnitude_) - 1;
+	long long sub = (index & (sub_half_ - 1)) + sub_half_;
+	if (bucket < 0)
+	{
+		sub -= sub_half_;
+		bucket = 0;
+	}
+	return sub << bucket;
+}
+
+long long histogram::highest_equivalent(long long value) const
+{
+	int bucket = bucket_index(value);
+	long long sub = value >> bucket;
+	int adjusted = sub >= sub_count_ ? bucket + 1 : bucket;
+	long long lowest = sub << bucket;
+	return lowest + (1LL << adjusted) - 1;
+}
+
+void histogram::record(long long value)
+{
+	if (value < 1)
+		value = 1;
+	else if (value > highest_)
+		value = highest_;
+
+	counts_[counts_index(value)]++;
+
+	if (total_ == 0 || value < min_)
+		min_ = value;
+	if (value > max_)
+		max_ = value;
+	sum_ += value;
+	total_++;
+}
+
+bool histogram::merge(const histogram& other)
+{
+	if (other.highest_ != highest_ || other.digits_ != digits_)
+		return false;
+	if (other.total_ == 0)
+		return true;
+
+	for (int i = 0; i < counts_len_; i++)
+		counts_[i] += other.counts_[i];
+
+	if (total_ == 0 || other.min_ < min_)
+		min_ = other.min_;
+	if (other.max_ > max_)
+		max_ = other.max_;
+	sum_ += other.sum_;
+	total_ += other.total_;
+	return true;
+}
+
+void histogram::reset()
+{
+	memset(counts_, 0, counts_len_ * sizeof(long long));
+	total_ = 0;
+	min_ = 0;
+	max_ = 0;
+	sum_ = 0.0;
+}
+
+long long histogram::percentile(double p) const
+{
+	if (total_ == 0)
+		return 0;
+
+	if (p < 0.0)
+		p = 0.0;
+	else if (p > 100.0)
+		p = 100.0;
+
+	long long count_at = (long long) (p / 100.0 * total_ + 0.5);
+	if (count_at < 1)
+		count_at = 1;
+
+	long long total = 0;
+	for (int i = 0; i < counts_len_; i++)
+	{
+		total += counts_[i];
+		if (total >= count_at)
+		{
+			// ͬһͰڵֵҲʵʼ¼ֵ
+			long long value = highest_equivalent(value_at(i));
+			return value < max_ ? value : max_;
+		}
+	}
+
+	return max_;
+}
+
+void histogram::print(const char* unit) const
+{
+	static const double percentiles[] = {
+		0, 50, 75, 90, 95, 99, 99.9, 99.99, 99.999, 100,
+	};
+
+	printf("%12s %14s %14s\r\n", "percentile", unit, "count");
+	for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++)
+	{
+		double p = percentiles[i];
+		long long count = (long long) (p / 100.0 * total_ + 0.5);
+		printf("%12.3f %14lld %14lld\r\n", p, percentile(p), count);
+	}
+	printf("#[Mean = %.2f, Min = %lld, Max = %lld, Total count = %lld]\r\n",
+		get_mean(), get_min(), get_max(), get_count());
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * HDR(High Dynamic Range) ֱͼֵ 2 ݴηֶΣÿԵطΪ
+ * ̶ͰӶڸЧ־£Թ̶Сڴ¼ܴΧ
+ * ֵ( 1 ΢ 1 ӵӳ)Լİٷλ߳
+ * Ӧʹһ󣬽ͨ merge ϲ
+ */
+class histogram
+{
+public:
+	/**
+	 * 캯
+	 * @param highest {long long} ɼ¼ֵڸֵֵֵ
+	 *  ¼С̶ֵΪ 1
+	 * @param digits {int} ЧֵλȡֵΧΪ 1  5
+	 */
+	histogram(long long highest = 60000000, int digits = 3);
+	~histogram();
+
+	/**
+	 * ¼һֵС 1 ʱ 1 ¼
+	 * @param value {long long}
+	 */
+	void record(long long value);
+
+	/**
+	 * ϲһֱͼļ¼ͬĹ
+	 * @param other {const histogram&}
+	 * @return {bool} ͬʱ false
+	 */
+	bool merge(const histogram& other);
+
+	/**
+	 * еļ¼
+	 */
+	void reset();
+
+	/**
+	 * ðٷλֵʵֵЧ־֮
+	 * @param p {double} ٷֱȣȡֵΧΪ 0  100
+	 * @return {long long} ûм¼ʱ 0
+	 */
+	long long percentile(double p) const;
+
+	long long get_count() const
+	{
+		return total_;
+	}
+
+	long long get_min() const
+	{
+		return total_ > 0 ? min_ : 0;
+	}
+
+	long long get_max() const
+	{
+		return max_;
+	}
+
+	double get_mean() const
+	{
+		return total_ > 0 ? sum_ / total_ : 0.0;
+	}
+
+	/**
+	 * ٷλֲ
+	 * @param unit {const char*} ֵĵλ "us"
+	 */
+	void print(const char* unit) const;
+
+private:
+	long long highest_;
+	int   digits_;
+	int   half_magnitude_;		// ÿͰһ 2 Ϊ׵Ķ
+	long long sub_count_;		// ÿεͰ
+	long long sub_half_;		// ÿͰһ
+	long long sub_mask_;
+	int   counts_len_;
+	long long* counts_;
+	long long total_;
+	long long min_;
+	long long max_;
+	double sum_;
+
+	int  bucket_index(long long value) const;
+	int  counts_index(long long value) const;
+	long long value_at(int index) const;
+	long long highest_equivalent(long long value) const;
+};
@@ -0,0 +1,553 @@
+#include "stdafx.h"
+#include <math.h>
+#include <algorithm>
+#include "histogram.h"
+
+// ֵķֲʽ
+typedef enum
+{
+	DIST_UNIFORM,	// ȷֲ
+	DIST_SEQ,	// ˳
+	DIST_ZIPF,	// zipf ֲȵֵƵ
+} dist_t;
+
+static acl::string __addr("127.0.0.1:6379");
+static bool   __cluster_mode = false;
+static int    __threads = 4;
+static int    __conns = 0;		// ÿӳص0 ʾ߳ͬ
+static long long __requests = 100000;	// ÿԵ
+static int    __value_size = 64;
+static int    __keyspace = 10000;
+static dist_t __dist = DIST_UNIFORM;
+static int    __pipeline = 16;		// ܵ
+static int    __batch = 16;		// MGET ļֵ
+static bool   __verbose = false;
+
+static acl::string __value;
+static std::vector<double> __zipf_cdf;	// zipf ֲۻ
+
+static const char* dist_name(dist_t dist)
+{
+	switch (dist)
+	{
+	case DIST_SEQ:
+		return "seq";
+	case DIST_ZIPF:
+		return "zipf";
+	default:
+		return "uniform";
+	}
+}
+
+// Ԥȼ zipf ֲۻʣΪ i ļֵĸ 1 / i^s 
+static void zipf_init(int n, double s)
+{
+	__zipf_cdf.resize(n);
+
+	double sum = 0;
+	for (int i = 0; i < n; i++)
+	{
+		sum += 1.0 / pow(i + 1.0, s);
+		__zipf_cdf[i] = sum;
+	}
+	for (int i = 0; i < n; i++)
+		__zipf_cdf[i] /= sum;
+}
+
+/**
+ * ֲʽɼֵţÿ̸߳ʹһ
+ */
+class key_picker
+{
+public:
+	key_picker(int idx)
+	: seed_(0x9E3779B97F4A7C15ULL * (idx + 1))
+	, seq_(0)
+	{
+		// ߳˳ʱӲͬλÿʼ
+		seq_ = (int) ((long long) __keyspace * idx / __threads);
+	}
+
+	~key_picker() {}
+
+	int next()
+	{
+		switch (__dist)
+		{
+		case DIST_SEQ:
+			if (seq_ >= __keyspace)
+				seq_ = 0;
+			return seq_++;
+		case DIST_ZIPF:
+		{
+			double u = (rand64() >> 11) * (1.0 / 9007199254740992.0);
+			return (int) (std::lower_bound(__zipf_cdf.begin(),
+				__zipf_cdf.end(), u) - __zipf_cdf.begin())
+				% __keyspace;
+		}
+		default:
+			return (int) (rand64() % (unsigned long long) __keyspace);
+		}
+	}
+
+private:
+	unsigned long long seed_;
+	int seq_;
+
+	// xorshift64* 㷨̹߳ rand() ״̬
+	unsigned long long rand64()
+	{
+		seed_ ^= seed_ >> 12;
+		seed_ ^= seed_ << 25;
+		seed_ ^= seed_ >> 27;
+		return seed_ * 2685821657736338717ULL;
+	}
+};
+
+/**
+ * ̣߳ÿ̸߳Լ¼ӳֱͼ̺߳ϲ
+ */
+class bench_thread : public acl::thread
+{
+public:
+	bench_thread(const char* test, long long count, int idx,
+		acl::redis_client_pool* pool, acl::redis_client_cluster* cluster)
+	: test_(test)
+	, count_(count)
+	, idx_(idx)
+	, pool_(pool)
+	, cluster_(cluster)
+	, errors_(0)
+	, misses_(0)
+	, waits_(0)
+	, ops_(0)
+	{
+	}
+
+	~bench_thread() {}
+
+	const histogram& get_histogram() const
+	{
+		return hist_;
+	}
+
+	long long get_errors() const
+	{
+		return errors_;
+	}
+
+	long long get_misses() const
+	{
+		return misses_;
+	}
+
+	long long get_waits() const
+	{
+		return waits_;
+	}
+
+	long long get_ops() const
+	{
+		return ops_;
+	}
+
+protected:
+	void* run()
+	{
+		acl::redis cmd;
+		acl::redis_pipeline pipe;
+		acl::redis_batch batch;
+
+		if (cluster_)
+		{
+			cmd.set_cluster(cluster_, __conns);
+			pipe.set_cluster(cluster_, __conns);
+			batch.set_cluster(cluster_, __conns);
+		}
+
+		// ܵÿִж
+		int step = 1;
+		if (test_ == "pipeline")
+			step = __pipeline;
+		else if (test_ == "mget")
+			step = __batch;
+
+		key_picker picker(idx_);
+		struct timeval begin, end;
+
+		for (long long i = 0; i < count_; i += step)
+		{
+			gettimeofday(&begin, NULL);
+
+			acl::redis_client* conn = NULL;
+			if (pool_ && (conn = peek_conn()) == NULL)
+			{
+				errors_ += step;
+				continue;
+			}
+			if (conn)
+			{
+				cmd.set_client(conn);
+				pipe.set_client(conn);
+				batch.set_client(conn);
+			}
+
+			if (!request(picker, cmd, pipe, batch))
+				errors_ += step;
+
+			if (conn)
+				pool_->put(conn, !conn->eof());
+
+			gettimeofday(&end, NULL);
+			hist_.record((end.tv_sec - begin.tv_sec) * 1000000LL
+				+ (end.tv_usec - begin.tv_usec));
+			ops_ += step;
+		}
+
+		return NULL;
+	}
+
+private:
+	acl::string test_;
+	long long count_;
+	int  idx_;
+	acl::redis_client_pool* pool_;
+	acl::redis_client_cluster* cluster_;
+	histogram hist_;
+	long long errors_;
+	long long misses_;
+	long long waits_;
+	long long ops_;
+	acl::string key_;
+	acl::string buf_;
+	std::vector<acl::string> keys_;
+	std::vector<acl::string> values_;
+
+	// ӳصӾʹʱ peek  NULLʱȴ̹߳黹
+	acl::redis_client* peek_conn()
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			acl::redis_client* conn =
+				(acl::redis_client*) pool_->peek();
+			if (conn)
+				return conn;
+			if (!pool_->aliving())
+				return NULL;
+			waits_++;
+			acl_doze(1);
+		}
+		return NULL;
+	}
+
+	// ֵӦ $-1 Ϊݵַ
+	static bool is_nil(const acl::redis_result* rr)
+	{
+		return rr->get_type() == acl::REDIS_RESULT_NIL
+			|| (rr->get_type() == acl::REDIS_RESULT_STRING
+				&& rr->get_size() == 0);
+	}
+
+	// ͬ͵ʹòͬǰ׺ļֵͳͻ
+	const char* next_key(key_picker& picker, const char* type = "string")
+	{
+		key_.format("bench_%s_%d", type, picker.next());
+		return key_.c_str();
+	}
+
+	bool request(key_picker& picker, acl::redis& cmd,
+		acl::redis_pipeline& pipe, acl::redis_batch& batch)
+	{
+		cmd.clear();
+
+		if (test_ == "get")
+		{
+			if (cmd.get(next_key(picker), buf_))
+				return true;
+
+			// ֵʱΪ
+			const acl::redis_result* rr = cmd.get_result();
+			if (rr && is_nil(rr))
+			{
+				misses_++;
+				return true;
+			}
+			return false;
+		}
+		else if (test_ == "set")
+		{
+			const char* key = next_key(picker);
+			return cmd.set(key, key_.length(), __value.c_str(),
+				__value.length());
+		}
+		else if (test_ == "hset")
+		{
+			const char* key = next_key(picker, "hash");
+			return cmd.hset(key, "field", __value.c_str(),
+				__value.length()) >= 0;
+		}
+		else if (test_ == "zadd")
+		{
+			const char* key = next_key(picker, "zset");
+			buf_.format("member_%d", picker.next());
+			const char* members[1] = { buf_.c_str() };
+			double scores[1] = { (double) picker.next() };
+			return cmd.zadd(key, members, scores, 1) >= 0;
+		}
+		else if (test_ == "lpush")
+		{
+			const char* key = next_key(picker, "list");
+			const char* values[1] = { __value.c_str() };
+			size_t lens[1] = { __value.length() };
+			return cmd.lpush(key, values, lens, 1) >= 0;
+		}
+		else if (test_ == "pipeline")
+		{
+			std::vector<acl::string> args;
+			for (int i = 0; i < __pipeline; i++)
+				pipe.add("GET", next_key(picker), args);
+			if (!pipe.flush())
+				return false;
+			for (int i = 0; i < __pipeline; i++)
+			{
+				const acl::redis_result* rr = pipe.get_child(i);
+				if (rr == NULL
+					|| rr->get_type() == acl::REDIS_RESULT_ERROR)
+				{
+					return false;
+				}
+				if (is_nil(rr))
+					misses_++;
+			}
+			return true;
+		}
+		else if (test_ == "mget")
+		{
+			keys_.clear();
+			for (int i = 0; i < __batch; i++)
+				keys_.push_back(next_key(picker));
+			if (!batch.mget(keys_, &values_))
+				return false;
+			for (size_t i = 0; i < values_.size(); i++)
+			{
+				if (values_[i].empty())
+					misses_++;
+			}
+			return true;
+		}
+
+		return false;
+	}
+};
+
+static void run_test(const char* test, acl::redis_client_pool* pool,
+	acl::redis_client_cluster* cluster)
+{
+	std::vector<bench_thread*> threads;
+	struct timeval begin, end;
+
+	gettimeofday(&begin, NULL);
+
+	for (int i = 0; i < __threads; i++)
+	{
+		long long count = __requests / __threads
+			+ (i < __requests % __threads ? 1 : 0);
+		bench_thread* thr = new bench_thread(test, count, i,
+			pool, cluster);
+		thr->set_detachable(false);
+		threads.push_back(thr);
+		thr->start();
+	}
+
+	histogram hist;
+	long long errors = 0, misses = 0, waits = 0, ops = 0;
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->wait();
+		hist.merge(threads[i]->get_histogram());
+		errors += threads[i]->get_errors();
+		misses += threads[i]->get_misses();
+		waits += threads[i]->get_waits();
+		ops += threads[i]->get_ops();
+		delete threads[i];
+	}
+
+	gettimeofday(&end, NULL);
+	double spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+
+	acl::string name(test);
+	name.upper();
+	if (name == "PIPELINE")
+		name.format_append("(%d GET)", __pipeline);
+	else if (name == "MGET")
+		name.format_append("(%d keys)", __batch);
+
+	printf("====== %s ======\r\n", name.c_str());
+	printf("  %lld requests, %d threads, %d conns, %d bytes value,"
+		" %d keys(%s)\r\n", ops, __threads, __conns, __value_size,
+		__keyspace, dist_name(__dist));
+	printf("  %.2f ms, %.2f requests/s, errors: %lld, misses: %lld,"
+		" pool waits: %lld\r\n", spent, spent > 0 ? ops * 1000 / spent
+		: 0.0, errors, misses, waits);
+	printf("  latency(us%s): min %lld, p50 %lld, p90 %lld, p99 %lld,"
+		" p99.9 %lld, p99.99 %lld, max %lld, mean %.2f\r\n",
+		name == "PIPELINE" || name == "MGET" ? ", per batch" : "",
+		hist.get_min(), hist.percentile(50), hist.percentile(90),
+		hist.percentile(99), hist.percentile(99.9),
+		hist.percentile(99.99), hist.get_max(), hist.get_mean());
+
+	if (__verbose)
+		hist.print("us");
+	printf("\r\n");
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379]\r\n"
+		"-c [use redis cluster mode]\r\n"
+		"-t tests[default: set,get; all: set,get,hset,zadd,lpush,pipeline,mget]\r\n"
+		"-n requests of each test[default: 100000]\r\n"
+		"-T threads[default: 4]\r\n"
+		"-C max connections of each pool[default: the number of threads]\r\n"
+		"-d value size[default: 64]\r\n"
+		"-k keyspace[default: 10000]\r\n"
+		"-D key distribution[uniform|seq|zipf, default: uniform]\r\n"
+		"-P pipeline depth[default: 16]\r\n"
+		"-B keys of each mget[default: 16]\r\n"
+		"-v [print the percentile distribution]\r\n"
+		"-V [print the library's log]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch;
+	acl::string tests("set,get");
+	bool logging = false;
+
+	while ((ch = getopt(argc, argv, "hs:ct:n:T:C:d:k:D:P:B:vV")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			__addr = optarg;
+			break;
+		case 'c':
+			__cluster_mode = true;
+			break;
+		case 't':
+			tests = optarg;
+			break;
+		case 'n':
+			__requests = atoll(optarg);
+			break;
+		case 'T':
+			__threads = atoi(optarg);
+			break;
+		case 'C':
+			__conns = atoi(optarg);
+			break;
+		case 'd':
+			__value_size = atoi(optarg);
+			break;
+		case 'k':
+			__keyspace = atoi(optarg);
+			break;
+		case 'D':
+			if (strcasecmp(optarg, "seq") == 0)
+				__dist = DIST_SEQ;
+			else if (strcasecmp(optarg, "zipf") == 0)
+				__dist = DIST_ZIPF;
+			else
+				__dist = DIST_UNIFORM;
+			break;
+		case 'P':
+			__pipeline = atoi(optarg);
+			break;
+		case 'B':
+			__batch = atoi(optarg);
+			break;
+		case 'v':
+			__verbose = true;
+			break;
+		case 'V':
+			logging = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (__threads < 1)
+		__threads = 1;
+	if (__conns <= 0)
+		__conns = __threads;
+	if (__value_size < 1)
+		__value_size = 1;
+	if (__keyspace < 1)
+		__keyspace = 1;
+	if (__pipeline < 1)
+		__pipeline = 1;
+	if (__batch < 1)
+		__batch = 1;
+
+	// ȺģʽӳûпʱýᱻΪãÿ
+	// ӳص߳
+	if (__cluster_mode && __conns < __threads)
+	{
+		printf("conns(%d) < threads(%d) in cluster mode, use %d\r\n",
+			__conns, __threads, __threads);
+		__conns = __threads;
+	}
+
+	acl::acl_cpp_init();
+	if (logging)
+		acl::log::stdout_open(true);
+
+	__value.space(__value_size + 1);
+	for (int i = 0; i < __value_size; i++)
+		__value += (char) ('a' + i % 26);
+
+	if (__dist == DIST_ZIPF)
+		zipf_init(__keyspace, 0.99);
+
+	acl::redis_client_pool* pool = NULL;
+	acl::redis_client_cluster* cluster = NULL;
+
+	if (__cluster_mode)
+	{
+		cluster = new acl::redis_client_cluster(10, 10);
+		cluster->set_redirect_sleep(0);
+		cluster->set_all_slot(__addr, __conns);
+	}
+	else
+	{
+		pool = new acl::redis_client_pool(__addr, __conns);
+		pool->set_timeout(10, 10);
+	}
+
+	acl::string buf(tests);
+	std::vector<acl::string>& names = buf.split2(",; \t");
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		names[i].lower();
+		if (names[i] != "get" && names[i] != "set"
+			&& names[i] != "hset" && names[i] != "zadd"
+			&& names[i] != "lpush" && names[i] != "pipeline"
+			&& names[i] != "mget")
+		{
+			printf("unknown test: %s\r\n", names[i].c_str());
+			continue;
+		}
+		run_test(names[i], pool, cluster);
+	}
+
+	delete pool;
+	delete cluster;
+	return 0;
+}
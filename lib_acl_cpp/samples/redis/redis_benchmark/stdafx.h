@@ -0,0 +1,14 @@
+// stdafx.h : ׼ϵͳļİļ
+// ǳõĵĿضİļ
+//
+
+#pragma once
+
+//
+//#include <iostream>
+//#include <tchar.h>
+
+// TODO: ڴ˴óҪĸͷļ
+#include "acl_cpp/lib_acl.hpp"
+#include "lib_acl.h"
+
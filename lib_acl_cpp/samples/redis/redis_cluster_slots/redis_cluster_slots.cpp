@@ -0,0 +1,237 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "util.h"
+
+// йϣ۶ӦĽַַ֪Ĺϣ۸
+static int snapshot(acl::redis_client_cluster& cluster,
+	std::vector<acl::string>& addrs)
+{
+	int n = 0, max_slot = cluster.get_max_slot();
+
+	addrs.resize(max_slot);
+	for (int i = 0; i < max_slot; i++)
+	{
+		acl::redis_client_pool* pool = cluster.peek_slot(i);
+		addrs[i] = pool ? pool->get_addr() : "";
+		if (pool)
+			n++;
+	}
+	return n;
+}
+
+// ȷӳϵȽϣزһµĹϣ۸
+static int diff(acl::redis_client_cluster& cluster,
+	const std::vector<acl::string>& addrs)
+{
+	std::vector<acl::string> curr;
+	int n = 0;
+
+	snapshot(cluster, curr);
+	for (size_t i = 0; i < addrs.size(); i++)
+	{
+		if (curr[i] != addrs[i])
+			n++;
+	}
+	return n;
+}
+
+// йϣӳĽ㣬ģлͻ˹ʱϢ
+static bool corrupt(acl::redis_client_cluster& cluster,
+	const std::vector<acl::string>& addrs)
+{
+	std::vector<acl::string> nodes;
+	for (size_t i = 0; i < addrs.size(); i++)
+	{
+		if (!addrs[i].empty() && std::find(nodes.begin(), nodes.end(),
+			addrs[i]) == nodes.end())
+		{
+			nodes.push_back(addrs[i]);
+		}
+	}
+
+	if (nodes.size() < 2)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"at least two nodes are needed");
+		return false;
+	}
+
+	for (size_t i = 0; i < addrs.size(); i++)
+	{
+		size_t n = std::find(nodes.begin(), nodes.end(), addrs[i])
+			- nodes.begin();
+		if (n < nodes.size())
+			cluster.set_slot((int) i, nodes[(n + 1) % nodes.size()]);
+	}
+	return true;
+}
+
+// ȴ̨߳йϣۣõʱ()ʱ -1
+static double wait_fixed(acl::redis_client_cluster& cluster,
+	const std::vector<acl::string>& addrs, const struct timeval& begin)
+{
+	struct timeval end;
+	for (int i = 0; i < 500; i++)
+	{
+		if (diff(cluster, addrs) == 0)
+		{
+			gettimeofday(&end, NULL);
+			return util::stamp_sub(&end, &begin);
+		}
+		acl_doze(10);
+	}
+	return -1;
+}
+
+static void test_load(const char* addr, std::vector<acl::string>& addrs)
+{
+	acl::redis_client_cluster cluster;
+	cluster.init(NULL, addr, 10);
+
+	CHECK(cluster.peek_slot(0) == NULL);
+	CHECK(cluster.refresh_slots());
+	CHECK(snapshot(cluster, addrs) == cluster.get_max_slot());
+
+	// ٴˢʱʹеӳ
+	std::vector<acl::connect_pool*> pools = cluster.get_pools();
+	CHECK(cluster.refresh_slots());
+	CHECK(cluster.get_pools() == pools);
+	CHECK(diff(cluster, addrs) == 0);
+
+	// Ĺϣˢºָ
+	cluster.clear_slot(100);
+	CHECK(cluster.peek_slot(100) == NULL);
+	CHECK(cluster.refresh_slots());
+	CHECK(diff(cluster, addrs) == 0);
+}
+
+// һ MOVED ضʹ̨߳ˢйϣ
+static void test_moved(const char* addr, const std::vector<acl::string>& addrs)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_redirect_sleep(0);
+	cluster.init(NULL, addr, 10);
+	CHECK(cluster.start_refresh(0, 10));
+	CHECK(diff(cluster, addrs) == 0);
+
+	if (!corrupt(cluster, addrs))
+		return;
+	CHECK(diff(cluster, addrs) == cluster.get_max_slot());
+
+	struct timeval begin;
+	gettimeofday(&begin, NULL);
+
+	acl::redis_string cmd(&cluster, 10);
+	CHECK(cmd.set("slots_moved_key", "value"));
+
+	double spent = wait_fixed(cluster, addrs, begin);
+	CHECK(spent >= 0);
+	printf("all slots fixed after MOVED: %.2f ms\r\n", spent);
+
+	cluster.stop_refresh();
+}
+
+// ̶̨߳ˢ
+static void test_periodic(const char* addr,
+	const std::vector<acl::string>& addrs)
+{
+	acl::redis_client_cluster cluster;
+	cluster.init(NULL, addr, 10);
+	CHECK(cluster.start_refresh(1, 10));
+
+	if (!corrupt(cluster, addrs))
+		return;
+
+	struct timeval begin;
+	gettimeofday(&begin, NULL);
+
+	double spent = wait_fixed(cluster, addrs, begin);
+	CHECK(spent >= 0);
+	printf("all slots fixed periodically: %.2f ms\r\n", spent);
+}
+
+// ȽʱѧϰԤȼϢĺʱ
+static void benchmark(const char* addr, int count)
+{
+	acl::string key;
+
+	for (int n = 0; n < 2; n++)
+	{
+		acl::redis_client_cluster cluster;
+		cluster.set_redirect_sleep(0);
+		cluster.init(NULL, addr, 10);
+		if (n == 1)
+			cluster.start_refresh(60, 10);
+
+		acl::redis_string cmd(&cluster, 10);
+		struct timeval begin, end;
+		gettimeofday(&begin, NULL);
+
+		for (int i = 0; i < count; i++)
+		{
+			key.format("slots_bench_%d", i);
+			cmd.clear();
+			if (!cmd.set(key, "value"))
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"set %s error", key.c_str());
+				return;
+			}
+		}
+
+		gettimeofday(&end, NULL);
+		printf("%-10s %8d keys, %10.2f ms\r\n", n == 0 ? "lazy" : "eager",
+			count, util::stamp_sub(&end, &begin));
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s one redis addr of cluster[127.0.0.1:6379]\r\n"
+		"-n count[default: 10000]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 10000;
+	acl::string addr("127.0.0.1:6379");
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:n:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	if (bench)
+		benchmark(addr, n);
+	else
+	{
+		std::vector<acl::string> addrs;
+		test_load(addr, addrs);
+		test_moved(addr, addrs);
+		test_periodic(addr, addrs);
+	}
+
+	return util::check_result();
+}
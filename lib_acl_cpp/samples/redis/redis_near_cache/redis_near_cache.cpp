@@ -0,0 +1,416 @@
+#include "stdafx.h"
+#include "util.h"
+
+// ȴеֵΪֵʧЧ֪ͨɺ̨߳첽
+static bool wait_value(acl::redis_string& cmd, const char* key,
+	const char* expected)
+{
+	acl::string buf;
+	for (int i = 0; i < 100; i++)
+	{
+		cmd.clear();
+		buf.clear();
+		if (cmd.get(key, buf) && buf == expected)
+			return true;
+		acl_doze(10);
+	}
+	return false;
+}
+
+// Сд LRU ̭
+static void test_local(const char* addr)
+{
+	acl::redis_near_cache cache(10, 60000);
+	acl::redis_client client(addr);
+	acl::redis_string cmd(&client);
+	cmd.set_near_cache(&cache);
+
+	acl::string buf;
+	CHECK(cmd.set("near_local", "value1"));
+
+	cmd.clear();
+	CHECK(cmd.get("near_local", buf) && buf == "value1");
+	unsigned long long misses = cache.get_misses();
+	for (int i = 0; i < 10; i++)
+	{
+		cmd.clear();
+		CHECK(cmd.get("near_local", buf) && buf == "value1");
+	}
+	CHECK(cache.get_hits() >= 10 && cache.get_misses() == misses);
+
+	// ͨͬһ޸ĺԶֵ
+	cmd.clear();
+	CHECK(cmd.set("near_local", "value2"));
+	cmd.clear();
+	CHECK(cmd.get("near_local", buf) && buf == "value2");
+
+	// ڵļֵ
+	acl::redis_key key_cmd(&client);
+	CHECK(key_cmd.del_one("near_no_such_key") >= 0);
+	cmd.clear();
+	CHECK(!cmd.get("near_no_such_key", buf));
+	cmd.clear();
+	CHECK(cmd.set("near_no_such_key", "v"));
+	cmd.clear();
+	CHECK(cmd.get("near_no_such_key", buf) && buf == "v");
+
+	acl::string key;
+	for (int i = 0; i < 20; i++)
+	{
+		key.format("near_lru_%d", i);
+		cmd.clear();
+		CHECK(cmd.set(key, "lru"));
+		cmd.clear();
+		CHECK(cmd.get(key, buf));
+	}
+	CHECK(cache.size() <= 10);
+
+	cache.clear();
+	CHECK(cache.size() == 0);
+}
+
+// ȡֵʹ뻺
+static bool get_all(acl::redis& cmd, const std::vector<acl::string>& keys,
+	const char* expected)
+{
+	acl::string buf;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		cmd.clear();
+		buf.clear();
+		if (!cmd.get(keys[i], buf) || buf != expected)
+			return false;
+	}
+	return true;
+}
+
+// дʹ޸ĵмֵʧЧֻʹʧЧ
+static void test_writes(const char* addr)
+{
+	acl::redis_near_cache cache(100, 60000);
+	acl::redis_client client(addr);
+	acl::redis cmd(&client);
+	cmd.set_near_cache(&cache);
+
+	std::vector<acl::string> keys;
+	keys.push_back("near_w1");
+	keys.push_back("near_w2");
+	keys.push_back("near_w3");
+
+	std::vector<acl::string> values(keys.size(), "a");
+	cmd.clear();
+	CHECK(cmd.mset(keys, values));
+	CHECK(get_all(cmd, keys, "a"));
+	CHECK(cache.size() == 3);
+
+	unsigned long long misses = cache.get_misses();
+	cmd.clear();
+	CHECK(cmd.exists(keys[0]));
+	cmd.clear();
+	CHECK(cmd.ttl(keys[1]) == -1);
+	CHECK(cache.size() == 3);
+	CHECK(get_all(cmd, keys, "a"));
+	CHECK(cache.get_misses() == misses);
+
+	values.assign(keys.size(), "b");
+	cmd.clear();
+	CHECK(cmd.mset(keys, values));
+	CHECK(cache.size() == 0);
+	CHECK(get_all(cmd, keys, "b"));
+
+	cmd.clear();
+	CHECK(cmd.del(keys) == 3);
+	CHECK(cache.size() == 0);
+	acl::string buf;
+	cmd.clear();
+	CHECK(!cmd.get(keys[2], buf));
+
+	// EVAL ʹļֵʧЧǽű
+	values.assign(keys.size(), "c");
+	cmd.clear();
+	CHECK(cmd.mset(keys, values));
+	CHECK(get_all(cmd, keys, "c"));
+
+	std::vector<acl::string> skeys, sargs;
+	skeys.push_back(keys[1]);
+	sargs.push_back("d");
+	cmd.clear();
+	CHECK(cmd.eval_status("return redis.call('set', KEYS[1], ARGV[1])",
+		skeys, sargs));
+	CHECK(cache.size() == 2);
+	cmd.clear();
+	CHECK(cmd.get(keys[1], buf) && buf == "d");
+
+	cmd.clear();
+	CHECK(cmd.del(keys) == 3);
+}
+
+// δʱʱ䱣֤һ
+static void test_ttl(const char* addr)
+{
+	acl::redis_near_cache cache(100, 200);
+	acl::redis_client client(addr), client2(addr);
+	acl::redis_string cmd(&client), writer(&client2);
+	cmd.set_near_cache(&cache);
+
+	acl::string buf;
+	CHECK(writer.set("near_ttl", "old"));
+	CHECK(cmd.get("near_ttl", buf) && buf == "old");
+
+	writer.clear();
+	CHECK(writer.set("near_ttl", "new"));
+	cmd.clear();
+	CHECK(cmd.get("near_ttl", buf) && buf == "old");
+
+	acl_doze(300);
+	cmd.clear();
+	CHECK(cmd.get("near_ttl", buf) && buf == "new");
+}
+
+// ӵ޸ͨ˵ʧЧ֪ͨʹʧЧ
+static void test_tracking(const char* addr)
+{
+	acl::redis_near_cache cache(1000, 0);
+	std::vector<acl::string> prefixes;
+	prefixes.push_back("near_");
+	if (!cache.track(addr, &prefixes))
+	{
+		util::check_failed(__FILE__, __LINE__, "track %s error", addr);
+		return;
+	}
+
+	acl::redis_client client(addr), client2(addr);
+	acl::redis_string cmd(&client), writer(&client2);
+	acl::redis_hash hcmd(&client), hwriter(&client2);
+	cmd.set_near_cache(&cache);
+	hcmd.set_near_cache(&cache);
+
+	acl::string buf;
+	CHECK(writer.set("near_track", "v1"));
+	CHECK(cmd.get("near_track", buf) && buf == "v1");
+	cmd.clear();
+	CHECK(cmd.get("near_track", buf) && buf == "v1");
+
+	writer.clear();
+	CHECK(writer.set("near_track", "v2"));
+	CHECK(wait_value(cmd, "near_track", "v2"));
+
+	std::map<acl::string, acl::string> attrs;
+	attrs["f1"] = "a";
+	attrs["f2"] = "b";
+	CHECK(hwriter.hmset("near_hash", attrs));
+
+	std::map<acl::string, acl::string> result;
+	CHECK(hcmd.hgetall("near_hash", result) && result.size() == 2);
+	hcmd.clear();
+	CHECK(hcmd.hget("near_hash", "f1", buf) && buf == "a");
+	unsigned long long hits = cache.get_hits();
+	hcmd.clear();
+	CHECK(hcmd.hgetall("near_hash", result) && result["f2"] == "b");
+	hcmd.clear();
+	CHECK(hcmd.hget("near_hash", "f1", buf) && buf == "a");
+	CHECK(cache.get_hits() == hits + 2);
+
+	hwriter.clear();
+	CHECK(hwriter.hset("near_hash", "f1", "c") >= 0);
+	bool ok = false;
+	for (int i = 0; i < 100 && !ok; i++)
+	{
+		hcmd.clear();
+		buf.clear();
+		ok = hcmd.hget("near_hash", "f1", buf) && buf == "c";
+		if (!ok)
+			acl_doze(10);
+	}
+	CHECK(ok);
+	hcmd.clear();
+	CHECK(hcmd.hgetall("near_hash", result) && result["f1"] == "c");
+
+	acl::redis_key key_cmd(&client2);
+	CHECK(key_cmd.del_one("near_hash") >= 0);
+}
+
+class reader_thread : public acl::thread
+{
+public:
+	reader_thread(const char* addr, acl::redis_near_cache& cache, int count)
+	: addr_(addr), cache_(cache), count_(count), errors_(0) {}
+	~reader_thread() {}
+
+	int get_errors() const
+	{
+		return errors_;
+	}
+
+protected:
+	void* run()
+	{
+		acl::redis_client client(addr_);
+		acl::redis_string cmd(&client);
+		cmd.set_near_cache(&cache_);
+
+		acl::string key, buf;
+		for (int i = 0; i < count_; i++)
+		{
+			key.format("near_mt_%d", i % 10);
+			cmd.clear();
+			if (!cmd.get(key, buf) || strncmp(buf, "mt_", 3) != 0)
+				errors_++;
+		}
+		return NULL;
+	}
+
+private:
+	acl::string addr_;
+	acl::redis_near_cache& cache_;
+	int count_;
+	int errors_;
+};
+
+// ̹߳ͬһͬʱ޸
+static void test_threads(const char* addr, int nthreads, int count)
+{
+	acl::redis_near_cache cache(5, 0);
+	if (!cache.track(addr))
+	{
+		util::check_failed(__FILE__, __LINE__, "track %s error", addr);
+		return;
+	}
+
+	acl::redis_client client(addr);
+	acl::redis_string writer(&client);
+	acl::string key, val;
+
+	for (int i = 0; i < 10; i++)
+	{
+		key.format("near_mt_%d", i);
+		writer.clear();
+		CHECK(writer.set(key, "mt_0"));
+	}
+
+	std::vector<reader_thread*> threads;
+	for (int i = 0; i < nthreads; i++)
+	{
+		reader_thread* thr = new reader_thread(addr, cache, count);
+		thr->set_detachable(false);
+		threads.push_back(thr);
+		thr->start();
+	}
+
+	for (int i = 1; i <= 50; i++)
+	{
+		key.format("near_mt_%d", i % 10);
+		val.format("mt_%d", i);
+		writer.clear();
+		CHECK(writer.set(key, val));
+	}
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->wait();
+		CHECK(threads[i]->get_errors() == 0);
+		delete threads[i];
+	}
+
+	// һ޸ĵĽս̶߳
+	acl::redis_client client2(addr);
+	acl::redis_string cmd(&client2);
+	cmd.set_near_cache(&cache);
+	for (int i = 41; i <= 50; i++)
+	{
+		key.format("near_mt_%d", i % 10);
+		val.format("mt_%d", i);
+		CHECK(wait_value(cmd, key, val));
+	}
+	CHECK(cache.size() <= 5);
+}
+
+static void benchmark(const char* addr, int count)
+{
+	acl::redis_near_cache cache;
+	acl::redis_client client(addr);
+	acl::redis_string cmd(&client);
+	acl::string buf;
+
+	CHECK(cmd.set("near_bench", "bench_value"));
+
+	struct timeval begin, end;
+	for (int n = 0; n < 2; n++)
+	{
+		cmd.set_near_cache(n == 0 ? NULL : &cache);
+
+		gettimeofday(&begin, NULL);
+		for (int i = 0; i < count; i++)
+		{
+			cmd.clear();
+			if (!cmd.get("near_bench", buf))
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"get error");
+				return;
+			}
+		}
+		gettimeofday(&end, NULL);
+
+		double spent = util::stamp_sub(&end, &begin);
+		printf("%-12s %8d gets, %10.2f ms, %10.2f /s\r\n",
+			n == 0 ? "redis" : "near cache", count, spent,
+			count * 1000 / (spent > 0 ? spent : 1));
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379]\r\n"
+		"-t threads[default: 4]\r\n"
+		"-n count[default: 10000]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, nthreads = 4, n = 10000;
+	acl::string addr("127.0.0.1:6379");
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:t:n:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 't':
+			nthreads = atoi(optarg);
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	if (bench)
+		benchmark(addr, n);
+	else
+	{
+		test_local(addr);
+		test_writes(addr);
+		test_ttl(addr);
+		test_tracking(addr);
+		test_threads(addr, nthreads, n);
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,231 @@
+#include "stdafx.h"
+#include "util.h"
+
+static bool result_eq(const acl::redis_result* rr, const char* s)
+{
+	if (rr == NULL || rr->get_type() != acl::REDIS_RESULT_STRING)
+		return false;
+	acl::string buf;
+	rr->argv_to_string(buf);
+	return buf == s;
+}
+
+static void test_pipeline(acl::redis_pipeline& pipe, int count)
+{
+	acl::string key, val;
+	std::vector<acl::string> args;
+
+	// һ SET һ GET ӦӦ˳һһӦ
+	for (int i = 0; i < count; i++)
+	{
+		key.format("pipe_key_%d", i);
+		val.format("pipe_value_%d", i);
+		args.clear();
+		args.push_back(val);
+		pipe.add("SET", key, args);
+	}
+	for (int i = 0; i < count; i++)
+	{
+		key.format("pipe_key_%d", i);
+		args.clear();
+		pipe.add("GET", key, args);
+	}
+
+	CHECK(pipe.get_size() == (size_t) count * 2);
+	CHECK(pipe.get_child(0) == NULL);
+	CHECK(pipe.flush());
+
+	for (int i = 0; i < count; i++)
+	{
+		const acl::redis_result* rr = pipe.get_child(i);
+		CHECK(rr && rr->get_type() == acl::REDIS_RESULT_STATUS
+			&& strcmp(rr->get_status(), "OK") == 0);
+
+		val.format("pipe_value_%d", i);
+		CHECK(result_eq(pipe.get_child(count + i), val));
+	}
+	CHECK(pipe.get_child(count * 2) == NULL);
+
+	// flush һƲӰ
+	const char* hargs[] = { "name\0x", "va\r\nlue" };
+	const size_t hlens[] = { 6, 7 };
+	pipe.add("HSET", "pipe_hash", hargs, hlens, 2);
+	CHECK(pipe.get_size() == 1);
+
+	pipe.add("HGET", "pipe_hash", hargs, hlens, 1);
+	args.clear();
+	pipe.add("NO_SUCH_CMD", "pipe_key_0", args);
+	pipe.add("INCR", "pipe_counter", args);
+
+	CHECK(pipe.flush());
+	CHECK(pipe.get_size() == 4);
+
+	const acl::redis_result* rr = pipe.get_child(0);
+	CHECK(rr && rr->get_type() == acl::REDIS_RESULT_INTEGER);
+
+	rr = pipe.get_child(1);
+	CHECK(rr && rr->get_type() == acl::REDIS_RESULT_STRING
+		&& rr->get_length() == 7
+		&& memcmp(rr->get(0), "va\r\nlue", 7) == 0);
+
+	rr = pipe.get_child(2);
+	CHECK(rr && rr->get_type() == acl::REDIS_RESULT_ERROR);
+
+	rr = pipe.get_child(3);
+	CHECK(rr && rr->get_type() == acl::REDIS_RESULT_INTEGER
+		&& rr->get_integer() > 0);
+
+	// չܵ
+	pipe.clear();
+	CHECK(pipe.flush());
+	CHECK(pipe.get_size() == 4);
+}
+
+// ֱԲͬĹִܵͬ HGET Ƚ
+static void benchmark(acl::redis_pipeline& pipe, acl::redis_hash& hash,
+	int count, int max_depth)
+{
+	acl::string key;
+	std::vector<acl::string> args;
+	args.push_back("field");
+
+	for (int i = 0; i < 100; i++)
+	{
+		key.format("bench_hash_%d", i);
+		hash.clear();
+		hash.hset(key, "field", "value");
+	}
+
+	struct timeval begin, end;
+	double spent;
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < count; i++)
+	{
+		key.format("bench_hash_%d", i % 100);
+		hash.clear();
+		acl::string buf;
+		if (hash.hget(key, "field", buf) == false)
+		{
+			printf("hget %s error\r\n", key.c_str());
+			break;
+		}
+	}
+	gettimeofday(&end, NULL);
+	spent = util::stamp_sub(&end, &begin);
+	printf("%-12s %8d cmds, %10.2f ms, %10.2f cmds/s\r\n", "no pipeline",
+		count, spent, count * 1000 / (spent > 0 ? spent : 1));
+
+	for (int depth = 1; depth <= max_depth; depth *= 2)
+	{
+		gettimeofday(&begin, NULL);
+
+		int n = 0;
+		while (n < count)
+		{
+			for (int i = 0; i < depth && n < count; i++, n++)
+			{
+				key.format("bench_hash_%d", n % 100);
+				pipe.add("HGET", key, args);
+			}
+			if (pipe.flush() == false)
+			{
+				printf("flush error, depth: %d\r\n", depth);
+				return;
+			}
+		}
+
+		gettimeofday(&end, NULL);
+		spent = util::stamp_sub(&end, &begin);
+
+		char label[32];
+		snprintf(label, sizeof(label), "depth %d", depth);
+		printf("%-12s %8d cmds, %10.2f ms, %10.2f cmds/s\r\n", label,
+			count, spent, count * 1000 / (spent > 0 ? spent : 1));
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379, or addrs of cluster: ip1:port1,ip2:port2]\r\n"
+		"-c [use redis cluster mode]\r\n"
+		"-n count[default: 100]\r\n"
+		"-b [benchmark]\r\n"
+		"-d max_depth[default: 256]\r\n"
+		"-S [use slice request]\r\n"
+		"-C connect_timeout[default: 10]\r\n"
+		"-I rw_timeout[default: 10]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100, max_depth = 256, conn_timeout = 10, rw_timeout = 10;
+	acl::string addr("127.0.0.1:6379");
+	bool cluster_mode = false, bench = false, slice_req = false;
+
+	while ((ch = getopt(argc, argv, "hs:cn:bd:SC:I:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'c':
+			cluster_mode = true;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		case 'd':
+			max_depth = atoi(optarg);
+			break;
+		case 'S':
+			slice_req = true;
+			break;
+		case 'C':
+			conn_timeout = atoi(optarg);
+			break;
+		case 'I':
+			rw_timeout = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::redis_client client(addr.c_str(), conn_timeout, rw_timeout);
+	acl::redis_client_cluster cluster(conn_timeout, rw_timeout);
+	acl::redis_pipeline pipe;
+	acl::redis_hash hash;
+
+	if (cluster_mode)
+	{
+		cluster.set_redirect_sleep(0);
+		cluster.init(NULL, addr.c_str(), 10);
+		pipe.set_cluster(&cluster, 10);
+		hash.set_cluster(&cluster, 10);
+	}
+	else
+	{
+		pipe.set_client(&client);
+		hash.set_client(&client);
+	}
+	pipe.set_slice_request(slice_req);
+
+	if (bench)
+		benchmark(pipe, hash, n, max_depth);
+	else
+		test_pipeline(pipe, n);
+
+	return util::check_result();
+}
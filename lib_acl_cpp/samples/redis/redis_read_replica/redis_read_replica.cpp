@@ -0,0 +1,351 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "util.h"
+
+static std::vector<acl::string> __masters;
+static std::vector<acl::string> __replicas;
+
+// ͨ CLUSTER SLOTS üȺӽĵַ
+static bool get_nodes(const char* addr)
+{
+	acl::redis_client client(addr, 10, 10);
+	acl::redis_cluster cmd(&client);
+
+	const std::vector<acl::redis_slot*>* slots = cmd.cluster_slots();
+	if (slots == NULL)
+		return false;
+
+	acl::string buf;
+	std::vector<acl::redis_slot*>::const_iterator cit, cit2;
+	for (cit = slots->begin(); cit != slots->end(); ++cit)
+	{
+		buf.format("%s:%d", (*cit)->get_ip(), (*cit)->get_port());
+		if (std::find(__masters.begin(), __masters.end(), buf)
+			== __masters.end())
+		{
+			__masters.push_back(buf);
+		}
+
+		const std::vector<acl::redis_slot*>& slaves = (*cit)->get_slaves();
+		for (cit2 = slaves.begin(); cit2 != slaves.end(); ++cit2)
+		{
+			buf.format("%s:%d", (*cit2)->get_ip(),
+				(*cit2)->get_port());
+			if (std::find(__replicas.begin(), __replicas.end(), buf)
+				== __replicas.end())
+			{
+				__replicas.push_back(buf);
+			}
+		}
+	}
+	return !__masters.empty();
+}
+
+// ýۼִ GET Ĵʱ -1
+static long long get_calls(const char* addr)
+{
+	acl::redis_client client(addr, 10, 10);
+	acl::dbuf_pool* dbuf = new acl::dbuf_pool;
+	acl::string req("*2\r\n$4\r\nINFO\r\n$12\r\ncommandstats\r\n");
+	acl::string buf;
+	long long n = -1;
+
+	const acl::redis_result* rr = client.run(dbuf, req, 0);
+	if (rr != NULL && rr->get_type() == acl::REDIS_RESULT_STRING)
+	{
+		rr->argv_to_string(buf);
+		const char* name = "cmdstat_get:calls=";
+		const char* ptr = strstr(buf.c_str(), name);
+		n = ptr ? atoll(ptr + strlen(name)) : 0;
+	}
+
+	delete dbuf;
+	return n;
+}
+
+static long long sum_calls(const std::vector<acl::string>& addrs)
+{
+	long long n = 0;
+	for (size_t i = 0; i < addrs.size(); i++)
+		n += get_calls(addrs[i]);
+	return n;
+}
+
+static const char* mode_name(acl::redis_read_mode_t mode)
+{
+	switch (mode)
+	{
+	case acl::REDIS_READ_PREFER_REPLICA:
+		return "prefer-replica";
+	case acl::REDIS_READ_NEAREST:
+		return "nearest";
+	default:
+		return "master";
+	}
+}
+
+static void set_keys(acl::redis_client_cluster& cluster, int count)
+{
+	acl::redis_string cmd(&cluster, 10);
+	acl::string key, val;
+
+	for (int i = 0; i < count; i++)
+	{
+		key.format("replica_key_%d", i);
+		val.format("replica_value_%d", i);
+		cmd.clear();
+		CHECK(cmd.set(key, val));
+	}
+
+	// ȴͬӽ
+	acl_doze(100);
+}
+
+// ȡеļֵӽֱִ GET Ĵ
+static void get_keys(acl::redis_string& cmd, int count,
+	long long& masters, long long& replicas)
+{
+	acl::string key, val, buf;
+
+	masters = sum_calls(__masters);
+	replicas = sum_calls(__replicas);
+
+	for (int i = 0; i < count; i++)
+	{
+		key.format("replica_key_%d", i);
+		val.format("replica_value_%d", i);
+		cmd.clear();
+		buf.clear();
+		CHECK(cmd.get(key, buf) && buf == val);
+	}
+
+	masters = sum_calls(__masters) - masters;
+	replicas = sum_calls(__replicas) - replicas;
+}
+
+// 鲻ͬ·ɷʽ¶Ľ
+static void test_route(const char* addr, acl::redis_read_mode_t mode,
+	int count)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_redirect_sleep(0);
+	cluster.set_read_mode(mode);
+	cluster.set_all_slot(addr, 10);
+
+	set_keys(cluster, count);
+
+	acl::redis_string cmd(&cluster, 10);
+	CHECK(cmd.get_read_mode() == mode);
+
+	long long masters, replicas;
+	get_keys(cmd, count, masters, replicas);
+	printf("%-16s masters: %lld, replicas: %lld\r\n",
+		mode_name(mode), masters, replicas);
+
+	if (mode == acl::REDIS_READ_MASTER)
+		CHECK(masters == count && replicas == 0);
+	else if (mode == acl::REDIS_READ_PREFER_REPLICA)
+		CHECK(masters == 0 && replicas == count);
+	else
+		CHECK(masters + replicas == count);
+
+	// ӳѱû;
+	std::vector<acl::connect_pool*>& pools = cluster.get_pools();
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		acl::redis_client_pool* pool = (acl::redis_client_pool*) pools[i];
+		CHECK(pool->get_inflight() == 0);
+		if (pool->get_current_used() > 0)
+			CHECK(pool->get_latency() > 0);
+	}
+}
+
+// Ե·ɷʽ
+static void test_override(const char* addr, int count)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_redirect_sleep(0);
+	cluster.set_read_mode(acl::REDIS_READ_PREFER_REPLICA);
+	cluster.set_all_slot(addr, 10);
+
+	acl::redis_string cmd(&cluster, 10);
+	cmd.set_read_mode(acl::REDIS_READ_MASTER);
+
+	long long masters, replicas;
+	get_keys(cmd, count, masters, replicas);
+	CHECK(masters == count && replicas == 0);
+}
+
+// ӽʱȡ
+static void test_dead(const char* addr, int count)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_redirect_sleep(0);
+	cluster.set_retry_inter(60);
+	cluster.set_read_mode(acl::REDIS_READ_PREFER_REPLICA);
+	cluster.set_all_slot(addr, 10);
+
+	for (size_t i = 0; i < __replicas.size(); i++)
+	{
+		acl::connect_pool* pool = cluster.get(__replicas[i]);
+		CHECK(pool != NULL);
+		if (pool)
+			pool->set_alive(false);
+	}
+
+	int max_slot = cluster.get_max_slot();
+	for (int i = 0; i < max_slot; i++)
+	{
+		acl::redis_client_pool* pool = cluster.peek_slot(i);
+		CHECK(cluster.peek_read_slot(i,
+			acl::REDIS_READ_PREFER_REPLICA) == pool);
+		CHECK(cluster.peek_read_slot(i,
+			acl::REDIS_READ_NEAREST) == pool);
+	}
+
+	acl::redis_string cmd(&cluster, 10);
+	long long masters, replicas;
+	get_keys(cmd, count, masters, replicas);
+	CHECK(masters == count && replicas == 0);
+}
+
+// ͽȡʱĶֲ
+static void test_nearest(const char* addr, int count)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_redirect_sleep(0);
+	cluster.set_read_mode(acl::REDIS_READ_NEAREST);
+	cluster.set_all_slot(addr, 10);
+
+	std::vector<acl::string> nodes = __masters;
+	nodes.insert(nodes.end(), __replicas.begin(), __replicas.end());
+
+	std::vector<long long> calls;
+	for (size_t i = 0; i < nodes.size(); i++)
+		calls.push_back(get_calls(nodes[i]));
+
+	acl::redis_string cmd(&cluster, 10);
+	long long masters, replicas;
+	get_keys(cmd, count, masters, replicas);
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		acl::redis_client_pool* pool = (acl::redis_client_pool*)
+			cluster.get(nodes[i]);
+		printf("%-22s %-8s gets: %6lld, latency: %.3f ms\r\n",
+			nodes[i].c_str(), i < __masters.size() ? "master"
+			: "replica", get_calls(nodes[i]) - calls[i],
+			pool ? pool->get_latency() : 0.0);
+	}
+}
+
+// Ƚϲͬ·ɷʽ¶ƽӳټ P99 ӳ
+static void benchmark(const char* addr, int count)
+{
+	acl::redis_read_mode_t modes[] = { acl::REDIS_READ_MASTER,
+		acl::REDIS_READ_PREFER_REPLICA, acl::REDIS_READ_NEAREST };
+
+	for (size_t n = 0; n < sizeof(modes) / sizeof(modes[0]); n++)
+	{
+		acl::redis_client_cluster cluster;
+		cluster.set_redirect_sleep(0);
+		cluster.set_read_mode(modes[n]);
+		cluster.set_all_slot(addr, 10);
+		if (n == 0)
+			set_keys(cluster, 100);
+
+		acl::redis_string cmd(&cluster, 10);
+		std::vector<double> costs;
+		acl::string key, buf;
+		struct timeval begin, end;
+		double total = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			key.format("replica_key_%d", i % 100);
+			cmd.clear();
+			gettimeofday(&begin, NULL);
+			if (!cmd.get(key, buf))
+			{
+				util::check_failed(__FILE__, __LINE__,
+					"get %s error", key.c_str());
+				return;
+			}
+			gettimeofday(&end, NULL);
+			costs.push_back(util::stamp_sub(&end, &begin));
+			total += costs.back();
+		}
+
+		std::sort(costs.begin(), costs.end());
+		printf("%-16s %8d gets, avg: %.3f ms, p99: %.3f ms\r\n",
+			mode_name(modes[n]), count, total / count,
+			costs[costs.size() * 99 / 100]);
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s one redis addr of cluster[127.0.0.1:6379]\r\n"
+		"-n count[default: 100]\r\n"
+		"-b [benchmark]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100;
+	acl::string addr("127.0.0.1:6379");
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:n:b")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (n < 1)
+		n = 1;
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	if (!get_nodes(addr))
+	{
+		printf("get nodes from %s error\r\n", addr.c_str());
+		return 1;
+	}
+	if (__replicas.empty())
+	{
+		printf("no replica in the cluster\r\n");
+		return 1;
+	}
+
+	if (bench)
+		benchmark(addr, n);
+	else
+	{
+		test_route(addr, acl::REDIS_READ_MASTER, n);
+		test_route(addr, acl::REDIS_READ_PREFER_REPLICA, n);
+		test_route(addr, acl::REDIS_READ_NEAREST, n);
+		test_override(addr, n);
+		test_dead(addr, n);
+		test_nearest(addr, n);
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,287 @@
+#include "stdafx.h"
+#include "util.h"
+
+// ͬȵַݣֱλڶڡԽƬ߽紦
+static void test_string(acl::redis_client& client, bool slice)
+{
+	const size_t lens[] = { 0, 1, 4095, 4096, 8190, 8191, 8192,
+		65535, 65536, 100000, 1024 * 1024 + 3 };
+
+	client.set_slice_respond(slice);
+
+	acl::redis_string cmd(&client);
+	acl::string key, val, buf;
+
+	for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+	{
+		// а \r\n  \0
+		val.clear();
+		for (size_t j = 0; j < lens[i]; j++)
+			val.push_back(j % 7 == 0 ? '\r' : j % 7 == 1 ? '\n'
+				: j % 7 == 2 ? '\0' : (char) ('a' + j % 26));
+
+		key.format("reply_key_%d", (int) lens[i]);
+		cmd.clear();
+		CHECK(cmd.set(key, key.length(), val, val.length()));
+
+		cmd.clear();
+		buf.clear();
+		CHECK(cmd.get(key, buf));
+		CHECK(buf.length() == val.length()
+			&& memcmp(buf.c_str(), val.c_str(), val.length()) == 0);
+
+		// Ƭģʽ£λڶڵݱֱãڶ
+		// 򱻴洢ڶΪ 8191 ֽڵڴƬ
+		const acl::redis_result* rr = cmd.get_result();
+		CHECK(rr != NULL && rr->get_type() == acl::REDIS_RESULT_STRING);
+		if (rr != NULL && slice && lens[i] > 65536)
+			CHECK(rr->get_size() == (lens[i] + 8190) / 8191);
+		else if (rr != NULL && !slice)
+			CHECK(rr->get_size() == 1);
+	}
+
+	// ڵļֵ
+	cmd.clear();
+	buf.clear();
+	CHECK(cmd.get("reply_no_such_key", buf) == false && buf.empty());
+	CHECK(cmd.get_result() != NULL
+		&& cmd.get_result()->get_type() == acl::REDIS_RESULT_STRING);
+
+	client.set_slice_respond(false);
+}
+
+static void hash_prepare(acl::redis_client& client, acl::redis_hash& cmd,
+	const char* key, int count)
+{
+	acl::redis_key key_cmd(&client);
+	CHECK(key_cmd.del_one(key) >= 0);
+
+	std::map<acl::string, acl::string> attrs;
+	acl::string name, value;
+
+	for (int i = 0; i < count; i++)
+	{
+		name.format("field_%d", i);
+		value.format("value_%d", i);
+		attrs[name] = value;
+
+		if (attrs.size() == 1000 || i == count - 1)
+		{
+			cmd.clear();
+			CHECK(cmd.hmset(key, attrs));
+			attrs.clear();
+		}
+	}
+}
+
+// ӦĸԪضӦȷ
+static void test_hash(acl::redis_client& client, int count)
+{
+	acl::redis_hash cmd(&client);
+	hash_prepare(client, cmd, "reply_hash", count);
+
+	std::map<acl::string, acl::string> result;
+	cmd.clear();
+	CHECK(cmd.hgetall("reply_hash", result));
+	CHECK(result.size() == (size_t) count);
+
+	acl::string name, value;
+	for (int i = 0; i < count; i += count / 10 + 1)
+	{
+		name.format("field_%d", i);
+		value.format("value_%d", i);
+		CHECK(result[name] == value);
+	}
+}
+
+// ͵ĶӦܱһζ
+static void test_pubsub(const char* addr)
+{
+	acl::redis_client client(addr), client2(addr);
+	acl::redis_pubsub sub(&client), pub(&client2);
+
+	CHECK(sub.subscribe("reply_chan1", "reply_chan2",
+		"reply_chan3", NULL) == 3);
+
+	acl::string msg, channel;
+	for (int i = 0; i < 100; i++)
+	{
+		msg.format("message_%d", i);
+		pub.clear();
+		CHECK(pub.publish("reply_chan2", msg, msg.length()) == 1);
+	}
+
+	acl::string buf;
+	for (int i = 0; i < 100; i++)
+	{
+		msg.format("message_%d", i);
+		sub.clear();
+		CHECK(sub.get_message(channel, buf));
+		CHECK(channel == "reply_chan2" && buf == msg);
+	}
+}
+
+// ģˣһдӦ
+class reply_server : public acl::thread
+{
+public:
+	reply_server(acl::server_socket& server, const char* part1,
+		const char* part2)
+	: server_(server), part1_(part1), part2_(part2) {}
+	~reply_server() {}
+
+protected:
+	void* run()
+	{
+		acl::socket_stream* conn = server_.accept();
+		if (conn == NULL)
+			return NULL;
+
+		char buf[1024];
+		if (conn->read(buf, sizeof(buf), false) > 0)
+		{
+			conn->write(part1_, strlen(part1_));
+			acl_doze(10);
+			if (*part2_)
+				conn->write(part2_, strlen(part2_));
+		}
+
+		// ȴͻ˹ر
+		conn->read(buf, sizeof(buf), false);
+		delete conn;
+		return NULL;
+	}
+
+private:
+	acl::server_socket& server_;
+	const char* part1_;
+	const char* part2_;
+};
+
+static bool get_reply(acl::server_socket& server, const char* part1,
+	const char* part2, acl::string& buf)
+{
+	reply_server rs(server, part1, part2);
+	rs.set_detachable(false);
+	rs.start();
+
+	bool ret;
+	{
+		acl::redis_client client(server.get_addr(), 10, 10, false);
+		acl::redis_string cmd(&client);
+		buf.clear();
+		ret = cmd.get("reply_key", buf);
+	}
+
+	rs.wait();
+	return ret;
+}
+
+// ַݺΪ \r\n߷ֱλζʱ
+static void test_terminator(void)
+{
+	acl::server_socket server;
+	if (server.open("127.0.0.1:0") == false)
+	{
+		util::check_failed(__FILE__, __LINE__, "listen error");
+		return;
+	}
+
+	acl::string buf;
+	CHECK(get_reply(server, "$3\r\nabc\r\n", "", buf) && buf == "abc");
+	CHECK(get_reply(server, "$3\r\nabc\r", "\n", buf) && buf == "abc");
+	CHECK(get_reply(server, "$3\r\nabc", "\r\n", buf) && buf == "abc");
+	CHECK(get_reply(server, "$0\r\n\r\n", "", buf) && buf.empty());
+	CHECK(!get_reply(server, "$3\r\nabcXY", "", buf));
+	CHECK(!get_reply(server, "$3\r\nabc\n\r", "", buf));
+	CHECK(!get_reply(server, "$3\r\nabc\r", "X", buf));
+	CHECK(!get_reply(server, "$3\r\nabc", "X\n", buf));
+	CHECK(!get_reply(server, "$0\r\nXY", "", buf));
+}
+
+// ԽӦٶ
+static void benchmark(acl::redis_client& client, int count, int loop)
+{
+	acl::redis_hash cmd(&client);
+	hash_prepare(client, cmd, "reply_bench", count);
+
+	std::vector<const char*> names, values;
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	for (int i = 0; i < loop; i++)
+	{
+		names.clear();
+		values.clear();
+		cmd.clear();
+		if (cmd.hgetall("reply_bench", names, values) == false
+			|| names.size() != (size_t) count)
+		{
+			util::check_failed(__FILE__, __LINE__, "hgetall error");
+			break;
+		}
+	}
+
+	gettimeofday(&end, NULL);
+	double spent = util::stamp_sub(&end, &begin);
+	printf("hgetall %d fields, loop %d, spent %.2f ms, %.2f ms per reply\r\n",
+		count, loop, spent, spent / (loop > 0 ? loop : 1));
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379]\r\n"
+		"-n count of hash fields[default: 100000]\r\n"
+		"-b [benchmark]\r\n"
+		"-l loop[default: 10]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100000, loop = 10;
+	acl::string addr("127.0.0.1:6379");
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:n:bl:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		case 'l':
+			loop = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::redis_client client(addr.c_str());
+
+	if (bench)
+		benchmark(client, n, loop);
+	else
+	{
+		test_terminator();
+		test_string(client, false);
+		test_string(client, true);
+		test_hash(client, n);
+		test_pubsub(addr);
+	}
+
+	return util::check_result();
+}
@@ -0,0 +1,516 @@
+#include "stdafx.h"
+#include <map>
+#include "util.h"
+
+/**
+ * ÿƵϢǷ񰴷˳򵽴ͬһ̴߳Ϣ
+ * ΪƵڵ
+ */
+class my_subscriber : public acl::redis_subscriber
+{
+public:
+	my_subscriber(const char* addr, size_t shards, size_t threads)
+	: acl::redis_subscriber(addr, shards, threads)
+	, messages_(0)
+	, patterns_(0)
+	, disorders_(0)
+	, switches_(0)
+	, reopens_(0)
+	, slow_(0)
+	{
+	}
+
+	my_subscriber(acl::redis_client_cluster* cluster, size_t shards,
+		size_t threads)
+	: acl::redis_subscriber(cluster, shards, threads)
+	, messages_(0)
+	, patterns_(0)
+	, disorders_(0)
+	, switches_(0)
+	, reopens_(0)
+	, slow_(0)
+	{
+	}
+
+	~my_subscriber()
+	{
+		stop();
+	}
+
+	// ƵϢÿζ slow_ 
+	void set_slow(const char* channel, int ms)
+	{
+		slow_channel_ = channel;
+		slow_ = ms;
+	}
+
+	long long get_messages()
+	{
+		lock_.lock();
+		long long n = messages_;
+		lock_.unlock();
+		return n;
+	}
+
+	long long get_messages(const char* channel)
+	{
+		lock_.lock();
+		long long n = counts_[channel];
+		lock_.unlock();
+		return n;
+	}
+
+	long long get_patterns() const
+	{
+		return patterns_;
+	}
+
+	long long get_disorders() const
+	{
+		return disorders_;
+	}
+
+	long long get_switches() const
+	{
+		return switches_;
+	}
+
+	// ôƵϢ߳ idδյϢʱ 0
+	unsigned long get_tid(const char* channel)
+	{
+		lock_.lock();
+		std::map<acl::string, unsigned long>::iterator it =
+			tids_.find(channel);
+		unsigned long tid = it == tids_.end() ? 0 : it->second;
+		lock_.unlock();
+		return tid;
+	}
+
+	int get_reopens() const
+	{
+		return reopens_;
+	}
+
+	void reset()
+	{
+		lock_.lock();
+		seqs_.clear();
+		counts_.clear();
+		messages_ = 0;
+		patterns_ = 0;
+		lock_.unlock();
+	}
+
+	// ȴյ n Ϣʱ false
+	bool wait(long long n, int timeout_ms)
+	{
+		for (int i = 0; i < timeout_ms; i++)
+		{
+			if (get_messages() >= n)
+				return true;
+			acl_doze(1);
+		}
+		return get_messages() >= n;
+	}
+
+protected:
+	void on_message(const acl::string& channel, const acl::string& msg,
+		const char* pattern)
+	{
+		if (slow_ > 0 && channel == slow_channel_)
+			acl_doze(slow_);
+
+		long long seq = atoll(msg.c_str());
+		unsigned long tid = acl::thread::thread_self();
+
+		lock_.lock();
+		std::map<acl::string, long long>::iterator it =
+			seqs_.find(channel);
+		if (it != seqs_.end() && seq != it->second + 1)
+			disorders_++;
+		seqs_[channel] = seq;
+
+		std::map<acl::string, unsigned long>::iterator it2 =
+			tids_.find(channel);
+		if (it2 != tids_.end() && it2->second != tid)
+			switches_++;
+		tids_[channel] = tid;
+
+		counts_[channel]++;
+		messages_++;
+		if (pattern != NULL)
+			patterns_++;
+		lock_.unlock();
+	}
+
+	void on_reconnect(const char*)
+	{
+		reopens_++;
+	}
+
+private:
+	acl::locker lock_;
+	std::map<acl::string, long long> seqs_;
+	std::map<acl::string, long long> counts_;
+	std::map<acl::string, unsigned long> tids_;
+	long long messages_;
+	long long patterns_;
+	long long disorders_;
+	long long switches_;
+	int reopens_;
+	acl::string slow_channel_;
+	int slow_;
+};
+
+// ÿƵη count ϢϢΪ 1 ʼ
+static long long publish(acl::redis_pubsub& cmd,
+	const std::vector<acl::string>& channels, int count)
+{
+	acl::string msg;
+	long long n = 0;
+
+	for (int i = 1; i <= count; i++)
+	{
+		msg.format("%d", i);
+		for (size_t j = 0; j < channels.size(); j++)
+		{
+			cmd.clear();
+			int ret = cmd.publish(channels[j], msg, msg.length());
+			if (ret > 0)
+				n += ret;
+		}
+	}
+	return n;
+}
+
+static long long run_cmd(const char* addr, const char* cmd)
+{
+	acl::redis_client client(addr, 10, 10);
+	acl::dbuf_pool* dbuf = new acl::dbuf_pool;
+	acl::string req;
+	req.format("*1\r\n$%d\r\n%s\r\n", (int) strlen(cmd), cmd);
+
+	const acl::redis_result* rr = client.run(dbuf, req, 0);
+	long long n = rr && rr->get_type() == acl::REDIS_RESULT_INTEGER
+		? rr->get_integer64() : -1;
+	delete dbuf;
+	return n;
+}
+
+static void make_channels(std::vector<acl::string>& channels, int count,
+	const char* prefix)
+{
+	acl::string buf;
+	for (int i = 0; i < count; i++)
+	{
+		buf.format("%s_%d", prefix, i);
+		channels.push_back(buf);
+	}
+}
+
+// ƵϢ˳򵽴ͬһƵͬһ̴߳
+static void test_order(const char* addr, int count)
+{
+	my_subscriber sub(addr, 4, 4);
+	std::vector<acl::string> channels;
+	make_channels(channels, 64, "order");
+
+	CHECK(sub.subscribe(channels));
+	CHECK(sub.start());
+	CHECK(!sub.start());
+
+	acl::redis_client client(addr, 10, 10);
+	acl::redis_pubsub cmd(&client);
+	long long n = publish(cmd, channels, count);
+	CHECK(n == (long long) channels.size() * count);
+
+	CHECK(sub.wait(n, 5000));
+	CHECK(sub.get_disorders() == 0);
+	CHECK(sub.get_switches() == 0);
+	CHECK(sub.get_patterns() == 0);
+	for (size_t i = 0; i < channels.size(); i++)
+		CHECK(sub.get_messages(channels[i]) == count);
+
+	sub.stop();
+	CHECK(sub.get_received() == (unsigned long long) n);
+	CHECK(sub.get_handled() == (unsigned long long) n);
+	printf("order: %lld messages on %d channels\r\n",
+		n, (int) channels.size());
+}
+
+// ģʽļȡ
+static void test_pattern(const char* addr)
+{
+	my_subscriber sub(addr, 2, 2);
+	CHECK(sub.start());
+	CHECK(sub.psubscribe("pat_*"));
+	CHECK(sub.subscribe("plain"));
+	acl_doze(100);
+
+	acl::redis_client client(addr, 10, 10);
+	acl::redis_pubsub cmd(&client);
+	std::vector<acl::string> channels;
+	channels.push_back("pat_a");
+	channels.push_back("pat_b");
+	channels.push_back("plain");
+	channels.push_back("other");
+
+	CHECK(publish(cmd, channels, 10) == 30);
+	CHECK(sub.wait(30, 5000));
+	CHECK(sub.get_patterns() == 20);
+	CHECK(sub.get_messages("plain") == 10);
+	CHECK(sub.get_messages("other") == 0);
+
+	CHECK(sub.punsubscribe("pat_*"));
+	CHECK(sub.unsubscribe("plain"));
+	acl_doze(100);
+	sub.reset();
+	CHECK(publish(cmd, channels, 10) == 0);
+	acl_doze(100);
+	CHECK(sub.get_messages() == 0);
+}
+
+// ӱ˶ϿԶ¶
+static void test_reconnect(const char* addr)
+{
+	my_subscriber sub(addr, 2, 2);
+	std::vector<acl::string> channels;
+	make_channels(channels, 8, "reconn");
+	CHECK(sub.subscribe(channels));
+	CHECK(sub.psubscribe("reconn_p*"));
+	CHECK(sub.start());
+
+	acl::redis_client client(addr, 10, 10);
+	acl::redis_pubsub cmd(&client);
+	CHECK(publish(cmd, channels, 10) == 80);
+	CHECK(sub.wait(80, 5000));
+
+	CHECK(run_cmd(addr, "KILLSUBS") == 2);
+
+	// ȴؽ
+	for (int i = 0; i < 50 && sub.get_reopens() < 2; i++)
+		acl_doze(100);
+	CHECK(sub.get_reopens() == 2);
+	CHECK(sub.get_reconnects() == 2);
+
+	sub.reset();
+	channels.push_back("reconn_pattern");
+	CHECK(publish(cmd, channels, 10) == 90);
+	CHECK(sub.wait(90, 5000));
+	CHECK(sub.get_patterns() == 10);
+	printf("reconnect: %llu reconnects\r\n", sub.get_reconnects());
+}
+
+// ƵӰƵϢ
+static void test_slow(const char* addr)
+{
+	my_subscriber sub(addr, 1, 4);
+	std::vector<acl::string> channels;
+	make_channels(channels, 16, "slow");
+	sub.set_slow(channels[0], 10);
+	CHECK(sub.subscribe(channels));
+	CHECK(sub.start());
+
+	acl::redis_client client(addr, 10, 10);
+	acl::redis_pubsub cmd(&client);
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+	CHECK(publish(cmd, channels, 100) == 1600);
+
+	// ͬһƵϢͬһ̴߳Ƶλͬһ̵߳Ƶ
+	// ᱻӳ٣߳ƵϢӦԶƵ( 1 )
+	acl_doze(300);
+	gettimeofday(&end, NULL);
+
+	unsigned long slow_tid = sub.get_tid(channels[0]);
+	int fast = 0, blocked = 0;
+	for (size_t i = 1; i < channels.size(); i++)
+	{
+		unsigned long tid = sub.get_tid(channels[i]);
+		if (tid == 0 || tid == slow_tid)
+			blocked++;
+		else
+		{
+			CHECK(sub.get_messages(channels[i]) == 100);
+			fast++;
+		}
+	}
+	CHECK(fast > 0);
+	CHECK(sub.get_messages(channels[0]) < 100);
+	printf("slow: %d channels done in %.2f ms, %d channels blocked, "
+		"slow channel: %lld\r\n", fast, util::stamp_sub(&end, &begin),
+		blocked, sub.get_messages(channels[0]));
+
+	CHECK(sub.wait(1600, 5000));
+	CHECK(sub.get_disorders() == 0);
+}
+
+// Ⱥģʽ¶ӷֲڸ
+static void test_cluster(const char* addr, int count)
+{
+	acl::redis_client_cluster cluster;
+	cluster.set_all_slot(addr, 10);
+
+	my_subscriber sub(&cluster, 3, 4);
+	std::vector<acl::string> channels;
+	make_channels(channels, 32, "cluster");
+	CHECK(sub.subscribe(channels));
+	CHECK(sub.start());
+
+	acl::redis_pubsub cmd(&cluster, 10);
+	long long n = publish(cmd, channels, count);
+	CHECK(n == (long long) channels.size() * count);
+	CHECK(sub.wait(n, 5000));
+	CHECK(sub.get_disorders() == 0);
+	printf("cluster: %lld messages\r\n", n);
+}
+
+class publisher : public acl::thread
+{
+public:
+	publisher(const char* addr, const std::vector<acl::string>& channels,
+		int count)
+	: addr_(addr), channels_(channels), count_(count), published_(0) {}
+	~publisher() {}
+
+	long long get_published() const
+	{
+		return published_;
+	}
+
+protected:
+	void* run()
+	{
+		acl::redis_client client(addr_, 10, 10);
+		acl::redis_pubsub cmd(&client);
+		published_ = publish(cmd, channels_, count_);
+		return NULL;
+	}
+
+private:
+	acl::string addr_;
+	std::vector<acl::string> channels_;
+	int count_;
+	long long published_;
+};
+
+// ̲߳ϢϢķַٶ
+static void benchmark(const char* addr, int count, size_t shards,
+	size_t threads, int npub)
+{
+	my_subscriber sub(addr, shards, threads);
+	std::vector<acl::string> channels;
+	make_channels(channels, 256, "bench");
+	CHECK(sub.subscribe(channels));
+	CHECK(sub.start());
+
+	std::vector<publisher*> pubs;
+	for (int i = 0; i < npub; i++)
+	{
+		std::vector<acl::string> part;
+		for (size_t j = i; j < channels.size(); j += npub)
+			part.push_back(channels[j]);
+		publisher* pub = new publisher(addr, part, count);
+		pub->set_detachable(false);
+		pubs.push_back(pub);
+	}
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	for (size_t i = 0; i < pubs.size(); i++)
+		pubs[i]->start();
+
+	long long n = 0;
+	for (size_t i = 0; i < pubs.size(); i++)
+	{
+		pubs[i]->wait();
+		n += pubs[i]->get_published();
+		delete pubs[i];
+	}
+
+	CHECK(sub.wait(n, 60000));
+	gettimeofday(&end, NULL);
+
+	double spent = util::stamp_sub(&end, &begin);
+	printf("benchmark: %lld messages, %d publishers, %d shards, "
+		"%d threads, %.2f ms, %.2f messages/s\r\n", n, npub,
+		(int) shards, (int) threads, spent, n * 1000 / spent);
+	CHECK(sub.get_disorders() == 0);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis addr[127.0.0.1:6379]\r\n"
+		"-c redis cluster addr[127.0.0.1:7000]\r\n"
+		"-n count[default: 100]\r\n"
+		"-b [benchmark]\r\n"
+		"-S shards[default: 4]\r\n"
+		"-t threads[default: 4]\r\n"
+		"-p publishers[default: 4]\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 100, npub = 4;
+	size_t shards = 4, threads = 4;
+	acl::string addr("127.0.0.1:6379"), cluster_addr;
+	bool bench = false;
+
+	while ((ch = getopt(argc, argv, "hs:c:n:bS:t:p:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'c':
+			cluster_addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			bench = true;
+			break;
+		case 'S':
+			shards = (size_t) atoi(optarg);
+			break;
+		case 't':
+			threads = (size_t) atoi(optarg);
+			break;
+		case 'p':
+			npub = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (n < 1)
+		n = 1;
+	if (npub < 1)
+		npub = 1;
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	if (bench)
+		benchmark(addr, n, shards, threads, npub);
+	else
+	{
+		test_order(addr, n);
+		test_pattern(addr);
+		test_reconnect(addr);
+		test_slow(addr);
+		if (!cluster_addr.empty())
+			test_cluster(cluster_addr, n);
+	}
+
+	return util::check_result();
+}
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <stdarg.h>
 #include <string.h>
 #include "util.h"
 
@@ -17,3 +18,29 @@ double util::stamp_sub(const struct timeval *from, const struct timeval *sub_by)
 
 	return (res.tv_sec * 1000.0 + res.tv_usec/1000.0);
 }
+
+static int __check_failed = 0;
+
+void util::check_failed(const char* file, int line, const char* fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	printf("%s(%d): check failed: ", file, line);
+	vprintf(fmt, ap);
+	printf("\r\n");
+	va_end(ap);
+
+	__check_failed++;
+}
+
+int util::check_result(void)
+{
+	if (__check_failed > 0) {
+		printf("%d checks failed\r\n", __check_failed);
+		return 1;
+	}
+
+	printf("all checks passed\r\n");
+	return 0;
+}
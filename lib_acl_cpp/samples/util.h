@@ -1,4 +1,5 @@
 #pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
 
 class util
 {
@@ -7,4 +8,17 @@ public:
 	~util() {}
 
 	static double stamp_sub(const struct timeval *from, const struct timeval *sub_by);
+
+	// ¼һμʧܲʧܵλüԭһͨ CHECK 
+	static void check_failed(const char* file, int line, const char* fmt, ...)
+		ACL_CPP_PRINTF(3, 4);
+
+	// ȫĽȫͨʱ 0򷵻 1 main ķֵ
+	static int check_result(void);
 };
+
+// ǷʱλüΪһʧ
+#define CHECK(cond) do { \
+	if (!(cond)) \
+		util::check_failed(__FILE__, __LINE__, "%s", #cond); \
+} while (0)
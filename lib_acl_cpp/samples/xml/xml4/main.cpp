@@ -0,0 +1,405 @@
+#include "lib_acl.h"
+#include "acl_cpp/lib_acl.hpp"
+#include <getopt.h>
+#include <sys/time.h>
+#include "util.h"
+
+static void create_xml(acl::string& buf, int count)
+{
+	buf = "<?xml version=\"1.0\"?>\r\n<config>";
+	for (int i = 0; i < count; i++)
+	{
+		buf.format_append("<server id=\"s%d\"><Addr>127.0.0.1:%d</Addr>"
+			"<conns>%d</conns><backup><addr>10.0.0.1:%d</addr>"
+			"</backup></server>", i, 8000 + i, i, 9000 + i);
+	}
+	buf += "</config>";
+}
+
+static void create_json(acl::string& buf, int count)
+{
+	buf = "{\"servers\": [";
+	for (int i = 0; i < count; i++)
+	{
+		if (i > 0)
+			buf += ", ";
+		buf.format_append("{\"Addr\": \"127.0.0.1:%d\", \"conns\": %d,"
+			" \"backup\": {\"addr\": \"10.0.0.1:%d\"}}",
+			8000 + i, i, 9000 + i);
+	}
+	buf += "]}";
+}
+
+// ǰĲѯ(˳)Ӧȫͬ
+static bool same_xml(ACL_ARRAY* a, ACL_ARRAY* b)
+{
+	if (a == NULL || b == NULL)
+		return a == b;
+	if (acl_array_size(a) != acl_array_size(b))
+		return false;
+	for (int i = 0; i < acl_array_size(a); i++)
+	{
+		if (acl_array_index(a, i) != acl_array_index(b, i))
+			return false;
+	}
+	return true;
+}
+
+static void check_xml_tag(ACL_XML* xml, const char* tag)
+{
+	acl_xml_index(xml, 0);
+	ACL_ARRAY* a = acl_xml_getElementsByTagName(xml, tag);
+	acl_xml_index(xml, 1);
+	// 󷵻صڵĽ飬ǸƷͷ
+	ACL_ARRAY* b = acl_xml_getElementsByTagName(xml, tag);
+	CHECK(same_xml(a, b));
+	CHECK(b == acl_xml_index_lookup(xml, tag));
+	if (a)
+		acl_xml_free_array(a);
+}
+
+static void check_xml_tags(ACL_XML* xml, const char* tags)
+{
+	acl_xml_index(xml, 0);
+	ACL_ARRAY* a = acl_xml_getElementsByTags(xml, tags);
+	acl_xml_index(xml, 1);
+	ACL_ARRAY* b = acl_xml_getElementsByTags(xml, tags);
+	CHECK(same_xml(a, b));
+	if (a)
+		acl_xml_free_array(a);
+	if (b)
+		acl_xml_free_array(b);
+}
+
+static ACL_ARRAY* xml_walk(ACL_XML* xml, const char* tag)
+{
+	ACL_ARRAY* a = acl_array_create(10);
+	ACL_ITER iter;
+
+	acl_foreach(iter, xml)
+	{
+		ACL_XML_NODE* node = (ACL_XML_NODE*) iter.data;
+		if (strcasecmp(tag, acl_vstring_str(node->ltag)) == 0)
+			acl_array_append(a, node);
+	}
+	if (acl_array_size(a) == 0)
+	{
+		acl_array_free(a, NULL);
+		return NULL;
+	}
+	return a;
+}
+
+// ǰʱɽĵ˳вҪؽ
+// ÿ step ֽڣʹǩڲͬݿ
+static void check_xml_parse(const acl::string& buf, size_t step)
+{
+	static const char* tags[] = { "xml", "config", "server", "addr",
+		"conns", "backup", "none", NULL };
+	ACL_XML* xml = acl_xml_alloc();
+	acl_xml_index(xml, 1);
+
+	for (size_t off = 0; off < buf.length(); off += step)
+	{
+		acl::string chunk(buf.c_str() + off,
+			off + step < buf.length() ? step : buf.length() - off);
+		acl_xml_update(xml, chunk.c_str());
+		CHECK(xml->tag_dirty == 0);
+	}
+
+	for (int i = 0; tags[i] != NULL; i++)
+	{
+		ACL_ARRAY* a = xml_walk(xml, tags[i]);
+		CHECK(same_xml(a, acl_xml_getElementsByTagName(xml, tags[i])));
+		if (a)
+			acl_array_free(a, NULL);
+	}
+	CHECK(xml->tag_dirty == 0);
+	acl_xml_free(xml);
+}
+
+static void test_xml(void)
+{
+	acl::string buf;
+	create_xml(buf, 10);
+
+	// ݣһβѯʱв
+	acl::xml xml;
+	xml.use_index(true);
+	size_t half = buf.length() / 2;
+	acl::string first(buf.c_str(), half);
+	xml.update(first.c_str());
+	size_t n = xml.getElementsByTagName("conns").size();
+	CHECK(n > 0 && n < 10);
+	xml.update(buf.c_str() + half);
+	CHECK(xml.getElementsByTagName("conns").size() == 10);
+
+	check_xml_parse(buf, 1);
+	check_xml_parse(buf, 7);
+	check_xml_parse(buf, buf.length());
+
+	ACL_XML* x = xml.get_xml();
+	check_xml_tag(x, "server");
+	check_xml_tag(x, "addr");
+	check_xml_tag(x, "ADDR");
+	check_xml_tag(x, "none");
+	check_xml_tag(x, "xml");
+	check_xml_tags(x, "config/server/addr");
+	check_xml_tags(x, "server/*/addr");
+	check_xml_tags(x, "backup/addr");
+	check_xml_tags(x, "none/addr");
+
+	// ǩִСдAddr  addr ͬһ
+	CHECK(xml.getElementsByTagName("aDdR").size() == 20);
+	CHECK(xml.getElementsByTags("server/addr").size() == 10);
+	const acl::xml_node* node = xml.getFirstElementByTag("conns");
+	CHECK(node && strcmp(node->text(), "0") == 0);
+	node = xml.getElementById("s3");
+	CHECK(node && strcmp(node->tag_name(), "server") == 0);
+
+	// ӡɾԶؽ
+	acl::xml_node& extra = xml.create_node("conns", "100");
+	xml.get_root().add_child(extra);
+	CHECK(xml.getElementsByTagName("conns").size() == 11);
+	check_xml_tag(x, "conns");
+
+	ACL_ARRAY* a = acl_xml_index_lookup(x, "backup");
+	CHECK(a && acl_array_size(a) == 10);
+	acl_xml_node_delete((ACL_XML_NODE*) acl_array_index(a, 0));
+	CHECK(xml.getElementsByTagName("backup").size() == 9);
+	CHECK(xml.getElementsByTagName("addr").size() == 19);
+	check_xml_tags(x, "backup/addr");
+
+	xml.reset();
+	CHECK(xml.getElementsByTagName("conns").empty());
+	xml.update("<a><b>1</b><B>2</B></a>");
+	CHECK(xml.getElementsByTagName("b").size() == 2);
+
+	xml.use_index(false);
+	CHECK(xml.getElementsByTagName("b").size() == 2);
+}
+
+static void check_json_tag(ACL_JSON* json, const char* tag)
+{
+	acl_json_index(json, 0);
+	ACL_ARRAY* a = acl_json_getElementsByTagName(json, tag);
+	acl_json_index(json, 1);
+	// 󷵻صڵĽ飬ǸƷͷ
+	ACL_ARRAY* b = acl_json_getElementsByTagName(json, tag);
+	CHECK(same_xml(a, b));
+	CHECK(b == acl_json_index_lookup(json, tag));
+	if (a)
+		acl_json_free_array(a);
+}
+
+static void check_json_tags(ACL_JSON* json, const char* tags)
+{
+	acl_json_index(json, 0);
+	ACL_ARRAY* a = acl_json_getElementsByTags(json, tags);
+	acl_json_index(json, 1);
+	ACL_ARRAY* b = acl_json_getElementsByTags(json, tags);
+	CHECK(same_xml(a, b));
+	if (a)
+		acl_json_free_array(a);
+	if (b)
+		acl_json_free_array(b);
+}
+
+static ACL_ARRAY* json_walk(ACL_JSON* json, const char* tag)
+{
+	ACL_ARRAY* a = acl_array_create(10);
+	ACL_ITER iter;
+
+	acl_foreach(iter, json)
+	{
+		ACL_JSON_NODE* node = (ACL_JSON_NODE*) iter.data;
+		if (strcasecmp(tag, acl_vstring_str(node->ltag)) == 0)
+			acl_array_append(a, node);
+	}
+	if (acl_array_size(a) == 0)
+	{
+		acl_array_free(a, NULL);
+		return NULL;
+	}
+	return a;
+}
+
+static void check_json_index(ACL_JSON* json)
+{
+	static const char* tags[] = { "servers", "addr", "conns",
+		"backup", "none", NULL };
+
+	for (int i = 0; tags[i] != NULL; i++)
+	{
+		ACL_ARRAY* a = json_walk(json, tags[i]);
+		CHECK(same_xml(a, acl_json_getElementsByTagName(json, tags[i])));
+		if (a)
+			acl_array_free(a, NULL);
+	}
+	CHECK(json->tag_dirty == 0);
+}
+
+// ״̬ٽ msgpack ̶ڽʱ
+static void check_json_parse(const acl::string& buf, size_t step)
+{
+	ACL_JSON* json = acl_json_alloc();
+	acl_json_index(json, 1);
+
+	for (size_t off = 0; off < buf.length(); off += step)
+	{
+		acl::string chunk(buf.c_str() + off,
+			off + step < buf.length() ? step : buf.length() - off);
+		acl_json_update(json, chunk.c_str());
+		CHECK(json->tag_dirty == 0);
+	}
+	check_json_index(json);
+
+	ACL_VSTRING* packed = acl_json_build_msgpack(json, NULL);
+	acl_json_free(json);
+
+	json = acl_json_alloc();
+	acl_json_index(json, 1);
+	acl_json_update_fast(json, buf.c_str());
+	check_json_index(json);
+	acl_json_free(json);
+
+	json = acl_json_alloc();
+	acl_json_index(json, 1);
+	CHECK(acl_json_update_msgpack(json, acl_vstring_str(packed),
+		ACL_VSTRING_LEN(packed)) == (int) ACL_VSTRING_LEN(packed));
+	check_json_index(json);
+	acl_json_free(json);
+	acl_vstring_free(packed);
+}
+
+static void test_json(void)
+{
+	acl::string buf;
+	create_json(buf, 10);
+
+	acl::json json;
+	json.use_index(true);
+	size_t half = buf.length() / 2;
+	acl::string first(buf.c_str(), half);
+	json.update(first.c_str());
+	size_t n = json.getElementsByTagName("conns").size();
+	CHECK(n > 0 && n < 10);
+	json.update(buf.c_str() + half);
+	CHECK(json.getElementsByTagName("conns").size() == 10);
+
+	check_json_parse(buf, 1);
+	check_json_parse(buf, 7);
+	check_json_parse(buf, buf.length());
+
+	ACL_JSON* j = json.get_json();
+	check_json_tag(j, "servers");
+	check_json_tag(j, "addr");
+	check_json_tag(j, "ADDR");
+	check_json_tag(j, "none");
+	check_json_tags(j, "servers/addr");
+	check_json_tags(j, "servers/backup/addr");
+	check_json_tags(j, "servers/*/addr");
+
+	CHECK(json.getElementsByTagName("addr").size() == 20);
+	CHECK(json.getElementsByTags("servers/backup/addr").size() == 10);
+
+	// ޸ıǩӽԶؽ
+	const std::vector<acl::json_node*>& conns =
+		json.getElementsByTagName("conns");
+	CHECK(conns.size() == 10 && conns[0]->set_tag("count"));
+	CHECK(json.getElementsByTagName("count").size() == 1);
+	json.get_root().add_number("conns", 100);
+	CHECK(json.getElementsByTagName("conns").size() == 10);
+	check_json_tag(j, "conns");
+
+	json.reset();
+	CHECK(json.getElementsByTagName("conns").empty());
+	json.update("{\"a\": {\"B\": 1, \"b\": [1, {\"b\": 2}]}}");
+	CHECK(json.getElementsByTagName("b").size() == 3);
+	check_json_tags(j, "a/b");
+}
+
+static void bench(int count, int loop)
+{
+	static const char* tags[] = { "addr", "conns", "server", "backup", NULL };
+	acl::string buf;
+	create_xml(buf, count);
+
+	struct timeval begin, end;
+	for (int k = 0; k < 2; k++)
+	{
+		acl::xml xml(buf.c_str());
+		xml.use_index(k == 1);
+		size_t total = 0;
+
+		gettimeofday(&begin, NULL);
+		for (int i = 0; i < loop; i++)
+			total += xml.getElementsByTags(tags[i % 4]).size();
+		gettimeofday(&end, NULL);
+		printf("xml  %-8s %d nodes, %d lookups, %lu found, %.2f ms\r\n",
+			k ? "index:" : "walk:", (int) xml.get_xml()->node_cnt,
+			loop, (unsigned long) total,
+			util::stamp_sub(&end, &begin));
+	}
+
+	create_json(buf, count);
+	for (int k = 0; k < 2; k++)
+	{
+		acl::json json(buf.c_str());
+		json.use_index(k == 1);
+		size_t total = 0;
+
+		gettimeofday(&begin, NULL);
+		for (int i = 0; i < loop; i++)
+			total += json.getElementsByTagName(tags[i % 4]).size();
+		gettimeofday(&end, NULL);
+		printf("json %-8s %d nodes, %d lookups, %lu found, %.2f ms\r\n",
+			k ? "index:" : "walk:", (int) json.get_json()->node_cnt,
+			loop, (unsigned long) total,
+			util::stamp_sub(&end, &begin));
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help] -b [benchmark] -n count -l lookups\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 1000, loop = 1000;
+	bool  benchmark = false;
+
+	while ((ch = getopt(argc, argv, "hbn:l:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'b':
+			benchmark = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'l':
+			loop = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (benchmark)
+	{
+		bench(count, loop);
+		return 0;
+	}
+
+	test_xml();
+	test_json();
+
+	return util::check_result();
+}
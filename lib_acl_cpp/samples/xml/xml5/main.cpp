@@ -0,0 +1,302 @@
+#include "lib_acl.h"
+#include "acl_cpp/lib_acl.hpp"
+#include <getopt.h>
+#include <sys/time.h>
+#include "util.h"
+
+// ȫ(ȡ־λ)ڱȽϽ
+static void dump_node(ACL_XML_NODE* node, acl::string& out)
+{
+	out.format_append("[%d|%u|%s|%s|%s|%s", node->depth, node->flag,
+		acl_vstring_str(node->ltag), acl_vstring_str(node->rtag),
+		acl_vstring_str(node->text),
+		node->id ? acl_vstring_str(node->id) : "-");
+
+	ACL_ITER iter;
+	acl_foreach(iter, node->attr_list)
+	{
+		ACL_XML_ATTR* attr = (ACL_XML_ATTR*) iter.data;
+		out.format_append("|%s=%s", acl_vstring_str(attr->name),
+			acl_vstring_str(attr->value));
+	}
+
+	acl_foreach(iter, node)
+		dump_node((ACL_XML_NODE*) iter.data, out);
+	out += "]";
+}
+
+static void dump_xml(ACL_XML* xml, acl::string& out)
+{
+	out.clear();
+	out.format("%d/%d", xml->node_cnt, xml->depth);
+	dump_node(xml->root, out);
+}
+
+// ̶ȷֶ
+static void parse_split(ACL_XML* xml, const char* data, size_t step)
+{
+	size_t len = strlen(data);
+	acl::string buf;
+
+	for (size_t off = 0; off < len; off += step)
+	{
+		size_t n = len - off > step ? step : len - off;
+		buf.copy(data + off, n);
+		acl_xml_update(xml, buf.c_str());
+	}
+}
+
+static const char* __samples[] = {
+	"<?xml version=\"1.0\" encoding='gb2312'?>\r\n"
+	"<!DOCTYPE html>\r\n"
+	"<!-- a comment with <tags> and 'quotes' -->\r\n"
+	"<root>\r\n"
+	"  <server id=\"s1\" name='first one' weight = 10 >"
+	"127.0.0.1:6379</server>\r\n"
+	"  <server id=s2 path=\"C:\\\\redis\\tbin\" empty=\"\"/>\r\n"
+	"  <text>  hello  <b>bold</b> world &amp; more  </text>\r\n"
+	"  <br/><hr /><input type=text>\r\n"
+	"  <Upper>case</UPPER>\r\n"
+	"  <script>if (a < b && c > d) x = \"<p>\";</script>\r\n"
+	"  <mismatch>abc</other></mismatch>\r\n"
+	"  <attr a=\"x>y\" b='it''s' c=\"q\\\"q\"/>\r\n"
+	"</root>\r\n",
+
+	"<rss version=\"2.0\"><channel><title>feed</title>"
+	"<item><title>one</title><link>http://a/1?x=1&amp;y=2</link>"
+	"<description><![CDATA[<p>html</p>]]></description></item>"
+	"<item><title>two</title><link>http://a/2</link></item>"
+	"</channel></rss>",
+
+	"<a><b><c>deep</c></b><d/><e f=\"1\" g=\"2\">t</e></a>",
+
+	"   <x>\t\r\n</x>  <y  a = \"1\"  >  </y  >",
+
+	NULL,
+};
+
+static void make_doc(acl::string& buf, int count)
+{
+	buf = "<?xml version=\"1.0\"?>\r\n<feed>\r\n";
+	for (int i = 0; i < count; i++)
+	{
+		buf.format_append("  <item id=\"i%d\" type=\"news\" rank='%d'>\r\n"
+			"    <title>Item number %d with a reasonably long"
+			" title text</title>\r\n"
+			"    <link>http://www.example.com/feed/%d?a=1&amp;b=2"
+			"</link>\r\n"
+			"    <author name=\"user%d\" mail=\"user%d@example.com\"/>\r\n"
+			"    <summary>Lorem ipsum dolor sit amet, consectetur"
+			" adipiscing elit, sed do eiusmod tempor incididunt ut"
+			" labore et dolore magna aliqua.</summary>\r\n"
+			"  </item>\r\n", i, i % 10, i, i, i, i);
+	}
+	buf += "</feed>\r\n";
+}
+
+// ֶַηʽȫ
+static void parse_all(const char* data, acl::string& all)
+{
+	static const size_t steps[] = { 1, 2, 3, 7, 16, 33, 0 };
+	acl::string out;
+
+	for (int flag = 0; flag < 3; flag++)
+	{
+		ACL_XML* xml = acl_xml_alloc();
+		if (flag == 1)
+			acl_xml_slash(xml, 1);
+		else if (flag == 2)
+			xml->flag |= ACL_XML_FLAG_PART_WORD;
+
+		acl_xml_update(xml, data);
+		dump_xml(xml, out);
+		all << out << "\r\n";
+
+		for (int i = 0; steps[i] > 0; i++)
+		{
+			acl_xml_reset(xml);
+			parse_split(xml, data, steps[i]);
+			dump_xml(xml, out);
+			all << out << "\r\n";
+		}
+		acl_xml_free(xml);
+	}
+}
+
+static void parse_samples(acl::string& all)
+{
+	for (int i = 0; __samples[i]; i++)
+		parse_all(__samples[i], all);
+
+	acl::string doc;
+	make_doc(doc, 5);
+	parse_all(doc.c_str(), all);
+}
+
+static void test(const char* golden)
+{
+	// ʽ淶ηֶ룬Ӧͬ
+	acl::string doc, expect, result;
+	make_doc(doc, 50);
+
+	ACL_XML* xml = acl_xml_alloc();
+	acl_xml_update(xml, doc.c_str());
+	dump_xml(xml, expect);
+	for (size_t step = 1; step < 40; step++)
+	{
+		acl_xml_reset(xml);
+		parse_split(xml, doc.c_str(), step);
+		dump_xml(xml, result);
+		CHECK(result == expect);
+	}
+	acl_xml_free(xml);
+
+	// 򿪻㼰Զ󱻷ãҲӦͬ
+	ACL_XML* cached = acl_xml_alloc();
+	acl_xml_cache(cached, 64);
+	for (int n = 0; n < 3; n++)
+	{
+		for (int i = 0; __samples[i]; i++)
+		{
+			xml = acl_xml_alloc();
+			acl_xml_update(xml, __samples[i]);
+			dump_xml(xml, expect);
+			acl_xml_free(xml);
+
+			acl_xml_reset(cached);
+			acl_xml_update(cached, __samples[i]);
+			dump_xml(cached, result);
+			CHECK(result == expect);
+		}
+
+		acl_xml_reset(cached);
+		acl_xml_update(cached, doc.c_str());
+		dump_xml(cached, result);
+		CHECK(result.length() > 0);
+	}
+	acl_xml_free(cached);
+
+	// 뱣ĽȽϣgolden ļ -w 
+	if (golden == NULL)
+		return;
+
+	acl::string saved, all;
+	if (acl::ifstream::load(golden, &saved) == false)
+	{
+		util::check_failed(__FILE__, __LINE__,
+			"load %s error %s", golden, acl::last_serror());
+		return;
+	}
+
+	parse_samples(all);
+	CHECK(saved.length() == all.length());
+
+	acl::string line1, line2;
+	int   n = 0;
+	while (saved.scan_line(line1) && all.scan_line(line2))
+	{
+		n++;
+		if (line1 != line2)
+		{
+			util::check_failed(__FILE__, __LINE__,
+				"line %d differs:\r\n%s\r\n%s", n,
+				line1.c_str(), line2.c_str());
+		}
+		line1.clear();
+		line2.clear();
+	}
+}
+
+static void save(const char* filepath)
+{
+	acl::string all;
+	parse_samples(all);
+
+	acl::ofstream fp;
+	if (fp.open_trunc(filepath) == false || fp.write(all) == -1)
+		printf("write %s error %s\r\n", filepath, acl::last_serror());
+	else
+		printf("saved to %s\r\n", filepath);
+}
+
+static void bench(int count, int loop)
+{
+	acl::string doc;
+	make_doc(doc, count);
+
+	ACL_XML* xml = acl_xml_alloc();
+	acl_xml_cache(xml, count * 5 + 10);
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < loop; i++)
+	{
+		acl_xml_reset(xml);
+		acl_xml_update(xml, doc.c_str());
+	}
+	gettimeofday(&end, NULL);
+
+	double spent = util::stamp_sub(&end, &begin);
+	printf("parse %d bytes x %d, %d nodes, %.2f ms, %.2f MB/s\r\n",
+		(int) doc.length(), loop, xml->node_cnt, spent,
+		doc.length() * (double) loop / 1024 / 1024 / (spent / 1000));
+	acl_xml_free(xml);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help]\r\n"
+		" -g golden_file [compare with saved result]\r\n"
+		" -w golden_file [save parse result]\r\n"
+		" -b [benchmark] -n items -l loop\r\n", procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int   ch, count = 10000, loop = 10;
+	bool  benchmark = false;
+	acl::string golden, saved;
+
+	while ((ch = getopt(argc, argv, "hg:w:bn:l:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'g':
+			golden = optarg;
+			break;
+		case 'w':
+			saved = optarg;
+			break;
+		case 'b':
+			benchmark = true;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'l':
+			loop = atoi(optarg);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (!saved.empty())
+	{
+		save(saved.c_str());
+		return 0;
+	}
+
+	if (benchmark)
+	{
+		bench(count, loop);
+		return 0;
+	}
+
+	test(golden.empty() ? NULL : golden.c_str());
+
+	return util::check_result();
+}
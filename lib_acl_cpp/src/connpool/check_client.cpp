@@ -74,6 +74,12 @@ void check_client::close_callback()
 	// ڴ˴ĺôǱ֤˵ǰ϶ڹرչУͬʱ
 	//  timer_ ɾԼ timer_ мĸ
 	timer_.get_monitor().get_manager().set_pools_status(addr_, aliving_);
+
+	// ʱӳеĿӣӹڼ̵̳߳߳
+	// У߳
+	if (aliving_)
+		timer_.get_monitor().keep_conns(addr_);
+
 	timer_.remove_client(addr_, this);
 
 	delete this;
@@ -61,6 +61,9 @@ void check_timer::timer_callback(unsigned int id)
 	if (addrs_.empty())
 		logger_warn(">>>no addr been set!<<<");
 
+	// ӳеĿӽб̽
+	monitor_.on_timer();
+
 	// зַ
 
 	struct timeval begin;
@@ -1,7 +1,11 @@
 #include "acl_stdafx.hpp"
+#include <math.h>
+#include <algorithm>
 #include "acl_cpp/stdlib/string.hpp"
 #include "acl_cpp/stdlib/log.hpp"
 #include "acl_cpp/stdlib/locker.hpp"
+#include "acl_cpp/stdlib/md5.hpp"
+#include "acl_cpp/stdlib/snprintf.hpp"
 #include "acl_cpp/connpool/connect_monitor.hpp"
 #include "acl_cpp/connpool/connect_pool.hpp"
 #include "acl_cpp/connpool/connect_manager.hpp"
@@ -14,8 +18,25 @@ connect_manager::connect_manager()
 , service_idx_(0)
 , stat_inter_(1)
 , retry_inter_(1)
+, thread_cache_(0)
+, min_idle_(0)
+, balance_(CONNECT_BALANCE_ROUND_ROBIN)
+, max_failures_(5)
+, latency_factor_(3.0)
+, eject_time_(10)
+, recover_time_(30)
+, max_eject_percent_(50)
+, last_outlier_check_(0)
+, avg_latency_(0.0)
 , monitor_(NULL)
+, hash_type_(CONNECT_HASH_MOD)
+, vnodes_(160)
 {
+	// xorshift ״̬Ϊ 0
+	rand_ = (((unsigned long long) time(NULL)) << 32)
+		^ (unsigned long long) (size_t) this;
+	if (rand_ == 0)
+		rand_ = 1;
 }
 
 connect_manager::~connect_manager()
@@ -79,6 +100,55 @@ void connect_manager::set_retry_inter(int n)
 	lock_.unlock();
 }
 
+void connect_manager::set_thread_cache(size_t max)
+{
+	lock_.lock();
+
+	thread_cache_ = max;
+
+	std::vector<connect_pool*>::iterator it = pools_.begin();
+	for (; it != pools_.end(); ++it)
+		(*it)->set_thread_cache(thread_cache_);
+
+	lock_.unlock();
+}
+
+void connect_manager::set_min_idle(int n)
+{
+	lock_.lock();
+
+	min_idle_ = n;
+
+	std::vector<connect_pool*>::iterator it = pools_.begin();
+	for (; it != pools_.end(); ++it)
+		(*it)->set_min_idle(min_idle_);
+
+	lock_.unlock();
+}
+
+int connect_manager::prewarm(int n /* = 0 */)
+{
+	std::vector<std::pair<connect_pool*, int> > reserved;
+
+	// ԤԤʹӳ⽨ڼ䲻ᱻ
+	lock_.lock();
+	std::vector<connect_pool*>::iterator it = pools_.begin();
+	for (; it != pools_.end(); ++it)
+	{
+		int m = (*it)->reserve_idle(n);
+		if (m > 0)
+			reserved.push_back(std::make_pair(*it, m));
+	}
+	lock_.unlock();
+
+	int opened = 0;
+	std::vector<std::pair<connect_pool*, int> >::iterator cit;
+	for (cit = reserved.begin(); cit != reserved.end(); ++cit)
+		opened += cit->first->open_reserved(cit->second);
+
+	return opened;
+}
+
 void connect_manager::init(const char* default_addr,
 	const char* addr_list, int count)
 {
@@ -151,7 +221,12 @@ connect_pool& connect_manager::set(const char* addr, int count)
 
 	connect_pool* pool = create_pool(key, count, pools_.size() - 1);
 	pool->set_retry_inter(retry_inter_);
+	pool->set_thread_cache(thread_cache_);
+	pool->set_min_idle(min_idle_);
+	if (balance_ == CONNECT_BALANCE_P2C)
+		pool->set_track_load(true);
 	pools_.push_back(pool);
+	rebuild_hash();
 
 	lock_.unlock();
 
@@ -175,6 +250,7 @@ void connect_manager::remove(const char* addr)
 		{
 			(*it)->set_delay_destroy();
 			pools_.erase(it);
+			rebuild_hash();
 			break;
 		}
 	}
@@ -217,6 +293,13 @@ connect_pool* connect_manager::get(const char* addr,
 //////////////////////////////////////////////////////////////////////////
 
 connect_pool* connect_manager::peek()
+{
+	if (balance_ == CONNECT_BALANCE_P2C)
+		return peek_p2c();
+	return peek_round_robin();
+}
+
+connect_pool* connect_manager::peek_round_robin()
 {
 	connect_pool* pool;
 	size_t service_size, n;
@@ -249,6 +332,163 @@ connect_pool* connect_manager::peek()
 	return NULL;
 }
 
+void connect_manager::set_balance(connect_balance_t type)
+{
+	lock_.lock();
+
+	balance_ = type;
+	if (balance_ == CONNECT_BALANCE_P2C)
+	{
+		std::vector<connect_pool*>::iterator it = pools_.begin();
+		for (; it != pools_.end(); ++it)
+			(*it)->set_track_load(true);
+	}
+
+	lock_.unlock();
+}
+
+void connect_manager::set_outlier(int max_failures, double latency_factor,
+	int eject_time /* = 10 */, int recover_time /* = 30 */,
+	int max_percent /* = 50 */)
+{
+	lock_.lock();
+	max_failures_ = max_failures;
+	latency_factor_ = latency_factor;
+	eject_time_ = eject_time > 0 ? eject_time : 1;
+	recover_time_ = recover_time > 0 ? recover_time : 0;
+	max_eject_percent_ = max_percent;
+	lock_.unlock();
+}
+
+// ֣ӳٲķԸƽӳ;֮
+// 㣬ʹʱȱ̽⣬ֲһӿ𲽻ָе
+// ְŴԼֵõ
+static double load_score(connect_pool* pool, double ramp, double avg)
+{
+	double load = pool->get_load();
+	if (load <= 0.0)
+		load = pool->get_inflight() * (avg > 0.0 ? avg : 1.0);
+	return load / ramp;
+}
+
+connect_pool* connect_manager::peek_p2c()
+{
+	lock_.lock();
+
+	size_t service_size = pools_.size();
+	if (service_size == 0)
+	{
+		lock_.unlock();
+		logger_warn("pools's size is 0!");
+		return NULL;
+	}
+
+	time_t now = time(NULL);
+	if (now != last_outlier_check_)
+	{
+		last_outlier_check_ = now;
+		check_outliers(now);
+	}
+
+	// ѡȡõӳأȡֽϵ
+	connect_pool* best = NULL;
+	double best_score = 0.0;
+	int picked = 0;
+
+	for (size_t i = 0; i < service_size * 2 && picked < 2; i++)
+	{
+		rand_ ^= rand_ << 13;
+		rand_ ^= rand_ >> 7;
+		rand_ ^= rand_ << 17;
+
+		connect_pool* pool = pools_[(size_t) (rand_ % service_size)];
+		if (pool == best)
+			continue;
+
+		double ramp = pool->get_ramp(now);
+		if (ramp <= 0.0 || !pool->aliving())
+			continue;
+
+		double score = load_score(pool, ramp, avg_latency_);
+		if (best == NULL || score < best_score)
+		{
+			best = pool;
+			best_score = score;
+		}
+		picked++;
+	}
+
+	// ѡȡδʱӳ
+	for (size_t i = 0; best == NULL && i < service_size; i++)
+	{
+		connect_pool* pool = pools_[i];
+		double ramp = pool->get_ramp(now);
+		if (ramp > 0.0 && pool->aliving())
+			best = pool;
+	}
+
+	lock_.unlock();
+
+	// ӳؾժʱ˻صѭʽȫ񲻿
+	return best != NULL ? best : peek_round_robin();
+}
+
+void connect_manager::check_outliers(time_t now)
+{
+	std::vector<double> latencies;
+	size_t ejected = 0;
+	double total = 0.0;
+
+	std::vector<connect_pool*>::iterator it = pools_.begin();
+	for (; it != pools_.end(); ++it)
+	{
+		if ((*it)->get_ramp(now) <= 0.0)
+			ejected++;
+		else if ((*it)->get_load() > 0.0)
+		{
+			latencies.push_back((*it)->get_latency());
+			total += (*it)->get_latency();
+		}
+	}
+
+	avg_latency_ = latencies.empty() ? 0.0 : total / latencies.size();
+
+	double median = 0.0;
+	if (latencies.size() >= 3)
+	{
+		std::nth_element(latencies.begin(), latencies.begin()
+			+ latencies.size() / 2, latencies.end());
+		median = latencies[latencies.size() / 2];
+	}
+
+	size_t max_ejected = pools_.size() * max_eject_percent_ / 100;
+
+	for (it = pools_.begin(); it != pools_.end(); ++it)
+	{
+		if (ejected >= max_ejected)
+			break;
+
+		connect_pool* pool = *it;
+		if (pool->get_ramp(now) <= 0.0)
+			continue;
+
+		bool bad = max_failures_ > 0
+			&& pool->get_failures() >= max_failures_;
+		if (!bad && latency_factor_ > 0.0 && median > 0.0
+			&& pool->get_load() > 0.0
+			&& pool->get_latency() > median * latency_factor_)
+		{
+			bad = true;
+		}
+
+		if (bad)
+		{
+			pool->eject(now, eject_time_, recover_time_);
+			ejected++;
+		}
+	}
+}
+
 connect_pool* connect_manager::peek(const char* key,
 	bool exclusive /* = true */)
 {
@@ -257,7 +497,6 @@ connect_pool* connect_manager::peek(const char* key,
 
 	size_t service_size;
 	connect_pool* pool;
-	unsigned n = acl_hash_crc32(key, strlen(key));
 
 	if (exclusive)
 		lock_.lock();
@@ -269,13 +508,216 @@ connect_pool* connect_manager::peek(const char* key,
 		logger_warn("pools's size is 0!");
 		return NULL;
 	}
-	pool = pools_[n % service_size];
+
+	switch (hash_type_)
+	{
+	case CONNECT_HASH_KETAMA:
+		pool = peek_ketama(key);
+		break;
+	case CONNECT_HASH_JUMP:
+		pool = peek_jump(key);
+		break;
+	case CONNECT_HASH_RENDEZVOUS:
+		pool = peek_rendezvous(key);
+		break;
+	case CONNECT_HASH_MOD:
+	default:
+		pool = pools_[acl_hash_crc32(key, strlen(key)) % service_size];
+		break;
+	}
+
 	if (exclusive)
 		lock_.unlock();
 
 	return pool;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+void connect_manager::set_key_hash(connect_hash_t type, int vnodes /* = 160 */)
+{
+	lock_.lock();
+	hash_type_ = type;
+	vnodes_ = vnodes > 0 ? vnodes : 160;
+	rebuild_hash();
+	lock_.unlock();
+}
+
+void connect_manager::set_weight(const char* addr, unsigned weight)
+{
+	string key(addr);
+	key.lower();
+
+	lock_.lock();
+	weights_[key] = weight > 0 ? weight : 1;
+	rebuild_hash();
+	lock_.unlock();
+}
+
+unsigned connect_manager::get_weight(const char* addr) const
+{
+	// ӳصĵַ set ʱѱתΪСд
+	std::map<string, unsigned>::const_iterator cit = weights_.find(addr);
+	return cit == weights_.end() ? 1 : cit->second;
+}
+
+// splitmix64 ĻϺʹ crc64 Թϣֵĸλɢ
+static unsigned long long hash_mix(unsigned long long x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+static unsigned long long hash_key(const char* key)
+{
+	return hash_mix(acl_hash_crc64(key, strlen(key)));
+}
+
+// ketama ʽȡ md5 д off ʼ 4 ֽΪϣϵĵ
+static unsigned ketama_point(const unsigned char* digest, int off)
+{
+	return ((unsigned) digest[off + 3] << 24)
+		| ((unsigned) digest[off + 2] << 16)
+		| ((unsigned) digest[off + 1] << 8)
+		| (unsigned) digest[off];
+}
+
+void connect_manager::rebuild_hash()
+{
+	ring_.clear();
+	nodes_.clear();
+
+	if (hash_type_ == CONNECT_HASH_KETAMA)
+	{
+		unsigned char digest[16];
+		char buf[300];
+
+		std::vector<connect_pool*>::const_iterator cit = pools_.begin();
+		for (; cit != pools_.end(); ++cit)
+		{
+			const char* addr = (*cit)->get_addr();
+
+			// ÿ md5  4 㣬Ȩس
+			int count = (int) ((vnodes_ * get_weight(addr) + 3) / 4);
+			for (int i = 0; i < count; i++)
+			{
+				int n = safe_snprintf(buf, sizeof(buf),
+					"%s-%d", addr, i);
+				md5::md5_digest(buf, n, NULL, 0,
+					digest, sizeof(digest));
+				for (int j = 0; j < 4; j++)
+					ring_.push_back(std::make_pair(
+						ketama_point(digest, j * 4), *cit));
+			}
+		}
+		std::sort(ring_.begin(), ring_.end());
+	}
+	else if (hash_type_ == CONNECT_HASH_RENDEZVOUS)
+	{
+		std::vector<connect_pool*>::const_iterator cit = pools_.begin();
+		for (; cit != pools_.end(); ++cit)
+		{
+			const char* addr = (*cit)->get_addr();
+			nodes_.push_back(std::make_pair(hash_key(addr),
+				get_weight(addr)));
+		}
+	}
+}
+
+connect_pool* connect_manager::peek_ketama(const char* key) const
+{
+	unsigned char digest[16];
+	md5::md5_digest(key, strlen(key), NULL, 0, digest, sizeof(digest));
+	unsigned point = ketama_point(digest, 0);
+
+	// Ӽֵλ˳ʱҵһӳصĽ
+	std::vector<std::pair<unsigned, connect_pool*> >::const_iterator it =
+		std::lower_bound(ring_.begin(), ring_.end(),
+			std::make_pair(point, (connect_pool*) NULL));
+	if (it == ring_.end())
+		it = ring_.begin();
+
+	connect_pool* first = it->second;
+	for (size_t i = 0; i < ring_.size(); i++)
+	{
+		if (it->second->aliving())
+			return it->second;
+		if (++it == ring_.end())
+			it = ring_.begin();
+	}
+
+	// ӳؾʱԭʼӳ
+	return first;
+}
+
+// Lamping & Veach  jump һԹϣ
+static size_t jump_hash(unsigned long long key, size_t buckets)
+{
+	long long b = -1, j = 0;
+	while (j < (long long) buckets)
+	{
+		b = j;
+		key = key * 2862933555777941757ULL + 1;
+		j = (long long) ((b + 1) * ((double) (1LL << 31)
+			/ (double) ((key >> 33) + 1)));
+	}
+	return (size_t) b;
+}
+
+connect_pool* connect_manager::peek_jump(const char* key) const
+{
+	unsigned long long h = hash_key(key);
+	size_t n = pools_.size();
+	connect_pool* first = pools_[jump_hash(h, n)];
+
+	if (first->aliving())
+		return first;
+
+	// ԭʼӳزʱԱ任Ĺϣֵ¶λӶʹӳص
+	// ֵɢӳأֵӳϵӰ
+	for (size_t i = 1; i < n * 2; i++)
+	{
+		connect_pool* pool = pools_[jump_hash(hash_mix(h + i), n)];
+		if (pool->aliving())
+			return pool;
+	}
+
+	return first;
+}
+
+connect_pool* connect_manager::peek_rendezvous(const char* key) const
+{
+	unsigned long long h = hash_key(key);
+	connect_pool* first = NULL, *best = NULL;
+	double first_score = 0.0, best_score = 0.0;
+
+	// ȨصȨعϣscore = -weight / ln(u)u Ϊ (0, 1)
+	// ɼֵͬľȷֲ
+	for (size_t i = 0; i < pools_.size(); i++)
+	{
+		unsigned long long x = hash_mix(h ^ nodes_[i].first);
+		double u = ((double) (x >> 11) + 0.5) / 9007199254740992.0;
+		double score = -(double) nodes_[i].second / ::log(u);
+
+		if (first == NULL || score > first_score)
+		{
+			first = pools_[i];
+			first_score = score;
+		}
+		if ((best == NULL || score > best_score) && pools_[i]->aliving())
+		{
+			best = pools_[i];
+			best_score = score;
+		}
+	}
+
+	return best ? best : first;
+}
+
 void connect_manager::lock()
 {
 	lock_.lock();
@@ -291,9 +733,16 @@ void connect_manager::statistics()
 	std::vector<connect_pool*>::const_iterator cit = pools_.begin();
 	for (; cit != pools_.end(); ++cit)
 	{
-		logger("server: %s, total: %llu, curr: %llu",
+		logger("server: %s, total: %llu, curr: %llu, idle: %d, "
+			"lock: %llu, contended: %llu, wait: %llu us, "
+			"cache hits: %llu, inflight: %d, latency: %.3f ms%s",
 			(*cit)->get_addr(), (*cit)->get_total_used(),
-			(*cit)->get_current_used());
+			(*cit)->get_current_used(),
+			(int) (*cit)->get_idle_count(), (*cit)->get_lock_count(),
+			(*cit)->get_lock_contended(), (*cit)->get_lock_wait(),
+			(*cit)->get_cache_hits(), (*cit)->get_inflight(),
+			(*cit)->get_latency(),
+			(*cit)->is_ejected() ? ", ejected" : "");
 		(*cit)->reset_statistics(stat_inter_);
 	}
 }
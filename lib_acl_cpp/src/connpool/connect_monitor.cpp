@@ -2,12 +2,15 @@
 #include <map>
 #include "acl_cpp/stdlib/log.hpp"
 #include "acl_cpp/stdlib/util.hpp"
+#include "acl_cpp/stdlib/thread_pool.hpp"
 #include "acl_cpp/ipc/rpc.hpp"
 #include "acl_cpp/connpool/connect_manager.hpp"
 #include "acl_cpp/connpool/connect_monitor.hpp"
+#include "acl_cpp/connpool/connect_pool.hpp"
 #include "acl_cpp/connpool/check_client.hpp"
 #include "check_timer.hpp"
 #include "check_rpc.hpp"
+#include "keep_job.hpp"
 
 namespace acl
 {
@@ -20,6 +23,10 @@ connect_monitor::connect_monitor(connect_manager& manager)
 , check_inter_(1)
 , conn_timeout_(10)
 , rpc_service_(NULL)
+, threads_(NULL)
+, keep_threads_(10)
+, keepalive_inter_(0)
+, last_keepalive_(0)
 {
 }
 
@@ -52,6 +59,18 @@ connect_monitor& connect_monitor::set_conn_timeout(int n)
 	return *this;
 }
 
+connect_monitor& connect_monitor::set_keep_threads(int n)
+{
+	keep_threads_ = n > 0 ? n : 1;
+	return *this;
+}
+
+connect_monitor& connect_monitor::set_keepalive_inter(int n)
+{
+	keepalive_inter_ = n > 0 ? n : 0;
+	return *this;
+}
+
 void connect_monitor::stop(bool graceful)
 {
 	stop_ = true;
@@ -60,6 +79,12 @@ void connect_monitor::stop(bool graceful)
 
 void* connect_monitor::run()
 {
+	// ֮⽨Ӽб̳̽߳
+	threads_ = NEW thread_pool;
+	threads_->set_limit(keep_threads_);
+	threads_->set_idle(60);
+	threads_->start();
+
 	// ״̬ʱ
 	check_timer timer(*this, handle_, conn_timeout_);
 
@@ -76,6 +101,12 @@ void* connect_monitor::run()
 	//  rpc_service_ ǿɾ֮
 	delete rpc_service_;
 
+	// ̳߳еŸӳأȫ
+	threads_->wait();
+	threads_->stop();
+	delete threads_;
+	threads_ = NULL;
+
 	// ټһΣԾͷſܴڵ첽
 	handle_.check();
 
@@ -101,6 +132,68 @@ void connect_monitor::on_open(check_client& checker)
 	}
 }
 
+void connect_monitor::keep_conns(const char* addr)
+{
+	std::vector<std::pair<connect_pool*, int> > reserved;
+
+	// ԤԤʹӳǰᱻ
+	manager_.lock();
+	const std::vector<connect_pool*>& pools = manager_.get_pools();
+	std::vector<connect_pool*>::const_iterator cit = pools.begin();
+	for (; cit != pools.end(); ++cit)
+	{
+		if ((*cit)->get_min_idle() <= 0
+			|| strcasecmp((*cit)->get_addr(), addr) != 0)
+		{
+			continue;
+		}
+
+		int n = (*cit)->reserve_idle(0);
+		if (n > 0)
+			reserved.push_back(std::make_pair(*cit, n));
+	}
+	manager_.unlock();
+
+	// ÿһӣӶ̳߳زн
+	std::vector<std::pair<connect_pool*, int> >::iterator it;
+	for (it = reserved.begin(); it != reserved.end(); ++it)
+	{
+		for (int i = 0; i < it->second; i++)
+			threads_->run(NEW keep_job(*it->first));
+	}
+}
+
+void connect_monitor::on_timer()
+{
+	if (keepalive_inter_ <= 0)
+		return;
+
+	time_t now = time(NULL);
+	if (now - last_keepalive_ < keepalive_inter_)
+		return;
+	last_keepalive_ = now;
+
+	std::vector<connect_pool*> probes;
+
+	manager_.lock();
+	const std::vector<connect_pool*>& pools = manager_.get_pools();
+	std::vector<connect_pool*>::const_iterator cit = pools.begin();
+	for (; cit != pools.end(); ++cit)
+	{
+		if ((*cit)->get_idle_count() == 0)
+			continue;
+
+		// ӳأǰ
+		(*cit)->refer();
+		probes.push_back(*cit);
+	}
+	manager_.unlock();
+
+	std::vector<connect_pool*>::iterator it = probes.begin();
+	for (; it != probes.end(); ++it)
+		threads_->run(NEW keep_job(**it, keepalive_inter_));
+}
+
 void connect_monitor::nio_check(check_client& checker, aio_socket_stream&)
 {
 	// ״̬Ǵ
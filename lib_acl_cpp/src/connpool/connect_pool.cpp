@@ -7,6 +7,137 @@
 namespace acl
 {
 
+// ̻߳ÿۻֵźϲӳصͳֵԼٶӳؼ
+#define CACHE_FOLD	64
+
+// ӳƶƽֵ²ռȨ
+#define EWMA_ALPHA	0.2
+
+// ʱ()ûвĽ㣬ӳٱΪδ֪Ա̽
+#define SAMPLE_TTL	5
+
+// ӳٲĽʧʱĳʼӳ()
+#define FAIL_LATENCY	1.0
+
+// 𲽻ָڼռ
+#define RAMP_MIN	0.1
+
+//////////////////////////////////////////////////////////////////////////
+
+// ÿ߳˽еĿӻ棻ӳص caches_ ¼˻ӵ̣߳
+// Աӳ١ӹڻӺľʱлӣ
+// ˳Ϊ__caches_lock -> conn_cache::lock_ -> connect_pool::lock_
+class conn_cache
+{
+public:
+	conn_cache() {}
+	~conn_cache() {}
+
+	locker lock_;
+	std::vector<connect_pool*> pools_;	// ѵǼǵӳ
+	std::vector<unsigned> hits_;		// ӳδϲ
+	std::vector<connect_client*> conns_;	// Ŀ
+
+	int find(const connect_pool* pool) const
+	{
+		for (size_t i = 0; i < pools_.size(); i++)
+		{
+			if (pools_[i] == pool)
+				return (int) i;
+		}
+		return -1;
+	}
+
+	// ĳӳصϲӳأ lock_
+	void fold(size_t i)
+	{
+		if (hits_[i] == 0)
+			return;
+		connect_pool* pool = pools_[i];
+		pool->lock_.lock();
+		pool->total_used_ += hits_[i];
+		pool->current_used_ += hits_[i];
+		pool->cache_hits_ += hits_[i];
+		pool->lock_.unlock();
+		hits_[i] = 0;
+	}
+
+	// ߳˳ʱӹ黹Եӳ
+	void release();
+};
+
+// ̻߳ӳ֮ĵǼǹϵֻڵǼǡռ߳˳ʱʹ
+static locker* __caches_lock = NULL;
+static acl_pthread_key_t __cache_key;
+static acl_pthread_once_t __cache_once = ACL_PTHREAD_ONCE_INIT;
+
+static void cache_free(void* ctx)
+{
+	conn_cache* cache = (conn_cache*) ctx;
+	cache->release();
+	delete cache;
+}
+
+static void cache_init(void)
+{
+	__caches_lock = NEW locker;
+	acl_pthread_key_create(&__cache_key, cache_free);
+}
+
+static conn_cache* get_cache(bool create)
+{
+	acl_pthread_once(&__cache_once, cache_init);
+
+	conn_cache* cache = (conn_cache*) acl_pthread_getspecific(__cache_key);
+	if (cache == NULL && create)
+	{
+		cache = NEW conn_cache;
+		acl_pthread_setspecific(__cache_key, cache);
+	}
+	return cache;
+}
+
+void conn_cache::release()
+{
+	__caches_lock->lock();
+
+	lock_.lock();
+	for (size_t i = 0; i < pools_.size(); i++)
+	{
+		fold(i);
+
+		connect_pool* pool = pools_[i];
+		pool->lock_.lock();
+		std::vector<conn_cache*>::iterator it = pool->caches_.begin();
+		for (; it != pool->caches_.end(); ++it)
+		{
+			if (*it == this)
+			{
+				pool->caches_.erase(it);
+				break;
+			}
+		}
+		pool->lock_.unlock();
+	}
+	pools_.clear();
+	hits_.clear();
+
+	std::vector<connect_client*> conns;
+	conns.swap(conns_);
+	lock_.unlock();
+
+	//  __caches_lock ڼӳزᱻ٣Ϊӳص
+	// set_delay_destroy Ȼȡ __caches_lock Ǽ
+	time_t now = time(NULL);
+	std::vector<connect_client*>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+		(void) (*it)->get_pool()->put_shared(*it, true, now);
+
+	__caches_lock->unlock();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 connect_pool::connect_pool(const char* addr, int max, size_t idx /* = 0 */)
 : alive_(true)
 , delay_destroy_(false)
@@ -20,6 +151,25 @@ connect_pool::connect_pool(const char* addr, int max, size_t idx /* = 0 */)
 , total_used_(0)
 , current_used_(0)
 , last_(0)
+, idle_(NULL)
+, idle_count_(0)
+, cache_max_(0)
+, lock_count_(0)
+, lock_contended_(0)
+, lock_wait_(0)
+, cache_hits_(0)
+, track_load_(false)
+, inflight_(0)
+, latency_(0.0)
+, last_sample_(0)
+, failures_(0)
+, ejections_(0)
+, ejected_until_(0)
+, recover_until_(0)
+, min_idle_(0)
+, warming_(0)
+, refers_(0)
+, confirmed_(false)
 {
 	retry_inter_ = 1;
 
@@ -31,9 +181,19 @@ connect_pool::connect_pool(const char* addr, int max, size_t idx /* = 0 */)
 
 connect_pool::~connect_pool()
 {
-	std::list<connect_client*>::iterator it = pool_.begin();
-	for (; it != pool_.end(); ++it)
+	std::vector<connect_client*> conns;
+	drain_caches(conns, -1, conns.max_size(), true);
+
+	std::vector<connect_client*>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
 		delete *it;
+
+	while (idle_ != NULL)
+	{
+		connect_client* conn = idle_;
+		idle_ = conn->next_;
+		delete conn;
+	}
 }
 
 connect_pool& connect_pool::set_idle_ttl(time_t ttl)
@@ -51,6 +211,24 @@ connect_pool& connect_pool::set_retry_inter(int retry_inter)
 	return *this;
 }
 
+connect_pool& connect_pool::set_thread_cache(size_t max)
+{
+	cache_max_ = max;
+	return *this;
+}
+
+connect_pool& connect_pool::set_track_load(bool on)
+{
+	track_load_ = on;
+	return *this;
+}
+
+connect_pool& connect_pool::set_min_idle(int n)
+{
+	min_idle_ = n > 0 ? n : 0;
+	return *this;
+}
+
 bool connect_pool::aliving()
 {
 	// XXXȻ˴δҲӦò⣬Ϊ peek() ̻ٴ
@@ -75,9 +253,42 @@ bool connect_pool::aliving()
 	return false;
 }
 
-connect_client* connect_pool::peek()
+void connect_pool::lock_pool()
 {
+	if (lock_.try_lock())
+	{
+		lock_count_++;
+		return;
+	}
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
 	lock_.lock();
+	gettimeofday(&end, NULL);
+
+	lock_count_++;
+	lock_contended_++;
+	lock_wait_ += (end.tv_sec - begin.tv_sec) * 1000000
+		+ (end.tv_usec - begin.tv_usec);
+}
+
+connect_client* connect_pool::peek()
+{
+	connect_client* conn = peek_one();
+	if (conn != NULL && track_load_)
+		request_begin(conn);
+	return conn;
+}
+
+connect_client* connect_pool::peek_one()
+{
+	connect_client* conn;
+
+	// ȴӱ̻߳Ŀлȡӳؼ
+	if (cache_max_ > 0 && alive_ && (conn = peek_cached()) != NULL)
+		return conn;
+
+	lock_pool();
 	if (alive_ == false)
 	{
 		time_t now = time(NULL);
@@ -92,13 +303,12 @@ connect_client* connect_pool::peek()
 		logger("reset server: %s", get_addr());
 	}
 
-	connect_client* conn;
-
-	std::list<connect_client*>::iterator it = pool_.begin();
-	if (it != pool_.end())
+	if (idle_ != NULL)
 	{
-		conn = *it;
-		pool_.erase(it);
+		conn = idle_;
+		idle_ = conn->next_;
+		conn->next_ = NULL;
+		idle_count_--;
 		total_used_++;
 		current_used_++;
 		lock_.unlock();
@@ -106,32 +316,79 @@ connect_client* connect_pool::peek()
 	}
 	else if (count_ >= max_)
 	{
-		logger_error("too many connections, max: %d, curr: %d,"
-			" server: %s", count_, max_, addr_);
 		lock_.unlock();
+
+		// Ѵʱ̻߳Ŀ
+		std::vector<connect_client*> conns;
+		if (cache_max_ > 0)
+			drain_caches(conns, -1, 1, false);
+		if (!conns.empty())
+		{
+			lock_.lock();
+			total_used_++;
+			current_used_++;
+			lock_.unlock();
+			return conns[0];
+		}
+
+		logger_error("too many connections, max: %d, curr: %d,"
+			" server: %s", max_, count_, addr_);
 		return NULL;
 	}
 
+	// ռ⽨ӣӹ߳
+	count_++;
+	bool probe = !confirmed_;
+	lock_.unlock();
+
+	// ʧʱδȷϷ˿ãʱֻһ߳̽ӣ
+	// ̵߳ȴ˲ʱÿ̶߳ȴӳʱ
+	if (probe)
+	{
+		connect_lock_.lock();
+
+		lock_.lock();
+		bool alive = alive_;
+		probe = !confirmed_;
+		if (!alive)
+			count_--;
+		lock_.unlock();
+
+		if (!alive || !probe)
+			connect_lock_.unlock();
+		if (!alive)
+			return NULL;
+	}
+
 	conn = create_connect();
-	if (conn->open() == false)
+	bool ok = conn->open();
+
+	lock_.lock();
+	if (ok)
 	{
-		delete conn;
+		confirmed_ = true;
+		total_used_++;
+		current_used_++;
+	}
+	else
+	{
+		count_--;
 		alive_ = false;
-		time(&last_dead_);
+		confirmed_ = false;
 		(void) time(&last_dead_);
-		lock_.unlock();
-		return NULL;
 	}
+	lock_.unlock();
 
-	count_++;
-
-	total_used_++;
-	current_used_++;
+	if (probe)
+		connect_lock_.unlock();
 
-	lock_.unlock();
+	if (!ok)
+	{
+		delete conn;
+		return NULL;
+	}
 
 	conn->set_pool(this);
-
 	return conn;
 }
 
@@ -139,7 +396,28 @@ void connect_pool::put(connect_client* conn, bool keep /* = true */)
 {
 	time_t now = time(NULL);
 
-	lock_.lock();
+	if (conn->begin_ > 0)
+		request_end(conn, keep);
+
+	// ȷ뱾̵߳ĻУӳؼ
+	if (keep && cache_max_ > 0 && alive_ && !delay_destroy_
+		&& put_cached(conn, now))
+	{
+		if (idle_ttl_ >= 0 && now - last_check_ >= check_inter_)
+			check_idle_timer(now);
+		return;
+	}
+
+	if (put_shared(conn, keep, now)
+		&& idle_ttl_ >= 0 && now - last_check_ >= check_inter_)
+	{
+		check_idle_timer(now);
+	}
+}
+
+bool connect_pool::put_shared(connect_client* conn, bool keep, time_t now)
+{
+	lock_pool();
 
 	// Ƿٱ־λ
 	if (delay_destroy_)
@@ -147,24 +425,27 @@ void connect_pool::put(connect_client* conn, bool keep /* = true */)
 		delete conn;
 		count_--;
 
-		if (count_ <= 0)
+		if (count_ <= 0 && refers_ <= 0)
 		{
 			// üΪ 0 
 			lock_.unlock();
 			delete this;
+			return false;
 		}
 		else
 			lock_.unlock();
-		return;
+		return true;
 	}
 
 	if (keep && alive_)
 	{
 		conn->set_when(now);
 
-		// 黹ӷײڵͷŹ
-		// ʱȽϷ㣬ھ콫æݿӹر
-		pool_.push_front(conn);
+		// 黹ѹջջ׼Ϊδʹõӣ
+		// ھ콫æӹر
+		conn->next_ = idle_;
+		idle_ = conn;
+		idle_count_++;
 	}
 	else
 	{
@@ -173,25 +454,335 @@ void connect_pool::put(connect_client* conn, bool keep /* = true */)
 		acl_assert(count_ >= 0);
 	}
 
-	if (idle_ttl_ >= 0 && now - last_check_ >= check_inter_)
+	lock_.unlock();
+	return true;
+}
+
+void connect_pool::check_idle_timer(time_t now)
+{
+	lock_.lock();
+	if (now - last_check_ < check_inter_)
 	{
-		(void) check_idle(idle_ttl_, false);
-		(void) time(&last_check_);
+		lock_.unlock();
+		return;
 	}
+	last_check_ = now;
 	lock_.unlock();
+
+	(void) check_idle(idle_ttl_);
+}
+
+connect_client* connect_pool::peek_cached()
+{
+	conn_cache* cache = get_cache(false);
+	if (cache == NULL)
+		return NULL;
+
+	connect_client* conn = NULL;
+
+	cache->lock_.lock();
+
+	// ȱʹ
+	for (size_t i = cache->conns_.size(); i > 0; i--)
+	{
+		if (cache->conns_[i - 1]->get_pool() == this)
+		{
+			conn = cache->conns_[i - 1];
+			cache->conns_.erase(cache->conns_.begin() + (i - 1));
+			break;
+		}
+	}
+
+	if (conn != NULL)
+	{
+		int i = cache->find(this);
+		if (i >= 0 && ++cache->hits_[i] >= CACHE_FOLD)
+			cache->fold((size_t) i);
+	}
+
+	cache->lock_.unlock();
+	return conn;
+}
+
+bool connect_pool::put_cached(connect_client* conn, time_t now)
+{
+	conn_cache* cache = get_cache(true);
+
+	cache->lock_.lock();
+	if (cache->find(this) < 0)
+	{
+		cache->lock_.unlock();
+		if (attach_cache(cache) == false)
+			return false;
+		cache->lock_.lock();
+
+		// ǼǺѱ drain_caches 
+		if (cache->find(this) < 0)
+		{
+			cache->lock_.unlock();
+			return false;
+		}
+	}
+
+	size_t n = 0;
+	std::vector<connect_client*>::const_iterator cit;
+	for (cit = cache->conns_.begin(); cit != cache->conns_.end(); ++cit)
+	{
+		if ((*cit)->get_pool() == this)
+			n++;
+	}
+
+	if (n >= cache_max_)
+	{
+		cache->lock_.unlock();
+		return false;
+	}
+
+	conn->set_when(now);
+	cache->conns_.push_back(conn);
+	cache->lock_.unlock();
+	return true;
+}
+
+bool connect_pool::attach_cache(conn_cache* cache)
+{
+	__caches_lock->lock();
+
+	lock_.lock();
+	if (delay_destroy_)
+	{
+		lock_.unlock();
+		__caches_lock->unlock();
+		return false;
+	}
+	caches_.push_back(cache);
+	lock_.unlock();
+
+	cache->lock_.lock();
+	cache->pools_.push_back(this);
+	cache->hits_.push_back(0);
+	cache->lock_.unlock();
+
+	__caches_lock->unlock();
+	return true;
+}
+
+void connect_pool::drain_caches(std::vector<connect_client*>& out,
+	time_t ttl, size_t max, bool detach)
+{
+	// û̻߳汾ӳصʱȡȫǼʱ(ӳ
+	// ٻɾ)ȡȫԵȴ˳߳̽ӹ黹
+	if (!detach)
+	{
+		lock_.lock();
+		bool empty = caches_.empty();
+		lock_.unlock();
+
+		if (empty)
+			return;
+	}
+	else
+		acl_pthread_once(&__cache_once, cache_init);
+
+	time_t now = time(NULL);
+
+	__caches_lock->lock();
+
+	lock_.lock();
+	std::vector<conn_cache*> caches(caches_);
+	if (detach)
+		caches_.clear();
+	lock_.unlock();
+
+	std::vector<conn_cache*>::iterator it = caches.begin();
+	for (; it != caches.end(); ++it)
+	{
+		conn_cache* cache = *it;
+		cache->lock_.lock();
+
+		std::vector<connect_client*>::iterator cit =
+			cache->conns_.begin();
+		while (cit != cache->conns_.end() && out.size() < max)
+		{
+			connect_client* conn = *cit;
+			if (conn->get_pool() == this
+				&& (ttl < 0 || now - conn->get_when() >= ttl))
+			{
+				out.push_back(conn);
+				cit = cache->conns_.erase(cit);
+			}
+			else
+				++cit;
+		}
+
+		int i = cache->find(this);
+		if (detach && i >= 0)
+		{
+			cache->fold((size_t) i);
+			cache->pools_.erase(cache->pools_.begin() + i);
+			cache->hits_.erase(cache->hits_.begin() + i);
+		}
+
+		cache->lock_.unlock();
+
+		if (out.size() >= max && !detach)
+			break;
+	}
+
+	__caches_lock->unlock();
+}
+
+static long long stamp_now(void)
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (long long) now.tv_sec * 1000000 + now.tv_usec;
+}
+
+void connect_pool::request_begin(connect_client* conn)
+{
+	conn->begin_ = stamp_now();
+
+	stat_lock_.lock();
+	inflight_++;
+	stat_lock_.unlock();
+}
+
+void connect_pool::request_end(connect_client* conn, bool ok)
+{
+	double cost = (stamp_now() - conn->begin_) / 1000.0;
+	conn->begin_ = 0;
+
+	stat_lock_.lock();
+	if (inflight_ > 0)
+		inflight_--;
+
+	if (ok)
+	{
+		failures_ = 0;
+		if (latency_ <= 0.0)
+			latency_ = cost;
+		else
+			latency_ = latency_ * (1 - EWMA_ALPHA) + cost * EWMA_ALPHA;
+	}
+	else
+	{
+		// ʧܵٳʱ̣ܶʱӳ٣
+		// ǽӳټӱ쳣ӳٿƺܵͶ
+		failures_++;
+		if (latency_ <= 0.0)
+			latency_ = cost > FAIL_LATENCY ? cost : FAIL_LATENCY;
+		else
+			latency_ *= 2;
+	}
+	last_sample_ = time(NULL);
+	stat_lock_.unlock();
+}
+
+double connect_pool::get_load()
+{
+	stat_lock_.lock();
+	double load;
+	if (time(NULL) - last_sample_ >= SAMPLE_TTL)
+		load = 0.0;
+	else
+		load = latency_ * (inflight_ + 1);
+	stat_lock_.unlock();
+	return load;
+}
+
+void connect_pool::eject(time_t now, int eject_time, int recover_time)
+{
+	stat_lock_.lock();
+
+	// ժĴԽ࣬ժʱԽ
+	if (ejections_ < 8)
+		ejections_++;
+	ejected_until_ = now + eject_time * ejections_;
+	recover_until_ = ejected_until_ + recover_time;
+
+	// ָ²ӳ٣ʱĸӳʹһֱò
+	failures_ = 0;
+	latency_ = 0.0;
+	last_sample_ = 0;
+
+	stat_lock_.unlock();
+
+	logger_warn("eject server: %s for %d seconds", addr_,
+		(int) (ejected_until_ - now));
+}
+
+double connect_pool::get_ramp(time_t now)
+{
+	stat_lock_.lock();
+
+	double ramp;
+	if (ejected_until_ == 0)
+		ramp = 1.0;
+	else if (now < ejected_until_)
+		ramp = 0.0;
+	else if (now >= recover_until_)
+	{
+		// ȫָժ¼²ӳ٣𲽻ָڼ
+		// ĲֵʹòӦе
+		ejected_until_ = recover_until_ = 0;
+		ejections_ = 0;
+		latency_ = 0.0;
+		last_sample_ = 0;
+		ramp = 1.0;
+	}
+	else
+	{
+		ramp = (double) (now - ejected_until_)
+			/ (double) (recover_until_ - ejected_until_);
+		if (ramp < RAMP_MIN)
+			ramp = RAMP_MIN;
+	}
+
+	stat_lock_.unlock();
+	return ramp;
 }
 
 void connect_pool::set_delay_destroy()
 {
+	std::vector<connect_client*> conns;
+
+	// ջеӲٱȡãڴ˴ͷ
 	lock_.lock();
 	delay_destroy_ = true;
+	while (idle_ != NULL)
+	{
+		conns.push_back(idle_);
+		idle_ = idle_->next_;
+	}
+	idle_count_ = 0;
 	lock_.unlock();
+
+	// ̻߳еӲٱ黹ڴ˴ͷ
+	drain_caches(conns, -1, conns.max_size(), true);
+	if (conns.empty())
+		return;
+
+	std::vector<connect_client*>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+		delete *it;
+
+	lock_.lock();
+	count_ -= (int) conns.size();
+	if (count_ <= 0 && refers_ <= 0)
+	{
+		lock_.unlock();
+		delete this;
+	}
+	else
+		lock_.unlock();
 }
 
 void connect_pool::set_alive(bool ok /* true | false */)
 {
 	lock_.lock();
 	alive_ = ok;
+	confirmed_ = ok;
 	if (ok == false)
 		time(&last_dead_);
 	lock_.unlock();
@@ -201,58 +792,241 @@ int connect_pool::check_idle(time_t ttl, bool exclusive /* = true */)
 {
 	if (ttl < 0)
 		return 0;
+
+	int n = 0;
+	time_t now = time(NULL);
+
 	if (exclusive)
 		lock_.lock();
-	if (pool_.empty())
+
+	// ͷſʱ䳬 ttl ӣttl Ϊ 0 ʱͷп
+	connect_client** pp = &idle_;
+	while (*pp != NULL)
+	{
+		connect_client* conn = *pp;
+		time_t when = conn->get_when();
+		if (ttl > 0 && (when <= 0 || now - when < ttl))
+		{
+			pp = &conn->next_;
+			continue;
+		}
+
+		*pp = conn->next_;
+		delete conn;
+		idle_count_--;
+		count_--;
+		n++;
+	}
+
+	if (!exclusive)
+		return n;
+
+	lock_.unlock();
+
+	std::vector<connect_client*> conns;
+	drain_caches(conns, ttl, conns.max_size(), false);
+	if (conns.empty())
+		return n;
+
+	std::vector<connect_client*>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+		delete *it;
+
+	lock_.lock();
+	count_ -= (int) conns.size();
+	lock_.unlock();
+
+	return n + (int) conns.size();
+}
+
+int connect_pool::prewarm(int n /* = 0 */)
+{
+	n = reserve_idle(n);
+	return n > 0 ? open_reserved(n) : 0;
+}
+
+int connect_pool::reserve_idle(int n)
+{
+	lock_.lock();
+
+	if (delay_destroy_ || !alive_)
 	{
 		lock_.unlock();
 		return 0;
 	}
 
-	if (ttl == 0)
+	// ԤδϵҲӣظ
+	if (n <= 0)
+		n = min_idle_ - (int) idle_count_ - warming_;
+	if (n > max_ - count_)
+		n = max_ - count_;
+
+	if (n > 0)
+	{
+		count_ += n;
+		warming_ += n;
+	}
+	else
+		n = 0;
+
+	lock_.unlock();
+	return n;
+}
+
+int connect_pool::open_reserved(int n)
+{
+	int  opened = 0;
+	bool failed = false;
+
+	// ⽨ӣӹ߳
+	while (opened < n)
 	{
-		int   n = 0;
-		std::list<connect_client*>::iterator it = pool_.begin();
-		for (; it != pool_.end(); ++it)
+		connect_client* conn = create_connect();
+		if (conn->open() == false)
 		{
-			delete *it;
-			n++;
-		};
-		pool_.clear();
-		count_ = 0;
+			delete conn;
+			failed = true;
+			break;
+		}
+
+		conn->set_pool(this);
+		conn->set_when(time(NULL));
+
+		lock_.lock();
+		if (delay_destroy_)
+		{
+			lock_.unlock();
+			delete conn;
+			break;
+		}
+
+		conn->next_ = idle_;
+		idle_ = conn;
+		idle_count_++;
+		warming_--;
+		confirmed_ = true;
 		lock_.unlock();
-		return n;
+
+		opened++;
 	}
 
-	int n = 0;
-	time_t now = time(NULL), when;
+	if (opened == n)
+		return opened;
 
-	std::list<connect_client*>::iterator it, next;
-	std::list<connect_client*>::reverse_iterator rit = pool_.rbegin();
+	// ͷδܽԤ
+	lock_.lock();
+	count_ -= n - opened;
+	warming_ -= n - opened;
+	if (failed)
+	{
+		alive_ = false;
+		confirmed_ = false;
+		(void) time(&last_dead_);
+	}
+	bool destroy = delay_destroy_ && count_ <= 0 && refers_ <= 0;
+	lock_.unlock();
+
+	if (destroy)
+		delete this;
+	return opened;
+}
+
+int connect_pool::check_dead(time_t ttl /* = 0 */)
+{
+	time_t now = time(NULL);
+	connect_client* probes = NULL;
 
-	for (; rit != pool_.rend();)
+	// ȴӿջȡҪ̽ӣ̽ڼЩӲᱻ peek 
+	lock_.lock();
+	connect_client** pp = &idle_;
+	while (*pp != NULL)
 	{
-		it = --rit.base();
-		when = (*it)->get_when();
-		if (when <= 0)
+		connect_client* conn = *pp;
+		if (ttl > 0 && now - conn->get_when() < ttl)
 		{
-			++rit;
+			pp = &conn->next_;
 			continue;
 		}
 
-		if (now - when < ttl)
-			break;
+		*pp = conn->next_;
+		conn->next_ = probes;
+		probes = conn;
+		idle_count_--;
+	}
+	lock_.unlock();
 
-		delete *it;
-		next = pool_.erase(it);
-		rit = std::list<connect_client*>::reverse_iterator(next);
+	if (probes == NULL)
+		return 0;
 
-		n++;
-		count_--;
+	// ̽⣬̽߳
+	connect_client* alives = NULL, *last = NULL;
+	int nalive = 0, ndead = 0;
+
+	while (probes != NULL)
+	{
+		connect_client* conn = probes;
+		probes = conn->next_;
+
+		if (conn->alive())
+		{
+			conn->next_ = alives;
+			alives = conn;
+			if (last == NULL)
+				last = conn;
+			nalive++;
+		}
+		else
+		{
+			delete conn;
+			ndead++;
+		}
 	}
 
+	// õӷŻؿջʱ䲻̽ı
+	lock_.lock();
+	count_ -= ndead;
+	if (delay_destroy_)
+	{
+		probes = alives;
+		count_ -= nalive;
+	}
+	else if (alives != NULL)
+	{
+		last->next_ = idle_;
+		idle_ = alives;
+		idle_count_ += nalive;
+	}
+	bool destroy = delay_destroy_ && count_ <= 0 && refers_ <= 0;
 	lock_.unlock();
-	return n;
+
+	while (probes != NULL)
+	{
+		connect_client* conn = probes;
+		probes = conn->next_;
+		delete conn;
+	}
+
+	if (destroy)
+		delete this;
+	return ndead;
+}
+
+void connect_pool::refer()
+{
+	lock_.lock();
+	refers_++;
+	lock_.unlock();
+}
+
+void connect_pool::unrefer()
+{
+	lock_.lock();
+	refers_--;
+	bool destroy = delay_destroy_ && count_ <= 0 && refers_ <= 0;
+	lock_.unlock();
+
+	if (destroy)
+		delete this;
 }
 
 } // namespace acl
@@ -0,0 +1,45 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/connpool/connect_pool.hpp"
+#include "keep_job.hpp"
+
+namespace acl
+{
+
+keep_job::keep_job(connect_pool& pool)
+: pool_(pool)
+, probe_(false)
+, ttl_(0)
+{
+}
+
+keep_job::keep_job(connect_pool& pool, time_t ttl)
+: pool_(pool)
+, probe_(true)
+, ttl_(ttl)
+{
+}
+
+void* keep_job::run()
+{
+	if (probe_)
+	{
+		int n = pool_.check_dead(ttl_);
+		if (n > 0)
+			logger_warn("server: %s, %d dead connections closed",
+				pool_.get_addr(), n);
+
+		// úӳؿѱ٣ٷ
+		pool_.unrefer();
+	}
+	else
+	{
+		// غӳؿѱ٣ٷ
+		(void) pool_.open_reserved(1);
+	}
+
+	delete this;
+	return NULL;
+}
+
+} // namespace acl
@@ -0,0 +1,43 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+
+namespace acl
+{
+
+class connect_pool;
+
+/**
+ *  connect_monitor ̳߳еӳά֮
+ * ӳԤĿӻԿӽб̽⣬ɺ
+ */
+class keep_job : public thread_job
+{
+public:
+	/**
+	 * 캯ӳһԤ(μ connect_pool::reserve_idle)
+	 * @param pool {connect_pool&}
+	 */
+	keep_job(connect_pool& pool);
+
+	/**
+	 * 캯̽ӳпʱ䲻 ttl ӣѵ
+	 * connect_pool::refer øӳ
+	 * @param pool {connect_pool&}
+	 * @param ttl {time_t}
+	 */
+	keep_job(connect_pool& pool, time_t ttl);
+
+protected:
+	// ി麯̳߳ص߳
+	void* run();
+
+private:
+	connect_pool& pool_;
+	bool   probe_;
+	time_t ttl_;
+
+	~keep_job() {}
+};
+
+} // namespace acl
@@ -5,6 +5,9 @@
 #include "acl_cpp/stdlib/util.hpp"
 #include "acl_cpp/stream/socket_stream.hpp"
 
+// ÿ get Яļֵ
+#define	MAX_GET_KEYS	100
+
 #define	SPECIAL_CHAR(x)	((x) == ' ' || (x) == '\t' || (x) == '\r' || (x) == '\n')
 
 namespace acl
@@ -22,6 +25,8 @@ memcache::memcache(const char* addr /* = "127.0.0.1:11211" */,
 , content_length_(0)
 , length_(0)
 , conn_(NULL)
+, multi_cmds_(0)
+, unsynced_(0)
 {
 	acl_assert(addr && *addr);
 	addr_ = acl_mystrdup(addr);
@@ -97,11 +102,29 @@ void memcache::close()
 		conn_ = NULL;
 	}
 	opened_ = false;
+	unsynced_ = 0;
+}
+
+bool memcache::drain_sync()
+{
+	while (unsynced_ > 0)
+	{
+		// sync_recv ʱѹر
+		if (sync_recv() == false)
+		{
+			logger_error("noreply commands to %s error: %s",
+				addr_, last_serror());
+			return false;
+		}
+		unsynced_--;
+	}
+	return true;
 }
 
 bool memcache::open()
 {
-	if (opened_)
+	// ȶȡǰδȴ version Ӧʱѱرգ
+	if (opened_ && drain_sync())
 		return true;
 
 	conn_ = NEW socket_stream();
@@ -497,6 +520,270 @@ bool memcache::del(const char* key)
 	return del(key, strlen(key));
 }
 
+bool memcache::send_request(const string& req)
+{
+	bool has_tried = false;
+
+AGAIN:
+	if (open() == false)
+		return false;
+
+	// ظִУдʧʱط
+	if (conn_->write(req) == -1)
+	{
+		close();
+		if (retry_ && !has_tried)
+		{
+			has_tried = true;
+			goto AGAIN;
+		}
+		ebuf_.format("write multi request error");
+		return false;
+	}
+	return true;
+}
+
+bool memcache::get_multi_send(const std::vector<string>& keys)
+{
+	multi_keys_.clear();
+	multi_cmds_ = 0;
+
+	string req;
+	int n = 0;
+
+	std::vector<string>::const_iterator cit = keys.begin();
+	for (; cit != keys.end(); ++cit)
+	{
+		const string& kbuf = build_key(cit->c_str(), cit->length());
+		if (multi_keys_.find(kbuf) != multi_keys_.end())
+			continue;
+		multi_keys_[kbuf] = *cit;
+
+		if (n == 0)
+			req << "get";
+		req << " " << kbuf;
+		if (++n == MAX_GET_KEYS)
+		{
+			req << "\r\n";
+			multi_cmds_++;
+			n = 0;
+		}
+	}
+
+	if (n > 0)
+	{
+		req << "\r\n";
+		multi_cmds_++;
+	}
+
+	if (multi_cmds_ == 0)
+		return true;
+	return send_request(req);
+}
+
+bool memcache::get_multi_recv(std::map<string, string>& out,
+	std::map<string, unsigned short>* flags)
+{
+	// ÿ get Ӧ END 
+	int ends = 0;
+
+	while (ends < multi_cmds_)
+	{
+		if (conn_->gets(res_line_) == false)
+		{
+			close();
+			ebuf_.format("reply for get_multi error");
+			return false;
+		}
+
+		if (res_line_.compare("END", false) == 0)
+		{
+			ends++;
+			continue;
+		}
+		if (error_happen(res_line_.c_str()))
+		{
+			close();
+			return false;
+		}
+
+		// VALUE {key} {flags} {bytes}\r\n
+		ACL_ARGV* tokens = acl_argv_split(res_line_.c_str(), " \t");
+		if (tokens->argc < 4
+			|| strcasecmp(tokens->argv[0], "VALUE") != 0)
+		{
+			close();
+			ebuf_.format("server error for get_multi, value: %s",
+				res_line_.c_str());
+			acl_argv_free(tokens);
+			return false;
+		}
+
+		std::map<string, string>::const_iterator cit =
+			multi_keys_.find(tokens->argv[1]);
+		unsigned short flag = (unsigned short) atoi(tokens->argv[2]);
+		int len = atoi(tokens->argv[3]);
+		acl_argv_free(tokens);
+
+		if (len < 0)
+		{
+			close();
+			ebuf_.format("invalid length: %d", len);
+			return false;
+		}
+
+		// ˷δѯļֵʱȡ
+		string dummy;
+		string& buf = cit != multi_keys_.end() ? out[cit->second] : dummy;
+		if (len > 0 && conn_->read(buf, (size_t) len, true) == false)
+		{
+			close();
+			ebuf_.format("read data error!");
+			return false;
+		}
+		else if (len == 0)
+			buf.clear();
+
+		// ݿ֮Ϊ "\r\n"˵ӦѴλ
+		char crlf[2];
+		if (conn_->read(crlf, 2, true) == -1)
+		{
+			close();
+			ebuf_.format("read data CRLF error");
+			return false;
+		}
+		if (crlf[0] != '\r' || crlf[1] != '\n')
+		{
+			close();
+			ebuf_.format("invalid data end for get_multi");
+			return false;
+		}
+
+		if (flags && cit != multi_keys_.end())
+			(*flags)[cit->second] = flag;
+	}
+
+	return true;
+}
+
+bool memcache::get_multi(const std::vector<string>& keys,
+	std::map<string, string>& out,
+	std::map<string, unsigned short>* flags /* = NULL */)
+{
+	if (get_multi_send(keys) == false)
+		return false;
+	return get_multi_recv(out, flags);
+}
+
+bool memcache::get_multi(const std::vector<const char*>& keys,
+	std::map<string, string>& out,
+	std::map<string, unsigned short>* flags /* = NULL */)
+{
+	std::vector<string> buf;
+	std::vector<const char*>::const_iterator cit = keys.begin();
+	for (; cit != keys.end(); ++cit)
+		buf.push_back(*cit);
+	return get_multi(buf, out, flags);
+}
+
+bool memcache::set_multi_send(const std::map<string, string>& items,
+	time_t timeout, unsigned short flags, bool sync)
+{
+	if (items.empty())
+		return true;
+
+	string req;
+	std::map<string, string>::const_iterator cit = items.begin();
+	for (; cit != items.end(); ++cit)
+	{
+		const string& kbuf = build_key(cit->first.c_str(),
+			cit->first.length());
+		req.format_append("set %s %u %d %d noreply\r\n", kbuf.c_str(),
+			flags, (int) timeout, (int) cit->second.length());
+		req.append(cit->second.c_str(), cit->second.length());
+		req.append("\r\n", 2);
+	}
+
+	//  noreply ȻӦǸ version Ա
+	// ȡӦʱִ󣬲ȴʱһβǰȡ
+	req << "version\r\n";
+	if (send_request(req) == false)
+		return false;
+	if (!sync)
+		unsynced_++;
+	return true;
+}
+
+bool memcache::del_multi_send(const std::vector<string>& keys, bool sync)
+{
+	if (keys.empty())
+		return true;
+
+	string req;
+	std::vector<string>::const_iterator cit = keys.begin();
+	for (; cit != keys.end(); ++cit)
+	{
+		const string& kbuf = build_key(cit->c_str(), cit->length());
+		req.format_append("delete %s noreply\r\n", kbuf.c_str());
+	}
+
+	req << "version\r\n";
+	if (send_request(req) == false)
+		return false;
+	if (!sync)
+		unsynced_++;
+	return true;
+}
+
+bool memcache::sync_recv()
+{
+	// noreply ûӦյĵһӦ version Ӧ
+	// ˵ʱϵ޷룬ر
+	if (conn_->gets(res_line_) == false)
+	{
+		close();
+		ebuf_.format("reply for version error");
+		return false;
+	}
+
+	if (strncasecmp(res_line_.c_str(), "VERSION", sizeof("VERSION") - 1))
+	{
+		if (!error_happen(res_line_.c_str()))
+			ebuf_.format("reply(%s) for noreply commands error",
+				res_line_.c_str());
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool memcache::set_multi(const std::map<string, string>& items,
+	time_t timeout /* = 0 */, unsigned short flags /* = 0 */,
+	bool sync /* = true */)
+{
+	if (set_multi_send(items, timeout, flags, sync) == false)
+		return false;
+	return !sync || items.empty() || sync_recv();
+}
+
+bool memcache::del_multi(const std::vector<string>& keys,
+	bool sync /* = true */)
+{
+	if (del_multi_send(keys, sync) == false)
+		return false;
+	return !sync || keys.empty() || sync_recv();
+}
+
+bool memcache::del_multi(const std::vector<const char*>& keys,
+	bool sync /* = true */)
+{
+	std::vector<string> buf;
+	std::vector<const char*>::const_iterator cit = keys.begin();
+	for (; cit != keys.end(); ++cit)
+		buf.push_back(*cit);
+	return del_multi(buf, sync);
+}
+
 const char* memcache::last_serror() const
 {
 	static const char* dummy = "ok";
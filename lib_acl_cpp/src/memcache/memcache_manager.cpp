@@ -1,4 +1,7 @@
 #include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/connpool/connect_pool.hpp"
+#include "acl_cpp/memcache/memcache.hpp"
 #include "acl_cpp/memcache/memcache_pool.hpp"
 #include "acl_cpp/memcache/memcache_manager.hpp"
 
@@ -21,4 +24,164 @@ connect_pool* memcache_manager::create_pool(const char* addr,
 	return conns;
 }
 
+// ֵĹϣʽֵ鵽ӳ
+static bool group_keys(connect_manager& manager,
+	const std::vector<string>& keys,
+	std::map<connect_pool*, std::vector<string> >& groups)
+{
+	bool ret = true;
+
+	std::vector<string>::const_iterator cit = keys.begin();
+	for (; cit != keys.end(); ++cit)
+	{
+		connect_pool* pool = manager.peek(cit->c_str());
+		if (pool == NULL)
+			ret = false;
+		else
+			groups[pool].push_back(*cit);
+	}
+
+	return ret;
+}
+
+// ÿѷ󡢵ȴȡӦ
+struct mc_conn
+{
+	connect_pool* pool;
+	memcache* conn;
+};
+
+static memcache* peek_conn(connect_pool* pool)
+{
+	memcache* conn = (memcache*) pool->peek();
+	if (conn == NULL)
+		logger_error("peek connection from %s error", pool->get_addr());
+	return conn;
+}
+
+bool memcache_manager::get_multi(const std::vector<string>& keys,
+	std::map<string, string>& out,
+	std::map<string, unsigned short>* flags /* = NULL */)
+{
+	std::map<connect_pool*, std::vector<string> > groups;
+	bool ret = group_keys(*this, keys, groups);
+
+	std::vector<mc_conn> conns;
+	std::map<connect_pool*, std::vector<string> >::const_iterator cit;
+	for (cit = groups.begin(); cit != groups.end(); ++cit)
+	{
+		mc_conn mc;
+		mc.pool = cit->first;
+		mc.conn = peek_conn(mc.pool);
+		if (mc.conn == NULL)
+			ret = false;
+		else if (mc.conn->get_multi_send(cit->second) == false)
+		{
+			mc.pool->put(mc.conn, false);
+			ret = false;
+		}
+		else
+			conns.push_back(mc);
+	}
+
+	std::vector<mc_conn>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+	{
+		bool ok = it->conn->get_multi_recv(out, flags);
+		it->pool->put(it->conn, ok);
+		if (!ok)
+			ret = false;
+	}
+
+	return ret;
+}
+
+bool memcache_manager::set_multi(const std::map<string, string>& items,
+	time_t timeout /* = 0 */, unsigned short flags /* = 0 */,
+	bool sync /* = true */)
+{
+	std::map<connect_pool*, std::map<string, string> > groups;
+	bool ret = true;
+
+	std::map<string, string>::const_iterator cit1 = items.begin();
+	for (; cit1 != items.end(); ++cit1)
+	{
+		connect_pool* pool = peek(cit1->first.c_str());
+		if (pool == NULL)
+			ret = false;
+		else
+			groups[pool].insert(*cit1);
+	}
+
+	std::vector<mc_conn> conns;
+	std::map<connect_pool*, std::map<string, string> >::const_iterator cit;
+	for (cit = groups.begin(); cit != groups.end(); ++cit)
+	{
+		mc_conn mc;
+		mc.pool = cit->first;
+		mc.conn = peek_conn(mc.pool);
+		if (mc.conn == NULL)
+			ret = false;
+		else if (!mc.conn->set_multi_send(cit->second, timeout,
+			flags, sync))
+		{
+			mc.pool->put(mc.conn, false);
+			ret = false;
+		}
+		else if (!sync)
+			mc.pool->put(mc.conn, true);
+		else
+			conns.push_back(mc);
+	}
+
+	std::vector<mc_conn>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+	{
+		bool ok = it->conn->sync_recv();
+		it->pool->put(it->conn, ok);
+		if (!ok)
+			ret = false;
+	}
+
+	return ret;
+}
+
+bool memcache_manager::del_multi(const std::vector<string>& keys,
+	bool sync /* = true */)
+{
+	std::map<connect_pool*, std::vector<string> > groups;
+	bool ret = group_keys(*this, keys, groups);
+
+	std::vector<mc_conn> conns;
+	std::map<connect_pool*, std::vector<string> >::const_iterator cit;
+	for (cit = groups.begin(); cit != groups.end(); ++cit)
+	{
+		mc_conn mc;
+		mc.pool = cit->first;
+		mc.conn = peek_conn(mc.pool);
+		if (mc.conn == NULL)
+			ret = false;
+		else if (mc.conn->del_multi_send(cit->second, sync) == false)
+		{
+			mc.pool->put(mc.conn, false);
+			ret = false;
+		}
+		else if (!sync)
+			mc.pool->put(mc.conn, true);
+		else
+			conns.push_back(mc);
+	}
+
+	std::vector<mc_conn>::iterator it = conns.begin();
+	for (; it != conns.end(); ++it)
+	{
+		bool ok = it->conn->sync_recv();
+		it->pool->put(it->conn, ok);
+		if (!ok)
+			ret = false;
+	}
+
+	return ret;
+}
+
 } // namespace acl
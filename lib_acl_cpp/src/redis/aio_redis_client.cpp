@@ -0,0 +1,246 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/util.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/stream/aio_handle.hpp"
+#include "acl_cpp/stream/aio_socket_stream.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_command.hpp"
+#include "acl_cpp/redis/aio_redis_client.hpp"
+#include "redis_builder.hpp"
+#include "redis_parser.hpp"
+
+namespace acl
+{
+
+aio_redis_client::aio_redis_client(aio_handle& handle, const char* addr,
+	int conn_timeout /* = 10 */, int rw_timeout /* = 10 */)
+: handle_(handle)
+, addr_(addr)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+, conn_(NULL)
+, opened_(false)
+, destroyed_(NULL)
+{
+	builder_ = NEW redis_builder;
+	parser_ = NEW redis_parser;
+	pool_ = NEW dbuf_pool;
+	parser_->reset(pool_);
+}
+
+aio_redis_client::~aio_redis_client()
+{
+	//  read_callback Ľصбʱ֪ͨ䲻ñ
+	if (destroyed_ != NULL)
+		*destroyed_ = true;
+
+	if (conn_ != NULL)
+	{
+		// Ƚлصӹرʱٻص
+		conn_->del_open_callback(this);
+		conn_->del_read_callback(this);
+		conn_->del_close_callback(this);
+		conn_->del_timeout_callback(this);
+		conn_->close();
+		conn_ = NULL;
+	}
+
+	fail_pending();
+
+	delete builder_;
+	delete parser_;
+	delete pool_;
+}
+
+bool aio_redis_client::open()
+{
+	if (conn_ != NULL)
+		return true;
+
+	conn_ = aio_socket_stream::open(&handle_, addr_, conn_timeout_);
+	if (conn_ == NULL)
+	{
+		logger_error("connect redis %s error: %s",
+			addr_.c_str(), last_serror());
+		return false;
+	}
+
+	conn_->add_open_callback(this);
+	conn_->add_close_callback(this);
+	conn_->add_timeout_callback(this);
+	return true;
+}
+
+void aio_redis_client::close()
+{
+	if (conn_ != NULL)
+		conn_->close();
+}
+
+bool aio_redis_client::exec(const char* cmd, const char* key,
+	const std::vector<string>& args, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args);
+	return send_request(callback);
+}
+
+bool aio_redis_client::exec(const char* cmd, const char* key,
+	const std::vector<const char*>& args, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args);
+	return send_request(callback);
+}
+
+bool aio_redis_client::exec(const char* cmd, const char* key,
+	const std::map<string, string>& attrs, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, attrs);
+	return send_request(callback);
+}
+
+bool aio_redis_client::exec(const char* cmd, const char* key,
+	const char* args[], const size_t lens[], size_t argc,
+	aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args, lens, argc);
+	return send_request(callback);
+}
+
+bool aio_redis_client::exec(const char* cmd, const char* key,
+	const char* args[], size_t argc, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args, argc);
+	return send_request(callback);
+}
+
+bool aio_redis_client::send_request(aio_redis_callback* callback)
+{
+	const string* req = builder_->request_buf_;
+	return exec_request(req->c_str(), req->length(), callback);
+}
+
+bool aio_redis_client::exec_request(const char* data, size_t len,
+	aio_redis_callback* callback)
+{
+	if (conn_ == NULL && open() == false)
+		return false;
+
+	pending_.push_back(callback);
+
+	// ӽǰȽӳɹһ
+	if (opened_)
+		conn_->write(data, (int) len);
+	else
+		wbuf_.append(data, len);
+	return true;
+}
+
+void aio_redis_client::fail_pending()
+{
+	// صпٴηҪȽȴתƳ
+	std::list<aio_redis_callback*> pending;
+	pending.swap(pending_);
+
+	std::list<aio_redis_callback*>::iterator it = pending.begin();
+	for (; it != pending.end(); ++it)
+	{
+		if (*it != NULL)
+			(*it)->result_callback(NULL);
+	}
+}
+
+bool aio_redis_client::open_callback()
+{
+	opened_ = true;
+
+	conn_->add_read_callback(this);
+	conn_->keep_read(true);
+	conn_->read(0, rw_timeout_);
+
+	if (!wbuf_.empty())
+	{
+		conn_->write(wbuf_.c_str(), (int) wbuf_.length());
+		wbuf_.clear();
+	}
+	return true;
+}
+
+bool aio_redis_client::read_callback(char* data, int len)
+{
+	bool destroyed = false;
+	destroyed_ = &destroyed;
+
+	while (len > 0)
+	{
+		size_t n = parser_->update(data, (size_t) len);
+		data += n;
+		len -= (int) n;
+
+		if (parser_->failed())
+		{
+			logger_error("invalid reply from redis %s", addr_.c_str());
+			destroyed_ = NULL;
+			return false;
+		}
+		if (!parser_->finished())
+			break;
+
+		if (pending_.empty())
+		{
+			logger_error("no command for the reply from redis %s",
+				addr_.c_str());
+			destroyed_ = NULL;
+			return false;
+		}
+
+		aio_redis_callback* callback = pending_.front();
+		pending_.pop_front();
+
+		// صǰ룬µڴأ
+		// ڵڴؽڻصڼЧ
+		const redis_result* result = parser_->get_result();
+		dbuf_pool* pool = pool_;
+		pool_ = NEW dbuf_pool;
+		parser_->reset(pool_);
+
+		if (callback != NULL)
+			callback->result_callback(result);
+		delete pool;
+
+		// ڻصбʱٷκγԱ false Թر
+		if (destroyed)
+			return false;
+	}
+
+	destroyed_ = NULL;
+	return true;
+}
+
+void aio_redis_client::close_callback()
+{
+	// ӹرպͷ
+	conn_ = NULL;
+	opened_ = false;
+	wbuf_.clear();
+
+	delete pool_;
+	pool_ = NEW dbuf_pool;
+	parser_->reset(pool_);
+
+	fail_pending();
+}
+
+bool aio_redis_client::timeout_callback()
+{
+	// ӿʱĶʱΪ
+	if (opened_ && pending_.empty())
+		return true;
+
+	logger_error("%s redis %s timeout, pending: %d",
+		opened_ ? "read from" : "connect", addr_.c_str(),
+		(int) pending_.size());
+	return false;
+}
+
+} // namespace acl
@@ -0,0 +1,289 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_command.hpp"
+#include "acl_cpp/redis/aio_redis_client.hpp"
+#include "acl_cpp/redis/aio_redis_cluster.hpp"
+#include "redis_builder.hpp"
+
+namespace acl
+{
+
+#define	EQ(x, y) !strncasecmp((x), (y), sizeof(y) -1)
+#define	ASKING_CMD	"*1\r\n$6\r\nASKING\r\n"
+
+/**
+ * Ⱥģʽÿмصڴ MOVED/ASK ضս
+ * صûĻص
+ */
+class aio_redis_redirect : public aio_redis_callback
+{
+public:
+	aio_redis_redirect(aio_redis_cluster& cluster, const string& req,
+		aio_redis_callback* callback)
+	: cluster_(cluster)
+	, req_(req)
+	, callback_(callback)
+	, redirect_(0)
+	{
+	}
+
+	~aio_redis_redirect() {}
+
+	void result_callback(const redis_result* result);
+
+private:
+	aio_redis_cluster& cluster_;
+	string req_;
+	aio_redis_callback* callback_;
+	int    redirect_;
+
+	bool redirect(const char* info);
+};
+
+// ضϢ磺MOVED 3999 127.0.0.1:6381ùϣۼĿַ
+static bool get_redirect(const char* info, int& slot, string& addr)
+{
+	const char* ptr = strchr(info, ' ');
+	if (ptr == NULL)
+		return false;
+	slot = atoi(++ptr);
+
+	ptr = strchr(ptr, ' ');
+	if (ptr == NULL || *++ptr == 0)
+		return false;
+	addr = ptr;
+	return true;
+}
+
+bool aio_redis_redirect::redirect(const char* info)
+{
+	bool asking;
+	if (EQ(info, "MOVED"))
+		asking = false;
+	else if (EQ(info, "ASK"))
+		asking = true;
+	else
+		return false;
+
+	int slot;
+	string addr;
+	if (get_redirect(info, slot, addr) == false)
+	{
+		logger_warn("%s invalid", info);
+		return false;
+	}
+
+	// MOVED ʾϣѾǨƣ¹ϣַӳϵ
+	//  ASK ԱЧȷ ASKING 
+	if (!asking)
+		cluster_.set_slot(slot, addr);
+
+	aio_redis_client* conn = cluster_.get(addr);
+	if (asking && !conn->exec_request(ASKING_CMD,
+		sizeof(ASKING_CMD) - 1, NULL))
+	{
+		return false;
+	}
+
+	return conn->exec_request(req_.c_str(), req_.length(), this);
+}
+
+void aio_redis_redirect::result_callback(const redis_result* result)
+{
+	if (result != NULL && result->get_type() == REDIS_RESULT_ERROR
+		&& redirect_++ < cluster_.get_redirect_max()
+		&& redirect(result->get_error()))
+	{
+		return;
+	}
+
+	if (callback_ != NULL)
+		callback_->result_callback(result);
+	delete this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+aio_redis_cluster::aio_redis_cluster(aio_handle& handle,
+	int conn_timeout /* = 10 */, int rw_timeout /* = 10 */,
+	int max_slot /* = 16384 */)
+: handle_(handle)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+, max_slot_(max_slot)
+, redirect_max_(15)
+, next_(0)
+{
+	slot_addrs_ = (const char**) acl_mycalloc(max_slot_, sizeof(char*));
+	builder_ = NEW redis_builder;
+}
+
+aio_redis_cluster::~aio_redis_cluster()
+{
+	std::map<string, aio_redis_client*>::iterator it = clients_.begin();
+	for (; it != clients_.end(); ++it)
+		delete it->second;
+
+	acl_myfree(slot_addrs_);
+
+	std::vector<char*>::iterator cit = addrs_.begin();
+	for (; cit != addrs_.end(); ++cit)
+		acl_myfree(*cit);
+
+	delete builder_;
+}
+
+void aio_redis_cluster::set_redirect_max(int max)
+{
+	if (max > 0)
+		redirect_max_ = max;
+}
+
+const char* aio_redis_cluster::save_addr(const char* addr)
+{
+	std::vector<char*>::const_iterator cit = addrs_.begin();
+	for (; cit != addrs_.end(); ++cit)
+	{
+		if (strcasecmp(*cit, addr) == 0)
+			return *cit;
+	}
+
+	// ַö̬䣬Ա֤ slot_addrs_ õĵֲַ
+	char* buf = acl_mystrdup(addr);
+	addrs_.push_back(buf);
+	return buf;
+}
+
+aio_redis_cluster& aio_redis_cluster::set(const char* addrs)
+{
+	ACL_ARGV* tokens = acl_argv_split(addrs, ";, \t");
+	ACL_ITER iter;
+
+	acl_foreach(iter, tokens)
+	{
+		const char* addr = (const char*) iter.data;
+		save_addr(addr);
+	}
+
+	acl_argv_free(tokens);
+	return *this;
+}
+
+aio_redis_client* aio_redis_cluster::get(const char* addr)
+{
+	std::map<string, aio_redis_client*>::iterator it = clients_.find(addr);
+	if (it != clients_.end())
+		return it->second;
+
+	aio_redis_client* conn = NEW aio_redis_client(handle_, addr,
+		conn_timeout_, rw_timeout_);
+	clients_[addr] = conn;
+	save_addr(addr);
+	return conn;
+}
+
+aio_redis_client* aio_redis_cluster::peek_slot(int slot)
+{
+	if (slot < 0 || slot >= max_slot_ || slot_addrs_[slot] == NULL)
+		return NULL;
+	return get(slot_addrs_[slot]);
+}
+
+aio_redis_client* aio_redis_cluster::peek()
+{
+	if (addrs_.empty())
+		return NULL;
+
+	// ѭѡȡһ֪Ľ
+	const char* addr = addrs_[next_++ % addrs_.size()];
+	return get(addr);
+}
+
+void aio_redis_cluster::set_slot(int slot, const char* addr)
+{
+	if (slot < 0 || slot >= max_slot_ || addr == NULL || *addr == 0)
+		return;
+	slot_addrs_[slot] = save_addr(addr);
+}
+
+void aio_redis_cluster::clear_slot(int slot)
+{
+	if (slot >= 0 && slot < max_slot_)
+		slot_addrs_[slot] = NULL;
+}
+
+bool aio_redis_cluster::exec(const char* cmd, const char* key,
+	const std::vector<string>& args, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args);
+	return send_request(key, callback);
+}
+
+bool aio_redis_cluster::exec(const char* cmd, const char* key,
+	const std::vector<const char*>& args, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args);
+	return send_request(key, callback);
+}
+
+bool aio_redis_cluster::exec(const char* cmd, const char* key,
+	const std::map<string, string>& attrs, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, attrs);
+	return send_request(key, callback);
+}
+
+bool aio_redis_cluster::exec(const char* cmd, const char* key,
+	const char* args[], const size_t lens[], size_t argc,
+	aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args, lens, argc);
+	return send_request(key, callback);
+}
+
+bool aio_redis_cluster::exec(const char* cmd, const char* key,
+	const char* args[], size_t argc, aio_redis_callback* callback)
+{
+	builder_->build(cmd, key, args, argc);
+	return send_request(key, callback);
+}
+
+bool aio_redis_cluster::send_request(const char* key,
+	aio_redis_callback* callback)
+{
+	aio_redis_client* conn = NULL;
+	int slot = -1;
+
+	if (key != NULL && *key != 0)
+	{
+		slot = (int) (acl_hash_crc16(key, strlen(key)) % max_slot_);
+		conn = peek_slot(slot);
+	}
+
+	// ϣ۶ӦĽδ֪ʱѡһ㣬 MOVED ضȷĽ㣻
+	// ͬʱʱ¼ӳϵʹͬһϣ۵ĺͬһ㣬Ա֤
+	// Щִ˳
+	if (conn == NULL)
+	{
+		if ((conn = peek()) == NULL)
+		{
+			logger_error("no redis node available");
+			return false;
+		}
+		set_slot(slot, conn->get_addr());
+	}
+
+	const string* req = builder_->request_buf_;
+	aio_redis_redirect* redirect = NEW aio_redis_redirect(*this,
+		*req, callback);
+
+	if (conn->exec_request(req->c_str(), req->length(), redirect))
+		return true;
+
+	delete redirect;
+	clear_slot(slot);
+	return false;
+}
+
+} // namespace acl
@@ -0,0 +1,326 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/redis/redis_client_pool.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_batch.hpp"
+
+namespace acl
+{
+
+redis_batch::redis_batch()
+: redis_command(NULL)
+{
+}
+
+redis_batch::redis_batch(redis_client* conn)
+: redis_command(conn)
+, redis_pipeline(conn)
+{
+}
+
+redis_batch::redis_batch(redis_client_cluster* cluster, size_t max_conns)
+: redis_command(cluster, max_conns)
+, redis_pipeline(cluster, max_conns)
+{
+}
+
+redis_batch::~redis_batch()
+{
+}
+
+bool redis_batch::exec_keys(const char* cmd, const std::vector<string>& args,
+	size_t step /* = 1 */)
+{
+	size_t argc = args.size();
+	std::vector<const char*> argv(argc);
+	std::vector<size_t> lens(argc);
+
+	for (size_t i = 0; i < argc; i++)
+	{
+		argv[i] = args[i].c_str();
+		lens[i] = args[i].length();
+	}
+
+	return exec_keys(cmd, argc > 0 ? &argv[0] : NULL,
+		argc > 0 ? &lens[0] : NULL, argc, step);
+}
+
+bool redis_batch::exec_keys(const char* cmd,
+	const std::vector<const char*>& args, size_t step /* = 1 */)
+{
+	size_t argc = args.size();
+	std::vector<size_t> lens(argc);
+
+	for (size_t i = 0; i < argc; i++)
+		lens[i] = strlen(args[i]);
+
+	return exec_keys(cmd, argc > 0 ? (const char**) &args[0] : NULL,
+		argc > 0 ? &lens[0] : NULL, argc, step);
+}
+
+bool redis_batch::exec_keys(const char* cmd, const char* args[],
+	const size_t lens[], size_t argc, size_t step /* = 1 */)
+{
+	key_cmds_.clear();
+	key_idxs_.clear();
+	cmd_keys_.clear();
+
+	if (step == 0 || argc == 0 || argc % step != 0)
+	{
+		logger_error("invalid argc: %d, step: %d", (int) argc, (int) step);
+		return false;
+	}
+
+	size_t nkeys = argc / step;
+
+	// ֵĹϣ۽飬ǼȺģʽвΪͬһ飬
+	// ͬһеĲ鱣ֵ߸˳
+	redis_client_cluster* cluster = get_cluster();
+	int max_slot = cluster != NULL ? cluster->get_max_slot() : 0;
+	std::map<int, std::vector<size_t> > slots;
+
+	for (size_t i = 0; i < nkeys; i++)
+	{
+		int slot = -1;
+		if (max_slot > 0)
+		{
+			unsigned short n = acl_hash_crc16(args[i * step],
+				lens[i * step]);
+			slot = (int) (n % max_slot);
+		}
+		slots[slot].push_back(i);
+	}
+
+	key_cmds_.resize(nkeys);
+	key_idxs_.resize(nkeys);
+
+	std::vector<const char*> argv;
+	std::vector<size_t> argl;
+	argv.reserve(argc + 1);
+	argl.reserve(argc + 1);
+
+	std::map<int, std::vector<size_t> >::const_iterator cit;
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
+	{
+		const std::vector<size_t>& keys = cit->second;
+
+		argv.clear();
+		argl.clear();
+		argv.push_back(cmd);
+		argl.push_back(strlen(cmd));
+
+		for (size_t j = 0; j < keys.size(); j++)
+		{
+			size_t k = keys[j];
+			key_cmds_[k] = cmd_keys_.size();
+			key_idxs_[k] = j;
+
+			for (size_t n = k * step; n < (k + 1) * step; n++)
+			{
+				argv.push_back(args[n]);
+				argl.push_back(lens[n]);
+			}
+		}
+
+		cmd_keys_.push_back(keys.size());
+		add_slot(cit->first, argv.size(), &argv[0], &argl[0]);
+	}
+
+	return flush();
+}
+
+const redis_result* redis_batch::get_key_result(size_t i) const
+{
+	if (i >= key_cmds_.size())
+		return NULL;
+
+	size_t n = key_cmds_[i];
+	const redis_result* result = get_child(n);
+	if (result == NULL || result->get_type() != REDIS_RESULT_ARRAY)
+		return result;
+
+	size_t size;
+	const redis_result** children = result->get_children(&size);
+	if (children == NULL || size != cmd_keys_[n])
+		return result;
+	return children[key_idxs_[i]];
+}
+
+bool redis_batch::get_values(std::vector<string>* out)
+{
+	// һʱΪʧ
+	size_t size = get_size();
+	for (size_t i = 0; i < size; i++)
+	{
+		const redis_result* result = get_child(i);
+		if (result == NULL || result->get_type() != REDIS_RESULT_ARRAY)
+			return false;
+	}
+
+	if (out == NULL)
+		return true;
+
+	out->clear();
+	out->reserve(key_cmds_.size());
+
+	string buf;
+	for (size_t i = 0; i < key_cmds_.size(); i++)
+	{
+		const redis_result* rr = get_key_result(i);
+		if (rr == NULL || rr->get_type() != REDIS_RESULT_STRING
+			|| rr->get_size() == 0)
+		{
+			out->push_back("");
+		}
+		else
+		{
+			rr->argv_to_string(buf);
+			out->push_back(buf);
+		}
+	}
+
+	return true;
+}
+
+bool redis_batch::check_ok()
+{
+	size_t size = get_size();
+	for (size_t i = 0; i < size; i++)
+	{
+		const redis_result* result = get_child(i);
+		if (result == NULL || result->get_type() != REDIS_RESULT_STATUS)
+			return false;
+
+		const char* status = result->get_status();
+		if (status == NULL || strcasecmp(status, "OK") != 0)
+			return false;
+	}
+
+	return true;
+}
+
+int redis_batch::get_sum()
+{
+	int sum = 0;
+
+	size_t size = get_size();
+	for (size_t i = 0; i < size; i++)
+	{
+		const redis_result* result = get_child(i);
+		if (result == NULL || result->get_type() != REDIS_RESULT_INTEGER)
+			return -1;
+		sum += result->get_integer();
+	}
+
+	return sum;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool redis_batch::mget(const std::vector<string>& keys,
+	std::vector<string>* out /* = NULL */)
+{
+	if (!exec_keys("MGET", keys))
+		return false;
+	return get_values(out);
+}
+
+bool redis_batch::mget(const std::vector<const char*>& keys,
+	std::vector<string>* out /* = NULL */)
+{
+	if (!exec_keys("MGET", keys))
+		return false;
+	return get_values(out);
+}
+
+bool redis_batch::mset(const std::map<string, string>& objs)
+{
+	std::vector<const char*> args;
+	std::vector<size_t> lens;
+	args.reserve(objs.size() * 2);
+	lens.reserve(objs.size() * 2);
+
+	std::map<string, string>::const_iterator cit = objs.begin();
+	for (; cit != objs.end(); ++cit)
+	{
+		args.push_back(cit->first.c_str());
+		lens.push_back(cit->first.length());
+		args.push_back(cit->second.c_str());
+		lens.push_back(cit->second.length());
+	}
+
+	if (args.empty())
+	{
+		logger_error("no key");
+		return false;
+	}
+
+	if (!exec_keys("MSET", &args[0], &lens[0], args.size(), 2))
+		return false;
+	return check_ok();
+}
+
+bool redis_batch::mset(const std::vector<string>& keys,
+	const std::vector<string>& values)
+{
+	if (keys.size() != values.size())
+	{
+		logger_error("keys' size(%d) != values' size(%d)",
+			(int) keys.size(), (int) values.size());
+		return false;
+	}
+
+	std::vector<const char*> args;
+	std::vector<size_t> lens;
+	args.reserve(keys.size() * 2);
+	lens.reserve(keys.size() * 2);
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		args.push_back(keys[i].c_str());
+		lens.push_back(keys[i].length());
+		args.push_back(values[i].c_str());
+		lens.push_back(values[i].length());
+	}
+
+	if (args.empty())
+	{
+		logger_error("no key");
+		return false;
+	}
+
+	if (!exec_keys("MSET", &args[0], &lens[0], args.size(), 2))
+		return false;
+	return check_ok();
+}
+
+int redis_batch::del(const std::vector<string>& keys)
+{
+	if (!exec_keys("DEL", keys))
+		return -1;
+	return get_sum();
+}
+
+int redis_batch::del(const std::vector<const char*>& keys)
+{
+	if (!exec_keys("DEL", keys))
+		return -1;
+	return get_sum();
+}
+
+int redis_batch::exists(const std::vector<string>& keys)
+{
+	if (!exec_keys("EXISTS", keys))
+		return -1;
+	return get_sum();
+}
+
+int redis_batch::exists(const std::vector<const char*>& keys)
+{
+	if (!exec_keys("EXISTS", keys))
+		return -1;
+	return get_sum();
+}
+
+} // namespace acl
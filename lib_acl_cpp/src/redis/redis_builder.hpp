@@ -0,0 +1,19 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include "acl_cpp/redis/redis_command.hpp"
+
+namespace acl
+{
+
+/**
+ * ڽ redis_command  build ϵзΪ redis Э
+ * 첽ͻڲʹ
+ */
+class redis_builder : public redis_command
+{
+public:
+	redis_builder() {}
+	~redis_builder() {}
+};
+
+} // namespace acl
@@ -7,21 +7,36 @@
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
 #include "redis_request.hpp"
+#include "redis_parser.hpp"
 
 namespace acl
 {
 
 #define INT_LEN	11
 
+// ĳʼȼ󳤶ȣȡͬһӦʱα
+#define READ_MIN	4096
+#define READ_MAX	65536
+
+// ַʣĳȲСڸֵʱֱӽڴ
+#define DIRECT_MIN	4096
+
 redis_client::redis_client(const char* addr, int conn_timeout /* = 60 */,
 	int rw_timeout /* = 30 */, bool retry /* = true */)
 : conn_timeout_(conn_timeout)
 , rw_timeout_(rw_timeout)
 , retry_(retry)
+, readonly_(false)
 , slice_req_(false)
 , slice_res_(false)
+, rbuf_(NULL)
+, rsize_(0)
+, rlen_(0)
+, roff_(0)
 {
 	addr_ = acl_mystrdup(addr);
+	parser_ = NEW redis_parser;
+	parser_->set_zero_copy(true);
 }
 
 redis_client::~redis_client()
@@ -29,6 +44,7 @@ redis_client::~redis_client()
 	acl_myfree(addr_);
 	if (conn_.opened())
 		conn_.close();
+	delete parser_;
 }
 
 socket_stream* redis_client::get_stream()
@@ -51,13 +67,62 @@ bool redis_client::open()
 			addr_, last_serror());
 		return false;
 	}
+
+	if (readonly_ && !send_readonly())
+	{
+		conn_.close();
+		return false;
+	}
 	return true;
 }
 
+bool redis_client::send_readonly()
+{
+	if (conn_.write("*1\r\n$8\r\nREADONLY\r\n") == -1)
+	{
+		logger_error("write READONLY to redis(%s) error: %s",
+			addr_, last_serror());
+		return false;
+	}
+
+	string line;
+	if (conn_.gets(line) == false)
+	{
+		logger_error("read READONLY's reply from redis(%s) error: %s",
+			addr_, last_serror());
+		return false;
+	}
+	if (line != "+OK")
+	{
+		logger_error("READONLY's reply from redis(%s) error: %s",
+			addr_, line.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool redis_client::alive()
+{
+	// вδʱ˵ӦѴλʹ
+	if (!conn_.opened() || !rleft_.empty())
+		return false;
+
+	string line;
+	if (conn_.write("*1\r\n$4\r\nPING\r\n") == -1
+		|| conn_.gets(line) == false)
+	{
+		logger_warn("PING redis(%s) error: %s", addr_, last_serror());
+		close();
+		return false;
+	}
+	return line == "+PONG";
+}
+
 void redis_client::close()
 {
 	if (conn_.opened())
 		conn_.close();
+	rleft_.clear();
 }
 
 bool redis_client::eof() const
@@ -73,210 +138,114 @@ void redis_client::set_slice_request(bool on)
 void redis_client::set_slice_respond(bool on)
 {
 	slice_res_ = on;
+	parser_->set_slice(on);
 }
 
-/////////////////////////////////////////////////////////////////////////////
-
-void redis_client::put_data(dbuf_pool* pool, redis_result* rr,
-	const char* data, size_t len)
+void redis_client::set_readonly(bool on)
 {
-	char* buf = (char*) pool->dbuf_alloc(len + 1);
-	if (len > 0)
-		memcpy(buf, data, len);
-	buf[len] = 0;
-	rr->put(buf, len);
+	readonly_ = on;
 }
 
-redis_result* redis_client::get_redis_error(dbuf_pool* pool)
-{
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
-	}
-
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_ERROR);
-	rr->set_size(1);
-
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
-}
+/////////////////////////////////////////////////////////////////////////////
 
-redis_result* redis_client::get_redis_status(dbuf_pool* pool)
+bool redis_client::read_more(dbuf_pool* pool)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
+	// ֱַӶڴУο
+	size_t size;
+	char* buf = parser_->get_space(size);
+	if (buf != NULL && size >= DIRECT_MIN)
 	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
+		int ret = conn_.read(buf, size, false);
+		if (ret == -1)
+		{
+			logger_error("read data error, server: %s", addr_);
+			return false;
+		}
+		parser_->put_space((size_t) ret);
+		return true;
 	}
 
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_STATUS);
-	rr->set_size(1);
-
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
-}
+	rsize_ = rsize_ == 0 ? READ_MIN : rsize_ * 2;
+	if (rsize_ > READ_MAX)
+		rsize_ = READ_MAX;
 
-redis_result* redis_client::get_redis_integer(dbuf_pool* pool)
-{
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
+	// ڽڴϷ䣬Աڽֱе
+	rbuf_ = (char*) pool->dbuf_alloc(rsize_);
+	int ret = conn_.read(rbuf_, rsize_, false);
+	if (ret == -1)
 	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
+		logger_error("read data error, server: %s", addr_);
+		return false;
 	}
-
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_INTEGER);
-	rr->set_size(1);
-
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
+	rlen_ = (size_t) ret;
+	roff_ = 0;
+	return true;
 }
 
-redis_result* redis_client::get_redis_string(dbuf_pool* pool)
+redis_result* redis_client::get_object(dbuf_pool* pool)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
-	}
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_STRING);
-	int len = atoi(buf_.c_str());
-	if (len < 0)
-		return rr;
+	parser_->reset(pool);
 
-	char*  buf;
-
-	if (!slice_res_)
+	while (true)
 	{
-		rr->set_size(1);
-		buf = (char*) pool->dbuf_alloc(len + 1);
-		if (len > 0 && conn_.read(buf, (size_t) len) == -1)
-		{
-			logger_error("read data error, server: %s", addr_);
-			return NULL;
-		}
-		buf[len] = 0;
-		rr->put(buf, (size_t) len);
-
-		//  \r\n
-		buf_.clear();
-		if (conn_.gets(buf_) == false)
+		if (roff_ < rlen_)
 		{
-			logger_error("gets line error, server: %s", addr_);
-			return NULL;
+			roff_ += parser_->update(rbuf_ + roff_, rlen_ - roff_);
+			if (parser_->finished())
+				return parser_->get_result();
+			if (parser_->failed())
+			{
+				logger_error("invalid respond, server: %s", addr_);
+				return NULL;
+			}
 		}
-		return rr;
-	}
-
-	// ܷصĴڴֳɲӵڴ洢
 
-#define CHUNK_LENGTH	8192
-
-	size_t size = (size_t) len / CHUNK_LENGTH;
-	if ((size_t) len % CHUNK_LENGTH != 0)
-		size++;
-	rr->set_size(size);
-	int    n;
-
-	while (len > 0)
-	{
-		n = len > CHUNK_LENGTH - 1 ? CHUNK_LENGTH - 1 : len;
-		buf = (char*) pool->dbuf_alloc((size_t) (n + 1));
-		if (conn_.read(buf, (size_t) n) == -1)
-		{
-			logger_error("read data error, server: %s", addr_);
+		if (read_more(pool) == false)
 			return NULL;
-		}
-		buf[n] = 0;
-		rr->put(buf, (size_t) n);
-		len -= n;
-	}
-	
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
 	}
-	return rr;
 }
 
-redis_result* redis_client::get_redis_array(dbuf_pool* pool)
+redis_result* redis_client::get_objects(dbuf_pool* pool, size_t nobjs)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-		return NULL;
-
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_ARRAY);
-	int count = atoi(buf_.c_str());
-	if (count <= 0)
-		return rr;
-
-	rr->set_size((size_t) count);
+	rbuf_ = NULL;
+	rsize_ = 0;
+	rlen_ = 0;
+	roff_ = 0;
 
-	for (int i = 0; i < count; i++)
+	// ȴϴζڱӦ
+	if (!rleft_.empty())
 	{
-		redis_result* child = get_redis_object(pool);
-		if (child == NULL)
-			return NULL;
-		rr->put(child, i);
-	}
-
-	return rr;
-}
-
-redis_result* redis_client::get_redis_object(dbuf_pool* pool)
-{
-	char ch;
-	if (conn_.read(ch) == false)
-	{
-		logger_error("read first char error, server: %s", addr_);
-		return NULL;
+		rlen_ = rleft_.length();
+		rbuf_ = (char*) pool->dbuf_alloc(rlen_);
+		memcpy(rbuf_, rleft_.c_str(), rlen_);
+		rleft_.clear();
 	}
 
-	switch (ch)
+	redis_result* objs = NULL;
+	if (nobjs >= 1)
 	{
-	case '-':	// ERROR
-		return get_redis_error(pool);
-	case '+':	// STATUS
-		return get_redis_status(pool);
-	case ':':	// INTEGER
-		return get_redis_integer(pool);
-	case '$':	// STRING
-		return get_redis_string(pool);
-	case '*':	// ARRAY
-		return get_redis_array(pool);
-	default:	// INVALID
-		logger_error("invalid first char: %c, %d", ch, ch);
-		return NULL;
+		objs = new(pool) redis_result(pool);
+		objs->set_type(REDIS_RESULT_ARRAY);
+		objs->set_size(nobjs);
 	}
-}
-
-redis_result* redis_client::get_redis_objects(dbuf_pool* pool, size_t nobjs)
-{
-	acl_assert(nobjs >= 1);
-
-	redis_result* objs = new(pool) redis_result(pool);
-	objs->set_type(REDIS_RESULT_ARRAY);
-	objs->set_size(nobjs);
+	else
+		nobjs = 1;
 
+	redis_result* obj = NULL;
 	for (size_t i = 0; i < nobjs; i++)
 	{
-		redis_result* obj = get_redis_object(pool);
+		obj = get_object(pool);
 		if (obj == NULL)
 			return NULL;
-		objs->put(obj, i);
+		if (objs != NULL)
+			objs->put(obj, i);
 	}
-	return objs;
+
+	// ںӦݣ綩ģʽ·͵Ϣ
+	if (roff_ < rlen_)
+		rleft_.copy(rbuf_ + roff_, rlen_ - roff_);
+
+	return objs != NULL ? objs : obj;
 }
 
 const redis_result* redis_client::run(dbuf_pool* pool, const string& req,
@@ -288,17 +257,12 @@ const redis_result* redis_client::run(dbuf_pool* pool, const string& req,
 
 	while (true)
 	{
-		if (!conn_.opened() && conn_.open(addr_, conn_timeout_,
-			rw_timeout_) == false)
-		{
-			logger_error("connect server: %s error: %s",
-				addr_, last_serror());
+		if (!open())
 			return NULL;
-		}
 
 		if (!req.empty() && conn_.write(req) == -1)
 		{
-			conn_.close();
+			close();
 			if (retry_ && !retried)
 			{
 				retried = true;
@@ -309,15 +273,11 @@ const redis_result* redis_client::run(dbuf_pool* pool, const string& req,
 			return NULL;
 		}
 
-		if (nchildren >= 1)
-			result = get_redis_objects(pool, nchildren);
-		else
-			result = get_redis_object(pool);
-
+		result = get_objects(pool, nchildren);
 		if (result != NULL)
 			return result;
 
-		conn_.close();
+		close();
 
 		if (!retry_ || retried)
 			break;
@@ -341,17 +301,12 @@ const redis_result* redis_client::run(dbuf_pool* pool, const redis_request& req,
 
 	while (true)
 	{
-		if (!conn_.opened() && conn_.open(addr_, conn_timeout_,
-			rw_timeout_) == false)
-		{
-			logger_error("connect server: %s error: %s",
-				addr_, last_serror());
+		if (!open())
 			return NULL;
-		}
 
 		if (size > 0 && conn_.writev(iov, (int) size) == -1)
 		{
-			conn_.close();
+			close();
 			if (retry_ && !retried)
 			{
 				retried = true;
@@ -362,15 +317,11 @@ const redis_result* redis_client::run(dbuf_pool* pool, const redis_request& req,
 			return NULL;
 		}
 
-		if (nchildren >= 1)
-			result = get_redis_objects(pool, nchildren);
-		else
-			result = get_redis_object(pool);
-
+		result = get_objects(pool, nchildren);
 		if (result != NULL)
 			return result;
 
-		conn_.close();
+		close();
 
 		if (!retry_ || retried)
 			break;
@@ -381,4 +332,38 @@ const redis_result* redis_client::run(dbuf_pool* pool, const redis_request& req,
 	return NULL;
 }
 
+bool redis_client::send_request(const string& req)
+{
+	bool retried = false;
+
+	while (true)
+	{
+		if (!open())
+			return false;
+
+		if (conn_.write(req) != -1)
+			return true;
+
+		close();
+
+		if (!retry_ || retried)
+		{
+			logger_error("write to redis(%s) error: %s",
+				addr_, last_serror());
+			return false;
+		}
+
+		retried = true;
+	}
+}
+
+const redis_result* redis_client::read_respond(dbuf_pool* pool,
+	size_t nchildren)
+{
+	redis_result* result = get_objects(pool, nchildren);
+	if (result == NULL)
+		close();
+	return result;
+}
+
 } // end namespace acl
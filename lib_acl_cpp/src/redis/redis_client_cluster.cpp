@@ -1,6 +1,9 @@
 #include "acl_stdafx.hpp"
 #include <vector>
 #include "acl_cpp/stdlib/snprintf.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
 #include "acl_cpp/redis/redis_cluster.hpp"
 #include "acl_cpp/redis/redis_slot.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
@@ -10,6 +13,103 @@
 namespace acl
 {
 
+// ̨ˢ̼߳ˢʱ()
+#define CHECK_INTER	100
+
+// ˢ֮Сʱ()лڼƵˢ
+#define REFRESH_MIN	1000
+
+static long long now_ms()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (long long) now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+/**
+ * Ⱥ˵ĺ̨ˢ̣߳ڻյˢͨ CLUSTER SLOTS ˢ
+ * йϣַӳϵ
+ */
+class slots_refresher : public thread
+{
+public:
+	slots_refresher(redis_client_cluster& cluster, int inter)
+	: cluster_(cluster)
+	, inter_(inter)
+	, stop_(false)
+	, pending_(false)
+	{
+	}
+
+	~slots_refresher() {}
+
+	// ̵߳ã־λڶд
+	void stop()
+	{
+		lock_.lock();
+		stop_ = true;
+		lock_.unlock();
+	}
+
+	void request()
+	{
+		lock_.lock();
+		pending_ = true;
+		lock_.unlock();
+	}
+
+protected:
+	// ി麯
+	void* run()
+	{
+		// ϴˢµʱ估ϴˢµʱ
+		long long last = now_ms(), last_req = 0, now;
+		bool stop, pending;
+
+		while (true)
+		{
+			acl_doze(CHECK_INTER);
+
+			lock_.lock();
+			stop = stop_;
+			pending = pending_;
+			lock_.unlock();
+
+			if (stop)
+				break;
+
+			now = now_ms();
+			if (pending)
+			{
+				if (now - last_req < REFRESH_MIN)
+					continue;
+				last_req = now;
+			}
+			else if (inter_ <= 0 || now - last < inter_ * 1000LL)
+				continue;
+
+			// ˢǰ־ˢڼһˢ
+			lock_.lock();
+			pending_ = false;
+			lock_.unlock();
+
+			cluster_.refresh_slots();
+			last = now_ms();
+		}
+
+		return NULL;
+	}
+
+private:
+	redis_client_cluster& cluster_;
+	int  inter_;
+	locker lock_;
+	bool stop_;
+	bool pending_;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
 redis_client_cluster::redis_client_cluster(int conn_timeout /* = 30 */,
 	int rw_timeout /* = 30 */, int max_slot /* = 16384 */)
 : conn_timeout_(conn_timeout)
@@ -17,17 +117,29 @@ redis_client_cluster::redis_client_cluster(int conn_timeout /* = 30 */,
 , max_slot_(max_slot)
 , redirect_max_(15)
 , redirect_sleep_(100)
+, max_conns_(0)
+, refresher_(NULL)
+, read_mode_(REDIS_READ_MASTER)
+, read_seq_(0)
 {
 	slot_addrs_ = (const char**) acl_mycalloc(max_slot_, sizeof(char*));
+	slot_replicas_ = (const replicas_t**)
+		acl_mycalloc(max_slot_, sizeof(replicas_t*));
 }
 
 redis_client_cluster::~redis_client_cluster()
 {
+	stop_refresh();
 	acl_myfree(slot_addrs_);
+	acl_myfree(slot_replicas_);
 
 	std::vector<char*>::iterator it = addrs_.begin();
 	for (; it != addrs_.end(); ++it)
 		acl_myfree(*it);
+
+	std::vector<replicas_t*>::iterator it2 = replicas_.begin();
+	for (; it2 != replicas_.end(); ++it2)
+		delete *it2;
 }
 
 void redis_client_cluster::set_redirect_max(int max)
@@ -41,6 +153,11 @@ void redis_client_cluster::set_redirect_sleep(int n)
 	redirect_sleep_ = n;
 }
 
+void redis_client_cluster::set_read_mode(redis_read_mode_t mode)
+{
+	read_mode_ = mode;
+}
+
 connect_pool* redis_client_cluster::create_pool(const char* addr,
 	int count, size_t idx)
 {
@@ -73,6 +190,65 @@ redis_client_pool* redis_client_cluster::peek_slot(int slot)
 	return conns;
 }
 
+redis_client_pool* redis_client_cluster::peek_read_slot(int slot,
+	redis_read_mode_t mode)
+{
+	if (slot < 0 || slot >= max_slot_)
+		return NULL;
+
+	lock();
+
+	if (slot_addrs_[slot] == NULL)
+	{
+		unlock();
+		return NULL;
+	}
+
+	redis_client_pool* master =
+		(redis_client_pool*) get(slot_addrs_[slot], false);
+	const replicas_t* replicas = slot_replicas_[slot];
+
+	if (mode == REDIS_READ_MASTER || replicas == NULL || replicas->empty())
+	{
+		unlock();
+		return master;
+	}
+
+	// ѡ͵Ľ㣬ͬʱתλÿʼѡȡδ
+	// Ľͬһѡ
+	redis_client_pool* best = NULL;
+	double best_load = 0.0;
+	size_t n = replicas->size();
+	size_t start = read_seq_++ % n;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		const char* addr = (*replicas)[(start + i) % n];
+		redis_client_pool* pool = (redis_client_pool*) get(addr, false);
+		if (pool == NULL || !pool->aliving())
+			continue;
+
+		double load = pool->get_load();
+		if (best == NULL || load < best_load)
+		{
+			best = pool;
+			best_load = load;
+		}
+	}
+
+	// ͽȡʱȽϣȶȡӽʱֻûпõĴӽ
+	// ʱŶȡ
+	if (mode == REDIS_READ_NEAREST && master != NULL && master->aliving()
+		&& (best == NULL || master->get_load() < best_load))
+	{
+		best = master;
+	}
+
+	unlock();
+
+	return best != NULL ? best : master;
+}
+
 void redis_client_cluster::clear_slot(int slot)
 {
 	if (slot >= 0 && slot < max_slot_)
@@ -83,73 +259,234 @@ void redis_client_cluster::clear_slot(int slot)
 	}
 }
 
+const char* redis_client_cluster::save_addr(const char* addr)
+{
+	// еַõֱַӣ
+	std::vector<char*>::const_iterator cit = addrs_.begin();
+	for (; cit != addrs_.end(); ++cit)
+	{
+		if (strcmp((*cit), addr) == 0)
+			return *cit;
+	}
+
+	// ֻԲö̬䷽ʽΪӶʱ
+	// ̬ӵĶ̬ڴַǹ̶ģ slot_addrs_ 
+	// ±ַҲԲ
+	char* buf = acl_mystrdup(addr);
+	addrs_.push_back(buf);
+	return buf;
+}
+
+const redis_client_cluster::replicas_t* redis_client_cluster::save_replicas(
+	const replicas_t& addrs)
+{
+	// ͬĴӽ㼯ֻһݣѱļڱ
+	// ǰᱻͷţΪ߳̿ʹ
+	std::vector<replicas_t*>::const_iterator cit = replicas_.begin();
+	for (; cit != replicas_.end(); ++cit)
+	{
+		if (**cit == addrs)
+			return *cit;
+	}
+
+	replicas_t* replicas = NEW replicas_t(addrs);
+	replicas_.push_back(replicas);
+	return replicas;
+}
+
 void redis_client_cluster::set_slot(int slot, const char* addr)
 {
 	if (slot < 0 || slot >= max_slot_ || addr == NULL || *addr == 0)
 		return;
 
-	// еַõֱַӣȻʹ֮ slot й
-
-	// öδҪ
+	//  slot ַйӳ䣬öδҪ
 	lock();
+	slot_addrs_[slot] = save_addr(addr);
+	unlock();
+}
 
-	std::vector<char*>::const_iterator cit = addrs_.begin();
-	for (; cit != addrs_.end(); ++cit)
+// ýĵַǷʱ false
+static bool get_node_addr(const redis_slot* node, string& addr)
+{
+	const char* ip = node->get_ip();
+	if (*ip == 0)
+		return false;
+	int port = node->get_port();
+	if (port <= 0)
+		return false;
+
+	addr.format("%s:%d", ip, port);
+	return true;
+}
+
+// ùϣ۷ΧַǷʱ false
+static bool get_slot_addr(const redis_slot* slot, int max_slot, string& addr)
+{
+	size_t slot_min = slot->get_slot_min();
+	size_t slot_max = slot->get_slot_max();
+	if ((int) slot_max >= max_slot || slot_max < slot_min)
+		return false;
+
+	return get_node_addr(slot, addr);
+}
+
+void redis_client_cluster::set_slots(const std::vector<redis_slot*>& slots)
+{
+	std::vector<redis_slot*>::const_iterator cit;
+	std::vector<redis_slot*>::const_iterator cit2;
+	string addr;
+
+	// Ϊ½㴴ӳأѴڵĽӳرʹãֻڴӽ
+	// ȡʱΪӽ㴴ӳ
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
 	{
-		if (strcmp((*cit), addr) == 0)
-			break;
+		if (!get_slot_addr(*cit, max_slot_, addr))
+			continue;
+
+		set(addr, max_conns_);
+		if (read_mode_ == REDIS_READ_MASTER)
+			continue;
+
+		const std::vector<redis_slot*>& slaves = (*cit)->get_slaves();
+		for (cit2 = slaves.begin(); cit2 != slaves.end(); ++cit2)
+		{
+			if (get_node_addr(*cit2, addr))
+				((redis_client_pool&) set(addr, max_conns_))
+					.set_readonly(true);
+		}
 	}
 
-	//  slot ַйӳ
-	if (cit != addrs_.end())
-		slot_addrs_[slot] = *cit;
-	else
+	// һ滻йϣ۵ӳϵδֵĹϣ۱
+	lock();
+
+	memset(slot_addrs_, 0, max_slot_ * sizeof(char*));
+	memset(slot_replicas_, 0, max_slot_ * sizeof(replicas_t*));
+
+	replicas_t addrs;
+
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
 	{
-		// ֻԲö̬䷽ʽΪӶʱ
-		// ̬ӵĶ̬ڴַǹ̶ģ
-		// slot_addrs_ ±ַҲԲ
-		char* buf = acl_mystrdup(addr);
-		addrs_.push_back(buf);
-		slot_addrs_[slot] = buf;
+		if (!get_slot_addr(*cit, max_slot_, addr))
+			continue;
+
+		const char* ptr = save_addr(addr);
+
+		const replicas_t* replicas = NULL;
+		if (read_mode_ != REDIS_READ_MASTER)
+		{
+			addrs.clear();
+			const std::vector<redis_slot*>& slaves =
+				(*cit)->get_slaves();
+			for (cit2 = slaves.begin(); cit2 != slaves.end(); ++cit2)
+			{
+				if (get_node_addr(*cit2, addr))
+					addrs.push_back(save_addr(addr));
+			}
+			if (!addrs.empty())
+				replicas = save_replicas(addrs);
+		}
+
+		size_t slot_max = (*cit)->get_slot_max();
+		for (size_t i = (*cit)->get_slot_min(); i <= slot_max; i++)
+		{
+			slot_addrs_[i] = ptr;
+			slot_replicas_[i] = replicas;
+		}
 	}
 
 	unlock();
 }
 
-void redis_client_cluster::set_all_slot(const char* addr, int max_conns)
+bool redis_client_cluster::load_slots(const char* addr)
 {
-	redis_client client(addr, 30, 60, false);
+	redis_client client(addr, conn_timeout_, rw_timeout_, false);
 	redis_cluster cluster(&client);
 
 	const std::vector<redis_slot*>* slots = cluster.cluster_slots();
-	if (slots == NULL)
-		return;
+	if (slots == NULL || slots->empty())
+		return false;
 
-	std::vector<redis_slot*>::const_iterator cit;
-	for (cit = slots->begin(); cit != slots->end(); ++cit)
+	set_slots(*slots);
+	return true;
+}
+
+void redis_client_cluster::set_all_slot(const char* addr, int max_conns)
+{
+	max_conns_ = max_conns;
+	(void) load_slots(addr);
+}
+
+bool redis_client_cluster::refresh_slots()
+{
+	std::vector<string> addrs;
+
+	// ȴӴĽȡϢ
+	lock();
+	std::vector<connect_pool*>& pools = get_pools();
+	std::vector<connect_pool*>::const_iterator cit;
+	for (cit = pools.begin(); cit != pools.end(); ++cit)
 	{
-		const redis_slot* slot = *cit;
-		const char* ip = slot->get_ip();
-		if (*ip == 0)
-			continue;
-		int port = slot->get_port();
-		if (port <= 0)
-			continue;
+		if ((*cit)->aliving())
+			addrs.push_back((*cit)->get_addr());
+	}
+	for (cit = pools.begin(); cit != pools.end(); ++cit)
+	{
+		if (!(*cit)->aliving())
+			addrs.push_back((*cit)->get_addr());
+	}
+	unlock();
 
-		size_t slot_min = slot->get_slot_min();
-		size_t slot_max = slot->get_slot_max();
-		if ((int) slot_max >= max_slot_ || slot_max < slot_min)
-			continue;
-		
-		char buf[128];
-		safe_snprintf(buf, sizeof(buf), "%s:%d", ip, port);
-		redis_client_pool* conns = (redis_client_pool*) get(buf);
-		if (conns == NULL)
-			set(buf, max_conns);
+	std::vector<string>::const_iterator it;
+	for (it = addrs.begin(); it != addrs.end(); ++it)
+	{
+		if (load_slots(*it))
+			return true;
+	}
+
+	logger_error("load slots error from all %d nodes", (int) addrs.size());
+	return false;
+}
 
-		for (size_t i = slot_min; i <= slot_max; i++)
-			set_slot((int) i, buf);
+bool redis_client_cluster::start_refresh(int inter /* = 60 */,
+	int max_conns /* = 100 */)
+{
+	if (refresher_ != NULL)
+	{
+		logger_warn("refresher has been started");
+		return false;
+	}
+
+	max_conns_ = max_conns;
+	bool ret = refresh_slots();
+
+	refresher_ = NEW slots_refresher(*this, inter);
+	refresher_->set_detachable(false);
+	if (refresher_->start() == false)
+	{
+		logger_error("start refresher thread error");
+		delete refresher_;
+		refresher_ = NULL;
+		return false;
 	}
+
+	return ret;
+}
+
+void redis_client_cluster::stop_refresh()
+{
+	if (refresher_ == NULL)
+		return;
+
+	refresher_->stop();
+	refresher_->wait();
+	delete refresher_;
+	refresher_ = NULL;
+}
+
+void redis_client_cluster::request_refresh()
+{
+	if (refresher_ != NULL)
+		refresher_->request();
 }
 
 } // namespace acl
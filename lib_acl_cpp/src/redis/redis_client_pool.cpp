@@ -10,7 +10,10 @@ redis_client_pool::redis_client_pool(const char* addr, int count,
 : connect_pool(addr, count, idx)
 , conn_timeout_(30)
 , rw_timeout_(60)
+, readonly_(false)
 {
+	// Ⱥģʽ°ӳټ;ѡֻĽ
+	set_track_load(true);
 }
 
 redis_client_pool::~redis_client_pool()
@@ -25,10 +28,18 @@ redis_client_pool& redis_client_pool::set_timeout(int conn_timeout,
 	return *this;
 }
 
+redis_client_pool& redis_client_pool::set_readonly(bool on)
+{
+	readonly_ = on;
+	return *this;
+}
+
 connect_client* redis_client_pool::create_connect()
 {
 	redis_client* conn = NEW redis_client(addr_, conn_timeout_,
 		rw_timeout_);
+	if (readonly_)
+		conn->set_readonly(true);
 	return conn;
 }
 
@@ -7,6 +7,7 @@
 #include "acl_cpp/redis/redis_client_cluster.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_command.hpp"
+#include "acl_cpp/redis/redis_near_cache.hpp"
 #include "redis_request.hpp"
 
 namespace acl
@@ -15,6 +16,131 @@ namespace acl
 #define INT_LEN		11
 #define	LONG_LEN	21
 
+#define CMD_IN(cmd, len, cmds) \
+	cmd_in((cmd), (len), (cmds), sizeof(cmds) / sizeof((cmds)[0]))
+
+static bool cmd_in(const char* cmd, size_t len, const char* cmds[], size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		if (strlen(cmds[i]) == len && strncasecmp(cmd, cmds[i], len) == 0)
+			return true;
+	}
+	return false;
+}
+
+// ɽ˻ṩĶ
+static bool near_read(const char* cmd, size_t len)
+{
+	static const char* cmds[] = { "GET", "HGET", "HGETALL" };
+
+	return CMD_IN(cmd, len, cmds);
+}
+
+// Ⱥģʽ¿ڴӽִеֻ
+static bool read_only(const char* cmd, size_t len)
+{
+	static const char* cmds[] = {
+		"GET", "MGET", "STRLEN", "GETRANGE", "GETBIT", "BITCOUNT",
+		"BITPOS", "EXISTS", "TYPE", "TTL", "PTTL", "DUMP",
+		"HGET", "HMGET", "HGETALL", "HKEYS", "HVALS", "HLEN",
+		"HEXISTS", "HSTRLEN", "HSCAN",
+		"LRANGE", "LLEN", "LINDEX",
+		"SMEMBERS", "SISMEMBER", "SCARD", "SRANDMEMBER", "SSCAN",
+		"SDIFF", "SINTER", "SUNION",
+		"ZRANGE", "ZREVRANGE", "ZRANGEBYSCORE", "ZREVRANGEBYSCORE",
+		"ZRANGEBYLEX", "ZREVRANGEBYLEX", "ZSCORE", "ZCARD", "ZCOUNT",
+		"ZLEXCOUNT", "ZRANK", "ZREVRANK", "ZSCAN",
+		"PFCOUNT", "GEOPOS", "GEODIST", "GEOHASH",
+	};
+
+	return CMD_IN(cmd, len, cmds);
+}
+
+// ݿս˻
+static bool near_flush(const char* cmd, size_t len)
+{
+	static const char* cmds[] = { "FLUSHDB", "FLUSHALL" };
+
+	return CMD_IN(cmd, len, cmds);
+}
+
+// д޸ĵļֵʹڽ˻ʧЧֻֵ
+// ޸κμֵȱʡֻ޸һʾļֵ
+static void near_keys(size_t argc, const char* argv[], const size_t lens[],
+	std::vector<string>& keys)
+{
+	//  read_only ֮⣬޸ļֵ
+	static const char* nokey_cmds[] = {
+		"AUTH", "SELECT", "PING", "ECHO", "INFO", "CONFIG", "CLIENT",
+		"CLUSTER", "SCRIPT", "KEYS", "SCAN", "RANDOMKEY", "OBJECT",
+		"TOUCH", "WATCH", "PUBLISH", "SUBSCRIBE", "PSUBSCRIBE",
+		"UNSUBSCRIBE", "PUNSUBSCRIBE",
+	};
+	// вΪֵ
+	static const char* all_cmds[] = {
+		"DEL", "UNLINK", "RENAME", "RENAMENX", "RPOPLPUSH",
+		"SDIFFSTORE", "SINTERSTORE", "SUNIONSTORE", "PFMERGE",
+	};
+	// ǰΪֵ
+	static const char* two_cmds[] = {
+		"SMOVE", "LMOVE", "BLMOVE", "BRPOPLPUSH", "COPY",
+	};
+	// ĳʱΪֵ
+	static const char* block_cmds[] = {
+		"BLPOP", "BRPOP", "BZPOPMIN", "BZPOPMAX",
+	};
+	// ֵֵɶԳ
+	static const char* pair_cmds[] = { "MSET", "MSETNX" };
+	// ڶΪֵΪֵ
+	static const char* script_cmds[] = { "EVAL", "EVALSHA" };
+
+	const char* cmd = argv[0];
+	size_t len = lens[0];
+
+	if (argc < 2 || near_read(cmd, len) || read_only(cmd, len)
+		|| CMD_IN(cmd, len, nokey_cmds))
+	{
+		return;
+	}
+
+	// ֵΪ argv[first, last] мΪ step Ĳ
+	size_t first = 1, last = 1, step = 1;
+
+	if (CMD_IN(cmd, len, all_cmds))
+		last = argc - 1;
+	else if (CMD_IN(cmd, len, two_cmds))
+		last = 2;
+	else if (CMD_IN(cmd, len, block_cmds))
+		last = argc - 2;
+	else if (CMD_IN(cmd, len, pair_cmds))
+	{
+		last = argc - 1;
+		step = 2;
+	}
+	else if (CMD_IN(cmd, len, script_cmds))
+	{
+		char buf[INT_LEN];
+		if (argc < 3 || lens[2] >= sizeof(buf))
+			return;
+		memcpy(buf, argv[2], lens[2]);
+		buf[lens[2]] = 0;
+		int n = atoi(buf);
+		if (n <= 0)
+			return;
+		first = 3;
+		last = 2 + (size_t) n;
+	}
+	else if (len == 5 && strncasecmp(cmd, "BITOP", len) == 0)
+		first = last = 2;
+
+	for (size_t i = first; i <= last && i < argc; i += step)
+	{
+		keys.push_back(string());
+		keys.back().copy(argv[i], lens[i]);
+	}
+}
+
 redis_command::redis_command()
 : conn_(NULL)
 , cluster_(NULL)
@@ -23,6 +149,8 @@ redis_command::redis_command()
 , slot_(-1)
 , redirect_max_(15)
 , redirect_sleep_(100)
+, read_mode_(REDIS_READ_MASTER)
+, read_only_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -31,6 +159,10 @@ redis_command::redis_command()
 , argv_lens_(NULL)
 , slice_res_(false)
 , result_(NULL)
+, near_cache_(NULL)
+, near_keys_(NULL)
+, near_dirty_(false)
+, near_flush_(false)
 {
 	pool_ = NEW dbuf_pool(128000);
 	addr_[0] = 0;
@@ -45,6 +177,8 @@ redis_command::redis_command(redis_client* conn)
 , slot_(-1)
 , redirect_max_(15)
 , redirect_sleep_(1)
+, read_mode_(REDIS_READ_MASTER)
+, read_only_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -53,6 +187,10 @@ redis_command::redis_command(redis_client* conn)
 , argv_lens_(NULL)
 , slice_res_(false)
 , result_(NULL)
+, near_cache_(NULL)
+, near_keys_(NULL)
+, near_dirty_(false)
+, near_flush_(false)
 {
 	pool_ = NEW dbuf_pool(128000);
 	if (conn != NULL)
@@ -67,6 +205,8 @@ redis_command::redis_command(redis_client_cluster* cluster, size_t max_conns)
 , max_conns_(max_conns)
 , used_(0)
 , slot_(-1)
+, read_mode_(REDIS_READ_MASTER)
+, read_only_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -75,6 +215,10 @@ redis_command::redis_command(redis_client_cluster* cluster, size_t max_conns)
 , argv_lens_(NULL)
 , slice_res_(false)
 , result_(NULL)
+, near_cache_(NULL)
+, near_keys_(NULL)
+, near_dirty_(false)
+, near_flush_(false)
 {
 	pool_ = NEW dbuf_pool(128000);
 	addr_[0] = 0;
@@ -85,6 +229,7 @@ redis_command::redis_command(redis_client_cluster* cluster, size_t max_conns)
 		if (redirect_max_ <= 0)
 			redirect_max_ = 15;
 		redirect_sleep_ = cluster->get_redirect_sleep();
+		read_mode_ = cluster->get_read_mode();
 	}
 	else
 	{
@@ -101,6 +246,7 @@ redis_command::~redis_command()
 		acl_myfree(argv_lens_);
 	delete request_buf_;
 	delete request_obj_;
+	delete near_keys_;
 	delete pool_;
 }
 
@@ -131,6 +277,12 @@ void redis_command::set_slice_respond(bool on)
 	slice_res_ = on;
 }
 
+void redis_command::set_near_cache(redis_near_cache* cache)
+{
+	near_cache_ = cache;
+	near_dirty_ = false;
+}
+
 void redis_command::set_client(redis_client* conn)
 {
 	conn_ = conn;
@@ -161,6 +313,12 @@ void redis_command::set_cluster(redis_client_cluster* cluster, size_t max_conns)
 	if (redirect_max_ <= 0)
 		redirect_max_ = 15;
 	redirect_sleep_ = cluster->get_redirect_sleep();
+	read_mode_ = cluster->get_read_mode();
+}
+
+void redis_command::set_read_mode(redis_read_mode_t mode)
+{
+	read_mode_ = mode;
 }
 
 bool redis_command::eof() const
@@ -371,10 +529,30 @@ redis_client* redis_command::peek_conn(redis_client_cluster* cluster, int slot)
 	return NULL;
 }
 
+redis_client* redis_command::peek_read_conn(redis_client_cluster* cluster,
+	int slot)
+{
+	// ·ɷʽӽѡһӳأʧʱɵߴȡ
+	redis_client_pool* conns = cluster->peek_read_slot(slot, read_mode_);
+	if (conns == NULL)
+		return NULL;
+
+	redis_client* conn = (redis_client*) conns->peek();
+	if (conn == NULL)
+		conns->set_alive(false);
+	return conn;
+}
+
 const redis_result* redis_command::run(redis_client_cluster* cluster,
 	size_t nchild)
 {
-	redis_client* conn = peek_conn(cluster, slot_);
+	redis_client* conn = NULL;
+
+	// ֻ·ɷʽѡ㣬δѡʱӹϣ۶Ӧȡ
+	if (read_only_ && slot_ >= 0)
+		conn = peek_read_conn(cluster, slot_);
+	if (conn == NULL)
+		conn = peek_conn(cluster, slot_);
 
 	// ûҵõӶֱӷ NULL ʾ
 	if (conn == NULL)
@@ -386,11 +564,14 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 	set_client_addr(*conn);
 
 	redis_result_t type;
+	redis_client_pool* conns;
 	bool  last_moved = false;
 	int   n = 0;
 
 	while (n++ < redirect_max_)
 	{
+		conns = (redis_client_pool*) conn->get_pool();
+
 		// ǷڴƬʽòͬ
 		if (slice_req_)
 			result_ = conn->run(pool_, *request_obj_, nchild);
@@ -400,8 +581,10 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 		// 쳣ϿҪ
 		if (conn->eof())
 		{
-			// ɾϣеĵַӳϵԱ´βʱ»ȡ
-			cluster->clear_slot(slot_);
+			// ɾϣеĵַӳϵԱ´βʱ»ȡ
+			// ӽӶϿʱֻĴȡ
+			if (!conns->is_readonly())
+				cluster->clear_slot(slot_);
 
 			// ӳضΪ״̬
 			conn->get_pool()->set_alive(false);
@@ -473,6 +656,9 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 				return result_;
 			}
 
+			// ϣѾǨƣ̨߳ˢȺϢ
+			cluster->request_refresh();
+
 			conn = redirect(cluster, addr);
 
 			if (conn == NULL)
@@ -585,18 +771,41 @@ const redis_result* redis_command::run(size_t nchild /* = 0 */)
 {
 	used_++;
 
+	const redis_result* result;
+
 	if (cluster_ != NULL)
-		return run(cluster_, nchild);
+		result = run(cluster_, nchild);
 	else if (conn_ != NULL)
 	{
 		if (slice_req_)
 			result_ = conn_->run(pool_, *request_obj_, nchild);
 		else
 			result_ = conn_->run(pool_, *request_buf_, nchild);
-		return result_;
+		result = result_;
 	}
 	else
-		return NULL;
+		result = NULL;
+
+	if (near_dirty_)
+		near_invalidate();
+	return result;
+}
+
+void redis_command::near_invalidate()
+{
+	near_dirty_ = false;
+	if (near_cache_ == NULL)
+		return;
+
+	if (near_flush_)
+	{
+		near_cache_->clear();
+		return;
+	}
+
+	std::vector<string>::const_iterator cit = near_keys_->begin();
+	for (; cit != near_keys_->end(); ++cit)
+		near_cache_->invalidate((*cit).c_str(), (*cit).length());
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1107,6 +1316,23 @@ void redis_command::clear_request()
 
 void redis_command::build_request(size_t argc, const char* argv[], size_t lens[])
 {
+	read_only_ = cluster_ != NULL && read_mode_ != REDIS_READ_MASTER
+		&& read_only(argv[0], lens[0]);
+
+	// ¼д޸ĵļֵɺʹЩֵĻʧЧ
+	if (near_cache_ != NULL)
+	{
+		if (near_keys_ == NULL)
+			near_keys_ = NEW std::vector<string>;
+		else
+			near_keys_->clear();
+
+		near_flush_ = near_flush(argv[0], lens[0]);
+		if (!near_flush_)
+			near_keys(argc, argv, lens, *near_keys_);
+		near_dirty_ = near_flush_ || !near_keys_->empty();
+	}
+
 	if (slice_req_)
 		build_request2(argc, argv, lens);
 	else
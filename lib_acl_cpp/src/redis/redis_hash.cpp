@@ -3,6 +3,7 @@
 #include "acl_cpp/redis/redis_client.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_hash.hpp"
+#include "acl_cpp/redis/redis_near_cache.hpp"
 
 namespace acl
 {
@@ -151,29 +152,54 @@ bool redis_hash::hget(const char* key, const char* name, string& result)
 bool redis_hash::hget(const char* key, const char* name,
 	size_t name_len, string& result)
 {
+	size_t key_len = strlen(key);
+	redis_near_cache* cache = get_near_cache();
+	unsigned long long seq = 0;
+	if (cache != NULL && cache->hget(key, key_len, name, name_len,
+		result, seq))
+	{
+		return true;
+	}
+
 	const char* argv[3];
 	size_t lens[3];
 
 	argv[0] = "HGET";
 	lens[0] = sizeof("HGET") - 1;
 	argv[1] = key;
-	lens[1] = strlen(key);
+	lens[1] = key_len;
 	argv[2] = name;
 	lens[2] = name_len;
 
 	hash_slot(key);
 	build_request(3, argv, lens);
-	return get_string(result) >= 0 ? true : false;
+	if (get_string(result) < 0)
+		return false;
+
+	if (cache != NULL)
+		cache->hput(key, key_len, name, name_len, result, seq);
+	return true;
 }
 
 bool redis_hash::hgetall(const char* key, std::map<string, string>& result)
 {
+	size_t key_len = strlen(key);
+	redis_near_cache* cache = get_near_cache();
+	unsigned long long seq = 0;
+	if (cache != NULL && cache->hgetall(key, key_len, result, seq))
+		return true;
+
 	const char* keys[1];
 	keys[0] = key;
 
 	hash_slot(key);
 	build("HGETALL", NULL, keys, 1);
-	return get_strings(result) < 0 ? false : true;
+	if (get_strings(result) < 0)
+		return false;
+
+	if (cache != NULL)
+		cache->hputall(key, key_len, result, seq);
+	return true;
 }
 
 bool redis_hash::hgetall(const char* key, std::vector<string>& names,
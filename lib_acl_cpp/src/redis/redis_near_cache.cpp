@@ -0,0 +1,603 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/util.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/stream/socket_stream.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_near_cache.hpp"
+#include "redis_parser.hpp"
+
+namespace acl
+{
+
+//  RESP2 Э鷢ʧЧ֪ͨʱʹõƵ
+#define TRACK_CHANNEL	"__redis__:invalidate"
+
+// ٿӵı()ӶϿʱ˻ֹͣʧЧ֪ͨ
+#define PING_INTER	5
+
+// ȴʧЧ֪ͨĳʱʱ()ʱǷҪ˳򱣻
+#define WAIT_TIMEOUT	1
+
+struct near_conn
+{
+	socket_stream conn;
+	redis_parser parser;
+	dbuf_pool* pool;
+	bool   parsing;
+	char   buf[8192];
+	size_t len;
+	size_t off;
+};
+
+/**
+ * ˻ʧЧ֪̣ͨ߳ÿ̶߳Ӧһ redis 㣬sub_ 
+ * ʧЧ֪ͨƵctl_ Թ㲥ģʽٲ֪ͨض sub_
+ */
+class near_tracker : public thread
+{
+public:
+	near_tracker(redis_near_cache& cache, const char* addr,
+		const std::vector<string>* prefixes,
+		int conn_timeout, int rw_timeout);
+	~near_tracker();
+
+	bool open();
+
+	void stop()
+	{
+		stop_ = true;
+	}
+
+protected:
+	// ി麯
+	void* run();
+
+private:
+	redis_near_cache& cache_;
+	string addr_;
+	std::vector<string> prefixes_;
+	int  conn_timeout_;
+	int  rw_timeout_;
+	bool stop_;
+	time_t last_ping_;
+	near_conn sub_;
+	near_conn ctl_;
+
+	void close();
+	bool check();
+	void on_message(const redis_result* rr);
+	const redis_result* request(near_conn& c,
+		const std::vector<const char*>& argv);
+	const redis_result* read_result(near_conn& c, int timeout,
+		bool* timedout);
+};
+
+near_tracker::near_tracker(redis_near_cache& cache, const char* addr,
+	const std::vector<string>* prefixes, int conn_timeout, int rw_timeout)
+: cache_(cache)
+, addr_(addr)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+, stop_(false)
+, last_ping_(0)
+{
+	if (prefixes != NULL)
+		prefixes_ = *prefixes;
+
+	sub_.pool = NULL;
+	ctl_.pool = NULL;
+	close();
+}
+
+near_tracker::~near_tracker()
+{
+	close();
+	delete sub_.pool;
+	delete ctl_.pool;
+}
+
+void near_tracker::close()
+{
+	near_conn* conns[] = { &sub_, &ctl_ };
+
+	for (size_t i = 0; i < sizeof(conns) / sizeof(conns[0]); i++)
+	{
+		if (conns[i]->conn.opened())
+			conns[i]->conn.close();
+		conns[i]->parsing = false;
+		conns[i]->len = 0;
+		conns[i]->off = 0;
+	}
+}
+
+bool near_tracker::open()
+{
+	close();
+
+	if (sub_.conn.open(addr_, conn_timeout_, rw_timeout_) == false
+		|| ctl_.conn.open(addr_, conn_timeout_, rw_timeout_) == false)
+	{
+		logger_error("connect redis %s error: %s",
+			addr_.c_str(), last_serror());
+		close();
+		return false;
+	}
+
+	std::vector<const char*> argv;
+	argv.push_back("CLIENT");
+	argv.push_back("ID");
+
+	const redis_result* rr = request(sub_, argv);
+	if (rr == NULL || rr->get_type() != REDIS_RESULT_INTEGER)
+	{
+		logger_error("CLIENT ID error, server: %s", addr_.c_str());
+		close();
+		return false;
+	}
+
+	string id;
+	id.format("%lld", rr->get_integer64());
+
+	argv.clear();
+	argv.push_back("SUBSCRIBE");
+	argv.push_back(TRACK_CHANNEL);
+
+	rr = request(sub_, argv);
+	if (rr == NULL || rr->get_type() != REDIS_RESULT_ARRAY)
+	{
+		logger_error("SUBSCRIBE %s error, server: %s",
+			TRACK_CHANNEL, addr_.c_str());
+		close();
+		return false;
+	}
+
+	argv.clear();
+	argv.push_back("CLIENT");
+	argv.push_back("TRACKING");
+	argv.push_back("ON");
+	argv.push_back("REDIRECT");
+	argv.push_back(id.c_str());
+	argv.push_back("BCAST");
+	for (size_t i = 0; i < prefixes_.size(); i++)
+	{
+		argv.push_back("PREFIX");
+		argv.push_back(prefixes_[i].c_str());
+	}
+
+	rr = request(ctl_, argv);
+	if (rr == NULL || rr->get_type() != REDIS_RESULT_STATUS)
+	{
+		const char* err = rr ? rr->get_error() : NULL;
+		logger_error("CLIENT TRACKING error: %s, server: %s",
+			err ? err : "no respond", addr_.c_str());
+		close();
+		return false;
+	}
+
+	// ٿ֮ǰݲյʧЧ֪ͨ
+	cache_.clear();
+	last_ping_ = time(NULL);
+	return true;
+}
+
+void* near_tracker::run()
+{
+	while (!stop_)
+	{
+		if (!sub_.conn.opened() && !open())
+		{
+			for (int i = 0; i < 10 && !stop_; i++)
+				acl_doze(100);
+			continue;
+		}
+
+		// жڼܶʧʧЧ֪ͨ
+		if (!check())
+		{
+			logger_warn("tracking broken, server: %s",
+				addr_.c_str());
+			close();
+			cache_.clear();
+		}
+	}
+
+	close();
+	return NULL;
+}
+
+bool near_tracker::check()
+{
+	const redis_result* rr;
+	time_t now = time(NULL);
+
+	if (now - last_ping_ >= PING_INTER)
+	{
+		last_ping_ = now;
+
+		std::vector<const char*> argv;
+		argv.push_back("PING");
+		rr = request(ctl_, argv);
+		if (rr == NULL || rr->get_type() != REDIS_RESULT_STATUS)
+			return false;
+	}
+
+	bool timedout = false;
+	rr = read_result(sub_, WAIT_TIMEOUT, &timedout);
+	if (rr == NULL)
+		return timedout;
+
+	on_message(rr);
+	return true;
+}
+
+void near_tracker::on_message(const redis_result* rr)
+{
+	if (rr->get_type() != REDIS_RESULT_ARRAY || rr->get_size() != 3)
+		return;
+
+	const redis_result* obj = rr->get_child(0);
+	if (obj == NULL || obj->get_type() != REDIS_RESULT_STRING)
+		return;
+
+	string buf;
+	obj->argv_to_string(buf);
+	if (strcasecmp(buf.c_str(), "message") != 0)
+		return;
+
+	obj = rr->get_child(2);
+	if (obj == NULL)
+		return;
+
+	if (obj->get_type() == REDIS_RESULT_ARRAY && obj->get_size() > 0)
+	{
+		size_t size;
+		const redis_result** children = obj->get_children(&size);
+		for (size_t i = 0; children != NULL && i < size; i++)
+		{
+			if (children[i]->get_type() != REDIS_RESULT_STRING)
+				continue;
+			children[i]->argv_to_string(buf);
+			cache_.invalidate(buf.c_str(), buf.length());
+		}
+	}
+	else if (obj->get_type() == REDIS_RESULT_STRING && obj->get_size() > 0)
+	{
+		obj->argv_to_string(buf);
+		cache_.invalidate(buf.c_str(), buf.length());
+	}
+	else
+		// յ֪ͨʾִ FLUSHALL/FLUSHDB
+		cache_.clear();
+}
+
+const redis_result* near_tracker::request(near_conn& c,
+	const std::vector<const char*>& argv)
+{
+	string req;
+	req.format("*%d\r\n", (int) argv.size());
+	for (size_t i = 0; i < argv.size(); i++)
+		req.format_append("$%d\r\n%s\r\n",
+			(int) strlen(argv[i]), argv[i]);
+
+	if (c.conn.write(req) == -1)
+	{
+		logger_error("write to redis(%s) error: %s",
+			addr_.c_str(), last_serror());
+		return NULL;
+	}
+
+	return read_result(c, 0, NULL);
+}
+
+const redis_result* near_tracker::read_result(near_conn& c, int timeout,
+	bool* timedout)
+{
+	// ʱʱ״̬´εʱͬһӦ
+	if (!c.parsing)
+	{
+		delete c.pool;
+		c.pool = NEW dbuf_pool();
+		c.parser.reset(c.pool);
+		c.parsing = true;
+	}
+
+	while (true)
+	{
+		if (c.off < c.len)
+		{
+			c.off += c.parser.update(c.buf + c.off, c.len - c.off);
+			if (c.parser.finished())
+			{
+				c.parsing = false;
+				return c.parser.get_result();
+			}
+			if (c.parser.failed())
+			{
+				logger_error("invalid respond, server: %s",
+					addr_.c_str());
+				c.parsing = false;
+				return NULL;
+			}
+		}
+
+		ACL_VSTREAM* vs = c.conn.get_vstream();
+		if (timeout > 0 && vs->read_cnt <= 0
+			&& acl_read_wait(ACL_VSTREAM_SOCK(vs), timeout) == -1)
+		{
+			if (timedout != NULL
+				&& acl_last_error() == ACL_ETIMEDOUT)
+			{
+				*timedout = true;
+			}
+			return NULL;
+		}
+
+		int ret = c.conn.read(c.buf, sizeof(c.buf), false);
+		if (ret == -1)
+		{
+			c.parsing = false;
+			return NULL;
+		}
+		c.len = (size_t) ret;
+		c.off = 0;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+struct redis_near_cache::near_node
+{
+	string key;
+	unsigned long long seq;
+	long long expire;
+	bool   has_value;
+	string value;
+	bool   has_all;
+	std::map<string, string> fields;
+	std::list<near_node*>::iterator it;
+};
+
+static long long now_ms()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (long long) now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+redis_near_cache::redis_near_cache(size_t max_keys /* = 10000 */,
+	int ttl /* = 60000 */)
+: max_keys_(max_keys > 0 ? max_keys : 10000)
+, ttl_(ttl)
+, seq_(0)
+, hits_(0)
+, misses_(0)
+{
+}
+
+redis_near_cache::~redis_near_cache()
+{
+	std::vector<near_tracker*>::iterator it = trackers_.begin();
+	for (; it != trackers_.end(); ++it)
+	{
+		(*it)->stop();
+		(*it)->wait();
+		delete *it;
+	}
+
+	clear();
+}
+
+bool redis_near_cache::track(const char* addr,
+	const std::vector<string>* prefixes /* = NULL */,
+	int conn_timeout /* = 10 */, int rw_timeout /* = 10 */)
+{
+	near_tracker* tracker = NEW near_tracker(*this, addr, prefixes,
+		conn_timeout, rw_timeout);
+	if (tracker->open() == false)
+	{
+		delete tracker;
+		return false;
+	}
+
+	tracker->set_detachable(false);
+	if (tracker->start() == false)
+	{
+		logger_error("start tracking thread error, server: %s", addr);
+		delete tracker;
+		return false;
+	}
+
+	lock_.lock();
+	trackers_.push_back(tracker);
+	lock_.unlock();
+	return true;
+}
+
+void redis_near_cache::invalidate(const char* key)
+{
+	invalidate(key, strlen(key));
+}
+
+void redis_near_cache::invalidate(const char* key, size_t len)
+{
+	string buf(key, len);
+
+	lock_.lock();
+	std::map<string, near_node*>::iterator it = nodes_.find(buf);
+	if (it != nodes_.end())
+		remove(it->second);
+	lock_.unlock();
+}
+
+void redis_near_cache::clear()
+{
+	lock_.lock();
+	while (!lru_.empty())
+		remove(lru_.back());
+	lock_.unlock();
+}
+
+size_t redis_near_cache::size()
+{
+	lock_.lock();
+	size_t n = nodes_.size();
+	lock_.unlock();
+	return n;
+}
+
+void redis_near_cache::remove(near_node* node)
+{
+	nodes_.erase(node->key);
+	lru_.erase(node->it);
+	delete node;
+}
+
+redis_near_cache::near_node* redis_near_cache::peek(const char* key,
+	size_t len, unsigned long long& seq)
+{
+	string buf(key, len);
+	near_node* node = NULL;
+
+	std::map<string, near_node*>::iterator it = nodes_.find(buf);
+	if (it != nodes_.end())
+	{
+		node = it->second;
+		if (ttl_ > 0 && node->expire <= now_ms())
+		{
+			remove(node);
+			node = NULL;
+		}
+		else
+			lru_.splice(lru_.begin(), lru_, node->it);
+	}
+
+	// δʱȴս㲢µţдݣڼ
+	// ֵʧЧʱ㱻ɾдʱҲͬŵĽ
+	if (node == NULL)
+	{
+		while (nodes_.size() >= max_keys_ && !lru_.empty())
+			remove(lru_.back());
+
+		node = NEW near_node;
+		node->key = buf;
+		node->seq = ++seq_;
+		node->expire = ttl_ > 0 ? now_ms() + ttl_ : 0;
+		node->has_value = false;
+		node->has_all = false;
+		lru_.push_front(node);
+		node->it = lru_.begin();
+		nodes_[buf] = node;
+	}
+
+	seq = node->seq;
+	return node;
+}
+
+redis_near_cache::near_node* redis_near_cache::find(const char* key,
+	size_t len, unsigned long long seq)
+{
+	string buf(key, len);
+	std::map<string, near_node*>::iterator it = nodes_.find(buf);
+	if (it == nodes_.end() || it->second->seq != seq)
+		return NULL;
+	return it->second;
+}
+
+bool redis_near_cache::get(const char* key, size_t len, string& out,
+	unsigned long long& seq)
+{
+	lock_.lock();
+	near_node* node = peek(key, len, seq);
+	if (node->has_value)
+	{
+		out = node->value;
+		hits_++;
+		lock_.unlock();
+		return true;
+	}
+
+	misses_++;
+	lock_.unlock();
+	return false;
+}
+
+void redis_near_cache::put(const char* key, size_t len, const string& value,
+	unsigned long long seq)
+{
+	lock_.lock();
+	near_node* node = find(key, len, seq);
+	if (node != NULL)
+	{
+		node->value = value;
+		node->has_value = true;
+	}
+	lock_.unlock();
+}
+
+bool redis_near_cache::hget(const char* key, size_t len, const char* name,
+	size_t name_len, string& out, unsigned long long& seq)
+{
+	string buf(name, name_len);
+
+	lock_.lock();
+	near_node* node = peek(key, len, seq);
+	std::map<string, string>::const_iterator cit = node->fields.find(buf);
+	if (cit != node->fields.end())
+	{
+		out = cit->second;
+		hits_++;
+		lock_.unlock();
+		return true;
+	}
+
+	misses_++;
+	lock_.unlock();
+	return false;
+}
+
+void redis_near_cache::hput(const char* key, size_t len, const char* name,
+	size_t name_len, const string& value, unsigned long long seq)
+{
+	string buf(name, name_len);
+
+	lock_.lock();
+	near_node* node = find(key, len, seq);
+	if (node != NULL)
+		node->fields[buf] = value;
+	lock_.unlock();
+}
+
+bool redis_near_cache::hgetall(const char* key, size_t len,
+	std::map<string, string>& out, unsigned long long& seq)
+{
+	lock_.lock();
+	near_node* node = peek(key, len, seq);
+	if (node->has_all)
+	{
+		out = node->fields;
+		hits_++;
+		lock_.unlock();
+		return true;
+	}
+
+	misses_++;
+	lock_.unlock();
+	return false;
+}
+
+void redis_near_cache::hputall(const char* key, size_t len,
+	const std::map<string, string>& attrs, unsigned long long seq)
+{
+	lock_.lock();
+	near_node* node = find(key, len, seq);
+	if (node != NULL)
+	{
+		node->fields = attrs;
+		node->has_all = true;
+	}
+	lock_.unlock();
+}
+
+} // namespace acl
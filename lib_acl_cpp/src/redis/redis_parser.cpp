@@ -0,0 +1,372 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "redis_parser.hpp"
+
+namespace acl
+{
+
+// ״̬Сݳе󳤶
+#define MAX_LINE	(1024 * 1024)
+
+// Ƭ洢ʱÿڴƬĳ(β \0)
+#define CHUNK_LENGTH	8192
+
+redis_parser::redis_parser()
+: status_(S_TYPE)
+, zero_copy_(false)
+, slice_(false)
+, type_(0)
+, line_(128)
+, pool_(NULL)
+, result_(NULL)
+, curr_(NULL)
+, data_ready_(false)
+, data_len_(0)
+, data_off_(0)
+, piece_(NULL)
+, piece_len_(0)
+, piece_off_(0)
+, crlf_(0)
+{
+}
+
+redis_parser::~redis_parser()
+{
+}
+
+void redis_parser::reset(dbuf_pool* pool)
+{
+	status_ = S_TYPE;
+	type_ = 0;
+	line_.clear();
+	pool_ = pool;
+	result_ = NULL;
+	curr_ = NULL;
+	data_ready_ = false;
+	data_len_ = 0;
+	data_off_ = 0;
+	piece_ = NULL;
+	piece_len_ = 0;
+	piece_off_ = 0;
+	crlf_ = 0;
+	stack_.clear();
+}
+
+size_t redis_parser::update(char* data, size_t len)
+{
+	acl_assert(pool_ != NULL);
+
+	size_t n = 0;
+
+	while (n < len)
+	{
+		switch (status_)
+		{
+		case S_TYPE:
+			n += parse_type(data + n, len - n);
+			break;
+		case S_LINE:
+			n += parse_line(data + n, len - n);
+			break;
+		case S_DATA:
+			n += parse_data(data + n, len - n);
+			break;
+		case S_DATA_CRLF:
+			n += parse_crlf(data + n, len - n);
+			break;
+		default:
+			return n;
+		}
+	}
+
+	return n;
+}
+
+size_t redis_parser::parse_type(const char* data, size_t len acl_unused)
+{
+	switch (*data)
+	{
+	case '-':	// ERROR
+	case '+':	// STATUS
+	case ':':	// INTEGER
+	case '$':	// STRING
+	case '*':	// ARRAY
+		type_ = *data;
+		line_.clear();
+		status_ = S_LINE;
+		break;
+	default:	// INVALID
+		logger_error("invalid first char: %c, %d", *data, *data);
+		status_ = S_ERROR;
+		break;
+	}
+
+	return 1;
+}
+
+size_t redis_parser::parse_line(char* data, size_t len)
+{
+	char* ptr = (char*) memchr(data, '\n', len);
+	if (ptr == NULL)
+	{
+		line_.append(data, len);
+		if (line_.length() > MAX_LINE)
+		{
+			logger_error("line too long: %d", (int) line_.length());
+			status_ = S_ERROR;
+		}
+		return len;
+	}
+
+	size_t n = ptr - data;
+
+	// 㿽ģʽ£ж뻺ʱֱãβ \r 
+	// \n Ϊ \0
+	if (zero_copy_ && line_.empty())
+	{
+		size_t size = n;
+		if (size > 0 && data[size - 1] == '\r')
+			size--;
+		data[size] = 0;
+		on_line(data, size, true);
+		return n + 1;
+	}
+
+	line_.append(data, n);
+
+	// ȥβ \r
+	if (!line_.empty() && line_[line_.length() - 1] == '\r')
+		line_.truncate(line_.length() - 1);
+
+	on_line(line_.c_str(), line_.length(), false);
+	return n + 1;
+}
+
+void redis_parser::on_line(const char* line, size_t len, bool inplace)
+{
+	redis_result* rr = new(pool_) redis_result(pool_);
+
+	switch (type_)
+	{
+	case '-':
+		rr->set_type(REDIS_RESULT_ERROR);
+		break;
+	case '+':
+		rr->set_type(REDIS_RESULT_STATUS);
+		break;
+	case ':':
+		rr->set_type(REDIS_RESULT_INTEGER);
+		break;
+	case '$':
+	{
+		rr->set_type(REDIS_RESULT_STRING);
+		int n = atoi(line);
+		if (n < 0)
+		{
+			on_object(rr);
+			return;
+		}
+
+		curr_ = rr;
+		data_ready_ = false;
+		data_len_ = (size_t) n;
+		data_off_ = 0;
+		piece_ = NULL;
+		status_ = S_DATA;
+		return;
+	}
+	case '*':
+	{
+		rr->set_type(REDIS_RESULT_ARRAY);
+		int count = atoi(line);
+		if (count <= 0)
+		{
+			on_object(rr);
+			return;
+		}
+
+		rr->set_size((size_t) count);
+
+		redis_frame frame;
+		frame.rr = rr;
+		frame.size = (size_t) count;
+		frame.idx = 0;
+		stack_.push_back(frame);
+		status_ = S_TYPE;
+		return;
+	}
+	default:
+		status_ = S_ERROR;
+		return;
+	}
+
+	// ״̬͵Ϊ
+	rr->set_size(1);
+	if (inplace)
+		rr->put(line, len);
+	else
+	{
+		char* buf = (char*) pool_->dbuf_alloc(len + 1);
+		memcpy(buf, line, len);
+		buf[len] = 0;
+		rr->put(buf, len);
+	}
+	on_object(rr);
+}
+
+bool redis_parser::begin_data(char* data, size_t len)
+{
+	data_ready_ = true;
+
+	// 㿽ģʽ£뻺ʱֱãݺ \r
+	// Ϊ \0ȼֽ
+	if (zero_copy_ && data != NULL && data_len_ < len)
+	{
+		if (data[data_len_] != '\r')
+		{
+			logger_error("invalid data end: %d", data[data_len_]);
+			crlf_ = 0;
+			status_ = S_ERROR;
+			return true;
+		}
+		data[data_len_] = 0;
+		curr_->set_size(1);
+		curr_->put(data, data_len_);
+		data_off_ = data_len_;
+		crlf_ = 1;
+		status_ = S_DATA_CRLF;
+		return true;
+	}
+
+	size_t size = 1;
+	if (slice_ && data_len_ > 0)
+		size = (data_len_ + CHUNK_LENGTH - 2) / (CHUNK_LENGTH - 1);
+	curr_->set_size(size);
+
+	if (data_len_ > 0)
+		return false;
+
+	char* buf = (char*) pool_->dbuf_alloc(1);
+	*buf = 0;
+	curr_->put(buf, 0);
+	crlf_ = 0;
+	status_ = S_DATA_CRLF;
+	return true;
+}
+
+char* redis_parser::peek_piece(size_t& size)
+{
+	if (piece_ == NULL)
+	{
+		piece_len_ = data_len_ - data_off_;
+		if (slice_ && piece_len_ > CHUNK_LENGTH - 1)
+			piece_len_ = CHUNK_LENGTH - 1;
+		piece_off_ = 0;
+		piece_ = (char*) pool_->dbuf_alloc(piece_len_ + 1);
+	}
+
+	size = piece_len_ - piece_off_;
+	return piece_ + piece_off_;
+}
+
+void redis_parser::put_piece(size_t n)
+{
+	piece_off_ += n;
+	data_off_ += n;
+
+	if (piece_off_ == piece_len_)
+	{
+		piece_[piece_len_] = 0;
+		curr_->put(piece_, piece_len_);
+		piece_ = NULL;
+	}
+
+	if (data_off_ == data_len_)
+	{
+		crlf_ = 0;
+		status_ = S_DATA_CRLF;
+	}
+}
+
+size_t redis_parser::parse_data(char* data, size_t len)
+{
+	if (!data_ready_ && begin_data(data, len))
+		return data_len_ + crlf_;
+
+	size_t n = 0;
+	while (n < len && status_ == S_DATA)
+	{
+		size_t size;
+		char* buf = peek_piece(size);
+		if (size > len - n)
+			size = len - n;
+		memcpy(buf, data + n, size);
+		put_piece(size);
+		n += size;
+	}
+
+	return n;
+}
+
+char* redis_parser::get_space(size_t& size)
+{
+	if (status_ != S_DATA)
+		return NULL;
+	if (!data_ready_ && begin_data(NULL, 0))
+		return NULL;
+	return peek_piece(size);
+}
+
+void redis_parser::put_space(size_t n)
+{
+	acl_assert(status_ == S_DATA && piece_ != NULL);
+	acl_assert(n <= piece_len_ - piece_off_);
+	put_piece(n);
+}
+
+size_t redis_parser::parse_crlf(const char* data, size_t len)
+{
+	// ݺΪ \r\n߿ֱܷλ
+	size_t n = 0;
+	while (n < len && crlf_ < 2)
+	{
+		if (data[n] != "\r\n"[crlf_])
+		{
+			logger_error("invalid data end: %d", data[n]);
+			status_ = S_ERROR;
+			return n;
+		}
+		crlf_++;
+		n++;
+	}
+
+	if (crlf_ == 2)
+		on_object(curr_);
+	return n;
+}
+
+void redis_parser::on_object(redis_result* rr)
+{
+	// ϵĶӽУҲˣ
+	// һӣֱĶ
+	while (!stack_.empty())
+	{
+		redis_frame& frame = stack_.back();
+		frame.rr->put(rr, frame.idx++);
+		if (frame.idx < frame.size)
+		{
+			status_ = S_TYPE;
+			return;
+		}
+
+		rr = frame.rr;
+		stack_.pop_back();
+	}
+
+	result_ = rr;
+	status_ = S_FINISH;
+}
+
+} // namespace acl
@@ -0,0 +1,148 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <vector>
+#include "acl_cpp/stdlib/string.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+class redis_result;
+
+/**
+ *  redis Э(RESP)ݿԷֶ룬ÿⳤȣ
+ * м״ֱ̬һӦϣ reset
+ * ָڴϷ䣬ڷ IO Ķص
+ */
+class ACL_CPP_API redis_parser
+{
+public:
+	redis_parser();
+	~redis_parser();
+
+	/**
+	 * ʼһµӦ
+	 * @param pool {dbuf_pool*} ʹõڴ
+	 */
+	void reset(dbuf_pool* pool);
+
+	/**
+	 * 㿽ģʽڸģʽλ뻺ڵݼַ
+	 * ֱӱãβ \r  \n Ϊ \0
+	 * 뻺дڲܶڽһӦڽ
+	 * ڴϷ䣻Խ뻺ȻĬΪģʽ
+	 * @param on {bool}
+	 */
+	void set_zero_copy(bool on)
+	{
+		zero_copy_ = on;
+	}
+
+	/**
+	 * Ƿ񽫴ַݷֳɶڴƬ洢ÿڴƬ
+	 * Ϊ 8191 ֽڣĬΪ
+	 * @param on {bool}
+	 */
+	void set_slice(bool on)
+	{
+		slice_ = on;
+	}
+
+	/**
+	 * ݽнһӦϻʱֹͣ
+	 * @param data {char*} ݵַ㿽ģʽ¸ݻᱻ޸
+	 * @param len {size_t} ݳ
+	 * @return {size_t} رѵݳȣʣһ
+	 *  Ӧ reset ٴ
+	 */
+	size_t update(char* data, size_t len);
+
+	/**
+	 * ڽַʱôźݵڴռ䣬߿Խ
+	 * ֱӶУȻ put_space ֪ͨӶԴ
+	 * Ķο
+	 * @param size {size_t&} ſÿռĳ
+	 * @return {char*} ǰڽַʱ NULL
+	 */
+	char* get_space(size_t& size);
+
+	/**
+	 * ֪ͨѾ get_space صĿռд
+	 * @param n {size_t} дݳȣô get_space صĳ
+	 */
+	void put_space(size_t n);
+
+	/**
+	 * һӦǷѾ
+	 * @return {bool}
+	 */
+	bool finished() const
+	{
+		return status_ == S_FINISH;
+	}
+
+	/**
+	 * Ƿݸʽʧ
+	 * @return {bool}
+	 */
+	bool failed() const
+	{
+		return status_ == S_ERROR;
+	}
+
+	/**
+	 * ϺӦ
+	 * @return {redis_result*} δʱ NULL
+	 */
+	redis_result* get_result() const
+	{
+		return status_ == S_FINISH ? result_ : NULL;
+	}
+
+private:
+	typedef enum
+	{
+		S_TYPE,
+		S_LINE,
+		S_DATA,
+		S_DATA_CRLF,
+		S_FINISH,
+		S_ERROR,
+	} status_t;
+
+	struct redis_frame
+	{
+		redis_result* rr;
+		size_t size;
+		size_t idx;
+	};
+
+	status_t status_;
+	bool     zero_copy_;
+	bool     slice_;
+	char     type_;
+	string   line_;
+	dbuf_pool* pool_;
+	redis_result* result_;
+	redis_result* curr_;
+	bool     data_ready_;
+	size_t   data_len_;
+	size_t   data_off_;
+	char*    piece_;
+	size_t   piece_len_;
+	size_t   piece_off_;
+	size_t   crlf_;
+	std::vector<redis_frame> stack_;
+
+	size_t parse_type(const char* data, size_t len);
+	size_t parse_line(char* data, size_t len);
+	size_t parse_data(char* data, size_t len);
+	size_t parse_crlf(const char* data, size_t len);
+	void on_line(const char* line, size_t len, bool inplace);
+	void on_object(redis_result* rr);
+	bool begin_data(char* data, size_t len);
+	char* peek_piece(size_t& size);
+	void put_piece(size_t n);
+};
+
+} // namespace acl
@@ -0,0 +1,466 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/redis/redis_client.hpp"
+#include "acl_cpp/redis/redis_client_pool.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_pipeline.hpp"
+#include "redis_request.hpp"
+
+namespace acl
+{
+
+#define	EQ(x, y) !strncasecmp((x), (y), sizeof(y) -1)
+#define	ASKING_CMD	"*1\r\n$6\r\nASKING\r\n"
+
+redis_pipeline::redis_pipeline()
+: redis_command(NULL)
+, flushed_(false)
+{
+}
+
+redis_pipeline::redis_pipeline(redis_client* conn)
+: redis_command(conn)
+, flushed_(false)
+{
+}
+
+redis_pipeline::redis_pipeline(redis_client_cluster* cluster, size_t max_conns)
+: redis_command(cluster, max_conns)
+, flushed_(false)
+{
+}
+
+redis_pipeline::~redis_pipeline()
+{
+}
+
+redis_pipeline& redis_pipeline::add(const char* cmd, const char* key,
+	const std::vector<string>& args)
+{
+	prepare();
+	build(cmd, key, args);
+	add_request(key_slot(key));
+	return *this;
+}
+
+redis_pipeline& redis_pipeline::add(const char* cmd, const char* key,
+	const std::vector<const char*>& args)
+{
+	prepare();
+	build(cmd, key, args);
+	add_request(key_slot(key));
+	return *this;
+}
+
+redis_pipeline& redis_pipeline::add(const char* cmd, const char* key,
+	const std::map<string, string>& attrs)
+{
+	prepare();
+	build(cmd, key, attrs);
+	add_request(key_slot(key));
+	return *this;
+}
+
+redis_pipeline& redis_pipeline::add(const char* cmd, const char* key,
+	const char* args[], const size_t lens[], size_t argc)
+{
+	prepare();
+	build(cmd, key, args, lens, argc);
+	add_request(key_slot(key));
+	return *this;
+}
+
+redis_pipeline& redis_pipeline::add(const char* cmd, const char* key,
+	const char* args[], size_t argc)
+{
+	prepare();
+	build(cmd, key, args, argc);
+	add_request(key_slot(key));
+	return *this;
+}
+
+void redis_pipeline::prepare()
+{
+	// һѾ͹һӦ
+	if (flushed_)
+	{
+		cmds_.clear();
+		cmds_buf_.clear();
+		clear();
+		flushed_ = false;
+	}
+}
+
+redis_pipeline& redis_pipeline::add_slot(int slot, size_t argc,
+	const char* argv[], size_t lens[])
+{
+	prepare();
+	build_request(argc, argv, lens);
+	add_request(slot);
+	return *this;
+}
+
+int redis_pipeline::key_slot(const char* key)
+{
+	// ڼȺģʽ²Żϣֵ
+	slot_ = -1;
+	if (key != NULL && *key != 0)
+		hash_slot(key);
+	return slot_;
+}
+
+void redis_pipeline::add_request(int slot)
+{
+	pipeline_cmd cmd;
+	cmd.off = cmds_buf_.length();
+
+	// װõ׷
+	if (slice_req_)
+	{
+		const struct iovec* iov = request_obj_->get_iovec();
+		size_t size = request_obj_->get_size();
+		for (size_t i = 0; i < size; i++)
+			cmds_buf_.append((const char*) iov[i].iov_base,
+				iov[i].iov_len);
+	}
+	else
+		cmds_buf_.append(request_buf_->c_str(), request_buf_->length());
+
+	cmd.len = cmds_buf_.length() - cmd.off;
+
+	cmd.slot = slot;
+	cmd.asking = false;
+	cmd.addr = NULL;
+	cmd.result = NULL;
+
+	cmds_.push_back(cmd);
+}
+
+size_t redis_pipeline::get_size() const
+{
+	return cmds_.size();
+}
+
+const redis_result* redis_pipeline::get_child(size_t i) const
+{
+	return i < cmds_.size() ? cmds_[i].result : NULL;
+}
+
+bool redis_pipeline::flush()
+{
+	flushed_ = true;
+	if (cmds_.empty())
+		return true;
+
+	// ʹ clear ͷűռõڴ
+	used_++;
+
+	std::vector<pipeline_cmd>::iterator it = cmds_.begin();
+	for (; it != cmds_.end(); ++it)
+	{
+		(*it).asking = false;
+		(*it).addr = NULL;
+		(*it).result = NULL;
+	}
+
+	if (cluster_ != NULL)
+		return flush_cluster();
+	else if (conn_ != NULL)
+		return flush_client();
+
+	logger_error("no redis_client or redis_client_cluster set");
+	return false;
+}
+
+bool redis_pipeline::flush_client()
+{
+	// ͨһдͣȻ˳ȡеӦ
+	const redis_result* result = conn_->run(pool_, cmds_buf_, cmds_.size());
+	if (result == NULL)
+	{
+		logger_error("run pipeline error, cmds: %d",
+			(int) cmds_.size());
+		return false;
+	}
+
+	size_t size;
+	const redis_result** children = result->get_children(&size);
+	if (children == NULL || size != cmds_.size())
+	{
+		logger_error("invalid result size: %d, cmds: %d",
+			(int) size, (int) cmds_.size());
+		return false;
+	}
+
+	for (size_t i = 0; i < size; i++)
+		cmds_[i].result = children[i];
+	return true;
+}
+
+redis_client_pool* redis_pipeline::get_pool(const pipeline_cmd& cmd)
+{
+	redis_client_pool* conns;
+
+	// ضʱֱʹضĿַ
+	if (cmd.addr != NULL)
+	{
+		conns = (redis_client_pool*) cluster_->get(cmd.addr);
+		if (conns == NULL)
+			conns = (redis_client_pool*)
+				&cluster_->set(cmd.addr, (int) max_conns_);
+		return conns;
+	}
+
+	if (cmd.slot >= 0 && (conns = cluster_->peek_slot(cmd.slot)) != NULL)
+		return conns;
+
+	return (redis_client_pool*) cluster_->peek();
+}
+
+bool redis_pipeline::flush_cluster()
+{
+	std::vector<size_t> pending, retry;
+	pending.reserve(cmds_.size());
+	for (size_t i = 0; i < cmds_.size(); i++)
+		pending.push_back(i);
+
+	int   n = 0;
+
+	while (!pending.empty() && n++ < redirect_max_)
+	{
+		//  redis з飬ͬһһԷ
+		std::map<redis_client_pool*, std::vector<size_t> > nodes;
+		std::map<int, redis_client_pool*> slots;
+		std::vector<size_t>::const_iterator cit = pending.begin();
+		for (; cit != pending.end(); ++cit)
+		{
+			const pipeline_cmd& cmd = cmds_[*cit];
+			redis_client_pool* conns;
+
+			// ͬһϣ۵ڱб뷢ͬһ㣬򵱹ϣ
+			// ӳδ֪ʱӵпǰִ
+			if (cmd.addr == NULL && cmd.slot >= 0)
+			{
+				std::map<int, redis_client_pool*>::iterator sit =
+					slots.find(cmd.slot);
+				if (sit != slots.end())
+					conns = sit->second;
+				else
+				{
+					conns = get_pool(cmd);
+					slots[cmd.slot] = conns;
+				}
+			}
+			else
+				conns = get_pool(cmd);
+
+			if (conns == NULL)
+			{
+				logger_error("no redis node for slot: %d",
+					cmd.slot);
+				continue;
+			}
+			nodes[conns].push_back(*cit);
+		}
+
+		retry.clear();
+		bool doze = false;
+
+		// н㷢ȻһȡӦʹ㲢д
+		std::vector<pipeline_node> sent;
+		sent.reserve(nodes.size());
+
+		std::map<redis_client_pool*, std::vector<size_t> >::iterator it;
+		for (it = nodes.begin(); it != nodes.end(); ++it)
+		{
+			sent.push_back(pipeline_node());
+			pipeline_node& node = sent.back();
+			node.conns = it->first;
+			node.idx.swap(it->second);
+			if (!send_node(node, retry, doze))
+				sent.pop_back();
+		}
+
+		std::vector<pipeline_node>::iterator nit;
+		for (nit = sent.begin(); nit != sent.end(); ++nit)
+			read_node(*nit, retry, doze);
+
+		pending.swap(retry);
+
+		if (!pending.empty() && doze && redirect_sleep_ > 0)
+		{
+			logger("redirect %d, left cmds: %d, waiting ...",
+				n, (int) pending.size());
+			acl_doze(redirect_sleep_);
+		}
+	}
+
+	if (!pending.empty())
+	{
+		logger_warn("too many redirect: %d, max: %d, left cmds: %d",
+			n, redirect_max_, (int) pending.size());
+		return false;
+	}
+
+	std::vector<pipeline_cmd>::const_iterator cit = cmds_.begin();
+	for (; cit != cmds_.end(); ++cit)
+	{
+		if ((*cit).result == NULL)
+			return false;
+	}
+	return true;
+}
+
+void redis_pipeline::retry_node(const pipeline_node& node,
+	std::vector<size_t>& retry)
+{
+	std::vector<size_t>::const_iterator cit;
+	for (cit = node.idx.begin(); cit != node.idx.end(); ++cit)
+	{
+		cluster_->clear_slot(cmds_[*cit].slot);
+		cmds_[*cit].addr = NULL;
+		cmds_[*cit].asking = false;
+		retry.push_back(*cit);
+	}
+}
+
+bool redis_pipeline::send_node(pipeline_node& node, std::vector<size_t>& retry,
+	bool& doze)
+{
+	node.conn = (redis_client*) node.conns->peek();
+	if (node.conn == NULL)
+	{
+		// ӳضΪ״̬һѡ
+		node.conns->set_alive(false);
+		retry_node(node, retry);
+		doze = true;
+		return false;
+	}
+
+	// ýϲһݰ ASK ضǰҪ ASKING
+	string buf(1024);
+	node.nreply = 0;
+
+	std::vector<size_t>::const_iterator cit;
+	for (cit = node.idx.begin(); cit != node.idx.end(); ++cit)
+	{
+		const pipeline_cmd& cmd = cmds_[*cit];
+		if (cmd.asking)
+		{
+			buf.append(ASKING_CMD, sizeof(ASKING_CMD) - 1);
+			node.nreply++;
+		}
+		buf.append(cmds_buf_.c_str() + cmd.off, cmd.len);
+		node.nreply++;
+	}
+
+	if (node.conn->send_request(buf))
+		return true;
+
+	logger_error("send pipeline to %s error, cmds: %d",
+		node.conns->get_addr(), (int) node.idx.size());
+
+	node.conns->set_alive(false);
+	node.conns->put(node.conn, false);
+	retry_node(node, retry);
+	doze = true;
+	return false;
+}
+
+void redis_pipeline::read_node(pipeline_node& node, std::vector<size_t>& retry,
+	bool& doze)
+{
+	redis_client* conn = node.conn;
+	redis_client_pool* conns = node.conns;
+	const redis_result* result = conn->read_respond(pool_, node.nreply);
+
+	size_t size = 0;
+	const redis_result** children = NULL;
+
+	// 쳣ϿӳΪ״̬һ
+	if (conn->eof())
+	{
+		conns->set_alive(false);
+		conns->put(conn, false);
+	}
+	else
+	{
+		conns->put(conn, true);
+		if (result != NULL)
+			children = result->get_children(&size);
+	}
+
+	if (children == NULL || size != node.nreply)
+	{
+		logger_error("run pipeline on %s error, cmds: %d",
+			conns->get_addr(), (int) node.idx.size());
+		retry_node(node, retry);
+		doze = true;
+		return;
+	}
+
+	std::vector<size_t>::const_iterator cit;
+	size_t k = 0;
+
+	for (cit = node.idx.begin(); cit != node.idx.end(); ++cit)
+	{
+		pipeline_cmd& cmd = cmds_[*cit];
+
+		//  ASKING Ӧ
+		if (cmd.asking)
+		{
+			cmd.asking = false;
+			k++;
+		}
+
+		cmd.result = children[k++];
+		cmd.addr = NULL;
+
+		if (cmd.result->get_type() != REDIS_RESULT_ERROR)
+			continue;
+
+		const char* ptr = cmd.result->get_error();
+		if (ptr == NULL || *ptr == 0)
+			continue;
+
+		if (EQ(ptr, "MOVED"))
+		{
+			const char* addr = get_addr(ptr);
+			if (addr == NULL)
+			{
+				logger_warn("MOVED invalid, ptr: %s", ptr);
+				continue;
+			}
+
+			// ¹ϣַӳϵ̨߳ˢ
+			// ȺϢ
+			cluster_->set_slot(cmd.slot, addr);
+			cluster_->request_refresh();
+			cmd.addr = addr;
+			retry.push_back(*cit);
+		}
+		else if (EQ(ptr, "ASK"))
+		{
+			const char* addr = get_addr(ptr);
+			if (addr == NULL)
+			{
+				logger_warn("ASK invalid, ptr: %s", ptr);
+				continue;
+			}
+
+			cmd.addr = addr;
+			cmd.asking = true;
+			retry.push_back(*cit);
+		}
+		else if (EQ(ptr, "CLUSTERDOWN"))
+		{
+			cluster_->clear_slot(cmd.slot);
+			retry.push_back(*cit);
+			doze = true;
+		}
+	}
+}
+
+} // namespace acl
@@ -215,8 +215,13 @@ int redis_result::argv_to_string(char* buf, size_t size) const
 redis_result& redis_result::put(const redis_result* rr, size_t idx)
 {
 	if (children_ == NULL)
+	{
+		// 数组元素个数已知时一次性分配，避免大数组逐次倍增时的重复拷贝
+		if (size_ >= children_size_)
+			children_size_ = size_ + 1;
 		children_ = (const redis_result**) pool_->dbuf_alloc(
 				sizeof(redis_result*) * children_size_);
+	}
 	else if (idx == 0)
 		children_idx_ = 0;
 
@@ -34,7 +34,7 @@ bool redis_script::eval_status(const char* script,
 	const std::vector<string>& args,
 	const char* success /* = "OK" */)
 {
-	const redis_result* result = eval_cmd(script, "EVAL", keys, args);
+	const redis_result* result = eval_cmd("EVAL", script, keys, args);
 	if (result == NULL)
 		return false;
 	const char* status = result->get_status();
@@ -48,7 +48,7 @@ bool redis_script::eval_number(const char* script,
 	const std::vector<string>& args,
 	int& out)
 {
-	const redis_result* result = eval_cmd(script, "EVAL", keys, args);
+	const redis_result* result = eval_cmd("EVAL", script, keys, args);
 	if (result == NULL)
 		return false;
 
@@ -62,7 +62,7 @@ bool redis_script::eval_number64(const char* script,
 	const std::vector<string>& args,
 	long long int& out)
 {
-	const redis_result* result = eval_cmd(script, "EVAL", keys, args);
+	const redis_result* result = eval_cmd("EVAL", script, keys, args);
 	if (result == NULL)
 		return false;
 
@@ -76,7 +76,7 @@ int redis_script::eval_string(const char* script,
 	const std::vector<string>& args,
 	string& out)
 {
-	const redis_result* result = eval_cmd(script, "EVAL", keys, args);
+	const redis_result* result = eval_cmd("EVAL", script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -87,7 +87,7 @@ bool redis_script::evalsha_status(const char* script,
 	const std::vector<string>& keys, const std::vector<string>& args,
 	const char* success /* = "OK" */)
 {
-	const redis_result* result = eval_cmd(script, "EVALSHA", keys, args);
+	const redis_result* result = eval_cmd("EVALSHA", script, keys, args);
 	if (result == NULL)
 		return false;
 	const char* status = result->get_status();
@@ -101,7 +101,7 @@ bool redis_script::evalsha_number(const char* script,
 	const std::vector<string>& args,
 	int& out)
 {
-	const redis_result* result = eval_cmd(script, "EVALSHA", keys, args);
+	const redis_result* result = eval_cmd("EVALSHA", script, keys, args);
 	if (result == NULL)
 		return false;
 
@@ -115,7 +115,7 @@ bool redis_script::evalsha_number64(const char* script,
 	const std::vector<string>& args,
 	long long int& out)
 {
-	const redis_result* result = eval_cmd(script, "EVALSHA", keys, args);
+	const redis_result* result = eval_cmd("EVALSHA", script, keys, args);
 	if (result == NULL)
 		return false;
 
@@ -129,7 +129,7 @@ int redis_script::evalsha_string(const char* script,
 	const std::vector<string>& args,
 	string& out)
 {
-	const redis_result* result = eval_cmd(script, "EVALSHA", keys, args);
+	const redis_result* result = eval_cmd("EVALSHA", script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -212,7 +212,7 @@ int redis_script::eval_status(const char* cmd, const char* script,
 	std::vector<bool>& out,
 	const char* success /* = "OK" */)
 {
-	const redis_result* result = eval_cmd(script, cmd, keys, args);
+	const redis_result* result = eval_cmd(cmd, script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -246,7 +246,7 @@ int redis_script::eval_number(const char* cmd, const char* script,
 	std::vector<int>& out,
 	std::vector<bool>& status)
 {
-	const redis_result* result = eval_cmd(script, cmd, keys, args);
+	const redis_result* result = eval_cmd(cmd, script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -280,7 +280,7 @@ long long int redis_script::eval_number64(const char* cmd, const char* script,
 	std::vector<long long int>& out,
 	std::vector<bool>& status)
 {
-	const redis_result* result = eval_cmd(script, cmd, keys, args);
+	const redis_result* result = eval_cmd(cmd, script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -313,7 +313,7 @@ int redis_script::eval_strings(const char* cmd, const char* script,
 	const std::vector<string>& args,
 	std::vector<string>& out)
 {
-	const redis_result* result = eval_cmd(script, cmd, keys, args);
+	const redis_result* result = eval_cmd(cmd, script, keys, args);
 	if (result == NULL)
 		return -1;
 
@@ -384,7 +384,8 @@ const redis_result* redis_script::eval_cmd(const char* cmd,
 	lens[1] = strlen(script);
 
 	char argc_s[LONG_LEN];
-	safe_snprintf(argc_s, sizeof(argc_s), "%lu", (unsigned long) argc);
+	safe_snprintf(argc_s, sizeof(argc_s), "%lu",
+		(unsigned long) keys.size());
 	argv[2] = argc_s;
 	lens[2] = strlen(argc_s);
 
@@ -429,7 +430,8 @@ const redis_result* redis_script::eval_cmd(const char* cmd,
 	lens[1] = strlen(script);
 
 	char argc_s[LONG_LEN];
-	safe_snprintf(argc_s, sizeof(argc_s), "%lu", (unsigned long) argc);
+	safe_snprintf(argc_s, sizeof(argc_s), "%lu",
+		(unsigned long) keys.size());
 	argv[2] = argc_s;
 	lens[2] = strlen(argc_s);
 
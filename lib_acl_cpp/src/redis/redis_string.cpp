@@ -5,6 +5,7 @@
 #include "acl_cpp/redis/redis_client.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_string.hpp"
+#include "acl_cpp/redis/redis_near_cache.hpp"
 
 namespace acl
 {
@@ -173,6 +174,11 @@ bool redis_string::get(const char* key, string& buf)
 
 bool redis_string::get(const char* key, size_t len, string& buf)
 {
+	redis_near_cache* cache = get_near_cache();
+	unsigned long long seq = 0;
+	if (cache != NULL && cache->get(key, len, buf, seq))
+		return true;
+
 	const char* argv[2];
 	size_t lens[2];
 
@@ -184,7 +190,12 @@ bool redis_string::get(const char* key, size_t len, string& buf)
 
 	hash_slot(key, len);
 	build_request(2, argv, lens);
-	return get_string(buf) >= 0 ? true : false;
+	if (get_string(buf) < 0)
+		return false;
+
+	if (cache != NULL)
+		cache->put(key, len, buf, seq);
+	return true;
 }
 
 const redis_result* redis_string::get(const char* key)
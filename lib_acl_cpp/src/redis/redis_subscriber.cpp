@@ -0,0 +1,909 @@
+#include "acl_stdafx.hpp"
+#include <set>
+#ifdef ACL_UNIX
+#include <poll.h>
+#endif
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/util.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/stream/socket_stream.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_client_pool.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_subscriber.hpp"
+#include "redis_parser.hpp"
+
+namespace acl
+{
+
+// ӿж() PING б
+#define PING_INTER	5
+
+// ӽʧܺԼ()
+#define RETRY_INTER	1
+
+// IO ̵߳ȴݵĳʱʱ()ʱǷҪ˳
+#define WAIT_INTER	100
+
+// ÿЯƵ
+#define MAX_ARGS	1000
+
+// Ϣһνʹõڴ
+#define MAX_PARSED	128
+
+struct sub_msg
+{
+	string channel;
+	string msg;
+	string pattern;
+	bool   has_pattern;
+};
+
+/**
+ * һӣconn ֻ IO ̴߳ȡرգ߳ lock ı
+ * ֱ׽д붩޸ĵƵģʽ
+ */
+class sub_shard
+{
+public:
+	sub_shard(size_t n)
+	: idx(n)
+	, conn(NULL)
+	, tries(0)
+	, opened(false)
+	, pool(NULL)
+	, parsing(false)
+	, parsed(0)
+	, len(0)
+	, off(0)
+	, last_read(0)
+	, ping_sent(0)
+	, next_open(0)
+	{
+	}
+
+	~sub_shard()
+	{
+		delete conn;
+		delete pool;
+	}
+
+	size_t idx;
+	locker lock;
+	socket_stream* conn;
+	string addr;
+	unsigned tries;
+	bool   opened;
+	std::set<string> channels;
+	std::set<string> patterns;
+
+	redis_parser parser;
+	dbuf_pool* pool;
+	bool   parsing;
+	int    parsed;
+	char   buf[65536];
+	size_t len;
+	size_t off;
+	time_t last_read;
+	time_t ping_sent;
+	time_t next_open;
+};
+
+/**
+ * ̣߳IO ߳ȽϢݴ pending_ УÿֶȡһԵ
+ * ĶУԼ̻߳ѵĴ
+ */
+class sub_worker : public thread
+{
+public:
+	sub_worker(redis_subscriber& sub)
+	: sub_(sub)
+	, stop_(false)
+	, handled_(0)
+	{
+		acl_pthread_mutex_init(&lock_, NULL);
+		acl_pthread_cond_init(&cond_, NULL);
+		acl_pthread_cond_init(&full_, NULL);
+	}
+
+	~sub_worker()
+	{
+		free_msgs(pending_);
+		free_msgs(queue_);
+		acl_pthread_cond_destroy(&full_);
+		acl_pthread_cond_destroy(&cond_);
+		acl_pthread_mutex_destroy(&lock_);
+	}
+
+	//  IO ߳е
+	void add(sub_msg* msg)
+	{
+		pending_.push_back(msg);
+	}
+
+	//  IO ߳еãʱȴ̴߳
+	void flush(size_t max)
+	{
+		if (pending_.empty())
+			return;
+
+		acl_pthread_mutex_lock(&lock_);
+		while (max > 0 && queue_.size() >= max && !stop_)
+			acl_pthread_cond_wait(&full_, &lock_);
+
+		bool wakeup = queue_.empty();
+		if (wakeup)
+			queue_.swap(pending_);
+		else
+		{
+			queue_.insert(queue_.end(), pending_.begin(),
+				pending_.end());
+			pending_.clear();
+		}
+
+		if (wakeup)
+			acl_pthread_cond_signal(&cond_);
+		acl_pthread_mutex_unlock(&lock_);
+	}
+
+	// ڹ߳еãȡдϢֹͣҶΪʱ false
+	bool pop(std::vector<sub_msg*>& out, size_t done)
+	{
+		acl_pthread_mutex_lock(&lock_);
+		handled_ += done;
+		while (queue_.empty() && !stop_)
+			acl_pthread_cond_wait(&cond_, &lock_);
+
+		out.swap(queue_);
+		acl_pthread_cond_broadcast(&full_);
+		acl_pthread_mutex_unlock(&lock_);
+		return !out.empty();
+	}
+
+	void stop()
+	{
+		acl_pthread_mutex_lock(&lock_);
+		stop_ = true;
+		acl_pthread_cond_signal(&cond_);
+		acl_pthread_cond_broadcast(&full_);
+		acl_pthread_mutex_unlock(&lock_);
+	}
+
+	unsigned long long get_handled()
+	{
+		acl_pthread_mutex_lock(&lock_);
+		unsigned long long n = handled_;
+		acl_pthread_mutex_unlock(&lock_);
+		return n;
+	}
+
+protected:
+	// ി麯
+	void* run()
+	{
+		sub_.run_worker(this);
+		return NULL;
+	}
+
+private:
+	redis_subscriber& sub_;
+	acl_pthread_mutex_t lock_;
+	acl_pthread_cond_t cond_;
+	acl_pthread_cond_t full_;
+	std::vector<sub_msg*> pending_;
+	std::vector<sub_msg*> queue_;
+	bool stop_;
+	unsigned long long handled_;
+
+	static void free_msgs(std::vector<sub_msg*>& msgs)
+	{
+		for (size_t i = 0; i < msgs.size(); i++)
+			delete msgs[i];
+		msgs.clear();
+	}
+};
+
+class sub_reader : public thread
+{
+public:
+	sub_reader(redis_subscriber& sub) : sub_(sub) {}
+	~sub_reader() {}
+
+protected:
+	// ി麯
+	void* run()
+	{
+		sub_.run_reader();
+		return NULL;
+	}
+
+private:
+	redis_subscriber& sub_;
+};
+
+static unsigned hash_name(const string& name)
+{
+	return acl_hash_crc32(name.c_str(), name.length());
+}
+
+//  names еƵģʽװ
+static void build_request(const char* cmd, const std::vector<string>& names,
+	string& out)
+{
+	size_t cmdlen = strlen(cmd);
+
+	for (size_t i = 0; i < names.size(); i += MAX_ARGS)
+	{
+		size_t n = names.size() - i;
+		if (n > MAX_ARGS)
+			n = MAX_ARGS;
+
+		out.format_append("*%d\r\n$%d\r\n%s\r\n", (int) n + 1,
+			(int) cmdlen, cmd);
+		for (size_t j = i; j < i + n; j++)
+		{
+			out.format_append("$%d\r\n", (int) names[j].length());
+			out.append(names[j].c_str(), names[j].length());
+			out.append("\r\n", 2);
+		}
+	}
+}
+
+// Ѽ
+static bool send_request(sub_shard* shard, const string& req, int timeout)
+{
+	if (shard->conn == NULL || req.empty())
+		return shard->conn != NULL;
+
+	ACL_SOCKET fd = ACL_VSTREAM_SOCK(shard->conn->get_vstream());
+	if (acl_write_buf(fd, req.c_str(), (int) req.length(), timeout) == -1)
+	{
+		logger_error("write to redis(%s) error: %s",
+			shard->addr.c_str(), last_serror());
+		return false;
+	}
+	return true;
+}
+
+// ȴ׽еһɶready дſɶ׽±
+static void wait_readable(const std::vector<ACL_SOCKET>& socks, int timeout,
+	std::vector<size_t>& ready)
+{
+	if (socks.empty())
+	{
+		acl_doze(timeout);
+		return;
+	}
+
+#ifdef ACL_UNIX
+	std::vector<struct pollfd> fds(socks.size());
+	for (size_t i = 0; i < socks.size(); i++)
+	{
+		fds[i].fd = socks[i];
+		fds[i].events = POLLIN;
+		fds[i].revents = 0;
+	}
+
+	if (poll(&fds[0], (nfds_t) fds.size(), timeout) <= 0)
+		return;
+
+	for (size_t i = 0; i < fds.size(); i++)
+	{
+		if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+			ready.push_back(i);
+	}
+#else
+	fd_set rset;
+	FD_ZERO(&rset);
+
+	ACL_SOCKET max_fd = 0;
+	for (size_t i = 0; i < socks.size(); i++)
+	{
+		FD_SET(socks[i], &rset);
+		if (socks[i] > max_fd)
+			max_fd = socks[i];
+	}
+
+	struct timeval tv;
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+
+	if (select((int) max_fd + 1, &rset, NULL, NULL, &tv) <= 0)
+		return;
+
+	for (size_t i = 0; i < socks.size(); i++)
+	{
+		if (FD_ISSET(socks[i], &rset))
+			ready.push_back(i);
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+redis_subscriber::redis_subscriber(const char* addr, size_t shards /* = 1 */,
+	size_t threads /* = 4 */, int conn_timeout /* = 10 */,
+	int rw_timeout /* = 10 */)
+: addr_(addr)
+, cluster_(NULL)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+{
+	init(shards, threads);
+}
+
+redis_subscriber::redis_subscriber(redis_client_cluster* cluster,
+	size_t shards /* = 1 */, size_t threads /* = 4 */,
+	int conn_timeout /* = 10 */, int rw_timeout /* = 10 */)
+: cluster_(cluster)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+{
+	init(shards, threads);
+}
+
+void redis_subscriber::init(size_t shards, size_t threads)
+{
+	max_queue_ = 100000;
+	stop_ = false;
+	received_ = 0;
+	reconnects_ = 0;
+	handled_ = 0;
+	reader_ = NULL;
+
+	if (shards == 0)
+		shards = 1;
+	if (threads == 0)
+		threads = 1;
+
+	for (size_t i = 0; i < shards; i++)
+		shards_.push_back(NEW sub_shard(i));
+
+	// ̶߳ start ʱ˴¼
+	workers_.resize(threads, NULL);
+}
+
+redis_subscriber::~redis_subscriber()
+{
+	stop();
+
+	std::vector<sub_shard*>::iterator it = shards_.begin();
+	for (; it != shards_.end(); ++it)
+		delete *it;
+}
+
+void redis_subscriber::set_max_queue(size_t max)
+{
+	max_queue_ = max;
+}
+
+bool redis_subscriber::start()
+{
+	if (reader_ != NULL)
+	{
+		logger_error("subscriber already started");
+		return false;
+	}
+
+	lock_.lock();
+	stop_ = false;
+	lock_.unlock();
+
+	for (size_t i = 0; i < shards_.size(); i++)
+	{
+		if (!open(shards_[i]))
+			shards_[i]->next_open = time(NULL) + RETRY_INTER;
+	}
+
+	for (size_t i = 0; i < workers_.size(); i++)
+	{
+		workers_[i] = NEW sub_worker(*this);
+		workers_[i]->set_detachable(false);
+		if (!workers_[i]->start())
+		{
+			logger_error("start worker thread error");
+			delete workers_[i];
+			workers_[i] = NULL;
+			stop();
+			return false;
+		}
+	}
+
+	reader_ = NEW sub_reader(*this);
+	reader_->set_detachable(false);
+	if (!reader_->start())
+	{
+		logger_error("start IO thread error");
+		delete reader_;
+		reader_ = NULL;
+		stop();
+		return false;
+	}
+
+	return true;
+}
+
+void redis_subscriber::stop()
+{
+	lock_.lock();
+	stop_ = true;
+	lock_.unlock();
+
+	if (reader_ != NULL)
+	{
+		reader_->wait();
+		delete reader_;
+		reader_ = NULL;
+	}
+
+	// IO ߳˳ѽϢУ̴߳˳
+	for (size_t i = 0; i < workers_.size(); i++)
+	{
+		if (workers_[i] == NULL)
+			continue;
+		workers_[i]->stop();
+		workers_[i]->wait();
+		handled_ += workers_[i]->get_handled();
+		delete workers_[i];
+		workers_[i] = NULL;
+	}
+
+	for (size_t i = 0; i < shards_.size(); i++)
+	{
+		close(shards_[i]);
+		shards_[i]->opened = false;
+	}
+}
+
+bool redis_subscriber::stopped() const
+{
+	locker& lock = const_cast<locker&>(lock_);
+	lock.lock();
+	bool stop = stop_;
+	lock.unlock();
+	return stop;
+}
+
+unsigned long long redis_subscriber::get_received() const
+{
+	locker& lock = const_cast<locker&>(lock_);
+	lock.lock();
+	unsigned long long n = received_;
+	lock.unlock();
+	return n;
+}
+
+unsigned long long redis_subscriber::get_reconnects() const
+{
+	locker& lock = const_cast<locker&>(lock_);
+	lock.lock();
+	unsigned long long n = reconnects_;
+	lock.unlock();
+	return n;
+}
+
+unsigned long long redis_subscriber::get_handled() const
+{
+	unsigned long long n = handled_;
+	for (size_t i = 0; i < workers_.size(); i++)
+	{
+		if (workers_[i] != NULL)
+			n += workers_[i]->get_handled();
+	}
+	return n;
+}
+
+bool redis_subscriber::subscribe(const char* channel)
+{
+	std::vector<string> channels;
+	channels.push_back(channel);
+	return subop("SUBSCRIBE", channels);
+}
+
+bool redis_subscriber::subscribe(const std::vector<string>& channels)
+{
+	return subop("SUBSCRIBE", channels);
+}
+
+bool redis_subscriber::unsubscribe(const char* channel)
+{
+	std::vector<string> channels;
+	channels.push_back(channel);
+	return subop("UNSUBSCRIBE", channels);
+}
+
+bool redis_subscriber::unsubscribe(const std::vector<string>& channels)
+{
+	return subop("UNSUBSCRIBE", channels);
+}
+
+bool redis_subscriber::psubscribe(const char* pattern)
+{
+	std::vector<string> patterns;
+	patterns.push_back(pattern);
+	return subop("PSUBSCRIBE", patterns);
+}
+
+bool redis_subscriber::psubscribe(const std::vector<string>& patterns)
+{
+	return subop("PSUBSCRIBE", patterns);
+}
+
+bool redis_subscriber::punsubscribe(const char* pattern)
+{
+	std::vector<string> patterns;
+	patterns.push_back(pattern);
+	return subop("PUNSUBSCRIBE", patterns);
+}
+
+bool redis_subscriber::punsubscribe(const std::vector<string>& patterns)
+{
+	return subop("PUNSUBSCRIBE", patterns);
+}
+
+bool redis_subscriber::subop(const char* cmd, const std::vector<string>& names)
+{
+	bool pattern = *cmd == 'P';
+	bool add = strstr(cmd, "UNSUB") == NULL;
+
+	// ϣֵƵģʽ
+	std::vector<std::vector<string> > groups(shards_.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		if (names[i].empty())
+			continue;
+		groups[hash_name(names[i]) % shards_.size()].push_back(names[i]);
+	}
+
+	bool ret = true;
+	for (size_t i = 0; i < groups.size(); i++)
+	{
+		if (groups[i].empty())
+			continue;
+
+		sub_shard* shard = shards_[i];
+		std::set<string>& saved = pattern ? shard->patterns
+			: shard->channels;
+		std::vector<string> changed;
+
+		shard->lock.lock();
+
+		for (size_t j = 0; j < groups[i].size(); j++)
+		{
+			const string& name = groups[i][j];
+			if (add ? saved.insert(name).second
+				: saved.erase(name) > 0)
+			{
+				changed.push_back(name);
+			}
+		}
+
+		// δʱ¼ӽͳһ
+		if (!changed.empty() && shard->conn != NULL)
+		{
+			string req;
+			build_request(cmd, changed, req);
+			if (!send_request(shard, req, rw_timeout_))
+				ret = false;
+		}
+
+		shard->lock.unlock();
+	}
+
+	return ret;
+}
+
+void redis_subscriber::get_masters(std::vector<string>& out)
+{
+	std::set<string> addrs;
+
+	int max_slot = cluster_->get_max_slot();
+	for (int i = 0; i < max_slot; i++)
+	{
+		redis_client_pool* pool = cluster_->peek_slot(i);
+		if (pool != NULL)
+			addrs.insert(pool->get_addr());
+	}
+
+	out.assign(addrs.begin(), addrs.end());
+}
+
+bool redis_subscriber::open(sub_shard* shard)
+{
+	string addr;
+
+	if (cluster_ != NULL)
+	{
+		std::vector<string> masters;
+		get_masters(masters);
+		if (masters.empty())
+		{
+			logger_error("no master node in cluster");
+			return false;
+		}
+
+		// ʧʱγ
+		addr = masters[(shard->idx + shard->tries) % masters.size()];
+	}
+	else
+		addr = addr_;
+
+	socket_stream* conn = NEW socket_stream;
+	if (!conn->open(addr, conn_timeout_, rw_timeout_))
+	{
+		logger_error("connect redis %s error: %s",
+			addr.c_str(), last_serror());
+		delete conn;
+		shard->tries++;
+		if (cluster_ != NULL)
+			cluster_->request_refresh();
+		return false;
+	}
+
+	shard->lock.lock();
+
+	std::vector<string> names;
+	string req;
+
+	names.assign(shard->channels.begin(), shard->channels.end());
+	build_request("SUBSCRIBE", names, req);
+	names.assign(shard->patterns.begin(), shard->patterns.end());
+	build_request("PSUBSCRIBE", names, req);
+
+	shard->conn = conn;
+	shard->addr = addr;
+	if (!send_request(shard, req, rw_timeout_))
+	{
+		shard->conn = NULL;
+		shard->lock.unlock();
+		delete conn;
+		shard->tries++;
+		return false;
+	}
+
+	bool reopened = shard->opened;
+	int nchannels = (int) shard->channels.size();
+	int npatterns = (int) shard->patterns.size();
+	shard->opened = true;
+	shard->tries = 0;
+	shard->parsing = false;
+	shard->len = 0;
+	shard->off = 0;
+	shard->last_read = time(NULL);
+	shard->ping_sent = 0;
+
+	shard->lock.unlock();
+
+	if (reopened)
+	{
+		lock_.lock();
+		reconnects_++;
+		lock_.unlock();
+		logger("resubscribed %d channels and %d patterns on %s",
+			nchannels, npatterns, addr.c_str());
+		on_reconnect(addr);
+	}
+	return true;
+}
+
+void redis_subscriber::close(sub_shard* shard)
+{
+	shard->lock.lock();
+	delete shard->conn;
+	shard->conn = NULL;
+	shard->parsing = false;
+	shard->len = 0;
+	shard->off = 0;
+	shard->lock.unlock();
+}
+
+void redis_subscriber::check_ping(sub_shard* shard, time_t now)
+{
+	if (shard->ping_sent > 0)
+	{
+		if (now - shard->ping_sent >= rw_timeout_)
+		{
+			logger_warn("no respond of PING from %s",
+				shard->addr.c_str());
+			close(shard);
+		}
+		return;
+	}
+
+	if (now - shard->last_read < PING_INTER)
+		return;
+
+	string req("*1\r\n$4\r\nPING\r\n");
+
+	shard->lock.lock();
+	bool ok = send_request(shard, req, rw_timeout_);
+	shard->lock.unlock();
+
+	if (ok)
+		shard->ping_sent = now;
+	else
+		close(shard);
+}
+
+void redis_subscriber::run_reader()
+{
+	std::vector<sub_shard*> polled, ready;
+	std::vector<ACL_SOCKET> socks;
+	std::vector<size_t> readable;
+
+	while (!stopped())
+	{
+		time_t now = time(NULL);
+
+		polled.clear();
+		ready.clear();
+		socks.clear();
+		readable.clear();
+
+		for (size_t i = 0; i < shards_.size(); i++)
+		{
+			sub_shard* shard = shards_[i];
+			if (shard->conn == NULL)
+			{
+				if (now < shard->next_open)
+					continue;
+				if (!open(shard))
+				{
+					shard->next_open = now + RETRY_INTER;
+					continue;
+				}
+			}
+
+			check_ping(shard, now);
+			if (shard->conn == NULL)
+				continue;
+
+			// Ķʱȴ
+			ACL_VSTREAM* vs = shard->conn->get_vstream();
+			if (shard->off < shard->len || vs->read_cnt > 0)
+				ready.push_back(shard);
+			else
+			{
+				polled.push_back(shard);
+				socks.push_back(ACL_VSTREAM_SOCK(vs));
+			}
+		}
+
+		wait_readable(socks, ready.empty() ? WAIT_INTER : 0, readable);
+		for (size_t i = 0; i < readable.size(); i++)
+			ready.push_back(polled[readable[i]]);
+
+		for (size_t i = 0; i < ready.size(); i++)
+		{
+			if (read_shard(ready[i]))
+				continue;
+
+			logger_warn("subscribing connection broken, server: %s",
+				ready[i]->addr.c_str());
+			close(ready[i]);
+			ready[i]->next_open = 0;
+		}
+
+		for (size_t i = 0; i < workers_.size(); i++)
+			workers_[i]->flush(max_queue_);
+	}
+
+	for (size_t i = 0; i < workers_.size(); i++)
+		workers_[i]->flush(0);
+}
+
+bool redis_subscriber::read_shard(sub_shard* shard)
+{
+	if (shard->off >= shard->len)
+	{
+		int ret = shard->conn->read(shard->buf, sizeof(shard->buf),
+			false);
+		if (ret == -1)
+			return false;
+
+		shard->len = (size_t) ret;
+		shard->off = 0;
+		shard->last_read = time(NULL);
+		shard->ping_sent = 0;
+	}
+
+	while (shard->off < shard->len)
+	{
+		// Ϣ󼴱ԽڵڴؿԶڸ
+		if (!shard->parsing)
+		{
+			if (shard->pool == NULL || shard->parsed >= MAX_PARSED)
+			{
+				delete shard->pool;
+				shard->pool = NEW dbuf_pool();
+				shard->parsed = 0;
+			}
+			shard->parser.reset(shard->pool);
+			shard->parsing = true;
+		}
+
+		shard->off += shard->parser.update(shard->buf + shard->off,
+			shard->len - shard->off);
+
+		if (shard->parser.failed())
+		{
+			logger_error("invalid respond, server: %s",
+				shard->addr.c_str());
+			return false;
+		}
+		if (!shard->parser.finished())
+			break;
+
+		shard->parsing = false;
+		shard->parsed++;
+		on_result(shard->parser.get_result());
+	}
+
+	return true;
+}
+
+void redis_subscriber::on_result(const redis_result* rr)
+{
+	// ȷϼ PING Ӧ
+	if (rr == NULL || rr->get_type() != REDIS_RESULT_ARRAY)
+		return;
+
+	size_t size;
+	const redis_result** children = rr->get_children(&size);
+	if (children == NULL || size < 3)
+		return;
+
+	size_t len;
+	const char* kind = children[0]->get(0, &len);
+	if (kind == NULL)
+		return;
+
+	sub_msg* msg;
+	if (size == 3 && len == 7 && strncasecmp(kind, "message", 7) == 0)
+	{
+		msg = NEW sub_msg;
+		msg->has_pattern = false;
+		children[1]->argv_to_string(msg->channel);
+		children[2]->argv_to_string(msg->msg);
+	}
+	else if (size == 4 && len == 8
+		&& strncasecmp(kind, "pmessage", 8) == 0)
+	{
+		msg = NEW sub_msg;
+		msg->has_pattern = true;
+		children[1]->argv_to_string(msg->pattern);
+		children[2]->argv_to_string(msg->channel);
+		children[3]->argv_to_string(msg->msg);
+	}
+	else
+		return;
+
+	lock_.lock();
+	received_++;
+	lock_.unlock();
+	workers_[hash_name(msg->channel) % workers_.size()]->add(msg);
+}
+
+void redis_subscriber::run_worker(sub_worker* worker)
+{
+	std::vector<sub_msg*> msgs;
+	size_t done = 0;
+
+	while (worker->pop(msgs, done))
+	{
+		for (size_t i = 0; i < msgs.size(); i++)
+		{
+			sub_msg* msg = msgs[i];
+			on_message(msg->channel, msg->msg, msg->has_pattern
+				? msg->pattern.c_str() : NULL);
+			delete msg;
+		}
+
+		done = msgs.size();
+		msgs.clear();
+	}
+}
+
+} // namespace acl
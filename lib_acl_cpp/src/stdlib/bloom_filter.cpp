@@ -0,0 +1,169 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/bloom_filter.hpp"
+
+namespace acl
+{
+
+bloom_filter::bloom_filter(size_t capacity, double fp_rate /* = 0.01 */)
+{
+	bloom_ = acl_bloom_create(capacity, fp_rate);
+}
+
+bloom_filter::~bloom_filter()
+{
+	acl_bloom_free(bloom_);
+}
+
+bloom_filter& bloom_filter::add(const void* key, size_t len)
+{
+	acl_bloom_add(bloom_, key, len);
+	return *this;
+}
+
+bloom_filter& bloom_filter::add(const char* key)
+{
+	return add(key, strlen(key));
+}
+
+bool bloom_filter::maybe_exists(const void* key, size_t len) const
+{
+	return acl_bloom_test(bloom_, key, len) != 0;
+}
+
+bool bloom_filter::maybe_exists(const char* key) const
+{
+	return maybe_exists(key, strlen(key));
+}
+
+void bloom_filter::reset()
+{
+	acl_bloom_reset(bloom_);
+}
+
+#ifdef WIN32
+unsigned __int64 bloom_filter::count() const
+#else
+unsigned long long bloom_filter::count() const
+#endif
+{
+	return acl_bloom_count(bloom_);
+}
+
+void bloom_filter::save(string& out) const
+{
+	acl_bloom_dump(bloom_, out.vstring());
+}
+
+bool bloom_filter::load(const string& in)
+{
+	ACL_BLOOM* bloom = acl_bloom_load(in.c_str(), in.length());
+	if (bloom == NULL)
+		return false;
+	acl_bloom_free(bloom_);
+	bloom_ = bloom;
+	return true;
+}
+
+bool bloom_filter::save_file(const char* path) const
+{
+	return acl_bloom_save(bloom_, path) == 0;
+}
+
+bool bloom_filter::load_file(const char* path)
+{
+	ACL_BLOOM* bloom = acl_bloom_open(path);
+	if (bloom == NULL)
+		return false;
+	acl_bloom_free(bloom_);
+	bloom_ = bloom;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+cuckoo_filter::cuckoo_filter(size_t capacity)
+{
+	cuckoo_ = acl_cuckoo_create(capacity);
+}
+
+cuckoo_filter::~cuckoo_filter()
+{
+	acl_cuckoo_free(cuckoo_);
+}
+
+bool cuckoo_filter::add(const void* key, size_t len)
+{
+	return acl_cuckoo_add(cuckoo_, key, len) == 0;
+}
+
+bool cuckoo_filter::add(const char* key)
+{
+	return add(key, strlen(key));
+}
+
+bool cuckoo_filter::del(const void* key, size_t len)
+{
+	return acl_cuckoo_del(cuckoo_, key, len) == 0;
+}
+
+bool cuckoo_filter::del(const char* key)
+{
+	return del(key, strlen(key));
+}
+
+bool cuckoo_filter::maybe_exists(const void* key, size_t len) const
+{
+	return acl_cuckoo_test(cuckoo_, key, len) != 0;
+}
+
+bool cuckoo_filter::maybe_exists(const char* key) const
+{
+	return maybe_exists(key, strlen(key));
+}
+
+void cuckoo_filter::reset()
+{
+	acl_cuckoo_reset(cuckoo_);
+}
+
+#ifdef WIN32
+unsigned __int64 cuckoo_filter::count() const
+#else
+unsigned long long cuckoo_filter::count() const
+#endif
+{
+	return acl_cuckoo_count(cuckoo_);
+}
+
+void cuckoo_filter::save(string& out) const
+{
+	acl_cuckoo_dump(cuckoo_, out.vstring());
+}
+
+bool cuckoo_filter::load(const string& in)
+{
+	ACL_CUCKOO* cuckoo = acl_cuckoo_load(in.c_str(), in.length());
+	if (cuckoo == NULL)
+		return false;
+	acl_cuckoo_free(cuckoo_);
+	cuckoo_ = cuckoo;
+	return true;
+}
+
+bool cuckoo_filter::save_file(const char* path) const
+{
+	return acl_cuckoo_save(cuckoo_, path) == 0;
+}
+
+bool cuckoo_filter::load_file(const char* path)
+{
+	ACL_CUCKOO* cuckoo = acl_cuckoo_open(path);
+	if (cuckoo == NULL)
+		return false;
+	acl_cuckoo_free(cuckoo_);
+	cuckoo_ = cuckoo;
+	return true;
+}
+
+} // namespace acl
@@ -0,0 +1,597 @@
+#include "acl_stdafx.hpp"
+#include <errno.h>
+#include "acl_cpp/stdlib/snprintf.hpp"
+#include "acl_cpp/stdlib/xml.hpp"
+#include "acl_cpp/stdlib/gson_helper.hpp"
+
+#ifdef WIN32
+# define STRTOLL	_strtoi64
+#else
+# define STRTOLL	strtoll
+#endif
+
+namespace acl
+{
+
+bool gson_error(json_reader& in, const char* field, const char* msg,
+	string* err)
+{
+	if (err == NULL)
+		return false;
+
+	const char* reason = in.get_error();
+	err->format("%s: %s", field, *reason ? reason : msg);
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// ܺСָ֣Ҳܳ long long ķΧ
+
+static bool get_integer(const char* s, long long int& n)
+{
+	if (*s == 0 || strpbrk(s, ".eE") != NULL)
+		return false;
+
+	char* end;
+	errno = 0;
+	n = STRTOLL(s, &end, 10);
+	if (errno == ERANGE || end == s)
+		return false;
+
+	while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n')
+		end++;
+	return *end == 0;
+}
+
+static bool get_uinteger(const char* s, unsigned long long int& n)
+{
+	while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n')
+		s++;
+	if (*s == '-' || *s == 0 || strpbrk(s, ".eE") != NULL)
+		return false;
+
+	char* end;
+	errno = 0;
+#ifdef WIN32
+	n = _strtoui64(s, &end, 10);
+#else
+	n = strtoull(s, &end, 10);
+#endif
+	if (errno == ERANGE || end == s)
+		return false;
+
+	while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n')
+		end++;
+	return *end == 0;
+}
+
+template<typename T>
+static bool json_signed(json_reader& in, json_token_t token, T& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_NUMBER)
+		return gson_error(in, field, "number expected", err);
+
+	long long int n;
+	if (!get_integer(in.get_text().c_str(), n) || (long long int) (T) n != n)
+		return gson_error(in, field, "invalid integer", err);
+	v = (T) n;
+	return true;
+}
+
+template<typename T>
+static bool json_unsigned(json_reader& in, json_token_t token, T& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_NUMBER)
+		return gson_error(in, field, "number expected", err);
+
+	unsigned long long int n;
+	if (!get_uinteger(in.get_text().c_str(), n)
+		|| (unsigned long long int) (T) n != n)
+	{
+		return gson_error(in, field, "invalid integer", err);
+	}
+	v = (T) n;
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, bool& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_BOOL)
+		return gson_error(in, field, "bool expected", err);
+	v = in.get_bool();
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, short& v,
+	const char* field, string* err)
+{
+	return json_signed(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, unsigned short& v,
+	const char* field, string* err)
+{
+	return json_unsigned(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, int& v,
+	const char* field, string* err)
+{
+	return json_signed(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, unsigned int& v,
+	const char* field, string* err)
+{
+	return json_unsigned(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, long& v,
+	const char* field, string* err)
+{
+	return json_signed(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, unsigned long& v,
+	const char* field, string* err)
+{
+	return json_unsigned(in, token, v, field, err);
+}
+
+#ifdef WIN32
+bool gson_get(json_reader& in, json_token_t token, __int64& v,
+	const char* field, string* err)
+#else
+bool gson_get(json_reader& in, json_token_t token, long long int& v,
+	const char* field, string* err)
+#endif
+{
+	return json_signed(in, token, v, field, err);
+}
+
+#ifdef WIN32
+bool gson_get(json_reader& in, json_token_t token, unsigned __int64& v,
+	const char* field, string* err)
+#else
+bool gson_get(json_reader& in, json_token_t token, unsigned long long int& v,
+	const char* field, string* err)
+#endif
+{
+	return json_unsigned(in, token, v, field, err);
+}
+
+bool gson_get(json_reader& in, json_token_t token, float& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_NUMBER)
+		return gson_error(in, field, "number expected", err);
+	v = (float) in.get_double();
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, double& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_NUMBER)
+		return gson_error(in, field, "number expected", err);
+	v = in.get_double();
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, string& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_STRING)
+		return gson_error(in, field, "string expected", err);
+	v = in.get_text();
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, std::string& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_STRING)
+		return gson_error(in, field, "string expected", err);
+	v.assign(in.get_text().c_str(), in.get_text().length());
+	return true;
+}
+
+bool gson_get(json_reader& in, json_token_t token, std::vector<bool>& v,
+	const char* field, string* err)
+{
+	if (token == JSON_TOKEN_NULL)
+		return true;
+	if (token != JSON_TOKEN_BEGIN_ARRAY)
+		return gson_error(in, field, "array expected", err);
+
+	while ((token = in.next()) != JSON_TOKEN_END_ARRAY)
+	{
+		bool b = false;
+		if (!gson_get(in, token, b, field, err))
+			return false;
+		v.push_back(b);
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void gson_put(json_writer& out, bool v)
+{
+	out.value(v);
+}
+
+void gson_put(json_writer& out, short v)
+{
+	out.value((int) v);
+}
+
+void gson_put(json_writer& out, unsigned short v)
+{
+	out.value((int) v);
+}
+
+void gson_put(json_writer& out, int v)
+{
+	out.value(v);
+}
+
+void gson_put(json_writer& out, unsigned int v)
+{
+	out.value((long long int) v);
+}
+
+void gson_put(json_writer& out, long v)
+{
+	out.value((long long int) v);
+}
+
+void gson_put(json_writer& out, unsigned long v)
+{
+	gson_put(out, (unsigned long long int) v);
+}
+
+#ifdef WIN32
+void gson_put(json_writer& out, __int64 v)
+#else
+void gson_put(json_writer& out, long long int v)
+#endif
+{
+	out.value(v);
+}
+
+#ifdef WIN32
+void gson_put(json_writer& out, unsigned __int64 v)
+#else
+void gson_put(json_writer& out, unsigned long long int v)
+#endif
+{
+	char buf[32];
+	int  len = safe_snprintf(buf, sizeof(buf), "%llu", v);
+	out.raw(buf, len);
+}
+
+// float ľ 0.1f Ϊ 0.10000000149011612
+
+static int float_format(char* buf, size_t size, float v)
+{
+	int len = safe_snprintf(buf, size, "%.7g", v);
+	if ((float) strtod(buf, NULL) != v)
+		len = safe_snprintf(buf, size, "%.9g", v);
+	return len;
+}
+
+void gson_put(json_writer& out, float v)
+{
+	if (v != v || v - v != 0)
+	{
+		out.value_null();
+		return;
+	}
+
+	char buf[32];
+	out.raw(buf, float_format(buf, sizeof(buf), v));
+}
+
+void gson_put(json_writer& out, double v)
+{
+	out.value(v);
+}
+
+void gson_put(json_writer& out, const string& v)
+{
+	out.value(v.c_str(), v.length());
+}
+
+void gson_put(json_writer& out, const std::string& v)
+{
+	out.value(v.c_str(), v.size());
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool gson_xml_error(const char* field, const char* msg, string* err)
+{
+	if (err)
+		err->format("%s: %s", field, msg);
+	return false;
+}
+
+xml_node* gson_xml_root(xml& x)
+{
+	xml_node& root = x.get_root();
+
+	for (xml_node* node = root.first_child(); node != NULL;
+		node = root.next_child())
+	{
+		if (node->tag_name() == NULL)
+			continue;
+		if ((node->get_xml_node()->flag & ACL_XML_F_META) == 0)
+			return node;
+	}
+
+	return NULL;
+}
+
+static const char* xml_text(xml_node& node)
+{
+	const char* text = node.text();
+	if (text == NULL)
+		return "";
+	while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')
+		text++;
+	return text;
+}
+
+template<typename T>
+static bool xml_signed(xml_node& node, T& v, const char* field, string* err)
+{
+	long long int n;
+	if (!get_integer(xml_text(node), n) || (long long int) (T) n != n)
+		return gson_xml_error(field, "invalid integer", err);
+	v = (T) n;
+	return true;
+}
+
+template<typename T>
+static bool xml_unsigned(xml_node& node, T& v, const char* field,
+	string* err)
+{
+	unsigned long long int n;
+	if (!get_uinteger(xml_text(node), n)
+		|| (unsigned long long int) (T) n != n)
+	{
+		return gson_xml_error(field, "invalid integer", err);
+	}
+	v = (T) n;
+	return true;
+}
+
+bool gson_xml_get(xml_node& node, bool& v, const char* field, string* err)
+{
+	const char* text = xml_text(node);
+
+	if (strncmp(text, "true", 4) == 0 || *text == '1')
+		v = true;
+	else if (strncmp(text, "false", 5) == 0 || *text == '0')
+		v = false;
+	else
+		return gson_xml_error(field, "bool expected", err);
+	return true;
+}
+
+bool gson_xml_get(xml_node& node, short& v, const char* field, string* err)
+{
+	return xml_signed(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, unsigned short& v, const char* field,
+	string* err)
+{
+	return xml_unsigned(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, int& v, const char* field, string* err)
+{
+	return xml_signed(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, unsigned int& v, const char* field,
+	string* err)
+{
+	return xml_unsigned(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, long& v, const char* field, string* err)
+{
+	return xml_signed(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, unsigned long& v, const char* field,
+	string* err)
+{
+	return xml_unsigned(node, v, field, err);
+}
+
+#ifdef WIN32
+bool gson_xml_get(xml_node& node, __int64& v, const char* field,
+	string* err)
+#else
+bool gson_xml_get(xml_node& node, long long int& v, const char* field,
+	string* err)
+#endif
+{
+	return xml_signed(node, v, field, err);
+}
+
+#ifdef WIN32
+bool gson_xml_get(xml_node& node, unsigned __int64& v, const char* field,
+	string* err)
+#else
+bool gson_xml_get(xml_node& node, unsigned long long int& v,
+	const char* field, string* err)
+#endif
+{
+	return xml_unsigned(node, v, field, err);
+}
+
+bool gson_xml_get(xml_node& node, float& v, const char* field, string* err)
+{
+	double d;
+	if (!gson_xml_get(node, d, field, err))
+		return false;
+	v = (float) d;
+	return true;
+}
+
+bool gson_xml_get(xml_node& node, double& v, const char* field, string* err)
+{
+	const char* text = xml_text(node);
+	char* end;
+
+	v = strtod(text, &end);
+	if (end == text)
+		return gson_xml_error(field, "number expected", err);
+	while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n')
+		end++;
+	if (*end != 0)
+		return gson_xml_error(field, "number expected", err);
+	return true;
+}
+
+// xml ʵתɴ˴
+
+bool gson_xml_get(xml_node& node, string& v, const char*, string*)
+{
+	const char* text = node.text();
+
+	v.clear();
+	if (text != NULL)
+		acl_xml_decode(text, v.vstring());
+	return true;
+}
+
+bool gson_xml_get(xml_node& node, std::string& v, const char* field,
+	string* err)
+{
+	string buf;
+	if (!gson_xml_get(node, buf, field, err))
+		return false;
+	v.assign(buf.c_str(), buf.length());
+	return true;
+}
+
+bool gson_xml_add(xml_node& node, std::vector<bool>& v, const char* field,
+	string* err)
+{
+	bool b = false;
+	if (!gson_xml_get(node, b, field, err))
+		return false;
+	v.push_back(b);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void gson_xml_put(string& out, const char* tag, bool v)
+{
+	out.format_append("<%s>%s</%s>", tag, v ? "true" : "false", tag);
+}
+
+void gson_xml_put(string& out, const char* tag, short v)
+{
+	out.format_append("<%s>%d</%s>", tag, (int) v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, unsigned short v)
+{
+	out.format_append("<%s>%u</%s>", tag, (unsigned int) v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, int v)
+{
+	out.format_append("<%s>%d</%s>", tag, v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, unsigned int v)
+{
+	out.format_append("<%s>%u</%s>", tag, v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, long v)
+{
+	out.format_append("<%s>%ld</%s>", tag, v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, unsigned long v)
+{
+	out.format_append("<%s>%lu</%s>", tag, v, tag);
+}
+
+#ifdef WIN32
+void gson_xml_put(string& out, const char* tag, __int64 v)
+#else
+void gson_xml_put(string& out, const char* tag, long long int v)
+#endif
+{
+	out.format_append("<%s>%lld</%s>", tag, v, tag);
+}
+
+#ifdef WIN32
+void gson_xml_put(string& out, const char* tag, unsigned __int64 v)
+#else
+void gson_xml_put(string& out, const char* tag, unsigned long long int v)
+#endif
+{
+	out.format_append("<%s>%llu</%s>", tag, v, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, float v)
+{
+	char buf[32];
+	float_format(buf, sizeof(buf), v);
+	out.format_append("<%s>%s</%s>", tag, buf, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, double v)
+{
+	char buf[32];
+	safe_snprintf(buf, sizeof(buf), "%.15g", v);
+	if (strtod(buf, NULL) != v)
+		safe_snprintf(buf, sizeof(buf), "%.17g", v);
+	out.format_append("<%s>%s</%s>", tag, buf, tag);
+}
+
+void gson_xml_put(string& out, const char* tag, const string& v)
+{
+	out.format_append("<%s>", tag);
+	acl_xml_encode(v.c_str(), out.vstring());
+	out.format_append("</%s>", tag);
+}
+
+void gson_xml_put(string& out, const char* tag, const std::string& v)
+{
+	out.format_append("<%s>", tag);
+	acl_xml_encode(v.c_str(), out.vstring());
+	out.format_append("</%s>", tag);
+}
+
+} // namespace acl
@@ -63,6 +63,7 @@ bool json_node::set_tag(const char* name)
 	if (node_me_->ltag == NULL || ACL_VSTRING_LEN(node_me_->ltag) == 0)
 		return false;
 	acl_vstring_strcpy(node_me_->ltag, name);
+	node_me_->json->tag_dirty = 1;
 	return true;
 }
 
@@ -87,6 +88,16 @@ const string& json_node::to_string(void)
 	return *buf_;
 }
 
+void json_node::build_msgpack(string& out) const
+{
+	(void) acl_json_node_build_msgpack(node_me_, out.vstring());
+}
+
+void json_node::build_cbor(string& out) const
+{
+	(void) acl_json_node_build_cbor(node_me_, out.vstring());
+}
+
 json_node& json_node::add_child(json_node* child,
 	bool return_child /* = false */)
 {
@@ -249,6 +260,7 @@ json::json(const char* data /* = NULL */)
 	node_tmp_ = NULL;
 	buf_ = NULL;
 	iter_ = NULL;
+	slice_ = NULL;
 	if (data && *data)
 		update(data);
 }
@@ -260,6 +272,7 @@ json::json(const json_node& node)
 	node_tmp_ = NULL;
 	buf_ = NULL;
 	iter_ = NULL;
+	slice_ = NULL;
 }
 
 json::~json(void)
@@ -275,6 +288,8 @@ json::~json(void)
 		delete buf_;
 	if (iter_)
 		acl_myfree(iter_);
+	if (slice_)
+		acl_slice_pool_destroy(slice_);
 }
 
 json& json::part_word(bool on)
@@ -286,14 +301,61 @@ json& json::part_word(bool on)
 	return *this;
 }
 
+json& json::use_index(bool on)
+{
+	acl_json_index(json_, on ? 1 : 0);
+	return *this;
+}
+
+// ݳȴﵽֵʱʹڴƬأݽʱڴƬصĿ
+// ʡڴ俪
+#define SLICE_MIN_DATA	1024
+
 void json::update(const char* data)
 {
-	acl_json_update(json_, data);
+	// δʼʱڴƬأطڴ
+	if (slice_ == NULL && json_->node_cnt == 1
+		&& json_->status == ACL_JSON_S_ROOT
+		&& strlen(data) >= SLICE_MIN_DATA)
+	{
+		use_slice();
+	}
+	acl_json_update_fast(json_, data);
+}
+
+void json::use_slice(void)
+{
+	slice_ = acl_slice_pool_create(8, 32, ACL_SLICE_FLAG_GC2
+		| ACL_SLICE_FLAG_RTGC_OFF | ACL_SLICE_FLAG_LP64_ALIGN);
+
+	// ʱ json ֻи㣬ֱ滻
+	ACL_JSON* tmp = acl_json_alloc1(slice_);
+	tmp->flag = json_->flag;
+	acl_json_free(json_);
+	json_ = tmp;
+
+	if (root_)
+		root_->set_json_node(json_->root);
+	if (node_tmp_)
+		node_tmp_->set_json_node(json_->root);
+}
+
+int json::update_msgpack(const void* data, size_t len)
+{
+	return acl_json_update_msgpack(json_, data, len);
+}
+
+int json::update_cbor(const void* data, size_t len)
+{
+	return acl_json_update_cbor(json_, data, len);
 }
 
 const std::vector<json_node*>& json::getElementsByTagName(const char* tag) const
 {
 	const_cast<json*>(this)->clear();
+
+	// ʱֱӱڵĽ飬ظ
+	bool indexed = (json_->flag & ACL_JSON_FLAG_TAG_INDEX) != 0;
 	ACL_ARRAY* a = acl_json_getElementsByTagName(json_, tag);
 	if (a == NULL)
 		return nodes_tmp_;
@@ -305,7 +367,8 @@ const std::vector<json_node*>& json::getElementsByTagName(const char* tag) const
 		json_node* node = NEW json_node(tmp, const_cast<json*>(this));
 		const_cast<json*>(this)->nodes_tmp_.push_back(node);
 	}
-	acl_json_free_array(a);
+	if (!indexed)
+		acl_json_free_array(a);
 
 	return nodes_tmp_;
 }
@@ -495,13 +558,23 @@ void json::build_json(string& out)
 	(void) acl_json_build(json_, buf);
 }
 
+void json::build_msgpack(string& out)
+{
+	(void) acl_json_build_msgpack(json_, out.vstring());
+}
+
+void json::build_cbor(string& out)
+{
+	(void) acl_json_build_cbor(json_, out.vstring());
+}
+
 void json::reset(void)
 {
 	clear();
 	if (json_)
 		acl_json_reset(json_);
 	else
-		json_ = acl_json_alloc();
+		json_ = acl_json_alloc1(slice_);
 }
 
 int json::push_pop(const char* in, size_t len acl_unused,
@@ -0,0 +1,764 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stream/istream.hpp"
+#include "acl_cpp/stdlib/json_reader.hpp"
+
+namespace acl
+{
+
+#define	READ_SIZE	8192
+#define	TOKEN_NONE	-2
+
+// ڴһ﷨ɷ
+enum
+{
+	EXPECT_VALUE,		// ֵһ json 
+	EXPECT_FIRST_VALUE,	// '[' ֵ֮ ']'
+	EXPECT_FIRST_KEY,	// '{' ֮ĳԱ '}'
+	EXPECT_KEY,		// ',' ֮ĳԱ
+	EXPECT_COLON,		// Ա֮ ':'
+	EXPECT_NEXT		// ֵ֮ ',' 
+};
+
+// ڷı
+enum
+{
+	LEX_NONE,
+	LEX_STRING,
+	LEX_NUMBER,
+	LEX_LITERAL
+};
+
+enum
+{
+	STATUS_OK,
+	STATUS_ERROR
+};
+
+json_reader::json_reader()
+: in_(NULL)
+, in_left_(-1)
+, max_token_(1024 * 1024)
+, max_depth_(1024)
+{
+	init();
+}
+
+#ifdef WIN32
+json_reader::json_reader(istream& in, __int64 len /* = -1 */)
+#else
+json_reader::json_reader(istream& in, long long int len /* = -1 */)
+#endif
+: in_(&in)
+, in_left_(len)
+, max_token_(1024 * 1024)
+, max_depth_(1024)
+{
+	init();
+}
+
+json_reader::~json_reader()
+{
+}
+
+void json_reader::init()
+{
+	buf_.clear();
+	pos_ = 0;
+	offset_ = 0;
+	eof_ = false;
+	stack_.clear();
+	expect_ = EXPECT_VALUE;
+	lex_ = LEX_NONE;
+	status_ = STATUS_OK;
+	last_ = JSON_TOKEN_MORE;
+	text_.clear();
+	error_.clear();
+	is_key_ = false;
+	esc_ = 0;
+	ucs_ = 0;
+	high_ = 0;
+	literal_ = NULL;
+	literal_pos_ = 0;
+	skip_value_ = false;
+	discard_ = false;
+	raw_ = false;
+	raw_str_ = false;
+	raw_esc_ = false;
+	raw_level_ = 0;
+}
+
+void json_reader::reset()
+{
+	init();
+}
+
+json_reader& json_reader::set_limits(size_t max_token, size_t max_depth)
+{
+	max_token_ = max_token;
+	max_depth_ = max_depth;
+	return *this;
+}
+
+void json_reader::update(const char* data, size_t len)
+{
+	if (pos_ >= buf_.length())
+	{
+		offset_ += pos_;
+		buf_.clear();
+		pos_ = 0;
+	}
+	buf_.append(data, len);
+}
+
+void json_reader::update_end()
+{
+	eof_ = true;
+}
+
+bool json_reader::fill()
+{
+	if (in_ == NULL || eof_)
+		return false;
+
+	size_t size = READ_SIZE;
+	if (in_left_ >= 0 && in_left_ < READ_SIZE)
+		size = (size_t) in_left_;
+	if (size == 0)
+	{
+		eof_ = true;
+		return false;
+	}
+
+	char buf[READ_SIZE];
+	int ret = in_->read(buf, size, false);
+	if (ret <= 0)
+	{
+		eof_ = true;
+		return false;
+	}
+	if (in_left_ > 0)
+		in_left_ -= ret;
+	buf_.append(buf, ret);
+	return true;
+}
+
+json_token_t json_reader::next()
+{
+	int ret;
+
+	if (status_ == STATUS_ERROR)
+		return JSON_TOKEN_ERROR;
+
+	while (true)
+	{
+		if (pos_ >= buf_.length())
+		{
+			offset_ += pos_;
+			buf_.clear();
+			pos_ = 0;
+
+			if (!fill())
+			{
+				if (!eof_)
+					return JSON_TOKEN_MORE;
+				ret = finish();
+				if (ret == TOKEN_NONE)
+					continue;
+				last_ = (json_token_t) ret;
+				return last_;
+			}
+		}
+
+		ret = parse();
+		if (ret != TOKEN_NONE)
+		{
+			last_ = (json_token_t) ret;
+			return last_;
+		}
+	}
+}
+
+bool json_reader::skip()
+{
+	if (last_ == JSON_TOKEN_BEGIN_OBJECT || last_ == JSON_TOKEN_BEGIN_ARRAY)
+	{
+		raw_ = true;
+		raw_str_ = false;
+		raw_esc_ = false;
+		raw_level_ = 0;
+	}
+	else if (last_ == JSON_TOKEN_KEY)
+		skip_value_ = true;
+	else
+		return false;
+
+	last_ = JSON_TOKEN_MORE;
+	return true;
+}
+
+bool json_reader::get_bool() const
+{
+	return text_ == "true";
+}
+
+#ifdef WIN32
+__int64 json_reader::get_int64() const
+#else
+long long int json_reader::get_int64() const
+#endif
+{
+	return acl_atoi64(text_.c_str());
+}
+
+double json_reader::get_double() const
+{
+	return atof(text_.c_str());
+}
+
+int json_reader::error(const char* msg)
+{
+	status_ = STATUS_ERROR;
+	error_.format("%s at offset %lld", msg, (long long int) (offset_ + pos_));
+	return JSON_TOKEN_ERROR;
+}
+
+//  JSON ֵ﷨: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+
+static bool number_valid(const char* s)
+{
+	if (*s == '-')
+		s++;
+	if (*s == '0')
+		s++;
+	else if (*s >= '1' && *s <= '9')
+	{
+		while (*s >= '0' && *s <= '9')
+			s++;
+	}
+	else
+		return false;
+
+	if (*s == '.')
+	{
+		s++;
+		if (*s < '0' || *s > '9')
+			return false;
+		while (*s >= '0' && *s <= '9')
+			s++;
+	}
+
+	if (*s == 'e' || *s == 'E')
+	{
+		s++;
+		if (*s == '+' || *s == '-')
+			s++;
+		if (*s < '0' || *s > '9')
+			return false;
+		while (*s >= '0' && *s <= '9')
+			s++;
+	}
+
+	return *s == 0;
+}
+
+// ݽʱһǣݲʱ
+
+int json_reader::finish()
+{
+	if (status_ == STATUS_ERROR)
+		return JSON_TOKEN_ERROR;
+
+	if (lex_ == LEX_NUMBER)
+	{
+		lex_ = LEX_NONE;
+		if (!discard_ && !number_valid(text_.c_str()))
+			return error("invalid number");
+		return value_done(JSON_TOKEN_NUMBER);
+	}
+
+	if (lex_ != LEX_NONE || raw_ || skip_value_ || !stack_.empty()
+		|| expect_ != EXPECT_VALUE)
+	{
+		return error("unexpected end of data");
+	}
+
+	return JSON_TOKEN_EOF;
+}
+
+int json_reader::value_done(json_token_t token)
+{
+	expect_ = stack_.empty() ? EXPECT_VALUE : EXPECT_NEXT;
+	if (discard_)
+	{
+		discard_ = false;
+		return TOKEN_NONE;
+	}
+	return token;
+}
+
+bool json_reader::append(const char* s, size_t n)
+{
+	if (discard_)
+		return true;
+	if (text_.length() + n > max_token_)
+		return false;
+	text_.append(s, n);
+	return true;
+}
+
+bool json_reader::append_ucs(unsigned int ucs)
+{
+	char buf[4];
+	size_t n;
+
+	if (ucs < 0x80)
+	{
+		buf[0] = (char) ucs;
+		n = 1;
+	}
+	else if (ucs < 0x800)
+	{
+		buf[0] = (char) (0xc0 | (ucs >> 6));
+		buf[1] = (char) (0x80 | (ucs & 0x3f));
+		n = 2;
+	}
+	else if (ucs < 0x10000)
+	{
+		buf[0] = (char) (0xe0 | (ucs >> 12));
+		buf[1] = (char) (0x80 | ((ucs >> 6) & 0x3f));
+		buf[2] = (char) (0x80 | (ucs & 0x3f));
+		n = 3;
+	}
+	else
+	{
+		buf[0] = (char) (0xf0 | (ucs >> 18));
+		buf[1] = (char) (0x80 | ((ucs >> 12) & 0x3f));
+		buf[2] = (char) (0x80 | ((ucs >> 6) & 0x3f));
+		buf[3] = (char) (0x80 | (ucs & 0x3f));
+		n = 4;
+	}
+	return append(buf, n);
+}
+
+// δλĸλΪ U+FFFD
+
+bool json_reader::flush_high()
+{
+	if (high_ == 0)
+		return true;
+	high_ = 0;
+	return append_ucs(0xfffd);
+}
+
+int json_reader::parse()
+{
+	if (lex_ == LEX_STRING)
+		return parse_string();
+	if (lex_ == LEX_NUMBER)
+		return parse_number();
+	if (lex_ == LEX_LITERAL)
+		return parse_literal();
+	if (raw_)
+		return parse_raw();
+
+	const char* begin = buf_.c_str();
+	const char* ptr = begin + pos_;
+	const char* end = begin + buf_.length();
+
+	// ָ ','  ':' رǣֱѭм
+	while (true)
+	{
+		while (ptr < end && (*ptr == ' ' || *ptr == '\t'
+			|| *ptr == '\r' || *ptr == '\n'))
+		{
+			ptr++;
+		}
+		pos_ = ptr - begin;
+		if (ptr == end)
+			return TOKEN_NONE;
+
+		char ch = *ptr;
+
+		switch (expect_)
+		{
+		case EXPECT_VALUE:
+			return parse_value(ch);
+		case EXPECT_FIRST_VALUE:
+			if (ch != ']')
+				return parse_value(ch);
+			break;
+		case EXPECT_FIRST_KEY:
+		case EXPECT_KEY:
+			if (ch == '"')
+			{
+				pos_++;
+				text_.clear();
+				is_key_ = true;
+				lex_ = LEX_STRING;
+				return parse_string();
+			}
+			if (ch != '}' || expect_ == EXPECT_KEY)
+				return error("member name expected");
+			break;
+		case EXPECT_COLON:
+			if (ch != ':')
+				return error("':' expected");
+			ptr++;
+			expect_ = EXPECT_VALUE;
+			continue;
+		case EXPECT_NEXT:
+			if (ch == ',')
+			{
+				ptr++;
+				expect_ = stack_.back() == '{'
+					? EXPECT_KEY : EXPECT_VALUE;
+				continue;
+			}
+			break;
+		default:
+			return error("invalid status");
+		}
+
+		// 
+		if ((ch == '}' && stack_.back() == '{')
+			|| (ch == ']' && stack_.back() == '['))
+		{
+			pos_++;
+			stack_.pop_back();
+			return value_done(ch == '}' ? JSON_TOKEN_END_OBJECT
+				: JSON_TOKEN_END_ARRAY);
+		}
+
+		return error("unexpected character");
+	}
+}
+
+int json_reader::parse_value(char ch)
+{
+	text_.clear();
+	discard_ = skip_value_;
+	skip_value_ = false;
+
+	switch (ch)
+	{
+	case '{':
+	case '[':
+		if (stack_.size() >= max_depth_)
+			return error("too deep");
+		pos_++;
+		stack_.push_back(ch);
+		if (discard_)
+		{
+			discard_ = false;
+			raw_ = true;
+			raw_str_ = false;
+			raw_esc_ = false;
+			raw_level_ = 0;
+			return parse_raw();
+		}
+		if (ch == '{')
+		{
+			expect_ = EXPECT_FIRST_KEY;
+			return JSON_TOKEN_BEGIN_OBJECT;
+		}
+		expect_ = EXPECT_FIRST_VALUE;
+		return JSON_TOKEN_BEGIN_ARRAY;
+	case '"':
+		pos_++;
+		is_key_ = false;
+		lex_ = LEX_STRING;
+		return parse_string();
+	case 't':
+		literal_ = "true";
+		break;
+	case 'f':
+		literal_ = "false";
+		break;
+	case 'n':
+		literal_ = "null";
+		break;
+	default:
+		if (ch == '-' || (ch >= '0' && ch <= '9'))
+		{
+			lex_ = LEX_NUMBER;
+			return parse_number();
+		}
+		return error("value expected");
+	}
+
+	literal_pos_ = 0;
+	lex_ = LEX_LITERAL;
+	return parse_literal();
+}
+
+int json_reader::parse_string()
+{
+	const char* begin = buf_.c_str();
+	const char* ptr = begin + pos_;
+	const char* end = begin + buf_.length();
+
+	while (ptr < end)
+	{
+		if (esc_ == 0)
+		{
+			const char* p = ptr;
+			while (p < end && *p != '"' && *p != '\\'
+				&& (unsigned char) *p >= 0x20)
+			{
+				p++;
+			}
+
+			if (p > ptr && (!flush_high() || !append(ptr, p - ptr)))
+			{
+				pos_ = p - begin;
+				return error("token too long");
+			}
+			ptr = p;
+			if (ptr == end)
+				break;
+
+			if (*ptr == '\\')
+			{
+				esc_ = 1;
+				ptr++;
+				continue;
+			}
+
+			pos_ = ptr - begin;
+			if (*ptr != '"')
+				return error("control character in string");
+			if (!flush_high())
+				return error("token too long");
+
+			pos_++;
+			lex_ = LEX_NONE;
+			if (is_key_)
+			{
+				is_key_ = false;
+				expect_ = EXPECT_COLON;
+				return JSON_TOKEN_KEY;
+			}
+			return value_done(JSON_TOKEN_STRING);
+		}
+
+		if (esc_ == 1)
+		{
+			char ch;
+
+			switch (*ptr)
+			{
+			case '"':
+			case '\\':
+			case '/':
+				ch = *ptr;
+				break;
+			case 'b':
+				ch = '\b';
+				break;
+			case 'f':
+				ch = '\f';
+				break;
+			case 'n':
+				ch = '\n';
+				break;
+			case 'r':
+				ch = '\r';
+				break;
+			case 't':
+				ch = '\t';
+				break;
+			case 'u':
+				esc_ = 2;
+				ucs_ = 0;
+				ptr++;
+				continue;
+			default:
+				pos_ = ptr - begin;
+				return error("invalid escape");
+			}
+
+			ptr++;
+			esc_ = 0;
+			if (!flush_high() || !append(&ch, 1))
+			{
+				pos_ = ptr - begin;
+				return error("token too long");
+			}
+			continue;
+		}
+
+		// \uXXXX еĸʮ
+		int n;
+		if (*ptr >= '0' && *ptr <= '9')
+			n = *ptr - '0';
+		else if (*ptr >= 'a' && *ptr <= 'f')
+			n = *ptr - 'a' + 10;
+		else if (*ptr >= 'A' && *ptr <= 'F')
+			n = *ptr - 'A' + 10;
+		else
+		{
+			pos_ = ptr - begin;
+			return error("invalid \\u escape");
+		}
+
+		ptr++;
+		ucs_ = (ucs_ << 4) | n;
+		if (++esc_ < 6)
+			continue;
+
+		esc_ = 0;
+		bool ok;
+		if (ucs_ >= 0xdc00 && ucs_ <= 0xdfff && high_ != 0)
+		{
+			ucs_ = 0x10000 + ((high_ - 0xd800) << 10)
+				+ (ucs_ - 0xdc00);
+			high_ = 0;
+			ok = append_ucs(ucs_);
+		}
+		else if (!flush_high())
+			ok = false;
+		else if (ucs_ >= 0xd800 && ucs_ <= 0xdbff)
+		{
+			high_ = ucs_;
+			ok = true;
+		}
+		else if (ucs_ >= 0xdc00 && ucs_ <= 0xdfff)
+			ok = append_ucs(0xfffd);
+		else
+			ok = append_ucs(ucs_);
+
+		if (!ok)
+		{
+			pos_ = ptr - begin;
+			return error("token too long");
+		}
+	}
+
+	pos_ = end - begin;
+	return TOKEN_NONE;
+}
+
+int json_reader::parse_number()
+{
+	const char* begin = buf_.c_str();
+	const char* ptr = begin + pos_;
+	const char* end = begin + buf_.length();
+	const char* p = ptr;
+
+	while (p < end && ((*p >= '0' && *p <= '9') || *p == '-'
+		|| *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+	{
+		p++;
+	}
+
+	pos_ = p - begin;
+	if (!append(ptr, p - ptr))
+		return error("token too long");
+
+	// ֵһм
+	if (p == end)
+		return TOKEN_NONE;
+
+	lex_ = LEX_NONE;
+	if (!discard_ && !number_valid(text_.c_str()))
+		return error("invalid number");
+	return value_done(JSON_TOKEN_NUMBER);
+}
+
+int json_reader::parse_literal()
+{
+	const char* begin = buf_.c_str();
+	const char* ptr = begin + pos_;
+	const char* end = begin + buf_.length();
+
+	while (ptr < end && literal_[literal_pos_] != 0)
+	{
+		if (*ptr != literal_[literal_pos_])
+		{
+			pos_ = ptr - begin;
+			return error("invalid literal");
+		}
+		ptr++;
+		literal_pos_++;
+	}
+
+	pos_ = ptr - begin;
+	if (literal_[literal_pos_] != 0)
+		return TOKEN_NONE;
+
+	lex_ = LEX_NONE;
+	text_ = literal_;
+	return value_done(literal_[0] == 'n' ? JSON_TOKEN_NULL
+		: JSON_TOKEN_BOOL);
+}
+
+// ʱֻżţҲе
+
+int json_reader::parse_raw()
+{
+	const char* begin = buf_.c_str();
+	const char* ptr = begin + pos_;
+	const char* end = begin + buf_.length();
+
+	while (ptr < end)
+	{
+		if (raw_esc_)
+		{
+			raw_esc_ = false;
+			ptr++;
+			continue;
+		}
+
+		//  '\0' βstrcspn ĽԽ endм
+		//  '\0' ֱ
+		if (raw_str_)
+		{
+			ptr += strcspn(ptr, "\"\\");
+			if (ptr >= end)
+				break;
+			if (*ptr == '\\')
+				raw_esc_ = true;
+			else if (*ptr == '"')
+				raw_str_ = false;
+			ptr++;
+			continue;
+		}
+
+		ptr += strcspn(ptr, "\"{}[]");
+		if (ptr >= end)
+			break;
+
+		switch (*ptr++)
+		{
+		case '"':
+			raw_str_ = true;
+			break;
+		case '{':
+		case '[':
+			raw_level_++;
+			break;
+		case 0:
+			break;
+		default:
+			if (raw_level_ > 0)
+			{
+				raw_level_--;
+				break;
+			}
+
+			pos_ = ptr - begin;
+			if ((ptr[-1] == '}') != (stack_.back() == '{'))
+				return error("unmatched bracket");
+			raw_ = false;
+			stack_.pop_back();
+			expect_ = stack_.empty() ? EXPECT_VALUE : EXPECT_NEXT;
+			return TOKEN_NONE;
+		}
+	}
+
+	pos_ = end - begin;
+	return TOKEN_NONE;
+}
+
+} // namespace acl
@@ -0,0 +1,372 @@
+#include "acl_stdafx.hpp"
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/snprintf.hpp"
+#include "acl_cpp/stream/ostream.hpp"
+#include "acl_cpp/stream/aio_ostream.hpp"
+#include "acl_cpp/http/HttpServletResponse.hpp"
+#include "acl_cpp/stdlib/json_writer.hpp"
+
+namespace acl
+{
+
+json_writer::json_writer(ostream& out, size_t size /* = 8192 */)
+: out_(&out)
+, res_(NULL)
+, aio_(NULL)
+, str_(NULL)
+{
+	init(size);
+}
+
+json_writer::json_writer(HttpServletResponse& res, size_t size /* = 8192 */)
+: out_(NULL)
+, res_(&res)
+, aio_(NULL)
+, str_(NULL)
+{
+	init(size);
+}
+
+json_writer::json_writer(aio_ostream& out, size_t size /* = 8192 */)
+: out_(NULL)
+, res_(NULL)
+, aio_(&out)
+, str_(NULL)
+{
+	init(size);
+}
+
+json_writer::json_writer(string& out)
+: out_(NULL)
+, res_(NULL)
+, aio_(NULL)
+, str_(&out)
+{
+	init(8192);
+}
+
+json_writer::~json_writer()
+{
+	acl_myfree(buf_);
+}
+
+void json_writer::init(size_t size)
+{
+	// һֵһתַ
+	if (size < 64)
+		size = 64;
+	size_ = size;
+	buf_ = (char*) acl_mymalloc(size_);
+	len_ = 0;
+	failed_ = false;
+	after_key_ = false;
+}
+
+bool json_writer::flush()
+{
+	if (len_ == 0)
+		return !failed_;
+
+	size_t len = len_;
+	len_ = 0;
+
+	if (failed_)
+		return false;
+
+	if (out_)
+	{
+		if (out_->write(buf_, len) == -1)
+			failed_ = true;
+	}
+	else if (res_)
+	{
+		if (res_->write(buf_, len) == false)
+			failed_ = true;
+	}
+	else if (aio_)
+		aio_->write(buf_, (int) len);
+	else if (str_)
+		str_->append(buf_, len);
+
+	return !failed_;
+}
+
+bool json_writer::finish()
+{
+	if (!flush())
+		return false;
+
+	// chunked ʽʱͽ飬õò
+	if (res_ && res_->write(NULL, 0) == false)
+		failed_ = true;
+
+	return !failed_ && stack_.empty() && !after_key_;
+}
+
+void json_writer::put(const char* s, size_t n)
+{
+	while (n > 0)
+	{
+		if (len_ == size_)
+			flush();
+
+		size_t k = size_ - len_;
+		if (k > n)
+			k = n;
+		memcpy(buf_ + len_, s, k);
+		len_ += k;
+		s += k;
+		n -= k;
+	}
+}
+
+void json_writer::put(char ch)
+{
+	if (len_ == size_)
+		flush();
+	buf_[len_++] = ch;
+}
+
+// ÿ 8 ֽڼһǷ '"''\\' ַַ
+// ת壬ο
+
+#define	ONES	0x0101010101010101ULL
+#define	HIGHS	0x8080808080808080ULL
+
+static inline bool has_zero(unsigned long long w)
+{
+	return ((w - ONES) & ~w & HIGHS) != 0;
+}
+
+static inline bool need_escape(unsigned long long w)
+{
+	return has_zero(w ^ (ONES * '"')) || has_zero(w ^ (ONES * '\\'))
+		|| ((w - ONES * 0x20) & ~w & HIGHS) != 0;
+}
+
+static size_t plain_length(const char* s, size_t n)
+{
+	size_t i = 0;
+	unsigned long long w;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		memcpy(&w, s + i, 8);
+		if (need_escape(w))
+			break;
+	}
+
+	for (; i < n; i++)
+	{
+		unsigned char ch = (unsigned char) s[i];
+		if (ch < 0x20 || ch == '"' || ch == '\\')
+			break;
+	}
+
+	return i;
+}
+
+void json_writer::put_escape(const char* s, size_t n)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	put('"');
+
+	while (n > 0)
+	{
+		size_t k = plain_length(s, n);
+		if (k > 0)
+		{
+			put(s, k);
+			s += k;
+			n -= k;
+			if (n == 0)
+				break;
+		}
+
+		unsigned char ch = (unsigned char) *s++;
+		n--;
+
+		if (size_ - len_ < 6)
+			flush();
+
+		char* ptr = buf_ + len_;
+		*ptr++ = '\\';
+
+		switch (ch)
+		{
+		case '"':
+		case '\\':
+			*ptr++ = (char) ch;
+			break;
+		case '\b':
+			*ptr++ = 'b';
+			break;
+		case '\f':
+			*ptr++ = 'f';
+			break;
+		case '\n':
+			*ptr++ = 'n';
+			break;
+		case '\r':
+			*ptr++ = 'r';
+			break;
+		case '\t':
+			*ptr++ = 't';
+			break;
+		default:
+			*ptr++ = 'u';
+			*ptr++ = '0';
+			*ptr++ = '0';
+			*ptr++ = hex[ch >> 4];
+			*ptr++ = hex[ch & 0x0f];
+			break;
+		}
+
+		len_ = ptr - buf_;
+	}
+
+	put('"');
+}
+
+void json_writer::separate()
+{
+	if (after_key_)
+	{
+		after_key_ = false;
+		return;
+	}
+
+	if (stack_.empty())
+		return;
+
+	if (stack_.back())
+		put(',');
+	else
+		stack_.back() = true;
+}
+
+json_writer& json_writer::begin_object()
+{
+	separate();
+	put('{');
+	stack_.push_back(false);
+	return *this;
+}
+
+json_writer& json_writer::end_object()
+{
+	if (!stack_.empty())
+		stack_.pop_back();
+	put('}');
+	return *this;
+}
+
+json_writer& json_writer::begin_array()
+{
+	separate();
+	put('[');
+	stack_.push_back(false);
+	return *this;
+}
+
+json_writer& json_writer::end_array()
+{
+	if (!stack_.empty())
+		stack_.pop_back();
+	put(']');
+	return *this;
+}
+
+json_writer& json_writer::key(const char* name)
+{
+	return key(name, strlen(name));
+}
+
+json_writer& json_writer::key(const char* name, size_t len)
+{
+	separate();
+	put_escape(name, len);
+	put(':');
+	after_key_ = true;
+	return *this;
+}
+
+json_writer& json_writer::value(const char* s)
+{
+	if (s == NULL)
+		return value_null();
+	return value(s, strlen(s));
+}
+
+json_writer& json_writer::value(const char* s, size_t len)
+{
+	separate();
+	put_escape(s, len);
+	return *this;
+}
+
+json_writer& json_writer::value(const string& s)
+{
+	return value(s.c_str(), s.length());
+}
+
+#ifdef WIN32
+json_writer& json_writer::value(__int64 n)
+#else
+json_writer& json_writer::value(long long int n)
+#endif
+{
+	char buf[32];
+
+	separate();
+	put(buf, safe_snprintf(buf, sizeof(buf), "%lld", n));
+	return *this;
+}
+
+json_writer& json_writer::value(int n)
+{
+	return value((long long int) n);
+}
+
+json_writer& json_writer::value(double n)
+{
+	// json вܱʾ NaN 
+	if (n != n || n - n != 0)
+		return value_null();
+
+	char buf[32];
+	int  len = safe_snprintf(buf, sizeof(buf), "%.15g", n);
+	if (strtod(buf, NULL) != n)
+		len = safe_snprintf(buf, sizeof(buf), "%.17g", n);
+
+	separate();
+	put(buf, len);
+	return *this;
+}
+
+json_writer& json_writer::value(bool b)
+{
+	separate();
+	if (b)
+		put("true", 4);
+	else
+		put("false", 5);
+	return *this;
+}
+
+json_writer& json_writer::value_null()
+{
+	separate();
+	put("null", 4);
+	return *this;
+}
+
+json_writer& json_writer::raw(const char* data, size_t len)
+{
+	separate();
+	put(data, len);
+	return *this;
+}
+
+} // namespace acl
@@ -84,7 +84,8 @@ bool locker::lock()
 
 bool locker::try_lock()
 {
-	if (pMutex_ && acl_pthread_mutex_trylock(pMutex_) == -1)
+	// pthread_mutex_trylock ռʱ EBUSY  -1
+	if (pMutex_ && acl_pthread_mutex_trylock(pMutex_) != 0)
 		return false;
 
 	if (fHandle_ == ACL_FILE_INVALID)
@@ -706,7 +706,7 @@ bool string::operator <(const string& s) const
 {
 	size_t nLeft = LEN(vbf_);
 	size_t nRight = LEN(s.vbf_);
-	size_t n = nLeft > nRight ? nLeft : nRight;
+	size_t n = nLeft < nRight ? nLeft : nRight;
 	int   ret = memcmp(STR(vbf_), STR(s.vbf_), n);
 	if (ret < 0)
 		return true;
@@ -721,7 +721,7 @@ bool string::operator >(const string& s) const
 {
 	size_t nLeft = LEN(vbf_);
 	size_t nRight = LEN(s.vbf_);
-	size_t n = nLeft > nRight ? nLeft : nRight;
+	size_t n = nLeft < nRight ? nLeft : nRight;
 	int   ret = memcmp(STR(vbf_), STR(s.vbf_), n);
 	if (ret > 0)
 		return true;
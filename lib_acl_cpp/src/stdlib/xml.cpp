@@ -327,6 +327,12 @@ xml& xml::ignore_slash(bool on)
 	return *this;
 }
 
+xml& xml::use_index(bool on)
+{
+	acl_xml_index(xml_, on ? 1 : 0);
+	return *this;
+}
+
 void xml::update(const char* data)
 {
 	acl_xml_update(xml_, data);
@@ -336,6 +342,8 @@ const std::vector<xml_node*>& xml::getElementsByTagName(const char* tag) const
 {
 	const_cast<xml*>(this)->clear();
 
+	// ʱֱӱڵĽ飬ظ
+	bool indexed = (xml_->flag & ACL_XML_FLAG_TAG_INDEX) != 0;
 	ACL_ARRAY* a = acl_xml_getElementsByTagName(xml_, tag);
 	if (a == NULL)
 		return elements_;
@@ -347,13 +355,15 @@ const std::vector<xml_node*>& xml::getElementsByTagName(const char* tag) const
 		xml_node* node = NEW xml_node(tmp, const_cast<xml*>(this));
 		const_cast<xml*>(this)->elements_.push_back(node);
 	}
-	acl_xml_free_array(a);
+	if (!indexed)
+		acl_xml_free_array(a);
 
 	return elements_;
 }
 
 const xml_node* xml::getFirstElementByTag(const char* tag) const
 {
+	bool indexed = (xml_->flag & ACL_XML_FLAG_TAG_INDEX) != 0;
 	ACL_ARRAY* a = acl_xml_getElementsByTagName(xml_, tag);
 	if (a == NULL)
 		return NULL;
@@ -365,7 +375,8 @@ const xml_node* xml::getFirstElementByTag(const char* tag) const
 			NEW xml_node(node, const_cast<xml*>(this));
 	else
 		const_cast<xml*>(this)->node_->set_xml_node(node);
-	acl_xml_free_array(a);
+	if (!indexed)
+		acl_xml_free_array(a);
 
 	return node_;
 }
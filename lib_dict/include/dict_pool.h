@@ -36,6 +36,16 @@ DICT_API DICT_POOL *dict_pool_new(const char **partions, int partions_size,
  */
 DICT_API void dict_pool_free(DICT_POOL *pool);
 
+/**
+ * üÿ洢DBһмʼĲ֮
+ * dict_pool_get/dict_pool_db_get һڵļ洢ֱӷأ
+ * Ӽɾʱͬ¹ĳ洢DBĹʱԶرոDB
+ * Ĺ˹
+ * @param pool {DICT_POOL*} ĳ洢صĶָ
+ * @param capacity {size_t} Ԥ洢м
+ */
+DICT_API void dict_pool_filter_open(DICT_POOL *pool, size_t capacity);
+
 /**
  * һ key/value һ洢
  * @param pool {DICT_POOL*} ĳ洢صĶָ
@@ -20,6 +20,7 @@ struct DICT_POOL_DB {
 	acl_pthread_mutex_t lock;
 	int   seqcnt;
 	POOL_PARTION *partion;
+	ACL_CUCKOO *filter;
 };
 
 struct DICT_POOL {
@@ -153,6 +154,8 @@ void dict_pool_free(DICT_POOL *pool)
 			if (pool->dbpool[i].dict_write != NULL)
 				DICT_CLOSE(pool->dbpool[i].dict_write);
 		}
+		if (pool->dbpool[i].filter)
+			acl_cuckoo_free(pool->dbpool[i].filter);
 		acl_vstring_free(pool->dbpool[i].dpath);
 		acl_pthread_mutex_destroy(&pool->dbpool[i].lock);
 	}
@@ -167,12 +170,97 @@ void dict_pool_free(DICT_POOL *pool)
 	acl_myfree(pool);
 }
 
+/*--------------------------------------------------------------------------*/
+
+/* ʱٱ֤©Уֻܹرոô洢DBĹ˹ */
+static void db_filter_close(DICT_POOL_DB *db)
+{
+	acl_msg_warn("dict(%s): key filter full, disabled",
+		STR(db->dpath));
+	acl_cuckoo_free(db->filter);
+	db->filter = NULL;
+}
+
+static void db_filter_build(DICT_POOL_DB *db, size_t capacity)
+{
+	char *key, *val;
+	size_t key_size, val_size;
+	int   ret;
+
+	db->filter = acl_cuckoo_create(capacity);
+	ret = DICT_SEQ(db->dict_read, DICT_SEQ_FUN_FIRST,
+		&key, &key_size, &val, &val_size);
+	while (ret == 0) {
+		ret = acl_cuckoo_add(db->filter, key, key_size);
+		acl_myfree(key);
+		acl_myfree(val);
+		if (ret < 0) {
+			db_filter_close(db);
+			break;
+		}
+		ret = DICT_SEQ(db->dict_read, DICT_SEQ_FUN_NEXT,
+			&key, &key_size, &val, &val_size);
+	}
+	DICT_RESET(db->dict_read);
+}
+
+/* cdb ͵Ķдͬһ⣬дݲᱻԲظ¹ */
+static void db_filter_add(DICT_POOL_DB *db, char *key, size_t key_len)
+{
+	char *value;
+	size_t size;
+
+	if (db->filter == NULL || db->dict_read != db->dict_write)
+		return;
+
+	/* ޸еļʱظӣʱҪѯ洢ȷ
+	 * ֮ͻļɾüͻᱻ©
+	 */
+	if (acl_cuckoo_test(db->filter, key, key_len)) {
+		if (DICT_GET(db->dict_read, key, key_len, &value, &size)) {
+			acl_myfree(value);
+			return;
+		}
+	}
+
+	if (acl_cuckoo_add(db->filter, key, key_len) < 0)
+		db_filter_close(db);
+}
+
+static void db_filter_del(DICT_POOL_DB *db, char *key, size_t key_len)
+{
+	if (db->filter && db->dict_read == db->dict_write)
+		acl_cuckoo_del(db->filter, key, key_len);
+}
+
+#define	DB_FILTER_MISS(db, key, key_len) \
+	((db)->filter && !acl_cuckoo_test((db)->filter, (key), (key_len)))
+
+void dict_pool_filter_open(DICT_POOL *pool, size_t capacity)
+{
+	size_t n = capacity / pool->pool_size;
+	int   i;
+
+	/* 洢DBļȫƽ */
+	n += n / 8 + 64;
+
+	for (i = 0; i < pool->pool_size; i++) {
+		dict_pool_db_lock(&pool->dbpool[i]);
+		if (pool->dbpool[i].filter == NULL)
+			db_filter_build(&pool->dbpool[i], n);
+		dict_pool_db_unlock(&pool->dbpool[i]);
+	}
+}
+
+/*--------------------------------------------------------------------------*/
+
 int  dict_pool_set(DICT_POOL *pool, char *key, size_t key_len, char *value, size_t len)
 {
 	unsigned int n;
 
 	n = (pool->hash_fn(key, key_len)) % (pool->pool_size);
 	dict_pool_db_lock(&pool->dbpool[n]);
+	db_filter_add(&pool->dbpool[n], key, key_len);
 	DICT_PUT(pool->dbpool[n].dict_write, key, key_len, value, len);
 	pool->dbpool[n].partion->obj_cnt++;
 	dict_pool_db_unlock(&pool->dbpool[n]);
@@ -187,6 +275,12 @@ char *dict_pool_get(DICT_POOL *pool, char *key, size_t key_len, size_t *size)
 
 	n = (pool->hash_fn(key, key_len)) % (pool->pool_size);
 	dict_pool_db_lock(&pool->dbpool[n]);
+	if (DB_FILTER_MISS(&pool->dbpool[n], key, key_len)) {
+		dict_pool_db_unlock(&pool->dbpool[n]);
+		if (size)
+			*size = 0;
+		return (NULL);
+	}
 	if (DICT_GET(pool->dbpool[n].dict_read, key, key_len, &value, size) == NULL) {
 		if (dict_errno == DICT_ERR_RETRY)
 			acl_msg_error("%s(%d): soft error", myname, __LINE__);
@@ -203,8 +297,10 @@ int  dict_pool_del(DICT_POOL *pool, char *key, size_t key_len)
 	n = (pool->hash_fn(key, key_len)) % (pool->pool_size);
 	dict_pool_db_lock(&pool->dbpool[n]);
 	ret = DICT_DEL(pool->dbpool[n].dict_write, key, key_len);
-	if (ret == 0)
+	if (ret == 0) {
+		db_filter_del(&pool->dbpool[n], key, key_len);
 		pool->dbpool[n].partion->obj_cnt--;
+	}
 	dict_pool_db_unlock(&pool->dbpool[n]);
 	return (ret);
 }
@@ -301,6 +397,7 @@ void dict_pool_db_unlock(DICT_POOL_DB *db)
 
 int  dict_pool_db_set(DICT_POOL_DB *db, char *key, size_t key_len, char *value, size_t len)
 {
+	db_filter_add(db, key, key_len);
 	DICT_PUT(db->dict_write, key, key_len, value, len);
 	db->partion->obj_cnt++;
 	return (0);
@@ -311,6 +408,11 @@ char *dict_pool_db_get(DICT_POOL_DB *db, char *key, size_t key_len, size_t *size
 	const char *myname = "dict_pool_db_get";
 	char *value;
 
+	if (DB_FILTER_MISS(db, key, key_len)) {
+		if (size)
+			*size = 0;
+		return (NULL);
+	}
 	if (DICT_GET(db->dict_read, key, key_len, &value, size) == NULL) {
 		if (dict_errno == DICT_ERR_RETRY)
 			acl_msg_error("%s(%d): soft error", myname, __LINE__);
@@ -323,8 +425,10 @@ int dict_pool_db_del(DICT_POOL_DB *db, char *key, size_t key_len)
 	int   ret;
 
 	ret = DICT_DEL(db->dict_write, key, key_len);
-	if (ret == 0)
+	if (ret == 0) {
+		db_filter_del(db, key, key_len);
 		db->partion->obj_cnt--;
+	}
 	return (ret);
 }
 